@@ -256,6 +256,21 @@ macro polly(ex)
     esc(isa(ex, Expr) ? pushmeta!(ex, :polly) : ex)
 end
 
+"""
+    @multiversion
+
+Tells the compiler to clone a function for every partial multiversioning
+target of the system image (see the `JULIA_CPU_TARGET` build option),
+instead of relying on the heuristic that looks for loops and vector code.
+Use this on hand-written kernels whose best code depends on the selected
+instruction set (e.g. the SIMD width) but which the heuristic misses. It
+has no effect on targets built with `clone_all`, which copy every
+function anyway.
+"""
+macro multiversion(ex)
+    esc(isa(ex, Expr) ? pushmeta!(ex, :multiversion) : ex)
+end
+
 ## some macro utilities ##
 
 function pushmeta!(ex::Expr, sym::Symbol, args::Any...)
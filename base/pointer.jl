@@ -93,29 +93,43 @@ unsafe_wrap(Atype::Type, p::Ptr, dims::NTuple{N,<:Integer}; own::Bool = false) w
     unsafe_wrap(Atype, p, convert(Tuple{Vararg{Int}}, dims), own = own)
 
 """
-    unsafe_load(p::Ptr{T}, i::Integer=1)
+    unsafe_load(p::Ptr{T}, i::Integer=1, [align::Integer])
 
 Load a value of type `T` from the address of the `i`th element (1-indexed) starting at `p`.
 This is equivalent to the C expression `p[i-1]`.
 
+`align` asserts that the loaded element is `align`-byte aligned, which permits the
+compiler to emit aligned (and, in loops, vectorized) memory accesses; when omitted,
+no alignment is assumed. For the assertion to reach the compiler, `align` must be a
+compile-time constant. Loading through a pointer that is not actually so aligned is
+undefined behavior.
+
 The `unsafe` prefix on this function indicates that no validation is performed on the
 pointer `p` to ensure that it is valid. Incorrect usage may segfault your program or return
 garbage answers, in the same manner as C.
 """
 unsafe_load(p::Ptr, i::Integer=1) = pointerref(p, Int(i), 1)
+unsafe_load(p::Ptr, i::Integer, align::Integer) = pointerref(p, Int(i), Int(align))
 
 """
-    unsafe_store!(p::Ptr{T}, x, i::Integer=1)
+    unsafe_store!(p::Ptr{T}, x, i::Integer=1, [align::Integer])
 
 Store a value of type `T` to the address of the `i`th element (1-indexed) starting at `p`.
 This is equivalent to the C expression `p[i-1] = x`.
 
+`align` asserts that the stored element is `align`-byte aligned, as for
+[`unsafe_load`](@ref).
+
 The `unsafe` prefix on this function indicates that no validation is performed on the
 pointer `p` to ensure that it is valid. Incorrect usage may corrupt or segfault your
 program, in the same manner as C.
 """
 unsafe_store!(p::Ptr{Any}, @nospecialize(x), i::Integer=1) = pointerset(p, x, Int(i), 1)
+unsafe_store!(p::Ptr{Any}, @nospecialize(x), i::Integer, align::Integer) =
+    pointerset(p, x, Int(i), Int(align))
 unsafe_store!(p::Ptr{T}, x, i::Integer=1) where {T} = pointerset(p, convert(T,x), Int(i), 1)
+unsafe_store!(p::Ptr{T}, x, i::Integer, align::Integer) where {T} =
+    pointerset(p, convert(T,x), Int(i), Int(align))
 
 # convert a raw Ptr to an object reference, and vice-versa
 """
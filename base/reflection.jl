@@ -932,6 +932,9 @@ struct CodegenParams
     static_alloc::Cint
     prefer_specsig::Cint
 
+    debug_info::Cint
+    safepoints::Cint
+
     module_setup::Any
     module_activation::Any
     raise_exception::Any
@@ -941,11 +944,13 @@ struct CodegenParams
     CodegenParams(;cached::Bool=true,
                    track_allocations::Bool=true, code_coverage::Bool=true,
                    static_alloc::Bool=true, prefer_specsig::Bool=false,
+                   debug_info::Bool=true, safepoints::Bool=true,
                    module_setup=nothing, module_activation=nothing, raise_exception=nothing,
                    emit_function=nothing, emitted_function=nothing) =
         new(Cint(cached),
             Cint(track_allocations), Cint(code_coverage),
             Cint(static_alloc), Cint(prefer_specsig),
+            Cint(debug_info), Cint(safepoints),
             module_setup, module_activation, raise_exception,
             emit_function, emitted_function)
 end
@@ -21,6 +21,52 @@ nthreads() = Int(unsafe_load(cglobal(:jl_n_threads, Cint)))
 # Only read/written by the main thread
 const in_threaded_loop = Ref(false)
 
+function _threadsfor_dynamic(iter,lbody)
+    lidx = iter.args[1]         # index
+    range = iter.args[2]
+    quote
+        local threadsfor_fun
+        local dynrange = $(esc(range))
+        let range = dynrange
+        function threadsfor_fun(onethread=false)
+            r = range # Load into local variable
+            lenr = length(r)
+            if onethread
+                for i = 1:lenr
+                    local $(esc(lidx)) = Base.unsafe_getindex(r,i)
+                    $(esc(lbody))
+                end
+                return
+            end
+            # pull half-open chunks of the iteration space from the shared
+            # counter until it is exhausted
+            chunkf = Ref{Int64}(0)
+            chunkl = Ref{Int64}(0)
+            while ccall(:jl_threading_next_chunk, Cint,
+                        (Ref{Int64}, Ref{Int64}), chunkf, chunkl) != 0
+                for i = (Int(chunkf[])+1):Int(chunkl[])
+                    local $(esc(lidx)) = Base.unsafe_getindex(r,i)
+                    $(esc(lbody))
+                end
+            end
+        end
+        end
+        # Hack to make nested threaded loops kinda work
+        if threadid() != 1 || in_threaded_loop[]
+            # We are in a nested threaded loop
+            Base.invokelatest(threadsfor_fun, true)
+        else
+            in_threaded_loop[] = true
+            ccall(:jl_threading_chunk_init, Cvoid, (Int64, Int64, Int64),
+                  0, Int64(length(dynrange)), 0)
+            # the ccall is not expected to throw
+            ccall(:jl_threading_run, Cvoid, (Any,), threadsfor_fun)
+            in_threaded_loop[] = false
+        end
+        nothing
+    end
+end
+
 function _threadsfor(iter,lbody)
     lidx = iter.args[1]         # index
     range = iter.args[2]
@@ -80,23 +126,43 @@ function _threadsfor(iter,lbody)
 end
 
 """
-    Threads.@threads
+    Threads.@threads [schedule] for ... end
 
 A macro to parallelize a for-loop to run with multiple threads. This spawns `nthreads()`
 number of threads, splits the iteration space amongst them, and iterates in parallel.
 A barrier is placed at the end of the loop which waits for all the threads to finish
 execution, and the loop returns.
+
+The optional `schedule` argument selects how iterations are distributed:
+`:static` (the default) assigns each thread a fixed contiguous block up
+front, while `:dynamic` has the threads pull chunks from a shared counter
+as they go, which balances loops whose per-iteration cost varies widely.
 """
 macro threads(args...)
     na = length(args)
-    if na != 1
+    if na == 2
+        sched, ex = args
+        if sched isa QuoteNode
+            sched = sched.value
+        elseif !(sched isa Symbol)
+            throw(ArgumentError("unrecognized schedule argument in @threads"))
+        end
+        if sched !== :static && sched !== :dynamic
+            throw(ArgumentError("unsupported schedule argument in @threads"))
+        end
+    elseif na == 1
+        sched = :static
+        ex = args[1]
+    else
         throw(ArgumentError("wrong number of arguments in @threads"))
     end
-    ex = args[1]
     if !isa(ex, Expr)
         throw(ArgumentError("need an expression argument to @threads"))
     end
     if ex.head === :for
+        if sched === :dynamic
+            return _threadsfor_dynamic(ex.args[1], ex.args[2])
+        end
         return _threadsfor(ex.args[1], ex.args[2])
     else
         throw(ArgumentError("unrecognized argument to @threads"))
@@ -0,0 +1,139 @@
+# This file is a part of Julia. License is MIT: https://julialang.org/license
+
+# FFI round-trip cost benchmark built on libccalltest. Run with
+#
+#     make bench-ccall
+#
+# Each result is one JSON object per line:
+#
+#     {"bench":"scalar","mode":"ccall","ns":12.3}
+#
+# where `ns` is the best observed per-call time in nanoseconds, so the output
+# can be collected and diffed across releases to spot FFI regressions. The
+# `bench` axis covers the ABI classes exercised by src/ccalltest.c (register
+# scalar, small struct in registers, sret aggregate, SIMD vector); the `mode`
+# axis covers plain ccall, a ccall declared `gc_leaf` (no safepoint
+# bookkeeping), a top-level cfunction callback, and a runtime-closure
+# cfunction callback.
+
+const libccalltest = "libccalltest"
+
+ccall((:set_verbose, libccalltest), Cvoid, (Int32,), 0)
+
+const CALLS = 100_000
+const SAMPLES = 11
+
+# Best-of-N timing: each sample times CALLS back-to-back calls and the
+# minimum is reported, which discards GC pauses and scheduler noise.
+function measure(f::F) where {F}
+    f(100) # force compilation
+    best = typemax(Float64)
+    for _ in 1:SAMPLES
+        t0 = time_ns()
+        f(CALLS)
+        best = min(best, (time_ns() - t0) / CALLS)
+    end
+    return best
+end
+
+report(bench, mode, ns) = println("{\"bench\":\"", bench, "\",\"mode\":\"", mode,
+                                  "\",\"ns\":", round(ns, digits = 2), "}")
+
+# matches struct2a in src/ccalltest.c: two int32 fields, passed and
+# returned in registers
+struct BenchStruct2a
+    x::Int32
+    y::Int32
+end
+
+# matches struct_big in src/ccalltest.c: 17 bytes, returned via sret
+struct BenchStructBig
+    x::Int
+    y::Int
+    z::Int8
+end
+
+const VecReg{N,T} = NTuple{N,VecElement{T}}
+const V4xF32 = VecReg{4,Float32}
+
+function bench_scalar(n)
+    s = Int32(0)
+    for i in 1:n
+        s += ccall((:testUcharX, libccalltest), Int32, (UInt8,), i % UInt8)
+    end
+    return s
+end
+
+function bench_scalar_gc_leaf(n)
+    s = Int32(0)
+    for i in 1:n
+        s += ccall((:testUcharX, libccalltest), gc_leaf, Int32, (UInt8,), i % UInt8)
+    end
+    return s
+end
+
+function bench_small_struct(n)
+    a = BenchStruct2a(13, 42)
+    s = Int32(0)
+    for i in 1:n
+        a = ccall((:test_2a, libccalltest), BenchStruct2a,
+                  (BenchStruct2a, Int32), a, Int32(1))
+        s += a.x
+    end
+    return s
+end
+
+function bench_sret(n)
+    a = BenchStructBig(424, -5, Int8('Z'))
+    s = 0
+    for i in 1:n
+        a = ccall((:test_big, libccalltest), BenchStructBig, (BenchStructBig,), a)
+        s += a.y
+    end
+    return s
+end
+
+function bench_vector(n)
+    a = ntuple(i -> VecElement(Float32(i)), 4)
+    s = 0.0f0
+    for i in 1:n
+        a = ccall((:test_m128, libccalltest), V4xF32,
+                  (V4xF32, V4xF32, V4xF32, V4xF32), a, a, a, a)
+        s += a[1].value
+    end
+    return s
+end
+
+cb_int(x::Cint) = x + Cint(1)
+const cb_int_ptr = @cfunction(cb_int, Cint, (Cint,))
+
+function bench_cfunction(n)
+    s = Cint(0)
+    for i in 1:n
+        s += ccall((:call_cb_int, libccalltest), Cint,
+                   (Ptr{Cvoid}, Cint), cb_int_ptr, s % Cint)
+    end
+    return s
+end
+
+function bench_closure_cfunction(n)
+    k = Cint(1)
+    f = x -> x + k
+    cf = @cfunction($f, Cint, (Cint,))
+    s = Cint(0)
+    for i in 1:n
+        s += ccall((:call_cb_int, libccalltest), Cint,
+                   (Ptr{Cvoid}, Cint), cf, s % Cint)
+    end
+    return s
+end
+
+report("scalar", "ccall", measure(bench_scalar))
+report("scalar", "ccall_gc_leaf", measure(bench_scalar_gc_leaf))
+report("small_struct", "ccall", measure(bench_small_struct))
+report("sret_big", "ccall", measure(bench_sret))
+if Sys.ARCH === :x86_64
+    report("vector_m128", "ccall", measure(bench_vector))
+end
+report("scalar", "cfunction", measure(bench_cfunction))
+report("scalar", "closure_cfunction", measure(bench_closure_cfunction))
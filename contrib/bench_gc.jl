@@ -0,0 +1,221 @@
+# This file is a part of Julia. License is MIT: https://julialang.org/license
+
+# GC stress harness. Run with
+#
+#     make bench-gc
+#
+# Synthesizes heaps that each exercise one class of the mark loop in
+# src/gc.c at a controlled size and pointer density, then forces
+# collections over the live heap and reports per-phase times and pause
+# percentiles for that shape alone, one JSON object per line:
+#
+#     {"bench":"gc","shape":"objarray_dense","mark_ns":...,"sweep_ns":...,
+#      "p50_ns":...,"p90_ns":...,"p99_ns":...,"max_ns":...,"collections":20}
+#
+# Shapes and the mark paths they drive (names from the gc_mark_loop labels):
+#
+#   objarray_{sparse,half,dense}  objarray: a large Vector{Any} whose slots
+#                                 hold distinct young objects at 1% / 50% /
+#                                 100% density (remaining slots share one
+#                                 singleton, so they load but mark nothing new)
+#   obj8_list                     obj8: a long linked list of two-pointer nodes
+#   obj16_wide                    obj16: structs wide enough (> 255 bytes) that
+#                                 field descriptors need 16 bits
+#   stack_tasks                   stack: many suspended tasks with deep frames
+#   finlist                       finlist: objects with registered finalizers
+#   module_bindings               module bindings: modules with many globals
+#
+# Phase times come from deltas of jl_gc_telemetry around the measured
+# collections; percentiles are computed over the jl_gc_pause_record ring
+# entries produced inside the window, so shapes do not contaminate each
+# other.
+
+const HEAP_SLOTS = 1_000_000   # slots in the objarray shapes
+const LIST_NODES = 500_000     # nodes in the linked-list shape
+const WIDE_OBJS = 20_000       # wide structs in the obj16 shape
+const NTASKS = 2_000           # suspended tasks in the stack shape
+const NFINAL = 200_000         # objects with finalizers
+const NMODULES = 50            # modules in the bindings shape
+const NBINDINGS = 1_000        # bindings per module
+const COLLECTIONS = 20         # forced collections per shape
+
+struct GCTelemetry
+    collections::UInt64
+    full_sweeps::UInt64
+    mark_time::UInt64
+    sweep_pool_time::UInt64
+    sweep_big_time::UInt64
+    finalizer_time::UInt64
+    total_pause::UInt64
+    remset_len::UInt64
+    remset_nptr::UInt64
+    pages_swept::UInt64
+    pages_freed::UInt64
+    promoted_bytes::UInt64
+end
+
+struct GCPauseRecord
+    pause::UInt64
+    mark_time::UInt64
+    sweep_time::UInt64
+    freed::Int64
+    pages_swept::UInt64
+    full_sweep::UInt8
+end
+
+function telemetry()
+    r = Ref{GCTelemetry}()
+    ccall(:jl_gc_telemetry, Cvoid, (Ref{GCTelemetry},), r)
+    return r[]
+end
+
+pause_count() = ccall(:jl_gc_pause_count, UInt64, ())
+
+function pause_record(i)
+    r = Ref{GCPauseRecord}()
+    ok = ccall(:jl_gc_pause_record, Cint, (UInt64, Ref{GCPauseRecord}), i, r)
+    return ok == 0 ? nothing : r[]
+end
+
+# nearest-rank percentile, matching jl_gc_pause_percentile but over a
+# caller-selected window of records
+function percentile(v::Vector{UInt64}, p)
+    isempty(v) && return UInt64(0)
+    rank = max(1, ceil(Int, p / 100 * length(v)))
+    return v[rank]
+end
+
+function run_shape(name, build::F) where {F}
+    GC.gc(true) # drain garbage from the previous shape
+    heap = build()
+    GC.gc(true) # promote the shape, so the timed collections see it as live
+    t0 = telemetry()
+    c0 = pause_count()
+    for _ in 1:COLLECTIONS
+        GC.gc(true)
+    end
+    t1 = telemetry()
+    c1 = pause_count()
+    n = Int(t1.collections - t0.collections)
+    pauses = UInt64[]
+    for i in c0:c1-1
+        rec = pause_record(i)
+        rec === nothing || push!(pauses, rec.pause)
+    end
+    sort!(pauses)
+    mark = (t1.mark_time - t0.mark_time) ÷ n
+    sweep = (t1.sweep_pool_time + t1.sweep_big_time -
+             t0.sweep_pool_time - t0.sweep_big_time) ÷ n
+    println("{\"bench\":\"gc\",\"shape\":\"", name,
+            "\",\"mark_ns\":", mark,
+            ",\"sweep_ns\":", sweep,
+            ",\"p50_ns\":", percentile(pauses, 50),
+            ",\"p90_ns\":", percentile(pauses, 90),
+            ",\"p99_ns\":", percentile(pauses, 99),
+            ",\"max_ns\":", isempty(pauses) ? 0 : pauses[end],
+            ",\"collections\":", n, "}")
+    return heap # keep the shape live until after reporting
+end
+
+# --- objarray: pointer density in a flat Vector{Any} -------------------------
+
+struct Leaf
+    x::Int
+end
+
+function build_objarray(density)
+    v = Vector{Any}(undef, HEAP_SLOTS)
+    shared = Leaf(0)
+    for i in 1:HEAP_SLOTS
+        v[i] = i * density ÷ 100 > (i - 1) * density ÷ 100 ? Leaf(i) : shared
+    end
+    return v
+end
+
+# --- obj8: pointer chasing through small nodes -------------------------------
+
+mutable struct Node
+    next::Union{Node,Nothing}
+    payload::Any
+end
+
+function build_list()
+    head = Node(nothing, Leaf(0))
+    for i in 1:LIST_NODES
+        head = Node(head, Leaf(i))
+    end
+    return head
+end
+
+# --- obj16: objects wide enough for 16-bit field descriptors -----------------
+
+@eval mutable struct Wide
+    $([:($(Symbol(:f, i))::Any) for i in 1:40]...)
+end
+
+function build_wide()
+    v = Vector{Any}(undef, WIDE_OBJS)
+    for i in 1:WIDE_OBJS
+        v[i] = Wide(ntuple(j -> Leaf(i + j), 40)...)
+    end
+    return v
+end
+
+# --- stack: suspended tasks with deep live frames ----------------------------
+
+@noinline function deep(n, ch)
+    if n == 0
+        local x = Leaf(n) # a live root in every frame
+        take!(ch)
+        return x.x
+    end
+    return deep(n - 1, ch) + 1
+end
+
+function build_tasks()
+    chans = [Channel{Int}(0) for _ in 1:NTASKS]
+    tasks = [@async deep(100, ch) for ch in chans]
+    yield() # let every task run up to its take! before we measure
+    return (chans, tasks)
+end
+
+# --- finlist: registered finalizers ------------------------------------------
+
+function build_finalizers()
+    v = Vector{Any}(undef, NFINAL)
+    for i in 1:NFINAL
+        x = Node(nothing, nothing)
+        finalizer(x -> nothing, x)
+        v[i] = x
+    end
+    return v
+end
+
+# --- module bindings ---------------------------------------------------------
+
+function build_modules()
+    mods = Module[]
+    for m in 1:NMODULES
+        mod = Module(Symbol(:GCBench, m))
+        for b in 1:NBINDINGS
+            Core.eval(mod, :($(Symbol(:g, b)) = Leaf($b)))
+        end
+        push!(mods, mod)
+    end
+    return mods
+end
+
+# -----------------------------------------------------------------------------
+
+# each shape is live only for its own measurement window; run_shape roots
+# the heap until it has reported, and nothing retains it afterwards
+run_shape("objarray_sparse", () -> build_objarray(1))
+run_shape("objarray_half", () -> build_objarray(50))
+run_shape("objarray_dense", () -> build_objarray(100))
+run_shape("obj8_list", build_list)
+run_shape("obj16_wide", build_wide)
+chans, tasks = run_shape("stack_tasks", build_tasks)
+foreach(ch -> put!(ch, 0), chans) # unblock and retire the tasks
+foreach(wait, tasks)
+run_shape("finlist", build_finalizers)
+run_shape("module_bindings", build_modules)
@@ -0,0 +1,195 @@
+# This file is a part of Julia. License is MIT: https://julialang.org/license
+
+# Benchmark of the runtime primitives every workload sits on. Run with
+#
+#     make benchmark
+#
+# Each result is one JSON object per line:
+#
+#     {"bench":"dispatch","case":"hot_1","ns":12.3}
+#
+# where `ns` is the best observed per-operation time in nanoseconds. The
+# covered primitives and their cases:
+#
+#   dispatch   jl_apply_generic (src/gf.c): monomorphic cache-hot calls, and
+#              rotations over 8 / 64 / 1024 argument types to walk from the
+#              per-thread call cache into the shared caches and typemap
+#   alloc      jl_gc_pool_alloc (src/gc.c): 16/64/256-byte size classes, and
+#              the big-object path for comparison
+#   task       task spawn+wait through the scheduler (src/partr.c) and raw
+#              yieldto context switches (src/task.c)
+#   subtype    jl_subtype (src/subtype.c): a repeated concrete query, and
+#              rotations over many distinct tuple-type pairs of growing depth
+#
+# Comparing runs: save the output, then pass it back in
+#
+#     julia contrib/bench_runtime.jl --baseline old.json
+#
+# which appends a "delta_pct" field (relative to the baseline's ns for the
+# same bench/case) to every line, positive meaning slower than baseline.
+
+const CALLS = 100_000
+const SAMPLES = 11
+
+# Best-of-N timing: each sample times CALLS back-to-back operations and the
+# minimum is reported, which discards GC pauses and scheduler noise.
+function measure(f::F, calls::Int = CALLS) where {F}
+    f(100) # force compilation
+    best = typemax(Float64)
+    for _ in 1:SAMPLES
+        t0 = time_ns()
+        f(calls)
+        best = min(best, (time_ns() - t0) / calls)
+    end
+    return best
+end
+
+# --- baseline handling -------------------------------------------------------
+
+# parse one line of our own output; a general JSON parser is deliberately
+# not a dependency here
+function parse_result(line)
+    m = match(r"\"bench\":\"([^\"]+)\",\"case\":\"([^\"]+)\",\"ns\":([0-9.]+)", line)
+    m === nothing && return nothing
+    return (m.captures[1], m.captures[2]) => parse(Float64, m.captures[3])
+end
+
+const baseline = Dict{Tuple{String,String},Float64}()
+let i = findfirst(isequal("--baseline"), ARGS)
+    if i !== nothing
+        for line in eachline(ARGS[i + 1])
+            r = parse_result(line)
+            r === nothing || push!(baseline, r)
+        end
+    end
+end
+
+function report(bench, case, ns)
+    print("{\"bench\":\"", bench, "\",\"case\":\"", case,
+          "\",\"ns\":", round(ns, digits = 2))
+    old = get(baseline, (String(bench), String(case)), nothing)
+    if old !== nothing && old > 0
+        print(",\"delta_pct\":", round(100 * (ns - old) / old, digits = 1))
+    end
+    println("}")
+end
+
+# --- dispatch ----------------------------------------------------------------
+
+# one struct type and one method per rotation slot; calling through a
+# Vector{Any} keeps the argument type unknown so every call is a full
+# jl_apply_generic dispatch
+const NTYPES = 1024
+for i in 1:NTYPES
+    @eval struct $(Symbol(:DspArg, i)) end
+    @eval @noinline dsp(::$(Symbol(:DspArg, i))) = $i
+end
+
+const dsp_args = Any[eval(Symbol(:DspArg, i))() for i in 1:NTYPES]
+
+function bench_dispatch(n, ntypes)
+    s = 0
+    i = 0
+    for _ in 1:n
+        i = i == ntypes - 1 ? 0 : i + 1
+        s += dsp(dsp_args[i + 1])::Int
+    end
+    return s
+end
+
+report("dispatch", "hot_1", measure(n -> bench_dispatch(n, 1)))
+report("dispatch", "rotate_8", measure(n -> bench_dispatch(n, 8)))
+report("dispatch", "rotate_64", measure(n -> bench_dispatch(n, 64)))
+report("dispatch", "rotate_1024", measure(n -> bench_dispatch(n, NTYPES)))
+
+# --- pool allocation ---------------------------------------------------------
+
+mutable struct Alloc16
+    a::Int
+end
+mutable struct Alloc64
+    a::Int; b::Int; c::Int; d::Int; e::Int; f::Int; g::Int
+end
+mutable struct Alloc256
+    x::NTuple{31,Int}
+end
+mutable struct AllocBig
+    x::NTuple{300,Int}
+end
+
+# the store into a preallocated Any slot keeps the object live past the
+# statement so the allocation cannot be elided
+const alloc_sink = Vector{Any}(undef, 1)
+
+for (case, ex) in (("pool_16", :(Alloc16(i))),
+                   ("pool_64", :(Alloc64(i, i, i, i, i, i, i))),
+                   ("pool_256", :(Alloc256(ntuple(_ -> i, Val(31))))),
+                   ("big", :(AllocBig(ntuple(_ -> i, Val(300))))))
+    f = @eval function (n)
+        for i in 1:n
+            @inbounds alloc_sink[1] = $ex
+        end
+        return nothing
+    end
+    report("alloc", case, measure(f))
+end
+
+# --- tasks -------------------------------------------------------------------
+
+function bench_task_spawn(n)
+    for _ in 1:n
+        t = Task(() -> nothing)
+        schedule(t)
+        wait(t)
+    end
+end
+
+function bench_task_switch(n)
+    main = current_task()
+    t = @task begin
+        while true
+            yieldto(main)
+        end
+    end
+    for _ in 1:n
+        yieldto(t)
+    end
+end
+
+report("task", "spawn_wait", measure(bench_task_spawn, CALLS ÷ 10))
+# one iteration is two context switches (there and back)
+report("task", "switch", measure(bench_task_switch) / 2)
+
+# --- subtype -----------------------------------------------------------------
+
+jl_subtype(a, b) = ccall(:jl_subtype, Cint, (Any, Any), a, b)
+
+# distinct closed tuple-type pairs; depth grows with the index so the
+# rotation also varies the cost of an individual query
+make_pair(i, depth) = begin
+    t = eval(Symbol(:DspArg, i))
+    a = Tuple{t,Int}
+    b = Tuple{t,Integer}
+    for _ in 1:depth
+        a = Tuple{a,Vector{a}}
+        b = Tuple{b,Vector{<:b}}
+    end
+    (a, b)
+end
+
+const sub_pairs = [make_pair(i, i % 4) for i in 1:NTYPES]
+
+function bench_subtype(n, npairs)
+    s = 0
+    i = 0
+    for _ in 1:n
+        i = i == npairs - 1 ? 0 : i + 1
+        @inbounds a, b = sub_pairs[i + 1]
+        s += Int(jl_subtype(a, b))
+    end
+    return s
+end
+
+report("subtype", "hot_1", measure(n -> bench_subtype(n, 1)))
+report("subtype", "rotate_64", measure(n -> bench_subtype(n, 64)))
+report("subtype", "rotate_1024", measure(n -> bench_subtype(n, NTYPES), CALLS ÷ 10))
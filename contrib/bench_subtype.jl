@@ -0,0 +1,105 @@
+# This file is a part of Julia. License is MIT: https://julialang.org/license
+
+# Replays a corpus of recorded subtype / intersection queries and times
+# each one. Record a corpus from any real session with
+#
+#     JULIA_SUBTYPE_LOG=corpus.log julia ...
+#
+# (see src/subtype.c), then replay it with
+#
+#     make bench-subtype CORPUS=corpus.log
+#
+# Each corpus line is `kind<TAB>TypeA<TAB>TypeB` with the types printed by
+# jl_static_show. Lines whose types no longer parse or evaluate in this
+# session (e.g. private types of packages that are not loaded) are skipped
+# and counted. Output is one JSON object per line: a summary per query
+# kind, then one line per outlier — a query slower than both OUTLIER_NS
+# and OUTLIER_RATIO times the kind's median — so pathological cases are
+# named individually:
+#
+#     {"bench":"subtype","kind":"subtype","queries":..,"skipped":..,
+#      "total_ms":..,"p50_ns":..,"p99_ns":..,"max_ns":..,"outliers":..}
+#     {"bench":"subtype","outlier":true,"kind":"subtype","ns":..,
+#      "lhs":"...","rhs":"..."}
+
+const SAMPLES = 5              # per-query best-of-N
+const OUTLIER_NS = 100_000     # absolute floor for flagging a query
+const OUTLIER_RATIO = 100      # ... and relative to the kind's median
+
+jl_subtype(a, b) = ccall(:jl_subtype, Cint, (Any, Any), a, b)
+jl_intersect(a, b) = ccall(:jl_type_intersection, Any, (Any, Any), a, b)
+
+function load_corpus(file)
+    queries = Tuple{String,Any,Any,String,String}[]
+    skipped = 0
+    for line in eachline(file)
+        parts = split(line, '\t')
+        length(parts) == 3 || (skipped += 1; continue)
+        kind, lhs, rhs = parts
+        a = b = nothing
+        try
+            a = Core.eval(Main, Meta.parse(lhs))
+            b = Core.eval(Main, Meta.parse(rhs))
+        catch
+            skipped += 1
+            continue
+        end
+        if !(a isa Type && b isa Type)
+            skipped += 1
+            continue
+        end
+        push!(queries, (String(kind), a, b, String(lhs), String(rhs)))
+    end
+    return queries, skipped
+end
+
+function time_query(kind, a, b)
+    best = typemax(UInt64)
+    for _ in 1:SAMPLES
+        t0 = time_ns()
+        kind == "subtype" ? jl_subtype(a, b) : jl_intersect(a, b)
+        best = min(best, time_ns() - t0)
+    end
+    return best
+end
+
+json_str(s) = replace(replace(s, '\\' => "\\\\"), '"' => "\\\"")
+
+function replay(queries, skipped)
+    times = Dict{String,Vector{Tuple{UInt64,Int}}}() # kind => [(ns, query idx)]
+    for (i, (kind, a, b, _, _)) in enumerate(queries)
+        push!(get!(() -> Tuple{UInt64,Int}[], times, kind), (time_query(kind, a, b), i))
+    end
+    for (kind, v) in times
+        sort!(v, by = first)
+        ns = first.(v)
+        n = length(ns)
+        p(q) = ns[max(1, ceil(Int, q * n))]
+        median = p(0.5)
+        cutoff = max(UInt64(OUTLIER_NS), OUTLIER_RATIO * median)
+        outliers = [x for x in v if x[1] > cutoff]
+        println("{\"bench\":\"subtype\",\"kind\":\"", kind,
+                "\",\"queries\":", n,
+                ",\"skipped\":", skipped,
+                ",\"total_ms\":", round(sum(ns) / 1e6, digits = 2),
+                ",\"p50_ns\":", median,
+                ",\"p99_ns\":", p(0.99),
+                ",\"max_ns\":", ns[end],
+                ",\"outliers\":", length(outliers), "}")
+        for (t, i) in outliers
+            _, _, _, lhs, rhs = queries[i]
+            println("{\"bench\":\"subtype\",\"outlier\":true,\"kind\":\"", kind,
+                    "\",\"ns\":", t,
+                    ",\"lhs\":\"", json_str(lhs),
+                    "\",\"rhs\":\"", json_str(rhs), "\"}")
+        end
+    end
+end
+
+if isempty(ARGS)
+    println(stderr, "usage: julia contrib/bench_subtype.jl <corpus file>")
+    println(stderr, "record one with JULIA_SUBTYPE_LOG=<file>")
+    exit(2)
+end
+queries, skipped = load_corpus(ARGS[1])
+replay(queries, skipped)
@@ -0,0 +1,86 @@
+#!/usr/bin/env python
+# This file is a part of Julia. License is MIT: https://julialang.org/license
+
+# Decoder for the binary GC event log written by jl_gc_event_log_stop
+# (src/gc-debug.c). Usage: gc_event_log.py <dumpfile>
+#
+# The file is a 16-byte header ("JLGCEV", format version byte, record size
+# byte, uint64 record count) followed by fixed-size records, in the byte
+# order of the machine that wrote them (assumed little-endian here).
+
+from __future__ import print_function
+import struct
+import sys
+
+EV_NAMES = {
+    1: "mark",
+    2: "pool sweep begin",
+    3: "pool sweep end",
+    4: "sysimg sweep",
+    5: "big sweep begin",
+    6: "big sweep end",
+    7: "array sweep begin",
+    8: "array sweep end",
+    9: "collect end",
+}
+
+
+def fmt(ev, flags, data):
+    full = " full" if flags & 0x1 else ""
+    if ev == 1:
+        return ("pause %.2f ms, scanned %d kB (+%d kB perm), "
+                "remset %d len %d ptrs" %
+                (data[0] / 1e6, data[1] // 1024, data[2] // 1024,
+                 data[3], data[4]))
+    if ev == 3:
+        skipped = (100.0 * data[1] / data[0]) if data[0] else 0.0
+        return ("%d pages, %.1f%% skipped, %d freed (%d lazily)%s" %
+                (data[0], skipped, data[2], data[3], full))
+    if ev == 4:
+        return "%.2f ms" % (data[0] / 1e6)
+    if ev == 6:
+        return "%d objects, %d freed, %d reset" % (data[0], data[1], data[2])
+    if ev == 8:
+        return "%d arrays, %d freed" % (data[0], data[1])
+    if ev == 9:
+        return ("sweep pause %.2f ms, live %d kB, freed %d kB "
+                "(est %d kB), allocd %d kB%s" %
+                (data[0] / 1e6, data[1] // 1024, data[2] // 1024,
+                 data[3] // 1024, data[4] // 1024, full))
+    return ""
+
+
+def main():
+    if len(sys.argv) != 2:
+        print("usage: gc_event_log.py <dumpfile>", file=sys.stderr)
+        return 1
+    with open(sys.argv[1], "rb") as f:
+        header = f.read(16)
+        if len(header) != 16 or header[:6] != b"JLGCEV":
+            print("not a GC event log", file=sys.stderr)
+            return 1
+        version = struct.unpack_from("B", header, 6)[0]
+        recsize = struct.unpack_from("B", header, 7)[0]
+        count = struct.unpack_from("<Q", header, 8)[0]
+        if version != 1 or recsize != 56:
+            print("unsupported format (version %d, record size %d)" %
+                  (version, recsize), file=sys.stderr)
+            return 1
+        t_first = None
+        for _ in range(count):
+            rec = f.read(recsize)
+            if len(rec) != recsize:
+                print("truncated file", file=sys.stderr)
+                return 1
+            t, ev, flags = struct.unpack_from("<QHH", rec, 0)
+            data = struct.unpack_from("<5q", rec, 16)
+            if t_first is None:
+                t_first = t
+            print("%12.3f ms  %-17s %s" %
+                  ((t - t_first) / 1e6, EV_NAMES.get(ev, "?%d" % ev),
+                   fmt(ev, flags, data)))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -48,8 +48,34 @@ const unsigned int host_char_bit = 8;
     else \
         memcpy(p##r, a.getRawData(), RoundUpToAlignment(numbits, host_char_bit) / host_char_bit); \
 
+#ifdef __SIZEOF_INT128__
+// Direct two's-complement specializations for the 128 bit width. APInt keeps
+// widths over 64 bits in heap storage, so routing Int128 through
+// CREATE/ASSIGN mallocs (twice per binary op) on every interpreter-executed
+// or runtime-fallback operation. The loads and stores go through memcpy
+// because julia Int128 values are only guaranteed 8-byte alignment.
+typedef unsigned __int128 uint128_jl;
+typedef __int128 int128_jl;
+
+static inline uint128_jl LOAD128(const integerPart *p) {
+    uint128_jl x;
+    memcpy(&x, p, sizeof(x));
+    return x;
+}
+static inline void STORE128(integerPart *p, uint128_jl x) {
+    memcpy(p, &x, sizeof(x));
+}
+#define INT128_MIN_jl ((int128_jl)((uint128_jl)1 << 127))
+#endif
+
 extern "C" JL_DLLEXPORT
 void LLVMNeg(unsigned numbits, integerPart *pa, integerPart *pr) {
+#ifdef __SIZEOF_INT128__
+    if (numbits == 128) {
+        STORE128(pr, (uint128_jl)0 - LOAD128(pa));
+        return;
+    }
+#endif
     APInt z(numbits, 0);
     CREATE(a)
     z -= a;
@@ -58,6 +84,12 @@ void LLVMNeg(unsigned numbits, integerPart *pa, integerPart *pr) {
 
 extern "C" JL_DLLEXPORT
 void LLVMAdd(unsigned numbits, integerPart *pa, integerPart *pb, integerPart *pr) {
+#ifdef __SIZEOF_INT128__
+    if (numbits == 128) {
+        STORE128(pr, LOAD128(pa) + LOAD128(pb));
+        return;
+    }
+#endif
     CREATE(a)
     CREATE(b)
     a += b;
@@ -66,6 +98,12 @@ void LLVMAdd(unsigned numbits, integerPart *pa, integerPart *pb, integerPart *pr
 
 extern "C" JL_DLLEXPORT
 void LLVMSub(unsigned numbits, integerPart *pa, integerPart *pb, integerPart *pr) {
+#ifdef __SIZEOF_INT128__
+    if (numbits == 128) {
+        STORE128(pr, LOAD128(pa) - LOAD128(pb));
+        return;
+    }
+#endif
     CREATE(a)
     CREATE(b)
     a -= b;
@@ -74,6 +112,12 @@ void LLVMSub(unsigned numbits, integerPart *pa, integerPart *pb, integerPart *pr
 
 extern "C" JL_DLLEXPORT
 void LLVMMul(unsigned numbits, integerPart *pa, integerPart *pb, integerPart *pr) {
+#ifdef __SIZEOF_INT128__
+    if (numbits == 128) {
+        STORE128(pr, LOAD128(pa) * LOAD128(pb));
+        return;
+    }
+#endif
     CREATE(a)
     CREATE(b)
     a *= b;
@@ -106,6 +150,10 @@ void LLVMURem(unsigned numbits, integerPart *pa, integerPart *pb, integerPart *p
 
 extern "C" JL_DLLEXPORT
 int LLVMICmpEQ(unsigned numbits, integerPart *pa, integerPart *pb) {
+#ifdef __SIZEOF_INT128__
+    if (numbits == 128)
+        return LOAD128(pa) == LOAD128(pb);
+#endif
     CREATE(a)
     CREATE(b)
     return a.eq(b);
@@ -113,6 +161,10 @@ int LLVMICmpEQ(unsigned numbits, integerPart *pa, integerPart *pb) {
 
 extern "C" JL_DLLEXPORT
 int LLVMICmpNE(unsigned numbits, integerPart *pa, integerPart *pb) {
+#ifdef __SIZEOF_INT128__
+    if (numbits == 128)
+        return LOAD128(pa) != LOAD128(pb);
+#endif
     CREATE(a)
     CREATE(b)
     return a.ne(b);
@@ -120,6 +172,10 @@ int LLVMICmpNE(unsigned numbits, integerPart *pa, integerPart *pb) {
 
 extern "C" JL_DLLEXPORT
 int LLVMICmpSLT(unsigned numbits, integerPart *pa, integerPart *pb) {
+#ifdef __SIZEOF_INT128__
+    if (numbits == 128)
+        return (int128_jl)LOAD128(pa) < (int128_jl)LOAD128(pb);
+#endif
     CREATE(a)
     CREATE(b)
     return a.slt(b);
@@ -127,6 +183,10 @@ int LLVMICmpSLT(unsigned numbits, integerPart *pa, integerPart *pb) {
 
 extern "C" JL_DLLEXPORT
 int LLVMICmpULT(unsigned numbits, integerPart *pa, integerPart *pb) {
+#ifdef __SIZEOF_INT128__
+    if (numbits == 128)
+        return LOAD128(pa) < LOAD128(pb);
+#endif
     CREATE(a)
     CREATE(b)
     return a.ult(b);
@@ -134,6 +194,10 @@ int LLVMICmpULT(unsigned numbits, integerPart *pa, integerPart *pb) {
 
 extern "C" JL_DLLEXPORT
 int LLVMICmpSLE(unsigned numbits, integerPart *pa, integerPart *pb) {
+#ifdef __SIZEOF_INT128__
+    if (numbits == 128)
+        return (int128_jl)LOAD128(pa) <= (int128_jl)LOAD128(pb);
+#endif
     CREATE(a)
     CREATE(b)
     return a.sle(b);
@@ -141,6 +205,10 @@ int LLVMICmpSLE(unsigned numbits, integerPart *pa, integerPart *pb) {
 
 extern "C" JL_DLLEXPORT
 int LLVMICmpULE(unsigned numbits, integerPart *pa, integerPart *pb) {
+#ifdef __SIZEOF_INT128__
+    if (numbits == 128)
+        return LOAD128(pa) <= LOAD128(pb);
+#endif
     CREATE(a)
     CREATE(b)
     return a.ule(b);
@@ -148,6 +216,12 @@ int LLVMICmpULE(unsigned numbits, integerPart *pa, integerPart *pb) {
 
 extern "C" JL_DLLEXPORT
 void LLVMAnd(unsigned numbits, integerPart *pa, integerPart *pb, integerPart *pr) {
+#ifdef __SIZEOF_INT128__
+    if (numbits == 128) {
+        STORE128(pr, LOAD128(pa) & LOAD128(pb));
+        return;
+    }
+#endif
     CREATE(a)
     CREATE(b)
     a &= b;
@@ -156,6 +230,12 @@ void LLVMAnd(unsigned numbits, integerPart *pa, integerPart *pb, integerPart *pr
 
 extern "C" JL_DLLEXPORT
 void LLVMOr(unsigned numbits, integerPart *pa, integerPart *pb, integerPart *pr) {
+#ifdef __SIZEOF_INT128__
+    if (numbits == 128) {
+        STORE128(pr, LOAD128(pa) | LOAD128(pb));
+        return;
+    }
+#endif
     CREATE(a)
     CREATE(b)
     a |= b;
@@ -164,6 +244,12 @@ void LLVMOr(unsigned numbits, integerPart *pa, integerPart *pb, integerPart *pr)
 
 extern "C" JL_DLLEXPORT
 void LLVMXor(unsigned numbits, integerPart *pa, integerPart *pb, integerPart *pr) {
+#ifdef __SIZEOF_INT128__
+    if (numbits == 128) {
+        STORE128(pr, LOAD128(pa) ^ LOAD128(pb));
+        return;
+    }
+#endif
     CREATE(a)
     CREATE(b)
     a ^= b;
@@ -172,6 +258,14 @@ void LLVMXor(unsigned numbits, integerPart *pa, integerPart *pb, integerPart *pr
 
 extern "C" JL_DLLEXPORT
 void LLVMShl(unsigned numbits, integerPart *pa, integerPart *pb, integerPart *pr) {
+#ifdef __SIZEOF_INT128__
+    if (numbits == 128) {
+        uint128_jl b = LOAD128(pb);
+        // match APInt::shl, which yields 0 for shift amounts >= the bit width
+        STORE128(pr, b < 128 ? LOAD128(pa) << (unsigned)b : 0);
+        return;
+    }
+#endif
     CREATE(a)
     CREATE(b)
     a = a.shl(b);
@@ -180,6 +274,13 @@ void LLVMShl(unsigned numbits, integerPart *pa, integerPart *pb, integerPart *pr
 
 extern "C" JL_DLLEXPORT
 void LLVMLShr(unsigned numbits, integerPart *pa, integerPart *pb, integerPart *pr) {
+#ifdef __SIZEOF_INT128__
+    if (numbits == 128) {
+        uint128_jl b = LOAD128(pb);
+        STORE128(pr, b < 128 ? LOAD128(pa) >> (unsigned)b : 0);
+        return;
+    }
+#endif
     CREATE(a)
     CREATE(b)
     a = a.lshr(b);
@@ -187,6 +288,15 @@ void LLVMLShr(unsigned numbits, integerPart *pa, integerPart *pb, integerPart *p
 }
 extern "C" JL_DLLEXPORT
 void LLVMAShr(unsigned numbits, integerPart *pa, integerPart *pb, integerPart *pr) {
+#ifdef __SIZEOF_INT128__
+    if (numbits == 128) {
+        uint128_jl b = LOAD128(pb);
+        int128_jl a = (int128_jl)LOAD128(pa);
+        // APInt::ashr saturates to the sign fill for shift amounts >= the bit width
+        STORE128(pr, (uint128_jl)(b < 128 ? a >> (unsigned)b : a >> 127));
+        return;
+    }
+#endif
     CREATE(a)
     CREATE(b)
     a = a.ashr(b);
@@ -195,6 +305,12 @@ void LLVMAShr(unsigned numbits, integerPart *pa, integerPart *pb, integerPart *p
 
 extern "C" JL_DLLEXPORT
 void LLVMFlipAllBits(unsigned numbits, integerPart *pa, integerPart *pr) {
+#ifdef __SIZEOF_INT128__
+    if (numbits == 128) {
+        STORE128(pr, ~LOAD128(pa));
+        return;
+    }
+#endif
     CREATE(a)
     a.flipAllBits();
     ASSIGN(r, a)
@@ -202,6 +318,14 @@ void LLVMFlipAllBits(unsigned numbits, integerPart *pa, integerPart *pr) {
 
 extern "C" JL_DLLEXPORT
 int LLVMAdd_uov(unsigned numbits, integerPart *pa, integerPart *pb, integerPart *pr) {
+#ifdef __SIZEOF_INT128__
+    if (numbits == 128) {
+        uint128_jl r;
+        int ovflw = __builtin_add_overflow((uint128_jl)LOAD128(pa), (uint128_jl)LOAD128(pb), &r);
+        STORE128(pr, (uint128_jl)r);
+        return ovflw;
+    }
+#endif
     CREATE(a)
     CREATE(b)
     bool Overflow;
@@ -212,6 +336,14 @@ int LLVMAdd_uov(unsigned numbits, integerPart *pa, integerPart *pb, integerPart
 
 extern "C" JL_DLLEXPORT
 int LLVMAdd_sov(unsigned numbits, integerPart *pa, integerPart *pb, integerPart *pr) {
+#ifdef __SIZEOF_INT128__
+    if (numbits == 128) {
+        int128_jl r;
+        int ovflw = __builtin_add_overflow((int128_jl)LOAD128(pa), (int128_jl)LOAD128(pb), &r);
+        STORE128(pr, (uint128_jl)r);
+        return ovflw;
+    }
+#endif
     CREATE(a)
     CREATE(b)
     bool Overflow;
@@ -222,6 +354,14 @@ int LLVMAdd_sov(unsigned numbits, integerPart *pa, integerPart *pb, integerPart
 
 extern "C" JL_DLLEXPORT
 int LLVMSub_uov(unsigned numbits, integerPart *pa, integerPart *pb, integerPart *pr) {
+#ifdef __SIZEOF_INT128__
+    if (numbits == 128) {
+        uint128_jl r;
+        int ovflw = __builtin_sub_overflow((uint128_jl)LOAD128(pa), (uint128_jl)LOAD128(pb), &r);
+        STORE128(pr, (uint128_jl)r);
+        return ovflw;
+    }
+#endif
     CREATE(a)
     CREATE(b)
     bool Overflow;
@@ -232,6 +372,14 @@ int LLVMSub_uov(unsigned numbits, integerPart *pa, integerPart *pb, integerPart
 
 extern "C" JL_DLLEXPORT
 int LLVMSub_sov(unsigned numbits, integerPart *pa, integerPart *pb, integerPart *pr) {
+#ifdef __SIZEOF_INT128__
+    if (numbits == 128) {
+        int128_jl r;
+        int ovflw = __builtin_sub_overflow((int128_jl)LOAD128(pa), (int128_jl)LOAD128(pb), &r);
+        STORE128(pr, (uint128_jl)r);
+        return ovflw;
+    }
+#endif
     CREATE(a)
     CREATE(b)
     bool Overflow;
@@ -242,6 +390,21 @@ int LLVMSub_sov(unsigned numbits, integerPart *pa, integerPart *pb, integerPart
 
 extern "C" JL_DLLEXPORT
 int LLVMMul_sov(unsigned numbits, integerPart *pa, integerPart *pb, integerPart *pr) {
+#ifdef __SIZEOF_INT128__
+    if (numbits == 128) {
+        // __builtin_mul_overflow on __int128 emits a call to __muloti4, which
+        // libgcc does not provide, so check with a division instead
+        int128_jl a = (int128_jl)LOAD128(pa);
+        int128_jl b = (int128_jl)LOAD128(pb);
+        int128_jl r = (int128_jl)((uint128_jl)a * (uint128_jl)b);
+        STORE128(pr, (uint128_jl)r);
+        if (a == 0)
+            return false;
+        if (a == -1)
+            return b == INT128_MIN_jl;
+        return r / a != b;
+    }
+#endif
     CREATE(a)
     CREATE(b)
     bool Overflow;
@@ -252,6 +415,15 @@ int LLVMMul_sov(unsigned numbits, integerPart *pa, integerPart *pb, integerPart
 
 extern "C" JL_DLLEXPORT
 int LLVMMul_uov(unsigned numbits, integerPart *pa, integerPart *pb, integerPart *pr) {
+#ifdef __SIZEOF_INT128__
+    if (numbits == 128) {
+        uint128_jl a = LOAD128(pa);
+        uint128_jl b = LOAD128(pb);
+        uint128_jl r = a * b;
+        STORE128(pr, r);
+        return a != 0 && r / a != b;
+    }
+#endif
     CREATE(a)
     CREATE(b)
     bool Overflow;
@@ -262,6 +434,16 @@ int LLVMMul_uov(unsigned numbits, integerPart *pa, integerPart *pb, integerPart
 
 extern "C" JL_DLLEXPORT
 int LLVMDiv_sov(unsigned numbits, integerPart *pa, integerPart *pb, integerPart *pr) {
+#ifdef __SIZEOF_INT128__
+    if (numbits == 128) {
+        int128_jl a = (int128_jl)LOAD128(pa);
+        int128_jl b = (int128_jl)LOAD128(pb);
+        if (b == 0 || (a == INT128_MIN_jl && b == -1))
+            return true;
+        STORE128(pr, (uint128_jl)(a / b));
+        return false;
+    }
+#endif
     CREATE(a)
     CREATE(b)
     if (!b)
@@ -274,6 +456,15 @@ int LLVMDiv_sov(unsigned numbits, integerPart *pa, integerPart *pb, integerPart
 
 extern "C" JL_DLLEXPORT
 int LLVMDiv_uov(unsigned numbits, integerPart *pa, integerPart *pb, integerPart *pr) {
+#ifdef __SIZEOF_INT128__
+    if (numbits == 128) {
+        uint128_jl b = LOAD128(pb);
+        if (b == 0)
+            return true;
+        STORE128(pr, LOAD128(pa) / b);
+        return false;
+    }
+#endif
     CREATE(a)
     CREATE(b)
     if (!b)
@@ -285,6 +476,17 @@ int LLVMDiv_uov(unsigned numbits, integerPart *pa, integerPart *pb, integerPart
 
 extern "C" JL_DLLEXPORT
 int LLVMRem_sov(unsigned numbits, integerPart *pa, integerPart *pb, integerPart *pr) {
+#ifdef __SIZEOF_INT128__
+    if (numbits == 128) {
+        int128_jl a = (int128_jl)LOAD128(pa);
+        int128_jl b = (int128_jl)LOAD128(pb);
+        if (b == 0)
+            return true;
+        // INT128_MIN % -1 is 0 mathematically but traps in hardware
+        STORE128(pr, b == -1 ? 0 : (uint128_jl)(a % b));
+        return false;
+    }
+#endif
     CREATE(a)
     CREATE(b)
     if (!b)
@@ -296,6 +498,15 @@ int LLVMRem_sov(unsigned numbits, integerPart *pa, integerPart *pb, integerPart
 
 extern "C" JL_DLLEXPORT
 int LLVMRem_uov(unsigned numbits, integerPart *pa, integerPart *pb, integerPart *pr) {
+#ifdef __SIZEOF_INT128__
+    if (numbits == 128) {
+        uint128_jl b = LOAD128(pb);
+        if (b == 0)
+            return true;
+        STORE128(pr, LOAD128(pa) % b);
+        return false;
+    }
+#endif
     CREATE(a)
     CREATE(b)
     if (!b)
@@ -307,6 +518,14 @@ int LLVMRem_uov(unsigned numbits, integerPart *pa, integerPart *pb, integerPart
 
 extern "C" JL_DLLEXPORT
 void LLVMByteSwap(unsigned numbits, integerPart *pa, integerPart *pr) {
+#ifdef __SIZEOF_INT128__
+    if (numbits == 128) {
+        uint128_jl a = LOAD128(pa);
+        STORE128(pr, ((uint128_jl)__builtin_bswap64((uint64_t)a) << 64) |
+                     __builtin_bswap64((uint64_t)(a >> 64)));
+        return;
+    }
+#endif
     CREATE(a)
     a = a.byteSwap();
     ASSIGN(r, a)
@@ -476,6 +695,21 @@ unsigned countTrailingZeros_64(uint64_t Val) {
 
 extern "C" JL_DLLEXPORT
 void jl_LLVMSMod(unsigned numbits, integerPart *pa, integerPart *pb, integerPart *pr) {
+#ifdef __SIZEOF_INT128__
+    if (numbits == 128) {
+        int128_jl a = (int128_jl)LOAD128(pa);
+        int128_jl b = (int128_jl)LOAD128(pb);
+        if (b != 0) {
+            // INT128_MIN % -1 is 0 mathematically but traps in hardware
+            int128_jl r = b == -1 ? 0 : a % b;
+            if (r != 0 && (a < 0) != (b < 0))
+                r += b;
+            STORE128(pr, (uint128_jl)r);
+            return;
+        }
+        jl_throw(jl_diverror_exception);
+    }
+#endif
     { // end scope before jl_error call
         CREATE(a)
         CREATE(b)
@@ -504,30 +738,64 @@ void jl_LLVMFlipSign(unsigned numbits, integerPart *pa, integerPart *pb, integer
 
 extern "C" JL_DLLEXPORT
 unsigned LLVMCountPopulation(unsigned numbits, integerPart *pa) {
+#ifdef __SIZEOF_INT128__
+    if (numbits == 128) {
+        uint128_jl a = LOAD128(pa);
+        return __builtin_popcountll((uint64_t)a) + __builtin_popcountll((uint64_t)(a >> 64));
+    }
+#endif
     CREATE(a)
     return a.countPopulation();
 }
 
 extern "C" JL_DLLEXPORT
 unsigned LLVMCountTrailingOnes(unsigned numbits, integerPart *pa) {
+#ifdef __SIZEOF_INT128__
+    if (numbits == 128) {
+        uint128_jl a = ~LOAD128(pa);
+        uint64_t lo = (uint64_t)a, hi = (uint64_t)(a >> 64);
+        return lo ? __builtin_ctzll(lo) : (hi ? 64 + __builtin_ctzll(hi) : 128);
+    }
+#endif
     CREATE(a)
     return a.countTrailingOnes();
 }
 
 extern "C" JL_DLLEXPORT
 unsigned LLVMCountTrailingZeros(unsigned numbits, integerPart *pa) {
+#ifdef __SIZEOF_INT128__
+    if (numbits == 128) {
+        uint128_jl a = LOAD128(pa);
+        uint64_t lo = (uint64_t)a, hi = (uint64_t)(a >> 64);
+        return lo ? __builtin_ctzll(lo) : (hi ? 64 + __builtin_ctzll(hi) : 128);
+    }
+#endif
     CREATE(a)
     return a.countTrailingZeros();
 }
 
 extern "C" JL_DLLEXPORT
 unsigned LLVMCountLeadingOnes(unsigned numbits, integerPart *pa) {
+#ifdef __SIZEOF_INT128__
+    if (numbits == 128) {
+        uint128_jl a = ~LOAD128(pa);
+        uint64_t lo = (uint64_t)a, hi = (uint64_t)(a >> 64);
+        return hi ? __builtin_clzll(hi) : (lo ? 64 + __builtin_clzll(lo) : 128);
+    }
+#endif
     CREATE(a)
     return a.countLeadingOnes();
 }
 
 extern "C" JL_DLLEXPORT
 unsigned LLVMCountLeadingZeros(unsigned numbits, integerPart *pa) {
+#ifdef __SIZEOF_INT128__
+    if (numbits == 128) {
+        uint128_jl a = LOAD128(pa);
+        uint64_t lo = (uint64_t)a, hi = (uint64_t)(a >> 64);
+        return hi ? __builtin_clzll(hi) : (lo ? 64 + __builtin_clzll(lo) : 128);
+    }
+#endif
     CREATE(a)
     return a.countLeadingZeros();
 }
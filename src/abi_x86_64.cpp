@@ -145,6 +145,11 @@ void classifyType(Classification& accum, jl_datatype_t *dt, uint64_t offset) con
     // struct types that map to SIMD registers
     else if (is_native_simd_type(dt)) {
         accum.addField(offset, Sse);
+        // a 16 byte vector occupies both eightbytes of its register
+        // (SSE + SSEUP); leaving the second eightbyte as NoClass would
+        // truncate the value when the vector is wrapped in another struct
+        if (jl_datatype_size(dt) > 8)
+            accum.addField(offset + 8, SseUp);
     }
     // Other struct types
     else if (jl_datatype_size(dt) <= 16) {
@@ -165,6 +170,10 @@ Classification classify(jl_datatype_t *dt) const
 {
     Classification cl;
     classifyType(cl, dt, 0);
+    // post-merger cleanup (SysV 3.2.3 rule 5c): an SSEUP not preceded by
+    // SSE or SSEUP is converted to SSE
+    if (cl.classes[1] == SseUp && cl.classes[0] != Sse)
+        cl.classes[1] = Sse;
     return cl;
 }
 
@@ -256,6 +265,10 @@ Type *preferred_llvm_type(jl_datatype_t *dt, bool isret) const override
             else
                 types[1] = T_float64;
             return StructType::get(jl_LLVMContext,ArrayRef<Type*>(&types[0],2));
+        case SseUp:
+            // both eightbytes form one vector register
+            assert(size > 8 && cl.classes[0] == Sse);
+            return VectorType::get(T_float64, 2);
         default:
             assert(0 && "Unexpected cl.classes[0]");
     }
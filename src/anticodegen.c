@@ -67,3 +67,4 @@ JL_DLLEXPORT uint32_t jl_get_LLVM_VERSION(void)
 }
 
 jl_array_t *jl_cfunction_list;
+jl_array_t *jl_cfunction_tramp_list;
@@ -49,6 +49,62 @@ typedef uint64_t wideint_t;
 #endif
 
 size_t jl_arr_xtralloc_limit = 0;
+// growth policy: double while the buffer is below the threshold, then grow
+// by the configured percentage (JULIA_ARRAY_GROWTH_PCT, clamped to >=110,
+// over buffers bigger than JULIA_ARRAY_GROWTH_THRESHOLD bytes). Doubling
+// forever leaves long-lived vectors averaging ~55% utilization; a gentler
+// tail factor trades a few more reallocs for much less slack.
+size_t jl_arr_growth_pct = 150;
+size_t jl_arr_growth_thresh = 1 << 20;
+
+#if defined(_CPU_X86_64_) && !defined(_COMPILER_MICROSOFT_)
+#include <emmintrin.h>
+#endif
+
+// Copies of at least this many bytes bypass the caches with non-temporal
+// stores (JULIA_NT_COPY_THRESHOLD; 0 disables). A plain memcpy of a
+// multi-GB array evicts the entire cache hierarchy for data the caller
+// usually does not read back right away.
+size_t jl_nt_copy_thresh = 4 * 1024 * 1024;
+
+// memcpy for array data that switches to cache-bypassing stores above
+// jl_nt_copy_thresh. The buffers must not overlap.
+static void jl_array_memcpy(void *dst, const void *src, size_t nb) JL_NOTSAFEPOINT
+{
+#if defined(_CPU_X86_64_) && !defined(_COMPILER_MICROSOFT_)
+    // nb >= 16 keeps the alignment head below; the threshold is clamped at
+    // startup (see init.c) but guard here regardless
+    if (__unlikely(jl_nt_copy_thresh && nb >= jl_nt_copy_thresh && nb >= 16)) {
+        char *d = (char*)dst;
+        const char *s = (const char*)src;
+        // streaming stores must be 16-byte aligned; the loads need not be
+        size_t head = (16 - ((uintptr_t)d & 15)) & 15;
+        if (head) {
+            memcpy(d, s, head);
+            d += head;
+            s += head;
+            nb -= head;
+        }
+        size_t nv = nb & ~(size_t)63;
+        for (size_t i = 0; i < nv; i += 64) {
+            __m128i x0 = _mm_loadu_si128((const __m128i*)(s + i));
+            __m128i x1 = _mm_loadu_si128((const __m128i*)(s + i + 16));
+            __m128i x2 = _mm_loadu_si128((const __m128i*)(s + i + 32));
+            __m128i x3 = _mm_loadu_si128((const __m128i*)(s + i + 48));
+            _mm_stream_si128((__m128i*)(d + i), x0);
+            _mm_stream_si128((__m128i*)(d + i + 16), x1);
+            _mm_stream_si128((__m128i*)(d + i + 32), x2);
+            _mm_stream_si128((__m128i*)(d + i + 48), x3);
+        }
+        // order the streaming stores before any subsequent read of the copy
+        _mm_sfence();
+        if (nb > nv)
+            memcpy(d + nv, s + nv, nb - nv);
+        return;
+    }
+#endif
+    memcpy(dst, src, nb);
+}
 
 #define MAXINTVAL (((size_t)-1)>>1)
 
@@ -468,11 +524,67 @@ JL_DLLEXPORT jl_value_t *jl_array_to_string(jl_array_t *a)
     return jl_pchar_to_string((const char*)jl_array_data(a), len);
 }
 
+// Optional string interning: `JULIA_STRING_INTERN=<n>` hash-conses strings of
+// up to `n` bytes created through `jl_pchar_to_string` in a direct-mapped
+// cache keyed by `memhash`, so repetitive workloads (log processing etc.)
+// share one object per distinct value instead of bloating the heap and the
+// mark phase. Strings are interned only here, where the contents are final;
+// `jl_alloc_string` callers fill the buffer afterwards and must not share.
+// The cache slots are marked as roots (see `mark_roots` in gc.c), which
+// bounds the pinned memory to the cache size times the length threshold.
+jl_value_t **jl_string_intern_cache = NULL;
+static int string_intern_max_len = -2; // -2 until the env var is checked
+static jl_mutex_t string_intern_lock = {0, 0};
+
+static int string_intern_enabled(void)
+{
+    int max = string_intern_max_len;
+    if (__unlikely(max == -2)) {
+        JL_LOCK_NOGC(&string_intern_lock);
+        max = string_intern_max_len;
+        if (max == -2) {
+            char *cp = getenv("JULIA_STRING_INTERN");
+            max = cp ? (int)strtol(cp, NULL, 10) : 0;
+            if (max > 0)
+                jl_string_intern_cache =
+                    (jl_value_t**)calloc(JL_STRING_INTERN_CACHE_SZ, sizeof(void*));
+            string_intern_max_len = max;
+        }
+        JL_UNLOCK_NOGC(&string_intern_lock);
+    }
+    return max;
+}
+
+static jl_value_t *string_intern(const char *str, size_t len)
+{
+    size_t slot = memhash(str, len) % JL_STRING_INTERN_CACHE_SZ;
+    JL_LOCK_NOGC(&string_intern_lock);
+    jl_value_t *s = jl_string_intern_cache[slot];
+    if (s && jl_string_len(s) == len &&
+        memcmp(jl_string_data(s), str, len) == 0) {
+        JL_UNLOCK_NOGC(&string_intern_lock);
+        return s;
+    }
+    JL_UNLOCK_NOGC(&string_intern_lock);
+    // allocate outside the lock; the allocation may trigger a collection
+    s = jl_gc_alloc_(jl_get_ptls_states(), sizeof(size_t) + len + 1, jl_string_type);
+    *(size_t*)s = len;
+    memcpy((char*)s + sizeof(size_t), str, len);
+    ((char*)s + sizeof(size_t))[len] = 0;
+    JL_LOCK_NOGC(&string_intern_lock);
+    jl_string_intern_cache[slot] = s; // evicts a colliding entry, if any
+    JL_UNLOCK_NOGC(&string_intern_lock);
+    return s;
+}
+
 JL_DLLEXPORT jl_value_t *jl_pchar_to_string(const char *str, size_t len)
 {
     size_t sz = sizeof(size_t) + len + 1; // add space for trailing \nul protector and size
     if (len == 0)
         return jl_an_empty_string;
+    int intern_max = string_intern_enabled();
+    if (__unlikely(intern_max > 0 && len <= (size_t)intern_max))
+        return string_intern(str, len);
     jl_value_t *s = jl_gc_alloc_(jl_get_ptls_states(), sz, jl_string_type); // force inlining
     *(size_t*)s = len;
     memcpy((char*)s + sizeof(size_t), str, len);
@@ -665,7 +777,11 @@ static int NOINLINE array_resize_buffer(jl_array_t *a, size_t newlen)
         }
     }
     if (JL_ARRAY_IMPL_NUL && elsz == 1 && !isbitsunion)
-        memset((char*)a->data + oldnbytes - 1, 0, nbytes - oldnbytes + 1);
+        // only the NUL protector in the last capacity byte has to be
+        // maintained (matching `_new_array_`); the rest of the grown region
+        // is undef to the caller, and zeroing it evicts cache for nothing
+        // when growing multi-gigabyte I/O buffers
+        ((char*)a->data)[nbytes - 1] = '\0';
     (void)oldlen;
     assert(oldlen == a->nrows &&
            "Race condition detected: recursive resizing on the same array.");
@@ -692,10 +808,19 @@ static void NOINLINE array_try_unshare(jl_array_t *a)
         int newbuf = array_resize_buffer(a, len);
         assert(newbuf);
         (void)newbuf;
-        memcpy(a->data, olddata, nbytes);
+        jl_array_memcpy(a->data, olddata, nbytes);
     }
 }
 
+// next capacity step when growing a buffer of oldmax elements
+STATIC_INLINE size_t jl_array_next_cap(jl_array_t *a, size_t oldmax)
+{
+    if (oldmax * a->elsize < jl_arr_growth_thresh)
+        return oldmax * 2;
+    size_t newmax = oldmax + (oldmax / 100) * (jl_arr_growth_pct - 100);
+    return newmax > oldmax ? newmax : oldmax * 2;
+}
+
 static size_t limit_overallocation(jl_array_t *a, size_t alen, size_t newlen, size_t inc)
 {
     // Limit overallocation to jl_arr_xtralloc_limit
@@ -753,9 +878,9 @@ STATIC_INLINE void jl_array_grow_at_beg(jl_array_t *a, size_t idx, size_t inc,
         size_t nb1 = idx * elsz;
         if (inc > (a->maxsize - n) / 2 - (a->maxsize - n) / 20) {
             // not enough room for requested growth from end of array
-            size_t newlen = a->maxsize == 0 ? inc * 2 : a->maxsize * 2;
+            size_t newlen = a->maxsize == 0 ? inc * 2 : jl_array_next_cap(a, a->maxsize);
             while (n + 2 * inc > newlen - a->offset)
-                newlen *= 2;
+                newlen = jl_array_next_cap(a, newlen);
             newlen = limit_overallocation(a, n, newlen, 2 * inc);
             size_t newoffset = (newlen - newnrows) / 2;
             if (!array_resize_buffer(a, newlen)) {
@@ -838,27 +963,46 @@ STATIC_INLINE void jl_array_grow_at_end(jl_array_t *a, size_t idx,
     if (isbitsunion) typetagdata = jl_array_typetagdata(a);
     int has_gap = n > idx;
     size_t reqmaxsize = a->offset + n + inc;
+    if (__unlikely(reqmaxsize > a->maxsize) && a->offset > 0 && n + inc <= a->maxsize) {
+        // the dead prefix left behind by front deletions covers the needed
+        // space: slide the live elements back instead of growing the
+        // allocation (which would copy them anyway, plus the prefix)
+        char *newdata = data - a->offset * elsz;
+        memmove(newdata, data, n * elsz);
+        if (isbitsunion) {
+            // the new tag location is at or above the old one and past the
+            // new element data, so moving the data first is safe
+            char *newtags = newdata + a->maxsize * elsz;
+            memmove(newtags, typetagdata, n);
+            typetagdata = newtags;
+        }
+        a->offset = 0;
+        a->data = data = newdata;
+        reqmaxsize = n + inc;
+    }
     if (__unlikely(reqmaxsize > a->maxsize)) {
         size_t nb1 = idx * elsz;
         size_t nbinc = inc * elsz;
-        // if the requested size is more than 2x current maxsize, grow exactly
-        // otherwise double the maxsize
-        size_t newmaxsize = reqmaxsize >= a->maxsize * 2
+        // if the requested size is more than the next growth step, grow
+        // exactly; otherwise take the step (doubling, or the configured
+        // tail factor once past the size threshold)
+        size_t nextcap = jl_array_next_cap(a, a->maxsize);
+        size_t newmaxsize = reqmaxsize >= nextcap
                           ? (reqmaxsize < 4 ? 4 : reqmaxsize)
-                          : a->maxsize * 2;
+                          : nextcap;
         newmaxsize = limit_overallocation(a, n, newmaxsize, inc);
         size_t oldmaxsize = a->maxsize;
         int newbuf = array_resize_buffer(a, newmaxsize);
         char *newdata = (char*)a->data + a->offset * elsz;
         if (isbitsunion) newtypetagdata = newdata + (a->maxsize - a->offset) * elsz + a->offset;
         if (newbuf) {
-            memcpy(newdata, data, nb1);
+            jl_array_memcpy(newdata, data, nb1);
             if (isbitsunion) {
                 memcpy(newtypetagdata, typetagdata, idx);
                 if (has_gap) memcpy(newtypetagdata + idx + inc, typetagdata + idx, n - idx);
                 memset(newtypetagdata + idx, 0, inc);
             }
-            if (has_gap) memcpy(newdata + nb1 + nbinc, data + nb1, n * elsz - nb1);
+            if (has_gap) jl_array_memcpy(newdata + nb1 + nbinc, data + nb1, n * elsz - nb1);
         }
         else {
             if (isbitsunion) {
@@ -945,41 +1089,23 @@ STATIC_INLINE void jl_array_shrink(jl_array_t *a, size_t dec)
     }
     else if (a->flags.how == 2) {
         //malloc-allocated pointer this array object manages
-        char *typetagdata;
-        char *newtypetagdata;
         if (isbitsunion) {
-            typetagdata = (char*)malloc(a->nrows);
-            memcpy(typetagdata, jl_array_typetagdata(a), a->nrows);
+            // move the selector bytes down to their post-shrink location while
+            // they are still inside the allocation; realloc preserves the
+            // prefix, so no temporary copy is needed
+            char *newtypetagdata = (char*)a->data + (a->maxsize - dec - a->offset) * elsz + a->offset;
+            memmove(newtypetagdata, jl_array_typetagdata(a), a->nrows);
         }
         size_t oldoffsnb = a->offset * elsz;
         a->data = ((char*) jl_gc_managed_realloc(originalptr, newbytes, oldnbytes,
                                         a->flags.isaligned, (jl_value_t*) a)) + oldoffsnb;
         a->maxsize -= dec;
-        if (isbitsunion) {
-            newtypetagdata = jl_array_typetagdata(a);
-            memcpy(newtypetagdata, typetagdata, a->nrows);
-            free(typetagdata);
-        }
     }
     else if (a->flags.how == 3) {
         //this has has a pointer to the object that owns the data
     }
 }
 
-static size_t jl_array_limit_offset(jl_array_t *a, size_t offset)
-{
-    // make sure offset doesn't grow forever due to deleting at beginning
-    // and growing at end
-    if (offset >= 13 * a->maxsize / 20)
-        offset = 17 * (a->maxsize - a->nrows) / 100;
-#ifdef _P64
-    while (offset > (size_t)UINT32_MAX) {
-        offset /= 2;
-    }
-#endif
-    return offset;
-}
-
 STATIC_INLINE void jl_array_del_at_beg(jl_array_t *a, size_t idx, size_t dec,
                                        size_t n)
 {
@@ -993,7 +1119,15 @@ STATIC_INLINE void jl_array_del_at_beg(jl_array_t *a, size_t idx, size_t dec,
     a->length = n - dec;
 #endif
     a->nrows = n - dec;
-    size_t newoffs = jl_array_limit_offset(a, offset);
+    // front deletion just advances the offset; the dead prefix is reclaimed
+    // lazily by jl_array_grow_at_end when growth would otherwise reallocate.
+    // Only the field width forces a normalization.
+    size_t newoffs = offset;
+#ifdef _P64
+    while (newoffs > (size_t)UINT32_MAX) {
+        newoffs /= 2;
+    }
+#endif
     assert(newoffs <= offset);
     size_t nbdec = dec * elsz;
     if (__unlikely(newoffs != offset) || idx > 0) {
@@ -1121,6 +1255,51 @@ JL_DLLEXPORT void jl_array_sizehint(jl_array_t *a, size_t sz)
     }
 }
 
+// Release all slack capacity: after this the buffer holds exactly the
+// live elements (plus the NUL protector for byte vectors). Unlike
+// jl_array_sizehint there is no "worth it" heuristic -- long-lived
+// caches call this precisely because the slack never gets used again.
+JL_DLLEXPORT void jl_array_shrink_to_fit(jl_array_t *a)
+{
+    if (a->flags.isshared)
+        return;
+    size_t n = jl_array_nrows(a);
+    size_t elsz = a->elsize;
+    int isbitsunion = jl_array_isbitsunion(a);
+    if (a->flags.how == 2) {
+        // realloc in place; keeps the offset slack at the front, which
+        // jl_gc_managed_realloc returns along with the tail
+        size_t need = a->offset + n;
+        if (a->maxsize > need)
+            jl_array_shrink(a, a->maxsize - need);
+    }
+    else if (a->flags.how == 1) {
+        // gc-managed buffer: swap to a right-sized one and drop the offset
+        if (a->maxsize <= n && a->offset == 0)
+            return;
+        jl_ptls_t ptls = jl_get_ptls_states();
+        size_t newbytes = n * elsz;
+        if (isbitsunion)
+            newbytes += n;
+        else if (elsz == 1)
+            newbytes++;
+        char *olddata = (char*)a->data;
+        char *oldtags = isbitsunion ? jl_array_typetagdata(a) : NULL;
+        // the old buffer stays reachable through `a` across this allocation
+        char *buf = (char*)jl_gc_alloc_buf(ptls, newbytes);
+        memcpy(buf, olddata, n * elsz);
+        if (isbitsunion)
+            memcpy(buf + n * elsz, oldtags, n);
+        else if (elsz == 1)
+            buf[newbytes - 1] = '\0';
+        a->data = buf;
+        a->offset = 0;
+        a->maxsize = n;
+        jl_gc_wb_buf(a, a->data, newbytes);
+    }
+    // how == 0 (inline) and how == 3 (foreign owner): nothing to release
+}
+
 JL_DLLEXPORT jl_array_t *jl_array_copy(jl_array_t *ary)
 {
     size_t elsz = ary->elsize;
@@ -1129,7 +1308,7 @@ JL_DLLEXPORT jl_array_t *jl_array_copy(jl_array_t *ary)
     jl_array_t *new_ary = _new_array_(jl_typeof(ary), jl_array_ndims(ary),
                                       &ary->nrows, !ary->flags.ptrarray,
                                       isunion, elsz);
-    memcpy(new_ary->data, ary->data, len * elsz);
+    jl_array_memcpy(new_ary->data, ary->data, len * elsz);
     // ensure isbits union arrays copy their selector bytes correctly
     if (jl_array_isbitsunion(ary))
         memcpy(jl_array_typetagdata(new_ary), jl_array_typetagdata(ary), len);
@@ -52,6 +52,7 @@ jl_sym_t *copyast_sym; jl_sym_t *cfunction_sym;
 jl_sym_t *pure_sym; jl_sym_t *loopinfo_sym;
 jl_sym_t *meta_sym; jl_sym_t *inert_sym;
 jl_sym_t *polly_sym; jl_sym_t *unused_sym;
+jl_sym_t *multiversion_sym;
 jl_sym_t *static_parameter_sym; jl_sym_t *inline_sym;
 jl_sym_t *noinline_sym; jl_sym_t *generated_sym;
 jl_sym_t *generated_only_sym; jl_sym_t *isdefined_sym;
@@ -90,6 +91,13 @@ STATIC_INLINE void jl_ast_context_list_delete(jl_ast_context_list_t *node) JL_NO
     *node->prev = node->next;
 }
 
+// scm_to_julia interns the same handful of head symbols over and over for
+// every node it converts. Interned flisp symbols are malloc'd once and never
+// freed, and jl_sym_t are permanently rooted, so a direct-mapped cache keyed
+// on the symbol_t pointer is safe across both collectors. Gensyms live on the
+// (copying) flisp heap and are never cached.
+#define JL_SCMSYM_CACHE_SIZE 256
+
 typedef struct _jl_ast_context_t {
     fl_context_t fl;
     fltype_t *jvtype;
@@ -100,6 +108,10 @@ typedef struct _jl_ast_context_t {
     value_t null_sym;
     value_t ssavalue_sym;
     value_t slot_sym;
+    struct {
+        symbol_t *scm;
+        jl_sym_t *jl;
+    } scmsym_cache[JL_SCMSYM_CACHE_SIZE];
     jl_ast_context_list_t list;
     int ref;
     jl_task_t *task; // the current owner (user) of this jl_ast_context_t
@@ -203,10 +215,31 @@ static const builtinspec_t julia_flisp_ast_ext[] = {
     { NULL, NULL }
 };
 
+// Initial size of each flisp semispace. The collector doubles the heap
+// adaptively when a cycle leaves it more than 80% full, but every doubling
+// costs a full copy of the live set first, so lowering a large generated
+// file from the 4MB default pays a burst of copy cycles before the heap
+// catches up. JULIA_FLISP_HEAP_SIZE (in MiB) lets such workloads start at
+// the right size.
+static size_t jl_flisp_heap_size(void)
+{
+    static size_t size = 0;
+    if (size == 0) {
+        size = 4 * 1024 * 1024;
+        char *cp = getenv("JULIA_FLISP_HEAP_SIZE");
+        if (cp) {
+            long mb = atol(cp);
+            if (mb >= 1 && mb <= 16384)
+                size = (size_t)mb * 1024 * 1024;
+        }
+    }
+    return size;
+}
+
 static void jl_init_ast_ctx(jl_ast_context_t *ast_ctx)
 {
     fl_context_t *fl_ctx = &ast_ctx->fl;
-    fl_init(fl_ctx, 4*1024*1024);
+    fl_init(fl_ctx, jl_flisp_heap_size());
 
     if (fl_load_system_image_str(fl_ctx, (char*)flisp_system_image,
                                  sizeof(flisp_system_image))) {
@@ -230,22 +263,40 @@ static void jl_init_ast_ctx(jl_ast_context_t *ast_ctx)
 }
 
 // There should be no GC allocation while holding this lock
+// Parsing from different tasks runs fully in parallel: every task gets its
+// own jl_ast_context_t (and hence its own fl_context_t) on demand, and
+// flisp_lock only guards the pool lists below, not parsing itself. Contexts
+// are recycled through the freed list but never deallocated, so a stale
+// pointer to one can always be dereferenced to check its current owner.
 static jl_mutex_t flisp_lock;
 static jl_ast_context_list_t *jl_ast_ctx_using = NULL;
 static jl_ast_context_list_t *jl_ast_ctx_freed = NULL;
 
+// the context this thread most recently entered, to skip the lock and the
+// pool scan on nested and repeated parses
+static __thread jl_ast_context_t *jl_ast_ctx_recent = NULL;
+
 static jl_ast_context_t *jl_ast_ctx_enter(void) JL_GLOBALLY_ROOTED JL_NOTSAFEPOINT
 {
     jl_ptls_t ptls = jl_get_ptls_states();
     JL_SIGATOMIC_BEGIN();
-    JL_LOCK_NOGC(&flisp_lock);
     jl_ast_context_list_t *node;
-    jl_ast_context_t *ctx;
+    jl_ast_context_t *ctx = jl_ast_ctx_recent;
+    // fast path: the context this thread used last still belongs to the
+    // current task; `ref` is only ever mutated by the owning task, so no
+    // lock is needed (a context reassigned to another task fails the
+    // `task` check and falls through to the locked scan)
+    if (ctx && ctx->task == ptls->current_task) {
+        ctx->ref++;
+        return ctx;
+    }
+    JL_LOCK_NOGC(&flisp_lock);
     // First check if the current task is using one of the contexts
     for (node = jl_ast_ctx_using;node;(node = node->next)) {
         ctx = jl_ast_context_list_item(node);
         if (ctx->task == ptls->current_task) {
             ctx->ref++;
+            jl_ast_ctx_recent = ctx;
             JL_UNLOCK_NOGC(&flisp_lock);
             return ctx;
         }
@@ -258,6 +309,7 @@ static jl_ast_context_t *jl_ast_ctx_enter(void) JL_GLOBALLY_ROOTED JL_NOTSAFEPOI
         ctx->ref = 1;
         ctx->task = ptls->current_task;
         ctx->module = NULL;
+        jl_ast_ctx_recent = ctx;
         JL_UNLOCK_NOGC(&flisp_lock);
         return ctx;
     }
@@ -267,6 +319,7 @@ static jl_ast_context_t *jl_ast_ctx_enter(void) JL_GLOBALLY_ROOTED JL_NOTSAFEPOI
     ctx->task = ptls->current_task;
     node = &ctx->list;
     jl_ast_context_list_insert(&jl_ast_ctx_using, node);
+    jl_ast_ctx_recent = ctx;
     JL_UNLOCK_NOGC(&flisp_lock);
     jl_init_ast_ctx(ctx);
     return ctx;
@@ -351,6 +404,7 @@ void jl_init_frontend(void)
     inline_sym = jl_symbol("inline");
     noinline_sym = jl_symbol("noinline");
     polly_sym = jl_symbol("polly");
+    multiversion_sym = jl_symbol("multiversion");
     propagate_inbounds_sym = jl_symbol("propagate_inbounds");
     isdefined_sym = jl_symbol("isdefined");
     nospecialize_sym = jl_symbol("nospecialize");
@@ -418,7 +472,15 @@ static jl_sym_t *scmsym_to_julia(fl_context_t *fl_ctx, value_t s)
         *(--n) = '#';
         return jl_symbol(n);
     }
-    return jl_symbol(symbol_name(fl_ctx, s));
+    jl_ast_context_t *ctx = jl_ast_ctx(fl_ctx);
+    symbol_t *sp = (symbol_t*)ptr(s);
+    size_t h = ((uintptr_t)sp / sizeof(void*)) & (JL_SCMSYM_CACHE_SIZE - 1);
+    if (ctx->scmsym_cache[h].scm == sp)
+        return ctx->scmsym_cache[h].jl;
+    jl_sym_t *sym = jl_symbol(symbol_name(fl_ctx, s));
+    ctx->scmsym_cache[h].scm = sp;
+    ctx->scmsym_cache[h].jl = sym;
+    return sym;
 }
 
 static jl_value_t *scm_to_julia(fl_context_t *fl_ctx, value_t e, jl_module_t *mod)
@@ -833,6 +895,15 @@ jl_value_t *jl_parse_eval_all(const char *fname,
     }
     fl_gc_handle(fl_ctx, &ast);
     fl_gc_handle(fl_ctx, &expression);
+    // look up the lowering entry points once per file instead of once per
+    // expression; the handles keep the closures valid across flisp
+    // collections triggered by lowering
+    value_t expand_fn = symbol_value(symbol(fl_ctx, "jl-expand-to-thunk"));
+    value_t expand_stmt_fn = symbol_value(symbol(fl_ctx, "jl-expand-to-thunk-stmt"));
+    value_t macrocall_fn = symbol_value(symbol(fl_ctx, "contains-macrocall"));
+    fl_gc_handle(fl_ctx, &expand_fn);
+    fl_gc_handle(fl_ctx, &expand_stmt_fn);
+    fl_gc_handle(fl_ctx, &macrocall_fn);
 
     int last_lineno = jl_lineno;
     const char *last_filename = jl_filename;
@@ -845,6 +916,9 @@ jl_value_t *jl_parse_eval_all(const char *fname,
     jl_value_t *result = jl_nothing;
     int err = 0;
     JL_GC_PUSH2(&form, &result);
+    // let consecutive definitions in this file share world increments;
+    // closed in the finally block so an error cannot leak an open batch
+    jl_world_batch_begin();
     JL_TRY {
         assert(iscons(ast) && car_(ast) == symbol(fl_ctx, "toplevel"));
         ast = cdr_(ast);
@@ -852,7 +926,7 @@ jl_value_t *jl_parse_eval_all(const char *fname,
             expression = car_(ast);
             {
                 JL_TIMING(LOWERING);
-                if (fl_ctx->T == fl_applyn(fl_ctx, 1, symbol_value(symbol(fl_ctx, "contains-macrocall")), expression)) {
+                if (fl_ctx->T == fl_applyn(fl_ctx, 1, macrocall_fn, expression)) {
                     form = scm_to_julia(fl_ctx, expression, inmodule);
                     form = jl_expand_macros(form, inmodule, NULL, 0);
                     expression = julia_to_scm(fl_ctx, form);
@@ -860,7 +934,7 @@ jl_value_t *jl_parse_eval_all(const char *fname,
                 // expand non-final expressions in statement position (value unused)
                 expression =
                     fl_applyn(fl_ctx, 3,
-                              symbol_value(symbol(fl_ctx, iscons(cdr_(ast)) ? "jl-expand-to-thunk-stmt" : "jl-expand-to-thunk")),
+                              iscons(cdr_(ast)) ? expand_stmt_fn : expand_fn,
                               expression, symbol(fl_ctx, jl_filename), fixnum(jl_lineno));
             }
             jl_get_ptls_states()->world_age = jl_world_counter;
@@ -882,10 +956,11 @@ jl_value_t *jl_parse_eval_all(const char *fname,
         goto finally; // skip jl_restore_excstack
     }
 finally:
+    jl_world_batch_end();
     jl_get_ptls_states()->world_age = last_age;
     jl_lineno = last_lineno;
     jl_filename = last_filename;
-    fl_free_gc_handles(fl_ctx, 2);
+    fl_free_gc_handles(fl_ctx, 5);
     ctx->module = old_module;
     jl_ast_ctx_leave(ctx);
     if (err) {
@@ -1170,14 +1245,162 @@ JL_DLLEXPORT jl_value_t *jl_macroexpand1(jl_value_t *expr, jl_module_t *inmodule
     return expr;
 }
 
+// lowering cache ------------------------------------------------------------
+
+// Opt-in (JULIA_LOWERING_CACHE=1) cache of lowered code keyed by a content
+// hash of the surface expression, consulted by jl_expand_with_loc and
+// jl_expand_stmt_with_loc before invoking flisp. This helps workflows that
+// repeatedly re-lower unchanged expressions (hot-reload tools re-lowering a
+// whole file when one method changed). It is off by default because lowering
+// runs macro expansion: if a macro definition changes, a cached result keyed
+// only on the (unchanged) call-site text is stale. jl_parse_eval_all lowers
+// flisp values directly and is not covered.
+#define JL_LOWERING_CACHE_SIZE 1024 // entries; must be a power of two
+
+static int jl_lowering_cache_enabled(void)
+{
+    static int enabled = -1;
+    if (enabled == -1) {
+        char *env = getenv("JULIA_LOWERING_CACHE");
+        enabled = (env && env[0] && strcmp(env, "0") != 0) ? 1 : 0;
+    }
+    return enabled;
+}
+
+static jl_mutex_t lowering_cache_lock;
+static struct {
+    uint64_t hash;
+    jl_module_t *mod;
+} lowering_cache_keys[JL_LOWERING_CACHE_SIZE];
+jl_array_t *jl_lowering_cache_values = NULL; // rooted in gc.c:mark_roots
+static uint64_t lowering_cache_nhit;
+static uint64_t lowering_cache_nmiss;
+
+// Content hash of a surface-syntax tree. Sets *cacheable to 0 (and may return
+// early) on node kinds whose contents we do not hash, so that unhashed state
+// can never alias a cached entry.
+static uint64_t lowering_hash_expr(jl_value_t *v, int *cacheable)
+{
+    if (jl_is_symbol(v))
+        return bitmix(memhash(jl_symbol_name((jl_sym_t*)v), strlen(jl_symbol_name((jl_sym_t*)v))), 0x53);
+    if (jl_is_expr(v)) {
+        jl_expr_t *e = (jl_expr_t*)v;
+        size_t i, l = jl_array_len(e->args);
+        uint64_t h = bitmix(lowering_hash_expr((jl_value_t*)e->head, cacheable), (uint64_t)l);
+        for (i = 0; i < l && *cacheable; i++)
+            h = bitmix(h, lowering_hash_expr(jl_exprarg(e, i), cacheable));
+        return h;
+    }
+    if (jl_is_string(v))
+        return bitmix(memhash(jl_string_data(v), jl_string_len(v)), 0x57);
+    if (jl_is_quotenode(v))
+        return bitmix(lowering_hash_expr(jl_quotenode_value(v), cacheable), 0x51);
+    if (jl_is_linenode(v)) {
+        uint64_t h = inthash((uint64_t)jl_linenode_line(v));
+        jl_value_t *file = jl_linenode_file(v);
+        if (file != jl_nothing)
+            h = bitmix(h, lowering_hash_expr(file, cacheable));
+        return h;
+    }
+    if (jl_is_globalref(v))
+        return bitmix(inthash((uintptr_t)jl_globalref_mod(v)),
+                      lowering_hash_expr((jl_value_t*)jl_globalref_name(v), cacheable));
+    jl_value_t *t = jl_typeof(v);
+    if (jl_isbits(t))
+        return bitmix(inthash((uintptr_t)t),
+                      memhash((char*)jl_data_ptr(v), jl_datatype_size(t)));
+    *cacheable = 0;
+    return 0;
+}
+
+static uint64_t lowering_cache_key(jl_value_t *expr, const char *file, int line,
+                                   int stmt, int *cacheable)
+{
+    uint64_t h = lowering_hash_expr(expr, cacheable);
+    h = bitmix(h, memhash(file, strlen(file)));
+    h = bitmix(h, inthash((uint64_t)line));
+    return bitmix(h, (uint64_t)(stmt ? 0x73 : 0x65));
+}
+
+// Cached results are shared structure: copy the Expr spine on every hit, and
+// shallow-copy a thunk's CodeInfo the same way jl_method_set_source does
+// before callers mutate its fields.
+static jl_value_t *lowering_cache_copy(jl_value_t *v)
+{
+    v = jl_copy_ast(v);
+    if (jl_is_expr(v) && ((jl_expr_t*)v)->head == thunk_sym &&
+        jl_expr_nargs(v) == 1 && jl_is_code_info(jl_exprarg(v, 0))) {
+        JL_GC_PUSH1(&v);
+        jl_code_info_t *src = jl_copy_code_info((jl_code_info_t*)jl_exprarg(v, 0));
+        jl_exprargset(v, 0, (jl_value_t*)src);
+        JL_GC_POP();
+    }
+    return v;
+}
+
+static jl_value_t *lowering_cache_lookup(uint64_t h, jl_module_t *mod)
+{
+    size_t i = h & (JL_LOWERING_CACHE_SIZE - 1);
+    jl_value_t *v = NULL;
+    JL_LOCK_NOGC(&lowering_cache_lock);
+    if (jl_lowering_cache_values != NULL &&
+        lowering_cache_keys[i].hash == h && lowering_cache_keys[i].mod == mod)
+        v = jl_array_ptr_ref(jl_lowering_cache_values, i);
+    if (v != NULL)
+        lowering_cache_nhit++;
+    else
+        lowering_cache_nmiss++;
+    JL_UNLOCK_NOGC(&lowering_cache_lock);
+    return v;
+}
+
+static void lowering_cache_store(uint64_t h, jl_module_t *mod, jl_value_t *v)
+{
+    if (jl_lowering_cache_values == NULL) {
+        jl_array_t *a = jl_alloc_vec_any(JL_LOWERING_CACHE_SIZE);
+        JL_LOCK_NOGC(&lowering_cache_lock);
+        if (jl_lowering_cache_values == NULL)
+            jl_lowering_cache_values = a;
+        JL_UNLOCK_NOGC(&lowering_cache_lock);
+    }
+    size_t i = h & (JL_LOWERING_CACHE_SIZE - 1);
+    JL_LOCK_NOGC(&lowering_cache_lock);
+    lowering_cache_keys[i].hash = h;
+    lowering_cache_keys[i].mod = mod;
+    jl_array_ptr_set(jl_lowering_cache_values, i, v);
+    JL_UNLOCK_NOGC(&lowering_cache_lock);
+}
+
+JL_DLLEXPORT uint64_t jl_lowering_cache_hits(void)
+{
+    return lowering_cache_nhit;
+}
+
+JL_DLLEXPORT uint64_t jl_lowering_cache_misses(void)
+{
+    return lowering_cache_nmiss;
+}
+
 JL_DLLEXPORT jl_value_t *jl_expand_with_loc(jl_value_t *expr, jl_module_t *inmodule,
                                             const char *file, int line)
 {
     JL_TIMING(LOWERING);
+    int cacheable = jl_lowering_cache_enabled();
+    uint64_t key = 0;
+    if (cacheable) {
+        key = lowering_cache_key(expr, file, line, 0, &cacheable);
+        if (cacheable) {
+            jl_value_t *cached = lowering_cache_lookup(key, inmodule);
+            if (cached != NULL)
+                return lowering_cache_copy(cached);
+        }
+    }
     JL_GC_PUSH1(&expr);
     expr = jl_copy_ast(expr);
     expr = jl_expand_macros(expr, inmodule, NULL, 0);
     expr = jl_call_scm_on_ast_and_loc("jl-expand-to-thunk", expr, inmodule, file, line);
+    if (cacheable)
+        lowering_cache_store(key, inmodule, expr);
     JL_GC_POP();
     return expr;
 }
@@ -1192,10 +1415,22 @@ JL_DLLEXPORT jl_value_t *jl_expand_stmt_with_loc(jl_value_t *expr, jl_module_t *
                                                  const char *file, int line)
 {
     JL_TIMING(LOWERING);
+    int cacheable = jl_lowering_cache_enabled();
+    uint64_t key = 0;
+    if (cacheable) {
+        key = lowering_cache_key(expr, file, line, 1, &cacheable);
+        if (cacheable) {
+            jl_value_t *cached = lowering_cache_lookup(key, inmodule);
+            if (cached != NULL)
+                return lowering_cache_copy(cached);
+        }
+    }
     JL_GC_PUSH1(&expr);
     expr = jl_copy_ast(expr);
     expr = jl_expand_macros(expr, inmodule, NULL, 0);
     expr = jl_call_scm_on_ast_and_loc("jl-expand-to-thunk-stmt", expr, inmodule, file, line);
+    if (cacheable)
+        lowering_cache_store(key, inmodule, expr);
     JL_GC_POP();
     return expr;
 }
@@ -687,6 +687,24 @@ JL_CALLABLE(jl_f_tuple)
         tt = jl_inst_concrete_tupletype(types);
         JL_GC_POP();
     }
+    if (nargs <= 4) {
+        // fast path for small tuples: the field types are exactly the
+        // argument types, so no type checks, union selectors, or undef tail
+        // initialization apply, and with no safepoint between the allocation
+        // and the stores the object stays young -- no write barriers either
+        if (tt->instance != NULL)
+            return tt->instance;
+        jl_ptls_t ptls = jl_get_ptls_states();
+        jl_value_t *jv = jl_gc_alloc(ptls, jl_datatype_size(tt), tt);
+        for (i = 0; i < nargs; i++) {
+            size_t offs = jl_field_offset(tt, i);
+            if (jl_field_isptr(tt, i))
+                *(jl_value_t**)((char*)jv + offs) = args[i];
+            else
+                jl_assign_bits((char*)jv + offs, args[i]);
+        }
+        return jv;
+    }
     return jl_new_structv(tt, args, nargs);
 }
 
@@ -1127,7 +1127,8 @@ public:
             size_t nargt,
             jl_cgval_t *argv,
             SmallVector<Value*, 16> &gc_uses,
-            bool static_rt) const;
+            bool static_rt,
+            bool gc_leaf) const;
 
 private:
 std::string generate_func_sig(const char *fname)
@@ -1391,6 +1392,16 @@ static jl_cgval_t emit_ccall(jl_codectx_t &ctx, jl_value_t **args, size_t nargs)
     native_sym_arg_t symarg = {};
     JL_GC_PUSH3(&rt, &at, &symarg.gcroot);
 
+    // `gc_leaf` is not a real calling convention: it selects the C ABI plus an
+    // assertion from the caller that the callee is a leaf function for GC
+    // purposes -- it never allocates, blocks, or calls back into julia -- so
+    // the GC lowering passes may skip treating the call as a safepoint and
+    // keep values live across it out of the GC frame. Debug builds verify the
+    // claim at runtime (see gc.c).
+    bool gc_leaf = (cc_sym == jl_symbol("gc_leaf"));
+    if (gc_leaf)
+        cc_sym = jl_symbol("cdecl");
+
     CallingConv::ID cc = CallingConv::C;
     bool llvmcall = false;
     std::tie(cc, llvmcall) = convert_cconv(cc_sym);
@@ -1592,7 +1603,10 @@ static jl_cgval_t emit_ccall(jl_codectx_t &ctx, jl_value_t **args, size_t nargs)
         JL_GC_POP();
         ctx.builder.CreateCall(prepare_call(gcroot_flush_func));
         emit_signal_fence(ctx);
-        ctx.builder.CreateLoad(ctx.signalPage, true);
+        // with safepoints disabled, polling is left to the remaining runtime
+        // entry points (allocation and library calls)
+        if (ctx.params->safepoints)
+            ctx.builder.CreateLoad(ctx.signalPage, true);
         emit_signal_fence(ctx);
         return ghostValue(jl_void_type);
     }
@@ -1746,7 +1760,8 @@ static jl_cgval_t emit_ccall(jl_codectx_t &ctx, jl_value_t **args, size_t nargs)
             nargt,
             argv,
             gc_uses,
-            static_rt);
+            static_rt,
+            gc_leaf);
     JL_GC_POP();
     return retval;
 }
@@ -1757,7 +1772,8 @@ jl_cgval_t function_sig_t::emit_a_ccall(
         size_t nargt,
         jl_cgval_t *argv,
         SmallVector<Value*, 16> &gc_uses,
-        bool static_rt) const
+        bool static_rt,
+        bool gc_leaf) const
 {
     if (!err_msg.empty()) {
         emit_error(ctx, err_msg);
@@ -1942,12 +1958,26 @@ jl_cgval_t function_sig_t::emit_a_ccall(
         }
     }
 
+#ifdef JL_DEBUG_BUILD
+    if (gc_leaf)
+        ctx.builder.CreateCall(prepare_call(jl_gc_leaf_check_begin_func));
+#endif
     OperandBundleDef OpBundle("jl_roots", gc_uses);
     // the actual call
     Value *ret = ctx.builder.CreateCall(prepare_call(llvmf),
                                     ArrayRef<Value*>(&argvals[0], nargs + sret),
                                     ArrayRef<OperandBundleDef>(&OpBundle, gc_uses.empty() ? 0 : 1));
     ((CallInst*)ret)->setAttributes(attributes);
+    if (gc_leaf) {
+        // tell the GC lowering passes this call cannot reach a safepoint
+        // (keeping the jl_roots bundle so the arguments stay live up to it)
+        ((CallInst*)ret)->addAttribute(AttributeList::FunctionIndex,
+                Attribute::get(jl_LLVMContext, "gc-leaf-function"));
+    }
+#ifdef JL_DEBUG_BUILD
+    if (gc_leaf)
+        ctx.builder.CreateCall(prepare_call(jl_gc_leaf_check_end_func));
+#endif
 
     if (cc != CallingConv::C)
         ((CallInst*)ret)->setCallingConv(cc);
@@ -778,6 +778,16 @@ JL_DLLEXPORT void *test_echo_p(void *p) {
     return p;
 }
 
+// Callback invokers for the FFI benchmark harness (contrib/bench_ccall.jl),
+// so that cfunction round-trip cost can be timed from the C side of the fence.
+JL_DLLEXPORT int call_cb_int(int (*cb)(int), int x) {
+    return cb(x);
+}
+
+JL_DLLEXPORT double call_cb_double(double (*cb)(double), double x) {
+    return cb(x);
+}
+
 #if defined(_CPU_X86_64_)
 
 #include <xmmintrin.h>
@@ -55,6 +55,7 @@
 // support
 #include <llvm/ADT/SmallBitVector.h>
 #include <llvm/ADT/Optional.h>
+#include <llvm/Support/Allocator.h>
 #include <llvm/Support/raw_ostream.h>
 #include <llvm/Support/FormattedStream.h>
 #include <llvm/Support/SourceMgr.h> // for llvmcall
@@ -279,6 +280,7 @@ static Function *jlcopyast_func;
 static Function *jltuple_func;
 static Function *jlnsvec_func;
 static Function *jlapplygeneric_func;
+static Function *jlapplygenericsite_func;
 static Function *jlinvoke_func;
 static Function *jlapply2va_func;
 static Function *jlgetfield_func;
@@ -299,6 +301,8 @@ static Function *jlisa_func;
 static Function *jlsubtype_func;
 static Function *jlapplytype_func;
 static Function *jl_object_id__func;
+static Function *jl_gc_leaf_check_begin_func;
+static Function *jl_gc_leaf_check_end_func;
 static Function *setjmp_func;
 static Function *memcmp_derived_func;
 static Function *box_int8_func;
@@ -345,7 +349,7 @@ static std::map<jl_fptr_args_t, Function*> builtin_func_map;
 // --- code generation ---
 extern "C" {
     int globalUnique = 0;
-    jl_cgparams_t jl_default_cgparams = {1, 1, 1, 1, 0, NULL, NULL, NULL, NULL, NULL};
+    jl_cgparams_t jl_default_cgparams = {1, 1, 1, 1, 0, 1, 1, NULL, NULL, NULL, NULL, NULL};
 }
 
 template<typename T>
@@ -497,18 +501,49 @@ struct jl_returninfo_t {
 
 static jl_returninfo_t get_specsig_function(Module *M, const std::string &name, jl_value_t *sig, jl_value_t *jlrettype);
 
+// Arena-backed STL allocator for the codegen-internal containers below.
+// Everything allocated while emitting a function comes out of the context's
+// bump allocator and is released wholesale when the jl_codectx_t dies,
+// instead of churning malloc/free on thousands of short-lived vector
+// buffers and map nodes.
+template <typename T>
+class cg_arena_alloc {
+public:
+    typedef T value_type;
+    BumpPtrAllocator *arena;
+    cg_arena_alloc(BumpPtrAllocator &a) : arena(&a) {}
+    template <typename U> cg_arena_alloc(const cg_arena_alloc<U> &other) : arena(other.arena) {}
+    T *allocate(size_t n)
+    {
+        return (T*)arena->Allocate(n * sizeof(T), alignof(T));
+    }
+    void deallocate(T*, size_t) {} // freed wholesale with the arena
+    template <typename U> bool operator==(const cg_arena_alloc<U> &other) const
+    {
+        return arena == other.arena;
+    }
+    template <typename U> bool operator!=(const cg_arena_alloc<U> &other) const
+    {
+        return arena != other.arena;
+    }
+};
+typedef std::vector<jl_varinfo_t, cg_arena_alloc<jl_varinfo_t>> jl_slotvec_t;
+
 // information about the context of a piece of code: its enclosing
 // function and module, and visible local variables and labels.
 class jl_codectx_t {
 public:
+    BumpPtrAllocator cg_arena; // must outlive the containers below
     IRBuilder<> builder;
     Function *f = NULL;
     // local var info. globals are not in here.
-    std::vector<jl_varinfo_t> slots;
-    std::map<int, jl_varinfo_t> phic_slots;
-    std::vector<jl_cgval_t> SAvalues;
-    std::vector<std::tuple<jl_cgval_t, BasicBlock *, AllocaInst *, PHINode *, jl_value_t *>> PhiNodes;
-    std::vector<bool> ssavalue_assigned;
+    jl_slotvec_t slots;
+    std::map<int, jl_varinfo_t, std::less<int>,
+             cg_arena_alloc<std::pair<const int, jl_varinfo_t>>> phic_slots;
+    std::vector<jl_cgval_t, cg_arena_alloc<jl_cgval_t>> SAvalues;
+    std::vector<std::tuple<jl_cgval_t, BasicBlock *, AllocaInst *, PHINode *, jl_value_t *>,
+                cg_arena_alloc<std::tuple<jl_cgval_t, BasicBlock *, AllocaInst *, PHINode *, jl_value_t *>>> PhiNodes;
+    std::vector<bool, cg_arena_alloc<bool>> ssavalue_assigned;
     jl_module_t *module = NULL;
     jl_method_instance_t *linfo = NULL;
     jl_code_info_t *source = NULL;
@@ -537,7 +572,12 @@ public:
     const jl_cgparams_t *params = NULL;
 
     jl_codectx_t(LLVMContext &llvmctx)
-      : builder(llvmctx) { }
+      : builder(llvmctx),
+        slots(cg_arena_alloc<jl_varinfo_t>(cg_arena)),
+        phic_slots(std::less<int>(), cg_arena_alloc<std::pair<const int, jl_varinfo_t>>(cg_arena)),
+        SAvalues(cg_arena_alloc<jl_cgval_t>(cg_arena)),
+        PhiNodes(cg_arena_alloc<std::tuple<jl_cgval_t, BasicBlock *, AllocaInst *, PHINode *, jl_value_t *>>(cg_arena)),
+        ssavalue_assigned(cg_arena_alloc<bool>(cg_arena)) { }
 
     ~jl_codectx_t() {
         assert(this->roots == NULL);
@@ -1194,6 +1234,12 @@ jl_code_instance_t *jl_compile_linfo(jl_method_instance_t *mi, jl_code_info_t *s
         if (!nested_compile && dump_compiles_stream != NULL)
             last_time = jl_hrtime();
         nested_compile = true;
+        uint64_t log_t0 = 0;
+        int log_recompile = 0;
+        if (jl_compile_log_enabled) {
+            log_t0 = jl_hrtime();
+            log_recompile = jl_compile_log_invalidated(mi, world);
+        }
 
         // Step 3. actually do the work of emitting the function
         std::unique_ptr<Module> m;
@@ -1215,6 +1261,10 @@ jl_code_instance_t *jl_compile_linfo(jl_method_instance_t *mi, jl_code_info_t *s
         const char *f = decls.functionObject;
         const char *specf = decls.specFunctionObject;
 
+        if (log_t0)
+            jl_compile_log_event(mi, JL_COMPILE_EV_CODEGEN, log_recompile,
+                                 jl_hrtime() - log_t0, 0);
+
         if (JL_HOOK_TEST(params, module_activation)) {
             JL_HOOK_CALL(params, module_activation, 1, jl_box_voidpointer(wrap(m.release())));
         }
@@ -1302,20 +1352,22 @@ static void jl_setup_module(Module *m, const jl_cgparams_t *params = &jl_default
         return;
     }
 
-    // Some linkers (*cough* OS X) don't understand DWARF v4, so we use v2 in
-    // imaging mode. The structure of v4 is slightly nicer for debugging JIT
-    // code.
-    if (!getModuleFlag(m,"Dwarf Version")) {
-        int dwarf_version = 4;
+    if (params->debug_info) {
+        // Some linkers (*cough* OS X) don't understand DWARF v4, so we use v2 in
+        // imaging mode. The structure of v4 is slightly nicer for debugging JIT
+        // code.
+        if (!getModuleFlag(m,"Dwarf Version")) {
+            int dwarf_version = 4;
 #ifdef _OS_DARWIN_
-        if (imaging_mode)
-            dwarf_version = 2;
+            if (imaging_mode)
+                dwarf_version = 2;
 #endif
-        m->addModuleFlag(llvm::Module::Warning, "Dwarf Version", dwarf_version);
+            m->addModuleFlag(llvm::Module::Warning, "Dwarf Version", dwarf_version);
+        }
+        if (!getModuleFlag(m,"Debug Info Version"))
+            m->addModuleFlag(llvm::Module::Error, "Debug Info Version",
+                llvm::DEBUG_METADATA_VERSION);
     }
-    if (!getModuleFlag(m,"Debug Info Version"))
-        m->addModuleFlag(llvm::Module::Error, "Debug Info Version",
-            llvm::DEBUG_METADATA_VERSION);
     m->setDataLayout(jl_data_layout);
     m->setTargetTriple(jl_TargetMachine->getTargetTriple().str());
 
@@ -2041,7 +2093,7 @@ static std::set<int> assigned_in_try(jl_array_t *stmts, int s, long l)
     return av;
 }
 
-static void mark_volatile_vars(jl_array_t *stmts, std::vector<jl_varinfo_t> &slots)
+static void mark_volatile_vars(jl_array_t *stmts, jl_slotvec_t &slots)
 {
     size_t slength = jl_array_dim0(stmts);
     for (int i = 0; i < (int)slength; i++) {
@@ -3280,6 +3332,15 @@ static jl_cgval_t emit_call(jl_codectx_t &ctx, jl_expr_t *ex, jl_value_t *rt)
     }
 
     // emit function and arguments
+    if (!imaging_mode) {
+        // give this site its own inline cache (see jl_apply_generic_site),
+        // passed through the F slot of the jlcall convention; the raw cache
+        // pointer is session-local, so not valid when generating output
+        jl_callsite_cache_t *site = jl_new_callsite_cache();
+        Value *siteval = maybe_decay_untracked(literal_static_pointer_val(ctx, site));
+        Value *callval = emit_jlcall(ctx, jlapplygenericsite_func, siteval, argv, nargs);
+        return mark_julia_type(ctx, callval, true, rt);
+    }
     Value *callval = emit_jlcall(ctx, jlapplygeneric_func, nullptr, argv, nargs);
     return mark_julia_type(ctx, callval, true, rt);
 }
@@ -4436,6 +4497,32 @@ static Function* gen_cfun_wrapper(
         }
     }
 
+    // Independent cfunction sites with the same signature can share one
+    // wrapper: when the function object arrives through the nest parameter
+    // and there is no specialized method to call directly, the emitted code
+    // depends only on the signature, with the closure pointer supplied later
+    // at trampoline-init time. Check that cache first (guarded by the codegen
+    // lock, like jl_cfunction_list).
+    bool cache_wrapper = into && nest && !lam && sigt && !unionall_env;
+    Module *orig_into = into;
+    if (cache_wrapper) {
+        if (jl_cfunction_tramp_list) {
+            jl_svec_t *entries = (jl_svec_t*)jl_eqtable_get(jl_cfunction_tramp_list, (jl_value_t*)sigt, NULL);
+            if (entries) {
+                size_t i, l = jl_svec_len(entries);
+                for (i = 0; i < l; i += 4) {
+                    if (jl_egal(jl_svecref(entries, i), declrt) &&
+                        jl_egal(jl_svecref(entries, i + 1), sig.rt) &&
+                        jl_egal(jl_svecref(entries, i + 2), (jl_value_t*)sig.at)) {
+                        Function *cached = (Function*)jl_unbox_voidpointer(jl_svecref(entries, i + 3));
+                        return cast<Function>(prepare_call_in(into, cached));
+                    }
+                }
+            }
+        }
+        into = NULL; // emit one shared copy into its own module below
+    }
+
     std::stringstream funcName;
     funcName << "jlcapi_" << name << "_" << globalUnique++;
 
@@ -4882,6 +4969,29 @@ static Function* gen_cfun_wrapper(
     if (!into)
         jl_finalize_module(M, true);
 
+    if (cache_wrapper) {
+        // record the shared wrapper, then hand the caller a declaration of it
+        // in the module it is emitting into
+        jl_value_t *boxed_cw = NULL;
+        jl_svec_t *newentries = NULL;
+        JL_GC_PUSH2(&boxed_cw, &newentries);
+        boxed_cw = jl_box_voidpointer((void*)cw_proto);
+        if (!jl_cfunction_tramp_list)
+            jl_cfunction_tramp_list = jl_alloc_vec_any(16);
+        jl_svec_t *oldentries = (jl_svec_t*)jl_eqtable_get(jl_cfunction_tramp_list, (jl_value_t*)sigt, NULL);
+        size_t i, oldlen = oldentries ? jl_svec_len(oldentries) : 0;
+        newentries = jl_alloc_svec(oldlen + 4);
+        jl_svecset(newentries, 0, declrt);
+        jl_svecset(newentries, 1, sig.rt);
+        jl_svecset(newentries, 2, (jl_value_t*)sig.at);
+        jl_svecset(newentries, 3, boxed_cw);
+        for (i = 0; i < oldlen; i++)
+            jl_svecset(newentries, i + 4, jl_svecref(oldentries, i));
+        jl_cfunction_tramp_list = jl_eqtable_put(jl_cfunction_tramp_list, (jl_value_t*)sigt, (jl_value_t*)newentries, NULL);
+        JL_GC_POP();
+        cw_proto = cast<Function>(prepare_call_in(orig_into, cw_proto));
+    }
+
     return cw_proto;
 }
 
@@ -5044,6 +5154,10 @@ const struct jl_typemap_info cfunction_cache = {
 
 jl_array_t *jl_cfunction_list;
 
+// cache of shared closure-trampoline wrappers, keyed by dispatch signature
+// (see gen_cfun_wrapper)
+jl_array_t *jl_cfunction_tramp_list;
+
 static Function *jl_cfunction_object(jl_value_t *ff, jl_value_t *declrt, jl_tupletype_t *argt)
 {
     // Assumes the codegen lock is acquired. The caller is responsible for that.
@@ -5158,6 +5272,11 @@ static Function *jl_cfunction_object(jl_value_t *ff, jl_value_t *declrt, jl_tupl
 }
 
 // generate a julia-callable function that calls f (AKA lam)
+// Emit the unbox-and-forward trampoline ("jfptr_*") that adapts the generic
+// boxed calling convention to a specsig target. Every specsig compilation
+// gets one (see emit_function), and its address -- not jl_fptr_args -- is
+// what dynamic dispatch installs as codeinst->invoke, so jl_apply_generic
+// already reaches the fast variant without re-boxing through a generic entry.
 static Function *gen_invoke_wrapper(jl_method_instance_t *lam, jl_value_t *jlretty, const jl_returninfo_t &f, StringRef funcName, Module *M)
 {
     Function *w = Function::Create(jl_func_sig, GlobalVariable::ExternalLinkage, funcName, M);
@@ -5477,6 +5596,8 @@ static std::unique_ptr<Module> emit_function(
         ctx.debug_enabled = 0;
     if (jl_options.debug_level == 0)
         ctx.debug_enabled = 0;
+    if (!params->debug_info)
+        ctx.debug_enabled = 0;
 
     // step 2. process var-info lists to see what vars need boxing
     int n_ssavalues = jl_is_long(src->ssavaluetypes) ? jl_unbox_long(src->ssavaluetypes) : jl_array_len(src->ssavaluetypes);
@@ -5625,6 +5746,14 @@ static std::unique_ptr<Module> emit_function(
         f->addFnAttr(Attribute::NoInline);
     }
 
+    if (jl_has_meta(stmts, multiversion_sym)) {
+        // annotated with Base.@multiversion: make the sysimage
+        // multiversioning pass clone this function for every partial
+        // target instead of relying on its heuristic (see
+        // llvm-multiversioning.cpp)
+        f->addFnAttr("julia.mv.clone");
+    }
+
     if (returninfo.cc == jl_returninfo_t::Union) {
         f->addAttribute(1, Attribute::getWithDereferenceableBytes(jl_LLVMContext, returninfo.union_bytes));
         f->addAttribute(1, Attribute::getWithAlignment(jl_LLVMContext, returninfo.union_align));
@@ -7300,6 +7429,17 @@ static void init_julia_llvm_env(Module *m)
     jlapplygeneric_func->addFnAttr(Thunk);
     add_named_global(jlapplygeneric_func, &jl_apply_generic);
 
+    std::vector<Type *> agsargs(0);
+    agsargs.push_back(T_prjlvalue);
+    agsargs.push_back(T_pprjlvalue);
+    agsargs.push_back(T_uint32);
+    jlapplygenericsite_func = Function::Create(FunctionType::get(T_prjlvalue, agsargs, false),
+                                               Function::ExternalLinkage,
+                                               "jl_apply_generic_site", m);
+    add_return_attr(jlapplygenericsite_func, Attribute::NonNull);
+    jlapplygenericsite_func->addFnAttr(Thunk);
+    add_named_global(jlapplygenericsite_func, &jl_apply_generic_site);
+
     std::vector<Type *> invokeargs(0);
     invokeargs.push_back(T_prjlvalue);
     invokeargs.push_back(T_pprjlvalue);
@@ -7578,6 +7718,18 @@ static void init_julia_llvm_env(Module *m)
     add_return_attr(jlarray_data_owner_func, Attribute::NonNull);
     add_named_global(jlarray_data_owner_func, &jl_array_data_owner);
 
+    jl_gc_leaf_check_begin_func =
+        Function::Create(FunctionType::get(T_void, false),
+                         Function::ExternalLinkage,
+                         "jl_gc_leaf_check_begin", m);
+    add_named_global(jl_gc_leaf_check_begin_func, &jl_gc_leaf_check_begin);
+
+    jl_gc_leaf_check_end_func =
+        Function::Create(FunctionType::get(T_void, false),
+                         Function::ExternalLinkage,
+                         "jl_gc_leaf_check_end", m);
+    add_named_global(jl_gc_leaf_check_end_func, &jl_gc_leaf_check_end);
+
     gcroot_flush_func = Function::Create(FunctionType::get(T_void, false),
                                          Function::ExternalLinkage,
                                          "julia.gcroot_flush");
@@ -146,7 +146,25 @@ static uint32_t crc32c_sse42(uint32_t crc, const char *buf, size_t len)
         len -= SHORT * 3;
     }
 
-    /* compute the crc on the remaining eight-byte units less than a SHORT*3
+    /* the same shift table can be used to compute two SHORT blocks
+       simultaneously; this covers the 256..767-byte tail that page-sized
+       inputs always leave after the SHORT*3 loop */
+    if (len >= SHORT * 2) {
+        uintptr_t crc1 = 0;
+        const char *end = buf + SHORT;
+        do {
+            __asm__(CRC32_PTR "\t" "(%2), %0\n\t"
+                    CRC32_PTR "\t" SHORTx1 "(%2), %1"
+                    : "=r"(crc0), "=r"(crc1)
+                    : "r"(buf), "0"(crc0), "1"(crc1));
+            buf += sizeof(void*);
+        } while (buf < end);
+        crc0 = crc32c_shift(crc32c_short, crc0) ^ crc1;
+        buf += SHORT;
+        len -= SHORT * 2;
+    }
+
+    /* compute the crc on the remaining eight-byte units less than a SHORT*2
        block */
     const char *end = buf + (len - (len & 7));
     while (buf < end) {
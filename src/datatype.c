@@ -89,6 +89,48 @@ jl_datatype_t *jl_new_uninitialized_datatype(void)
     return t;
 }
 
+// hash-consing table for layout descriptors: instantiating parameterized
+// types produces huge numbers of identical layouts (same sizes, offsets and
+// pointer fields), so share one permanent descriptor per distinct contents
+// instead of allocating a fresh one per type
+static jl_datatype_layout_t **layout_cache;
+static size_t layout_cache_sz;
+static size_t layout_cache_count;
+static jl_mutex_t layout_cache_lock;
+
+STATIC_INLINE size_t layout_nbytes(const jl_datatype_layout_t *l) JL_NOTSAFEPOINT
+{
+    return sizeof(jl_datatype_layout_t) +
+           l->nfields * jl_fielddesc_size(l->fielddesc_type);
+}
+
+static int layout_eq(const jl_datatype_layout_t *a, const jl_datatype_layout_t *b) JL_NOTSAFEPOINT
+{
+    // the n_nonptr prefix word is derived from the fields, so comparing the
+    // descriptor and field array bytes is sufficient
+    if (a->nfields != b->nfields || a->fielddesc_type != b->fielddesc_type)
+        return 0;
+    return memcmp(a, b, layout_nbytes(a)) == 0;
+}
+
+static void layout_cache_rehash(size_t newsz) JL_NOTSAFEPOINT
+{
+    jl_datatype_layout_t **old = layout_cache;
+    size_t oldsz = layout_cache_sz;
+    layout_cache = (jl_datatype_layout_t**)calloc(newsz, sizeof(void*));
+    layout_cache_sz = newsz;
+    for (size_t i = 0; i < oldsz; i++) {
+        jl_datatype_layout_t *l = old[i];
+        if (l != NULL) {
+            size_t idx = memhash32((char*)l, layout_nbytes(l)) & (newsz - 1);
+            while (layout_cache[idx] != NULL)
+                idx = (idx + 1) & (newsz - 1);
+            layout_cache[idx] = l;
+        }
+    }
+    free(old);
+}
+
 static jl_datatype_layout_t *jl_get_layout(uint32_t nfields,
                                            uint32_t alignment,
                                            int haspadding,
@@ -128,21 +170,23 @@ static jl_datatype_layout_t *jl_get_layout(uint32_t nfields,
         }
     }
 
-    // allocate a new descriptor
+    // build the descriptor in scratch space first, so that contents-equal
+    // layouts can be deduplicated below before any permanent allocation
     uint32_t fielddesc_size = jl_fielddesc_size(fielddesc_type);
     int has_padding = nfields && npointers;
+    size_t descsz = sizeof(jl_datatype_layout_t) + nfields * fielddesc_size;
+    uint32_t n_nonptr = 0;
+    char *scratch = (char*)malloc(descsz + sizeof(uint32_t));
     jl_datatype_layout_t *flddesc =
-        (jl_datatype_layout_t*)jl_gc_perm_alloc(sizeof(jl_datatype_layout_t) +
-                                                nfields * fielddesc_size +
-                                                (has_padding ? sizeof(uint32_t) : 0), 0, 4, 0);
+        (jl_datatype_layout_t*)(scratch + sizeof(uint32_t));
     if (has_padding) {
         if (first_ptr > UINT16_MAX)
             first_ptr = UINT16_MAX;
         last_ptr = nfields - last_ptr - 1;
         if (last_ptr > UINT16_MAX)
             last_ptr = UINT16_MAX;
-        flddesc = (jl_datatype_layout_t*)(((char*)flddesc) + sizeof(uint32_t));
-        jl_datatype_layout_n_nonptr(flddesc) = (first_ptr << 16) | last_ptr;
+        n_nonptr = (first_ptr << 16) | last_ptr;
+        jl_datatype_layout_n_nonptr(flddesc) = n_nonptr;
     }
     flddesc->nfields = nfields;
     flddesc->alignment = alignment;
@@ -176,7 +220,33 @@ static jl_datatype_layout_t *jl_get_layout(uint32_t nfields,
         npointers = npointers >> 1;
     }
     flddesc->npointers = npointers | (nexp << 16);
-    return flddesc;
+
+    // hash-cons: return the existing permanent descriptor if an identical
+    // one was already created for another type
+    JL_LOCK_NOGC(&layout_cache_lock);
+    if (layout_cache_count * 4 >= layout_cache_sz * 3)
+        layout_cache_rehash(layout_cache_sz ? layout_cache_sz * 2 : 4096);
+    size_t idx = memhash32((char*)flddesc, descsz) & (layout_cache_sz - 1);
+    jl_datatype_layout_t *ret;
+    while ((ret = layout_cache[idx]) != NULL) {
+        if (layout_eq(ret, flddesc))
+            break;
+        idx = (idx + 1) & (layout_cache_sz - 1);
+    }
+    if (ret == NULL) {
+        ret = (jl_datatype_layout_t*)jl_gc_perm_alloc(
+            descsz + (has_padding ? sizeof(uint32_t) : 0), 0, 4, 0);
+        if (has_padding) {
+            ret = (jl_datatype_layout_t*)(((char*)ret) + sizeof(uint32_t));
+            jl_datatype_layout_n_nonptr(ret) = n_nonptr;
+        }
+        memcpy(ret, flddesc, descsz);
+        layout_cache[idx] = ret;
+        layout_cache_count++;
+    }
+    JL_UNLOCK_NOGC(&layout_cache_lock);
+    free(scratch);
+    return ret;
 }
 
 // Determine if homogeneous tuple with fields of type t will have
@@ -669,14 +739,17 @@ UNBOX_FUNC(voidpointer, void*)
     }
 BOX_FUNC(float32, float,  jl_box, 1)
 BOX_FUNC(voidpointer, void*,  jl_box, 1)
-#ifdef _P64
-BOX_FUNC(float64, double, jl_box, 1)
-#else
-BOX_FUNC(float64, double, jl_box, 2)
-#endif
 
 #define NBOX_C 1024
 
+// interned box caches for the 32 and 64 bit integer types; the cached range
+// is +/- jl_nbox_c/2 for the signed types and [0, jl_nbox_c) for the
+// unsigned ones, and can be widened at startup with the JULIA_BOX_CACHE
+// environment variable (see jl_init_int32_int64_cache). Zero until the
+// caches are allocated so the box functions fall through cleanly during
+// bootstrap.
+static size_t jl_nbox_c = 0;
+
 #define SIBOX_FUNC(typ,c_type,nw)\
     static jl_value_t *boxed_##typ##_cache[NBOX_C];             \
     JL_DLLEXPORT jl_value_t *jl_box_##typ(c_type x)             \
@@ -702,20 +775,96 @@ BOX_FUNC(float64, double, jl_box, 2)
         *(c_type*)jl_data_ptr(v) = x;                           \
         return v;                                               \
     }
+// same as SIBOX_FUNC/UIBOX_FUNC but with a heap-allocated cache whose length
+// is the runtime-configurable jl_nbox_c
+#define SIBOX_DYN_FUNC(typ,c_type,nw)                           \
+    static jl_value_t **boxed_##typ##_cache;                    \
+    JL_DLLEXPORT jl_value_t *jl_box_##typ(c_type x)             \
+    {                                                           \
+        jl_ptls_t ptls = jl_get_ptls_states();                  \
+        u##c_type idx = (u##c_type)x + (u##c_type)(jl_nbox_c/2);\
+        if (idx < (u##c_type)jl_nbox_c)                         \
+            return boxed_##typ##_cache[idx];                    \
+        jl_value_t *v = jl_gc_alloc(ptls, nw * sizeof(void*),   \
+                                    jl_##typ##_type);           \
+        *(c_type*)jl_data_ptr(v) = x;                           \
+        return v;                                               \
+    }
+#define UIBOX_DYN_FUNC(typ,c_type,nw)                           \
+    static jl_value_t **boxed_##typ##_cache;                    \
+    JL_DLLEXPORT jl_value_t *jl_box_##typ(c_type x)             \
+    {                                                           \
+        jl_ptls_t ptls = jl_get_ptls_states();                  \
+        if (x < (c_type)jl_nbox_c)                              \
+            return boxed_##typ##_cache[x];                      \
+        jl_value_t *v = jl_gc_alloc(ptls, nw * sizeof(void*),   \
+                                    jl_##typ##_type);           \
+        *(c_type*)jl_data_ptr(v) = x;                           \
+        return v;                                               \
+    }
 SIBOX_FUNC(int16,  int16_t, 1)
-SIBOX_FUNC(int32,  int32_t, 1)
+SIBOX_DYN_FUNC(int32,  int32_t, 1)
 UIBOX_FUNC(uint16, uint16_t, 1)
-UIBOX_FUNC(uint32, uint32_t, 1)
+UIBOX_DYN_FUNC(uint32, uint32_t, 1)
 UIBOX_FUNC(ssavalue, size_t, 1)
 UIBOX_FUNC(slotnumber, size_t, 1)
 #ifdef _P64
-SIBOX_FUNC(int64,  int64_t, 1)
-UIBOX_FUNC(uint64, uint64_t, 1)
+UIBOX_DYN_FUNC(uint64, uint64_t, 1)
 #else
-SIBOX_FUNC(int64,  int64_t, 2)
-UIBOX_FUNC(uint64, uint64_t, 2)
+UIBOX_DYN_FUNC(uint64, uint64_t, 2)
 #endif
 
+static jl_value_t **boxed_int64_cache;
+JL_DLLEXPORT jl_value_t *jl_box_int64(int64_t x)
+{
+    jl_ptls_t ptls = jl_get_ptls_states();
+    uint64_t idx = (uint64_t)x + jl_nbox_c / 2;
+    if (idx < (uint64_t)jl_nbox_c)
+        return boxed_int64_cache[idx];
+    // outside the interned range, see if this thread boxed the value
+    // recently; sharing a box is fine since Int64 compares by value
+    size_t slot = (size_t)(((uint64_t)x ^ ((uint64_t)x >> 32)) & (N_BOX_CACHE - 1));
+    jl_value_t *v = ptls->int64_box_cache[slot];
+    if (v != NULL && *(int64_t*)jl_data_ptr(v) == x)
+        return v;
+    v = jl_gc_alloc(ptls, sizeof(int64_t), jl_int64_type);
+    *(int64_t*)jl_data_ptr(v) = x;
+    ptls->int64_box_cache[slot] = v;
+    return v;
+}
+
+static jl_value_t *boxed_float64_cache[NBOX_C];
+JL_DLLEXPORT jl_value_t *jl_box_float64(double x)
+{
+    jl_ptls_t ptls = jl_get_ptls_states();
+    uint64_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    // intern the common constants: integer and half-integer values in the
+    // default box range, except -0.0 which must keep its sign bit
+    double t = x + x;
+    if (t >= -(double)(NBOX_C / 2) && t < (double)(NBOX_C / 2)) {
+        int32_t i = (int32_t)t;
+        if ((double)i == t && !(i == 0 && (bits >> 63))) {
+            jl_value_t *c = boxed_float64_cache[i + NBOX_C / 2];
+            if (c != NULL)
+                return c;
+        }
+    }
+    // recently-boxed cache, compared bit-exactly
+    size_t slot = (size_t)((bits ^ (bits >> 21) ^ (bits >> 42)) & (N_BOX_CACHE - 1));
+    jl_value_t *v = ptls->float64_box_cache[slot];
+    if (v != NULL) {
+        uint64_t vbits;
+        memcpy(&vbits, jl_data_ptr(v), sizeof(vbits));
+        if (vbits == bits)
+            return v;
+    }
+    v = jl_gc_alloc(ptls, sizeof(double), jl_float64_type);
+    *(double*)jl_data_ptr(v) = x;
+    ptls->float64_box_cache[slot] = v;
+    return v;
+}
+
 static jl_value_t *boxed_char_cache[128];
 JL_DLLEXPORT jl_value_t *jl_box_char(uint32_t x)
 {
@@ -741,10 +890,29 @@ JL_DLLEXPORT jl_value_t *jl_box_uint8(uint8_t x)
 
 void jl_init_int32_int64_cache(void)
 {
+    // JULIA_BOX_CACHE widens the interned range of the 32/64 bit integer
+    // types beyond the default +/- NBOX_C/2
+    size_t nbox = NBOX_C;
+    const char *env = getenv("JULIA_BOX_CACHE");
+    if (env) {
+        long n = atol(env);
+        if (n >= NBOX_C && n <= (1 << 24))
+            nbox = (size_t)n;
+    }
+    boxed_int32_cache = (jl_value_t**)calloc(nbox, sizeof(jl_value_t*));
+    boxed_int64_cache = (jl_value_t**)calloc(nbox, sizeof(jl_value_t*));
+    boxed_uint32_cache = (jl_value_t**)calloc(nbox, sizeof(jl_value_t*));
+    boxed_uint64_cache = (jl_value_t**)calloc(nbox, sizeof(jl_value_t*));
+    if (!boxed_int32_cache || !boxed_int64_cache ||
+        !boxed_uint32_cache || !boxed_uint64_cache)
+        abort();
+    jl_nbox_c = nbox;
     int64_t i;
+    for(i=0; i < (int64_t)nbox; i++) {
+        boxed_int32_cache[i]  = jl_permbox32(jl_int32_type, i-(int64_t)nbox/2);
+        boxed_int64_cache[i]  = jl_permbox64(jl_int64_type, i-(int64_t)nbox/2);
+    }
     for(i=0; i < NBOX_C; i++) {
-        boxed_int32_cache[i]  = jl_permbox32(jl_int32_type, i-NBOX_C/2);
-        boxed_int64_cache[i]  = jl_permbox64(jl_int64_type, i-NBOX_C/2);
 #ifdef _P64
         boxed_ssavalue_cache[i] = jl_permbox64(jl_ssavalue_type, i);
         boxed_slotnumber_cache[i] = jl_permbox64(jl_slotnumber_type, i);
@@ -770,6 +938,13 @@ void jl_init_box_caches(void)
     for(i=0; i < NBOX_C; i++) {
         boxed_int16_cache[i]  = jl_permbox16(jl_int16_type, i-NBOX_C/2);
         boxed_uint16_cache[i] = jl_permbox16(jl_uint16_type, i);
+        // common Float64 constants: integer and half-integer values around 0
+        double fv = (i - NBOX_C / 2) * 0.5;
+        int64_t fbits;
+        memcpy(&fbits, &fv, sizeof(fbits));
+        boxed_float64_cache[i] = jl_permbox64(jl_float64_type, fbits);
+    }
+    for(i=0; i < (int64_t)jl_nbox_c; i++) {
         boxed_uint32_cache[i] = jl_permbox32(jl_uint32_type, i);
         boxed_uint64_cache[i] = jl_permbox64(jl_uint64_type, i);
     }
@@ -819,26 +994,40 @@ static void init_struct_tail(jl_datatype_t *type, jl_value_t *jv, size_t na)
 JL_DLLEXPORT jl_value_t *jl_new_structv(jl_datatype_t *type, jl_value_t **args, uint32_t na)
 {
     jl_ptls_t ptls = jl_get_ptls_states();
-    if (type->instance != NULL) {
-        for (size_t i = 0; i < na; i++) {
-            jl_value_t *ft = jl_field_type(type, i);
-            if (!jl_isa(args[i], ft))
-                jl_type_error("new", ft, args[i]);
-        }
-        return type->instance;
+    // check the field types up front: jl_isa can allocate (and so run GC),
+    // and doing all of it before the allocation below means the new object
+    // is still young for the entire store loop, so no field store needs a
+    // write barrier. Exact concrete matches skip jl_isa entirely.
+    for (size_t i = 0; i < na; i++) {
+        jl_value_t *ft = jl_field_type(type, i);
+        if (jl_typeof(args[i]) != ft && !jl_isa(args[i], ft))
+            jl_type_error("new", ft, args[i]);
     }
+    if (type->instance != NULL)
+        return type->instance;
     if (type->layout == NULL)
         jl_type_error("new", (jl_value_t*)jl_datatype_type, (jl_value_t*)type);
     jl_value_t *jv = jl_gc_alloc(ptls, jl_datatype_size(type), type);
-    JL_GC_PUSH1(&jv);
     for (size_t i = 0; i < na; i++) {
-        jl_value_t *ft = jl_field_type(type, i);
-        if (!jl_isa(args[i], ft))
-            jl_type_error("new", ft, args[i]);
-        jl_set_nth_field(jv, i, args[i]);
+        size_t offs = jl_field_offset(type, i);
+        if (jl_field_isptr(type, i)) {
+            *(jl_value_t**)((char*)jv + offs) = args[i];
+        }
+        else {
+            jl_value_t *ft = jl_field_type(type, i);
+            if (jl_is_uniontype(ft)) {
+                uint8_t *psel = &((uint8_t*)jv)[offs + jl_field_size(type, i) - 1];
+                unsigned nth = 0;
+                if (!jl_find_union_component(ft, jl_typeof(args[i]), &nth))
+                    assert(0 && "invalid field assignment to isbits union");
+                *psel = nth;
+                if (jl_is_datatype_singleton((jl_datatype_t*)jl_typeof(args[i])))
+                    continue;
+            }
+            jl_assign_bits((char*)jv + offs, args[i]);
+        }
     }
     init_struct_tail(type, jv, na);
-    JL_GC_POP();
     return jv;
 }
 
@@ -890,11 +1079,40 @@ JL_DLLEXPORT jl_value_t *jl_new_struct_uninit(jl_datatype_t *type)
 
 // field access ---------------------------------------------------------------
 
+// cache for dynamic getfield(obj, :name) on wide structs: maps a
+// (field-names svec, symbol) pair to the field index. A hit is validated
+// against the svec itself, so a stale entry (addresses can be reused after
+// GC) or a torn racy update can only cause a rescan, never a wrong answer;
+// that also means no lock is needed.
+#define FIELD_INDEX_CACHE_SIZE 1024 // entries; power of two
+#define FIELD_INDEX_CACHE_MIN 16    // only cache types at least this wide
+typedef struct {
+    jl_svec_t *names;
+    jl_sym_t *sym;
+    uint32_t idx;
+} jl_fldcache_ent_t;
+static jl_fldcache_ent_t jl_fldcache[FIELD_INDEX_CACHE_SIZE];
+
 JL_DLLEXPORT int jl_field_index(jl_datatype_t *t, jl_sym_t *fld, int err)
 {
     jl_svec_t *fn = jl_field_names(t);
-    for(size_t i=0; i < jl_svec_len(fn); i++) {
+    size_t n = jl_svec_len(fn);
+    jl_fldcache_ent_t *e = NULL;
+    if (n >= FIELD_INDEX_CACHE_MIN) {
+        uintptr_t h = ((uintptr_t)fn ^ (uintptr_t)fld) >> 4;
+        e = &jl_fldcache[h & (FIELD_INDEX_CACHE_SIZE - 1)];
+        size_t idx = e->idx;
+        if (e->names == fn && e->sym == fld && idx < n &&
+            jl_svecref(fn, idx) == (jl_value_t*)fld)
+            return (int)idx;
+    }
+    for(size_t i=0; i < n; i++) {
         if (jl_svecref(fn,i) == (jl_value_t*)fld) {
+            if (e) {
+                e->names = fn;
+                e->sym = fld;
+                e->idx = (uint32_t)i;
+            }
             return (int)i;
         }
     }
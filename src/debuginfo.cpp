@@ -157,10 +157,152 @@ struct strrefcomp {
     }
 };
 
+// function name -> GC frame bytes, recorded by the late GC lowering pass and
+// consumed (then erased) when the emitted object is registered below. Both
+// sides run under the codegen lock, so no separate locking is needed.
+static StringMap<uint64_t> gcframe_size_map;
+extern "C" void jl_record_gc_frame_size(const char *fname, uint64_t nbytes)
+{
+    gcframe_size_map[fname] = nbytes;
+}
+
+#if defined(_OS_LINUX_)
+// --- perf JIT symbol export ---
+//
+// Without this, Linux perf shows every jitted frame as an anonymous
+// mapping. Two opt-in mechanisms, both fed from the symbol registration
+// loop below (which already sees every emitted function with its final
+// address and size):
+//
+//   JULIA_PERF_MAP=1      append "addr size name" lines to
+//                         /tmp/perf-<pid>.map, the cheap format perf
+//                         consults automatically for anonymous samples
+//   JULIA_PERF_JITDUMP=1  write jit-<pid>.dump in the jitdump format in
+//                         the current directory (code bytes included), so
+//                         `perf inject --jit` can synthesize ELF images
+//                         with full symbols for annotate and flamegraphs
+//
+// All writers run while holding the codegen lock and the threadsafe
+// rwlock, so plain stdio without extra locking is fine here.
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#define JITDUMP_MAGIC 0x4A695444 // "JiTD"
+#define JITDUMP_VERSION 1
+#define JITDUMP_CODE_LOAD 0
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t total_size;
+    uint32_t elf_mach;
+    uint32_t pad1;
+    uint32_t pid;
+    uint64_t timestamp;
+    uint64_t flags;
+} jitdump_header_t;
+
+typedef struct {
+    uint32_t id;
+    uint32_t total_size;
+    uint64_t timestamp;
+    uint32_t pid;
+    uint32_t tid;
+    uint64_t vma;
+    uint64_t code_addr;
+    uint64_t code_size;
+    uint64_t code_index;
+} jitdump_code_load_t;
+
+static FILE *perf_map_file = NULL;
+static FILE *jitdump_file = NULL;
+static uint64_t jitdump_code_index = 0;
+
+static uint64_t perf_timestamp(void)
+{
+    // perf timestamps sample CLOCK_MONOTONIC (perf record -k monotonic)
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void jl_perf_symbols_init(void)
+{
+    static int initialized = 0;
+    if (initialized)
+        return;
+    initialized = 1;
+    if (getenv("JULIA_PERF_MAP")) {
+        char path[64];
+        snprintf(path, sizeof(path), "/tmp/perf-%d.map", (int)getpid());
+        perf_map_file = fopen(path, "w");
+    }
+    if (getenv("JULIA_PERF_JITDUMP")) {
+        char path[64];
+        snprintf(path, sizeof(path), "jit-%d.dump", (int)getpid());
+        int fd = open(path, O_CREAT | O_TRUNC | O_RDWR, 0644);
+        if (fd == -1)
+            return;
+        jitdump_file = fdopen(fd, "w");
+        jitdump_header_t hdr;
+        memset(&hdr, 0, sizeof(hdr));
+        hdr.magic = JITDUMP_MAGIC;
+        hdr.version = JITDUMP_VERSION;
+        hdr.total_size = sizeof(hdr);
+#if defined(_CPU_X86_64_)
+        hdr.elf_mach = 62;  // EM_X86_64
+#elif defined(_CPU_X86_)
+        hdr.elf_mach = 3;   // EM_386
+#elif defined(_CPU_AARCH64_)
+        hdr.elf_mach = 183; // EM_AARCH64
+#elif defined(_CPU_ARM_)
+        hdr.elf_mach = 40;  // EM_ARM
+#endif
+        hdr.pid = (uint32_t)getpid();
+        hdr.timestamp = perf_timestamp();
+        fwrite(&hdr, sizeof(hdr), 1, jitdump_file);
+        fflush(jitdump_file);
+        // perf locates the dump through this PROT_EXEC mapping of its
+        // header page, which shows up as an mmap event in perf.data
+        mmap(NULL, (size_t)sysconf(_SC_PAGESIZE), PROT_READ | PROT_EXEC,
+             MAP_PRIVATE, fd, 0);
+    }
+}
+
+static void jl_perf_record_symbol(const char *name, uint64_t addr, uint64_t size)
+{
+    jl_perf_symbols_init();
+    if (perf_map_file) {
+        fprintf(perf_map_file, "%llx %llx %s\n",
+                (unsigned long long)addr, (unsigned long long)size, name);
+        fflush(perf_map_file);
+    }
+    if (jitdump_file) {
+        jitdump_code_load_t rec;
+        rec.id = JITDUMP_CODE_LOAD;
+        rec.total_size = (uint32_t)(sizeof(rec) + strlen(name) + 1 + size);
+        rec.timestamp = perf_timestamp();
+        rec.pid = (uint32_t)getpid();
+        rec.tid = (uint32_t)syscall(SYS_gettid);
+        rec.vma = addr;
+        rec.code_addr = addr;
+        rec.code_size = size;
+        rec.code_index = jitdump_code_index++;
+        fwrite(&rec, sizeof(rec), 1, jitdump_file);
+        fwrite(name, strlen(name) + 1, 1, jitdump_file);
+        fwrite((const void*)(uintptr_t)addr, 1, size, jitdump_file);
+        fflush(jitdump_file);
+    }
+}
+#endif
+
 class JuliaJITEventListener: public JITEventListener
 {
     std::map<size_t, ObjectInfo, revcomp> objectmap;
     std::map<size_t, std::pair<size_t, jl_method_instance_t *>, revcomp> linfomap;
+    std::map<jl_method_instance_t *, jl_code_size_stats_t> codesizemap;
 
 public:
     JuliaJITEventListener(){}
@@ -346,12 +488,17 @@ public:
             StringRef secName;
             Section->getName(secName);
             uint64_t SectionLoadAddr = getLoadAddress(secName);
+            uint64_t ObjAddr = Addr; // object-coordinate address, for relocation accounting
             Addr -= SectionAddr - SectionLoadAddr;
             auto sNameOrError = sym_iter.getName();
             assert(sNameOrError);
             StringRef sName = sNameOrError.get();
             uint64_t SectionSize = Section->getSize();
             size_t Size = sym_size.second;
+#if defined(_OS_LINUX_)
+            if (Size > 0)
+                jl_perf_record_symbol(sName.str().c_str(), Addr, Size);
+#endif
 #if defined(_OS_WINDOWS_)
             if (SectionAddrCheck)
                 assert(SectionAddrCheck == SectionLoadAddr);
@@ -381,8 +528,26 @@ public:
                     }
                 }
             }
-            if (codeinst)
+            if (codeinst) {
                 linfomap[Addr] = std::make_pair(Size, codeinst->def);
+                if (jl_compile_log_enabled)
+                    jl_compile_log_event(codeinst->def, JL_COMPILE_EV_NATIVE, 0, 0, Size);
+                // accumulate the per-method code size accounting
+                jl_code_size_stats_t &szstats = codesizemap[codeinst->def];
+                szstats.native_bytes += Size;
+                szstats.nfuncs++;
+                auto gcsz = gcframe_size_map.find(sName);
+                if (gcsz != gcframe_size_map.end()) {
+                    szstats.gcframe_bytes += gcsz->second;
+                    gcframe_size_map.erase(gcsz);
+                }
+                // count the relocations applied inside this function's range
+                for (const object::RelocationRef &R : Section->relocations()) {
+                    uint64_t off = R.getOffset() + SectionAddr;
+                    if (off >= ObjAddr && off < ObjAddr + Size)
+                        szstats.nrelocs++;
+                }
+            }
             if (first) {
                 ObjectInfo tmp = {&debugObj,
                     (size_t)SectionSize,
@@ -411,6 +576,17 @@ public:
         uv_rwlock_rdlock(&threadsafe);
         return objectmap;
     }
+
+    int getCodeSizeStats(jl_method_instance_t *mi, jl_code_size_stats_t *stats)
+    {
+        uv_rwlock_rdlock(&threadsafe);
+        auto it = codesizemap.find(mi);
+        int found = it != codesizemap.end();
+        if (found)
+            *stats = it->second;
+        uv_rwlock_rdunlock(&threadsafe);
+        return found;
+    }
 };
 
 JL_DLLEXPORT void ORCNotifyObjectEmitted(JITEventListener *Listener,
@@ -1250,6 +1426,13 @@ extern "C" jl_method_instance_t *jl_gdblookuplinfo(void *p)
     return jl_jit_events->lookupLinfo((size_t)p);
 }
 
+// report how much native code a method instance has accumulated across all
+// of its compilations; returns 0 if nothing was emitted for it yet
+extern "C" JL_DLLEXPORT int jl_code_size_stats(jl_method_instance_t *mi, jl_code_size_stats_t *stats)
+{
+    return jl_jit_events->getCodeSizeStats(mi, stats);
+}
+
 #if (defined(_OS_LINUX_) || (defined(_OS_DARWIN_) && defined(LLVM_SHLIB)))
 extern "C" void __register_frame(void*);
 extern "C" void __deregister_frame(void*);
@@ -2,6 +2,21 @@
 
 /*
   saving and restoring system images
+
+  Note on the format: incremental (package) images are stream-deserialized
+  object by object here, unlike the sysimage's position-independent blittable
+  layout in staticdata.c. Reusing that layout for incremental images is not a
+  matter of swapping the writer: nearly every object in a package image is
+  entangled with state owned by the running session rather than by the image.
+  Types must be deduplicated against the session's type caches (an identical
+  DataType may already exist and must be unified by identity), methods are
+  spliced into method tables whose contents depend on what else was loaded,
+  backedges must be patched against the live world, and world-age counters
+  are assigned at load time. Those are exactly the steps that force a
+  per-object walk; the raw bytes that remain (code, constants) are already
+  the cheap part of deserialization. A blittable incremental format needs
+  image-local caches with a validation/merge step designed in from the start
+  -- a format redesign, not an optimization of this file.
 */
 #include <stdlib.h>
 #include <string.h>
@@ -12,6 +27,8 @@
 
 #ifndef _OS_WINDOWS_
 #include <dlfcn.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #endif
 
 #ifndef _COMPILER_MICROSOFT_
@@ -412,6 +429,7 @@ static void jl_serialize_module(jl_serializer_state *s, jl_module_t *m)
     }
     write_int8(s->s, 0);
     jl_serialize_value(s, m->parent);
+    jl_module_ensure_bindings(m);
     void **table = m->bindings.table;
     for(i=1; i < m->bindings.size; i+=2) {
         if (table[i] != HT_NOTFOUND) {
@@ -476,6 +494,29 @@ static int literal_val_id(jl_serializer_state *s, jl_value_t *v) JL_GC_DISABLED
     return jl_array_len(rs) - 1;
 }
 
+// whether instances of this type can be serialized as their raw in-memory
+// bytes in one span: plain bits all the way down, with no gc pointers, no
+// inlined-union selector bytes, and no Ptr fields anywhere (those are
+// normalized to NULL when written field-by-field, to help catch memory
+// errors). the serializer and deserializer both compute this from the type,
+// so the two sides agree on the layout without any extra bytes in the stream.
+static int jl_datatype_is_rawbits(jl_datatype_t *t) JL_NOTSAFEPOINT
+{
+    if (!t->isbitstype || t->layout == NULL)
+        return 0;
+    size_t i, nf = jl_datatype_nfields(t);
+    for (i = 0; i < nf; i++) {
+        jl_value_t *ft = jl_field_type(t, i);
+        if (jl_field_isptr(t, i) || !jl_is_datatype(ft))
+            return 0; // gc pointer, or inlined union (selector byte)
+        if (((jl_datatype_t*)ft)->name == jl_pointer_typename)
+            return 0;
+        if (!jl_datatype_is_rawbits((jl_datatype_t*)ft))
+            return 0;
+    }
+    return 1;
+}
+
 static void jl_serialize_value_(jl_serializer_state *s, jl_value_t *v, int as_literal) JL_GC_DISABLED
 {
     if (v == NULL) {
@@ -1030,6 +1071,11 @@ static void jl_serialize_value_(jl_serializer_state *s, jl_value_t *v, int as_li
                     ios_write(s->s, (char*)data, jl_datatype_size(t));
                 }
             }
+            else if (jl_datatype_is_rawbits(t)) {
+                // plain-bits struct: write the whole object as one span
+                // instead of boxing and tag-dispatching every field
+                ios_write(s->s, (char*)data, jl_datatype_size(t));
+            }
             else {
                 size_t i;
                 for (i = 0; i < nf; i++) {
@@ -1117,6 +1163,7 @@ static void jl_collect_lambdas_from_mod(jl_array_t *s, jl_module_t *m) JL_GC_DIS
     if (module_in_worklist(m))
         return;
     size_t i;
+    jl_module_ensure_bindings(m);
     void **table = m->bindings.table;
     for (i = 1; i < m->bindings.size; i += 2) {
         if (table[i] != HT_NOTFOUND) {
@@ -1220,7 +1267,8 @@ static void write_mod_list(ios_t *s, jl_array_t *a)
 }
 
 // "magic" string and version header of .ji file
-static const int JI_FORMAT_VERSION = 8;
+static const int JI_FORMAT_VERSION = 10; // 9: body may be zlib-compressed
+                                         // 10: body prefixed with its object count
 static const char JI_MAGIC[] = "\373jli\r\n\032\n"; // based on PNG signature
 static const uint16_t BOM = 0xFEFF; // byte-order marker
 static void write_header(ios_t *s)
@@ -1956,6 +2004,10 @@ static jl_value_t *jl_deserialize_value_any(jl_serializer_state *s, uint8_t tag,
         jl_set_nth_field(v, 1, sizefield);
         jl_set_nth_field(v, 2, jl_box_voidpointer(buf));
     }
+    else if (jl_datatype_is_rawbits(dt)) {
+        // matches the single-span encoding in jl_serialize_value_
+        ios_read(s->s, (char*)jl_data_ptr(v), jl_datatype_size(dt));
+    }
     else {
         jl_deserialize_struct(s, v, 0);
     }
@@ -2163,14 +2215,38 @@ static jl_value_t *jl_deserialize_value(jl_serializer_state *s, jl_value_t **loc
 static void jl_insert_methods(jl_array_t *list)
 {
     size_t i, l = jl_array_len(list);
+    // group the loaded methods by method table so each table is merged in
+    // one batch (one lock acquisition and one cache-invalidation scan per
+    // table, instead of one per method)
+    htable_t mt_groups;
+    htable_new(&mt_groups, 0);
+    jl_array_t *groups = jl_alloc_vec_any(0); // (mt, pairs) pairs
+    jl_array_t *pairs = NULL;
+    JL_GC_PUSH2(&groups, &pairs);
     for (i = 0; i < l; i += 2) {
         jl_method_t *meth = (jl_method_t*)jl_array_ptr_ref(list, i);
-        jl_tupletype_t *simpletype = (jl_tupletype_t*)jl_array_ptr_ref(list, i + 1);
         assert(jl_is_method(meth));
         jl_datatype_t *gf = jl_first_argument_datatype((jl_value_t*)meth->sig);
         assert(jl_is_datatype(gf) && gf->name->mt);
-        jl_method_table_insert(gf->name->mt, meth, simpletype);
+        jl_methtable_t *mt = gf->name->mt;
+        pairs = (jl_array_t*)ptrhash_get(&mt_groups, mt);
+        if ((void*)pairs == HT_NOTFOUND) {
+            pairs = jl_alloc_vec_any(0);
+            jl_array_ptr_1d_push(groups, (jl_value_t*)mt);
+            jl_array_ptr_1d_push(groups, (jl_value_t*)pairs);
+            ptrhash_put(&mt_groups, mt, pairs);
+        }
+        jl_array_ptr_1d_push(pairs, (jl_value_t*)meth);
+        jl_array_ptr_1d_push(pairs, jl_array_ptr_ref(list, i + 1));
+    }
+    l = jl_array_len(groups);
+    for (i = 0; i < l; i += 2) {
+        jl_methtable_t *mt = (jl_methtable_t*)jl_array_ptr_ref(groups, i);
+        pairs = (jl_array_t*)jl_array_ptr_ref(groups, i + 1);
+        jl_method_table_insert_batch(mt, pairs);
     }
+    htable_free(&mt_groups);
+    JL_GC_POP();
 }
 
 static size_t lowerbound_dependent_world_set(size_t world, arraylist_t *dependent_worlds) JL_NOTSAFEPOINT
@@ -2766,8 +2842,13 @@ JL_DLLEXPORT int jl_save_incremental(const char *fname, jl_array_t *worklist)
 
     jl_collect_backedges(edges);
 
+    // serialize the body into memory first so it can be written through
+    // zlib when available; cache files on shared filesystems are often
+    // I/O bound, and the tag stream compresses well
+    ios_t body;
+    ios_mem(&body, 1000000);
     jl_serializer_state s = {
-        &f, MODE_MODULE,
+        &body, MODE_MODULE,
         NULL,
         jl_get_ptls_states(),
         mod_array
@@ -2778,6 +2859,26 @@ JL_DLLEXPORT int jl_save_incremental(const char *fname, jl_array_t *worklist)
     jl_finalize_serializer(&s);
     serializer_worklist = NULL;
 
+    // write the body: object count (so the deserializer can size its backref
+    // list exactly), flag byte, length(s), then the raw or compressed bytes
+    write_uint64(&f, (uint64_t)backref_table_numel);
+    size_t bodylen = (size_t)body.size;
+    size_t complen = 0;
+    char *comp = jl_zlib_compress(body.buf, bodylen, &complen);
+    if (comp && complen < bodylen) {
+        write_uint8(&f, 1); // compressed
+        write_uint64(&f, bodylen);
+        write_uint64(&f, complen);
+        ios_write(&f, comp, complen);
+    }
+    else {
+        write_uint8(&f, 0); // raw (zlib unavailable, or it did not shrink)
+        write_uint64(&f, bodylen);
+        ios_write(&f, body.buf, bodylen);
+    }
+    free(comp);
+    ios_close(&body);
+
     jl_gc_enable(en);
     htable_reset(&edges_map, 0);
     htable_reset(&backref_table, 0);
@@ -3134,14 +3235,59 @@ static jl_value_t *_jl_restore_incremental(ios_t *f, jl_array_t *mod_array)
         return verify_fail;
     }
 
+    // the serialized body follows, either raw or zlib-compressed (see
+    // jl_save_incremental); expand a compressed body before deserializing
+    ios_t body;
+    char *bodybuf = NULL;
+    uint64_t nobjs = read_uint64(f); // backref entries the body will create
+    int compressed = read_uint8(f);
+    uint64_t bodylen = read_uint64(f);
+    if (compressed) {
+        uint64_t complen = read_uint64(f);
+        char *comp = (char*)malloc(complen);
+        bodybuf = (char*)malloc(bodylen);
+        if (comp == NULL || bodybuf == NULL ||
+            ios_readall(f, comp, complen) != complen ||
+            jl_zlib_uncompress(comp, complen, bodybuf, bodylen) != 0) {
+            free(comp);
+            free(bodybuf);
+            arraylist_free(&dependent_worlds);
+            ios_close(f);
+            return jl_get_exceptionf(jl_errorexception_type,
+                    "Cache file body could not be decompressed.");
+        }
+        free(comp);
+        ios_static_buffer(&body, bodybuf, bodylen);
+        ios_close(f);
+        f = &body;
+    }
+
     // prepare to deserialize
     int en = jl_gc_enable(0);
     jl_gc_enable_finalizers(ptls, 0);
     ++jl_world_counter; // reserve a world age for the deserialization
 
-    arraylist_new(&backref_list, 4000);
+    // most deserialized objects get a backref entry, and reallocating the
+    // list mid-restore memcpy's every slot, so size it up front from the
+    // object count recorded at save time
+    size_t backref_sizehint = nobjs + 100;
+    if (backref_sizehint < 4000)
+        backref_sizehint = 4000;
+    if (backref_list.items == NULL) {
+        arraylist_new(&backref_list, backref_sizehint);
+        arraylist_new(&flagref_list, 0);
+    }
+    else {
+        // reuse the allocations left behind by the previous restore in this
+        // process; package loading restores many cache files back to back
+        backref_list.len = 0;
+        if (backref_list.max < backref_sizehint) {
+            arraylist_grow(&backref_list, backref_sizehint);
+            backref_list.len = 0;
+        }
+        flagref_list.len = 0;
+    }
     arraylist_push(&backref_list, jl_main_module);
-    arraylist_new(&flagref_list, 0);
     arraylist_push(&dependent_worlds, (void*)jl_world_counter);
     arraylist_push(&dependent_worlds, (void*)jl_main_module->primary_world);
     qsort(dependent_worlds.items, dependent_worlds.len, sizeof(size_t), size_isgreater);
@@ -3152,6 +3298,10 @@ static jl_value_t *_jl_restore_incremental(ios_t *f, jl_array_t *mod_array)
         ptls,
         mod_array
     };
+    // n.b. this stage is inherently serial: backref indices are assigned by
+    // stream position, so no object can be materialized until everything
+    // before it in the stream has been. splitting it across threads would
+    // require the format to record a backref base per section.
     jl_array_t *restored = (jl_array_t*)jl_deserialize_value(&s, (jl_value_t**)&restored);
     serializer_worklist = restored;
 
@@ -3176,10 +3326,16 @@ static jl_value_t *_jl_restore_incremental(ios_t *f, jl_array_t *mod_array)
     jl_insert_backedges((jl_array_t*)external_backedges, &dependent_worlds); // restore external backedges (needs to be last)
 
     serializer_worklist = NULL;
-    arraylist_free(&flagref_list);
-    arraylist_free(&backref_list);
+    // keep the backref/flagref allocations for the next restore, unless this
+    // one grew the backref list unusually large
+    flagref_list.len = 0;
+    if (backref_list.max > (1 << 20))
+        arraylist_free(&backref_list);
+    else
+        backref_list.len = 0;
     arraylist_free(&dependent_worlds);
     ios_close(f);
+    free(bodybuf);
 
     jl_gc_enable_finalizers(ptls, 1); // make sure we don't run any Julia code concurrently before this point
     if (tracee_list) {
@@ -3211,6 +3367,24 @@ JL_DLLEXPORT jl_value_t *jl_restore_incremental(const char *fname, jl_array_t *m
         return jl_get_exceptionf(jl_errorexception_type,
             "Cache file \"%s\" not found.\n", fname);
     }
+#ifndef _OS_WINDOWS_
+    // deserialization is dominated by a very large number of 1-16 byte reads;
+    // mapping the cache file and walking it as an in-memory stream turns each
+    // of those into a plain pointer access instead of a buffered-ios_read call
+    struct stat sb;
+    if (fstat(f.fd, &sb) == 0 && S_ISREG(sb.st_mode) && sb.st_size > 0) {
+        size_t len = (size_t)sb.st_size;
+        char *buf = (char*)mmap(NULL, len, PROT_READ, MAP_PRIVATE, f.fd, 0);
+        if (buf != MAP_FAILED) {
+            ios_t mf;
+            ios_static_buffer(&mf, buf, len);
+            ios_close(&f);
+            jl_value_t *ret = _jl_restore_incremental(&mf, mod_array);
+            munmap(buf, len);
+            return ret;
+        }
+    }
+#endif
     return _jl_restore_incremental(&f, mod_array);
 }
 
@@ -262,9 +262,22 @@ static symbol_t **symtab_lookup(symbol_t **ptree, const char *str)
 
 value_t symbol(fl_context_t *fl_ctx, const char *str)
 {
+    // The reader interns every identifier token, so parsing looks up the
+    // same names over and over; check a direct-mapped cache before
+    // descending into the (unbalanced) symtab tree. Interned symbols are
+    // never freed, so cached pointers stay valid.
+    uint32_t h = 0;
+    const char *p = str;
+    while (*p)
+        h = h * 33 + (uint8_t)*p++;
+    h &= FL_SYMCACHE_SIZE - 1;
+    symbol_t *s = fl_ctx->symcache[h];
+    if (s != NULL && strcmp(str, s->name) == 0)
+        return tagptr(s, TAG_SYM);
     symbol_t **pnode = symtab_lookup(&fl_ctx->symtab, str);
     if (*pnode == NULL)
         *pnode = mk_symbol(str);
+    fl_ctx->symcache[h] = *pnode;
     return tagptr(*pnode, TAG_SYM);
 }
 
@@ -2317,6 +2330,7 @@ static void lisp_init(fl_context_t *fl_ctx, size_t initial_heapsize)
     fl_ctx->readstate = NULL;
     fl_ctx->gensym_ctr = 0;
     fl_ctx->gsnameno = 0;
+    memset(fl_ctx->symcache, 0, sizeof(fl_ctx->symcache));
 
 #ifdef MEMDEBUG2
     fl_ctx->tochain = NULL;
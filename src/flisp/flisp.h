@@ -380,8 +380,12 @@ JL_DLLEXPORT int jl_id_char(uint32_t wc);
 JL_DLLEXPORT int jl_id_start_char(uint32_t wc);
 JL_DLLEXPORT int jl_op_suffix_char(uint32_t wc);
 
+// direct-mapped cache in front of the symtab tree (see symbol())
+#define FL_SYMCACHE_SIZE 512
+
 struct _fl_context_t {
     symbol_t *symtab;
+    symbol_t *symcache[FL_SYMCACHE_SIZE];
     value_t NIL, T, F, FL_EOF, QUOTE;
     value_t int8sym, uint8sym, int16sym, uint16sym, int32sym, uint32sym;
     value_t int64sym, uint64sym;
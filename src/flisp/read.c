@@ -120,6 +120,19 @@ static int read_numtok(fl_context_t *fl_ctx, char *tok, value_t *pval, int base)
     return result;
 }
 
+// like ios_getc, but takes characters straight out of the ios buffer when it
+// has data, avoiding a function call and state check per character
+static inline int readchar(ios_t *f)
+{
+    if (f->state == bst_rd && f->bpos < f->size) {
+        char c = f->buf[f->bpos++];
+        if (c == '\n')
+            f->lineno++;
+        return (unsigned char)c;
+    }
+    return ios_getc(f);
+}
+
 static char nextchar(fl_context_t *fl_ctx)
 {
     int ch;
@@ -137,13 +150,25 @@ static char nextchar(fl_context_t *fl_ctx)
         }
         c = (char)ch;
         if (c == ';') {
-            // single-line comment
-            do {
+            // single-line comment: sweep over buffered bytes with memchr,
+            // falling back to ios_getc only to refill across buffer ends
+            while (1) {
+                if (f->state == bst_rd && f->bpos < f->size) {
+                    char *nl = (char*)memchr(f->buf + f->bpos, '\n', f->size - f->bpos);
+                    if (nl != NULL) {
+                        f->bpos = (size_t)(nl - f->buf) + 1;
+                        f->lineno++;
+                        break;
+                    }
+                    f->bpos = f->size;
+                }
                 ch = ios_getc(f);
                 if (ch == IOS_EOF)
                     return 0;
-            } while ((char)ch != '\n');
-            c = (char)ch;
+                if ((char)ch == '\n')
+                    break;
+            }
+            c = '\n';
         }
     } while (c==' ' || isspace((unsigned char)c));
     return c;
@@ -168,7 +193,7 @@ static int read_token(fl_context_t *fl_ctx, char c, int digits)
 
     while (1) {
         if (!first) {
-            ch = ios_getc(readF(fl_ctx));
+            ch = readchar(readF(fl_ctx));
             if (ch == IOS_EOF)
                 goto terminate;
             c = (char)ch;
@@ -180,7 +205,7 @@ static int read_token(fl_context_t *fl_ctx, char c, int digits)
         }
         else if (c == '\\') {
             issym = 1;
-            ch = ios_getc(readF(fl_ctx));
+            ch = readchar(readF(fl_ctx));
             if (ch == IOS_EOF)
                 goto terminate;
             accumchar(fl_ctx, (char)ch, &i);
@@ -232,7 +257,7 @@ static uint32_t peek(fl_context_t *fl_ctx)
         fl_ctx->readtoktype = TOK_DOUBLEQUOTE;
     }
     else if (c == '#') {
-        ch = ios_getc(readF(fl_ctx)); c = (char)ch;
+        ch = readchar(readF(fl_ctx)); c = (char)ch;
         if (ch == IOS_EOF)
             lerror(fl_ctx, fl_ctx->ParseError, "read: invalid read macro");
         if (c == '.') {
@@ -285,7 +310,7 @@ static uint32_t peek(fl_context_t *fl_ctx)
         }
         else if (isdigit(c)) {
             read_token(fl_ctx, c, 1);
-            c = (char)ios_getc(readF(fl_ctx));
+            c = (char)readchar(readF(fl_ctx));
             if (c == '#')
                 fl_ctx->readtoktype = TOK_BACKREF;
             else if (c == '=')
@@ -301,7 +326,7 @@ static uint32_t peek(fl_context_t *fl_ctx)
         else if (c == '!') {
             // #! single line comment for shbang script support
             do {
-                ch = ios_getc(readF(fl_ctx));
+                ch = readchar(readF(fl_ctx));
             } while (ch != IOS_EOF && (char)ch != '\n');
             return peek(fl_ctx);
         }
@@ -309,12 +334,12 @@ static uint32_t peek(fl_context_t *fl_ctx)
             // multiline comment
             int commentlevel=1;
             while (1) {
-                ch = ios_getc(readF(fl_ctx));
+                ch = readchar(readF(fl_ctx));
             hashpipe_gotc:
                 if (ch == IOS_EOF)
                     lerror(fl_ctx, fl_ctx->ParseError, "read: eof within comment");
                 if ((char)ch == '|') {
-                    ch = ios_getc(readF(fl_ctx));
+                    ch = readchar(readF(fl_ctx));
                     if ((char)ch == '#') {
                         commentlevel--;
                         if (commentlevel == 0)
@@ -325,7 +350,7 @@ static uint32_t peek(fl_context_t *fl_ctx)
                     goto hashpipe_gotc;
                 }
                 else if ((char)ch == '#') {
-                    ch = ios_getc(readF(fl_ctx));
+                    ch = readchar(readF(fl_ctx));
                     if ((char)ch == '|')
                         commentlevel++;
                     else
@@ -342,9 +367,9 @@ static uint32_t peek(fl_context_t *fl_ctx)
         }
         else if (c == ':') {
             // gensym
-            ch = ios_getc(readF(fl_ctx));
+            ch = readchar(readF(fl_ctx));
             if ((char)ch == 'g')
-                ch = ios_getc(readF(fl_ctx));
+                ch = readchar(readF(fl_ctx));
             read_token(fl_ctx, (char)ch, 0);
             errno = 0;
             x = strtol(fl_ctx->readbuf, &end, 10);
@@ -376,7 +401,7 @@ static uint32_t peek(fl_context_t *fl_ctx)
     }
     else if (c == ',') {
         fl_ctx->readtoktype = TOK_COMMA;
-        ch = ios_getc(readF(fl_ctx));
+        ch = readchar(readF(fl_ctx));
         if (ch == IOS_EOF)
             return fl_ctx->readtoktype;
         if ((char)ch == '@')
@@ -461,6 +486,36 @@ static value_t read_string(fl_context_t *fl_ctx)
 
     buf = (char*)malloc(sz);
     while (1) {
+        // bulk-copy buffered characters up to the next quote, escape, or end
+        // of the ios buffer, so ordinary string contents avoid the
+        // per-character path entirely
+        ios_t *f = readF(fl_ctx);
+        if (f->state == bst_rd && f->bpos < f->size) {
+            char *p = f->buf + f->bpos;
+            size_t avail = f->size - f->bpos;
+            size_t n = 0, nl = 0;
+            while (n < avail && p[n] != '"' && p[n] != '\\') {
+                if (p[n] == '\n')
+                    nl++;
+                n++;
+            }
+            if (n > 0) {
+                while (i + n >= sz-4) {  // -4: leaves room for longest utf8 sequence
+                    sz *= 2;
+                    temp = (char*)realloc(buf, sz);
+                    if (temp == NULL) {
+                        free(buf);
+                        lerror(fl_ctx, fl_ctx->ParseError, "read: out of memory reading string");
+                    }
+                    buf = temp;
+                }
+                memcpy(&buf[i], p, n);
+                i += n;
+                f->bpos += n;
+                f->lineno += nl;
+                continue;
+            }
+        }
         if (i >= sz-4) {  // -4: leaves room for longest utf8 sequence
             sz *= 2;
             temp = (char*)realloc(buf, sz);
@@ -470,7 +525,7 @@ static value_t read_string(fl_context_t *fl_ctx)
             }
             buf = temp;
         }
-        c = ios_getc(readF(fl_ctx));
+        c = readchar(readF(fl_ctx));
         if (c == IOS_EOF) {
             free(buf);
             lerror(fl_ctx, fl_ctx->ParseError, "read: unexpected end of input in string");
@@ -478,7 +533,7 @@ static value_t read_string(fl_context_t *fl_ctx)
         if (c == '"')
             break;
         else if (c == '\\') {
-            c = ios_getc(readF(fl_ctx));
+            c = readchar(readF(fl_ctx));
             if (c == IOS_EOF) {
                 free(buf);
                 lerror(fl_ctx, fl_ctx->ParseError, "read: end of input in escape sequence");
@@ -487,7 +542,7 @@ static value_t read_string(fl_context_t *fl_ctx)
             if (octal_digit(c)) {
                 do {
                     eseq[j++] = c;
-                    c = ios_getc(readF(fl_ctx));
+                    c = readchar(readF(fl_ctx));
                 } while (octal_digit(c) && j<3 && (c!=IOS_EOF));
                 if (c!=IOS_EOF) ios_ungetc(c, readF(fl_ctx));
                 eseq[j] = '\0';
@@ -498,10 +553,10 @@ static value_t read_string(fl_context_t *fl_ctx)
             else if ((c=='x' && (ndig=2)) ||
                      (c=='u' && (ndig=4)) ||
                      (c=='U' && (ndig=8))) {
-                c = ios_getc(readF(fl_ctx));
+                c = readchar(readF(fl_ctx));
                 while (hex_digit(c) && j<ndig && (c!=IOS_EOF)) {
                     eseq[j++] = c;
-                    c = ios_getc(readF(fl_ctx));
+                    c = readchar(readF(fl_ctx));
                 }
                 if (c!=IOS_EOF) ios_ungetc(c, readF(fl_ctx));
                 eseq[j] = '\0';
@@ -165,7 +165,20 @@ static void clear_mark(int bits)
     }
     bigval_t *v;
     for (int i = 0;i < jl_n_threads;i++) {
-        v = jl_all_tls_states[i]->heap.big_objects;
+        for (int s = 0; s < JL_GC_N_BIG_SHARDS; s++) {
+            v = jl_all_tls_states[i]->heap.big_objects[s];
+            while (v != NULL) {
+                void *gcv = &v->header;
+                if (!gc_verifying)
+                    arraylist_push(&bits_save[v->bits.gc], gcv);
+                v->bits.gc = bits;
+                v = v->next;
+            }
+        }
+    }
+
+    for (int s = 0; s < JL_GC_N_BIG_SHARDS; s++) {
+        v = big_objects_marked[s];
         while (v != NULL) {
             void *gcv = &v->header;
             if (!gc_verifying)
@@ -175,15 +188,6 @@ static void clear_mark(int bits)
         }
     }
 
-    v = big_objects_marked;
-    while (v != NULL) {
-        void *gcv = &v->header;
-        if (!gc_verifying)
-            arraylist_push(&bits_save[v->bits.gc], gcv);
-        v->bits.gc = bits;
-        v = v->next;
-    }
-
     gc_clear_mark_pagetable(bits);
 }
 
@@ -709,17 +713,6 @@ void objprofile_printall(void)
 }
 #endif
 
-#if defined(GC_TIME) || defined(GC_FINAL_STATS)
-STATIC_INLINE double jl_ns2ms(int64_t t)
-{
-    return t / (double)1e6;
-}
-
-STATIC_INLINE double jl_ns2s(int64_t t)
-{
-    return t / (double)1e9;
-}
-
 static uint64_t gc_premark_end;
 static uint64_t gc_postmark_end;
 void gc_settime_premark_end(void)
@@ -730,9 +723,17 @@ void gc_settime_postmark_end(void)
 {
     gc_postmark_end = jl_hrtime();
 }
-#endif
 
 #ifdef GC_FINAL_STATS
+STATIC_INLINE double jl_ns2ms(int64_t t)
+{
+    return t / (double)1e6;
+}
+
+STATIC_INLINE double jl_ns2s(int64_t t)
+{
+    return t / (double)1e9;
+}
 #ifdef _OS_LINUX_
 #include <malloc.h> // for mallinfo
 #endif
@@ -848,107 +849,187 @@ void jl_print_gc_stats(JL_STREAM *s)
 }
 #endif
 
-#ifdef GC_TIME
+// -- structured binary GC event log ---------------------------------------
+//
+// The old GC_TIME instrumentation wrote human-format lines to stdout in
+// the middle of the collection, perturbing exactly what it measured, and
+// needed a rebuild to turn on. The same hooks now append fixed-size
+// records (jl_gc_event_rec_t, gc.h) to a preallocated ring when the log
+// is enabled at runtime; jl_gc_event_log_stop dumps the retained records
+// behind a small header for offline decoding by contrib/gc_event_log.py.
+// All hooks run while the world is stopped, so plain stores suffice.
+
+int gc_event_log_on = 0;
+static jl_gc_event_rec_t *gc_event_ring = NULL;
+static size_t gc_event_ring_len = 0;
+static uint64_t gc_event_n = 0;
+
+static void gc_event(int event, int flags, int64_t d0, int64_t d1,
+                     int64_t d2, int64_t d3, int64_t d4) JL_NOTSAFEPOINT
+{
+    jl_gc_event_rec_t *rec = &gc_event_ring[gc_event_n % gc_event_ring_len];
+    rec->t = jl_hrtime();
+    rec->event = (uint16_t)event;
+    rec->flags = (uint16_t)flags;
+    rec->_pad = 0;
+    rec->data[0] = d0;
+    rec->data[1] = d1;
+    rec->data[2] = d2;
+    rec->data[3] = d3;
+    rec->data[4] = d4;
+    gc_event_n++;
+}
+
+JL_DLLEXPORT int jl_gc_event_log_start(size_t max_records)
+{
+    if (gc_event_log_on)
+        return -1;
+    if (max_records == 0)
+        max_records = 1 << 16; // 3.5MB of records by default
+    jl_gc_event_rec_t *buf =
+        (jl_gc_event_rec_t*)calloc(max_records, sizeof(jl_gc_event_rec_t));
+    if (buf == NULL)
+        return -1;
+    gc_event_ring = buf;
+    gc_event_ring_len = max_records;
+    gc_event_n = 0;
+    gc_event_log_on = 1;
+    return 0;
+}
+
+JL_DLLEXPORT int jl_gc_event_log_stop(const char *fname)
+{
+    if (!gc_event_log_on)
+        return -1;
+    gc_event_log_on = 0;
+    FILE *f = fopen(fname, "wb");
+    if (f == NULL)
+        return -1;
+    // "JLGCEV" magic, format version, record size, retained record count;
+    // multi-byte fields are in the writing machine's byte order
+    uint64_t retained = gc_event_n < gc_event_ring_len ? gc_event_n : gc_event_ring_len;
+    char header[16] = "JLGCEV";
+    header[6] = 1;
+    header[7] = (char)sizeof(jl_gc_event_rec_t);
+    memcpy(header + 8, &retained, sizeof(retained));
+    fwrite(header, 1, sizeof(header), f);
+    for (uint64_t i = 0; i < retained; i++)
+        fwrite(&gc_event_ring[(gc_event_n - retained + i) % gc_event_ring_len],
+               sizeof(jl_gc_event_rec_t), 1, f);
+    fclose(f);
+    free(gc_event_ring);
+    gc_event_ring = NULL;
+    gc_event_ring_len = 0;
+    return 0;
+}
+
 static int64_t skipped_pages = 0;
 static int64_t total_pages = 0;
 static int64_t freed_pages = 0;
-static int64_t pool_sweep_start;
 
 void gc_time_pool_start(void)
 {
+    if (!gc_event_log_on)
+        return;
     skipped_pages = 0;
     total_pages = 0;
     freed_pages = 0;
-    pool_sweep_start = jl_hrtime();
+    gc_event(GC_EV_POOL_SWEEP_BEGIN, 0, 0, 0, 0, 0, 0);
 }
 
 void gc_time_count_page(int freedall, int pg_skpd)
 {
+    if (!gc_event_log_on)
+        return;
     freed_pages += freedall;
     skipped_pages += pg_skpd;
     total_pages++;
 }
 
+// data: {total pages, skipped pages, freed pages, lazily freed pages}
 void gc_time_pool_end(int sweep_full)
 {
-    double sweep_pool_sec = (jl_hrtime() - pool_sweep_start) / 1e9;
-    double sweep_gb = total_pages * GC_PAGE_SZ / (double)(1024 * 1024 * 1024);
-    double sweep_speed = sweep_gb / sweep_pool_sec;
-    jl_printf(JL_STDOUT,
-              "GC sweep pools end %.2f ms at %.1f GB/s "
-              "(skipped %.2f %% of %" PRId64 ", swept %" PRId64 " pgs, "
-              "%" PRId64 " freed with %" PRId64 " lazily) %s\n",
-              sweep_pool_sec * 1000, sweep_speed,
-              (total_pages ? ((double)skipped_pages * 100) / total_pages : 0),
-              total_pages, total_pages - skipped_pages,
-              freed_pages, lazy_freed_pages,
-              sweep_full ? "full" : "quick");
+    if (!gc_event_log_on)
+        return;
+    gc_event(GC_EV_POOL_SWEEP_END, sweep_full ? GC_EV_FLAG_FULL : 0,
+             total_pages, skipped_pages, freed_pages, lazy_freed_pages, 0);
 }
 
+// data: {sweep duration}
 void gc_time_sysimg_end(uint64_t t0)
 {
-    double sweep_pool_sec = (jl_hrtime() - t0) / 1e9;
-    jl_printf(JL_STDOUT,
-              "GC sweep sysimg end %.2f ms\n",
-              sweep_pool_sec * 1000);
+    if (!gc_event_log_on)
+        return;
+    gc_event(GC_EV_SYSIMG_SWEEP, 0, (int64_t)(jl_hrtime() - t0), 0, 0, 0, 0);
 }
 
 static int64_t big_total;
 static int64_t big_freed;
 static int64_t big_reset;
-static int64_t big_sweep_start;
 
 void gc_time_big_start(void)
 {
+    if (!gc_event_log_on)
+        return;
     big_total = 0;
     big_freed = 0;
     big_reset = 0;
-    big_sweep_start = jl_hrtime();
+    gc_event(GC_EV_BIG_SWEEP_BEGIN, 0, 0, 0, 0, 0, 0);
 }
 
 void gc_time_count_big(int old_bits, int bits)
 {
+    if (!gc_event_log_on)
+        return;
     big_total++;
     big_reset += bits == GC_CLEAN;
     big_freed += !gc_marked(old_bits);
 }
 
+// data: {objects visited, objects freed, objects reset to clean}
 void gc_time_big_end(void)
 {
-    double t_ms = jl_ns2ms(jl_hrtime() - big_sweep_start);
-    jl_printf(JL_STDOUT, "GC sweep big %.2f ms "
-              "(freed %" PRId64 " / %" PRId64 " with %" PRId64 " rst)\n",
-              t_ms, big_freed, big_total, big_reset);
+    if (!gc_event_log_on)
+        return;
+    gc_event(GC_EV_BIG_SWEEP_END, 0, big_total, big_freed, big_reset, 0, 0);
 }
 
 static int64_t mallocd_array_total;
 static int64_t mallocd_array_freed;
-static int64_t mallocd_array_sweep_start;
 
 void gc_time_mallocd_array_start(void)
 {
+    if (!gc_event_log_on)
+        return;
     mallocd_array_total = 0;
     mallocd_array_freed = 0;
-    mallocd_array_sweep_start = jl_hrtime();
+    gc_event(GC_EV_ARRAY_SWEEP_BEGIN, 0, 0, 0, 0, 0, 0);
 }
 
 void gc_time_count_mallocd_array(int bits)
 {
+    if (!gc_event_log_on)
+        return;
     mallocd_array_total++;
     mallocd_array_freed += !gc_marked(bits);
 }
 
+// data: {arrays visited, arrays freed}
 void gc_time_mallocd_array_end(void)
 {
-    double t_ms = jl_ns2ms(jl_hrtime() - mallocd_array_sweep_start);
-    jl_printf(JL_STDOUT, "GC sweep arrays %.2f ms "
-              "(freed %" PRId64 " / %" PRId64 ")\n",
-              t_ms, mallocd_array_freed, mallocd_array_total);
+    if (!gc_event_log_on)
+        return;
+    gc_event(GC_EV_ARRAY_SWEEP_END, 0, mallocd_array_total,
+             mallocd_array_freed, 0, 0, 0);
 }
 
+// data: {mark pause, scanned bytes, perm scanned bytes, remset length,
+//        old-to-young pointers}
 void gc_time_mark_pause(int64_t t0, int64_t scanned_bytes,
                         int64_t perm_scanned_bytes)
 {
+    if (!gc_event_log_on)
+        return;
     int64_t last_remset_len = 0;
     int64_t remset_nptr = 0;
     for (int t_i = 0;t_i < jl_n_threads;t_i++) {
@@ -956,32 +1037,22 @@ void gc_time_mark_pause(int64_t t0, int64_t scanned_bytes,
         last_remset_len += ptls2->heap.last_remset->len;
         remset_nptr = ptls2->heap.remset_nptr;
     }
-    jl_printf(JL_STDOUT, "GC mark pause %.2f ms | "
-              "scanned %" PRId64 " kB = %" PRId64 " + %" PRId64 " | "
-              "remset %" PRId64 " %" PRId64 "\n",
-              jl_ns2ms(gc_premark_end - t0),
-              (scanned_bytes + perm_scanned_bytes) / 1024,
-              scanned_bytes / 1024, perm_scanned_bytes / 1024,
-              last_remset_len, remset_nptr);
+    gc_event(GC_EV_MARK, 0, (int64_t)gc_premark_end - t0, scanned_bytes,
+             perm_scanned_bytes, last_remset_len, remset_nptr);
 }
 
+// data: {sweep pause, live bytes, freed bytes, estimated freed bytes,
+//        bytes allocated since the last sweep}
 void gc_time_sweep_pause(uint64_t gc_end_t, int64_t actual_allocd,
                          int64_t live_bytes, int64_t estimate_freed,
                          int sweep_full)
 {
-    uint64_t sweep_pause = gc_end_t - gc_premark_end;
-    int pct = actual_allocd ? (gc_num.freed * 100) / actual_allocd : -1;
-    jl_printf(JL_STDOUT, "GC sweep pause %.2f ms live %" PRId64 " kB "
-              "(freed %" PRId64 " kB EST %" PRId64 " kB "
-              "[error %" PRId64 "] = %d%% of allocd b %" PRIu64 ") "
-              "(%.2f ms in post_mark) %s | next in %" PRId64 " kB\n",
-              jl_ns2ms(sweep_pause), live_bytes / 1024,
-              gc_num.freed / 1024, estimate_freed / 1024,
-              gc_num.freed - estimate_freed, pct, gc_num.since_sweep / 1024,
-              jl_ns2ms(gc_postmark_end - gc_premark_end),
-              sweep_full ? "full" : "quick", -gc_num.allocd / 1024);
+    if (!gc_event_log_on)
+        return;
+    gc_event(GC_EV_COLLECT_END, sweep_full ? GC_EV_FLAG_FULL : 0,
+             (int64_t)(gc_end_t - gc_premark_end), live_bytes,
+             gc_num.freed, estimate_freed, actual_allocd);
 }
-#endif
 
 void gc_debug_init(void)
 {
@@ -1088,23 +1159,28 @@ void gc_stats_all_pool(void)
 
 void gc_stats_big_obj(void)
 {
-    bigval_t *v = current_heap->big_objects;
+    bigval_t *v;
     size_t nused=0, nbytes=0;
-    while (v != NULL) {
-        if (gc_marked(v->bits.gc)) {
-            nused++;
-            nbytes += v->sz&~3;
+    for (int s = 0; s < JL_GC_N_BIG_SHARDS; s++) {
+        v = current_heap->big_objects[s];
+        while (v != NULL) {
+            if (gc_marked(v->bits.gc)) {
+                nused++;
+                nbytes += v->sz&~3;
+            }
+            v = v->next;
         }
-        v = v->next;
     }
-    v = big_objects_marked;
     size_t nused_old=0, nbytes_old=0;
-    while (v != NULL) {
-        if (gc_marked(v->bits.gc)) {
-            nused_old++;
-            nbytes_old += v->sz&~3;
+    for (int s = 0; s < JL_GC_N_BIG_SHARDS; s++) {
+        v = big_objects_marked[s];
+        while (v != NULL) {
+            if (gc_marked(v->bits.gc)) {
+                nused_old++;
+                nbytes_old += v->sz&~3;
+            }
+            v = v->next;
         }
-        v = v->next;
     }
 
     mallocarray_t *ma = current_heap->mallocarrays;
@@ -1374,6 +1450,189 @@ NOINLINE void gc_mark_loop_unwind(jl_ptls_t ptls, jl_gc_mark_sp_t sp, int pc_off
     ptls->safe_restore = old_buf;
 }
 
+// heap snapshot
+
+// Stream an object-graph dump of the entire heap to a file: one JSON record
+// per line of the form
+//     {"a":"0x...","t":"TypeName","s":SIZE,"r":["0x...",...]}
+// with the object address, type name, size in bytes (including malloc'd
+// array storage) and the addresses of all objects it references. The dump
+// covers all pool pages (walking `pagetable0/1`), the per-thread and global
+// big object lists and, through the owning arrays, malloc'd array storage.
+// The caller must ensure the heap is not mutated while it is walked, i.e.
+// other threads have to be quiesced; running a collection right before
+// keeps dead objects out of the dump but is not required for safety since
+// live cells are identified with `jl_gc_internal_obj_base_ptr`.
+
+JL_DLLEXPORT jl_value_t *jl_gc_internal_obj_base_ptr(void *p);
+
+static FILE *snapshot_stream = NULL;
+
+static size_t snapshot_array_nbytes(jl_array_t *a)
+{
+    size_t sz = 0;
+    int isbitsunion = jl_array_isbitsunion(a);
+    if (jl_array_ndims(a) == 1)
+        sz = a->elsize * a->maxsize + ((a->elsize == 1 && !isbitsunion) ? 1 : 0);
+    else
+        sz = a->elsize * jl_array_len(a);
+    if (isbitsunion)
+        sz += jl_array_len(a);
+    return sz;
+}
+
+static void snapshot_write_ref(jl_value_t *ref, int *nrefs)
+{
+    if (ref == NULL)
+        return;
+    fprintf(snapshot_stream, "%s\"%p\"", (*nrefs)++ ? "," : "", (void*)ref);
+}
+
+static void snapshot_write_obj(jl_value_t *v)
+{
+    jl_taggedvalue_t *o = jl_astaggedvalue(v);
+    uintptr_t tag = o->header & ~(uintptr_t)0xf;
+    jl_datatype_t *vt = (jl_datatype_t*)tag;
+    if (vt == NULL || !jl_is_datatype(vt))
+        return;
+    size_t sz;
+    const char *tname = jl_symbol_name(vt->name->name);
+    if (vt == jl_simplevector_type)
+        sz = jl_svec_len(v) * sizeof(void*) + sizeof(jl_svec_t);
+    else if (vt == jl_string_type)
+        sz = jl_string_len(v) + sizeof(size_t) + 1;
+    else if (vt->name == jl_array_typename) {
+        jl_array_t *a = (jl_array_t*)v;
+        sz = sizeof(jl_array_t);
+        if (a->flags.how == 1 || a->flags.how == 2)
+            sz += snapshot_array_nbytes(a);
+    }
+    else if (vt == jl_module_type)
+        sz = sizeof(jl_module_t);
+    else if (vt == jl_task_type)
+        sz = sizeof(jl_task_t);
+    else
+        sz = jl_datatype_size(vt);
+    fprintf(snapshot_stream, "{\"a\":\"%p\",\"t\":\"%s\",\"s\":%zd,\"r\":[",
+            (void*)v, tname, sz);
+    int nrefs = 0;
+    if (vt == jl_simplevector_type) {
+        size_t l = jl_svec_len(v);
+        jl_value_t **data = jl_svec_data(v);
+        for (size_t i = 0; i < l; i++)
+            snapshot_write_ref(data[i], &nrefs);
+    }
+    else if (vt->name == jl_array_typename) {
+        jl_array_t *a = (jl_array_t*)v;
+        if (a->flags.how == 3)
+            snapshot_write_ref(jl_array_data_owner(a), &nrefs);
+        if (a->flags.ptrarray && a->data != NULL) {
+            size_t l = jl_array_len(a);
+            for (size_t i = 0; i < l; i++)
+                snapshot_write_ref(((jl_value_t**)a->data)[i], &nrefs);
+        }
+    }
+    else if (vt == jl_module_type) {
+        jl_module_t *m = (jl_module_t*)v;
+        jl_binding_t **table = (jl_binding_t**)m->bindings.table;
+        size_t bsize = table == NULL ? 0 : m->bindings.size; // deferred sysimage table
+        for (size_t i = 1; i < bsize; i += 2) {
+            jl_binding_t *b = table[i];
+            if (b == (jl_binding_t*)HT_NOTFOUND)
+                continue;
+            snapshot_write_ref(b->value, &nrefs);
+            snapshot_write_ref(b->globalref, &nrefs);
+        }
+        for (size_t i = 0; i < m->usings.len; i++)
+            snapshot_write_ref((jl_value_t*)m->usings.items[i], &nrefs);
+        snapshot_write_ref((jl_value_t*)m->parent, &nrefs);
+    }
+    else if (vt->layout != NULL && vt->layout->fielddesc_type <= 2) {
+        size_t nf = jl_datatype_nfields(vt);
+        for (size_t i = 0; i < nf; i++) {
+            if (!jl_field_isptr(vt, i))
+                continue;
+            jl_value_t **slot = (jl_value_t**)((char*)v + jl_field_offset(vt, i));
+            snapshot_write_ref(*slot, &nrefs);
+        }
+    }
+    fprintf(snapshot_stream, "]}\n");
+}
+
+static void gc_snapshot_page(jl_gc_pagemeta_t *pg)
+{
+    jl_taggedvalue_t *v = (jl_taggedvalue_t*)(pg->data + GC_PAGE_OFFSET);
+    char *lim = (char*)v + GC_PAGE_SZ - GC_PAGE_OFFSET - pg->osize;
+    while ((char*)v <= lim) {
+        // distinguish live cells from freelist entries
+        if (jl_gc_internal_obj_base_ptr((char*)jl_valueof(v) + 1) == jl_valueof(v))
+            snapshot_write_obj(jl_valueof(v));
+        v = (jl_taggedvalue_t*)((char*)v + pg->osize);
+    }
+}
+
+static void gc_snapshot_pagetable0(pagetable0_t *pagetable0)
+{
+    for (int pg_i = 0; pg_i < REGION0_PG_COUNT / 32; pg_i++) {
+        uint32_t line = pagetable0->allocmap[pg_i];
+        if (line) {
+            for (int j = 0; j < 32; j++) {
+                if ((line >> j) & 1)
+                    gc_snapshot_page(pagetable0->meta[pg_i * 32 + j]);
+            }
+        }
+    }
+}
+
+static void gc_snapshot_pagetable1(pagetable1_t *pagetable1)
+{
+    for (int pg_i = 0; pg_i < REGION1_PG_COUNT / 32; pg_i++) {
+        uint32_t line = pagetable1->allocmap0[pg_i];
+        if (line) {
+            for (int j = 0; j < 32; j++) {
+                if ((line >> j) & 1)
+                    gc_snapshot_pagetable0(pagetable1->meta0[pg_i * 32 + j]);
+            }
+        }
+    }
+}
+
+static void gc_snapshot_pagetable(void)
+{
+    for (int pg_i = 0; pg_i < (REGION2_PG_COUNT + 31) / 32; pg_i++) {
+        uint32_t line = memory_map.allocmap1[pg_i];
+        if (line) {
+            for (int j = 0; j < 32; j++) {
+                if ((line >> j) & 1)
+                    gc_snapshot_pagetable1(memory_map.meta1[pg_i * 32 + j]);
+            }
+        }
+    }
+}
+
+static void gc_snapshot_big_list(bigval_t *v)
+{
+    for (; v != NULL; v = v->next)
+        snapshot_write_obj(jl_valueof(&v->header));
+}
+
+JL_DLLEXPORT int jl_gc_take_heap_snapshot(const char *filename)
+{
+    snapshot_stream = fopen(filename, "w");
+    if (snapshot_stream == NULL)
+        return -1;
+    gc_snapshot_pagetable();
+    for (int i = 0; i < jl_n_threads; i++) {
+        for (int s = 0; s < JL_GC_N_BIG_SHARDS; s++)
+            gc_snapshot_big_list(jl_all_tls_states[i]->heap.big_objects[s]);
+    }
+    for (int s = 0; s < JL_GC_N_BIG_SHARDS; s++)
+        gc_snapshot_big_list(big_objects_marked[s]);
+    int err = fclose(snapshot_stream);
+    snapshot_stream = NULL;
+    return err;
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -18,13 +18,76 @@ extern "C" {
 #endif
 #define MIN_BLOCK_PG_ALLOC (1) // 16 KB
 
+#define GC_HUGE_PG_SZ (2 * 1024 * 1024)
+
+// Back the pool page blocks with 2 MB huge pages to cut down on dTLB misses
+// on large heaps. Opt-in via `JULIA_GC_HUGE_PAGES` since decommitting
+// individual 16k pages out of a huge page splits it again and the hugetlb
+// pool is a machine-wide resource.
+static int gc_use_hugepages = 0;
+
+// With `JULIA_NUMA` set, recycled pages are dropped with MADV_DONTNEED
+// instead of MADV_FREE: the next thread to allocate from the page then
+// faults fresh zero pages on its own node (first touch), instead of
+// inheriting the physical placement of the page's previous owner.
+static int gc_numa_aware = 0;
+
 static int block_pg_cnt = DEFAULT_BLOCK_PG_ALLOC;
 static size_t current_pg_count = 0;
 
+// Per-thread page caches. The common page acquire/release works against the
+// calling thread's cache and never touches `gc_perm_lock`; the cache is
+// refilled (on a miss) and drained (when full) in batches of half its size
+// while the lock is held anyway. A cached page is invisible to both the
+// freemap scan and the sweep: its freemap and level-0 allocmap bits are
+// clear until it is handed out or drained back.
+#define GC_PAGE_CACHE_MAX 16
+
+typedef struct {
+    jl_gc_pagemeta_t *pages[GC_PAGE_CACHE_MAX];
+    int len;
+} jl_gc_page_cache_t;
+
+static jl_gc_page_cache_t *page_caches;
+
+// Pages freed while the decay policy is active are not returned to the OS
+// right away since under a bursty allocation pattern they are likely to be
+// reused shortly. Instead `jl_gc_free_page` timestamps the page and queues
+// it here, and `jl_gc_decay_free_pages` (run at the end of each collection)
+// releases the ones that stayed free for the whole decay period.
+// The policy is off by default (pages are released immediately, matching
+// the old behavior) and enabled by setting `JULIA_GC_PAGE_DECAY_MS`.
+static int64_t page_decay_ns = -1;
+static arraylist_t page_decay_list;
+static uint64_t page_return_count = 0; // pages returned to the OS
+static uint64_t page_reuse_count = 0;  // pages reused while awaiting release
+
+JL_DLLEXPORT uint64_t jl_gc_page_return_count(void)
+{
+    return page_return_count;
+}
+
+JL_DLLEXPORT uint64_t jl_gc_page_reuse_count(void)
+{
+    return page_reuse_count;
+}
+
 void jl_gc_init_page(void)
 {
     if (GC_PAGE_SZ * block_pg_cnt < jl_page_size)
         block_pg_cnt = jl_page_size / GC_PAGE_SZ; // exact division
+    page_caches = (jl_gc_page_cache_t*)calloc(jl_n_threads,
+                                              sizeof(jl_gc_page_cache_t));
+    arraylist_new(&page_decay_list, 0);
+    char *cp = getenv("JULIA_GC_PAGE_DECAY_MS");
+    if (cp)
+        page_decay_ns = strtol(cp, NULL, 10) * (int64_t)1000000;
+    cp = getenv("JULIA_GC_HUGE_PAGES");
+    if (cp && strtol(cp, NULL, 10) != 0)
+        gc_use_hugepages = 1;
+    cp = getenv("JULIA_NUMA");
+    if (cp && strtol(cp, NULL, 10) != 0)
+        gc_numa_aware = 1;
 }
 
 #ifndef MAP_NORESERVE // not defined in POSIX, FreeBSD, etc.
@@ -42,6 +105,31 @@ static char *jl_gc_try_alloc_pages(int pg_cnt)
     if (mem == NULL)
         return NULL;
 #else
+#if defined(_OS_LINUX_) && defined(MADV_HUGEPAGE)
+    if (gc_use_hugepages && pages_sz >= GC_HUGE_PG_SZ) {
+#ifdef MAP_HUGETLB
+        {
+            // try the preallocated hugetlb pool first, the result is
+            // huge-page (and therefore `GC_PAGE_SZ`) aligned
+            char *hmem = (char*)mmap(0, LLT_ALIGN(pages_sz, GC_HUGE_PG_SZ),
+                                     PROT_READ | PROT_WRITE,
+                                     MAP_NORESERVE | MAP_PRIVATE | MAP_ANONYMOUS |
+                                     MAP_HUGETLB, -1, 0);
+            if (hmem != MAP_FAILED)
+                return hmem;
+        }
+        // the pool may be exhausted or too fragmented, fall back to
+        // transparent huge pages on a normal (over-aligned) mapping
+#endif
+        char *hmem = (char*)mmap(0, pages_sz + GC_HUGE_PG_SZ, PROT_READ | PROT_WRITE,
+                                 MAP_NORESERVE | MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (hmem == MAP_FAILED)
+            return NULL;
+        hmem = (char*)LLT_ALIGN((uintptr_t)hmem, GC_HUGE_PG_SZ);
+        madvise(hmem, pages_sz, MADV_HUGEPAGE);
+        return hmem;
+    }
+#endif
     if (GC_PAGE_SZ > jl_page_size)
         pages_sz += GC_PAGE_SZ;
     char *mem = (char*)mmap(0, pages_sz, PROT_READ | PROT_WRITE,
@@ -166,11 +254,49 @@ static jl_gc_pagemeta_t *jl_gc_alloc_new_page(void)
     return page_meta;
 }
 
-// get a new page, either from the freemap
+// Pull up to half a cache's worth of additional free pages out of the
+// level-0 table the page being handed out lives in (they are address
+// adjacent, which also helps locality). Assumes `gc_perm_lock` is acquired.
+static void gc_page_cache_refill(struct jl_gc_metadata_ext *info,
+                                 jl_gc_page_cache_t *cache)
+{
+    pagetable0_t *pagetable0 = info->pagetable0;
+    for (unsigned i32 = info->pagetable0_i32; i32 < REGION0_PG_COUNT / 32; i32++) {
+        uint32_t freemap = pagetable0->freemap[i32];
+        while (freemap && cache->len < GC_PAGE_CACHE_MAX / 2) {
+            unsigned j = ffs_u32(freemap);
+            uint32_t msk = (uint32_t)(1 << j);
+            freemap &= ~msk;
+            pagetable0->freemap[i32] &= ~msk;
+            jl_gc_pagemeta_t *pg = pagetable0->meta[i32 * 32 + j];
+            assert(pg->data);
+            if (pg->free_time) {
+                // was waiting to be returned to the OS, keep it instead
+                pg->free_time = 0;
+                page_reuse_count++;
+            }
+            // pre-extend the sweep bound to cover this page; `ub` never
+            // shrinks so doing it now saves the hand-out any locking
+            if (pagetable0->ub < i32)
+                pagetable0->ub = i32;
+            cache->pages[cache->len++] = pg;
+        }
+        if (cache->len >= GC_PAGE_CACHE_MAX / 2)
+            break;
+    }
+}
+
+// get a new page, either from this thread's cache, from the freemap,
 // or from the kernel if none are available
 NOINLINE jl_gc_pagemeta_t *jl_gc_alloc_page(void)
 {
     struct jl_gc_metadata_ext info;
+    jl_gc_page_cache_t *cache = &page_caches[jl_get_ptls_states()->tid];
+    if (cache->len > 0) {
+        // per-thread fast path, no global lock
+        info = page_metadata_ext(cache->pages[--cache->len]->data);
+        goto have_page;
+    }
     JL_LOCK_NOGC(&gc_perm_lock);
 
     // scan over memory_map page-table for existing allocated but unused pages
@@ -236,47 +362,44 @@ have_free_page:
     if (info.pagetable0->ub < info.pagetable0_i32)
         info.pagetable0->ub = info.pagetable0_i32;
 
-    // mark this entry as in-use and not free
+    // mark this entry as no longer free
     info.pagetable0->freemap[info.pagetable0_i32] &= ~(uint32_t)(1 << info.pagetable0_i);
-    info.pagetable0->allocmap[info.pagetable0_i32] |= (uint32_t)(1 << info.pagetable0_i);
-    info.pagetable1->allocmap0[info.pagetable1_i32] |= (uint32_t)(1 << info.pagetable1_i);
-    memory_map.allocmap1[info.pagetable_i32] |= (uint32_t)(1 << info.pagetable_i);
 
+    if (info.meta->free_time) {
+        // the page was waiting to be returned to the OS, keep it instead
+        // (its stale decay list entry is dropped by `jl_gc_decay_free_pages`)
+        info.meta->free_time = 0;
+        page_reuse_count++;
+    }
+
+    // grab a batch of additional free pages for this thread while we
+    // already hold the lock
+    gc_page_cache_refill(&info, cache);
+    JL_UNLOCK_NOGC(&gc_perm_lock);
+
+have_page:
+    // mark the page as in-use; the pagetable words are shared with pages
+    // being handed out of other threads' caches concurrently, so the
+    // updates must be atomic
+    jl_atomic_fetch_or(&info.pagetable0->allocmap[info.pagetable0_i32],
+                       (uint32_t)(1 << info.pagetable0_i));
+    jl_atomic_fetch_or(&info.pagetable1->allocmap0[info.pagetable1_i32],
+                       (uint32_t)(1 << info.pagetable1_i));
+    jl_atomic_fetch_or(&memory_map.allocmap1[info.pagetable_i32],
+                       (uint32_t)(1 << info.pagetable_i));
 #ifdef _OS_WINDOWS_
     VirtualAlloc(info.meta->data, GC_PAGE_SZ, MEM_COMMIT, PAGE_READWRITE);
 #endif
-    current_pg_count++;
+    jl_atomic_fetch_add(&current_pg_count, 1);
     gc_final_count_page(current_pg_count);
-    JL_UNLOCK_NOGC(&gc_perm_lock);
     return info.meta;
 }
 
-// return a page to the freemap allocator
-void jl_gc_free_page(void *p)
+// Tell the OS we don't need the data in this page right now.
+// Returns `0` (without releasing anything) when the page shares an OS page
+// with a `GC_PAGE_SZ` neighbor that is still allocated.
+static int jl_gc_decommit_page(void *p)
 {
-    // update the allocmap and freemap to indicate this contains a free entry
-    struct jl_gc_metadata_ext info = page_metadata_ext(p);
-    uint32_t msk;
-    msk = (uint32_t)(1 << info.pagetable0_i);
-    assert(!(info.pagetable0->freemap[info.pagetable0_i32] & msk));
-    assert(info.pagetable0->allocmap[info.pagetable0_i32] & msk);
-    info.pagetable0->allocmap[info.pagetable0_i32] &= ~msk;
-    info.pagetable0->freemap[info.pagetable0_i32] |= msk;
-
-    msk = (uint32_t)(1 << info.pagetable1_i);
-    assert(info.pagetable1->allocmap0[info.pagetable1_i32] & msk);
-    if ((info.pagetable1->freemap0[info.pagetable1_i32] & msk) == 0)
-        info.pagetable1->freemap0[info.pagetable1_i32] |= msk;
-
-    msk = (uint32_t)(1 << info.pagetable_i);
-    assert(memory_map.allocmap1[info.pagetable_i32] & msk);
-    if ((memory_map.freemap1[info.pagetable_i32] & msk) == 0)
-        memory_map.freemap1[info.pagetable_i32] |= msk;
-
-    free(info.meta->ages);
-    info.meta->ages = NULL;
-
-    // tell the OS we don't need these pages right now
     size_t decommit_size = GC_PAGE_SZ;
     if (GC_PAGE_SZ < jl_page_size) {
         // ensure so we don't release more memory than intended
@@ -286,27 +409,209 @@ void jl_gc_free_page(void *p)
         p = otherp;
         while (n_pages--) {
             struct jl_gc_metadata_ext info = page_metadata_ext(otherp);
-            msk = (uint32_t)(1 << info.pagetable0_i);
+            uint32_t msk = (uint32_t)(1 << info.pagetable0_i);
             if (info.pagetable0->allocmap[info.pagetable0_i32] & msk)
-                goto no_decommit;
+                return 0;
             otherp = (void*)((char*)otherp + GC_PAGE_SZ);
         }
     }
 #ifdef _OS_WINDOWS_
     VirtualFree(p, decommit_size, MEM_DECOMMIT);
+#elif defined(MADV_FREE)
+    if (gc_numa_aware)
+        madvise(p, decommit_size, MADV_DONTNEED);
+    else
+        madvise(p, decommit_size, MADV_FREE);
 #else
     madvise(p, decommit_size, MADV_DONTNEED);
 #endif
+    page_return_count++;
+    return 1;
+}
+
+// Release the pages that have stayed on the decay list for the whole decay
+// period. Called with the world stopped at the end of a collection so that
+// the page table is stable.
+void jl_gc_decay_free_pages(void)
+{
+    if (page_decay_list.len == 0)
+        return;
+    uint64_t now = jl_hrtime();
+    size_t n = 0;
+    for (size_t i = 0; i < page_decay_list.len; i++) {
+        jl_gc_pagemeta_t *pg = (jl_gc_pagemeta_t*)page_decay_list.items[i];
+        if (pg->free_time == 0)
+            // reused by `jl_gc_alloc_page` since it was queued
+            continue;
+        if (now - pg->free_time >= (uint64_t)page_decay_ns) {
+            if (jl_gc_decommit_page(pg->data)) {
+                pg->free_time = 0;
+                continue;
+            }
+            // an allocated neighbor shares the OS page, retry next time
+        }
+        page_decay_list.items[n++] = pg;
+    }
+    page_decay_list.len = n;
+}
+
+// make a drained page visible to the freemap scan again.
+// Assumes `gc_perm_lock` is acquired.
+static void gc_return_page_to_freemap(struct jl_gc_metadata_ext *info)
+{
+    uint32_t msk;
+    msk = (uint32_t)(1 << info->pagetable0_i);
+    info->pagetable0->freemap[info->pagetable0_i32] |= msk;
+
+    msk = (uint32_t)(1 << info->pagetable1_i);
+    assert(info->pagetable1->allocmap0[info->pagetable1_i32] & msk);
+    if ((info->pagetable1->freemap0[info->pagetable1_i32] & msk) == 0)
+        info->pagetable1->freemap0[info->pagetable1_i32] |= msk;
+
+    msk = (uint32_t)(1 << info->pagetable_i);
+    assert(memory_map.allocmap1[info->pagetable_i32] & msk);
+    if ((memory_map.freemap1[info->pagetable_i32] & msk) == 0)
+        memory_map.freemap1[info->pagetable_i32] |= msk;
+
+    if (page_decay_ns < 0) {
+        // tell the OS we don't need these pages right now
+        jl_gc_decommit_page(info->meta->data);
+    }
+    else {
+        // keep the page committed for the decay period in case it gets
+        // reused, `jl_gc_decay_free_pages` will release it eventually
+        info->meta->free_time = jl_hrtime();
+        arraylist_push(&page_decay_list, info->meta);
+    }
 
-no_decommit:
     // new pages are now available starting at max of lb and pagetable_i32
-    if (memory_map.lb > info.pagetable_i32)
-        memory_map.lb = info.pagetable_i32;
-    if (info.pagetable1->lb > info.pagetable1_i32)
-        info.pagetable1->lb = info.pagetable1_i32;
-    if (info.pagetable0->lb > info.pagetable0_i32)
-        info.pagetable0->lb = info.pagetable0_i32;
-    current_pg_count--;
+    if (memory_map.lb > info->pagetable_i32)
+        memory_map.lb = info->pagetable_i32;
+    if (info->pagetable1->lb > info->pagetable1_i32)
+        info->pagetable1->lb = info->pagetable1_i32;
+    if (info->pagetable0->lb > info->pagetable0_i32)
+        info->pagetable0->lb = info->pagetable0_i32;
+}
+
+// return a page to this thread's cache (draining half the cache back to
+// the freemap allocator when it is full)
+void jl_gc_free_page(void *p)
+{
+    // update the allocmap to indicate this no longer contains an entry
+    struct jl_gc_metadata_ext info = page_metadata_ext(p);
+    uint32_t msk = (uint32_t)(1 << info.pagetable0_i);
+    assert(!(info.pagetable0->freemap[info.pagetable0_i32] & msk));
+    assert(info.pagetable0->allocmap[info.pagetable0_i32] & msk);
+    jl_atomic_fetch_and(&info.pagetable0->allocmap[info.pagetable0_i32], ~msk);
+
+    free(info.meta->ages);
+    info.meta->ages = NULL;
+    jl_atomic_fetch_add(&current_pg_count, -1);
+
+    jl_gc_page_cache_t *cache = &page_caches[jl_get_ptls_states()->tid];
+    if (cache->len < GC_PAGE_CACHE_MAX) {
+        cache->pages[cache->len++] = info.meta;
+        return;
+    }
+    JL_LOCK_NOGC(&gc_perm_lock);
+    gc_return_page_to_freemap(&info);
+    for (int i = 0; i < GC_PAGE_CACHE_MAX / 2; i++) {
+        jl_gc_pagemeta_t *pg = cache->pages[--cache->len];
+        struct jl_gc_metadata_ext cinfo = page_metadata_ext(pg->data);
+        gc_return_page_to_freemap(&cinfo);
+    }
+    JL_UNLOCK_NOGC(&gc_perm_lock);
+}
+
+// Fragmentation report: walk the allocated pages in the memory map and
+// aggregate, per size class, the page/object counts and a histogram of
+// page occupancy, to tell sparse heaps (compaction or a restart would pay
+// off) apart from genuinely full ones. Occupancy per page is computed from
+// `nfree` and is exact right after a collection (see the caveat on
+// `jl_gc_sizeclass_stats` in gc.c).
+
+#define GC_FRAG_BUCKETS 8
+
+typedef struct {
+    uint64_t npages;
+    uint64_t live;
+    uint64_t nfree;
+    // histogram of page occupancy in 1/GC_FRAG_BUCKETS-wide buckets
+    uint64_t occupancy[GC_FRAG_BUCKETS];
+} gc_frag_class_t;
+
+static void gc_frag_count_page(jl_gc_pagemeta_t *pg, gc_frag_class_t *frag)
+{
+    gc_frag_class_t *f = &frag[pg->pool_n];
+    uint64_t nobjs = (GC_PAGE_SZ - GC_PAGE_OFFSET) / pg->osize;
+    uint64_t live = nobjs - pg->nfree;
+    f->npages++;
+    f->live += live;
+    f->nfree += pg->nfree;
+    unsigned bucket = (unsigned)(live * GC_FRAG_BUCKETS / nobjs);
+    if (bucket >= GC_FRAG_BUCKETS)
+        bucket = GC_FRAG_BUCKETS - 1;
+    f->occupancy[bucket]++;
+}
+
+static void gc_frag_pagetable0(pagetable0_t *pagetable0, gc_frag_class_t *frag)
+{
+    for (unsigned pg_i = 0; pg_i <= pagetable0->ub; pg_i++) {
+        uint32_t line = pagetable0->allocmap[pg_i];
+        unsigned j;
+        for (j = 0; line; j++, line >>= 1) {
+            unsigned next = ffs_u32(line);
+            j += next;
+            line >>= next;
+            gc_frag_count_page(pagetable0->meta[pg_i * 32 + j], frag);
+        }
+    }
+}
+
+static void gc_frag_pagetable1(pagetable1_t *pagetable1, gc_frag_class_t *frag)
+{
+    for (unsigned pg_i = 0; pg_i <= pagetable1->ub; pg_i++) {
+        uint32_t line = pagetable1->allocmap0[pg_i];
+        unsigned j;
+        for (j = 0; line; j++, line >>= 1) {
+            unsigned next = ffs_u32(line);
+            j += next;
+            line >>= next;
+            pagetable0_t *pagetable0 = pagetable1->meta0[pg_i * 32 + j];
+            if (pagetable0)
+                gc_frag_pagetable0(pagetable0, frag);
+        }
+    }
+}
+
+JL_DLLEXPORT void jl_gc_fragmentation_report(void)
+{
+    gc_frag_class_t frag[JL_GC_N_POOLS];
+    memset(frag, 0, sizeof(frag));
+    for (unsigned pg_i = 0; pg_i <= memory_map.ub; pg_i++) {
+        uint32_t line = memory_map.allocmap1[pg_i];
+        unsigned j;
+        for (j = 0; line; j++, line >>= 1) {
+            unsigned next = ffs_u32(line);
+            j += next;
+            line >>= next;
+            pagetable1_t *pagetable1 = memory_map.meta1[pg_i * 32 + j];
+            if (pagetable1)
+                gc_frag_pagetable1(pagetable1, frag);
+        }
+    }
+    jl_printf(JL_STDERR,
+              "size   pages       live       free  occupancy (eighths, low to high)\n");
+    for (int i = 0; i < JL_GC_N_POOLS; i++) {
+        gc_frag_class_t *f = &frag[i];
+        if (f->npages == 0)
+            continue;
+        jl_printf(JL_STDERR, "%4d  %6" PRIu64 " %10" PRIu64 " %10" PRIu64 " ",
+                  jl_gc_sizeclasses[i], f->npages, f->live, f->nfree);
+        for (int b = 0; b < GC_FRAG_BUCKETS; b++)
+            jl_printf(JL_STDERR, " %6" PRIu64, f->occupancy[b]);
+        jl_printf(JL_STDERR, "\n");
+    }
 }
 
 #ifdef __cplusplus
@@ -22,6 +22,10 @@
 // number of stacks to always keep available per pool
 #define MIN_STACK_MAPPINGS_PER_POOL 5
 
+// number of stacks to cache per pool per thread; anything beyond this is
+// returned to the OS immediately instead of being pooled
+#define MAX_STACK_MAPPINGS_PER_POOL 64
+
 const size_t jl_guard_size = (4096 * 8);
 static volatile uint32_t num_stack_mappings = 0;
 
@@ -73,6 +77,30 @@ static void free_stack(void *stkbuf, size_t bufsz)
 }
 #endif
 
+// drop the physical pages of a pooled stack while keeping its mapping (and
+// guard page), so reuse stays a no-op but idle pools cost no memory
+#ifdef _OS_WINDOWS_
+static void scrub_stack(void *stkbuf, size_t bufsz)
+{
+    VirtualAlloc(stkbuf, bufsz, MEM_RESET, PAGE_READWRITE);
+}
+#else
+static void scrub_stack(void *stkbuf, size_t bufsz)
+{
+    char *data = (char*)stkbuf;
+#if !defined(JL_HAVE_UCONTEXT) && !defined(JL_HAVE_SIGALTSTACK)
+    // skip the PROT_NONE guard page
+    data += jl_guard_size;
+    bufsz -= jl_guard_size;
+#endif
+#if defined(MADV_FREE)
+    if (madvise(data, bufsz, MADV_FREE) == 0)
+        return;
+#endif
+    madvise(data, bufsz, MADV_DONTNEED);
+}
+#endif
+
 
 const unsigned pool_sizes[] = {
     128 * 1024,
@@ -108,7 +136,8 @@ static void _jl_free_stack(jl_ptls_t ptls, void *stkbuf, size_t bufsz)
 {
     if (bufsz <= pool_sizes[JL_N_STACK_POOLS - 1]) {
         unsigned pool_id = select_pool(bufsz);
-        if (pool_sizes[pool_id] == bufsz) {
+        if (pool_sizes[pool_id] == bufsz &&
+            ptls->heap.free_stacks[pool_id].len < MAX_STACK_MAPPINGS_PER_POOL) {
             arraylist_push(&ptls->heap.free_stacks[pool_id], stkbuf);
             return;
         }
@@ -129,7 +158,8 @@ void jl_release_task_stack(jl_ptls_t ptls, jl_task_t *task)
     size_t bufsz = task->bufsz;
     if (bufsz <= pool_sizes[JL_N_STACK_POOLS - 1]) {
         unsigned pool_id = select_pool(bufsz);
-        if (pool_sizes[pool_id] == bufsz) {
+        if (pool_sizes[pool_id] == bufsz &&
+            ptls->heap.free_stacks[pool_id].len < MAX_STACK_MAPPINGS_PER_POOL) {
             task->stkbuf = NULL;
             arraylist_push(&ptls->heap.free_stacks[pool_id], stkbuf);
         }
@@ -185,21 +215,29 @@ void sweep_stack_pools(void)
     for (int i = 0; i < jl_n_threads; i++) {
         jl_ptls_t ptls2 = jl_all_tls_states[i];
 
-        // free half of stacks that remain unused since last sweep
+        // scrub half of stacks that remain unused since last sweep: they
+        // keep their mapping (the pool is capped at push time, so this is
+        // bounded), but give their physical pages back to the OS. scrub the
+        // bottom of the list, which holds the least recently used stacks.
         for (int p = 0; p < JL_N_STACK_POOLS; p++) {
             arraylist_t *al = &ptls2->heap.free_stacks[p];
-            size_t n_to_free;
+            size_t n_to_scrub;
             if (al->len > MIN_STACK_MAPPINGS_PER_POOL) {
-                n_to_free = al->len / 2;
-                if (n_to_free > (al->len - MIN_STACK_MAPPINGS_PER_POOL))
-                    n_to_free = al->len - MIN_STACK_MAPPINGS_PER_POOL;
+                n_to_scrub = al->len / 2;
+                if (n_to_scrub > (al->len - MIN_STACK_MAPPINGS_PER_POOL))
+                    n_to_scrub = al->len - MIN_STACK_MAPPINGS_PER_POOL;
             }
             else {
-                n_to_free = 0;
+                n_to_scrub = 0;
+            }
+            if (num_stack_mappings > MAX_STACK_MAPPINGS / 2) {
+                // under global mapping pressure, unmap instead of caching
+                for (int n = 0; n < n_to_scrub; n++)
+                    free_stack(arraylist_pop(al), pool_sizes[p]);
             }
-            for (int n = 0; n < n_to_free; n++) {
-                void *stk = arraylist_pop(al);
-                free_stack(stk, pool_sizes[p]);
+            else {
+                for (int n = 0; n < n_to_scrub; n++)
+                    scrub_stack(al->items[n], pool_sizes[p]);
             }
         }
 
@@ -3,6 +3,9 @@
 #include "gc.h"
 #include "julia_gcext.h"
 #include "julia_assert.h"
+#ifdef _OS_LINUX_
+#include "ptrhash.h"
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -161,15 +164,98 @@ static int support_conservative_marking = 0;
  * when `jl_gc_collect` is called) with `jl_in_finalizer = 1`. (TODO:) When we
  * have proper support of GC transition in codegen, we should execute the
  * finalizers in unmanaged (GC safe) mode.
+ *
+ * Why even a quick (young) collection stops the world: the heap is shared.
+ * Any thread may hold a pointer to any other thread's pool objects in its
+ * stack, registers, or task-local state, and nothing records which thread
+ * "owns" a reference — the write barrier only records old-to-young edges
+ * into the *mutating* thread's remembered set, keyed by nothing. So a thread
+ * cannot collect "its own" young objects while others run: it would have to
+ * prove no other running thread can reach them, which would require either
+ * per-object ownership tracking on every write (a tax on all code) or read
+ * barriers, neither of which exists in this runtime or its generated code.
+ * Making pauses cheaper therefore means making the stopped phases shorter
+ * (the generational quick sweep already serves that role), not skipping
+ * the stop.
  */
 
 jl_gc_num_t gc_num = {0,0,0,0,0,0,0,0,0,0,0,0,0,0};
 static size_t last_long_collect_interval;
 
+// Always-on telemetry counters (see `jl_gc_telemetry_t` in julia.h).
+// Updated while the world is stopped (finalizer time is the exception and
+// is counted racily, same as `gc_num.freed`), so a monitoring thread can
+// copy them at any time and only risks slightly stale values.
+static jl_gc_telemetry_t gc_telemetry;
+
+JL_DLLEXPORT void jl_gc_telemetry(jl_gc_telemetry_t *stats)
+{
+    *stats = gc_telemetry;
+}
+
+// Per-collection pause records (see `jl_gc_pause_record_t` in julia.h).
+// The ring keeps the most recent GC_PAUSE_RING_LEN collections; records
+// are written while the world is stopped, so readers get the same
+// staleness guarantees as the telemetry counters above.
+#define GC_PAUSE_RING_LEN 1024
+static jl_gc_pause_record_t gc_pause_ring[GC_PAUSE_RING_LEN];
+static uint64_t gc_pause_ring_n = 0; // collections recorded since startup
+
+JL_DLLEXPORT uint64_t jl_gc_pause_count(void)
+{
+    return gc_pause_ring_n;
+}
+
+// copy out record `i`, where 0 is the oldest retained record; returns -1
+// when `i` is past the end of the ring
+JL_DLLEXPORT int jl_gc_pause_record(uint64_t i, jl_gc_pause_record_t *rec)
+{
+    uint64_t n = gc_pause_ring_n;
+    uint64_t retained = n < GC_PAUSE_RING_LEN ? n : GC_PAUSE_RING_LEN;
+    if (i >= retained)
+        return -1;
+    *rec = gc_pause_ring[(n - retained + i) % GC_PAUSE_RING_LEN];
+    return 0;
+}
+
+static int gc_pause_cmp(const void *a, const void *b)
+{
+    uint64_t pa = *(const uint64_t*)a, pb = *(const uint64_t*)b;
+    return pa < pb ? -1 : pa > pb;
+}
+
+// nearest-rank percentile (p in [0, 100]) of the retained pauses;
+// full < 0 considers every collection, otherwise only records whose
+// full_sweep flag matches. Returns 0 when no record matches.
+JL_DLLEXPORT uint64_t jl_gc_pause_percentile(double p, int full)
+{
+    uint64_t pauses[GC_PAUSE_RING_LEN];
+    uint64_t n = gc_pause_ring_n;
+    uint64_t retained = n < GC_PAUSE_RING_LEN ? n : GC_PAUSE_RING_LEN;
+    size_t nsel = 0;
+    for (uint64_t i = 0; i < retained; i++) {
+        jl_gc_pause_record_t *rec = &gc_pause_ring[(n - retained + i) % GC_PAUSE_RING_LEN];
+        if (full < 0 || rec->full_sweep == (full != 0))
+            pauses[nsel++] = rec->pause;
+    }
+    if (nsel == 0)
+        return 0;
+    qsort(pauses, nsel, sizeof(uint64_t), gc_pause_cmp);
+    if (p <= 0)
+        return pauses[0];
+    if (p >= 100)
+        return pauses[nsel - 1];
+    double x = p / 100.0 * nsel;
+    size_t rank = (size_t)x;
+    if ((double)rank < x)
+        rank++;
+    return pauses[rank - 1];
+}
+
 pagetable_t memory_map;
 
 // List of marked big objects.  Not per-thread.  Accessed only by master thread.
-bigval_t *big_objects_marked = NULL;
+bigval_t *big_objects_marked[JL_GC_N_BIG_SHARDS] = {NULL};
 
 // finalization
 // `ptls->finalizers` and `finalizer_list_marked` might have tagged pointers.
@@ -193,12 +279,13 @@ static void jl_gc_wait_for_the_world(void)
         jl_wake_libuv();
     for (int i = 0;i < jl_n_threads;i++) {
         jl_ptls_t ptls2 = jl_all_tls_states[i];
-        // FIXME: The acquire load pairs with the release stores
+        // The acquire load pairs with the release stores
         // in the signal handler of safepoint so we are sure that
-        // all the stores on those threads are visible. However,
-        // we're currently not using atomic stores in mutator threads.
-        // We should either use atomic store release there too or use signals
-        // to flush the memory operations on those threads.
+        // all the stores on those threads are visible.
+        // Mutator threads only use plain stores for their `gc_state`
+        // transitions; those (and all heap stores preceding them) were
+        // made visible by the process-wide barrier that
+        // `jl_safepoint_start_gc` issued before we got here.
         while (!ptls2->gc_state || !jl_atomic_load_acquire(&ptls2->gc_state)) {
             jl_cpu_pause(); // yield?
         }
@@ -215,10 +302,28 @@ static inline void jl_gc_wait_for_the_world(void)
 #define malloc_cache_align(sz) jl_malloc_aligned(sz, JL_CACHE_BYTE_ALIGNMENT)
 #define realloc_cache_align(p, sz, oldsz) jl_realloc_aligned(p, sz, oldsz, JL_CACHE_BYTE_ALIGNMENT)
 
+// Batched asynchronous finalization (enabled via `JULIA_ASYNC_FINALIZERS`).
+// Instead of running every queued finalizer on the collecting thread right
+// after the collection, `to_finalize` is drained in bounded batches from
+// the scheduler's idle path (see `jl_task_get_next` in partr.c), which
+// behaves like a dedicated low-priority finalizer task. When the queue
+// grows past the backpressure limit the collecting thread falls back to
+// draining it synchronously so finalizers cannot pile up without bound.
+static int gc_async_finalizers = 0;
+#define GC_FINALIZER_BATCH 256 // object/finalizer pairs run per batch
+#define GC_FINALIZER_BACKPRESSURE (16 * GC_FINALIZER_BATCH)
+// Set (without the lock, see `schedule_finalization`) whenever
+// `to_finalize` may be non-empty so the scheduler can poll cheaply.
+JL_DLLEXPORT volatile int jl_gc_have_pending_finalizers = 0;
+#ifdef JULIA_ENABLE_THREADING
+JL_DLLEXPORT void jl_wakeup_thread(int16_t tid); // defined in partr.c
+#endif
+
 static void schedule_finalization(void *o, void *f) JL_NOTSAFEPOINT
 {
     arraylist_push(&to_finalize, o);
     arraylist_push(&to_finalize, f);
+    jl_gc_have_pending_finalizers = 1;
 }
 
 static void run_finalizer(jl_ptls_t ptls, jl_value_t *o, jl_value_t *ff)
@@ -315,11 +420,13 @@ static void jl_gc_run_finalizers_in_list(jl_ptls_t ptls, arraylist_t *list)
     jl_value_t **items = (jl_value_t**)list->items;
     size_t len = list->len;
     JL_UNLOCK_NOGC(&finalizers_lock);
+    uint64_t t0 = jl_hrtime();
     // run finalizers in reverse order they were added, so lower-level finalizers run last
     for (size_t i = len-4; i >= 2; i -= 2)
         run_finalizer(ptls, items[i], items[i + 1]);
     // first entries were moved last to make room for GC frame metadata
     run_finalizer(ptls, items[len-2], items[len-1]);
+    gc_telemetry.finalizer_time += jl_hrtime() - t0;
     // matches the jl_gc_push_arraylist above
     JL_GC_POP();
 }
@@ -344,11 +451,52 @@ static void run_finalizers(jl_ptls_t ptls)
         copied_list.items = copied_list._space;
     }
     arraylist_new(&to_finalize, 0);
+    jl_gc_have_pending_finalizers = 0;
     // This releases the finalizers lock.
     jl_gc_run_finalizers_in_list(ptls, &copied_list);
     arraylist_free(&copied_list);
 }
 
+// Move up to `GC_FINALIZER_BATCH` pairs from the tail of `to_finalize`
+// into a private list and run them. Taking from the tail keeps the
+// reverse-addition-order semantics of `run_finalizers`.
+static void run_finalizers_batch(jl_ptls_t ptls)
+{
+    // Racy fast path, same reasoning as in `run_finalizers`.
+    if (to_finalize.len == 0)
+        return;
+    JL_LOCK_NOGC(&finalizers_lock);
+    size_t len = to_finalize.len;
+    if (len == 0) {
+        jl_gc_have_pending_finalizers = 0;
+        JL_UNLOCK_NOGC(&finalizers_lock);
+        return;
+    }
+    size_t n = len > 2 * GC_FINALIZER_BATCH ? 2 * GC_FINALIZER_BATCH : len;
+    arraylist_t copied_list;
+    arraylist_new(&copied_list, 0);
+    for (size_t i = len - n; i < len; i++)
+        arraylist_push(&copied_list, to_finalize.items[i]);
+    to_finalize.len = len - n;
+    jl_gc_have_pending_finalizers = to_finalize.len != 0;
+    // This releases the finalizers lock.
+    jl_gc_run_finalizers_in_list(ptls, &copied_list);
+    arraylist_free(&copied_list);
+}
+
+// Run one batch of the pending finalizers. Called from the scheduler when
+// a thread runs out of work so that the queue drains in the background
+// instead of stalling the thread that happened to trigger the collection.
+JL_DLLEXPORT void jl_gc_run_pending_finalizers(void)
+{
+    jl_ptls_t ptls = jl_get_ptls_states();
+    if (ptls->in_finalizer || ptls->finalizers_inhibited)
+        return;
+    ptls->in_finalizer = 1;
+    run_finalizers_batch(ptls);
+    ptls->in_finalizer = 0;
+}
+
 JL_DLLEXPORT void jl_gc_enable_finalizers(jl_ptls_t ptls, int on)
 {
     int old_val = ptls->finalizers_inhibited;
@@ -545,6 +693,141 @@ static int mark_reset_age = 0;
 // - sweep_page which is specialized for 1bit age
 // - the size of the age storage in jl_gc_pagemeta_t
 
+// Runtime-tunable promotion threshold (see `jl_gc_set_promote_age`).
+// Pool objects only have a 1 bit age so the effective choice for them is
+// between the default aging (1) and eager promotion on the first surviving
+// sweep (0); big objects have a 2 bit age and honor the range 0-3.
+static int gc_promote_age = PROMOTE_AGE;
+
+// Per size class tenuring statistics, updated during the pool sweep:
+// number of young objects that survived a sweep unpromoted resp. were
+// promoted to the old generation by it. Counting is not synchronized
+// (same as `gc_num.freed`); the values are for tuning, not accounting.
+static uint64_t gc_tenure_survived[JL_GC_N_POOLS];
+static uint64_t gc_tenure_promoted[JL_GC_N_POOLS];
+
+JL_DLLEXPORT void jl_gc_set_promote_age(int age)
+{
+    if (age < 0)
+        age = 0;
+    else if (age > 3)
+        age = 3;
+    gc_promote_age = age;
+}
+
+JL_DLLEXPORT int jl_gc_get_promote_age(void)
+{
+    return gc_promote_age;
+}
+
+JL_DLLEXPORT uint64_t jl_gc_pool_survived(int klass)
+{
+    return (unsigned)klass < JL_GC_N_POOLS ? gc_tenure_survived[klass] : 0;
+}
+
+JL_DLLEXPORT uint64_t jl_gc_pool_promoted(int klass)
+{
+    return (unsigned)klass < JL_GC_N_POOLS ? gc_tenure_promoted[klass] : 0;
+}
+
+JL_DLLEXPORT void jl_gc_reset_tenure_stats(void)
+{
+    memset(gc_tenure_survived, 0, sizeof(gc_tenure_survived));
+    memset(gc_tenure_promoted, 0, sizeof(gc_tenure_promoted));
+}
+
+// Per size class occupancy statistics, aggregated over all threads by
+// walking the allocated pages in the memory map.
+//
+// Note on dedicated pools for fixed-shape runtime objects (jl_task_t,
+// jl_typemap_entry_t, module bindings, ...): these are all traced GC
+// objects, so they cannot be recycled through a manual free list without
+// bypassing the collector. They already get slab allocation with free-list
+// recycling from the size class pools below — each per-thread jl_gc_pool_t
+// carves page-sized slabs into fixed-size cells and the sweep threads dead
+// cells back onto the pool's freelist — so a type-private pool would only
+// duplicate that machinery while splitting its locality. bigval_t headers
+// are not separable either: they are allocated contiguously with the
+// object they describe (see jl_gc_big_alloc). Per-pool occupancy is
+// observable through jl_gc_sizeclass_stats below.
+
+static void gc_sizeclass_stats_pagetable0(pagetable0_t *pagetable0, uint64_t *live,
+                                          uint64_t *nfree, uint64_t *npages)
+{
+    for (unsigned pg_i = 0; pg_i <= pagetable0->ub; pg_i++) {
+        uint32_t line = pagetable0->allocmap[pg_i];
+        unsigned j;
+        for (j = 0; line; j++, line >>= 1) {
+            unsigned next = ffs_u32(line);
+            j += next;
+            line >>= next;
+            jl_gc_pagemeta_t *pg = pagetable0->meta[pg_i * 32 + j];
+            int klass = pg->pool_n;
+            uint64_t nobjs = (GC_PAGE_SZ - GC_PAGE_OFFSET) / pg->osize;
+            npages[klass]++;
+            nfree[klass] += pg->nfree;
+            live[klass] += nobjs - pg->nfree;
+        }
+    }
+}
+
+static void gc_sizeclass_stats_pagetable1(pagetable1_t *pagetable1, uint64_t *live,
+                                          uint64_t *nfree, uint64_t *npages)
+{
+    for (unsigned pg_i = 0; pg_i <= pagetable1->ub; pg_i++) {
+        uint32_t line = pagetable1->allocmap0[pg_i];
+        unsigned j;
+        for (j = 0; line; j++, line >>= 1) {
+            unsigned next = ffs_u32(line);
+            j += next;
+            line >>= next;
+            pagetable0_t *pagetable0 = pagetable1->meta0[pg_i * 32 + j];
+            if (pagetable0)
+                gc_sizeclass_stats_pagetable0(pagetable0, live, nfree, npages);
+        }
+    }
+}
+
+JL_DLLEXPORT int jl_gc_sizeclass_count(void)
+{
+    return JL_GC_N_POOLS;
+}
+
+JL_DLLEXPORT int jl_gc_sizeclass_size(int klass)
+{
+    return (unsigned)klass < JL_GC_N_POOLS ? jl_gc_sizeclasses[klass] : 0;
+}
+
+// Fill `live`, `nfree` and `npages` (each `JL_GC_N_POOLS` entries, see
+// `jl_gc_sizeclass_count`) with the per size class object and page counts.
+// Free counts are as of the last sweep of each page; objects allocated
+// since then are still counted as free, so the numbers are approximate
+// unless a collection just ran.
+JL_DLLEXPORT void jl_gc_sizeclass_stats(uint64_t *live, uint64_t *nfree, uint64_t *npages)
+{
+    memset(live, 0, JL_GC_N_POOLS * sizeof(uint64_t));
+    memset(nfree, 0, JL_GC_N_POOLS * sizeof(uint64_t));
+    memset(npages, 0, JL_GC_N_POOLS * sizeof(uint64_t));
+    if (REGION2_PG_COUNT == 1) { // compile-time optimization
+        pagetable1_t *pagetable1 = memory_map.meta1[0];
+        if (pagetable1)
+            gc_sizeclass_stats_pagetable1(pagetable1, live, nfree, npages);
+        return;
+    }
+    for (unsigned pg_i = 0; pg_i <= memory_map.ub; pg_i++) {
+        uint32_t line = memory_map.allocmap1[pg_i];
+        unsigned j;
+        for (j = 0; line; j++, line >>= 1) {
+            unsigned next = ffs_u32(line);
+            j += next;
+            line >>= next;
+            pagetable1_t *pagetable1 = memory_map.meta1[pg_i * 32 + j];
+            if (pagetable1)
+                gc_sizeclass_stats_pagetable1(pagetable1, live, nfree, npages);
+        }
+    }
+}
+
 
 static int64_t scanned_bytes; // young bytes scanned while marking
 static int64_t perm_scanned_bytes; // old bytes scanned while marking
@@ -587,6 +870,43 @@ STATIC_INLINE void gc_update_heap_size(int64_t sz_ub, int64_t sz_est)
     last_full_live_est = sz_est;
 }
 
+// Deployment-level pacing knobs (see the setters below).
+// `gc_max_heap_size` keeps the next collection from being scheduled past
+// the heap target and forces a full sweep once the live set approaches it.
+// `gc_pause_budget_ns` suppresses heuristic (non-mandatory) full sweeps
+// while full collections have been costing more than the budget.
+// `gc_interval_growth` replaces the hard coded 2.5x interval growth factor.
+static uint64_t gc_max_heap_size = 0;
+static uint64_t gc_pause_budget_ns = 0;
+static uint64_t last_full_sweep_pause = 0;
+static double gc_interval_growth = 2.5;
+
+// Set a (soft) upper bound on the heap size in bytes. 0 removes the bound.
+JL_DLLEXPORT void jl_gc_set_max_heap_size(uint64_t bytes)
+{
+    gc_max_heap_size = bytes;
+}
+
+// Set a soft budget (in ns) for the collection pause. While full sweeps
+// exceed it the collector sticks to quick sweeps whenever correctness
+// allows. 0 (the default) removes the budget.
+JL_DLLEXPORT void jl_gc_set_pause_budget(uint64_t ns)
+{
+    gc_pause_budget_ns = ns;
+}
+
+// Set the factor by which the collection interval grows when a collection
+// didn't free enough. Larger values favor throughput (fewer collections),
+// smaller values keep the heap tighter. The default is 2.5.
+JL_DLLEXPORT void jl_gc_set_interval_growth(double factor)
+{
+    if (factor < 1.125)
+        factor = 1.125;
+    else if (factor > 10)
+        factor = 10;
+    gc_interval_growth = factor;
+}
+
 static void gc_sync_cache_nolock(jl_ptls_t ptls, jl_gc_mark_cache_t *gc_cache) JL_NOTSAFEPOINT
 {
     const int nbig = gc_cache->nbig_obj;
@@ -595,11 +915,11 @@ static void gc_sync_cache_nolock(jl_ptls_t ptls, jl_gc_mark_cache_t *gc_cache) J
         bigval_t *hdr = (bigval_t*)gc_ptr_clear_tag(ptr, 1);
         gc_big_object_unlink(hdr);
         if (gc_ptr_tag(ptr, 1)) {
-            gc_big_object_link(hdr, &ptls->heap.big_objects);
+            gc_big_object_link(hdr, &ptls->heap.big_objects[gc_bigval_shard(hdr)]);
         }
         else {
             // Move hdr from `big_objects` list to `big_objects_marked list`
-            gc_big_object_link(hdr, &big_objects_marked);
+            gc_big_object_link(hdr, &big_objects_marked[gc_bigval_shard(hdr)]);
         }
     }
     gc_cache->nbig_obj = 0;
@@ -802,11 +1122,43 @@ void jl_gc_force_mark_old(jl_ptls_t ptls, jl_value_t *v) JL_NOTSAFEPOINT
         jl_gc_queue_root(v);
 }
 
-#define should_collect() (__unlikely(gc_num.allocd>0))
+#define should_collect(ptls) (__unlikely((ptls)->gc_num.allocd > 0))
+
+// `gc_leaf` ccall validation (see emit_ccall): while a ccall annotated with
+// the `gc_leaf` pseudo calling convention is running, this thread has
+// promised to stay out of the allocator and the collector. Debug builds of
+// the generated code bracket such calls with these helpers so that a broken
+// annotation aborts loudly instead of corrupting the heap.
+static __thread int gc_leaf_region = 0;
+
+JL_DLLEXPORT void jl_gc_leaf_check_begin(void)
+{
+    gc_leaf_region = 1;
+}
+
+JL_DLLEXPORT void jl_gc_leaf_check_end(void)
+{
+    gc_leaf_region = 0;
+}
+
+#ifdef JL_DEBUG_BUILD
+static void gc_leaf_violation(const char *what)
+{
+    jl_safe_printf("fatal error: %s inside a ccall declared `gc_leaf`\n", what);
+    abort();
+}
+#define gc_leaf_check(what) do {                                        \
+        if (__unlikely(gc_leaf_region))                                 \
+            gc_leaf_violation(what);                                    \
+    } while (0)
+#else
+#define gc_leaf_check(what)
+#endif
 
 static inline int maybe_collect(jl_ptls_t ptls)
 {
-    if (should_collect() || gc_debug_check_other()) {
+    gc_leaf_check("allocation");
+    if (should_collect(ptls) || gc_debug_check_other()) {
         jl_gc_collect(0);
         return 1;
     }
@@ -814,6 +1166,109 @@ static inline int maybe_collect(jl_ptls_t ptls)
     return 0;
 }
 
+// allocation-site sampling profiler
+
+// A cheap sampling profiler for the pool and big-object allocators: every
+// `alloc_prof_interval` allocated bytes (approximately) a backtrace of the
+// allocating thread is recorded. The data layout mirrors the CPU profiler in
+// signal-handling.c: a flat buffer of samples, each sample being the
+// allocation size followed by the backtrace and a NULL terminator. The
+// consumer attributes `alloc_prof_interval` bytes to each sampled site.
+// The byte countdown is deliberately not atomic; a racy decrement only
+// perturbs the sampling interval slightly and keeps the fast path to a
+// single test of `alloc_prof_running`.
+static intptr_t *alloc_prof_data = NULL;
+static volatile size_t alloc_prof_size_max = 0;
+static volatile size_t alloc_prof_size_cur = 0;
+static volatile int64_t alloc_prof_interval = 0;
+static volatile int64_t alloc_prof_countdown = 0;
+static volatile int alloc_prof_running = 0;
+static jl_mutex_t alloc_prof_lock;
+
+static NOINLINE void gc_alloc_profile_sample(size_t sz) JL_NOTSAFEPOINT
+{
+    int64_t rem = alloc_prof_countdown - (int64_t)sz;
+    if (__likely(rem > 0)) {
+        alloc_prof_countdown = rem;
+        return;
+    }
+    alloc_prof_countdown = alloc_prof_interval;
+    JL_LOCK_NOGC(&alloc_prof_lock);
+    size_t cur = alloc_prof_size_cur;
+    if (cur + 3 >= alloc_prof_size_max) {
+        // out of space; stop sampling instead of overflowing
+        alloc_prof_running = 0;
+        JL_UNLOCK_NOGC(&alloc_prof_lock);
+        return;
+    }
+    alloc_prof_data[cur++] = (intptr_t)sz;
+    cur += rec_backtrace((uintptr_t*)alloc_prof_data + cur,
+                         alloc_prof_size_max - cur - 1);
+    alloc_prof_data[cur++] = 0;
+    alloc_prof_size_cur = cur;
+    JL_UNLOCK_NOGC(&alloc_prof_lock);
+}
+
+STATIC_INLINE void gc_alloc_profile_record(size_t sz) JL_NOTSAFEPOINT
+{
+    if (__unlikely(alloc_prof_running))
+        gc_alloc_profile_sample(sz);
+}
+
+JL_DLLEXPORT int jl_alloc_profile_init(size_t maxsize, uint64_t sample_bytes)
+{
+    alloc_prof_running = 0;
+    alloc_prof_size_max = maxsize;
+    alloc_prof_interval = (int64_t)sample_bytes;
+    alloc_prof_countdown = (int64_t)sample_bytes;
+    if (alloc_prof_data != NULL)
+        free(alloc_prof_data);
+    alloc_prof_data = (intptr_t*)calloc(maxsize, sizeof(intptr_t));
+    if (alloc_prof_data == NULL && maxsize > 0)
+        return -1;
+    alloc_prof_size_cur = 0;
+    return 0;
+}
+
+JL_DLLEXPORT int jl_alloc_profile_start(void)
+{
+    if (alloc_prof_data == NULL || alloc_prof_interval <= 0)
+        return -1;
+    alloc_prof_countdown = alloc_prof_interval;
+    alloc_prof_running = 1;
+    return 0;
+}
+
+JL_DLLEXPORT void jl_alloc_profile_stop(void)
+{
+    alloc_prof_running = 0;
+}
+
+JL_DLLEXPORT int jl_alloc_profile_is_running(void)
+{
+    return alloc_prof_running;
+}
+
+JL_DLLEXPORT uint8_t *jl_alloc_profile_get_data(void)
+{
+    return (uint8_t*)alloc_prof_data;
+}
+
+JL_DLLEXPORT size_t jl_alloc_profile_len_data(void)
+{
+    return alloc_prof_size_cur;
+}
+
+JL_DLLEXPORT size_t jl_alloc_profile_maxlen_data(void)
+{
+    return alloc_prof_size_max;
+}
+
+JL_DLLEXPORT void jl_alloc_profile_clear_data(void)
+{
+    alloc_prof_size_cur = 0;
+}
+
 // weak references
 
 JL_DLLEXPORT jl_weakref_t *jl_gc_new_weakref_th(jl_ptls_t ptls,
@@ -876,24 +1331,50 @@ JL_DLLEXPORT jl_value_t *jl_gc_big_alloc(jl_ptls_t ptls, size_t sz)
         jl_throw(jl_memory_exception);
     gc_invoke_callbacks(jl_gc_cb_notify_external_alloc_t,
         gc_cblist_notify_external_alloc, (v, allocsz));
-#ifdef JULIA_ENABLE_THREADING
-    jl_atomic_fetch_add(&gc_num.allocd, allocsz);
-#else
-    gc_num.allocd += allocsz;
-#endif
-    gc_num.bigalloc++;
+    ptls->gc_num.allocd += allocsz;
+    ptls->gc_num.bigalloc++;
+    gc_alloc_profile_record(allocsz);
 #ifdef MEMDEBUG
     memset(v, 0xee, allocsz);
 #endif
     v->sz = allocsz;
     v->age = 0;
-    gc_big_object_link(v, &ptls->heap.big_objects);
+    gc_big_object_link(v, &ptls->heap.big_objects[gc_bigval_shard(v)]);
     return jl_valueof(&v->header);
 }
 
+// Per-shard survivor count/bytes recorded by the last big object sweep.
+// Only written by the thread that swept the shard.
+static uint64_t big_shard_len[JL_GC_N_BIG_SHARDS];
+static uint64_t big_shard_bytes[JL_GC_N_BIG_SHARDS];
+
+JL_DLLEXPORT uint64_t jl_gc_big_shard_len(int shard)
+{
+    return (unsigned)shard < JL_GC_N_BIG_SHARDS ? big_shard_len[shard] : 0;
+}
+
+JL_DLLEXPORT uint64_t jl_gc_big_shard_bytes(int shard)
+{
+    return (unsigned)shard < JL_GC_N_BIG_SHARDS ? big_shard_bytes[shard] : 0;
+}
+
+// Set when `JULIA_GC_PARALLEL_SWEEP` is enabled. The big object shards are
+// then claimed and swept by the threads spinning in `jl_safepoint_wait_gc`
+// (same scheme as the parallel marking above). Note that this runs the
+// external-free callbacks from those threads too.
+static int gc_parallel_sweeping = 0;
+static int gc_big_sweep_claimed = 0;
+static int gc_big_sweep_full = 0;
+static volatile int gc_big_sweep_available = 0;
+static volatile int gc_sweep_workers_busy = 0;
+
 // Sweep list rooted at *pv, removing and freeing any unmarked objects.
 // Return pointer to last `next` field in the culled list.
-static bigval_t **sweep_big_list(int sweep_full, bigval_t **pv) JL_NOTSAFEPOINT
+// Survivors are counted into `plen`/`pbytes` and the freed bytes into
+// `pfreed` (the caller flushes them into the global stats, the sweep may
+// run on several threads at once).
+static bigval_t **sweep_big_list(int sweep_full, bigval_t **pv, uint64_t *plen,
+                                 uint64_t *pbytes, int64_t *pfreed) JL_NOTSAFEPOINT
 {
     bigval_t *v = *pv;
     while (v != NULL) {
@@ -903,7 +1384,7 @@ static bigval_t **sweep_big_list(int sweep_full, bigval_t **pv) JL_NOTSAFEPOINT
         if (gc_marked(bits)) {
             pv = &v->next;
             int age = v->age;
-            if (age >= PROMOTE_AGE || bits == GC_OLD_MARKED) {
+            if (age >= gc_promote_age || bits == GC_OLD_MARKED) {
                 if (sweep_full || bits == GC_MARKED) {
                     bits = GC_OLD;
                 }
@@ -914,13 +1395,15 @@ static bigval_t **sweep_big_list(int sweep_full, bigval_t **pv) JL_NOTSAFEPOINT
                 bits = GC_CLEAN;
             }
             v->bits.gc = bits;
+            (*plen)++;
+            *pbytes += v->sz & ~3;
         }
         else {
             // Remove v from list and free it
             *pv = nxt;
             if (nxt)
                 nxt->prev = pv;
-            gc_num.freed += v->sz&~3;
+            *pfreed += v->sz&~3;
 #ifdef MEMDEBUG
             memset(v, 0xbb, v->sz&~3);
 #endif
@@ -934,21 +1417,80 @@ static bigval_t **sweep_big_list(int sweep_full, bigval_t **pv) JL_NOTSAFEPOINT
     return pv;
 }
 
-static void sweep_big(jl_ptls_t ptls, int sweep_full)
+// Sweep one big object shard: the matching list of every thread heap plus
+// (on a full sweep) the matching `big_objects_marked` list. All the lists
+// touched here belong to this shard only, so distinct shards can be swept
+// concurrently.
+static void gc_sweep_big_shard(int s, int sweep_full) JL_NOTSAFEPOINT
 {
-    gc_time_big_start();
+    uint64_t len = 0, bytes = 0;
+    int64_t freed = 0;
     for (int i = 0;i < jl_n_threads;i++)
-        sweep_big_list(sweep_full, &jl_all_tls_states[i]->heap.big_objects);
+        sweep_big_list(sweep_full, &jl_all_tls_states[i]->heap.big_objects[s],
+                       &len, &bytes, &freed);
     if (sweep_full) {
-        bigval_t **last_next = sweep_big_list(sweep_full, &big_objects_marked);
-        // Move all survivors from big_objects_marked list to big_objects list.
-        if (ptls->heap.big_objects)
-            ptls->heap.big_objects->prev = last_next;
-        *last_next = ptls->heap.big_objects;
-        ptls->heap.big_objects = big_objects_marked;
-        if (ptls->heap.big_objects)
-            ptls->heap.big_objects->prev = &ptls->heap.big_objects;
-        big_objects_marked = NULL;
+        bigval_t **last_next = sweep_big_list(sweep_full, &big_objects_marked[s],
+                                              &len, &bytes, &freed);
+        // Move all survivors from the big_objects_marked list to one of the
+        // big_objects lists of this shard (which we also own right now).
+        bigval_t **head = &jl_all_tls_states[s % jl_n_threads]->heap.big_objects[s];
+        if (*head)
+            (*head)->prev = last_next;
+        *last_next = *head;
+        *head = big_objects_marked[s];
+        if (*head)
+            (*head)->prev = head;
+        big_objects_marked[s] = NULL;
+    }
+    big_shard_len[s] = len;
+    big_shard_bytes[s] = bytes;
+#ifdef JULIA_ENABLE_THREADING
+    jl_atomic_fetch_add(&gc_num.freed, freed);
+#else
+    gc_num.freed += freed;
+#endif
+}
+
+static void gc_drain_big_shards(void) JL_NOTSAFEPOINT
+{
+    while (1) {
+        int s = jl_atomic_fetch_add(&gc_big_sweep_claimed, 1);
+        if (s >= JL_GC_N_BIG_SHARDS)
+            return;
+        gc_sweep_big_shard(s, gc_big_sweep_full);
+    }
+}
+
+// Called from `jl_safepoint_wait_gc` while waiting for the GC to finish so
+// that stopped threads can pick up big object shards once the collecting
+// thread publishes them. No-op unless parallel sweeping is active.
+void jl_gc_sweep_worker_from_safepoint(void)
+{
+    if (!jl_atomic_load_acquire(&gc_big_sweep_available))
+        return;
+    jl_atomic_fetch_add(&gc_sweep_workers_busy, 1);
+    if (jl_atomic_load_acquire(&gc_big_sweep_available))
+        gc_drain_big_shards();
+    jl_atomic_fetch_add(&gc_sweep_workers_busy, -1);
+}
+
+static void sweep_big(int sweep_full)
+{
+    gc_time_big_start();
+    if (gc_parallel_sweeping && jl_n_threads > 1) {
+        gc_big_sweep_claimed = 0;
+        gc_big_sweep_full = sweep_full;
+        jl_atomic_store_release(&gc_big_sweep_available, 1);
+        gc_drain_big_shards();
+        jl_atomic_store_release(&gc_big_sweep_available, 0);
+        // wait for the workers so that no shard is still being swept when
+        // the world restarts
+        while (jl_atomic_load_acquire(&gc_sweep_workers_busy))
+            jl_cpu_pause();
+    }
+    else {
+        for (int s = 0; s < JL_GC_N_BIG_SHARDS; s++)
+            gc_sweep_big_shard(s, sweep_full);
     }
     gc_time_big_end();
 }
@@ -971,16 +1513,22 @@ void jl_gc_track_malloced_array(jl_ptls_t ptls, jl_array_t *a) JL_NOTSAFEPOINT
     ptls->heap.mallocarrays = ma;
 }
 
+static void combine_thread_gc_counts(jl_gc_num_t *dest) JL_NOTSAFEPOINT;
+static void reset_thread_gc_counts(void) JL_NOTSAFEPOINT;
+
 void jl_gc_count_allocd(size_t sz) JL_NOTSAFEPOINT
 {
-    gc_num.allocd += sz;
+    jl_ptls_t ptls = jl_get_ptls_states();
+    ptls->gc_num.allocd += sz;
 }
 
 void jl_gc_reset_alloc_count(void) JL_NOTSAFEPOINT
 {
-    live_bytes += (gc_num.deferred_alloc + (gc_num.allocd + gc_num.interval));
-    gc_num.allocd = -(int64_t)gc_num.interval;
+    combine_thread_gc_counts(&gc_num);
+    live_bytes += (gc_num.deferred_alloc + gc_num.allocd);
+    gc_num.allocd = 0;
     gc_num.deferred_alloc = 0;
+    reset_thread_gc_counts();
 }
 
 static size_t array_nbytes(jl_array_t *a) JL_NOTSAFEPOINT
@@ -997,10 +1545,81 @@ static size_t array_nbytes(jl_array_t *a) JL_NOTSAFEPOINT
     return sz;
 }
 
+#ifdef _OS_LINUX_
+// Array buffers at least this large are mapped with mmap instead of
+// malloc so that growing them in `jl_gc_managed_realloc` can be done
+// with mremap (a page-table remap) instead of an allocate-and-copy.
+// Tunable in bytes via `JULIA_GC_MREMAP_THRESHOLD` (0 disables it).
+static size_t gc_mremap_threshold = 64 * 1024 * 1024;
+static jl_mutex_t gc_mmap_lock = {0, 0};
+static htable_t gc_mmap_sizes; // mmap'ed buffer -> mapped size
+static size_t gc_mmap_count = 0;
+
+static void *gc_managed_mmap(size_t allocsz)
+{
+    size_t mapsz = LLT_ALIGN(allocsz, jl_page_size);
+    void *b = mmap(NULL, mapsz, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (b == MAP_FAILED)
+        return NULL;
+    JL_LOCK_NOGC(&gc_mmap_lock);
+    ptrhash_put(&gc_mmap_sizes, b, (void*)mapsz);
+    gc_mmap_count++;
+    JL_UNLOCK_NOGC(&gc_mmap_lock);
+    return b;
+}
+
+// mapped size of `p` if it is an mmap'ed array buffer, 0 if malloc'd.
+// the racy unlocked count check is fine: only the owning thread can ask
+// about a buffer while it is live, and it inserted the entry itself.
+static size_t gc_mmapped_size(void *p) JL_NOTSAFEPOINT
+{
+    if (gc_mmap_count == 0)
+        return 0;
+    JL_LOCK_NOGC(&gc_mmap_lock);
+    void *v = ptrhash_get(&gc_mmap_sizes, p);
+    JL_UNLOCK_NOGC(&gc_mmap_lock);
+    return v == HT_NOTFOUND ? 0 : (size_t)v;
+}
+
+static void *gc_managed_mremap(void *d, size_t oldmapsz, size_t allocsz)
+{
+    size_t mapsz = LLT_ALIGN(allocsz, jl_page_size);
+    void *b = mremap(d, oldmapsz, mapsz, MREMAP_MAYMOVE);
+    if (b == MAP_FAILED)
+        return NULL;
+    JL_LOCK_NOGC(&gc_mmap_lock);
+    ptrhash_remove(&gc_mmap_sizes, d);
+    ptrhash_put(&gc_mmap_sizes, b, (void*)mapsz);
+    JL_UNLOCK_NOGC(&gc_mmap_lock);
+    return b;
+}
+
+// unmap `p` if it is an mmap'ed array buffer; returns 0 if it isn't
+static int gc_managed_munmap(void *p) JL_NOTSAFEPOINT
+{
+    size_t mapsz = gc_mmapped_size(p);
+    if (mapsz == 0)
+        return 0;
+    munmap(p, mapsz);
+    JL_LOCK_NOGC(&gc_mmap_lock);
+    ptrhash_remove(&gc_mmap_sizes, p);
+    gc_mmap_count--;
+    JL_UNLOCK_NOGC(&gc_mmap_lock);
+    return 1;
+}
+#endif
+
 static void jl_gc_free_array(jl_array_t *a) JL_NOTSAFEPOINT
 {
     if (a->flags.how == 2) {
         char *d = (char*)a->data - a->offset*a->elsize;
+#ifdef _OS_LINUX_
+        if (gc_managed_munmap(d)) {
+            gc_num.freed += array_nbytes(a);
+            return;
+        }
+#endif
         if (a->flags.isaligned)
             jl_free_aligned(d);
         else
@@ -1037,6 +1656,8 @@ static void sweep_malloced_arrays(void) JL_NOTSAFEPOINT
 }
 
 // pool allocation
+static NOINLINE jl_taggedvalue_t *gc_pool_lazy_sweep(jl_gc_pool_t *p);
+
 static inline jl_taggedvalue_t *reset_page(const jl_gc_pool_t *p, jl_gc_pagemeta_t *pg, jl_taggedvalue_t *fl)
 {
     assert(GC_PAGE_OFFSET >= sizeof(void*));
@@ -1092,24 +1713,26 @@ JL_DLLEXPORT jl_value_t *jl_gc_pool_alloc(jl_ptls_t ptls, int pool_offset,
     // to workaround a llvm bug.
     // Ref https://llvm.org/bugs/show_bug.cgi?id=27190
     jl_gc_pool_t *p = (jl_gc_pool_t*)((char*)ptls + pool_offset);
+    gc_leaf_check("allocation");
 #ifdef JULIA_ENABLE_THREADING
     assert(ptls->gc_state == 0);
 #endif
 #ifdef MEMDEBUG
     return jl_gc_big_alloc(ptls, osize);
 #endif
-    // FIXME - need JL_ATOMIC_FETCH_AND_ADD here
-    if (__unlikely((gc_num.allocd += osize) >= 0) || gc_debug_check_pool()) {
-        //gc_num.allocd -= osize;
+    if (__unlikely((ptls->gc_num.allocd += osize) >= 0) || gc_debug_check_pool()) {
         jl_gc_collect(0);
-        //gc_num.allocd += osize;
     }
     else {
         jl_gc_safepoint_(ptls);
     }
-    gc_num.poolalloc++;
-    // first try to use the freelist
+    ptls->gc_num.poolalloc++;
+    gc_alloc_profile_record(osize);
+    // first try to use the freelist, sweeping a deferred page to refill it
+    // if necessary (no-op unless the lazy sweep mode is enabled)
     jl_taggedvalue_t *v = p->freelist;
+    if (__unlikely(!v && p->unswept != NULL))
+        v = p->freelist = gc_pool_lazy_sweep(p);
     if (v) {
         jl_taggedvalue_t *next = v->next;
         p->freelist = next;
@@ -1162,6 +1785,21 @@ int jl_gc_classify_pools(size_t sz, int *osize)
 
 int64_t lazy_freed_pages = 0;
 
+// Lazy sweep mode (enabled via `JULIA_GC_LAZY_SWEEP`): pages with live
+// objects are not scanned during the stop-the-world window. Instead they are
+// pushed on the owning pool's `unswept` list and swept on demand from
+// `jl_gc_pool_alloc` when the pool runs out of free cells. Until a page is
+// swept it is unreachable from the allocator, so the owning thread can sweep
+// it without synchronization. Any page still unswept when the next collection
+// starts is swept then (`gc_lazy_sweep_flush`) since its mark bits are still
+// set from the previous mark phase.
+static int gc_lazy_sweep_enabled = 0;
+// Set while `gc_sweep_pool` runs with the lazy mode active so that
+// `sweep_page` defers the scan of live pages instead of performing it.
+static int gc_lazy_sweep_deferring = 0;
+// Whether the sweep that deferred the currently pending pages was full.
+static int gc_lazy_sweep_full = 0;
+
 // Returns pointer to terminal pointer of list rooted at *pfl.
 static jl_taggedvalue_t **sweep_page(jl_gc_pool_t *p, jl_gc_pagemeta_t *pg, jl_taggedvalue_t **pfl, int sweep_full, int osize) JL_NOTSAFEPOINT
 {
@@ -1209,12 +1847,24 @@ static jl_taggedvalue_t **sweep_page(jl_gc_pool_t *p, jl_gc_pagemeta_t *pg, jl_t
         }
     }
 
+    // Lazy sweep mode: defer the object scan of live pages to allocation
+    // time. Freed bytes are accounted when the page is actually swept.
+    if (gc_lazy_sweep_deferring) {
+        pg->next_unswept = p->unswept;
+        p->unswept = pg;
+        nfree = old_nfree;
+        freedall = 0;
+        goto done;
+    }
+
     pg_skpd = 0;
     {  // scope to avoid clang goto errors
         int has_marked = 0;
         int has_young = 0;
         int16_t prev_nold = 0;
         int pg_nfree = 0;
+        int n_survived = 0;
+        int n_promoted = 0;
         jl_taggedvalue_t **pfl_begin = NULL;
         uint8_t msk = 1; // mask for the age bit in the current age byte
         while ((char*)v <= lim) {
@@ -1227,10 +1877,11 @@ static jl_taggedvalue_t **sweep_page(jl_gc_pool_t *p, jl_gc_pagemeta_t *pg, jl_t
                 *ages &= ~msk;
             }
             else { // marked young or old
-                if (*ages & msk || bits == GC_OLD_MARKED) { // old enough
+                if (*ages & msk || bits == GC_OLD_MARKED || !gc_promote_age) { // old enough
                     // `!age && bits == GC_OLD_MARKED` is possible for
                     // non-first-class objects like `jl_binding_t`
                     if (sweep_full || bits == GC_MARKED) {
+                        n_promoted += bits == GC_MARKED;
                         bits = v->bits.gc = GC_OLD; // promote
                     }
                     prev_nold++;
@@ -1239,6 +1890,7 @@ static jl_taggedvalue_t **sweep_page(jl_gc_pool_t *p, jl_gc_pagemeta_t *pg, jl_t
                     assert(bits == GC_MARKED);
                     bits = v->bits.gc = GC_CLEAN; // unmark
                     has_young = 1;
+                    n_survived++;
                 }
                 has_marked |= gc_marked(bits);
                 *ages |= msk;
@@ -1265,6 +1917,8 @@ static jl_taggedvalue_t **sweep_page(jl_gc_pool_t *p, jl_gc_pagemeta_t *pg, jl_t
         }
 
         pg->nfree = pg_nfree;
+        gc_tenure_survived[pg->pool_n] += n_survived;
+        gc_tenure_promoted[pg->pool_n] += n_promoted;
         if (sweep_full) {
             pg->nold = 0;
             pg->prev_nold = prev_nold;
@@ -1274,10 +1928,52 @@ static jl_taggedvalue_t **sweep_page(jl_gc_pool_t *p, jl_gc_pagemeta_t *pg, jl_t
 
 done:
     gc_time_count_page(freedall, pg_skpd);
+    gc_telemetry.pages_swept++;
+    gc_telemetry.pages_freed += freedall;
     gc_num.freed += (nfree - old_nfree) * osize;
     return pfl;
 }
 
+// Sweep deferred pages of `p` until one of them yields free cells.
+// Returns the head of the new freelist, which is terminated by the previous
+// value of `p->freelist`, or NULL if every remaining deferred page is fully
+// live. This runs on the thread owning the pool (outside the pause) or on
+// the collecting thread during `gc_lazy_sweep_flush`, never concurrently.
+static NOINLINE jl_taggedvalue_t *gc_pool_lazy_sweep(jl_gc_pool_t *p)
+{
+    while (p->unswept) {
+        jl_gc_pagemeta_t *pg = p->unswept;
+        p->unswept = pg->next_unswept;
+        pg->next_unswept = NULL;
+        jl_taggedvalue_t *fl = NULL;
+        jl_taggedvalue_t **pfl = sweep_page(p, pg, &fl, gc_lazy_sweep_full, p->osize);
+        *pfl = p->freelist;
+        if (fl != NULL)
+            return fl;
+    }
+    return NULL;
+}
+
+// Sweep all the pages deferred by the previous collection. This must run
+// before a new mark phase starts since the mark bits of deferred pages are
+// still set from the previous one.
+static void gc_lazy_sweep_flush(void)
+{
+    if (!gc_lazy_sweep_enabled)
+        return;
+    for (int t_i = 0; t_i < jl_n_threads; t_i++) {
+        jl_ptls_t ptls2 = jl_all_tls_states[t_i];
+        for (int i = 0; i < JL_GC_N_POOLS; i++) {
+            jl_gc_pool_t *p = &ptls2->heap.norm_pools[i];
+            while (p->unswept) {
+                jl_taggedvalue_t *fl = gc_pool_lazy_sweep(p);
+                if (fl)
+                    p->freelist = fl;
+            }
+        }
+    }
+}
+
 // the actual sweeping over all allocated pages in a memory pool
 static inline void sweep_pool_page(jl_taggedvalue_t ***pfl, jl_gc_pagemeta_t *pg, int sweep_full) JL_NOTSAFEPOINT
 {
@@ -1369,7 +2065,8 @@ static void sweep_pool_pagetable(jl_taggedvalue_t ***pfl, int sweep_full) JL_NOT
 static void gc_sweep_other(jl_ptls_t ptls, int sweep_full) JL_NOTSAFEPOINT
 {
     sweep_malloced_arrays();
-    sweep_big(ptls, sweep_full);
+    (void)ptls;
+    sweep_big(sweep_full);
 }
 
 static void gc_pool_sync_nfree(jl_gc_pagemeta_t *pg, jl_taggedvalue_t *last) JL_NOTSAFEPOINT
@@ -1393,6 +2090,10 @@ static void gc_sweep_pool(int sweep_full)
 {
     gc_time_pool_start();
     lazy_freed_pages = 0;
+    // Conservative marking needs the age bits of every page to be up to date
+    // when the mutators resume, so the lazy mode cannot be used with it.
+    gc_lazy_sweep_deferring = gc_lazy_sweep_enabled && !support_conservative_marking;
+    gc_lazy_sweep_full = sweep_full;
 
     // For the benfit of the analyzer, which doesn't know that jl_n_threads
     // doesn't change over the course of this function
@@ -1431,6 +2132,7 @@ static void gc_sweep_pool(int sweep_full)
 
     // the actual sweeping
     sweep_pool_pagetable(pfl, sweep_full);
+    gc_lazy_sweep_deferring = 0;
 
     // null out terminal pointers of free lists
     for (int t_i = 0; t_i < n_threads; t_i++) {
@@ -1451,6 +2153,15 @@ static void gc_sweep_perm_alloc(void)
 
 // mark phase
 
+// Card marking mode (enabled via `JULIA_GC_CARD_MARKING`): instead of
+// pushing each written-to old object onto the per-thread remset, the write
+// barrier only sets a dirty bit on the object's page. Repeated stores into
+// a large old object then cost a page table walk and a byte store, with no
+// duplicated remset entries, and the collector picks the objects back up
+// by scanning the dirty pages (`gc_queue_dirty_pages`) at the start of the
+// mark phase. Big (non-pool) objects keep using the remset.
+static int gc_card_marking = 0;
+
 JL_DLLEXPORT void jl_gc_queue_root(jl_value_t *ptr)
 {
     jl_ptls_t ptls = jl_get_ptls_states();
@@ -1466,6 +2177,15 @@ JL_DLLEXPORT void jl_gc_queue_root(jl_value_t *ptr)
     // write GC_OLD to the GC bits outside GC. This could cause
     // duplicated objects in the remset but that shouldn't be a problem.
     o->bits.gc = GC_MARKED;
+    if (gc_card_marking) {
+        jl_gc_pagemeta_t *pg = page_metadata(o);
+        if (pg) {
+            // racy but idempotent, same reasoning as for the bits above
+            pg->has_dirty = 1;
+            return;
+        }
+        // not a pool object, fall back to the remset
+    }
     arraylist_push(ptls->heap.remset, ptr);
     ptls->heap.remset_nptr++; // conservative
 }
@@ -1675,6 +2395,21 @@ STATIC_INLINE void gc_mark_push_remset(jl_ptls_t ptls, jl_value_t *obj, uintptr_
     }
 }
 
+// Prefetch distance (in reference slots) used by the mark loop scanners.
+// Scanning is dominated by dependent cache misses on the child object
+// headers; fetching the header a few slots ahead of the cursor overlaps
+// most of that latency with the `gc_try_setmark` of the current child.
+#define GC_MARK_PREFETCH_DIST 4
+STATIC_INLINE void gc_mark_prefetch_obj(jl_value_t *obj) JL_NOTSAFEPOINT
+{
+#ifdef __GNUC__
+    // prefetch never faults so `obj` may be `NULL` or garbage
+    __builtin_prefetch(jl_astaggedvalue(obj));
+#else
+    (void)obj;
+#endif
+}
+
 // Scan a dense array of object references, see `gc_mark_objarray_t`
 STATIC_INLINE int gc_mark_scan_objarray(jl_ptls_t ptls, jl_gc_mark_sp_t *sp,
                                         gc_mark_objarray_t *objary,
@@ -1683,6 +2418,8 @@ STATIC_INLINE int gc_mark_scan_objarray(jl_ptls_t ptls, jl_gc_mark_sp_t *sp,
 {
     (void)jl_assume(objary == (gc_mark_objarray_t*)sp->data);
     for (; begin < end; begin++) {
+        if (begin + GC_MARK_PREFETCH_DIST < end)
+            gc_mark_prefetch_obj(begin[GC_MARK_PREFETCH_DIST]);
         *pnew_obj = *begin;
         if (*pnew_obj)
             verify_parent2("obj array", objary->parent, begin, "elem(%d)",
@@ -1717,6 +2454,8 @@ STATIC_INLINE int gc_mark_scan_obj8(jl_ptls_t ptls, jl_gc_mark_sp_t *sp, gc_mark
     for (; begin < end; begin++) {
         if (!begin->isptr)
             continue;
+        if (begin + GC_MARK_PREFETCH_DIST < end && begin[GC_MARK_PREFETCH_DIST].isptr)
+            gc_mark_prefetch_obj(*(jl_value_t**)(parent + begin[GC_MARK_PREFETCH_DIST].offset));
         jl_value_t **slot = (jl_value_t**)(parent + begin->offset);
         *pnew_obj = *slot;
         if (*pnew_obj)
@@ -1752,6 +2491,8 @@ STATIC_INLINE int gc_mark_scan_obj16(jl_ptls_t ptls, jl_gc_mark_sp_t *sp, gc_mar
     for (; begin < end; begin++) {
         if (!begin->isptr)
             continue;
+        if (begin + GC_MARK_PREFETCH_DIST < end && begin[GC_MARK_PREFETCH_DIST].isptr)
+            gc_mark_prefetch_obj(*(jl_value_t**)(parent + begin[GC_MARK_PREFETCH_DIST].offset));
         jl_value_t **slot = (jl_value_t**)(parent + begin->offset);
         *pnew_obj = *slot;
         if (*pnew_obj)
@@ -1787,6 +2528,8 @@ STATIC_INLINE int gc_mark_scan_obj32(jl_ptls_t ptls, jl_gc_mark_sp_t *sp, gc_mar
     for (; begin < end; begin++) {
         if (!begin->isptr)
             continue;
+        if (begin + GC_MARK_PREFETCH_DIST < end && begin[GC_MARK_PREFETCH_DIST].isptr)
+            gc_mark_prefetch_obj(*(jl_value_t**)(parent + begin[GC_MARK_PREFETCH_DIST].offset));
         jl_value_t **slot = (jl_value_t**)(parent + begin->offset);
         *pnew_obj = *slot;
         if (*pnew_obj)
@@ -1952,6 +2695,11 @@ pop:
         return;
     }
     sp.pc--;
+#ifdef __GNUC__
+    // warm up the data of the mark-stack entry below the one we are about
+    // to handle (the data stack grows up, entries sit right below `sp.data`)
+    __builtin_prefetch((char*)sp.data - 64);
+#endif
     gc_mark_jmp(*sp.pc); // computed goto
 
 marked_obj: {
@@ -2322,6 +3070,12 @@ mark: {
             jl_module_t *m = (jl_module_t*)new_obj;
             jl_binding_t **table = (jl_binding_t**)m->bindings.table;
             size_t bsize = m->bindings.size;
+            if (table == NULL) {
+                // binding table still deferred from the sysimage (staticdata.c);
+                // the bindings live in image memory and anything stored into
+                // them since load is tracked by the binding remset
+                bsize = 0;
+            }
             uintptr_t nptr = ((bsize + m->usings.len + 1) << 2) | (bits & GC_OLD);
             gc_mark_binding_t markdata = {m, table + 1, table + bsize, nptr, bits};
             gc_mark_stack_push(&ptls->gc_cache, &sp, gc_mark_laddr(module_binding),
@@ -2477,8 +3231,89 @@ mark: {
     }
 }
 
+// parallel marking
+
+// When enabled (via `JULIA_GC_PARALLEL_MARKING`), the bulk of the root set
+// (remsets, thread local roots and backtrace buffers) is collected into a
+// shared root queue instead of the collecting thread's mark stack. All the
+// threads spinning in `jl_safepoint_wait_gc` then claim chunks of that queue
+// and trace them through their own `gc_cache` mark stacks concurrently with
+// the collecting thread. The marking itself is already safe to run on
+// multiple threads (`gc_setmark_tag` is atomic and per-thread metadata
+// updates go through `gc_cache`) so no additional synchronization is needed
+// apart from the chunk claiming and the termination detection.
+static int gc_parallel_marking = 0;
+// Shared root queue. The lowest pointer bit marks a remset entry that only
+// needs to be re-scanned (see `gc_mark_queue_scan_obj`).
+static arraylist_t gc_mark_shared_roots;
+// Claim index into `gc_mark_shared_roots`. Chunks are claimed with a
+// fetch-add so a root is only ever traced from one mark stack.
+static volatile size_t gc_shared_roots_claimed = 0;
+// Number of helper threads currently draining the shared queue.
+static volatile uint32_t gc_mark_workers_busy = 0;
+// Set (with release semantics) while the parallel mark phase is running.
+// This is the only flag the spinning threads read without holding any lock.
+static volatile uint32_t gc_mark_work_available = 0;
+// Number of roots a thread claims at a time. Larger chunks lower the
+// claiming overhead, smaller chunks balance the load better.
+#define GC_MARK_ROOT_CHUNK 32
+
+STATIC_INLINE void gc_queue_shared_root(jl_value_t *obj, int scan_only) JL_NOTSAFEPOINT
+{
+    arraylist_push(&gc_mark_shared_roots, (void*)(((uintptr_t)obj) | (scan_only ? 1 : 0)));
+}
+
+// Claim chunks of the shared root queue and trace them to completion through
+// this thread's own mark stack. Returns when the queue is exhausted.
+static void gc_drain_shared_roots(jl_ptls_t ptls)
+{
+    jl_gc_mark_cache_t *gc_cache = &ptls->gc_cache;
+    size_t len = gc_mark_shared_roots.len;
+    void **items = gc_mark_shared_roots.items;
+    while (1) {
+        size_t start = jl_atomic_fetch_add(&gc_shared_roots_claimed,
+                                           (size_t)GC_MARK_ROOT_CHUNK);
+        if (start >= len)
+            return;
+        size_t end = start + GC_MARK_ROOT_CHUNK;
+        if (end > len)
+            end = len;
+        jl_gc_mark_sp_t sp;
+        gc_mark_sp_init(gc_cache, &sp);
+        for (size_t i = start; i < end; i++) {
+            void *v = items[i];
+            jl_value_t *obj = (jl_value_t*)gc_ptr_clear_tag(v, 1);
+            if (gc_ptr_tag(v, 1))
+                gc_mark_queue_scan_obj(gc_cache, &sp, obj);
+            else
+                gc_mark_queue_obj(gc_cache, &sp, obj);
+        }
+        gc_mark_loop(ptls, sp);
+    }
+}
+
+// Entry point for the threads spinning in `jl_safepoint_wait_gc`.
+// The check of the flag here is racy but safe: a thread that misses the flag
+// simply doesn't help with this collection and the collecting thread always
+// drains the queue itself.
+void jl_gc_mark_worker_from_safepoint(void)
+{
+    if (!jl_atomic_load_acquire(&gc_mark_work_available))
+        return;
+    jl_ptls_t ptls = jl_get_ptls_states();
+    jl_atomic_fetch_add(&gc_mark_workers_busy, 1);
+    // Re-check after publishing ourselves as busy so that the collecting
+    // thread cannot observe `!busy` while we are about to start tracing.
+    if (jl_atomic_load_acquire(&gc_mark_work_available))
+        gc_drain_shared_roots(ptls);
+    jl_atomic_fetch_add(&gc_mark_workers_busy, -1);
+}
+
 extern jl_typemap_entry_t *call_cache[N_CALL_CACHE];
+extern jl_callsite_cache_t *callsite_caches;
+extern jl_array_t *jl_invalidation_log;
 extern jl_array_t *jl_all_methods;
+extern jl_array_t *jl_lowering_cache_values;
 
 static void jl_gc_queue_thread_local(jl_gc_mark_cache_t *gc_cache, jl_gc_mark_sp_t *sp,
                                      jl_ptls_t ptls2)
@@ -2487,6 +3322,78 @@ static void jl_gc_queue_thread_local(jl_gc_mark_cache_t *gc_cache, jl_gc_mark_sp
     gc_mark_queue_obj(gc_cache, sp, ptls2->root_task);
     if (ptls2->previous_exception)
         gc_mark_queue_obj(gc_cache, sp, ptls2->previous_exception);
+    for (size_t i = 0; i < N_CALL_CACHE_TLS; i++)
+        if (ptls2->call_cache[i])
+            gc_mark_queue_obj(gc_cache, sp, ptls2->call_cache[i]);
+    for (size_t i = 0; i < N_SUBTYPE_CACHE; i++) {
+        if (ptls2->subtype_cache[i].x) {
+            gc_mark_queue_obj(gc_cache, sp, ptls2->subtype_cache[i].x);
+            gc_mark_queue_obj(gc_cache, sp, ptls2->subtype_cache[i].y);
+        }
+    }
+    for (size_t i = 0; i < N_INTERSECT_CACHE; i++) {
+        if (ptls2->intersect_cache[i].a) {
+            gc_mark_queue_obj(gc_cache, sp, ptls2->intersect_cache[i].a);
+            gc_mark_queue_obj(gc_cache, sp, ptls2->intersect_cache[i].b);
+            gc_mark_queue_obj(gc_cache, sp, ptls2->intersect_cache[i].result);
+        }
+    }
+    for (size_t i = 0; i < N_TUPLE_CACHE; i++) {
+        size_t np = ptls2->tuple_type_cache[i].np;
+        if (np) {
+            for (size_t j = 0; j < np; j++)
+                gc_mark_queue_obj(gc_cache, sp, ptls2->tuple_type_cache[i].key[j]);
+            gc_mark_queue_obj(gc_cache, sp, ptls2->tuple_type_cache[i].result);
+        }
+    }
+    for (size_t i = 0; i < N_BOX_CACHE; i++) {
+        if (ptls2->int64_box_cache[i])
+            gc_mark_queue_obj(gc_cache, sp, ptls2->int64_box_cache[i]);
+        if (ptls2->float64_box_cache[i])
+            gc_mark_queue_obj(gc_cache, sp, ptls2->float64_box_cache[i]);
+    }
+    if (ptls2->deferred_enqueue_task)
+        gc_mark_queue_obj(gc_cache, sp, ptls2->deferred_enqueue_task);
+}
+
+static void jl_gc_queue_thread_local_parallel(jl_ptls_t ptls2)
+{
+    gc_queue_shared_root((jl_value_t*)ptls2->current_task, 0);
+    gc_queue_shared_root((jl_value_t*)ptls2->root_task, 0);
+    if (ptls2->previous_exception)
+        gc_queue_shared_root(ptls2->previous_exception, 0);
+    for (size_t i = 0; i < N_CALL_CACHE_TLS; i++)
+        if (ptls2->call_cache[i])
+            gc_queue_shared_root((jl_value_t*)ptls2->call_cache[i], 0);
+    for (size_t i = 0; i < N_SUBTYPE_CACHE; i++) {
+        if (ptls2->subtype_cache[i].x) {
+            gc_queue_shared_root((jl_value_t*)ptls2->subtype_cache[i].x, 0);
+            gc_queue_shared_root((jl_value_t*)ptls2->subtype_cache[i].y, 0);
+        }
+    }
+    for (size_t i = 0; i < N_INTERSECT_CACHE; i++) {
+        if (ptls2->intersect_cache[i].a) {
+            gc_queue_shared_root((jl_value_t*)ptls2->intersect_cache[i].a, 0);
+            gc_queue_shared_root((jl_value_t*)ptls2->intersect_cache[i].b, 0);
+            gc_queue_shared_root((jl_value_t*)ptls2->intersect_cache[i].result, 0);
+        }
+    }
+    for (size_t i = 0; i < N_TUPLE_CACHE; i++) {
+        size_t np = ptls2->tuple_type_cache[i].np;
+        if (np) {
+            for (size_t j = 0; j < np; j++)
+                gc_queue_shared_root((jl_value_t*)ptls2->tuple_type_cache[i].key[j], 0);
+            gc_queue_shared_root((jl_value_t*)ptls2->tuple_type_cache[i].result, 0);
+        }
+    }
+    for (size_t i = 0; i < N_BOX_CACHE; i++) {
+        if (ptls2->int64_box_cache[i])
+            gc_queue_shared_root((jl_value_t*)ptls2->int64_box_cache[i], 0);
+        if (ptls2->float64_box_cache[i])
+            gc_queue_shared_root((jl_value_t*)ptls2->float64_box_cache[i], 0);
+    }
+    if (ptls2->deferred_enqueue_task)
+        gc_queue_shared_root((jl_value_t*)ptls2->deferred_enqueue_task, 0);
 }
 
 void jl_gc_mark_enqueued_tasks(jl_gc_mark_cache_t *gc_cache, jl_gc_mark_sp_t *sp);
@@ -2512,12 +3419,30 @@ static void mark_roots(jl_gc_mark_cache_t *gc_cache, jl_gc_mark_sp_t *sp)
     }
     if (jl_cfunction_list != NULL)
         gc_mark_queue_obj(gc_cache, sp, jl_cfunction_list);
+    if (jl_cfunction_tramp_list != NULL)
+        gc_mark_queue_obj(gc_cache, sp, jl_cfunction_tramp_list);
     gc_mark_queue_obj(gc_cache, sp, jl_anytuple_type_type);
     for (size_t i = 0; i < N_CALL_CACHE; i++)
         if (call_cache[i])
             gc_mark_queue_obj(gc_cache, sp, call_cache[i]);
+    for (jl_callsite_cache_t *site = callsite_caches; site != NULL; site = site->next)
+        for (size_t i = 0; i < N_SITE_CACHE; i++)
+            if (site->entries[i])
+                gc_mark_queue_obj(gc_cache, sp, site->entries[i]);
     if (jl_all_methods != NULL)
         gc_mark_queue_obj(gc_cache, sp, jl_all_methods);
+    if (jl_invalidation_log != NULL)
+        gc_mark_queue_obj(gc_cache, sp, jl_invalidation_log);
+    if (jl_lowering_cache_values != NULL)
+        gc_mark_queue_obj(gc_cache, sp, jl_lowering_cache_values);
+    if (jl_string_intern_cache != NULL) {
+        for (size_t i = 0; i < JL_STRING_INTERN_CACHE_SZ; i++)
+            if (jl_string_intern_cache[i])
+                gc_mark_queue_obj(gc_cache, sp, jl_string_intern_cache[i]);
+    }
+    // code instances queued for tiered background compilation (see gf.c)
+    for (size_t i = 0; i < tiered_compile_queue.len; i++)
+        gc_mark_queue_obj(gc_cache, sp, tiered_compile_queue.items[i]);
 
     // constants
     gc_mark_queue_obj(gc_cache, sp, jl_typetype_type);
@@ -2572,6 +3497,38 @@ static void sweep_finalizer_list(arraylist_t *list)
 // collector entry point and control
 static volatile uint32_t jl_gc_disable_counter = 0;
 
+// Fold the per-thread allocation counters into `*dest`. Each thread's
+// `allocd` runs from `-gc_num.interval` up, so adding the interval back
+// yields the bytes it actually allocated. Exact when the world is stopped;
+// query paths call this on a racy snapshot and tolerate slightly stale
+// values, same as the old global counters.
+static void combine_thread_gc_counts(jl_gc_num_t *dest) JL_NOTSAFEPOINT
+{
+    for (int i = 0; i < jl_n_threads; i++) {
+        jl_ptls_t ptls2 = jl_all_tls_states[i];
+        if (ptls2 == NULL)
+            continue;
+        dest->allocd += (ptls2->gc_num.allocd + (int64_t)gc_num.interval);
+        dest->freed += ptls2->gc_num.freed;
+        dest->malloc += ptls2->gc_num.malloc;
+        dest->realloc += ptls2->gc_num.realloc;
+        dest->poolalloc += ptls2->gc_num.poolalloc;
+        dest->bigalloc += ptls2->gc_num.bigalloc;
+        dest->freecall += ptls2->gc_num.freecall;
+    }
+}
+
+static void reset_thread_gc_counts(void) JL_NOTSAFEPOINT
+{
+    for (int i = 0; i < jl_n_threads; i++) {
+        jl_ptls_t ptls2 = jl_all_tls_states[i];
+        if (ptls2 == NULL)
+            continue;
+        memset(&ptls2->gc_num, 0, sizeof(ptls2->gc_num));
+        ptls2->gc_num.allocd = -(int64_t)gc_num.interval;
+    }
+}
+
 JL_DLLEXPORT int jl_gc_enable(int on)
 {
     jl_ptls_t ptls = jl_get_ptls_states();
@@ -2600,9 +3557,10 @@ JL_DLLEXPORT int jl_gc_is_enabled(void)
 
 JL_DLLEXPORT int64_t jl_gc_total_bytes(void)
 {
+    jl_gc_num_t num = gc_num;
+    combine_thread_gc_counts(&num);
     // Sync this logic with `base/util.jl:GC_Diff`
-    return (gc_num.total_allocd + gc_num.deferred_alloc +
-            gc_num.allocd + gc_num.interval);
+    return (num.total_allocd + num.deferred_alloc + num.allocd);
 }
 JL_DLLEXPORT uint64_t jl_gc_total_hrtime(void)
 {
@@ -2610,7 +3568,9 @@ JL_DLLEXPORT uint64_t jl_gc_total_hrtime(void)
 }
 JL_DLLEXPORT jl_gc_num_t jl_gc_num(void)
 {
-    return gc_num;
+    jl_gc_num_t num = gc_num;
+    combine_thread_gc_counts(&num);
+    return num;
 }
 
 JL_DLLEXPORT int64_t jl_gc_diff_total_bytes(void)
@@ -2647,15 +3607,11 @@ static void jl_gc_premark(jl_ptls_t ptls2)
     }
 }
 
-static void jl_gc_queue_remset(jl_gc_mark_cache_t *gc_cache, jl_gc_mark_sp_t *sp, jl_ptls_t ptls2)
+static void jl_gc_queue_rem_bindings(jl_gc_mark_cache_t *gc_cache, jl_gc_mark_sp_t *sp, jl_ptls_t ptls2)
 {
-    size_t len = ptls2->heap.last_remset->len;
-    void **items = ptls2->heap.last_remset->items;
-    for (size_t i = 0; i < len; i++)
-        gc_mark_queue_scan_obj(gc_cache, sp, (jl_value_t*)items[i]);
     int n_bnd_refyoung = 0;
-    len = ptls2->heap.rem_bindings.len;
-    items = ptls2->heap.rem_bindings.items;
+    size_t len = ptls2->heap.rem_bindings.len;
+    void **items = ptls2->heap.rem_bindings.items;
     for (size_t i = 0; i < len; i++) {
         jl_binding_t *ptr = (jl_binding_t*)items[i];
         // A null pointer can happen here when the binding is cleaned up
@@ -2669,6 +3625,109 @@ static void jl_gc_queue_remset(jl_gc_mark_cache_t *gc_cache, jl_gc_mark_sp_t *sp
     ptls2->heap.rem_bindings.len = n_bnd_refyoung;
 }
 
+static void jl_gc_queue_remset(jl_gc_mark_cache_t *gc_cache, jl_gc_mark_sp_t *sp, jl_ptls_t ptls2)
+{
+    size_t len = ptls2->heap.last_remset->len;
+    void **items = ptls2->heap.last_remset->items;
+    for (size_t i = 0; i < len; i++)
+        gc_mark_queue_scan_obj(gc_cache, sp, (jl_value_t*)items[i]);
+    jl_gc_queue_rem_bindings(gc_cache, sp, ptls2);
+}
+
+// Parallel-marking variant of `jl_gc_queue_remset`: the remset objects are
+// accumulated in the shared root queue instead so that every stopped thread
+// can claim a share of them. The remembered bindings still go through the
+// collecting thread since their re-insertion filter needs the mark result.
+static void jl_gc_queue_remset_parallel(jl_ptls_t ptls2)
+{
+    size_t len = ptls2->heap.last_remset->len;
+    void **items = ptls2->heap.last_remset->items;
+    for (size_t i = 0; i < len; i++)
+        gc_queue_shared_root((jl_value_t*)items[i], 1);
+}
+
+// Scan one dirty page for objects that the write barrier flipped to
+// `GC_MARKED` and queue them the way `jl_gc_premark`/`jl_gc_queue_remset`
+// handle remset entries. Must run after `jl_gc_premark` restored the
+// remset entries to `GC_OLD_MARKED` so nothing is queued twice.
+static void gc_queue_dirty_page(jl_gc_mark_cache_t *gc_cache, jl_gc_mark_sp_t *sp,
+                                jl_gc_pagemeta_t *pg)
+{
+    pg->has_dirty = 0;
+    int osize = pg->osize;
+    char *data = pg->data;
+    char *lim = data + GC_PAGE_SZ - osize;
+    for (char *p = data + GC_PAGE_OFFSET; p <= lim; p += osize) {
+        jl_taggedvalue_t *v = (jl_taggedvalue_t*)p;
+        if (v->bits.gc == GC_MARKED) {
+            jl_value_t *item = jl_valueof(v);
+            objprofile_count(jl_typeof(item), 2, 0);
+            v->bits.gc = GC_OLD_MARKED;
+            gc_mark_queue_scan_obj(gc_cache, sp, item);
+        }
+    }
+}
+
+static void gc_queue_dirty_pagetable0(jl_gc_mark_cache_t *gc_cache, jl_gc_mark_sp_t *sp,
+                                      pagetable0_t *pagetable0)
+{
+    for (unsigned pg_i = 0; pg_i <= pagetable0->ub; pg_i++) {
+        uint32_t line = pagetable0->allocmap[pg_i];
+        unsigned j;
+        for (j = 0; line; j++, line >>= 1) {
+            unsigned next = ffs_u32(line);
+            j += next;
+            line >>= next;
+            jl_gc_pagemeta_t *pg = pagetable0->meta[pg_i * 32 + j];
+            if (pg->has_dirty)
+                gc_queue_dirty_page(gc_cache, sp, pg);
+        }
+    }
+}
+
+static void gc_queue_dirty_pagetable1(jl_gc_mark_cache_t *gc_cache, jl_gc_mark_sp_t *sp,
+                                      pagetable1_t *pagetable1)
+{
+    for (unsigned pg_i = 0; pg_i <= pagetable1->ub; pg_i++) {
+        uint32_t line = pagetable1->allocmap0[pg_i];
+        unsigned j;
+        for (j = 0; line; j++, line >>= 1) {
+            unsigned next = ffs_u32(line);
+            j += next;
+            line >>= next;
+            pagetable0_t *pagetable0 = pagetable1->meta0[pg_i * 32 + j];
+            if (pagetable0)
+                gc_queue_dirty_pagetable0(gc_cache, sp, pagetable0);
+        }
+    }
+}
+
+// Queue every object the write barrier recorded through a page dirty bit
+// instead of the remset. No-op unless card marking is enabled.
+static void gc_queue_dirty_pages(jl_gc_mark_cache_t *gc_cache, jl_gc_mark_sp_t *sp)
+{
+    if (!gc_card_marking)
+        return;
+    if (REGION2_PG_COUNT == 1) { // compile-time optimization
+        pagetable1_t *pagetable1 = memory_map.meta1[0];
+        if (pagetable1)
+            gc_queue_dirty_pagetable1(gc_cache, sp, pagetable1);
+        return;
+    }
+    for (unsigned pg_i = 0; pg_i <= memory_map.ub; pg_i++) {
+        uint32_t line = memory_map.allocmap1[pg_i];
+        unsigned j;
+        for (j = 0; line; j++, line >>= 1) {
+            unsigned next = ffs_u32(line);
+            j += next;
+            line >>= next;
+            pagetable1_t *pagetable1 = memory_map.meta1[pg_i * 32 + j];
+            if (pagetable1)
+                gc_queue_dirty_pagetable1(gc_cache, sp, pagetable1);
+        }
+    }
+}
+
 static void jl_gc_queue_bt_buf(jl_gc_mark_cache_t *gc_cache, jl_gc_mark_sp_t *sp, jl_ptls_t ptls2)
 {
     size_t n = 0;
@@ -2681,6 +3740,18 @@ static void jl_gc_queue_bt_buf(jl_gc_mark_cache_t *gc_cache, jl_gc_mark_sp_t *sp
     }
 }
 
+static void jl_gc_queue_bt_buf_parallel(jl_ptls_t ptls2)
+{
+    size_t n = 0;
+    while (n+2 < ptls2->bt_size) {
+        if (ptls2->bt_data[n] == JL_BT_INTERP_FRAME) {
+            gc_queue_shared_root((jl_value_t*)ptls2->bt_data[n+1], 0);
+            n += 2;
+        }
+        n++;
+    }
+}
+
 // Only one thread should be running in this function
 static int _jl_gc_collect(jl_ptls_t ptls, int full)
 {
@@ -2690,21 +3761,52 @@ static int _jl_gc_collect(jl_ptls_t ptls, int full)
 
     uint64_t t0 = jl_hrtime();
     int64_t last_perm_scanned_bytes = perm_scanned_bytes;
+    // the world is stopped: fold the per-thread allocation counters into the
+    // global aggregate (they are reset again at the end of the collection)
+    combine_thread_gc_counts(&gc_num);
+    // snapshot the cumulative phase counters so the pause record below can
+    // report this collection's share
+    uint64_t tel_mark0 = gc_telemetry.mark_time;
+    uint64_t tel_sweep0 = gc_telemetry.sweep_pool_time + gc_telemetry.sweep_big_time;
+    uint64_t tel_pages0 = gc_telemetry.pages_swept;
+
+    // 0. finish any sweeping deferred by the previous collection
+    gc_lazy_sweep_flush();
 
     // 1. fix GC bits of objects in the remset.
-    for (int t_i = 0; t_i < jl_n_threads; t_i++)
-        jl_gc_premark(jl_all_tls_states[t_i]);
+    gc_telemetry.remset_len = 0;
+    for (int t_i = 0; t_i < jl_n_threads; t_i++) {
+        jl_ptls_t ptls2 = jl_all_tls_states[t_i];
+        jl_gc_premark(ptls2);
+        gc_telemetry.remset_len += ptls2->heap.last_remset->len +
+            ptls2->heap.rem_bindings.len;
+    }
 
+    int parallel_mark = gc_parallel_marking && jl_n_threads > 1;
     for (int t_i = 0; t_i < jl_n_threads; t_i++) {
         jl_ptls_t ptls2 = jl_all_tls_states[t_i];
-        // 2.1. mark every object in the `last_remsets` and `rem_binding`
-        jl_gc_queue_remset(gc_cache, &sp, ptls2);
-        // 2.2. mark every thread local root
-        jl_gc_queue_thread_local(gc_cache, &sp, ptls2);
-        // 2.3. mark any managed objects in the backtrace buffer
-        jl_gc_queue_bt_buf(gc_cache, &sp, ptls2);
+        if (parallel_mark) {
+            // 2.1. - 2.3. same as below, but queue the bulk roots in the
+            // shared root queue to be drained by all stopped threads
+            jl_gc_queue_remset_parallel(ptls2);
+            jl_gc_queue_rem_bindings(gc_cache, &sp, ptls2);
+            jl_gc_queue_thread_local_parallel(ptls2);
+            jl_gc_queue_bt_buf_parallel(ptls2);
+        }
+        else {
+            // 2.1. mark every object in the `last_remsets` and `rem_binding`
+            jl_gc_queue_remset(gc_cache, &sp, ptls2);
+            // 2.2. mark every thread local root
+            jl_gc_queue_thread_local(gc_cache, &sp, ptls2);
+            // 2.3. mark any managed objects in the backtrace buffer
+            jl_gc_queue_bt_buf(gc_cache, &sp, ptls2);
+        }
     }
 
+    // 2.4. mark every object recorded through a page dirty bit
+    // (card marking mode, no-op otherwise)
+    gc_queue_dirty_pages(gc_cache, &sp);
+
     // 3. walk roots
     mark_roots(gc_cache, &sp);
     if (gc_cblist_root_scanner) {
@@ -2713,9 +3815,24 @@ static int _jl_gc_collect(jl_ptls_t ptls, int full)
             gc_cblist_root_scanner, (full));
         import_gc_state(ptls, &sp);
     }
-    gc_mark_loop(ptls, sp);
+    if (parallel_mark) {
+        gc_shared_roots_claimed = 0;
+        jl_atomic_store_release(&gc_mark_work_available, 1);
+        // trace the roots on our own mark stack first, then help with
+        // (and make sure we exhaust) the shared root queue
+        gc_mark_loop(ptls, sp);
+        gc_drain_shared_roots(ptls);
+        jl_atomic_store_release(&gc_mark_work_available, 0);
+        // wait for the helper threads to finish tracing their last chunks
+        while (jl_atomic_load_acquire(&gc_mark_workers_busy))
+            jl_cpu_pause();
+        gc_mark_shared_roots.len = 0;
+    }
+    else {
+        gc_mark_loop(ptls, sp);
+    }
     gc_mark_sp_init(gc_cache, &sp);
-    gc_num.since_sweep += gc_num.allocd + (int64_t)gc_num.interval;
+    gc_num.since_sweep += gc_num.allocd;
     gc_settime_premark_end();
     gc_time_mark_pause(t0, scanned_bytes, perm_scanned_bytes);
     int64_t actual_allocd = gc_num.since_sweep;
@@ -2754,6 +3871,7 @@ static int _jl_gc_collect(jl_ptls_t ptls, int full)
     gc_mark_loop(ptls, sp);
     mark_reset_age = 0;
     gc_settime_postmark_end();
+    gc_telemetry.mark_time += jl_hrtime() - t0;
 
     // Flush everything in mark cache
     gc_sync_all_caches_nolock(ptls);
@@ -2769,6 +3887,8 @@ static int _jl_gc_collect(jl_ptls_t ptls, int full)
     objprofile_printall();
     objprofile_reset();
     gc_num.total_allocd += gc_num.since_sweep;
+    if (perm_scanned_bytes > last_perm_scanned_bytes)
+        gc_telemetry.promoted_bytes += perm_scanned_bytes - last_perm_scanned_bytes;
     if (!prev_sweep_full)
         promoted_bytes += perm_scanned_bytes - last_perm_scanned_bytes;
     // 5. next collection decision
@@ -2777,12 +3897,20 @@ static int _jl_gc_collect(jl_ptls_t ptls, int full)
     for (int i = 0;i < jl_n_threads;i++)
         nptr += jl_all_tls_states[i]->heap.remset_nptr;
     int large_frontier = nptr*sizeof(void*) >= default_collect_interval; // many pointers in the intergen frontier => "quick" mark is not quick
+    gc_telemetry.remset_nptr = nptr;
+    // pacing API: approaching the max-heap target forces a full sweep while
+    // a blown pause budget suppresses the heuristic (optional) full sweeps
+    int near_heap_target = gc_max_heap_size &&
+        (uint64_t)live_sz_ub >= gc_max_heap_size - gc_max_heap_size / 4;
+    int over_pause_budget = gc_pause_budget_ns && !full &&
+        last_full_sweep_pause > gc_pause_budget_ns;
     int sweep_full;
     int recollect = 0;
-    if ((full || large_frontier ||
-         ((not_freed_enough || promoted_bytes >= gc_num.interval) &&
-          (promoted_bytes >= default_collect_interval || prev_sweep_full)) ||
-         gc_check_heap_size(live_sz_ub, live_sz_est)) &&
+    if ((full || large_frontier || near_heap_target ||
+         (!over_pause_budget &&
+          ((((not_freed_enough || promoted_bytes >= gc_num.interval) &&
+             (promoted_bytes >= default_collect_interval || prev_sweep_full)) ||
+            gc_check_heap_size(live_sz_ub, live_sz_est))))) &&
         gc_num.pause > 1) {
         gc_update_heap_size(live_sz_ub, live_sz_est);
         recollect = full;
@@ -2792,8 +3920,8 @@ static int _jl_gc_collect(jl_ptls_t ptls, int full)
             if (gc_num.interval < default_collect_interval) {
                 gc_num.interval = default_collect_interval;
             }
-            else if (gc_num.interval <= 2*(max_collect_interval/5)) {
-                gc_num.interval = 5 * (gc_num.interval / 2);
+            else if ((size_t)(gc_num.interval * gc_interval_growth) <= max_collect_interval) {
+                gc_num.interval = (size_t)(gc_num.interval * gc_interval_growth);
             }
         }
         last_long_collect_interval = gc_num.interval;
@@ -2811,12 +3939,18 @@ static int _jl_gc_collect(jl_ptls_t ptls, int full)
     sweep_weak_refs();
     sweep_stack_pools();
     gc_sweep_foreign_objs();
+    uint64_t t_sweep = jl_hrtime();
     gc_sweep_other(ptls, sweep_full);
+    uint64_t t_sweep_big_end = jl_hrtime();
+    gc_telemetry.sweep_big_time += t_sweep_big_end - t_sweep;
     gc_scrub();
     gc_verify_tags();
+    t_sweep = jl_hrtime();
     gc_sweep_pool(sweep_full);
+    gc_telemetry.sweep_pool_time += jl_hrtime() - t_sweep;
     if (sweep_full)
         gc_sweep_perm_alloc();
+    jl_gc_decay_free_pages();
     // sweeping is over
     // 6. if it is a quick sweep, put back the remembered objects in queued state
     // so that we don't trigger the barrier again on them.
@@ -2843,9 +3977,31 @@ static int _jl_gc_collect(jl_ptls_t ptls, int full)
     gc_time_sweep_pause(gc_end_t, actual_allocd, live_bytes,
                         estimate_freed, sweep_full);
     gc_num.full_sweep += sweep_full;
+    gc_telemetry.collections++;
+    gc_telemetry.full_sweeps += sweep_full;
+    gc_telemetry.total_pause += pause;
+    jl_gc_pause_record_t *rec = &gc_pause_ring[gc_pause_ring_n % GC_PAUSE_RING_LEN];
+    rec->pause = pause;
+    rec->mark_time = gc_telemetry.mark_time - tel_mark0;
+    rec->sweep_time = gc_telemetry.sweep_pool_time + gc_telemetry.sweep_big_time - tel_sweep0;
+    rec->freed = estimate_freed;
+    rec->pages_swept = gc_telemetry.pages_swept - tel_pages0;
+    rec->full_sweep = (uint8_t)sweep_full;
+    gc_pause_ring_n++;
+    if (sweep_full)
+        last_full_sweep_pause = pause;
     prev_sweep_full = sweep_full;
-    gc_num.allocd = -(int64_t)gc_num.interval;
     live_bytes += -gc_num.freed + gc_num.since_sweep;
+    if (gc_max_heap_size) {
+        // never schedule the next collection past the heap target
+        int64_t headroom = (int64_t)gc_max_heap_size - live_bytes;
+        if (headroom < (int64_t)(default_collect_interval / 8))
+            headroom = default_collect_interval / 8;
+        if (gc_num.interval > (size_t)headroom)
+            gc_num.interval = (size_t)headroom;
+    }
+    gc_num.allocd = 0;
+    reset_thread_gc_counts();
     gc_num.pause += !recollect;
     gc_num.total_time += pause;
     gc_num.since_sweep = 0;
@@ -2857,9 +4013,13 @@ static int _jl_gc_collect(jl_ptls_t ptls, int full)
 JL_DLLEXPORT void jl_gc_collect(int full)
 {
     jl_ptls_t ptls = jl_get_ptls_states();
+    gc_leaf_check("garbage collection");
     if (jl_gc_disable_counter) {
-        gc_num.deferred_alloc += (gc_num.allocd + gc_num.interval);
-        gc_num.allocd = -(int64_t)gc_num.interval;
+        // only this thread's budget triggered; move its bytes to the
+        // deferred count and hand it a fresh interval
+        size_t localbytes = ptls->gc_num.allocd + gc_num.interval;
+        ptls->gc_num.allocd = -(int64_t)gc_num.interval;
+        jl_atomic_fetch_add(&gc_num.deferred_alloc, (int64_t)localbytes);
         return;
     }
     gc_debug_print();
@@ -2900,10 +4060,22 @@ JL_DLLEXPORT void jl_gc_collect(int full)
     // Doing this on all threads is racy (it's impossible to check
     // or wait for finalizers on other threads without dead lock).
     if (!ptls->finalizers_inhibited) {
-        int8_t was_in_finalizer = ptls->in_finalizer;
-        ptls->in_finalizer = 1;
-        run_finalizers(ptls);
-        ptls->in_finalizer = was_in_finalizer;
+#ifdef JULIA_ENABLE_THREADING
+        if (gc_async_finalizers &&
+            to_finalize.len < 2 * GC_FINALIZER_BACKPRESSURE) {
+            // leave the queue for the scheduler's batched drain; wake a
+            // sleeping thread so the first batch starts promptly
+            if (to_finalize.len)
+                jl_wakeup_thread(0);
+        }
+        else
+#endif
+        {
+            int8_t was_in_finalizer = ptls->in_finalizer;
+            ptls->in_finalizer = 1;
+            run_finalizers(ptls);
+            ptls->in_finalizer = was_in_finalizer;
+        }
     }
     gc_invoke_callbacks(jl_gc_cb_post_gc_t,
         gc_cblist_post_gc, (full));
@@ -2936,19 +4108,32 @@ void jl_init_thread_heap(jl_ptls_t ptls)
         p[i].osize = jl_gc_sizeclasses[i];
         p[i].freelist = NULL;
         p[i].newpages = NULL;
+        p[i].unswept = NULL;
     }
     arraylist_new(&heap->weak_refs, 0);
     arraylist_new(&heap->live_tasks, 0);
     heap->mallocarrays = NULL;
     heap->mafreelist = NULL;
-    heap->big_objects = NULL;
+    for (int i = 0; i < JL_GC_N_BIG_SHARDS; i++)
+        heap->big_objects[i] = NULL;
     arraylist_new(&heap->rem_bindings, 0);
     heap->remset = &heap->_remset[0];
     heap->last_remset = &heap->_remset[1];
     arraylist_new(heap->remset, 0);
     arraylist_new(heap->last_remset, 0);
+    // write-barrier pushes between collections should not have to double
+    // their way up from the inline buffer one realloc at a time
+    arraylist_reserve(heap->remset, 1024);
+    arraylist_reserve(heap->last_remset, 1024);
     arraylist_new(&ptls->finalizers, 0);
     arraylist_new(&ptls->sweep_objs, 0);
+    arena_new(&ptls->scratch_arena);
+
+    // the default is used (rather than the current, possibly adapted,
+    // gc_num.interval) because the master thread is initialized before
+    // jl_gc_init; the next collection re-syncs every thread's budget
+    memset(&ptls->gc_num, 0, sizeof(ptls->gc_num));
+    ptls->gc_num.allocd = -(int64_t)default_collect_interval;
 
     jl_gc_mark_cache_t *gc_cache = &ptls->gc_cache;
     gc_cache->perm_scanned_bytes = 0;
@@ -2969,10 +4154,43 @@ void jl_gc_init(void)
 
     arraylist_new(&finalizer_list_marked, 0);
     arraylist_new(&to_finalize, 0);
+    arraylist_new(&gc_mark_shared_roots, 0);
+    jl_lock_register(&finalizers_lock, "finalizers");
+#ifdef JULIA_ENABLE_THREADING
+    {
+        char *cp = getenv("JULIA_GC_PARALLEL_MARKING");
+        if (cp && strtol(cp, NULL, 10) != 0)
+            gc_parallel_marking = 1;
+        cp = getenv("JULIA_GC_PARALLEL_SWEEP");
+        if (cp && strtol(cp, NULL, 10) != 0)
+            gc_parallel_sweeping = 1;
+        cp = getenv("JULIA_ASYNC_FINALIZERS");
+        if (cp && strtol(cp, NULL, 10) != 0)
+            gc_async_finalizers = 1;
+    }
+#endif
+    {
+        char *cp = getenv("JULIA_GC_CARD_MARKING");
+        if (cp && strtol(cp, NULL, 10) != 0)
+            gc_card_marking = 1;
+    }
+    {
+        char *cp = getenv("JULIA_GC_LAZY_SWEEP");
+        if (cp && strtol(cp, NULL, 10) != 0)
+            gc_lazy_sweep_enabled = 1;
+    }
+#ifdef _OS_LINUX_
+    htable_new(&gc_mmap_sizes, 0);
+    {
+        char *cp = getenv("JULIA_GC_MREMAP_THRESHOLD");
+        if (cp)
+            gc_mremap_threshold = strtoull(cp, NULL, 10);
+    }
+#endif
 
     gc_num.interval = default_collect_interval;
     last_long_collect_interval = default_collect_interval;
-    gc_num.allocd = -default_collect_interval;
+    gc_num.allocd = 0;
 
 #ifdef _P64
     // on a big memory machine, set max_collect_interval to totalmem * nthreads / ncores / 2
@@ -2996,8 +4214,8 @@ JL_DLLEXPORT void *jl_gc_counted_malloc(size_t sz)
 {
     jl_ptls_t ptls = jl_get_ptls_states();
     maybe_collect(ptls);
-    gc_num.allocd += sz;
-    gc_num.malloc++;
+    ptls->gc_num.allocd += sz;
+    ptls->gc_num.malloc++;
     void *b = malloc(sz);
     if (b == NULL)
         jl_throw(jl_memory_exception);
@@ -3008,8 +4226,8 @@ JL_DLLEXPORT void *jl_gc_counted_calloc(size_t nm, size_t sz)
 {
     jl_ptls_t ptls = jl_get_ptls_states();
     maybe_collect(ptls);
-    gc_num.allocd += nm*sz;
-    gc_num.malloc++;
+    ptls->gc_num.allocd += nm*sz;
+    ptls->gc_num.malloc++;
     void *b = calloc(nm, sz);
     if (b == NULL)
         jl_throw(jl_memory_exception);
@@ -3018,9 +4236,10 @@ JL_DLLEXPORT void *jl_gc_counted_calloc(size_t nm, size_t sz)
 
 JL_DLLEXPORT void jl_gc_counted_free_with_size(void *p, size_t sz)
 {
+    jl_ptls_t ptls = jl_get_ptls_states();
     free(p);
-    gc_num.freed += sz;
-    gc_num.freecall++;
+    ptls->gc_num.freed += sz;
+    ptls->gc_num.freecall++;
 }
 
 // older name for jl_gc_counted_free_with_size
@@ -3034,10 +4253,10 @@ JL_DLLEXPORT void *jl_gc_counted_realloc_with_old_size(void *p, size_t old, size
     jl_ptls_t ptls = jl_get_ptls_states();
     maybe_collect(ptls);
     if (sz < old)
-        gc_num.freed += (old - sz);
+        ptls->gc_num.freed += (old - sz);
     else
-        gc_num.allocd += (sz - old);
-    gc_num.realloc++;
+        ptls->gc_num.allocd += (sz - old);
+    ptls->gc_num.realloc++;
     void *b = realloc(p, sz);
     if (b == NULL)
         jl_throw(jl_memory_exception);
@@ -3097,9 +4316,15 @@ JL_DLLEXPORT void *jl_gc_managed_malloc(size_t sz)
     size_t allocsz = LLT_ALIGN(sz, JL_CACHE_BYTE_ALIGNMENT);
     if (allocsz < sz)  // overflow in adding offs, size was "negative"
         jl_throw(jl_memory_exception);
-    gc_num.allocd += allocsz;
-    gc_num.malloc++;
-    void *b = malloc_cache_align(allocsz);
+    ptls->gc_num.allocd += allocsz;
+    ptls->gc_num.malloc++;
+    void *b;
+#ifdef _OS_LINUX_
+    if (gc_mremap_threshold && allocsz >= gc_mremap_threshold)
+        b = gc_managed_mmap(allocsz);
+    else
+#endif
+        b = malloc_cache_align(allocsz);
     if (b == NULL)
         jl_throw(jl_memory_exception);
     return b;
@@ -3120,12 +4345,34 @@ static void *gc_managed_realloc_(jl_ptls_t ptls, void *d, size_t sz, size_t olds
         live_bytes += allocsz - oldsz;
     }
     else if (allocsz < oldsz)
-        gc_num.freed += (oldsz - allocsz);
+        ptls->gc_num.freed += (oldsz - allocsz);
     else
-        gc_num.allocd += (allocsz - oldsz);
-    gc_num.realloc++;
+        ptls->gc_num.allocd += (allocsz - oldsz);
+    ptls->gc_num.realloc++;
 
     void *b;
+#ifdef _OS_LINUX_
+    size_t oldmapsz = gc_mmapped_size(d);
+    if (oldmapsz) {
+        b = gc_managed_mremap(d, oldmapsz, allocsz);
+    }
+    else if (gc_mremap_threshold && allocsz >= gc_mremap_threshold &&
+             jl_is_array(owner)) {
+        // crossing the threshold: move the buffer into an mmap'ed
+        // mapping so further growth can remap instead of copying.
+        // (arrays only -- string buffers are bigvals and must stay
+        // on the malloc path so big-object sweeping can free them)
+        b = gc_managed_mmap(allocsz);
+        if (b != NULL) {
+            memcpy(b, d, oldsz < allocsz ? oldsz : allocsz);
+            if (isaligned)
+                jl_free_aligned(d);
+            else
+                free(d);
+        }
+    }
+    else
+#endif
     if (isaligned)
         b = realloc_cache_align(d, allocsz, oldsz);
     else
@@ -3174,7 +4421,7 @@ jl_value_t *jl_gc_realloc_string(jl_value_t *s, size_t sz)
     bigval_t *newbig = (bigval_t*)gc_managed_realloc_(ptls, hdr, allocsz, oldsz, 1, s, 0);
     newbig->sz = allocsz;
     newbig->age = 0;
-    gc_big_object_link(newbig, &ptls->heap.big_objects);
+    gc_big_object_link(newbig, &ptls->heap.big_objects[gc_bigval_shard(newbig)]);
     jl_value_t *snew = jl_valueof(&newbig->header);
     *(size_t*)snew = sz;
     return snew;
@@ -247,7 +247,7 @@ typedef struct _mallocarray_t {
 } mallocarray_t;
 
 // pool page metadata
-typedef struct {
+typedef struct _jl_gc_pagemeta_t {
     // index of pool that owns this page
     uint8_t pool_n;
     // Whether any cell in the page is marked
@@ -280,6 +280,16 @@ typedef struct {
     uint16_t thread_n;        // thread id of the heap that owns this page
     char *data;
     uint8_t *ages;
+    // link in the owning pool's `unswept` list when the sweep of this page
+    // has been deferred to allocation time (see the lazy sweep mode in gc.c)
+    struct _jl_gc_pagemeta_t *next_unswept;
+    // time (`jl_hrtime`) at which the page was freed, while the page sits
+    // on the decay list waiting to be returned to the OS (0 otherwise)
+    uint64_t free_time;
+    // whether the write barrier recorded an old-to-young store into this
+    // page since the last collection (card marking mode only, see
+    // `jl_gc_queue_root` in gc.c)
+    uint8_t has_dirty;
 } jl_gc_pagemeta_t;
 
 // Page layout:
@@ -370,7 +380,7 @@ STATIC_INLINE unsigned ffs_u32(uint32_t bitvec)
 
 extern jl_gc_num_t gc_num;
 extern pagetable_t memory_map;
-extern bigval_t *big_objects_marked;
+extern bigval_t *big_objects_marked[JL_GC_N_BIG_SHARDS];
 extern arraylist_t finalizer_list_marked;
 extern arraylist_t to_finalize;
 extern int64_t lazy_freed_pages;
@@ -486,6 +496,16 @@ STATIC_INLINE void gc_big_object_link(bigval_t *hdr, bigval_t **list) JL_NOTSAFE
     *list = hdr;
 }
 
+// The shard (both of `heap.big_objects` and of `big_objects_marked`) a big
+// object belongs on. Keyed on the address so that the mark phase can move an
+// object between the two sets without knowing where it was allocated.
+// Unlinking doesn't need the shard at all thanks to the `prev` pointer.
+STATIC_INLINE int gc_bigval_shard(const bigval_t *hdr) JL_NOTSAFEPOINT
+{
+    // big objects are at least 2k apart, drop the always-zero low bits
+    return (int)(((uintptr_t)hdr >> 11) % JL_GC_N_BIG_SHARDS);
+}
+
 STATIC_INLINE void gc_mark_sp_init(jl_gc_mark_cache_t *gc_cache, jl_gc_mark_sp_t *sp)
 {
     sp->pc = gc_cache->pc_stack;
@@ -508,16 +528,42 @@ extern void *gc_mark_label_addrs[_GC_MARK_L_MAX];
 void jl_gc_init_page(void);
 NOINLINE jl_gc_pagemeta_t *jl_gc_alloc_page(void);
 void jl_gc_free_page(void *p);
+void jl_gc_decay_free_pages(void);
 
 // GC debug
 
-#if defined(GC_TIME) || defined(GC_FINAL_STATS)
 void gc_settime_premark_end(void);
 void gc_settime_postmark_end(void);
-#else
-#define gc_settime_premark_end()
-#define gc_settime_postmark_end()
-#endif
+
+// Structured binary GC event log (see gc-debug.c). The gc_time_* hooks
+// below append fixed-size records to a preallocated ring while the world
+// is stopped; the log is enabled at runtime with jl_gc_event_log_start and
+// dumped with jl_gc_event_log_stop. Dumps are decoded offline by
+// contrib/gc_event_log.py.
+typedef struct {
+    uint64_t t;      // jl_hrtime timestamp at emission
+    uint16_t event;  // GC_EV_*
+    uint16_t flags;  // GC_EV_FLAG_FULL when part of a full sweep
+    uint32_t _pad;
+    int64_t data[5]; // per-event payload, documented in gc-debug.c
+} jl_gc_event_rec_t;
+
+enum {
+    GC_EV_MARK = 1,          // mark pause and scan/remset statistics
+    GC_EV_POOL_SWEEP_BEGIN,
+    GC_EV_POOL_SWEEP_END,    // page statistics from gc_time_count_page
+    GC_EV_SYSIMG_SWEEP,
+    GC_EV_BIG_SWEEP_BEGIN,
+    GC_EV_BIG_SWEEP_END,
+    GC_EV_ARRAY_SWEEP_BEGIN,
+    GC_EV_ARRAY_SWEEP_END,
+    GC_EV_COLLECT_END,       // whole-collection summary
+};
+#define GC_EV_FLAG_FULL 0x1
+
+extern int gc_event_log_on;
+JL_DLLEXPORT int jl_gc_event_log_start(size_t max_records);
+JL_DLLEXPORT int jl_gc_event_log_stop(const char *fname);
 
 #ifdef GC_FINAL_STATS
 void gc_final_count_page(size_t pg_cnt);
@@ -527,7 +573,7 @@ void gc_final_pause_end(int64_t t0, int64_t tend);
 #define gc_final_pause_end(t0, tend)
 #endif
 
-#ifdef GC_TIME
+// event-log hooks; all early-out on a flag test while the log is disabled
 void gc_time_pool_start(void) JL_NOTSAFEPOINT;
 void gc_time_count_page(int freedall, int pg_skpd) JL_NOTSAFEPOINT;
 void gc_time_pool_end(int sweep_full) JL_NOTSAFEPOINT;
@@ -546,32 +592,6 @@ void gc_time_mark_pause(int64_t t0, int64_t scanned_bytes,
 void gc_time_sweep_pause(uint64_t gc_end_t, int64_t actual_allocd,
                          int64_t live_bytes, int64_t estimate_freed,
                          int sweep_full);
-#else
-#define gc_time_pool_start()
-STATIC_INLINE void gc_time_count_page(int freedall, int pg_skpd) JL_NOTSAFEPOINT
-{
-    (void)freedall;
-    (void)pg_skpd;
-}
-#define gc_time_pool_end(sweep_full) (void)(sweep_full)
-#define gc_time_sysimg_end(t0) (void)(t0)
-#define gc_time_big_start()
-STATIC_INLINE void gc_time_count_big(int old_bits, int bits) JL_NOTSAFEPOINT
-{
-    (void)old_bits;
-    (void)bits;
-}
-#define gc_time_big_end()
-#define gc_time_mallocd_array_start()
-STATIC_INLINE void gc_time_count_mallocd_array(int bits) JL_NOTSAFEPOINT
-{
-    (void)bits;
-}
-#define gc_time_mallocd_array_end()
-#define gc_time_mark_pause(t0, scanned_bytes, perm_scanned_bytes)
-#define gc_time_sweep_pause(gc_end_t, actual_allocd, live_bytes,        \
-                            estimate_freed, sweep_full)
-#endif
 
 #ifdef MEMFENCE
 void gc_verify_tags(void);
@@ -12,6 +12,7 @@
 #include <string.h>
 #include "julia.h"
 #include "julia_internal.h"
+#include "ptrhash.h"
 #ifndef _OS_WINDOWS_
 #include <unistd.h>
 #endif
@@ -24,6 +25,15 @@
 extern "C" {
 #endif
 
+// The global method-table epoch. Note that dispatch never reads this:
+// jl_apply_generic and the codegen'd fast paths read the thread-local
+// ptls->world_age (one line, written only by its own thread), which acts
+// as a per-thread cache of this counter. It is refreshed only at the
+// points where the visible method set is allowed to advance — top-level
+// expression boundaries, task start and switch, and entry from embedding
+// or callback code — so a definition published here becomes visible to
+// running code at well-defined moments rather than mid-function, and the
+// steady state costs no shared-line traffic.
 JL_DLLEXPORT size_t jl_world_counter = 1;
 JL_DLLEXPORT size_t jl_get_world_counter(void)
 {
@@ -35,6 +45,55 @@ JL_DLLEXPORT size_t jl_get_tls_world_age(void)
     return jl_get_ptls_states()->world_age;
 }
 
+// World-age batching for top-level evaluation. While a batch is open,
+// consecutive method definitions share a single world increment instead of
+// bumping the counter once per method; the driver (jl_parse_eval_all) breaks
+// the batch whenever it executes an expression that could call methods
+// defined earlier in it, so sequential code observes the same method sets it
+// would without batching. Within one shared world the method set can grow,
+// which a concurrently running task pinned at that world could observe, so
+// this is opt-in via JULIA_WORLD_BATCH=1.
+static int world_batch_depth = 0;
+static size_t world_batch_world = 0; // world shared by the current run of definitions
+
+static int jl_world_batch_enabled(void)
+{
+    static int enabled = -1;
+    if (enabled == -1) {
+        char *env = getenv("JULIA_WORLD_BATCH");
+        enabled = (env && env[0] && strcmp(env, "0") != 0) ? 1 : 0;
+    }
+    return enabled;
+}
+
+void jl_world_batch_begin(void)
+{
+    if (jl_world_batch_enabled())
+        world_batch_depth++;
+}
+
+void jl_world_batch_end(void)
+{
+    if (world_batch_depth > 0 && --world_batch_depth == 0)
+        world_batch_world = 0;
+}
+
+// end sharing: the next definition gets a fresh world
+void jl_world_batch_break(void)
+{
+    world_batch_world = 0;
+}
+
+size_t jl_world_counter_next(void)
+{
+    if (world_batch_depth > 0) {
+        if (world_batch_world == 0)
+            world_batch_world = ++jl_world_counter;
+        return world_batch_world;
+    }
+    return ++jl_world_counter;
+}
+
 /// ----- Handling for Julia callbacks ----- ///
 
 JL_DLLEXPORT int8_t jl_is_in_pure_context(void)
@@ -89,9 +148,16 @@ static int8_t jl_cachearg_offset(jl_methtable_t *mt)
 // get or create the MethodInstance for a specialization
 JL_DLLEXPORT jl_method_instance_t *jl_specializations_get_linfo(jl_method_t *m JL_PROPAGATES_ROOT, jl_value_t *type, jl_svec_t *sparams)
 {
-    JL_LOCK(&m->writelock);
+    // probe without the method lock first: typemaps tolerate concurrent
+    // readers during insertion (the dispatch fast path reads mt->cache the
+    // same way), so for methods with very large specialization tables the
+    // common already-specialized case never serializes on m->writelock
     jl_typemap_entry_t *sf =
         jl_typemap_assoc_by_type(m->specializations, type, NULL, /*subtype*/0, /*offs*/0, 1, /*max_world_mask*/0);
+    if (sf && jl_is_method_instance(sf->func.value))
+        return sf->func.linfo;
+    JL_LOCK(&m->writelock);
+    sf = jl_typemap_assoc_by_type(m->specializations, type, NULL, /*subtype*/0, /*offs*/0, 1, /*max_world_mask*/0);
     if (sf && jl_is_method_instance(sf->func.value)) {
         JL_UNLOCK(&m->writelock);
         return sf->func.linfo;
@@ -116,6 +182,21 @@ JL_DLLEXPORT jl_value_t *jl_specializations_lookup(jl_method_t *m, jl_value_t *t
     return sf->func.value;
 }
 
+static int count_specializations_visitor(jl_typemap_entry_t *ml, void *closure)
+{
+    (*(size_t*)closure)++;
+    return 1;
+}
+
+// number of specializations recorded for a method, for finding methods whose
+// specialization tables have blown up
+JL_DLLEXPORT size_t jl_method_n_specializations(jl_method_t *m)
+{
+    size_t count = 0;
+    jl_typemap_visitor(m->specializations, count_specializations_visitor, &count);
+    return count;
+}
+
 JL_DLLEXPORT jl_value_t *jl_methtable_lookup(jl_methtable_t *mt, jl_value_t *type, size_t world)
 {
     jl_typemap_entry_t *sf = jl_typemap_assoc_by_type(
@@ -167,6 +248,88 @@ jl_datatype_t *jl_mk_builtin_func(jl_datatype_t *dt, const char *name, jl_fptr_a
     return dt;
 }
 
+// -- compilation telemetry ---------------------------------------------
+//
+// When a service stalls under a compilation storm, nothing in the runtime
+// records what compiled or why. With the log enabled, every inference run
+// (here), codegen invocation (jl_compile_linfo) and native code emission
+// (debuginfo.cpp) appends one event; the ring keeps the most recent
+// JL_COMPILE_LOG_LEN events and is queryable while the process runs.
+// See `jl_compile_event_t` in julia.h.
+
+JL_DLLEXPORT int jl_compile_log_enabled = 0;
+
+#define JL_COMPILE_LOG_LEN 4096
+static jl_compile_event_t compile_log[JL_COMPILE_LOG_LEN];
+static volatile uint64_t compile_log_n = 0;
+
+void jl_compile_log_event(jl_method_instance_t *mi, int kind, int recompile,
+                          uint64_t duration_ns, uint64_t native_size)
+{
+    uint64_t idx = jl_atomic_fetch_add(&compile_log_n, 1);
+    jl_compile_event_t *ev = &compile_log[idx % JL_COMPILE_LOG_LEN];
+    ev->mi = mi;
+    ev->t_ns = jl_hrtime();
+    ev->duration_ns = duration_ns;
+    ev->native_size = native_size;
+    ev->kind = (uint8_t)kind;
+    ev->recompile = (uint8_t)recompile;
+}
+
+// an instance that already holds code whose validity ended before `world`
+// is being recompiled because a method redefinition invalidated it; an
+// instance with no such entry is compiling for its first dispatch
+int jl_compile_log_invalidated(jl_method_instance_t *mi, size_t world)
+{
+    for (jl_code_instance_t *ci = mi->cache; ci; ci = ci->next)
+        if (ci->max_world < world)
+            return 1;
+    return 0;
+}
+
+JL_DLLEXPORT int jl_compile_log_enable(int enable)
+{
+    int old = jl_compile_log_enabled;
+    jl_compile_log_enabled = enable;
+    return old;
+}
+
+JL_DLLEXPORT uint64_t jl_compile_log_count(void)
+{
+    return compile_log_n;
+}
+
+// copy out event `i`, where 0 is the oldest retained event; returns -1
+// when `i` is past the end of the ring
+JL_DLLEXPORT int jl_compile_log_get(uint64_t i, jl_compile_event_t *ev)
+{
+    uint64_t n = compile_log_n;
+    uint64_t retained = n < JL_COMPILE_LOG_LEN ? n : JL_COMPILE_LOG_LEN;
+    if (i >= retained)
+        return -1;
+    *ev = compile_log[(n - retained + i) % JL_COMPILE_LOG_LEN];
+    return 0;
+}
+
+JL_DLLEXPORT void jl_compile_log_dump(void)
+{
+    uint64_t n = compile_log_n;
+    uint64_t retained = n < JL_COMPILE_LOG_LEN ? n : JL_COMPILE_LOG_LEN;
+    static const char *kinds[] = { "inference", "codegen", "native" };
+    for (uint64_t i = 0; i < retained; i++) {
+        jl_compile_event_t *ev = &compile_log[(n - retained + i) % JL_COMPILE_LOG_LEN];
+        jl_printf(JL_STDERR, "%" PRIu64 ".%06u %-9s %8.3f ms %8u bytes %s ",
+                  ev->t_ns / 1000000000, (unsigned)(ev->t_ns % 1000000000 / 1000),
+                  kinds[ev->kind % 3], ev->duration_ns / 1e6,
+                  (unsigned)ev->native_size,
+                  ev->recompile ? "invalidated" : "first-call ");
+        jl_static_show_func_sig(JL_STDERR, (jl_value_t*)ev->mi->specTypes);
+        jl_printf(JL_STDERR, "\n");
+    }
+    if (n > retained)
+        jl_printf(JL_STDERR, "(%" PRIu64 " older events overwritten)\n", n - retained);
+}
+
 // run type inference on lambda "mi" for given argument types.
 // returns the inferred source, and may cache the result in mi
 // if successful, also updates the mi argument to describe the validity of this src
@@ -187,6 +350,13 @@ jl_code_info_t *jl_type_infer(jl_method_instance_t *mi, size_t world, int force)
     if (mi->inInference && !force)
         return NULL;
 
+    uint64_t log_t0 = 0;
+    int log_recompile = 0;
+    if (jl_compile_log_enabled) {
+        log_t0 = jl_hrtime();
+        log_recompile = jl_compile_log_invalidated(mi, world);
+    }
+
     jl_value_t **fargs;
     JL_GC_PUSHARGS(fargs, 3);
     fargs[0] = (jl_value_t*)jl_typeinf_func;
@@ -222,6 +392,9 @@ jl_code_info_t *jl_type_infer(jl_method_instance_t *mi, size_t world, int force)
         src = NULL;
     }
     JL_GC_POP();
+    if (log_t0)
+        jl_compile_log_event(mi, JL_COMPILE_EV_INFERENCE, log_recompile,
+                             jl_hrtime() - log_t0, 0);
 #endif
     return src;
 }
@@ -330,6 +503,7 @@ static void foreach_mtable_in_module(
         jl_array_t *visited)
 {
     size_t i;
+    jl_module_ensure_bindings(m);
     void **table = m->bindings.table;
     jl_eqtable_put(visited, (jl_value_t*)m, jl_true, NULL);
     for (i = 1; i < m->bindings.size; i += 2) {
@@ -994,12 +1168,77 @@ static jl_method_instance_t *cache_method(
     return newmeth;
 }
 
-static jl_method_instance_t *jl_mt_assoc_by_type(jl_methtable_t *mt, jl_datatype_t *tt, int mt_cache, size_t world)
+// Tracing of dispatch-miss compilations as replayable `precompile(...)`
+// statements, for feeding back into sysimage generation. Enabled at startup
+// with `--trace-compile=<file|stderr>`, or toggled at runtime (e.g. around a
+// representative traffic window in a deployed service) with
+// `jl_set_trace_compile`. TODO: Merge with jl_dump_compiles?
+static jl_mutex_t precompile_trace_lock;
+static ios_t f_precompile;
+static JL_STREAM *s_precompile = NULL;
+// -1: not yet consulted `jl_options.trace_compile`; 0: off; 1: on
+static volatile int precompile_trace_on = -1;
+
+// open the trace target; returns 0 (with the stream unset) if it cannot be
+// opened so the caller can release the lock before raising
+static int open_precompile_stream(const char *t)
 {
-    // TODO: Merge with jl_dump_compiles?
-    static ios_t f_precompile;
-    static JL_STREAM* s_precompile = NULL;
+    if (!strncmp(t, "stderr", 6)) {
+        s_precompile = JL_STDERR;
+    }
+    else {
+        if (ios_file(&f_precompile, t, 1, 1, 1, 1) == NULL)
+            return 0;
+        s_precompile = (JL_STREAM*)&f_precompile;
+    }
+    return 1;
+}
 
+JL_DLLEXPORT void jl_set_trace_compile(const char *fname)
+{
+    JL_LOCK_NOGC(&precompile_trace_lock);
+    if (s_precompile != NULL && s_precompile != JL_STDERR)
+        ios_close(&f_precompile);
+    s_precompile = NULL;
+    jl_options.trace_compile = NULL; // don't lazily reopen the startup target
+    precompile_trace_on = 0;
+    if (fname != NULL && fname[0] != '\0') {
+        if (!open_precompile_stream(fname)) {
+            JL_UNLOCK_NOGC(&precompile_trace_lock);
+            jl_errorf("cannot open precompile statement file \"%s\" for writing", fname);
+        }
+        precompile_trace_on = 1;
+    }
+    JL_UNLOCK_NOGC(&precompile_trace_lock);
+}
+
+static void record_precompile_statement(jl_tupletype_t *tt)
+{
+    JL_LOCK_NOGC(&precompile_trace_lock);
+    if (precompile_trace_on == -1) {
+        // first hit: consult the command-line option
+        const char *t = jl_options.trace_compile;
+        if (t == NULL || !open_precompile_stream(t)) {
+            precompile_trace_on = 0;
+            JL_UNLOCK_NOGC(&precompile_trace_lock);
+            if (t != NULL)
+                jl_errorf("cannot open precompile statement file \"%s\" for writing", t);
+            return;
+        }
+        precompile_trace_on = 1;
+    }
+    if (precompile_trace_on) {
+        jl_printf(s_precompile, "precompile(");
+        jl_static_show(s_precompile, (jl_value_t*)tt);
+        jl_printf(s_precompile, ")\n");
+        if (s_precompile != JL_STDERR)
+            ios_flush(&f_precompile);
+    }
+    JL_UNLOCK_NOGC(&precompile_trace_lock);
+}
+
+static jl_method_instance_t *jl_mt_assoc_by_type(jl_methtable_t *mt, jl_datatype_t *tt, int mt_cache, size_t world)
+{
     // caller must hold the mt->writelock
     jl_typemap_entry_t *entry = NULL;
     entry = jl_typemap_assoc_by_type(mt->cache, (jl_value_t*)tt, NULL, /*subtype*/1, jl_cachearg_offset(mt), world, /*max_world_mask*/0);
@@ -1015,26 +1254,9 @@ static jl_method_instance_t *jl_mt_assoc_by_type(jl_methtable_t *mt, jl_datatype
     if (entry != NULL) {
         jl_method_t *m = entry->func.method;
         if (!jl_has_call_ambiguities((jl_value_t*)tt, m)) {
-            if (jl_options.trace_compile != NULL) {
-                if (s_precompile == NULL) {
-                    const char* t = jl_options.trace_compile;
-                    if (!strncmp(t, "stderr", 6))
-                        s_precompile = JL_STDERR;
-                    else {
-                        if (ios_file(&f_precompile, t, 1, 1, 1, 1) == NULL)
-                            jl_errorf("cannot open precompile statement file \"%s\" for writing", t);
-                        s_precompile = (JL_STREAM*) &f_precompile;
-                    }
-                }
-                if (!jl_has_free_typevars((jl_value_t*)tt)) {
-                    jl_printf(s_precompile, "precompile(");
-                    jl_static_show(s_precompile, (jl_value_t*)tt);
-                    jl_printf(s_precompile, ")\n");
-
-                    if (s_precompile != JL_STDERR)
-                        ios_flush(&f_precompile);
-                }
-            }
+            if (__unlikely(precompile_trace_on != 0) &&
+                !jl_has_free_typevars((jl_value_t*)tt))
+                record_precompile_statement(tt);
             if (!mt_cache) {
                 intptr_t nspec = (mt == jl_type_type_mt ? m->nargs + 1 : mt->max_args + 2);
                 jl_compilation_sig(tt, env, m, nspec, &newparams);
@@ -1278,8 +1500,33 @@ static void update_max_args(jl_methtable_t *mt, jl_value_t *type)
 
 int JL_DEBUG_METHOD_INVALIDATION = 0;
 
-// recursively invalidate cached methods that had an edge to a replaced method
-static void invalidate_method_instance(jl_method_instance_t *replaced, size_t max_world, int depth)
+// when enabled, flat log of (cause, invalidated instance) pairs, where cause
+// is the newly added or deleted method that triggered the invalidation
+jl_array_t *jl_invalidation_log JL_GLOBALLY_ROOTED = NULL;
+
+JL_DLLEXPORT void jl_log_method_invalidations(int enable)
+{
+    if (enable && jl_invalidation_log == NULL)
+        jl_invalidation_log = jl_alloc_vec_any(0);
+    else if (!enable)
+        jl_invalidation_log = NULL;
+}
+
+// return the accumulated invalidation log (or nothing) and start a new one
+JL_DLLEXPORT jl_value_t *jl_method_invalidation_log(void)
+{
+    jl_array_t *log = jl_invalidation_log;
+    if (log == NULL)
+        return jl_nothing;
+    jl_invalidation_log = jl_alloc_vec_any(0);
+    return (jl_value_t*)log;
+}
+
+// recursively invalidate cached methods that had an edge to a replaced method.
+// note that this only stamps world bounds, which must happen eagerly so that
+// code running in the new world can never reach a stale compilation; the
+// expensive part (recompiling) already happens lazily on the next call.
+static void invalidate_method_instance(jl_method_instance_t *replaced, size_t max_world, int depth, jl_value_t *cause)
 {
     if (JL_DEBUG_METHOD_INVALIDATION) {
         int d0 = depth;
@@ -1290,6 +1537,11 @@ static void invalidate_method_instance(jl_method_instance_t *replaced, size_t ma
     }
     if (!jl_is_method(replaced->def.method))
         return; // shouldn't happen, but better to be safe
+    if (jl_invalidation_log != NULL) {
+        // push before taking the no-GC lock below, since pushing can allocate
+        jl_array_ptr_1d_push(jl_invalidation_log, cause);
+        jl_array_ptr_1d_push(jl_invalidation_log, (jl_value_t*)replaced);
+    }
     JL_LOCK_NOGC(&replaced->def.method->writelock);
     jl_code_instance_t *codeinst = replaced->cache;
     while (codeinst) {
@@ -1307,7 +1559,7 @@ static void invalidate_method_instance(jl_method_instance_t *replaced, size_t ma
         size_t i, l = jl_array_len(backedges);
         for (i = 0; i < l; i++) {
             jl_method_instance_t *replaced = (jl_method_instance_t*)jl_array_ptr_ref(backedges, i);
-            invalidate_method_instance(replaced, max_world, depth + 1);
+            invalidate_method_instance(replaced, max_world, depth + 1, cause);
         }
     }
     JL_UNLOCK_NOGC(&replaced->def.method->writelock);
@@ -1318,6 +1570,7 @@ struct invalidate_conflicting_env {
     struct typemap_intersection_env match;
     size_t max_world;
     int invalidated;
+    jl_value_t *cause;
 };
 static int invalidate_backedges(jl_typemap_entry_t *oldentry, struct typemap_intersection_env *closure0)
 {
@@ -1331,7 +1584,7 @@ static int invalidate_backedges(jl_typemap_entry_t *oldentry, struct typemap_int
         size_t i, l = jl_array_len(backedges);
         jl_method_instance_t **replaced = (jl_method_instance_t**)jl_array_ptr_data(backedges);
         for (i = 0; i < l; i++) {
-            invalidate_method_instance(replaced[i], closure->max_world, 1);
+            invalidate_method_instance(replaced[i], closure->max_world, 1, closure->cause);
         }
         closure->invalidated = 1;
     }
@@ -1437,6 +1690,42 @@ static int invalidate_mt_cache(jl_typemap_entry_t *oldentry, void *closure0)
     return 1;
 }
 
+// variant of invalidate_mt_cache for batched insertion, where env->shadowed
+// is a flat array of the methods shadowed by the whole batch
+static int invalidate_mt_cache_batch(jl_typemap_entry_t *oldentry, void *closure0)
+{
+    struct invalidate_mt_env *env = (struct invalidate_mt_env*)closure0;
+    if (oldentry->max_world == ~(size_t)0) {
+        jl_method_t *m = oldentry->func.linfo->def.method;
+        jl_value_t **d = jl_array_ptr_data(env->shadowed);
+        size_t i, n = jl_array_len(env->shadowed);
+        for (i = 0; i < n; i++) {
+            if ((jl_value_t*)m == d[i]) {
+                if (JL_DEBUG_METHOD_INVALIDATION) {
+                    jl_uv_puts(JL_STDOUT, "-- ", 4);
+                    jl_static_show(JL_STDOUT, (jl_value_t*)oldentry->func.linfo);
+                    jl_uv_puts(JL_STDOUT, "\n", 1);
+                }
+                oldentry->max_world = env->max_world;
+                break;
+            }
+        }
+    }
+    return 1;
+}
+
+// record a method shadowed by a new definition for a deferred mt->cache
+// scan, keeping the list duplicate-free
+static void push_shadowed(jl_array_t *shadowed, jl_value_t *meth)
+{
+    size_t i, n = jl_array_len(shadowed);
+    for (i = 0; i < n; i++) {
+        if (jl_array_ptr_ref(shadowed, i) == meth)
+            return;
+    }
+    jl_array_ptr_1d_push(shadowed, meth);
+}
+
 static int typemap_search(jl_typemap_entry_t *entry, void *closure)
 {
     if ((void*)(entry->func.method) == *(jl_method_t**)closure) {
@@ -1477,31 +1766,35 @@ JL_DLLEXPORT void jl_method_table_disable(jl_methtable_t *mt, jl_method_t *metho
     struct invalidate_conflicting_env env;
     env.invalidated = 0;
     env.max_world = methodentry->max_world;
+    env.cause = (jl_value_t*)method;
     jl_typemap_visitor(methodentry->func.method->specializations, (jl_typemap_visitor_fptr)invalidate_backedges, &env.match);
     JL_UNLOCK(&mt->writelock);
 }
 
-JL_DLLEXPORT void jl_method_table_insert(jl_methtable_t *mt, jl_method_t *method, jl_tupletype_t *simpletype)
+// insert one method while holding mt->writelock. When `shadowed_out` is
+// NULL this is the complete insertion; when non-NULL (batched insertion),
+// the scan of mt->cache for newly shadowed entries is deferred: the
+// shadowed methods are accumulated into the array for the caller to
+// process in a single pass over the cache.
+static void method_table_insert(jl_methtable_t *mt, jl_method_t *method, jl_tupletype_t *simpletype,
+                                jl_array_t *shadowed_out)
 {
-    JL_TIMING(ADD_METHOD);
     assert(jl_is_method(method));
-    assert(jl_is_mtable(mt));
     jl_value_t *type = method->sig;
     jl_value_t *oldvalue = NULL;
     if (method->primary_world == 1)
-        method->primary_world = ++jl_world_counter;
+        method->primary_world = jl_world_counter_next();
     struct invalidate_conflicting_env env;
     env.invalidated = 0;
     env.max_world = method->primary_world - 1;
+    env.cause = (jl_value_t*)method;
     JL_GC_PUSH1(&oldvalue);
-    JL_LOCK(&mt->writelock);
     jl_typemap_entry_t *newentry = jl_typemap_insert(&mt->defs, (jl_value_t*)mt,
             (jl_tupletype_t*)type, simpletype, jl_emptysvec, (jl_value_t*)method, 0, &method_defs,
             method->primary_world, method->deleted_world, &oldvalue);
     if (oldvalue) {
         if (oldvalue == (jl_value_t*)method) {
             // redundant add of same method; no need to do anything
-            JL_UNLOCK(&mt->writelock);
             JL_GC_POP();
             return;
         }
@@ -1527,7 +1820,7 @@ JL_DLLEXPORT void jl_method_table_insert(jl_methtable_t *mt, jl_method_t *method
                 jl_value_t *backedgetyp = backedges[i - 1];
                 if (!jl_has_empty_intersection(backedgetyp, (jl_value_t*)type)) {
                     jl_method_instance_t *backedge = (jl_method_instance_t*)backedges[i];
-                    invalidate_method_instance(backedge, env.max_world, 0);
+                    invalidate_method_instance(backedge, env.max_world, 0, env.cause);
                     env.invalidated = 1;
                 }
                 else {
@@ -1545,14 +1838,29 @@ JL_DLLEXPORT void jl_method_table_insert(jl_methtable_t *mt, jl_method_t *method
         if (jl_typeis(oldvalue, jl_typemap_entry_type))
             oldvalue = ((jl_typemap_entry_t*)oldvalue)->func.value; // a method
         // drop anything in mt->cache that might overlap with the new method
-        struct invalidate_mt_env mt_cache_env;
-        mt_cache_env.max_world = env.max_world;
-        mt_cache_env.shadowed = oldvalue;
-        jl_typemap_visitor(mt->cache, invalidate_mt_cache, (void*)&mt_cache_env);
-        //TODO: if it's small, might it be better to drop it all too?
-        //if (mt != jl_type_type_mt) {
-        //    mt->cache = jl_nothing;
-        //}
+        if (shadowed_out) {
+            if (jl_is_method(oldvalue)) {
+                push_shadowed(shadowed_out, oldvalue);
+            }
+            else {
+                assert(jl_is_array(oldvalue));
+                size_t i, n = jl_array_len(oldvalue);
+                for (i = 0; i < n; i++) {
+                    jl_typemap_entry_t *e = (jl_typemap_entry_t*)jl_array_ptr_ref(oldvalue, i);
+                    push_shadowed(shadowed_out, (jl_value_t*)e->func.method);
+                }
+            }
+        }
+        else {
+            struct invalidate_mt_env mt_cache_env;
+            mt_cache_env.max_world = env.max_world;
+            mt_cache_env.shadowed = oldvalue;
+            jl_typemap_visitor(mt->cache, invalidate_mt_cache, (void*)&mt_cache_env);
+            //TODO: if it's small, might it be better to drop it all too?
+            //if (mt != jl_type_type_mt) {
+            //    mt->cache = jl_nothing;
+            //}
+        }
 
         jl_datatype_t *unw = (jl_datatype_t*)jl_unwrap_unionall(type);
         size_t l = jl_svec_len(unw->parameters);
@@ -1589,6 +1897,52 @@ JL_DLLEXPORT void jl_method_table_insert(jl_methtable_t *mt, jl_method_t *method
         jl_uv_puts(JL_STDOUT, "\n", 1);
     }
     update_max_args(mt, type);
+    JL_GC_POP();
+}
+
+JL_DLLEXPORT void jl_method_table_insert(jl_methtable_t *mt, jl_method_t *method, jl_tupletype_t *simpletype)
+{
+    JL_TIMING(ADD_METHOD);
+    assert(jl_is_mtable(mt));
+    JL_LOCK(&mt->writelock);
+    method_table_insert(mt, method, simpletype, NULL);
+    JL_UNLOCK(&mt->writelock);
+}
+
+// Batched variant of jl_method_table_insert used when loading an incremental
+// image (see jl_insert_methods in dump.c): `pairs` holds (method, simpletype)
+// pairs that all target `mt` (and, coming from one image, share one primary
+// world). The table lock is taken once for the whole group, and the scan of
+// mt->cache for newly shadowed entries — a full cache traversal per method
+// on the normal path — is collapsed into a single pass over the union of
+// shadowed methods.
+void jl_method_table_insert_batch(jl_methtable_t *mt, jl_array_t *pairs)
+{
+    JL_TIMING(ADD_METHOD);
+    assert(jl_is_mtable(mt));
+    size_t i, l = jl_array_len(pairs);
+    if (l == 0)
+        return;
+    jl_array_t *shadowed = jl_alloc_vec_any(0);
+    JL_GC_PUSH1(&shadowed);
+    size_t min_world = ~(size_t)0;
+    JL_LOCK(&mt->writelock);
+    for (i = 0; i < l; i += 2) {
+        jl_method_t *meth = (jl_method_t*)jl_array_ptr_ref(pairs, i);
+        jl_tupletype_t *simpletype = (jl_tupletype_t*)jl_array_ptr_ref(pairs, i + 1);
+        method_table_insert(mt, meth, simpletype, shadowed);
+        if (meth->primary_world < min_world)
+            min_world = meth->primary_world;
+    }
+    if (jl_array_len(shadowed) > 0) {
+        // capping at the smallest new world is conservative if the batch
+        // ever spans several worlds: an entry capped early just falls back
+        // to a defs lookup, which gives the same answer
+        struct invalidate_mt_env mt_cache_env;
+        mt_cache_env.max_world = min_world - 1;
+        mt_cache_env.shadowed = (jl_value_t*)shadowed;
+        jl_typemap_visitor(mt->cache, invalidate_mt_cache_batch, (void*)&mt_cache_env);
+    }
     JL_UNLOCK(&mt->writelock);
     JL_GC_POP();
 }
@@ -1608,8 +1962,8 @@ void JL_NORETURN jl_method_error_bare(jl_function_t *f, jl_value_t *args, size_t
     }
     else {
         jl_printf((JL_STREAM*)STDERR_FILENO, "A method error occurred before the base MethodError type was defined. Aborting...\n");
-        jl_static_show((JL_STREAM*)STDERR_FILENO,(jl_value_t*)f); jl_printf((JL_STREAM*)STDERR_FILENO," world %u\n", (unsigned)world);
-        jl_static_show((JL_STREAM*)STDERR_FILENO,args); jl_printf((JL_STREAM*)STDERR_FILENO,"\n");
+        jl_static_show_bounded((JL_STREAM*)STDERR_FILENO,(jl_value_t*)f,32,1<<20); jl_printf((JL_STREAM*)STDERR_FILENO," world %u\n", (unsigned)world);
+        jl_static_show_bounded((JL_STREAM*)STDERR_FILENO,args,32,1<<20); jl_printf((JL_STREAM*)STDERR_FILENO,"\n");
         jl_ptls_t ptls = jl_get_ptls_states();
         ptls->bt_size = rec_backtrace(ptls->bt_data, JL_MAX_BT_SIZE);
         jl_critical_error(0, NULL, ptls->bt_data, &ptls->bt_size);
@@ -1718,6 +2072,165 @@ jl_method_instance_t *jl_get_unspecialized(jl_method_instance_t *method)
     return def->unspecialized;
 }
 
+// --- tiered execution ---
+// With JULIA_TIERED_COMPILE=<n> set, cold interpretable method instances
+// start out running in the interpreter behind jl_fptr_tiered_call, which
+// counts calls. After n calls the code instance is queued and the scheduler's
+// idle path (jl_task_get_next) compiles it and swaps in the native entry
+// point, so threads doing useful work never block on LLVM for warmup.
+
+JL_DLLEXPORT volatile int jl_have_pending_compiles = 0;
+// entries are also reachable through mi->cache, but the GC additionally
+// treats this list as roots (see mark_roots in gc.c) so a queued instance
+// can never be collected out from under the compile worker
+arraylist_t tiered_compile_queue;
+static htable_t tiered_call_counts; // jl_code_instance_t* -> call count
+static int tiered_opt_level = 3;    // hot methods deserve full optimization
+static jl_mutex_t tiered_lock;
+#ifdef JULIA_ENABLE_THREADING
+JL_DLLEXPORT void jl_wakeup_thread(int16_t tid); // defined in partr.c
+#endif
+extern JL_DLLEXPORT int jl_n_threads;
+
+static int jl_tiered_threshold(void)
+{
+    static volatile int threshold = -1;
+    if (__unlikely(threshold == -1)) {
+        JL_LOCK_NOGC(&tiered_lock);
+        if (threshold == -1) {
+            int t = 0;
+            // sysimg/precompile output must not bake in the trampoline
+            if (!jl_generating_output()) {
+                char *cp = getenv("JULIA_TIERED_COMPILE");
+                if (cp)
+                    t = (int)strtol(cp, NULL, 10);
+                cp = getenv("JULIA_TIERED_OPT_LEVEL");
+                if (cp) {
+                    int o = (int)strtol(cp, NULL, 10);
+                    if (o >= 0 && o <= 3)
+                        tiered_opt_level = o;
+                }
+            }
+            if (t > 0) {
+                htable_new(&tiered_call_counts, 0);
+                arraylist_new(&tiered_compile_queue, 0);
+            }
+            threshold = t > 0 ? t : 0;
+        }
+        JL_UNLOCK_NOGC(&tiered_lock);
+    }
+    return threshold;
+}
+
+// interpret the call, promoting the code instance once it has run hot
+JL_DLLEXPORT jl_value_t *jl_fptr_tiered_call(jl_code_instance_t *m, jl_value_t **args, uint32_t nargs)
+{
+    jl_callptr_t invoke = m->invoke;
+    if (invoke != jl_fptr_tiered_call) // the worker finished while we were in flight
+        return invoke(m, args, nargs);
+    int promote = 0;
+    JL_LOCK_NOGC(&tiered_lock);
+    void *v = ptrhash_get(&tiered_call_counts, m);
+    size_t n = (v == HT_NOTFOUND) ? 1 : (size_t)(uintptr_t)v + 1;
+    ptrhash_put(&tiered_call_counts, m, (void*)(uintptr_t)n);
+    if (n == (size_t)jl_tiered_threshold()) {
+        arraylist_push(&tiered_compile_queue, m);
+        jl_have_pending_compiles = 1;
+        promote = 1;
+    }
+    JL_UNLOCK_NOGC(&tiered_lock);
+    if (promote) {
+#ifdef JULIA_ENABLE_THREADING
+        if (jl_n_threads > 1)
+            jl_wakeup_thread(0); // start the background compile promptly
+        else
+#endif
+            jl_compile_pending_hot_methods(); // no worker available: compile here
+    }
+    return jl_fptr_interpret_call(m, args, nargs);
+}
+
+// drain the promotion queue, compiling each instance and publishing the
+// native entry point; runs on whichever thread hits the scheduler idle path
+// how many promoted instances to emit before handing the JIT one merged
+// module; bounds both the roots frame below and the size of a compile unit
+#define TIERED_COMPILE_BATCH 32
+
+JL_DLLEXPORT void jl_compile_pending_hot_methods(void)
+{
+    while (1) {
+        jl_value_t **roots;
+        JL_GC_PUSHARGS(roots, TIERED_COMPILE_BATCH);
+        size_t n = 0;
+        JL_LOCK_NOGC(&tiered_lock);
+        while (n < TIERED_COMPILE_BATCH && tiered_compile_queue.len)
+            roots[n++] = (jl_value_t*)arraylist_pop(&tiered_compile_queue);
+        if (n == 0)
+            jl_have_pending_compiles = 0;
+        JL_UNLOCK_NOGC(&tiered_lock);
+        if (n == 0) {
+            JL_GC_POP();
+            return;
+        }
+        // hot methods deserve full optimization, even when the process runs
+        // -O0/-O1 for load time; the boost covers batch finalization too,
+        // where the optimizer actually runs
+        if (tiered_opt_level > jl_options.opt_level)
+            jl_set_jit_opt_level_boost(tiered_opt_level);
+        // emit everything first, then finalize the batch as one compile unit
+        // so the JIT pays its fixed per-module costs once, not per method
+        jl_code_instance_t *natives[TIERED_COMPILE_BATCH];
+        const char *fnames[TIERED_COMPILE_BATCH];
+        size_t nf = 0;
+        for (size_t i = 0; i < n; i++) {
+            jl_code_instance_t *codeinst = (jl_code_instance_t*)roots[i];
+            jl_method_instance_t *mi = codeinst->def;
+            natives[i] = NULL;
+            if (codeinst->invoke != jl_fptr_tiered_call)
+                continue; // promoted by someone else while queued
+            size_t world = jl_world_counter;
+            jl_code_info_t *src = NULL;
+            if (!jl_rettype_inferred(mi, world, world))
+                src = jl_type_infer(mi, world, 0);
+            jl_code_instance_t *native = jl_compile_linfo(mi, src, world, &jl_default_cgparams);
+            if (native == NULL || native == codeinst) {
+                // codegen failed, or it landed on the interpreted instance
+                // itself (whose invoke we must not clear under racing
+                // callers): keep interpreting, it is a missed optimization
+                continue;
+            }
+            natives[i] = native; // rooted through mi->cache via roots[i]
+            if (native->functionObjectsDecls.functionObject)
+                fnames[nf++] = native->functionObjectsDecls.functionObject;
+        }
+        if (nf)
+            jl_finalize_function_batch(fnames, nf);
+        for (size_t i = 0; i < n; i++) {
+            jl_code_instance_t *native = natives[i];
+            if (native == NULL)
+                continue;
+            jl_generate_fptr(native);
+            jl_callptr_t invoke = native->invoke;
+            if (invoke != NULL && invoke != jl_fptr_interpret_call &&
+                invoke != jl_fptr_tiered_call) {
+                // publish invoke last: racing callers that still see the
+                // trampoline will take one more trip through the interpreter
+                jl_code_instance_t *codeinst = (jl_code_instance_t*)roots[i];
+                codeinst->specptr = native->specptr;
+                codeinst->rettype_const = native->rettype_const;
+                if (codeinst->rettype_const)
+                    jl_gc_wb(codeinst, codeinst->rettype_const);
+                codeinst->invoke = invoke;
+                JL_LOCK_NOGC(&tiered_lock);
+                ptrhash_remove(&tiered_call_counts, codeinst);
+                JL_UNLOCK_NOGC(&tiered_lock);
+            }
+        }
+        jl_set_jit_opt_level_boost(-1);
+        JL_GC_POP();
+    }
+}
+
 jl_code_instance_t *jl_compile_method_internal(jl_method_instance_t *mi, size_t world)
 {
     jl_code_instance_t *codeinst;
@@ -1758,6 +2271,39 @@ jl_code_instance_t *jl_compile_method_internal(jl_method_instance_t *mi, size_t
         }
     }
 
+    // package precompile (--incremental --output-ji) saves only inference
+    // results: any native code emitted now dies with this process, so run
+    // inference for the cache file and then interpret instead of paying
+    // LLVM codegen for every method executed during module definition
+    if (jl_options.incremental && jl_options.outputji &&
+        !jl_options.outputo && !jl_options.outputbc && !jl_options.outputunoptbc &&
+        jl_is_method(mi->def.method)) {
+        if (!jl_rettype_inferred(mi, world, world) &&
+            jl_symbol_name(mi->def.method->name)[0] != '@')
+            jl_type_infer(mi, world, 0);
+        jl_code_info_t *src = jl_code_for_interpreter(mi);
+        if (!jl_code_requires_compiler(src)) {
+            jl_code_instance_t *codeinst = jl_set_method_inferred(mi, (jl_value_t*)jl_any_type, NULL, NULL,
+                0, 1, ~(size_t)0);
+            codeinst->invoke = jl_fptr_interpret_call;
+            return codeinst;
+        }
+        // requires the compiler (e.g. foreigncall): take the synchronous path
+    }
+
+    if (__unlikely(jl_tiered_threshold() > 0) && jl_is_method(mi->def.method)) {
+        // tiered mode: start interpretable methods in the interpreter and let
+        // the call counter decide which ones deserve native code
+        jl_code_info_t *src = jl_code_for_interpreter(mi);
+        if (!jl_code_requires_compiler(src)) {
+            jl_code_instance_t *codeinst = jl_set_method_inferred(mi, (jl_value_t*)jl_any_type, NULL, NULL,
+                0, 1, ~(size_t)0);
+            codeinst->invoke = jl_fptr_tiered_call;
+            return codeinst;
+        }
+        // requires the compiler (e.g. foreigncall): take the synchronous path
+    }
+
     codeinst = mi->cache;
     while (codeinst) {
         if (codeinst->min_world <= world && world <= codeinst->max_world && codeinst->functionObjectsDecls.functionObject != NULL)
@@ -1828,6 +2374,8 @@ JL_DLLEXPORT int32_t jl_invoke_api(jl_code_instance_t *codeinst)
         return 3;
     if (f == &jl_fptr_interpret_call)
         return 4;
+    if (f == &jl_fptr_tiered_call)
+        return 4; // still interpreting, until the background compile lands
     return -1;
 }
 
@@ -2073,7 +2621,8 @@ void call_cache_stats()
 #endif
 
 STATIC_INLINE jl_method_instance_t *jl_lookup_generic_(jl_value_t **args, uint32_t nargs,
-                                                       uint32_t callsite, size_t world)
+                                                       uint32_t callsite, size_t world,
+                                                       jl_callsite_cache_t *site)
 {
 #ifdef JL_GF_PROFILE
     ncalls++;
@@ -2103,21 +2652,39 @@ STATIC_INLINE jl_method_instance_t *jl_lookup_generic_(jl_value_t **args, uint32
         (callsite >> 8) & (N_CALL_CACHE - 1),
         (callsite >> 16) & (N_CALL_CACHE - 1),
         (callsite >> 24 | callsite << 8) & (N_CALL_CACHE - 1)};
+    jl_ptls_t ptls = jl_get_ptls_states();
+    uint32_t tls_idx[4] = {
+        cache_idx[0] & (N_CALL_CACHE_TLS - 1),
+        cache_idx[1] & (N_CALL_CACHE_TLS - 1),
+        cache_idx[2] & (N_CALL_CACHE_TLS - 1),
+        cache_idx[3] & (N_CALL_CACHE_TLS - 1)};
     jl_typemap_entry_t *entry = NULL;
     jl_methtable_t *mt = NULL;
     int i;
-    // check each cache entry to see if it matches
-    //#pragma unroll
-    //for (i = 0; i < 4; i++) {
-    //    LOOP_BODY(i);
-    //}
+    // check each cache entry to see if it matches, probing the
+    // thread-private cache first: hits there never touch shared memory
+#define LOOP_BODY(_i) do { \
+            i = _i; \
+            entry = ptls->call_cache[tls_idx[i]]; \
+            if (entry && nargs == jl_svec_len(entry->sig->parameters) && \
+                sig_match_fast(args, jl_svec_data(entry->sig->parameters), 0, nargs) && \
+                world >= entry->min_world && world <= entry->max_world) { \
+                goto cache_site_entry; \
+            } \
+        } while (0);
+    LOOP_BODY(0);
+    LOOP_BODY(1);
+    LOOP_BODY(2);
+    LOOP_BODY(3);
+#undef LOOP_BODY
+    // then the shared table; hits get promoted into the thread cache
 #define LOOP_BODY(_i) do { \
             i = _i; \
             entry = call_cache[cache_idx[i]]; \
             if (entry && nargs == jl_svec_len(entry->sig->parameters) && \
                 sig_match_fast(args, jl_svec_data(entry->sig->parameters), 0, nargs) && \
                 world >= entry->min_world && world <= entry->max_world) { \
-                goto have_entry; \
+                goto cache_tls_entry; \
             } \
         } while (0);
     LOOP_BODY(0);
@@ -2136,12 +2703,20 @@ STATIC_INLINE jl_method_instance_t *jl_lookup_generic_(jl_value_t **args, uint32
             // put the entry into the cache if it's valid for a leafsig lookup,
             // using pick_which to slightly randomize where it ends up
             call_cache[cache_idx[++pick_which[cache_idx[0]] & 3]] = entry;
-            goto have_entry;
+            goto cache_tls_entry;
         }
     }
 
     jl_method_instance_t *mfunc;
     if (entry) {
+        goto have_entry;
+cache_tls_entry:
+        // only reached with a leafsig entry; private store, no ordering needed
+        ptls->call_cache[tls_idx[++ptls->call_cache_pick_which & 3]] = entry;
+cache_site_entry:
+        // remember leafsig matches in the per-callsite cache too, if we have one
+        if (site)
+            site->entries[++site->pick_which & (N_SITE_CACHE - 1)] = entry;
 have_entry:
         mfunc = entry->func.linfo;
     }
@@ -2174,7 +2749,7 @@ have_entry:
 jl_method_instance_t *jl_lookup_generic(jl_value_t **args, uint32_t nargs, uint32_t callsite,
                                         size_t world)
 {
-    return jl_lookup_generic_(args, nargs, callsite, world);
+    return jl_lookup_generic_(args, nargs, callsite, world, NULL);
 }
 
 JL_DLLEXPORT jl_value_t *jl_apply_generic(jl_value_t **args, uint32_t nargs)
@@ -2182,7 +2757,102 @@ JL_DLLEXPORT jl_value_t *jl_apply_generic(jl_value_t **args, uint32_t nargs)
     size_t world = jl_get_ptls_states()->world_age;
     jl_method_instance_t *mfunc = jl_lookup_generic_(args, nargs,
                                                      jl_int32hash_fast(jl_return_address()),
-                                                     world);
+                                                     world, NULL);
+    JL_GC_PROMISE_ROOTED(mfunc);
+    jl_value_t *res;
+    // manually inline key parts of jl_invoke:
+    jl_code_instance_t *codeinst = mfunc->cache;
+    while (codeinst) {
+        if (codeinst->min_world <= world && world <= codeinst->max_world && codeinst->invoke != NULL) {
+            res = codeinst->invoke(codeinst, args, nargs);
+            return verify_type(res);
+        }
+        codeinst = codeinst->next;
+    }
+    codeinst = jl_compile_method_internal(mfunc, world);
+    res = codeinst->invoke(codeinst, args, nargs);
+    return verify_type(res);
+}
+
+// all per-callsite dispatch caches ever allocated, so the GC can find them
+jl_callsite_cache_t *callsite_caches = NULL;
+
+jl_callsite_cache_t *jl_new_callsite_cache(void)
+{
+    jl_callsite_cache_t *site = (jl_callsite_cache_t*)calloc(1, sizeof(jl_callsite_cache_t));
+    // only called from codegen, which serializes us behind the codegen lock
+    site->next = callsite_caches;
+    callsite_caches = site;
+    return site;
+}
+
+// like jl_apply_generic, but with a per-callsite cache allocated by codegen.
+// unlike the hash-indexed global table, the site entries can only be evicted
+// by signatures actually seen at this call, so unrelated sites never
+// interfere with each other.
+JL_DLLEXPORT jl_value_t *jl_apply_generic_site(jl_value_t *cache, jl_value_t **args, uint32_t nargs)
+{
+    jl_callsite_cache_t *site = (jl_callsite_cache_t*)cache;
+    size_t world = jl_get_ptls_states()->world_age;
+    jl_method_instance_t *mfunc = NULL;
+    int i;
+    for (i = 0; i < N_SITE_CACHE; i++) {
+        // entries only ever hold leafsig matches, installed by jl_lookup_generic_
+        jl_typemap_entry_t *entry = site->entries[i];
+        if (entry && nargs == jl_svec_len(entry->sig->parameters) &&
+            sig_match_fast(args, jl_svec_data(entry->sig->parameters), 0, nargs) &&
+            world >= entry->min_world && world <= entry->max_world) {
+            mfunc = entry->func.linfo;
+            break;
+        }
+    }
+    if (mfunc == NULL)
+        mfunc = jl_lookup_generic_(args, nargs, jl_int32hash_fast((uintptr_t)site),
+                                   world, site);
+    JL_GC_PROMISE_ROOTED(mfunc);
+    jl_value_t *res;
+    // manually inline key parts of jl_invoke:
+    jl_code_instance_t *codeinst = mfunc->cache;
+    while (codeinst) {
+        if (codeinst->min_world <= world && world <= codeinst->max_world && codeinst->invoke != NULL) {
+            res = codeinst->invoke(codeinst, args, nargs);
+            return verify_type(res);
+        }
+        codeinst = codeinst->next;
+    }
+    codeinst = jl_compile_method_internal(mfunc, world);
+    res = codeinst->invoke(codeinst, args, nargs);
+    return verify_type(res);
+}
+
+// monomorphic per-statement variant for the interpreter: `slot` is a single
+// GC-rooted cache slot owned by the interpreted frame, remembering the
+// typemap entry the statement dispatched to last time
+JL_DLLEXPORT jl_value_t *jl_apply_generic_stmt(jl_value_t **slot, jl_value_t **args, uint32_t nargs)
+{
+    size_t world = jl_get_ptls_states()->world_age;
+    jl_typemap_entry_t *entry = (jl_typemap_entry_t*)*slot;
+    jl_method_instance_t *mfunc = NULL;
+    if (entry != NULL && nargs == jl_svec_len(entry->sig->parameters) &&
+        sig_match_fast(args, jl_svec_data(entry->sig->parameters), 0, nargs) &&
+        world >= entry->min_world && world <= entry->max_world) {
+        mfunc = entry->func.linfo;
+    }
+    if (mfunc == NULL) {
+        jl_callsite_cache_t site;
+        memset(&site, 0, sizeof(site));
+        mfunc = jl_lookup_generic_(args, nargs, jl_int32hash_fast(jl_return_address()),
+                                   world, &site);
+        int i;
+        for (i = 0; i < N_SITE_CACHE; i++) {
+            // keep the leafsig entry (if any) captured from the lookup;
+            // the frame's slot roots it, no write barrier needed
+            if (site.entries[i] != NULL) {
+                *slot = (jl_value_t*)site.entries[i];
+                break;
+            }
+        }
+    }
     JL_GC_PROMISE_ROOTED(mfunc);
     jl_value_t *res;
     // manually inline key parts of jl_invoke:
@@ -2334,19 +3004,21 @@ jl_function_t *jl_new_generic_function_with_supertype(jl_sym_t *name, jl_module_
 {
     // type name is function name prefixed with #
     size_t l = strlen(jl_symbol_name(name));
+    arena_t *scratch = &jl_get_ptls_states()->scratch_arena;
+    arena_mark_t mark = arena_save(scratch);
     char *prefixed;
     if (iskw) {
-        prefixed = (char*)malloc(l+5);
+        prefixed = (char*)arena_alloc(scratch, l+5);
         strcpy(&prefixed[0], "#kw#");
         strcpy(&prefixed[4], jl_symbol_name(name));
     }
     else {
-        prefixed = (char*)malloc(l+2);
+        prefixed = (char*)arena_alloc(scratch, l+2);
         prefixed[0] = '#';
         strcpy(&prefixed[1], jl_symbol_name(name));
     }
     jl_sym_t *tname = jl_symbol(prefixed);
-    free(prefixed);
+    arena_restore(scratch, mark);
     jl_datatype_t *ftype = (jl_datatype_t*)jl_new_datatype(
             tname, module, st, jl_emptysvec, jl_emptysvec, jl_emptysvec, 0, 0, 0);
     assert(jl_is_datatype(ftype));
@@ -652,6 +652,64 @@ static void jl_set_io_wait(int v)
     ptls->io_wait = v;
 }
 
+// --trace-startup: record the wall time spent in each phase of _julia_init
+// and emit them as chrome-trace (catapult) complete events, one "X" event per
+// phase, so regressions can be eyeballed in about:tracing / Perfetto
+typedef struct {
+    const char *name;
+    uint64_t t0;
+    uint64_t t1;
+} jl_startup_phase_t;
+
+#define JL_STARTUP_MAX_PHASES 128
+static jl_startup_phase_t startup_phases[JL_STARTUP_MAX_PHASES];
+static int startup_nphases = 0;
+
+static void jl_startup_phase_end(void)
+{
+    if (startup_nphases > 0 && startup_phases[startup_nphases - 1].t1 == 0)
+        startup_phases[startup_nphases - 1].t1 = jl_hrtime();
+}
+
+// close the previous phase (if any) and open a new one; `name` must outlive
+// the init sequence
+static void jl_startup_phase(const char *name)
+{
+    if (!jl_options.trace_startup || startup_nphases >= JL_STARTUP_MAX_PHASES)
+        return;
+    jl_startup_phase_end();
+    startup_phases[startup_nphases].name = name;
+    startup_phases[startup_nphases].t0 = jl_hrtime();
+    startup_phases[startup_nphases].t1 = 0;
+    startup_nphases++;
+}
+
+static void jl_write_startup_trace(void)
+{
+    if (!jl_options.trace_startup)
+        return;
+    jl_startup_phase_end();
+    ios_t f;
+    if (ios_file(&f, jl_options.trace_startup, 0, 1, 1, 1) == NULL) {
+        jl_printf(JL_STDERR, "WARNING: could not open startup trace file \"%s\"\n",
+                  jl_options.trace_startup);
+        return;
+    }
+    uint64_t t0 = startup_nphases ? startup_phases[0].t0 : 0;
+    ios_printf(&f, "[\n");
+    int i;
+    for (i = 0; i < startup_nphases; i++) {
+        jl_startup_phase_t *p = &startup_phases[i];
+        ios_printf(&f, "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":1,"
+                       "\"ts\":%.3f,\"dur\":%.3f}%s\n",
+                   p->name,
+                   (p->t0 - t0) / 1e3, (p->t1 - p->t0) / 1e3, // ns -> us
+                   i + 1 < startup_nphases ? "," : "");
+    }
+    ios_printf(&f, "]\n");
+    ios_close(&f);
+}
+
 void _julia_init(JL_IMAGE_SEARCH rel)
 {
     jl_init_timing();
@@ -663,6 +721,7 @@ void _julia_init(JL_IMAGE_SEARCH rel)
     (void)ptls; assert(ptls); // make sure early that we have initialized ptls
     jl_safepoint_init();
     libsupport_init();
+    jl_startup_phase("uv and stdio init");
     htable_new(&jl_current_modules, 0);
     ios_set_io_wait_func = jl_set_io_wait;
     jl_io_loop = uv_default_loop(); // this loop will internal events (spawning process etc.),
@@ -677,6 +736,25 @@ void _julia_init(JL_IMAGE_SEARCH rel)
         total_mem = (size_t)-1;
     }
     jl_arr_xtralloc_limit = total_mem / 100;  // Extra allocation limited to 1% of total RAM
+    {   // array growth policy knobs (see array.c)
+        char *pct = getenv("JULIA_ARRAY_GROWTH_PCT");
+        if (pct) {
+            jl_arr_growth_pct = (size_t)atol(pct);
+            if (jl_arr_growth_pct < 110)
+                jl_arr_growth_pct = 110;
+        }
+        char *thresh = getenv("JULIA_ARRAY_GROWTH_THRESHOLD");
+        if (thresh)
+            jl_arr_growth_thresh = (size_t)atol(thresh);
+        char *ntthresh = getenv("JULIA_NT_COPY_THRESHOLD");
+        if (ntthresh) {
+            jl_nt_copy_thresh = (size_t)atol(ntthresh);
+            // 0 disables; otherwise keep the streaming path's alignment
+            // head and 64-byte block loop in bounds
+            if (jl_nt_copy_thresh && jl_nt_copy_thresh < 64)
+                jl_nt_copy_thresh = 64;
+        }
+    }
     jl_prep_sanitizers();
     void *stack_lo, *stack_hi;
     jl_init_stack_limits(1, &stack_lo, &stack_hi);
@@ -746,12 +824,15 @@ void _julia_init(JL_IMAGE_SEARCH rel)
         jl_error("cannot generate code-coverage or track allocation information while generating a .o or .bc output file");
     }
 
+    jl_startup_phase("threading init");
     jl_init_threading();
     jl_init_intrinsic_properties();
 
+    jl_startup_phase("gc init");
     jl_gc_init();
     jl_gc_enable(0);
 
+    jl_startup_phase("sysimage load");
     jl_resolve_sysimg_location(rel);
     // loads sysimg if available, and conditionally sets jl_options.cpu_target
     if (jl_options.image_file)
@@ -768,6 +849,7 @@ void _julia_init(JL_IMAGE_SEARCH rel)
         jl_init_codegen();
     }
 
+    jl_startup_phase("tasks and frontend init");
     jl_init_tasks();
     jl_init_root_task(stack_lo, stack_hi);
 #ifdef ENABLE_TIMINGS
@@ -779,6 +861,7 @@ void _julia_init(JL_IMAGE_SEARCH rel)
     jl_init_serializer();
 
     if (!jl_options.image_file) {
+        jl_startup_phase("boot.jl");
         jl_core_module = jl_new_module(jl_symbol("Core"));
         jl_type_typename->mt->module = jl_core_module;
         jl_top_module = jl_core_module;
@@ -789,6 +872,7 @@ void _julia_init(JL_IMAGE_SEARCH rel)
         post_boot_hooks();
     }
 
+    jl_startup_phase("standard imports and thread start");
     // the Main module is the one which is always open, and set as the
     // current module for bare (non-module-wrapped) toplevel expressions.
     // it does "using Base" if Base is available.
@@ -822,6 +906,15 @@ void _julia_init(JL_IMAGE_SEARCH rel)
         int i, l = jl_array_len(init_order);
         for (i = 0; i < l; i++) {
             jl_value_t *mod = jl_array_ptr_ref(init_order, i);
+            if (jl_options.trace_startup) {
+                const char *mname = jl_symbol_name(((jl_module_t*)mod)->name);
+                char *pname = (char*)malloc(strlen(mname) + sizeof("__init__ "));
+                if (pname) {
+                    strcpy(pname, "__init__ ");
+                    strcat(pname, mname);
+                    jl_startup_phase(pname); // leaked: must outlive the trace dump
+                }
+            }
             jl_module_run_initializer((jl_module_t*)mod);
         }
         JL_GC_POP();
@@ -829,6 +922,8 @@ void _julia_init(JL_IMAGE_SEARCH rel)
 
     if (jl_options.handle_signals == JL_OPTIONS_HANDLE_SIGNALS_ON)
         jl_install_sigint_handler();
+
+    jl_write_startup_trace();
 }
 
 static jl_value_t *core(const char *name)
@@ -884,6 +979,7 @@ static void post_boot_hooks(void)
 
     // set module field of primitive types
     int i;
+    jl_module_ensure_bindings(jl_core_module);
     void **table = jl_core_module->bindings.table;
     for (i = 1; i < jl_core_module->bindings.size; i += 2) {
         if (table[i] != HT_NOTFOUND) {
@@ -14,6 +14,39 @@
 extern "C" {
 #endif
 
+// eval_body dispatches on statement kind; classifying each statement once per
+// frame lets the main loop dispatch through a dense jump table instead of
+// re-running the head-symbol comparison chain on every (re-)execution.
+enum interp_stmt_opcode {
+    ISTMT_GENERIC = 0, // no special statement-position handling: eval_stmt_value
+    ISTMT_GOTO,
+    ISTMT_UPSILON,
+    ISTMT_RETURN,
+    ISTMT_ASSIGN,
+    ISTMT_GOTOIFNOT,
+    ISTMT_ENTER,
+    ISTMT_LEAVE,
+    ISTMT_POPEXC,
+    ISTMT_NEWVAR,
+    ISTMT_LINENO,
+    ISTMT_EXPR_OTHER // exprs handled specially only at toplevel
+};
+
+#define INTERP_BINDING_CACHE_SIZE 8 // entries, direct-mapped; must be a power of two
+
+// Per-frame scratch computed at frame entry: the preprocessed opcode stream
+// for eval_body and a small cache of resolved global bindings. Lives on the
+// callback's C stack; interpreter_state itself cannot grow freely because its
+// size is capped by the hand-written enter_interpreter_frame asm.
+typedef struct {
+    const uint8_t *ops; // one interp_stmt_opcode per statement, or NULL
+    jl_value_t **sites; // one GC-rooted dispatch-cache slot per statement, or NULL
+    struct {
+        jl_value_t *ref; // GlobalRef (or Symbol) node as it appears in the IR
+        jl_binding_t *bnd; // resolved binding for that node
+    } bcache[INTERP_BINDING_CACHE_SIZE];
+} interp_cache_t;
+
 typedef struct {
     jl_code_info_t *src; // contains the names and number of slots
     jl_method_instance_t *mi; // MethodInstance we're executing, or NULL if toplevel
@@ -23,6 +56,7 @@ typedef struct {
     size_t ip; // Leak the currently-evaluating statement index to backtrace capture
     int preevaluation; // use special rules for pre-evaluating expressions (deprecated--only for ccall handling)
     int continue_at; // statement index to jump to after leaving exception handler (0 if none)
+    interp_cache_t *cache; // per-frame preprocessed statements and binding cache, or NULL
 } interpreter_state;
 
 #include "interpreter-stacktrace.c"
@@ -323,7 +357,15 @@ SECT_INTERP static jl_value_t *do_call(jl_value_t **args, size_t nargs, interpre
     size_t i;
     for (i = 0; i < nargs; i++)
         argv[i] = eval_value(args[i], s);
-    jl_value_t *result = jl_apply_generic(argv, nargs);
+    jl_value_t *result;
+    // dispatch through the statement's cache slot if this frame has them, so
+    // interpreted loops remember what the same statement resolved to last
+    // time; the slot is verified against the actual argument types, so
+    // nested calls sharing a statement stay correct
+    if (s->cache != NULL && s->cache->sites != NULL)
+        result = jl_apply_generic_stmt(&s->cache->sites[s->ip], argv, nargs);
+    else
+        result = jl_apply_generic(argv, nargs);
     JL_GC_POP();
     return result;
 }
@@ -366,6 +408,82 @@ SECT_INTERP static void eval_stmt_value(jl_value_t *stmt, interpreter_state *s)
     s->locals[jl_source_nslots(s->src) + s->ip] = res;
 }
 
+// Global reads go through jl_get_binding on every execution, re-hashing the
+// module binding table each time a loop re-reads the same global. Cache the
+// resolved binding per frame, keyed on the identity of the GlobalRef (or
+// Symbol) node in the IR: resolved jl_binding_t are interned in the module
+// binding table and live as long as the module, so a repeat read is a single
+// load of b->value. Compiled code resolves bindings once at codegen time and
+// keeps them for the life of the code instance; caching for the duration of
+// one interpreter frame is strictly shorter-lived than that.
+SECT_INTERP static jl_value_t *eval_global(jl_value_t *e, jl_module_t *modu,
+                                           jl_sym_t *sym, interpreter_state *s)
+{
+    jl_binding_t *b = NULL;
+    if (s->cache != NULL) {
+        size_t i = ((uintptr_t)e / sizeof(void*)) & (INTERP_BINDING_CACHE_SIZE - 1);
+        if (s->cache->bcache[i].ref == e) {
+            b = s->cache->bcache[i].bnd;
+        }
+        else {
+            b = jl_get_binding(modu, sym);
+            if (b != NULL) {
+                s->cache->bcache[i].ref = e;
+                s->cache->bcache[i].bnd = b;
+            }
+        }
+    }
+    else {
+        b = jl_get_binding(modu, sym);
+    }
+    if (b != NULL && b->deprecated)
+        jl_binding_deprecation_warning(modu, b);
+    jl_value_t *v = (b == NULL) ? NULL : b->value;
+    if (v == NULL)
+        jl_undefined_var_error(sym);
+    return v;
+}
+
+SECT_INTERP static uint8_t interp_stmt_op(jl_value_t *stmt) JL_NOTSAFEPOINT
+{
+    if (jl_is_expr(stmt)) {
+        jl_sym_t *head = ((jl_expr_t*)stmt)->head;
+        if (head == return_sym)
+            return ISTMT_RETURN;
+        if (head == assign_sym)
+            return ISTMT_ASSIGN;
+        if (head == goto_ifnot_sym)
+            return ISTMT_GOTOIFNOT;
+        if (head == enter_sym)
+            return ISTMT_ENTER;
+        if (head == leave_sym)
+            return ISTMT_LEAVE;
+        if (head == pop_exception_sym)
+            return ISTMT_POPEXC;
+        return ISTMT_EXPR_OTHER;
+    }
+    if (jl_is_gotonode(stmt))
+        return ISTMT_GOTO;
+    if (jl_is_upsilonnode(stmt))
+        return ISTMT_UPSILON;
+    if (jl_is_newvarnode(stmt))
+        return ISTMT_NEWVAR;
+    if (jl_is_linenode(stmt))
+        return ISTMT_LINENO;
+    return ISTMT_GENERIC;
+}
+
+SECT_INTERP static void interp_cache_init(interp_cache_t *cache, uint8_t *ops,
+                                          jl_array_t *stmts, jl_value_t **sites) JL_NOTSAFEPOINT
+{
+    size_t i, ns = jl_array_len(stmts);
+    for (i = 0; i < ns; i++)
+        ops[i] = interp_stmt_op(jl_array_ptr_ref(stmts, i));
+    cache->ops = ops;
+    cache->sites = sites;
+    memset(cache->bcache, 0, sizeof(cache->bcache));
+}
+
 SECT_INTERP static jl_value_t *eval_value(jl_value_t *e, interpreter_state *s)
 {
     jl_code_info_t *src = s->src;
@@ -389,10 +507,10 @@ SECT_INTERP static jl_value_t *eval_value(jl_value_t *e, interpreter_state *s)
         return jl_quotenode_value(e);
     }
     if (jl_is_globalref(e)) {
-        return jl_eval_global_var(jl_globalref_mod(e), jl_globalref_name(e));
+        return eval_global(e, jl_globalref_mod(e), jl_globalref_name(e), s);
     }
     if (jl_is_symbol(e)) {  // bare symbols appear in toplevel exprs not wrapped in `thunk`
-        return jl_eval_global_var(s->module, (jl_sym_t*)e);
+        return eval_global(e, s->module, (jl_sym_t*)e, s);
     }
     if (jl_is_pinode(e)) {
         jl_value_t *val = eval_value(jl_fieldref_noalloc(e, 0), s);
@@ -603,6 +721,9 @@ SECT_INTERP static jl_value_t *eval_body(jl_array_t *stmts, interpreter_state *s
 {
     jl_handler_t __eh;
     size_t ns = jl_array_len(stmts);
+    // the opcode stream is preprocessed once at frame entry; recursive calls
+    // (for `enter`) share it through s->cache
+    const uint8_t *ops = s->cache != NULL ? s->cache->ops : NULL;
 
     while (1) {
         s->ip = ip;
@@ -611,13 +732,15 @@ SECT_INTERP static jl_value_t *eval_body(jl_array_t *stmts, interpreter_state *s
         if (toplevel)
             jl_get_ptls_states()->world_age = jl_world_counter;
         jl_value_t *stmt = jl_array_ptr_ref(stmts, ip);
-        assert(!jl_is_phinode(stmt));
-        size_t next_ip = ip + 1;
         assert(!jl_is_phinode(stmt) && !jl_is_phicnode(stmt) && "malformed AST");
-        if (jl_is_gotonode(stmt)) {
+        assert(!jl_is_expr(stmt) || ((jl_expr_t*)stmt)->head != unreachable_sym);
+        size_t next_ip = ip + 1;
+        switch (ops != NULL ? ops[ip] : interp_stmt_op(stmt)) {
+        case ISTMT_GOTO: {
             next_ip = jl_gotonode_label(stmt) - 1;
+            break;
         }
-        else if (jl_is_upsilonnode(stmt)) {
+        case ISTMT_UPSILON: {
             jl_value_t *val = jl_fieldref_noalloc(stmt, 0);
             if (val)
                 val = eval_value(val, s);
@@ -625,51 +748,50 @@ SECT_INTERP static jl_value_t *eval_body(jl_array_t *stmts, interpreter_state *s
             assert(jl_is_ssavalue(phic));
             ssize_t id = ((jl_ssavalue_t*)phic)->id - 1;
             s->locals[jl_source_nslots(s->src) + id] = val;
+            break;
         }
-        else if (jl_is_expr(stmt)) {
-            // Most exprs are allowed to end a BB by fall through
-            jl_sym_t *head = ((jl_expr_t*)stmt)->head;
-            assert(head != unreachable_sym);
-            if (head == return_sym) {
-                return eval_value(jl_exprarg(stmt, 0), s);
+        case ISTMT_RETURN: {
+            return eval_value(jl_exprarg(stmt, 0), s);
+        }
+        case ISTMT_ASSIGN: {
+            jl_value_t *lhs = jl_exprarg(stmt, 0);
+            jl_value_t *rhs = eval_value(jl_exprarg(stmt, 1), s);
+            if (jl_is_slot(lhs)) {
+                ssize_t n = jl_slot_number(lhs);
+                assert(n <= jl_source_nslots(s->src) && n > 0);
+                s->locals[n - 1] = rhs;
             }
-            else if (head == assign_sym) {
-                jl_value_t *lhs = jl_exprarg(stmt, 0);
-                jl_value_t *rhs = eval_value(jl_exprarg(stmt, 1), s);
-                if (jl_is_slot(lhs)) {
-                    ssize_t n = jl_slot_number(lhs);
-                    assert(n <= jl_source_nslots(s->src) && n > 0);
-                    s->locals[n - 1] = rhs;
+            else {
+                jl_module_t *modu;
+                jl_sym_t *sym;
+                if (jl_is_globalref(lhs)) {
+                    modu = jl_globalref_mod(lhs);
+                    sym = jl_globalref_name(lhs);
                 }
                 else {
-                    jl_module_t *modu;
-                    jl_sym_t *sym;
-                    if (jl_is_globalref(lhs)) {
-                        modu = jl_globalref_mod(lhs);
-                        sym = jl_globalref_name(lhs);
-                    }
-                    else {
-                        assert(jl_is_symbol(lhs));
-                        modu = s->module;
-                        sym = (jl_sym_t*)lhs;
-                    }
-                    JL_GC_PUSH1(&rhs);
-                    jl_binding_t *b = jl_get_binding_wr(modu, sym, 1);
-                    jl_checked_assignment(b, rhs);
-                    JL_GC_POP();
+                    assert(jl_is_symbol(lhs));
+                    modu = s->module;
+                    sym = (jl_sym_t*)lhs;
                 }
+                JL_GC_PUSH1(&rhs);
+                jl_binding_t *b = jl_get_binding_wr(modu, sym, 1);
+                jl_checked_assignment(b, rhs);
+                JL_GC_POP();
             }
-            else if (head == goto_ifnot_sym) {
-                jl_value_t *cond = eval_value(jl_exprarg(stmt, 0), s);
-                if (cond == jl_false) {
-                    next_ip = jl_unbox_long(jl_exprarg(stmt, 1)) - 1;
-                }
-                else if (cond != jl_true) {
-                    jl_type_error("if", (jl_value_t*)jl_bool_type, cond);
-                }
+            break;
+        }
+        case ISTMT_GOTOIFNOT: {
+            jl_value_t *cond = eval_value(jl_exprarg(stmt, 0), s);
+            if (cond == jl_false) {
+                next_ip = jl_unbox_long(jl_exprarg(stmt, 1)) - 1;
             }
-            else if (head == enter_sym) {
-                jl_enter_handler(&__eh);
+            else if (cond != jl_true) {
+                jl_type_error("if", (jl_value_t*)jl_bool_type, cond);
+            }
+            break;
+        }
+        case ISTMT_ENTER: {
+            jl_enter_handler(&__eh);
                 // This is a bit tricky, but supports the implementation of PhiC nodes.
                 // They are conceptually slots, but the slot to store to doesn't get explicitly
                 // mentioned in the store (aka the "UpsilonNode") (this makes them integrate more
@@ -711,25 +833,28 @@ SECT_INTERP static jl_value_t *eval_body(jl_array_t *stmts, interpreter_state *s
                     continue;
                 }
             }
-            else if (head == leave_sym) {
-                int hand_n_leave = jl_unbox_long(jl_exprarg(stmt, 0));
-                assert(hand_n_leave > 0);
-                // equivalent to jl_pop_handler(hand_n_leave), but retaining eh for longjmp:
-                jl_ptls_t ptls = jl_get_ptls_states();
-                jl_handler_t *eh = ptls->current_task->eh;
-                while (--hand_n_leave > 0)
-                    eh = eh->prev;
-                jl_eh_restore_state(eh);
-                // leave happens during normal control flow, but we must
-                // longjmp to pop the eval_body call for each enter.
-                s->continue_at = next_ip;
-                jl_longjmp(eh->eh_ctx, 1);
-            }
-            else if (head == pop_exception_sym) {
-                size_t prev_state = jl_unbox_ulong(eval_value(jl_exprarg(stmt, 0), s));
-                jl_restore_excstack(prev_state);
-            }
-            else if (toplevel) {
+        case ISTMT_LEAVE: {
+            int hand_n_leave = jl_unbox_long(jl_exprarg(stmt, 0));
+            assert(hand_n_leave > 0);
+            // equivalent to jl_pop_handler(hand_n_leave), but retaining eh for longjmp:
+            jl_ptls_t ptls = jl_get_ptls_states();
+            jl_handler_t *eh = ptls->current_task->eh;
+            while (--hand_n_leave > 0)
+                eh = eh->prev;
+            jl_eh_restore_state(eh);
+            // leave happens during normal control flow, but we must
+            // longjmp to pop the eval_body call for each enter.
+            s->continue_at = next_ip;
+            jl_longjmp(eh->eh_ctx, 1);
+        }
+        case ISTMT_POPEXC: {
+            size_t prev_state = jl_unbox_ulong(eval_value(jl_exprarg(stmt, 0), s));
+            jl_restore_excstack(prev_state);
+            break;
+        }
+        case ISTMT_EXPR_OTHER: {
+            if (toplevel) {
+                jl_sym_t *head = ((jl_expr_t*)stmt)->head;
                 if (head == method_sym && jl_expr_nargs(stmt) > 1) {
                     eval_methoddef((jl_expr_t*)stmt, s);
                 }
@@ -760,19 +885,28 @@ SECT_INTERP static jl_value_t *eval_body(jl_array_t *stmts, interpreter_state *s
             else {
                 eval_stmt_value(stmt, s);
             }
+            break;
         }
-        else if (jl_is_newvarnode(stmt)) {
+        case ISTMT_NEWVAR: {
             jl_value_t *var = jl_fieldref(stmt, 0);
             assert(jl_is_slot(var));
             ssize_t n = jl_slot_number(var);
             assert(n <= jl_source_nslots(s->src) && n > 0);
             s->locals[n - 1] = NULL;
+            break;
         }
-        else if (toplevel && jl_is_linenode(stmt)) {
-            jl_lineno = jl_linenode_line(stmt);
+        case ISTMT_LINENO: {
+            if (toplevel)
+                jl_lineno = jl_linenode_line(stmt);
+            else
+                eval_stmt_value(stmt, s);
+            break;
         }
-        else {
+        default: {
+            assert((ops != NULL ? ops[ip] : interp_stmt_op(stmt)) == ISTMT_GENERIC);
             eval_stmt_value(stmt, s);
+            break;
+        }
         }
         ip = eval_phi(stmts, s, ns, next_ip);
     }
@@ -826,7 +960,8 @@ SECT_INTERP CALLBACK_ABI void *jl_interpret_call_callback(interpreter_state *s,
     jl_array_t *stmts = src->code;
     assert(jl_typeis(stmts, jl_array_any_type));
     jl_value_t **locals;
-    JL_GC_PUSHARGS(locals, jl_source_nslots(src) + jl_source_nssavalues(src) + 2);
+    // the last jl_array_len(stmts) slots root the per-statement dispatch caches
+    JL_GC_PUSHARGS(locals, jl_source_nslots(src) + jl_source_nssavalues(src) + 2 + jl_array_len(stmts));
     locals[0] = (jl_value_t*)src;
     locals[1] = (jl_value_t*)stmts;
     s->src = src;
@@ -847,6 +982,10 @@ SECT_INTERP CALLBACK_ABI void *jl_interpret_call_callback(interpreter_state *s,
     s->preevaluation = 0;
     s->continue_at = 0;
     s->mi = args->mi;
+    interp_cache_t cache;
+    interp_cache_init(&cache, (uint8_t*)alloca(jl_array_len(stmts)), stmts,
+                      s->locals + jl_source_nslots(src) + jl_source_nssavalues(src));
+    s->cache = &cache;
     size_t i;
     for (i = 0; i < nargs; i++) {
         if (isva && i == nargs - 1)
@@ -876,13 +1015,18 @@ SECT_INTERP CALLBACK_ABI void *jl_interpret_toplevel_thunk_callback(interpreter_
     jl_array_t *stmts = args->src->code;
     assert(jl_typeis(stmts, jl_array_any_type));
     jl_value_t **locals;
-    JL_GC_PUSHARGS(locals, jl_source_nslots(args->src) + jl_source_nssavalues(args->src));
+    // the last jl_array_len(stmts) slots root the per-statement dispatch caches
+    JL_GC_PUSHARGS(locals, jl_source_nslots(args->src) + jl_source_nssavalues(args->src) + jl_array_len(stmts));
     s->src = args->src;
     s->locals = locals;
     s->module = args->m;
     s->sparam_vals = jl_emptysvec;
     s->continue_at = 0;
     s->mi = NULL;
+    interp_cache_t cache;
+    interp_cache_init(&cache, (uint8_t*)alloca(jl_array_len(stmts)), stmts,
+                      locals + jl_source_nslots(args->src) + jl_source_nssavalues(args->src));
+    s->cache = &cache;
     size_t last_age = jl_get_ptls_states()->world_age;
     jl_value_t *r = eval_body(stmts, s, 0, 1);
     jl_get_ptls_states()->world_age = last_age;
@@ -917,6 +1061,7 @@ SECT_INTERP CALLBACK_ABI void *jl_interpret_toplevel_expr_in_callback(interprete
     s->preevaluation = (s->sparam_vals != NULL);
     s->continue_at = 0;
     s->mi = NULL;
+    s->cache = NULL;
     jl_value_t *v = eval_value(args->e, s);
     assert(v);
     return (void*)v;
@@ -45,6 +45,7 @@ namespace llvm {
 
 #include <llvm/IR/LegacyPassManagers.h>
 #include <llvm/IR/IRPrintingPasses.h>
+#include <llvm/Support/Compression.h>
 #include <llvm/Transforms/Utils/Cloning.h>
 #include "llvm/Object/ArchiveWriter.h"
 
@@ -78,6 +79,13 @@ static Type *T_psize;
 static Type *T_pjlvalue;
 void jl_init_jit(Type *T_pjlvalue_)
 {
+    // JULIA_LLVM_TIME_PASSES=1 turns on LLVM's per-pass wall/CPU timers for
+    // the JIT pipeline; each compile prints its per-module breakdown (see
+    // CompilerT) while the pipeline as a whole stays accounted to the
+    // LLVM_OPT owner of the src/timing.h framework.
+    if (char *env = getenv("JULIA_LLVM_TIME_PASSES"))
+        if (env[0] && env[0] != '0')
+            llvm::TimePassesIsEnabled = true;
     T_uint32 = Type::getInt32Ty(jl_LLVMContext);
     T_uint64 = Type::getInt64Ty(jl_LLVMContext);
     if (sizeof(size_t) == 8)
@@ -192,6 +200,10 @@ void addOptimizationPasses(legacy::PassManagerBase *PM, int opt_level,
     // Subsequent passes not stripping metadata from terminator
     PM->add(createInstructionCombiningPass());
     PM->add(createIndVarSimplifyPass());       // Canonicalize indvars
+    // Hoist monotone bounds checks out of counted loops: the iteration space
+    // is split so the main loop runs without the per-access branch, keyed off
+    // the cold branch weights codegen puts on the bounds-check failure edges.
+    PM->add(createInductiveRangeCheckEliminationPass());
     PM->add(createLoopDeletionPass());         // Delete dead loops
     PM->add(createSimpleLoopUnrollPass());     // Unroll small loops
     //PM->add(createLoopStrengthReducePass());   // (jwb added)
@@ -232,6 +244,8 @@ void addOptimizationPasses(legacy::PassManagerBase *PM, int opt_level,
     PM->add(createInstructionCombiningPass());  // Clean up after SLP loop vectorizer
     PM->add(createLoopVectorizePass());         // Vectorize loops
     PM->add(createInstructionCombiningPass());  // Clean up after loop vectorizer
+    // Remove write barriers proven redundant, before they are lowered
+    PM->add(createBarrierElisionPass());
 
     if (lower_intrinsics) {
         // LowerPTLS removes an indirect call. As a result, it is likely to trigger
@@ -247,6 +261,8 @@ void addOptimizationPasses(legacy::PassManagerBase *PM, int opt_level,
         // Clean up write barrier and ptls lowering
         PM->add(createCFGSimplificationPass());
     }
+    // Needs to run after the vectorizers so that vector mul+add chains get
+    // their `contract` flags too.
     PM->add(createCombineMulAddPass());
 }
 
@@ -358,16 +374,70 @@ void JuliaOJIT::DebugObjectRegistrar::operator()(RTDyldObjHandleT H,
 }
 
 
+// When >= 0, compile at this optimization level if it exceeds the process
+// level. Set around the tiered-execution promotion of hot method instances
+// (see gf.c) so they get full optimization even under -O0/-O1. The unlocked
+// read below can at worst boost an unrelated concurrent compile, which only
+// costs compile time, never correctness.
+static volatile int jit_opt_level_boost = -1;
+extern "C" JL_DLLEXPORT void jl_set_jit_opt_level_boost(int level)
+{
+    jit_opt_level_boost = level;
+}
+
+// whether the current compile was identified as hot by the tiered call
+// counter; the code memory manager uses this to partition code placement
+extern "C" JL_DLLEXPORT int jl_jit_compiling_hot_code(void)
+{
+    return jit_opt_level_boost > 0;
+}
+
+// When set, JIT compiles use the fast (-O1 style) pipeline regardless of the
+// process opt level, e.g. around package load where most code runs once.
+// Hot methods promoted by the tiered counter still get the full pipeline
+// through the boost above. Same unlocked-read caveat as the boost.
+static volatile int jit_pipeline_fast = 0;
+extern "C" JL_DLLEXPORT void jl_set_jit_pipeline_fast(int enable)
+{
+    jit_pipeline_fast = enable;
+}
+
 CompilerResultT JuliaOJIT::CompilerT::operator()(Module &M)
 {
     JL_TIMING(LLVM_OPT);
-    jit.PM.run(M);
+    // Build the pipeline and output buffer per-compile rather than sharing
+    // them across the JIT, so that running the optimizer and MC emission does
+    // not mutate any JuliaOJIT state. Compilation is still serialized by the
+    // codegen lock, but only because IR emission shares jl_LLVMContext --
+    // this stage itself is now reentrant.
+    SmallVector<char, 4096> ObjBufferSV;
+    raw_svector_ostream ObjStream(ObjBufferSV);
+    legacy::PassManager PM;
+    MCContext *Ctx;
+    int opt_level = jl_generating_output() ? 0 : jl_options.opt_level;
+    if (jit_pipeline_fast && opt_level > 1)
+        opt_level = 1;
+    int boost = jit_opt_level_boost;
+    if (boost > opt_level)
+        opt_level = boost;
+    addTargetPasses(&PM, &jit.TM);
+    addOptimizationPasses(&PM, opt_level);
+    if (jit.TM.addPassesToEmitMC(PM, Ctx, ObjStream))
+        llvm_unreachable("Target does not support MC emission.");
+    PM.run(M);
+#if JL_LLVM_VERSION >= 70000
+    if (llvm::TimePassesIsEnabled) {
+        errs() << "== LLVM pass timings for " << M.getName() << "\n";
+        reportAndResetTimings();
+    }
+#endif
+    // (before LLVM 7 the aggregate pass timers print once at process exit)
 #if JL_LLVM_VERSION >= 70000
     std::unique_ptr<MemoryBuffer> ObjBuffer(
-        new SmallVectorMemoryBuffer(std::move(jit.ObjBufferSV)));
+        new SmallVectorMemoryBuffer(std::move(ObjBufferSV)));
 #else
     std::unique_ptr<MemoryBuffer> ObjBuffer(
-        new ObjectMemoryBuffer(std::move(jit.ObjBufferSV)));
+        new ObjectMemoryBuffer(std::move(ObjBufferSV)));
 #endif
     auto Obj = object::ObjectFile::createObjectFile(ObjBuffer->getMemBufferRef());
 
@@ -391,7 +461,6 @@ CompilerResultT JuliaOJIT::CompilerT::operator()(Module &M)
 JuliaOJIT::JuliaOJIT(TargetMachine &TM)
   : TM(TM),
     DL(TM.createDataLayout()),
-    ObjStream(ObjBufferSV),
     MemMgr(createRTDyldMemoryManager()),
     registrar(*this),
 #if JL_LLVM_VERSION >= 70000
@@ -425,11 +494,6 @@ JuliaOJIT::JuliaOJIT(TargetMachine &TM)
             CompilerT(this)
         )
 {
-    addTargetPasses(&PM, &TM);
-    addOptimizationPasses(&PM, jl_generating_output() ? 0 : jl_options.opt_level);
-    if (TM.addPassesToEmitMC(PM, Ctx, ObjStream))
-        llvm_unreachable("Target does not support MC emission.");
-
     // Make sure SectionMemoryManager::getSymbolAddressInProcess can resolve
     // symbols in the program as well. The nullptr argument to the function
     // tells DynamicLibrary to load the program, not a library.
@@ -464,6 +528,13 @@ void *JuliaOJIT::getPointerToGlobalIfAvailable(const GlobalValue *GV)
 }
 
 
+// N.B.: the object buffers produced here cannot be persisted across
+// processes. Outside imaging mode, codegen embeds jl_value_t* heap addresses
+// directly into the instruction stream as immediate constants
+// (literal_static_pointer_val in cgutils.cpp) with no relocation records, so
+// a cached object would silently reference another process's heap layout.
+// Ahead-of-time reuse of native code requires compiling under imaging_mode,
+// which is what system image generation does.
 void JuliaOJIT::addModule(std::unique_ptr<Module> M)
 {
 #ifndef JL_NDEBUG
@@ -793,6 +864,34 @@ static void jl_merge_recursive(Module *m, Module *collector)
     }
 }
 
+// Merge the dependency closures of several pending functions into a single
+// module and hand it to the execution engine once, instead of paying the
+// optimization pipeline setup, object emission and memory-manager costs per
+// method. The tiered background drain uses this for its batch of promoted
+// methods; names with no pending module (already added, or the jl_fptr_args /
+// jl_fptr_sparam builtins) are skipped.
+extern "C" JL_DLLEXPORT void jl_finalize_function_batch(const char **fnames, size_t n)
+{
+    JL_LOCK(&codegen_lock);
+    std::unique_ptr<Module> batch;
+    for (size_t i = 0; i < n; i++) {
+        std::unique_ptr<Module> m(module_for_fname.lookup(fnames[i]));
+        if (!m)
+            continue;
+        if (!batch) {
+            batch = std::move(m);
+            jl_merge_recursive(batch.get(), batch.get());
+        }
+        else {
+            jl_merge_recursive(m.get(), batch.get());
+            jl_merge_module(batch.get(), std::move(m));
+        }
+    }
+    if (batch)
+        jl_add_to_ee(std::move(batch));
+    JL_UNLOCK(&codegen_lock);
+}
+
 // see if any of the functions needed by F are still WIP
 static StringSet<> incomplete_fname;
 static bool can_finalize_function(StringRef F, SmallSet<Module*, 16> &known)
@@ -1185,3 +1284,38 @@ template<> char JuliaPipeline<3>::ID = 0;
 static RegisterPass<JuliaPipeline<0>> X("juliaO0", "Runs the entire julia pipeline (at -O0)", false, false);
 static RegisterPass<JuliaPipeline<2>> Y("julia", "Runs the entire julia pipeline (at -O2)", false, false);
 static RegisterPass<JuliaPipeline<3>> Z("juliaO3", "Runs the entire julia pipeline (at -O3)", false, false);
+
+// zlib helpers for the .ji serializer (dump.c): LLVM already links zlib, so
+// cache-file compression costs no new dependency. Returns a malloc'd buffer
+// (caller frees) or NULL when zlib is unavailable or compression fails.
+extern "C" JL_DLLEXPORT char *jl_zlib_compress(const char *src, size_t n, size_t *outn)
+{
+    if (!zlib::isAvailable())
+        return NULL;
+    SmallVector<char, 0> buf;
+    Error err = zlib::compress(StringRef(src, n), buf);
+    if (err) {
+        consumeError(std::move(err));
+        return NULL;
+    }
+    char *out = (char*)malloc(buf.size());
+    if (out == NULL)
+        return NULL;
+    memcpy(out, buf.data(), buf.size());
+    *outn = buf.size();
+    return out;
+}
+
+// expand `n` compressed bytes into exactly `dstn` bytes; returns 0 on success
+extern "C" JL_DLLEXPORT int jl_zlib_uncompress(const char *src, size_t n, char *dst, size_t dstn)
+{
+    if (!zlib::isAvailable())
+        return -1;
+    size_t sz = dstn;
+    Error err = zlib::uncompress(StringRef(src, n), dst, sz);
+    if (err) {
+        consumeError(std::move(err));
+        return -1;
+    }
+    return sz == dstn ? 0 : -1;
+}
@@ -170,12 +170,6 @@ private:
 
     TargetMachine &TM;
     const DataLayout DL;
-    // Should be big enough that in the common case, The
-    // object fits in its entirety
-    SmallVector<char, 4096> ObjBufferSV;
-    raw_svector_ostream ObjStream;
-    legacy::PassManager PM;
-    MCContext *Ctx;
     std::shared_ptr<RTDyldMemoryManager> MemMgr;
     DebugObjectRegistrar registrar;
 
@@ -201,6 +195,7 @@ Pass *createGCInvariantVerifierPass(bool Strong);
 Pass *createPropagateJuliaAddrspaces();
 Pass *createMultiVersioningPass();
 Pass *createAllocOptPass();
+Pass *createBarrierElisionPass();
 // Whether the Function is an llvm or julia intrinsic.
 static inline bool isIntrinsicFunction(Function *F)
 {
@@ -17,6 +17,22 @@
 #include <sys/socket.h>
 #endif
 
+#ifdef _OS_LINUX_
+#include <fcntl.h>         // splice
+#include <sys/sendfile.h>
+#if defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#if defined(SYS_io_uring_setup) && defined(SYS_io_uring_enter)
+#define JL_HAVE_IO_URING
+#endif
+#endif
+#endif
+#endif
+
 #include "julia.h"
 #include "julia_internal.h"
 #include "support/ios.h"
@@ -51,10 +67,83 @@ void jl_wake_libuv(void)
 
 jl_mutex_t jl_uv_mutex;
 
+static void jl_uv_wbatch_check_cb(uv_check_t *hdl);
+static uv_check_t uv_wbatch_check_global;
+static jl_mutex_t uv_wbatch_lock;
+
+#ifdef JL_HAVE_IO_URING
+static jl_mutex_t jl_fs_uring_lock;
+#endif
+static jl_mutex_t jl_fsync_gc_lock;
+
+// Pooled read buffers. The read path's alloc callback would otherwise
+// malloc a fresh buffer per read event; at high read rates that is pure
+// allocator churn. Each loop keeps a small pool of recycled buffers in
+// power-of-two size classes (4K..64K); `jl_uv_alloc_read_buf` pops from
+// the class covering the size hint and `jl_uv_free_read_buf` pushes back,
+// capped per class. Oversized requests bypass the pool entirely.
+#define JL_UV_RDPOOL_NCLASSES 5
+#define JL_UV_RDPOOL_MINSZ 4096u
+#define JL_UV_RDPOOL_MAXCACHED 16
+
+typedef struct jl_uv_rdbuf_t {
+    struct jl_uv_rdbuf_t *next; // freelist link, only while pooled
+} jl_uv_rdbuf_t;
+
+// precedes the data we hand out; records which freelist the buffer
+// belongs to (or that it bypassed the pool)
+typedef struct {
+    uint32_t cls;    // size class, or UINT32_MAX for a plain malloc
+    uint32_t _pad;
+    uint64_t _pad2;  // keep the data 16-byte aligned
+} jl_uv_rdbuf_hdr_t;
+
+typedef struct {
+    jl_mutex_t lock; // leaf lock; release may come from another thread
+    jl_uv_rdbuf_t *freelist[JL_UV_RDPOOL_NCLASSES];
+    int nfree[JL_UV_RDPOOL_NCLASSES];
+} jl_uv_buf_pool_t;
+
+static jl_uv_buf_pool_t jl_uv_global_rdpool; // serves the global loop
+
+static void jl_uv_rdpool_init(jl_uv_buf_pool_t *pool)
+{
+    JL_MUTEX_INIT(&pool->lock);
+    memset(pool->freelist, 0, sizeof(pool->freelist));
+    memset(pool->nfree, 0, sizeof(pool->nfree));
+}
+
+static void jl_uv_rdpool_drain(jl_uv_buf_pool_t *pool)
+{
+    JL_LOCK_NOGC(&pool->lock);
+    for (int cls = 0; cls < JL_UV_RDPOOL_NCLASSES; cls++) {
+        jl_uv_rdbuf_t *node = pool->freelist[cls];
+        while (node) {
+            jl_uv_rdbuf_t *next = node->next;
+            free((jl_uv_rdbuf_hdr_t*)node - 1);
+            node = next;
+        }
+        pool->freelist[cls] = NULL;
+        pool->nfree[cls] = 0;
+    }
+    JL_UNLOCK_NOGC(&pool->lock);
+}
+
 void jl_init_uv(void)
 {
     uv_async_init(jl_io_loop, &signal_async, jl_signal_async_cb);
     JL_MUTEX_INIT(&jl_uv_mutex); // a file-scope initializer can be used instead
+    jl_lock_register(&jl_uv_mutex, "uv");
+    JL_MUTEX_INIT(&uv_wbatch_lock);
+    jl_uv_rdpool_init(&jl_uv_global_rdpool);
+    JL_MUTEX_INIT(&jl_fsync_gc_lock);
+#ifdef JL_HAVE_IO_URING
+    JL_MUTEX_INIT(&jl_fs_uring_lock);
+#endif
+    // flush pending write batches at the end of every loop iteration
+    uv_check_init(jl_io_loop, &uv_wbatch_check_global);
+    uv_check_start(&uv_wbatch_check_global, jl_uv_wbatch_check_cb);
+    uv_unref((uv_handle_t*)&uv_wbatch_check_global);
 }
 
 int jl_uv_n_waiters = 0;
@@ -71,6 +160,337 @@ void JL_UV_LOCK(void)
     }
 }
 
+// Auxiliary event loops (`jl_new_event_loop`). A handle is pinned to the
+// loop it was initialized with; operations on it take that loop's own lock
+// instead of the global `jl_uv_mutex`, so connections living on separate
+// loops can be serviced by separate threads without contending on one lock.
+// An auxiliary loop is recognized by `loop->data` pointing back at the
+// enclosing struct; neither libuv nor Base touches `loop->data`.
+typedef struct {
+    uv_loop_t loop; // must be first
+    jl_mutex_t lock;
+    uv_async_t wakeup; // stops the loop so that lock waiters can get in
+    uv_check_t wbatch_check; // end-of-iteration write batch flush
+    int n_waiters;
+    jl_uv_buf_pool_t rdpool; // recycled read buffers for this loop
+} jl_aux_uv_loop_t;
+
+static void jl_aux_loop_wakeup_cb(uv_async_t *hdl)
+{
+    uv_stop(hdl->loop);
+}
+
+STATIC_INLINE jl_aux_uv_loop_t *jl_aux_uv_loop(uv_loop_t *loop)
+{
+    jl_aux_uv_loop_t *aux = (jl_aux_uv_loop_t*)loop;
+    if (loop == NULL || loop == jl_io_loop || loop->data != (void*)aux)
+        return NULL;
+    return aux;
+}
+
+void jl_uv_lock_loop(uv_loop_t *loop)
+{
+    jl_aux_uv_loop_t *aux = jl_aux_uv_loop(loop);
+    if (aux == NULL) {
+        JL_UV_LOCK();
+        return;
+    }
+    if (jl_mutex_trylock(&aux->lock)) {
+    }
+    else {
+        jl_atomic_fetch_add(&aux->n_waiters, 1);
+        uv_async_send(&aux->wakeup);
+        JL_LOCK(&aux->lock);
+        jl_atomic_fetch_add(&aux->n_waiters, -1);
+    }
+}
+
+void jl_uv_unlock_loop(uv_loop_t *loop)
+{
+    jl_aux_uv_loop_t *aux = jl_aux_uv_loop(loop);
+    if (aux == NULL)
+        JL_UV_UNLOCK();
+    else
+        JL_UNLOCK(&aux->lock);
+}
+
+JL_DLLEXPORT uv_loop_t *jl_new_event_loop(void)
+{
+    jl_aux_uv_loop_t *aux = (jl_aux_uv_loop_t*)malloc(sizeof(jl_aux_uv_loop_t));
+    if (aux == NULL)
+        return NULL;
+    if (uv_loop_init(&aux->loop) != 0) {
+        free(aux);
+        return NULL;
+    }
+    JL_MUTEX_INIT(&aux->lock);
+    aux->n_waiters = 0;
+    uv_async_init(&aux->loop, &aux->wakeup, jl_aux_loop_wakeup_cb);
+    // don't let the bookkeeping handles keep an otherwise idle loop alive
+    uv_unref((uv_handle_t*)&aux->wakeup);
+    uv_check_init(&aux->loop, &aux->wbatch_check);
+    uv_check_start(&aux->wbatch_check, jl_uv_wbatch_check_cb);
+    uv_unref((uv_handle_t*)&aux->wbatch_check);
+    jl_uv_rdpool_init(&aux->rdpool);
+    aux->loop.data = (void*)aux;
+    return &aux->loop;
+}
+
+JL_DLLEXPORT int jl_close_event_loop(uv_loop_t *loop)
+{
+    jl_aux_uv_loop_t *aux = jl_aux_uv_loop(loop);
+    if (aux == NULL)
+        return UV_EINVAL; // refuse to tear down the global loop
+    jl_uv_lock_loop(loop);
+    uv_close((uv_handle_t*)&aux->wakeup, NULL);
+    uv_close((uv_handle_t*)&aux->wbatch_check, NULL);
+    uv_run(loop, UV_RUN_NOWAIT); // flush the pending closes
+    int err = uv_loop_close(loop);
+    jl_uv_unlock_loop(loop);
+    if (err == 0) {
+        jl_uv_rdpool_drain(&aux->rdpool);
+        free(aux);
+    }
+    return err;
+}
+
+STATIC_INLINE jl_uv_buf_pool_t *jl_uv_loop_rdpool(uv_loop_t *loop)
+{
+    jl_aux_uv_loop_t *aux = jl_aux_uv_loop(loop);
+    return aux ? &aux->rdpool : &jl_uv_global_rdpool;
+}
+
+// get a read buffer of at least `suggested` bytes from the loop's pool
+// (*len receives the usable size). Pair with jl_uv_free_read_buf.
+JL_DLLEXPORT char *jl_uv_alloc_read_buf(uv_loop_t *loop, size_t suggested,
+                                        size_t *len)
+{
+    uint32_t cls = 0;
+    size_t sz = JL_UV_RDPOOL_MINSZ;
+    while (sz < suggested && cls < JL_UV_RDPOOL_NCLASSES - 1) {
+        sz <<= 1;
+        cls++;
+    }
+    jl_uv_rdbuf_hdr_t *hdr = NULL;
+    if (suggested <= sz) {
+        jl_uv_buf_pool_t *pool = jl_uv_loop_rdpool(loop);
+        JL_LOCK_NOGC(&pool->lock);
+        jl_uv_rdbuf_t *node = pool->freelist[cls];
+        if (node) {
+            pool->freelist[cls] = node->next;
+            pool->nfree[cls]--;
+            hdr = (jl_uv_rdbuf_hdr_t*)node - 1;
+        }
+        JL_UNLOCK_NOGC(&pool->lock);
+    }
+    else {
+        // too big to pool
+        sz = suggested;
+        cls = UINT32_MAX;
+    }
+    if (hdr == NULL) {
+        hdr = (jl_uv_rdbuf_hdr_t*)malloc(sizeof(jl_uv_rdbuf_hdr_t) + sz);
+        if (hdr == NULL) {
+            *len = 0;
+            return NULL;
+        }
+        hdr->cls = cls;
+    }
+    *len = sz;
+    return (char*)(hdr + 1);
+}
+
+JL_DLLEXPORT void jl_uv_free_read_buf(uv_loop_t *loop, char *base)
+{
+    if (base == NULL)
+        return;
+    jl_uv_rdbuf_hdr_t *hdr = (jl_uv_rdbuf_hdr_t*)base - 1;
+    uint32_t cls = hdr->cls;
+    if (cls < JL_UV_RDPOOL_NCLASSES) {
+        jl_uv_buf_pool_t *pool = jl_uv_loop_rdpool(loop);
+        JL_LOCK_NOGC(&pool->lock);
+        if (pool->nfree[cls] < JL_UV_RDPOOL_MAXCACHED) {
+            jl_uv_rdbuf_t *node = (jl_uv_rdbuf_t*)base;
+            node->next = pool->freelist[cls];
+            pool->freelist[cls] = node;
+            pool->nfree[cls]++;
+            JL_UNLOCK_NOGC(&pool->lock);
+            return;
+        }
+        JL_UNLOCK_NOGC(&pool->lock);
+    }
+    free(hdr);
+}
+
+// drop-in uv_alloc_cb for uv_read_start; the read callback owns the
+// buffer afterwards and must return it with jl_uv_free_read_buf
+JL_DLLEXPORT void jl_uv_pooled_alloc_cb(uv_handle_t *handle,
+                                        size_t suggested_size, uv_buf_t *buf)
+{
+    size_t len = 0;
+    buf->base = jl_uv_alloc_read_buf(handle->loop, suggested_size, &len);
+    buf->len = len;
+}
+
+// Write batching. `jl_uv_write_batched` appends small writes to a pooled
+// per-stream buffer instead of submitting a fresh malloc'd uv_write_t per
+// call; a batch goes out as one uv_write when it fills, when the owning
+// loop finishes an iteration (via a check handle), or when the caller asks
+// with `jl_uv_flush_pending`. The request structs cycle through a freelist.
+#define JL_UV_WBATCH_BUFSZ 4096
+#define JL_UV_WBATCH_POOL_MAX 32
+
+typedef struct jl_uv_wbatch_t {
+    uv_write_t req;
+    struct jl_uv_wbatch_t *next;
+    uv_stream_t *stream;
+    size_t len;
+    char data[JL_UV_WBATCH_BUFSZ];
+} jl_uv_wbatch_t;
+
+// `uv_wbatch_lock` (initialized in jl_init_uv) guards the two lists below;
+// it is a leaf lock, never held across a libuv call
+static jl_uv_wbatch_t *uv_wbatch_free; // pooled request structs
+static int uv_wbatch_nfree;
+static jl_uv_wbatch_t *uv_wbatch_open; // batches still accepting data
+
+static void jl_uv_wbatch_writecb(uv_write_t *req, int status)
+{
+    jl_uv_wbatch_t *batch = (jl_uv_wbatch_t*)req->data;
+    if (status < 0) {
+        jl_safe_printf("jl_uv_wbatch_writecb() ERROR: %s %s\n",
+                       uv_strerror(status), uv_err_name(status));
+    }
+    JL_LOCK_NOGC(&uv_wbatch_lock);
+    if (uv_wbatch_nfree < JL_UV_WBATCH_POOL_MAX) {
+        batch->next = uv_wbatch_free;
+        uv_wbatch_free = batch;
+        uv_wbatch_nfree++;
+        batch = NULL;
+    }
+    JL_UNLOCK_NOGC(&uv_wbatch_lock);
+    if (batch)
+        free(batch);
+}
+
+// submit one detached batch. `locked` says whether the caller is already
+// serialized with the loop (i.e. running inside one of its callbacks).
+static void jl_uv_wbatch_submit(jl_uv_wbatch_t *batch, int locked)
+{
+    uv_buf_t buf;
+    buf.base = batch->data;
+    buf.len = batch->len;
+    batch->req.data = (void*)batch;
+    if (!locked)
+        jl_uv_lock_loop(batch->stream->loop);
+    int status = uv_write(&batch->req, batch->stream, &buf, 1,
+                          jl_uv_wbatch_writecb);
+    if (!locked)
+        jl_uv_unlock_loop(batch->stream->loop);
+    if (status < 0)
+        jl_uv_wbatch_writecb(&batch->req, status);
+}
+
+// flush every open batch owned by `loop`; runs on the loop's thread after
+// each iteration
+static void jl_uv_wbatch_check_cb(uv_check_t *hdl)
+{
+    uv_loop_t *loop = hdl->loop;
+    jl_uv_wbatch_t *todo = NULL;
+    JL_LOCK_NOGC(&uv_wbatch_lock);
+    jl_uv_wbatch_t **pb = &uv_wbatch_open;
+    while (*pb) {
+        jl_uv_wbatch_t *batch = *pb;
+        if (batch->stream->loop == loop) {
+            *pb = batch->next;
+            batch->next = todo;
+            todo = batch;
+        }
+        else {
+            pb = &batch->next;
+        }
+    }
+    JL_UNLOCK_NOGC(&uv_wbatch_lock);
+    while (todo) {
+        jl_uv_wbatch_t *batch = todo;
+        todo = batch->next;
+        jl_uv_wbatch_submit(batch, 1);
+    }
+}
+
+// detach the open batch for `stream`, if any
+static jl_uv_wbatch_t *jl_uv_wbatch_take(uv_stream_t *stream)
+{
+    // uv_wbatch_lock must be held
+    jl_uv_wbatch_t **pb = &uv_wbatch_open;
+    while (*pb) {
+        if ((*pb)->stream == stream) {
+            jl_uv_wbatch_t *batch = *pb;
+            *pb = batch->next;
+            return batch;
+        }
+        pb = &(*pb)->next;
+    }
+    return NULL;
+}
+
+JL_DLLEXPORT void jl_uv_flush_pending(uv_stream_t *stream)
+{
+    JL_LOCK_NOGC(&uv_wbatch_lock);
+    jl_uv_wbatch_t *batch = jl_uv_wbatch_take(stream);
+    JL_UNLOCK_NOGC(&uv_wbatch_lock);
+    if (batch)
+        jl_uv_wbatch_submit(batch, 0);
+}
+
+JL_DLLEXPORT int jl_uv_write_batched(uv_stream_t *stream, const char *data,
+                                     size_t n)
+{
+    if (n > JL_UV_WBATCH_BUFSZ) {
+        // too big to batch: push out what is pending to keep the bytes in
+        // order, then submit this write on its own
+        jl_uv_flush_pending(stream);
+        jl_uv_puts(stream, data, n);
+        return 0;
+    }
+    JL_LOCK_NOGC(&uv_wbatch_lock);
+    jl_uv_wbatch_t *batch = jl_uv_wbatch_take(stream);
+    if (batch && batch->len + n <= JL_UV_WBATCH_BUFSZ) {
+        // common case: append in place, no allocation and no syscall
+        memcpy(batch->data + batch->len, data, n);
+        batch->len += n;
+        batch->next = uv_wbatch_open;
+        uv_wbatch_open = batch;
+        JL_UNLOCK_NOGC(&uv_wbatch_lock);
+        return 0;
+    }
+    JL_UNLOCK_NOGC(&uv_wbatch_lock);
+    if (batch)
+        // full: the older bytes must go out before the new batch is
+        // published, or an end-of-iteration flush could reorder them
+        jl_uv_wbatch_submit(batch, 0);
+    JL_LOCK_NOGC(&uv_wbatch_lock);
+    batch = uv_wbatch_free;
+    if (batch) {
+        uv_wbatch_free = batch->next;
+        uv_wbatch_nfree--;
+    }
+    JL_UNLOCK_NOGC(&uv_wbatch_lock);
+    if (batch == NULL) {
+        batch = (jl_uv_wbatch_t*)malloc(sizeof(jl_uv_wbatch_t));
+        if (batch == NULL)
+            return UV_ENOMEM;
+    }
+    batch->stream = stream;
+    batch->len = n;
+    memcpy(batch->data, data, n);
+    JL_LOCK_NOGC(&uv_wbatch_lock);
+    batch->next = uv_wbatch_open;
+    uv_wbatch_open = batch;
+    JL_UNLOCK_NOGC(&uv_wbatch_lock);
+    return 0;
+}
+
 void jl_uv_call_close_callback(jl_value_t *val)
 {
     jl_value_t *args[2];
@@ -156,7 +576,8 @@ void jl_uv_flush(uv_stream_t *stream)
         stream->type != UV_TCP &&
         stream->type != UV_NAMED_PIPE)
         return;
-    JL_UV_LOCK();
+    jl_uv_flush_pending(stream); // push out any batched bytes first
+    jl_uv_lock_loop(stream->loop);
     while (uv_is_writable(stream) && stream->write_queue_size != 0) {
         int fired = 0;
         uv_buf_t buf;
@@ -165,14 +586,14 @@ void jl_uv_flush(uv_stream_t *stream)
         uv_write_t *write_req = (uv_write_t*)malloc(sizeof(uv_write_t));
         write_req->data = (void*)&fired;
         if (uv_write(write_req, stream, &buf, 1, uv_flush_callback) != 0) {
-            JL_UV_UNLOCK();
+            jl_uv_unlock_loop(stream->loop);
             return;
         }
         while (!fired) {
-            uv_run(uv_default_loop(), UV_RUN_DEFAULT);
+            uv_run(stream->loop, UV_RUN_DEFAULT);
         }
     }
-    JL_UV_UNLOCK();
+    jl_uv_unlock_loop(stream->loop);
 }
 
 // getters and setters
@@ -195,10 +616,10 @@ JL_DLLEXPORT int jl_run_once(uv_loop_t *loop)
     jl_ptls_t ptls = jl_get_ptls_states();
     if (loop) {
         jl_gc_safepoint_(ptls);
-        JL_UV_LOCK();
+        jl_uv_lock_loop(loop);
         loop->stop_flag = 0;
         int r = uv_run(loop,UV_RUN_ONCE);
-        JL_UV_UNLOCK();
+        jl_uv_unlock_loop(loop);
         return r;
     }
     return 0;
@@ -209,10 +630,10 @@ JL_DLLEXPORT int jl_process_events(uv_loop_t *loop)
     jl_ptls_t ptls = jl_get_ptls_states();
     if (loop) {
         jl_gc_safepoint_(ptls);
-        JL_UV_LOCK();
+        jl_uv_lock_loop(loop);
         loop->stop_flag = 0;
         int r = uv_run(loop,UV_RUN_NOWAIT);
-        JL_UV_UNLOCK();
+        jl_uv_unlock_loop(loop);
         return r;
     }
     return 0;
@@ -232,7 +653,11 @@ JL_DLLEXPORT void jl_close_uv(uv_handle_t *handle)
         ((uv_process_t*)handle)->exit_cb = jl_proc_exit_cleanup_cb;
         return;
     }
-    JL_UV_LOCK();
+    if (handle->type == UV_NAMED_PIPE || handle->type == UV_TCP ||
+        handle->type == UV_TTY)
+        // no batch may outlive its stream
+        jl_uv_flush_pending((uv_stream_t*)handle);
+    jl_uv_lock_loop(handle->loop);
     if (handle->type == UV_FILE) {
         uv_fs_t req;
         jl_uv_file_t *fd = (jl_uv_file_t*)handle;
@@ -241,7 +666,7 @@ JL_DLLEXPORT void jl_close_uv(uv_handle_t *handle)
             fd->file = (uv_os_fd_t)(ssize_t)-1;
         }
         jl_uv_closeHandle(handle); // synchronous (ok since the callback is known to not interact with any global state)
-        JL_UV_UNLOCK();
+        jl_uv_unlock_loop(handle->loop);
         return;
     }
 
@@ -249,7 +674,7 @@ JL_DLLEXPORT void jl_close_uv(uv_handle_t *handle)
         uv_write_t *req = (uv_write_t*)malloc(sizeof(uv_write_t));
         req->handle = (uv_stream_t*)handle;
         jl_uv_flush_close_callback(req, 0);
-        JL_UV_UNLOCK();
+        jl_uv_unlock_loop(handle->loop);
         return;
     }
 
@@ -257,16 +682,16 @@ JL_DLLEXPORT void jl_close_uv(uv_handle_t *handle)
     if (!uv_is_closing(handle)) {
         uv_close(handle, &jl_uv_closeHandle);
     }
-    JL_UV_UNLOCK();
+    jl_uv_unlock_loop(handle->loop);
 }
 
 JL_DLLEXPORT void jl_forceclose_uv(uv_handle_t *handle)
 {
     // avoid double-closing the stream
     if (!uv_is_closing(handle)) {
-        JL_UV_LOCK();
+        jl_uv_lock_loop(handle->loop);
         uv_close(handle, &jl_uv_closeHandle);
-        JL_UV_UNLOCK();
+        jl_uv_unlock_loop(handle->loop);
     }
 }
 
@@ -311,9 +736,9 @@ JL_DLLEXPORT int jl_spawn(char *name, char **argv,
         }
     }
     opts.exit_cb = cb;
-    JL_UV_LOCK();
+    jl_uv_lock_loop(loop);
     int r = uv_spawn(loop, proc, &opts);
-    JL_UV_UNLOCK();
+    jl_uv_unlock_loop(loop);
     return r;
 }
 
@@ -333,6 +758,168 @@ JL_DLLEXPORT uv_loop_t *jl_global_event_loop(void)
     return jl_io_loop;
 }
 
+#ifdef JL_HAVE_IO_URING
+// --- io_uring backend for the jl_fs layer ------------------------------
+//
+// Opt-in via JULIA_IO_URING=1. A single small kernel ring is shared by
+// all threads under a leaf lock; each operation is submitted and reaped
+// within one io_uring_enter, and jl_fs_write_batch pushes a whole batch
+// of writes into the kernel per syscall instead of paying a threadpool
+// handoff per buffer. If the kernel has no io_uring (or setup fails) the
+// callers below quietly stay on the libuv path, so this is purely a fast
+// path. The ring is always drained before the lock is released, which
+// keeps the submission/completion bookkeeping trivial.
+
+#define JL_URING_ENTRIES 64u
+
+static jl_mutex_t jl_fs_uring_lock;
+static struct {
+    int fd;
+    int state;                  // 0 untried, 1 ready, -1 unavailable
+    unsigned *sq_head, *sq_tail, *sq_mask, *sq_array;
+    unsigned *cq_head, *cq_tail, *cq_mask;
+    struct io_uring_sqe *sqes;
+    struct io_uring_cqe *cqes;
+} jl_fs_uring = { -1, 0 };
+
+// jl_fs_uring_lock must be held
+static int jl_fs_uring_ready(void)
+{
+    if (jl_fs_uring.state)
+        return jl_fs_uring.state > 0;
+    jl_fs_uring.state = -1;
+    char *enabled = getenv("JULIA_IO_URING");
+    if (!enabled || !atoi(enabled))
+        return 0;
+    struct io_uring_params p;
+    memset(&p, 0, sizeof(p));
+    int fd = syscall(SYS_io_uring_setup, JL_URING_ENTRIES, &p);
+    if (fd < 0)
+        return 0;
+    // map the two rings and the sqe array separately; the single-mmap
+    // feature is newer than the kernels we must run on
+    size_t sq_sz = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    size_t cq_sz = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    size_t sqes_sz = p.sq_entries * sizeof(struct io_uring_sqe);
+    void *sq = mmap(NULL, sq_sz, PROT_READ | PROT_WRITE, MAP_SHARED,
+                    fd, IORING_OFF_SQ_RING);
+    void *cq = mmap(NULL, cq_sz, PROT_READ | PROT_WRITE, MAP_SHARED,
+                    fd, IORING_OFF_CQ_RING);
+    void *sqes = mmap(NULL, sqes_sz, PROT_READ | PROT_WRITE, MAP_SHARED,
+                      fd, IORING_OFF_SQES);
+    if (sq == MAP_FAILED || cq == MAP_FAILED || sqes == MAP_FAILED) {
+        if (sq != MAP_FAILED)
+            munmap(sq, sq_sz);
+        if (cq != MAP_FAILED)
+            munmap(cq, cq_sz);
+        if (sqes != MAP_FAILED)
+            munmap(sqes, sqes_sz);
+        close(fd);
+        return 0;
+    }
+    jl_fs_uring.fd = fd;
+    jl_fs_uring.sq_head = (unsigned*)((char*)sq + p.sq_off.head);
+    jl_fs_uring.sq_tail = (unsigned*)((char*)sq + p.sq_off.tail);
+    jl_fs_uring.sq_mask = (unsigned*)((char*)sq + p.sq_off.ring_mask);
+    jl_fs_uring.sq_array = (unsigned*)((char*)sq + p.sq_off.array);
+    jl_fs_uring.cq_head = (unsigned*)((char*)cq + p.cq_off.head);
+    jl_fs_uring.cq_tail = (unsigned*)((char*)cq + p.cq_off.tail);
+    jl_fs_uring.cq_mask = (unsigned*)((char*)cq + p.cq_off.ring_mask);
+    jl_fs_uring.cqes = (struct io_uring_cqe*)((char*)cq + p.cq_off.cqes);
+    jl_fs_uring.sqes = (struct io_uring_sqe*)sqes;
+    jl_fs_uring.state = 1;
+    return 1;
+}
+
+// prepare the i'th sqe of the batch being built at the current tail.
+// jl_fs_uring_lock must be held
+static struct io_uring_sqe *jl_fs_uring_sqe(unsigned i, uint8_t opcode, int fd,
+                                            const void *addr, unsigned len,
+                                            uint64_t off)
+{
+    unsigned idx = (*jl_fs_uring.sq_tail + i) & *jl_fs_uring.sq_mask;
+    struct io_uring_sqe *sqe = &jl_fs_uring.sqes[idx];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = opcode;
+    sqe->fd = fd;
+    sqe->addr = (uintptr_t)addr;
+    sqe->len = len;
+    sqe->off = off;
+    sqe->user_data = i;
+    jl_fs_uring.sq_array[idx] = idx;
+    return sqe;
+}
+
+// submit the n prepared sqes and wait for all their completions;
+// results[i] receives the raw cqe result (-errno on failure) for the sqe
+// with user_data i. jl_fs_uring_lock must be held
+static int jl_fs_uring_submit_and_wait(unsigned n, int32_t *results)
+{
+    jl_atomic_store_release(jl_fs_uring.sq_tail, *jl_fs_uring.sq_tail + n);
+    unsigned got = 0;
+    long ret = syscall(SYS_io_uring_enter, jl_fs_uring.fd, n, n,
+                       IORING_ENTER_GETEVENTS, NULL, 0);
+    while (1) {
+        if (ret < 0 && errno != EINTR)
+            return uv_translate_sys_error(errno);
+        unsigned head = *jl_fs_uring.cq_head;
+        while (head != jl_atomic_load_acquire(jl_fs_uring.cq_tail)) {
+            struct io_uring_cqe *cqe =
+                &jl_fs_uring.cqes[head & *jl_fs_uring.cq_mask];
+            assert(cqe->user_data < n);
+            results[cqe->user_data] = cqe->res;
+            head++;
+            got++;
+        }
+        jl_atomic_store_release(jl_fs_uring.cq_head, head);
+        if (got >= n)
+            return 0;
+        // completions can trickle in; go back to sleep for the rest
+        ret = syscall(SYS_io_uring_enter, jl_fs_uring.fd, 0, n - got,
+                      IORING_ENTER_GETEVENTS, NULL, 0);
+    }
+}
+
+// run one read/write/fsync through the ring. returns 1 with *res set
+// (bytes, or a uv error code) when the ring handled it, 0 when the
+// caller should take the libuv path instead
+static int jl_fs_uring_rw(uint8_t opcode, int fd, const void *data,
+                          size_t len, int64_t offset, int *res)
+{
+    int64_t cur = -1;
+    if (opcode != IORING_OP_FSYNC && offset < 0) {
+        // the ring wants explicit file offsets; emulate "current
+        // position" for seekable fds and punt for everything else
+        cur = lseek(fd, 0, SEEK_CUR);
+        if (cur < 0)
+            return 0;
+        offset = cur;
+    }
+    JL_LOCK_NOGC(&jl_fs_uring_lock);
+    if (!jl_fs_uring_ready()) {
+        JL_UNLOCK_NOGC(&jl_fs_uring_lock);
+        return 0;
+    }
+    struct iovec iov = { (void*)data, len };
+    if (opcode == IORING_OP_FSYNC)
+        jl_fs_uring_sqe(0, opcode, fd, NULL, 0, 0);
+    else
+        jl_fs_uring_sqe(0, opcode, fd, &iov, 1, (uint64_t)offset);
+    int32_t result = 0;
+    int err = jl_fs_uring_submit_and_wait(1, &result);
+    JL_UNLOCK_NOGC(&jl_fs_uring_lock);
+    if (err)
+        *res = err;
+    else if (result < 0)
+        *res = uv_translate_sys_error(-result);
+    else
+        *res = result;
+    if (cur >= 0 && *res > 0)
+        lseek(fd, cur + *res, SEEK_SET);
+    return 1;
+}
+#endif
+
 JL_DLLEXPORT int jl_fs_unlink(char *path)
 {
     uv_fs_t req;
@@ -365,6 +952,132 @@ JL_DLLEXPORT int jl_fs_sendfile(uv_os_fd_t src_fd, uv_os_fd_t dst_fd,
     return ret;
 }
 
+#ifdef _OS_LINUX_
+// move len bytes from one stream fd to another without surfacing them in
+// userspace, by splicing through a transient pipe (splice requires a pipe
+// on one side; socket->socket needs the double hop)
+static int64_t jl_fs_splice_streams(int src_fd, int dst_fd, size_t len)
+{
+    int pfd[2];
+    if (pipe2(pfd, O_CLOEXEC))
+        return uv_translate_sys_error(errno);
+    int64_t total = 0;
+    int err = 0;
+    while (len > 0) {
+        ssize_t nr = splice(src_fd, NULL, pfd[1], NULL, len,
+                            SPLICE_F_MOVE | SPLICE_F_MORE);
+        if (nr == 0)
+            break;  // EOF on source
+        if (nr < 0) {
+            if (errno == EINTR)
+                continue;
+            err = errno;
+            break;
+        }
+        size_t left = (size_t)nr;
+        while (left > 0) {
+            ssize_t nw = splice(pfd[0], NULL, dst_fd, NULL, left,
+                                SPLICE_F_MOVE | SPLICE_F_MORE);
+            if (nw < 0) {
+                if (errno == EINTR)
+                    continue;
+                err = errno;
+                break;
+            }
+            left -= (size_t)nw;
+            total += nw;
+        }
+        if (err)
+            break;
+        len -= (size_t)nr;
+    }
+    close(pfd[0]);
+    close(pfd[1]);
+    if (err && total == 0)
+        return uv_translate_sys_error(err);
+    return total;
+}
+#endif
+
+// Forward up to len bytes from src_fd to dst_fd. in_offset >= 0 treats the
+// source as a file read from that offset (in-kernel sendfile); in_offset < 0
+// treats both ends as streams (sockets/pipes) and forwards from the current
+// positions, in-kernel on Linux and via a bounce buffer elsewhere. Returns
+// the number of bytes forwarded, or a negative uv error code if nothing
+// could be moved.
+JL_DLLEXPORT int64_t jl_fs_forward(uv_os_fd_t src_fd, uv_os_fd_t dst_fd,
+                                   int64_t in_offset, size_t len)
+{
+    if (in_offset >= 0) {
+        int64_t total = 0;
+        JL_SIGATOMIC_BEGIN();
+        while (len > 0) {
+            uv_fs_t req;
+            int ret = uv_fs_sendfile(unused_uv_loop_arg, &req, dst_fd, src_fd,
+                                     in_offset + total, len, NULL);
+            uv_fs_req_cleanup(&req);
+            if (ret <= 0) {
+                if (total == 0)
+                    total = ret;
+                break;
+            }
+            total += ret;
+            len -= (size_t)ret;
+        }
+        JL_SIGATOMIC_END();
+        return total;
+    }
+#ifdef _OS_LINUX_
+    int64_t ret;
+    JL_SIGATOMIC_BEGIN();
+    ret = jl_fs_splice_streams(src_fd, dst_fd, len);
+    JL_SIGATOMIC_END();
+    return ret;
+#else
+    // no splice; copy through a stack buffer
+    char buf[65536];
+    int64_t total = 0;
+    while (len > 0) {
+        size_t want = len < sizeof(buf) ? len : sizeof(buf);
+#ifdef _OS_WINDOWS_
+        DWORD nr = 0, nw = 0;
+        if (!ReadFile(src_fd, buf, (DWORD)want, &nr, NULL) || nr == 0)
+            break;
+        if (!WriteFile(dst_fd, buf, nr, &nw, NULL) || nw < nr)
+            break;
+#else
+        ssize_t nr = read(src_fd, buf, want);
+        if (nr == 0)
+            break;
+        if (nr < 0) {
+            if (errno == EINTR)
+                continue;
+            if (total == 0)
+                total = uv_translate_sys_error(errno);
+            break;
+        }
+        ssize_t nw = 0;
+        while (nw < nr) {
+            ssize_t w = write(dst_fd, buf + nw, (size_t)(nr - nw));
+            if (w < 0) {
+                if (errno == EINTR)
+                    continue;
+                break;
+            }
+            nw += w;
+        }
+        if (nw < nr) {
+            total += nw;
+            break;
+        }
+#endif
+        total += nw;
+        len -= (size_t)nr;
+    }
+    return total;
+#endif
+}
+
 JL_DLLEXPORT int jl_fs_symlink(char *path, char *new_path, int flags)
 {
     uv_fs_t req;
@@ -399,6 +1112,11 @@ JL_DLLEXPORT int jl_fs_write(uv_os_fd_t handle, const char *data, size_t len,
         return WriteFile(handle, data, len, NULL, NULL);
 #else
         return write(handle, data, len);
+#endif
+#ifdef JL_HAVE_IO_URING
+    int res;
+    if (jl_fs_uring_rw(IORING_OP_WRITEV, handle, data, len, offset, &res))
+        return res;
 #endif
     uv_fs_t req;
     uv_buf_t buf[1];
@@ -411,8 +1129,222 @@ JL_DLLEXPORT int jl_fs_write(uv_os_fd_t handle, const char *data, size_t len,
     return ret;
 }
 
+// write nbufs buffers at consecutive file offsets starting at offset
+// (offset < 0 writes at the current position). With io_uring enabled the
+// whole batch goes to the kernel in ring-sized gulps, one syscall per
+// gulp; otherwise it degrades to one write per buffer. Returns the total
+// bytes written, or a negative uv error code if nothing was.
+JL_DLLEXPORT int64_t jl_fs_write_batch(uv_os_fd_t handle, char **bufs,
+                                       size_t *lens, int nbufs, int64_t offset)
+{
+    int64_t total = 0;
+#ifdef JL_HAVE_IO_URING
+    if (offset < 0) {
+        int64_t cur = lseek(handle, 0, SEEK_CUR);
+        if (cur >= 0)
+            offset = cur;
+    }
+    if (offset >= 0) {
+        JL_LOCK_NOGC(&jl_fs_uring_lock);
+        if (jl_fs_uring_ready()) {
+            int err = 0;
+            int i = 0, stop = 0;
+            while (i < nbufs && !err && !stop) {
+                struct iovec iov[JL_URING_ENTRIES];
+                int32_t results[JL_URING_ENTRIES];
+                unsigned n = 0;
+                uint64_t off = (uint64_t)(offset + total);
+                while (i < nbufs && n < JL_URING_ENTRIES) {
+                    iov[n].iov_base = bufs[i];
+                    iov[n].iov_len = lens[i];
+                    jl_fs_uring_sqe(n, IORING_OP_WRITEV, handle, &iov[n], 1, off);
+                    off += lens[i];
+                    n++;
+                    i++;
+                }
+                err = jl_fs_uring_submit_and_wait(n, results);
+                for (unsigned j = 0; !err && j < n; j++) {
+                    if (results[j] < 0) {
+                        err = uv_translate_sys_error(-results[j]);
+                        break;
+                    }
+                    total += results[j];
+                    if ((size_t)results[j] < iov[j].iov_len) {
+                        // short write: later offsets no longer line up
+                        stop = 1;
+                        break;
+                    }
+                }
+            }
+            JL_UNLOCK_NOGC(&jl_fs_uring_lock);
+            return (total == 0 && err) ? err : total;
+        }
+        JL_UNLOCK_NOGC(&jl_fs_uring_lock);
+    }
+#endif
+    for (int i = 0; i < nbufs; i++) {
+        int ret = jl_fs_write(handle, bufs[i], lens[i],
+                              offset < 0 ? -1 : offset + total);
+        if (ret < 0)
+            return total ? total : ret;
+        total += ret;
+        if ((size_t)ret < lens[i])
+            break;
+    }
+    return total;
+}
+
+// Group commit. Durable logging wants an fsync per commit, but the device
+// only needs one flush to cover every write that happened before it.
+// jl_fsync_commit registers a completion callback for a dirty fd; the
+// first registration in a window arms a timer on the global loop
+// (JULIA_FSYNC_WINDOW_MS, default 1), and when it fires one asynchronous
+// uv_fs_fsync is issued for the whole group. Callbacks run on the loop
+// thread when the covering flush lands, so at high commit rates the
+// device sees one flush per window instead of one per commit.
+typedef struct jl_fsync_waiter_t {
+    struct jl_fsync_waiter_t *next;
+    void (*cb)(int status, void *data);
+    void *data;
+} jl_fsync_waiter_t;
+
+typedef struct jl_fsync_group_t {
+    struct jl_fsync_group_t *next;
+    uv_os_fd_t fd;
+    jl_fsync_waiter_t *waiters;  // registered since the last flush was cut
+    jl_fsync_waiter_t *flushing; // riding the in-flight flush
+    uv_timer_t timer;
+    uv_fs_t req;
+    int timer_active;
+    int flush_active;
+} jl_fsync_group_t;
+
+// leaf lock guarding the group list and per-group waiter lists; never
+// held across libuv calls
+static jl_mutex_t jl_fsync_gc_lock;
+static jl_fsync_group_t *jl_fsync_groups = NULL;
+static int jl_fsync_window_ms = -1;
+
+static int jl_fsync_window(void)
+{
+    if (jl_fsync_window_ms < 0) {
+        char *w = getenv("JULIA_FSYNC_WINDOW_MS");
+        jl_fsync_window_ms = w ? atoi(w) : 1;
+        if (jl_fsync_window_ms < 0)
+            jl_fsync_window_ms = 0;
+    }
+    return jl_fsync_window_ms;
+}
+
+static void jl_fsync_timer_cb(uv_timer_t *hdl);
+
+static void jl_fsync_done_cb(uv_fs_t *req)
+{
+    jl_fsync_group_t *g = (jl_fsync_group_t*)req->data;
+    int status = (int)req->result;
+    uv_fs_req_cleanup(req);
+    jl_fsync_waiter_t *w = g->flushing;
+    g->flushing = NULL;
+    while (w) {
+        jl_fsync_waiter_t *next = w->next;
+        // note: runs on the loop thread with the loop lock held
+        w->cb(status, w->data);
+        free(w);
+        w = next;
+    }
+    JL_LOCK_NOGC(&jl_fsync_gc_lock);
+    g->flush_active = 0;
+    int rearm = (g->waiters != NULL && !g->timer_active);
+    if (rearm)
+        g->timer_active = 1;
+    JL_UNLOCK_NOGC(&jl_fsync_gc_lock);
+    if (rearm) // commits arrived while we were flushing; cut the next window
+        uv_timer_start(&g->timer, jl_fsync_timer_cb, jl_fsync_window(), 0);
+}
+
+static void jl_fsync_timer_cb(uv_timer_t *hdl)
+{
+    jl_fsync_group_t *g = (jl_fsync_group_t*)hdl->data;
+    JL_LOCK_NOGC(&jl_fsync_gc_lock);
+    g->timer_active = 0;
+    g->flushing = g->waiters;
+    g->waiters = NULL;
+    g->flush_active = 1;
+    JL_UNLOCK_NOGC(&jl_fsync_gc_lock);
+    g->req.data = g;
+    uv_fs_fsync(jl_io_loop, &g->req, g->fd, jl_fsync_done_cb);
+}
+
+// register cb(status, data) to run once a flush covering everything
+// already written to fd has landed. Returns 0, or a uv error code if the
+// waiter could not be queued (in which case cb will not be called).
+JL_DLLEXPORT int jl_fsync_commit(uv_os_fd_t fd,
+                                 void (*cb)(int status, void *data), void *data)
+{
+    jl_fsync_waiter_t *w = (jl_fsync_waiter_t*)malloc(sizeof(jl_fsync_waiter_t));
+    if (w == NULL)
+        return UV_ENOMEM;
+    w->cb = cb;
+    w->data = data;
+    JL_LOCK_NOGC(&jl_fsync_gc_lock);
+    jl_fsync_group_t *g = jl_fsync_groups;
+    while (g && g->fd != fd)
+        g = g->next;
+    int created = 0;
+    if (g == NULL) {
+        g = (jl_fsync_group_t*)calloc(1, sizeof(jl_fsync_group_t));
+        if (g == NULL) {
+            JL_UNLOCK_NOGC(&jl_fsync_gc_lock);
+            free(w);
+            return UV_ENOMEM;
+        }
+        g->fd = fd;
+        g->next = jl_fsync_groups;
+        jl_fsync_groups = g;
+        created = 1;
+    }
+    w->next = g->waiters;
+    g->waiters = w;
+    int arm = (!g->timer_active && !g->flush_active);
+    if (arm)
+        g->timer_active = 1;
+    JL_UNLOCK_NOGC(&jl_fsync_gc_lock);
+    if (arm) {
+        JL_UV_LOCK();
+        if (created) {
+            uv_timer_init(jl_io_loop, &g->timer);
+            g->timer.data = g;
+            uv_unref((uv_handle_t*)&g->timer); // don't keep an idle loop alive
+        }
+        uv_timer_start(&g->timer, jl_fsync_timer_cb, jl_fsync_window(), 0);
+        JL_UV_UNLOCK();
+        jl_wake_libuv(); // the loop may be sleeping past the new deadline
+    }
+    return 0;
+}
+
+JL_DLLEXPORT int jl_fs_fsync(uv_os_fd_t handle)
+{
+#ifdef JL_HAVE_IO_URING
+    int res;
+    if (jl_fs_uring_rw(IORING_OP_FSYNC, handle, NULL, 0, 0, &res))
+        return res;
+#endif
+    uv_fs_t req;
+    JL_SIGATOMIC_BEGIN();
+    int ret = uv_fs_fsync(unused_uv_loop_arg, &req, handle, NULL);
+    uv_fs_req_cleanup(&req);
+    JL_SIGATOMIC_END();
+    return ret;
+}
+
 JL_DLLEXPORT int jl_fs_read(uv_os_fd_t handle, char *data, size_t len)
 {
+#ifdef JL_HAVE_IO_URING
+    int res;
+    if (jl_fs_uring_rw(IORING_OP_READV, handle, data, len, -1, &res))
+        return res;
+#endif
     uv_fs_t req;
     uv_buf_t buf[1];
     buf[0].base = data;
@@ -455,10 +1387,10 @@ JL_DLLEXPORT int jl_uv_write(uv_stream_t *stream, const char *data, size_t n,
     uv_buf_t buf[1];
     buf[0].base = (char*)data;
     buf[0].len = n;
-    JL_UV_LOCK();
+    jl_uv_lock_loop(stream->loop);
     JL_SIGATOMIC_BEGIN();
     int err = uv_write(uvw, stream, buf, 1, writecb);
-    JL_UV_UNLOCK();
+    jl_uv_unlock_loop(stream->loop);
     JL_SIGATOMIC_END();
     return err;
 }
@@ -523,10 +1455,10 @@ JL_DLLEXPORT void jl_uv_puts(uv_stream_t *stream, const char *str, size_t n)
         buf[0].base = data;
         buf[0].len = n;
         req->data = NULL;
-        JL_UV_LOCK();
+        jl_uv_lock_loop(stream->loop);
         JL_SIGATOMIC_BEGIN();
         int status = uv_write(req, stream, buf, 1, (uv_write_cb)jl_uv_writecb);
-        JL_UV_UNLOCK();
+        jl_uv_unlock_loop(stream->loop);
         JL_SIGATOMIC_END();
         if (status < 0) {
             jl_uv_writecb(req, status);
@@ -592,7 +1524,9 @@ JL_DLLEXPORT int jl_printf(uv_stream_t *s, const char *format, ...)
 
 JL_DLLEXPORT void jl_safe_printf(const char *fmt, ...)
 {
-    static char buf[1000];
+    // stack buffer: no allocation, and concurrent callers (or a signal
+    // handler interrupting one) can't clobber each other's message
+    char buf[1000];
     buf[0] = '\0';
 
     va_list args;
@@ -733,9 +1667,9 @@ JL_DLLEXPORT int jl_udp_send(uv_udp_t *handle, uint16_t port, uint32_t host,
     buf[0].len = size;
     uv_udp_send_t *req = (uv_udp_send_t*)malloc(sizeof(uv_udp_send_t));
     req->data = handle->data;
-    JL_UV_LOCK();
+    jl_uv_lock_loop(((uv_handle_t*)handle)->loop);
     int r = uv_udp_send(req, handle, buf, 1, (struct sockaddr*)&addr, cb);
-    JL_UV_UNLOCK();
+    jl_uv_unlock_loop(((uv_handle_t*)handle)->loop);
     return r;
 }
 
@@ -752,9 +1686,9 @@ JL_DLLEXPORT int jl_udp_send6(uv_udp_t *handle, uint16_t port, void *host,
     buf[0].len = size;
     uv_udp_send_t *req = (uv_udp_send_t *) malloc(sizeof(uv_udp_send_t));
     req->data = handle->data;
-    JL_UV_LOCK();
+    jl_uv_lock_loop(((uv_handle_t*)handle)->loop);
     int r = uv_udp_send(req, handle, buf, 1, (struct sockaddr*)&addr, cb);
-    JL_UV_UNLOCK();
+    jl_uv_unlock_loop(((uv_handle_t*)handle)->loop);
     return r;
 }
 
@@ -815,9 +1749,9 @@ JL_DLLEXPORT int jl_getnameinfo6(uv_loop_t *loop, uv_getnameinfo_t *req,
     addr.sin6_port = port;
 
     req->data = NULL;
-    JL_UV_LOCK();
+    jl_uv_lock_loop(loop);
     int r = uv_getnameinfo(loop, req, uvcb, (struct sockaddr*)&addr, flags);
-    JL_UV_UNLOCK();
+    jl_uv_unlock_loop(loop);
     return r;
 }
 
@@ -881,9 +1815,9 @@ JL_DLLEXPORT int jl_tcp4_connect(uv_tcp_t *handle,uint32_t host, uint16_t port,
     addr.sin_family = AF_INET;
     addr.sin_addr.s_addr = host;
     addr.sin_port = port;
-    JL_UV_LOCK();
+    jl_uv_lock_loop(((uv_handle_t*)handle)->loop);
     int r = uv_tcp_connect(req,handle,(struct sockaddr*)&addr,cb);
-    JL_UV_UNLOCK();
+    jl_uv_unlock_loop(((uv_handle_t*)handle)->loop);
     return r;
 }
 
@@ -897,9 +1831,9 @@ JL_DLLEXPORT int jl_tcp6_connect(uv_tcp_t *handle, void *host, uint16_t port,
     addr.sin6_family = AF_INET6;
     memcpy(&addr.sin6_addr, host, 16);
     addr.sin6_port = port;
-    JL_UV_LOCK();
+    jl_uv_lock_loop(((uv_handle_t*)handle)->loop);
     int r = uv_tcp_connect(req,handle,(struct sockaddr*)&addr,cb);
-    JL_UV_UNLOCK();
+    jl_uv_unlock_loop(((uv_handle_t*)handle)->loop);
     return r;
 }
 
@@ -908,9 +1842,9 @@ JL_DLLEXPORT int jl_connect_raw(uv_tcp_t *handle,struct sockaddr_storage *addr,
 {
     uv_connect_t *req = (uv_connect_t*)malloc(sizeof(uv_connect_t));
     req->data = 0;
-    JL_UV_LOCK();
+    jl_uv_lock_loop(((uv_handle_t*)handle)->loop);
     int r = uv_tcp_connect(req,handle,(struct sockaddr*)addr,cb);
-    JL_UV_UNLOCK();
+    jl_uv_unlock_loop(((uv_handle_t*)handle)->loop);
     return r;
 }
 
@@ -956,20 +1890,20 @@ JL_DLLEXPORT int jl_tcp_reuseport(uv_tcp_t *handle)
 JL_DLLEXPORT int jl_uv_unix_fd_is_watched(int fd, uv_poll_t *handle,
                                           uv_loop_t *loop)
 {
-    JL_UV_LOCK();
+    jl_uv_lock_loop(loop);
     if (fd >= loop->nwatchers) {
-        JL_UV_UNLOCK();
+        jl_uv_unlock_loop(loop);
         return 0;
     }
     if (loop->watchers[fd] == NULL) {
-        JL_UV_UNLOCK();
+        jl_uv_unlock_loop(loop);
         return 0;
     }
     if (handle && loop->watchers[fd] == &handle->io_watcher) {
-        JL_UV_UNLOCK();
+        jl_uv_unlock_loop(loop);
         return 0;
     }
-    JL_UV_UNLOCK();
+    jl_uv_unlock_loop(loop);
     return 1;
 }
 
@@ -1084,95 +2018,95 @@ JL_DLLEXPORT int jl_queue_work(work_cb_t work_func, void *work_args, void *work_
 
 JL_DLLEXPORT void jl_uv_stop(uv_loop_t* loop)
 {
-    JL_UV_LOCK();
+    jl_uv_lock_loop(loop);
     uv_stop(loop);
     // TODO: use memory/compiler fence here instead of the lock
-    JL_UV_UNLOCK();
+    jl_uv_unlock_loop(loop);
 }
 
 JL_DLLEXPORT void jl_uv_update_time(uv_loop_t* loop)
 {
-    JL_UV_LOCK();
+    jl_uv_lock_loop(loop);
     uv_update_time(loop);
-    JL_UV_UNLOCK();
+    jl_uv_unlock_loop(loop);
 }
 
 JL_DLLEXPORT int jl_uv_timer_start(uv_timer_t* handle, uv_timer_cb cb,
                                    uint64_t timeout, uint64_t repeat)
 {
-    JL_UV_LOCK();
+    jl_uv_lock_loop(((uv_handle_t*)handle)->loop);
     int r = uv_timer_start(handle, cb, timeout, repeat);
-    JL_UV_UNLOCK();
+    jl_uv_unlock_loop(((uv_handle_t*)handle)->loop);
     return r;
 }
 
 JL_DLLEXPORT int jl_uv_timer_stop(uv_timer_t* handle)
 {
-    JL_UV_LOCK();
+    jl_uv_lock_loop(((uv_handle_t*)handle)->loop);
     int r = uv_timer_stop(handle);
-    JL_UV_UNLOCK();
+    jl_uv_unlock_loop(((uv_handle_t*)handle)->loop);
     return r;
 }
 
 JL_DLLEXPORT int jl_uv_fs_scandir(uv_loop_t* loop, uv_fs_t* req, const char* path, int flags,
                                   uv_fs_cb cb)
 {
-    JL_UV_LOCK();
+    jl_uv_lock_loop(loop);
     int r = uv_fs_scandir(loop, req, path, flags, cb);
-    JL_UV_UNLOCK();
+    jl_uv_unlock_loop(loop);
     return r;
 }
 
 JL_DLLEXPORT int jl_uv_fs_readlink(uv_loop_t* loop, uv_fs_t* req, const char* path,
                                    uv_fs_cb cb)
 {
-    JL_UV_LOCK();
+    jl_uv_lock_loop(loop);
     int r = uv_fs_readlink(loop, req, path, cb);
-    JL_UV_UNLOCK();
+    jl_uv_unlock_loop(loop);
     return r;
 }
 
 JL_DLLEXPORT int jl_uv_fs_open(uv_loop_t* loop, uv_fs_t* req, const char* path, int flags,
                                int mode, uv_fs_cb cb)
 {
-    JL_UV_LOCK();
+    jl_uv_lock_loop(loop);
     int r = uv_fs_open(loop, req, path, flags, mode, cb);
-    JL_UV_UNLOCK();
+    jl_uv_unlock_loop(loop);
     return r;
 }
 
 JL_DLLEXPORT int jl_uv_fs_ftruncate(uv_loop_t* loop, uv_fs_t* req, uv_os_fd_t handle,
                                     int64_t offset, uv_fs_cb cb)
 {
-    JL_UV_LOCK();
+    jl_uv_lock_loop(loop);
     int r = uv_fs_ftruncate(loop, req, handle, offset, cb);
-    JL_UV_UNLOCK();
+    jl_uv_unlock_loop(loop);
     return r;
 }
 
 JL_DLLEXPORT int jl_uv_fs_futime(uv_loop_t* loop, uv_fs_t* req, uv_os_fd_t handle, double atime,
                                  double mtime, uv_fs_cb cb)
 {
-    JL_UV_LOCK();
+    jl_uv_lock_loop(loop);
     int r = uv_fs_futime(loop, req, handle, atime, mtime, cb);
-    JL_UV_UNLOCK();
+    jl_uv_unlock_loop(loop);
     return r;
 }
 
 JL_DLLEXPORT int jl_uv_read_start(uv_stream_t* handle, uv_alloc_cb alloc_cb,
                                   uv_read_cb read_cb)
 {
-    JL_UV_LOCK();
+    jl_uv_lock_loop(((uv_handle_t*)handle)->loop);
     int r = uv_read_start(handle, alloc_cb, read_cb);
-    JL_UV_UNLOCK();
+    jl_uv_unlock_loop(((uv_handle_t*)handle)->loop);
     return r;
 }
 
 JL_DLLEXPORT int jl_uv_read_stop(uv_stream_t* handle)
 {
-    JL_UV_LOCK();
+    jl_uv_lock_loop(((uv_handle_t*)handle)->loop);
     int r = uv_read_stop(handle);
-    JL_UV_UNLOCK();
+    jl_uv_unlock_loop(((uv_handle_t*)handle)->loop);
     return r;
 }
 
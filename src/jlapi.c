@@ -14,6 +14,7 @@
 #include "options.h"
 #include "julia_assert.h"
 #include "julia_internal.h"
+#include "threading.h"
 
 #ifdef __cplusplus
 #include <cfenv>
@@ -83,6 +84,54 @@ JL_DLLEXPORT void jl_init(void)
     free(libbindir);
 }
 
+// prefork ("zygote") support: initialize one parent process fully (jl_init
+// plus whatever package loads the embedder wants baked in), then fork
+// request-handler children that share every loaded page copy-on-write.
+// Unix only; the runtime must be single-threaded, since only the forking
+// thread survives into the child.
+
+// call in the parent, immediately before fork(2); returns 0 if forking is
+// supported in the current configuration
+JL_DLLEXPORT int jl_prefork_prepare(void)
+{
+#if defined(_OS_WINDOWS_)
+    return -1; // no fork
+#else
+    if (jl_n_threads > 1)
+        return -1; // partr worker threads would not survive the fork
+    jl_flush_cstdio();
+    // drain pending uv callbacks so they don't run (twice) in the child
+    if (jl_io_loop)
+        uv_run(jl_io_loop, UV_RUN_NOWAIT);
+    return 0;
+#endif
+}
+
+// call in the child, immediately after fork(2), before any other runtime
+// use; returns 0 on success
+JL_DLLEXPORT int jl_postfork_child(void)
+{
+#if defined(_OS_WINDOWS_)
+    return -1;
+#else
+    // the uv backend fd (epoll/kqueue) is shared with the parent until the
+    // loop is told about the fork
+    if (jl_io_loop && uv_loop_fork(jl_io_loop) != 0)
+        return -1;
+    // the signal-listener thread did not survive the fork; the inherited
+    // sigmask still blocks the listened set on this thread, so just start
+    // a fresh listener
+    restore_signals();
+    return 0;
+#endif
+}
+
+// call in the parent after fork(2); currently nothing to repair there, but
+// embedders should use it for forward compatibility
+JL_DLLEXPORT void jl_postfork_parent(void)
+{
+}
+
 JL_DLLEXPORT jl_value_t *jl_eval_string(const char *str)
 {
     jl_value_t *r;
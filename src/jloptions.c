@@ -70,7 +70,8 @@ jl_options_t jl_options = { 0,    // quiet
                             NULL, // output-ji
                             NULL,    // output-code_coverage
                             0, // incremental
-                            0 // image_file_specified
+                            0, // image_file_specified
+                            NULL // trace_startup
 };
 
 static const char usage[] = "julia [switches] -- [programfile] [args...]\n";
@@ -149,6 +150,10 @@ static const char opts_hidden[]  =
     " --output-jit-bc name      Dump all IR generated by the frontend (not including system image)\n"
     " --output-bc name          Generate LLVM bitcode (.bc)\n"
     " --output-incremental=no   Generate an incremental output file (rather than complete)\n\n"
+
+    // startup debugging
+    " --trace-startup name      Write a chrome-trace (JSON) timeline of the runtime init phases,\n"
+    "                           including per-module __init__ times, to the named file\n\n"
 ;
 
 JL_DLLEXPORT void jl_parse_opts(int *argcp, char ***argvp)
@@ -169,6 +174,7 @@ JL_DLLEXPORT void jl_parse_opts(int *argcp, char ***argvp)
            opt_inline,
            opt_polly,
            opt_trace_compile,
+           opt_trace_startup,
            opt_math_mode,
            opt_worker,
            opt_bind_to,
@@ -225,6 +231,7 @@ JL_DLLEXPORT void jl_parse_opts(int *argcp, char ***argvp)
         { "inline",          required_argument, 0, opt_inline },
         { "polly",           required_argument, 0, opt_polly },
         { "trace-compile",   required_argument, 0, opt_trace_compile },
+        { "trace-startup",   required_argument, 0, opt_trace_startup },
         { "math-mode",       required_argument, 0, opt_math_mode },
         { "handle-signals",  required_argument, 0, opt_handle_signals },
         // hidden command line options
@@ -582,6 +589,11 @@ restart_switch:
             if (!jl_options.trace_compile)
                 jl_errorf("fatal error: failed to allocate memory: %s", strerror(errno));
             break;
+         case opt_trace_startup:
+            jl_options.trace_startup = strdup(optarg);
+            if (!jl_options.trace_startup)
+                jl_errorf("fatal error: failed to allocate memory: %s", strerror(errno));
+            break;
         case opt_math_mode:
             if (!strcmp(optarg,"ieee"))
                 jl_options.fast_math = JL_OPTIONS_FAST_MATH_OFF;
@@ -462,6 +462,28 @@ int union_sort_cmp(const void *ap, const void *bp) JL_NOTSAFEPOINT
     }
 }
 
+// raw pointer order; used to bring identical components together before
+// deduplication (the canonical component order is applied afterwards by
+// union_sort_cmp, so the intermediate order does not matter)
+static int union_ptr_cmp(const void *ap, const void *bp) JL_NOTSAFEPOINT
+{
+    char *a = *(char**)ap;
+    char *b = *(char**)bp;
+    return a < b ? -1 : a > b ? 1 : 0;
+}
+
+// whether `t` has no strict subtypes other than Bottom, so that identity is
+// the only way it can make another union component redundant. Concreteness
+// alone does not imply this: tuple types are covariant (Tuple{Int} <:
+// Tuple{Any} with both concrete), the kinds have the corresponding Type{T}s
+// below them (Type{Int} <: DataType), and a Type{T} can equal a kind or
+// another Type without being identical to it, so those are all excluded.
+static int union_component_is_leaf(jl_value_t *t) JL_NOTSAFEPOINT
+{
+    return jl_is_concrete_type(t) && !jl_is_kind(t) && !jl_is_type_type(t) &&
+        !jl_is_tuple_type(t);
+}
+
 JL_DLLEXPORT jl_value_t *jl_type_union(jl_value_t **ts, size_t n)
 {
     if (n == 0) return (jl_value_t*)jl_bottom_type;
@@ -480,15 +502,58 @@ JL_DLLEXPORT jl_value_t *jl_type_union(jl_value_t **ts, size_t n)
     flatten_type_union(ts, n, temp, &count);
     assert(count == nt);
     size_t j;
-    for(i=0; i < nt; i++) {
-        int has_free = temp[i]!=NULL && jl_has_free_typevars(temp[i]);
-        for(j=0; j < nt; j++) {
-            if (j != i && temp[i] && temp[j]) {
-                if (temp[i] == temp[j] || temp[i] == jl_bottom_type ||
-                    temp[j] == (jl_value_t*)jl_any_type ||
-                    (!has_free && !jl_has_free_typevars(temp[j]) &&
-                     jl_subtype(temp[i], temp[j]))) {
+    if (nt <= 8) {
+        for(i=0; i < nt; i++) {
+            int has_free = temp[i]!=NULL && jl_has_free_typevars(temp[i]);
+            for(j=0; j < nt; j++) {
+                if (j != i && temp[i] && temp[j]) {
+                    if (temp[i] == temp[j] || temp[i] == jl_bottom_type ||
+                        temp[j] == (jl_value_t*)jl_any_type ||
+                        (!has_free && !jl_has_free_typevars(temp[j]) &&
+                         jl_subtype(temp[i], temp[j]))) {
+                        temp[i] = NULL;
+                    }
+                }
+            }
+        }
+    }
+    else {
+        // Large unions (e.g. machine-generated unions of many concrete
+        // types) would spend quadratic time in the loop above. Identical
+        // components are deduplicated by sorting on the pointer value
+        // (concrete types are interned, so equal concrete components are
+        // identical), and the pairwise subtype scan then only needs the
+        // components that can have strict subtypes (see
+        // union_component_is_leaf) as absorbers —
+        // O(n log n + n * #non-leaf) overall.
+        size_t k, nnc = 0;
+        size_t *ncidx = (size_t*)alloca(nt * sizeof(size_t));
+        uint8_t *hasfree = (uint8_t*)alloca(nt);
+        qsort(temp, nt, sizeof(jl_value_t*), union_ptr_cmp);
+        for (i = 0; i + 1 < nt; i++) {
+            if (temp[i] == temp[i + 1])
+                temp[i] = NULL;
+        }
+        for (i = 0; i < nt; i++) {
+            if (temp[i] == jl_bottom_type)
+                temp[i] = NULL;
+            if (temp[i] == NULL)
+                continue;
+            hasfree[i] = jl_has_free_typevars(temp[i]);
+            if (!union_component_is_leaf(temp[i]))
+                ncidx[nnc++] = i;
+        }
+        for (i = 0; i < nt; i++) {
+            if (temp[i] == NULL)
+                continue;
+            for (k = 0; k < nnc; k++) {
+                j = ncidx[k];
+                if (j == i || temp[j] == NULL)
+                    continue;
+                if (temp[j] == (jl_value_t*)jl_any_type ||
+                    (!hasfree[i] && !hasfree[j] && jl_subtype(temp[i], temp[j]))) {
                     temp[i] = NULL;
+                    break;
                 }
             }
         }
@@ -662,11 +727,10 @@ static int typekey_eq(jl_datatype_t *tt, jl_value_t **key, size_t n)
 // look up a type in a cache by binary or linear search.
 // if found, returns the index of the found item. if not found, returns
 // ~n, where n is the index where the type should be inserted.
-static ssize_t lookup_type_idx(jl_typename_t *tn, jl_value_t **key, size_t n, int ordered)
+static ssize_t lookup_type_idx(jl_svec_t *cache, jl_value_t **key, size_t n, int ordered)
 {
     if (n==0) return -1;
     if (ordered) {
-        jl_svec_t *cache = tn->cache;
         jl_datatype_t **data = (jl_datatype_t**)jl_svec_data(cache);
         size_t cl = jl_svec_len(cache);
         ssize_t lo = -1;
@@ -693,7 +757,6 @@ static ssize_t lookup_type_idx(jl_typename_t *tn, jl_value_t **key, size_t n, in
         return ~hi;
     }
     else {
-        jl_svec_t *cache = tn->linearcache;
         jl_datatype_t **data = (jl_datatype_t**)jl_svec_data(cache);
         size_t cl = jl_svec_len(cache);
         ssize_t i;
@@ -707,12 +770,33 @@ static ssize_t lookup_type_idx(jl_typename_t *tn, jl_value_t **key, size_t n, in
     }
 }
 
-static jl_value_t *lookup_type(jl_typename_t *tn, jl_value_t **key, size_t n)
+// counters for sizing typecache contention: lookups that hit without the
+// lock vs. lookups that had to fall back to the locked path. increments can
+// race and are allowed to be approximate.
+static uint64_t typecache_lockfree_hits;
+static uint64_t typecache_locked_lookups;
+
+JL_DLLEXPORT void jl_typecache_stats(uint64_t *lockfree_hits, uint64_t *locked_lookups)
+{
+    *lockfree_hits = typecache_lockfree_hits;
+    *locked_lookups = typecache_locked_lookups;
+}
+
+static jl_value_t *lookup_type(jl_typename_t *tn JL_PROPAGATES_ROOT, jl_value_t **key, size_t n)
 {
     JL_TIMING(TYPE_CACHE_LOOKUP);
     int ord = is_typekey_ordered(key, n);
-    ssize_t idx = lookup_type_idx(tn, key, n, ord);
-    jl_value_t *t = (idx < 0) ? NULL : jl_svecref(ord ? tn->cache : tn->linearcache, idx);
+    // snapshot the cache array once; inserts build a fresh copy and publish
+    // it with a release store, so searching the snapshot needs no lock.
+    // root the snapshot: the comparison calls can allocate, and a concurrent
+    // insert may have already unlinked it from the typename.
+    jl_svec_t *cache = jl_atomic_load_acquire(ord ? &tn->cache : &tn->linearcache);
+    jl_value_t *t = NULL;
+    JL_GC_PUSH1(&cache);
+    ssize_t idx = lookup_type_idx(cache, key, n, ord);
+    if (idx >= 0)
+        t = jl_svecref(cache, idx);
+    JL_GC_POP();
     return t;
 }
 
@@ -747,35 +831,32 @@ static void cache_insert_type(jl_value_t *type, ssize_t insert_at, int ordered)
     // assign uid if it hasn't been done already
     if (!jl_is_abstracttype(type) && ((jl_datatype_t*)type)->uid==0)
         ((jl_datatype_t*)type)->uid = jl_assign_type_uid();
-    jl_svec_t *cache;
-    if (ordered)
-        cache = ((jl_datatype_t*)type)->name->cache;
-    else
-        cache = ((jl_datatype_t*)type)->name->linearcache;
+    jl_typename_t *tn = ((jl_datatype_t*)type)->name;
+    jl_svec_t *cache = ordered ? tn->cache : tn->linearcache;
     assert(jl_is_svec(cache));
     size_t n = jl_svec_len(cache);
-    if (n==0 || jl_svecref(cache,n-1) != NULL) {
-        jl_svec_t *nc = jl_alloc_svec(n < 8 ? 8 : (n*3)>>1);
-        memcpy(jl_svec_data(nc), jl_svec_data(cache), sizeof(void*) * n);
-        if (ordered)
-            ((jl_datatype_t*)type)->name->cache = nc;
-        else
-            ((jl_datatype_t*)type)->name->linearcache = nc;
-        jl_gc_wb(((jl_datatype_t*)type)->name, nc);
-        cache = nc;
-        n = jl_svec_len(nc);
-    }
-    jl_value_t **p = jl_svec_data(cache);
+    // never shift the live array in place: build a fresh copy with the new
+    // entry and publish it with a single release store, so concurrent
+    // lock-free readers always see either the old cache or the new one.
+    // writers are still serialized by the typecache lock.
+    size_t nl = (n == 0 || jl_svecref(cache, n - 1) != NULL)
+                ? (n < 8 ? 8 : (n * 3) >> 1) : n;
+    jl_svec_t *nc = jl_alloc_svec(nl);
+    jl_value_t **src = jl_svec_data(cache);
+    jl_value_t **dst = jl_svec_data(nc);
+    memcpy(dst, src, sizeof(void*) * insert_at);
+    dst[insert_at] = (jl_value_t*)type;
+    // copy the tail, shifted one slot right, stopping at the NULL padding
     size_t i = insert_at;
-    jl_value_t *temp = p[i], *temp2;
-    jl_svecset(cache, insert_at, (jl_value_t*)type);
-    assert(i < n-1 || temp == NULL);
-    while (temp != NULL && i < n-1) {
+    while (i < n && src[i] != NULL) {
+        dst[i + 1] = src[i];
         i++;
-        temp2 = p[i];
-        p[i] = temp;
-        temp = temp2;
     }
+    if (ordered)
+        jl_atomic_store_release(&tn->cache, nc);
+    else
+        jl_atomic_store_release(&tn->linearcache, nc);
+    jl_gc_wb(tn, nc);
 }
 
 jl_value_t *jl_cache_type_(jl_datatype_t *type)
@@ -783,7 +864,8 @@ jl_value_t *jl_cache_type_(jl_datatype_t *type)
     if (is_cacheable(type)) {
         JL_TIMING(TYPE_CACHE_INSERT);
         int ord = is_typekey_ordered(jl_svec_data(type->parameters), jl_svec_len(type->parameters));
-        ssize_t idx = lookup_type_idx(type->name, jl_svec_data(type->parameters),
+        ssize_t idx = lookup_type_idx(ord ? type->name->cache : type->name->linearcache,
+                                      jl_svec_data(type->parameters),
                                       jl_svec_len(type->parameters), ord);
         if (idx >= 0)
             type = (jl_datatype_t*)jl_svecref(ord ? type->name->cache : type->name->linearcache, idx);
@@ -1073,7 +1155,6 @@ static jl_value_t *inst_datatype_inner(jl_datatype_t *dt, jl_svec_t *p, jl_value
     int isnamedtuple = (tn == jl_namedtuple_typename);
     // check type cache
     if (cacheable) {
-        JL_LOCK(&typecache_lock); // Might GC
         size_t i;
         for (i = 0; i < ntp; i++) {
             jl_value_t *pi = iparams[i];
@@ -1089,7 +1170,16 @@ static jl_value_t *inst_datatype_inner(jl_datatype_t *dt, jl_svec_t *p, jl_value
                 if (p) jl_gc_wb(p, tw);
             }
         }
+        // first probe without the typecache lock; inserts publish a fresh
+        // cache array, so a snapshot search cannot observe a partial shift
         jl_value_t *lkup = (jl_value_t*)lookup_type(tn, iparams, ntp);
+        if (lkup != NULL) {
+            typecache_lockfree_hits++;
+            return lkup;
+        }
+        JL_LOCK(&typecache_lock); // Might GC
+        typecache_locked_lookups++;
+        lkup = (jl_value_t*)lookup_type(tn, iparams, ntp);
         if (lkup != NULL) {
             JL_UNLOCK(&typecache_lock); // Might GC
             return lkup;
@@ -1320,8 +1410,34 @@ static jl_tupletype_t *jl_apply_tuple_type_v_(jl_value_t **p, size_t np, jl_svec
         if (!jl_is_concrete_type(p[i]))
             cacheable = 0;
     }
+    // dynamic dispatch builds small concrete argument tuples constantly, so
+    // memoize those by component pointers in a thread-local table and skip
+    // the general typecache search; instantiation is hash-consed, so the
+    // cached pointer is the canonical instance (and a GC root)
+    jl_ptls_t ptls = NULL;
+    uint32_t slot = 0;
+    if (cacheable && np >= 1 && np <= N_TUPLE_CACHE_ARGS) {
+        uintptr_t h = (uintptr_t)p[0] >> 4;
+        for (size_t i = 1; i < np; i++)
+            h = (h * 31) ^ ((uintptr_t)p[i] >> 4);
+        ptls = jl_get_ptls_states();
+        slot = (uint32_t)h & (N_TUPLE_CACHE - 1);
+        if (ptls->tuple_type_cache[slot].np == np) {
+            size_t i = 0;
+            while (i < np && ptls->tuple_type_cache[slot].key[i] == p[i])
+                i++;
+            if (i == np)
+                return (jl_tupletype_t*)ptls->tuple_type_cache[slot].result;
+        }
+    }
     jl_datatype_t *ndt = (jl_datatype_t*)inst_datatype(jl_anytuple_type, params, p, np,
                                                        cacheable, NULL);
+    if (ptls) {
+        for (size_t i = 0; i < np; i++)
+            ptls->tuple_type_cache[slot].key[i] = p[i];
+        ptls->tuple_type_cache[slot].result = (jl_value_t*)ndt;
+        ptls->tuple_type_cache[slot].np = np;
+    }
     return ndt;
 }
 
@@ -15,6 +15,7 @@
 
 #include "htable.h"
 #include "arraylist.h"
+#include "arena.h"
 #include "analyzer_annotations.h"
 
 #include <setjmp.h>
@@ -737,8 +738,98 @@ JL_DLLEXPORT int64_t jl_gc_diff_total_bytes(void);
 
 JL_DLLEXPORT void jl_gc_collect(int);
 
+// collection pacing (see gc.c for the semantics of each knob)
+JL_DLLEXPORT void jl_gc_set_max_heap_size(uint64_t bytes);
+JL_DLLEXPORT void jl_gc_set_pause_budget(uint64_t ns);
+JL_DLLEXPORT void jl_gc_set_interval_growth(double factor);
+
+// promotion tuning and per-size-class tenuring statistics (see gc.c)
+JL_DLLEXPORT void jl_gc_set_promote_age(int age);
+JL_DLLEXPORT int jl_gc_get_promote_age(void);
+JL_DLLEXPORT uint64_t jl_gc_pool_survived(int klass);
+JL_DLLEXPORT uint64_t jl_gc_pool_promoted(int klass);
+JL_DLLEXPORT void jl_gc_reset_tenure_stats(void);
+JL_DLLEXPORT int jl_gc_sizeclass_count(void);
+JL_DLLEXPORT int jl_gc_sizeclass_size(int klass);
+JL_DLLEXPORT void jl_gc_sizeclass_stats(uint64_t *live, uint64_t *nfree, uint64_t *npages);
+JL_DLLEXPORT void jl_gc_fragmentation_report(void);
+// Always-on GC telemetry. All counters are cumulative since startup except
+// the remset fields, which describe the most recent collection. The phase
+// times are in nanoseconds. The counters are updated while the world is
+// stopped, so a monitoring thread can read them at any time without
+// synchronization and only risks slightly stale values.
+typedef struct {
+    uint64_t collections;     // number of collections
+    uint64_t full_sweeps;     // collections that ended in a full sweep
+    uint64_t mark_time;       // time spent marking
+    uint64_t sweep_pool_time; // time spent sweeping pool pages
+    uint64_t sweep_big_time;  // time spent sweeping big objects and malloc'd arrays
+    uint64_t finalizer_time;  // time spent running finalizers
+    uint64_t total_pause;     // total stop-the-world time
+    uint64_t remset_len;      // remembered-set entries at the last collection
+    uint64_t remset_nptr;     // old-to-young pointers at the last collection
+    uint64_t pages_swept;     // pool pages visited while sweeping
+    uint64_t pages_freed;     // pool pages released by the sweep
+    uint64_t promoted_bytes;  // bytes promoted to the old generation
+} jl_gc_telemetry_t;
+JL_DLLEXPORT void jl_gc_telemetry(jl_gc_telemetry_t *stats);
+
+// Per-collection pause records (see gc.c). The runtime retains the most
+// recent collections in a fixed ring; jl_gc_pause_percentile computes a
+// nearest-rank percentile of the retained pauses, optionally restricted
+// to quick (full=0) or full (full=1) sweeps.
+typedef struct {
+    uint64_t pause;       // stop-the-world time for this collection (ns)
+    uint64_t mark_time;   // portion spent marking (ns)
+    uint64_t sweep_time;  // portion spent sweeping pools and big objects (ns)
+    int64_t  freed;       // estimated bytes freed
+    uint64_t pages_swept; // pool pages visited while sweeping
+    uint8_t  full_sweep;  // 1 if the collection ended in a full sweep
+} jl_gc_pause_record_t;
+JL_DLLEXPORT uint64_t jl_gc_pause_count(void);
+JL_DLLEXPORT int jl_gc_pause_record(uint64_t i, jl_gc_pause_record_t *rec);
+JL_DLLEXPORT uint64_t jl_gc_pause_percentile(double p, int full);
+
+// Compilation telemetry (see gf.c). When enabled with
+// jl_compile_log_enable, the runtime appends one record per inference run,
+// codegen invocation and native code emission to a fixed ring, so a stalled
+// service can be asked after the fact what compiled and why.
+typedef struct {
+    struct _jl_method_instance_t *mi; // identity only; not a GC root
+    uint64_t t_ns;        // jl_hrtime timestamp when the event completed
+    uint64_t duration_ns; // inference/codegen time (0 for native events)
+    uint64_t native_size; // emitted machine code bytes (native events only)
+    uint8_t  kind;        // JL_COMPILE_EV_*
+    uint8_t  recompile;   // 1 when an invalidation forced the recompile
+} jl_compile_event_t;
+#define JL_COMPILE_EV_INFERENCE 0
+#define JL_COMPILE_EV_CODEGEN   1
+#define JL_COMPILE_EV_NATIVE    2
+JL_DLLEXPORT int jl_compile_log_enable(int enable);
+JL_DLLEXPORT uint64_t jl_compile_log_count(void);
+JL_DLLEXPORT int jl_compile_log_get(uint64_t i, jl_compile_event_t *ev);
+JL_DLLEXPORT void jl_compile_log_dump(void);
+
+// Hardware performance counter groups (Linux perf_event_open; see
+// timing.c). Counters are per-thread: each thread that wants them calls
+// _open once and _read thereafter. Values are corrected for kernel
+// multiplexing by the time_enabled/time_running ratio. On other platforms
+// _open and _read return -1.
+typedef struct {
+    uint64_t cycles;
+    uint64_t instructions;
+    uint64_t cache_misses;  // last-level cache misses
+    uint64_t branch_misses;
+} jl_perf_counters_t;
+JL_DLLEXPORT int jl_perf_counters_open(void);
+JL_DLLEXPORT int jl_perf_counters_read(jl_perf_counters_t *out);
+JL_DLLEXPORT void jl_perf_counters_close(void);
+
 JL_DLLEXPORT void jl_gc_add_finalizer(jl_value_t *v, jl_function_t *f);
 JL_DLLEXPORT void jl_finalize(jl_value_t *o);
+// batched asynchronous finalization (see gc.c)
+extern JL_DLLEXPORT volatile int jl_gc_have_pending_finalizers;
+JL_DLLEXPORT void jl_gc_run_pending_finalizers(void);
 JL_DLLEXPORT jl_weakref_t *jl_gc_new_weakref(jl_value_t *value);
 JL_DLLEXPORT jl_value_t *jl_gc_alloc_0w(void);
 JL_DLLEXPORT jl_value_t *jl_gc_alloc_1w(void);
@@ -1359,6 +1450,7 @@ JL_DLLEXPORT void jl_array_del_end(jl_array_t *a, size_t dec);
 JL_DLLEXPORT void jl_array_grow_beg(jl_array_t *a, size_t inc);
 JL_DLLEXPORT void jl_array_del_beg(jl_array_t *a, size_t dec);
 JL_DLLEXPORT void jl_array_sizehint(jl_array_t *a, size_t sz);
+JL_DLLEXPORT void jl_array_shrink_to_fit(jl_array_t *a);
 JL_DLLEXPORT void jl_array_ptr_1d_push(jl_array_t *a, jl_value_t *item);
 JL_DLLEXPORT void jl_array_ptr_1d_append(jl_array_t *a, jl_array_t *a2);
 JL_DLLEXPORT jl_value_t *jl_apply_array_type(jl_value_t *type, size_t dim);
@@ -1507,6 +1599,10 @@ JL_DLLEXPORT void jl_init_with_image(const char *julia_bindir,
 JL_DLLEXPORT const char *jl_get_default_sysimg_path(void);
 JL_DLLEXPORT int jl_is_initialized(void);
 JL_DLLEXPORT void jl_atexit_hook(int status);
+// prefork ("zygote") worker spawning, see jlapi.c
+JL_DLLEXPORT int jl_prefork_prepare(void);
+JL_DLLEXPORT int jl_postfork_child(void);
+JL_DLLEXPORT void jl_postfork_parent(void);
 JL_DLLEXPORT void JL_NORETURN jl_exit(int status);
 JL_DLLEXPORT const char *jl_pathname_for_handle(void *handle);
 
@@ -1603,6 +1699,16 @@ JL_DLLEXPORT jl_value_t *jl_apply_generic(jl_value_t **args, uint32_t nargs);
 JL_DLLEXPORT jl_value_t *jl_invoke(jl_method_instance_t *meth, jl_value_t **args, uint32_t nargs);
 JL_DLLEXPORT int32_t jl_invoke_api(jl_code_instance_t *linfo);
 
+// native code size accounting (see debuginfo.cpp): accumulated over all code
+// ever emitted for a method instance, to locate over-specialized methods
+typedef struct {
+    uint64_t native_bytes;  // machine code emitted
+    uint64_t nrelocs;       // relocations applied to that code
+    uint64_t gcframe_bytes; // stack GC frame slots, incl. the 2-slot header
+    uint64_t nfuncs;        // function symbols (entry point + specsig etc.)
+} jl_code_size_stats_t;
+JL_DLLEXPORT int jl_code_size_stats(jl_method_instance_t *mi, jl_code_size_stats_t *stats);
+
 STATIC_INLINE
 jl_value_t *jl_apply(jl_value_t **args, uint32_t nargs)
 {
@@ -1788,6 +1894,12 @@ typedef struct {
 #endif
 
 JL_DLLEXPORT void jl_uv_puts(uv_stream_t *stream, const char *str, size_t n) JL_NOTSAFEPOINT;
+JL_DLLEXPORT int jl_uv_write_batched(uv_stream_t *stream, const char *data, size_t n);
+JL_DLLEXPORT void jl_uv_flush_pending(uv_stream_t *stream);
+JL_DLLEXPORT char *jl_uv_alloc_read_buf(uv_loop_t *loop, size_t suggested, size_t *len);
+JL_DLLEXPORT void jl_uv_free_read_buf(uv_loop_t *loop, char *base);
+JL_DLLEXPORT void jl_uv_pooled_alloc_cb(uv_handle_t *handle, size_t suggested_size,
+                                        uv_buf_t *buf);
 JL_DLLEXPORT int jl_printf(uv_stream_t *s, const char *format, ...) JL_NOTSAFEPOINT
     _JL_FORMAT_ATTR(printf, 2, 3);
 JL_DLLEXPORT int jl_vprintf(uv_stream_t *s, const char *format, va_list args) JL_NOTSAFEPOINT
@@ -1808,6 +1920,8 @@ JL_DLLEXPORT void jl_flush_cstdio(void) JL_NOTSAFEPOINT;
 JL_DLLEXPORT jl_value_t *jl_stdout_obj(void) JL_NOTSAFEPOINT;
 JL_DLLEXPORT jl_value_t *jl_stderr_obj(void) JL_NOTSAFEPOINT;
 JL_DLLEXPORT size_t jl_static_show(JL_STREAM *out, jl_value_t *v) JL_NOTSAFEPOINT;
+JL_DLLEXPORT size_t jl_static_show_bounded(JL_STREAM *out, jl_value_t *v,
+                                           size_t max_depth, size_t max_bytes) JL_NOTSAFEPOINT;
 JL_DLLEXPORT size_t jl_static_show_func_sig(JL_STREAM *s, jl_value_t *type) JL_NOTSAFEPOINT;
 JL_DLLEXPORT void jlbacktrace(void);
 // Mainly for debugging, use `void*` so that no type cast is needed in C++.
@@ -1856,6 +1970,7 @@ typedef struct {
     const char *output_code_coverage;
     int8_t incremental;
     int8_t image_file_specified;
+    const char *trace_startup;
 } jl_options_t;
 
 extern JL_DLLEXPORT jl_options_t jl_options;
@@ -1963,6 +2078,11 @@ typedef struct {
     int static_alloc;       // is the compiler allowed to allocate statically?
     int prefer_specsig;     // are specialized function signatures preferred?
 
+    // lean codegen for throughput-oriented workloads: disabling these trades
+    // debuggability for compile time and code size
+    int debug_info;         // can we emit DWARF debug info?
+    int safepoints;         // can we emit explicit GC safepoint polls?
+
 
     // hooks
 
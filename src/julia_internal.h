@@ -118,6 +118,12 @@ extern jl_mutex_t jl_uv_mutex;
 extern int jl_uv_n_waiters;
 void JL_UV_LOCK(void);
 #define JL_UV_UNLOCK() JL_UNLOCK(&jl_uv_mutex)
+// per-loop locking for auxiliary event loops (jl_uv.c); both fall back to
+// JL_UV_LOCK/JL_UV_UNLOCK when `loop` is the global jl_io_loop
+void jl_uv_lock_loop(uv_loop_t *loop);
+void jl_uv_unlock_loop(uv_loop_t *loop);
+JL_DLLEXPORT uv_loop_t *jl_new_event_loop(void);
+JL_DLLEXPORT int jl_close_event_loop(uv_loop_t *loop);
 
 #ifdef __cplusplus
 extern "C" {
@@ -150,6 +156,11 @@ STATIC_INLINE uint32_t jl_int32hash_fast(uint32_t a)
 // useful constants
 extern jl_methtable_t *jl_type_type_mt JL_GLOBALLY_ROOTED;
 JL_DLLEXPORT extern size_t jl_world_counter;
+// world-age batching for top-level evaluation (see gf.c)
+void jl_world_batch_begin(void);
+void jl_world_batch_end(void);
+void jl_world_batch_break(void);
+size_t jl_world_counter_next(void);
 
 typedef void (*tracer_cb)(jl_value_t *tracee);
 void jl_call_tracer(tracer_cb callback, jl_value_t *tracee);
@@ -164,6 +175,8 @@ JL_DLLEXPORT extern const char *jl_filename;
 JL_DLLEXPORT jl_value_t *jl_gc_pool_alloc(jl_ptls_t ptls, int pool_offset,
                                           int osize);
 JL_DLLEXPORT jl_value_t *jl_gc_big_alloc(jl_ptls_t ptls, size_t allocsz);
+JL_DLLEXPORT void jl_gc_leaf_check_begin(void) JL_NOTSAFEPOINT;
+JL_DLLEXPORT void jl_gc_leaf_check_end(void) JL_NOTSAFEPOINT;
 int jl_gc_classify_pools(size_t sz, int *osize);
 extern jl_mutex_t gc_perm_lock;
 void *jl_gc_perm_alloc_nolock(size_t sz, int zero,
@@ -175,6 +188,12 @@ void gc_sweep_sysimg(void);
 
 
 // pools are 16376 bytes large (GC_POOL_SZ - GC_PAGE_OFFSET)
+// The portion of the table above 16 bytes can be specialized at build time
+// from a measured allocation profile by defining `JL_GC_SIZECLASSES` (the
+// class sizes, 16-byte aligned, ending at 2032) together with the matching
+// `JL_GC_SZCLASS_TABLE` lookup table; both are computed with the formulas
+// in the comments below and the number of classes must stay `JL_GC_N_POOLS`.
+// Per-class occupancy can be measured with `jl_gc_sizeclass_stats`.
 static const int jl_gc_sizeclasses[] = {
 #ifdef _P64
     8,
@@ -186,6 +205,9 @@ static const int jl_gc_sizeclasses[] = {
     4, 8, 12,
 #endif
 
+#ifdef JL_GC_SIZECLASSES
+    JL_GC_SIZECLASSES
+#else
     // 16 pools at 16-byte spacing
     16, 32, 48, 64, 80, 96, 112, 128,
     144, 160, 176, 192, 208, 224, 240, 256,
@@ -207,6 +229,7 @@ static const int jl_gc_sizeclasses[] = {
     1088, 1168, 1248, 1360, 1488, 1632, 1808, 2032
 //    15,   14,   13,   12,   11,   10,    9,    8, /pool
 //    64,   32,  160,   64,   16,   64,  112,  128, bytes lost
+#endif
 };
 static_assert(sizeof(jl_gc_sizeclasses) / sizeof(jl_gc_sizeclasses[0]) == JL_GC_N_POOLS, "");
 
@@ -234,7 +257,11 @@ JL_DLLEXPORT int jl_alignment(size_t sz);
 
 // the following table is computed from jl_gc_sizeclasses via the formula:
 // [searchsortedfirst(TABLE, i) for i = 0:16:table[end]]
+#ifdef JL_GC_SZCLASS_TABLE
+static const uint8_t szclass_table[] = {JL_GC_SZCLASS_TABLE};
+#else
 static const uint8_t szclass_table[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 20, 21, 21, 22, 22, 23, 23, 23, 24, 24, 24, 25, 25, 25, 26, 26, 27, 27, 27, 28, 28, 28, 29, 29, 29, 29, 30, 30, 30, 30, 30, 31, 31, 31, 31, 31, 32, 32, 32, 32, 32, 32, 32, 33, 33, 33, 33, 33, 34, 34, 34, 34, 34, 35, 35, 35, 35, 35, 36, 36, 36, 36, 36, 36, 36, 37, 37, 37, 37, 37, 37, 37, 37, 38, 38, 38, 38, 38, 38, 38, 38, 38, 39, 39, 39, 39, 39, 39, 39, 39, 39, 39, 39, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40};
+#endif
 static_assert(sizeof(szclass_table) == 128, "");
 
 STATIC_INLINE uint8_t JL_CONST_FUNC jl_gc_szclass(unsigned sz)
@@ -342,7 +369,26 @@ JL_DLLEXPORT jl_code_instance_t *jl_get_method_inferred(
         size_t min_world, size_t max_world);
 jl_method_instance_t *jl_get_unspecialized(jl_method_instance_t *method);
 
+// tiered execution (see gf.c): interpreted-first dispatch with background
+// compilation of hot method instances, enabled by JULIA_TIERED_COMPILE
+extern JL_DLLEXPORT volatile int jl_have_pending_compiles;
+extern arraylist_t tiered_compile_queue;
+JL_DLLEXPORT jl_value_t *jl_fptr_tiered_call(jl_code_instance_t *m, jl_value_t **args, uint32_t nargs);
+JL_DLLEXPORT void jl_compile_pending_hot_methods(void);
+// raise the JIT optimization level for subsequent compiles (see jitlayers.cpp)
+JL_DLLEXPORT void jl_set_jit_opt_level_boost(int level);
+JL_DLLEXPORT int jl_jit_compiling_hot_code(void);
+// merge several pending functions into one JIT compile unit (see jitlayers.cpp)
+JL_DLLEXPORT void jl_finalize_function_batch(const char **fnames, size_t n);
+
 JL_DLLEXPORT int jl_compile_hint(jl_tupletype_t *types);
+// runtime toggle for --trace-compile; NULL or "" stops tracing
+JL_DLLEXPORT void jl_set_trace_compile(const char *fname);
+// compilation telemetry (gf.c); the public query API is in julia.h
+extern JL_DLLEXPORT int jl_compile_log_enabled;
+void jl_compile_log_event(jl_method_instance_t *mi, int kind, int recompile,
+                          uint64_t duration_ns, uint64_t native_size);
+int jl_compile_log_invalidated(jl_method_instance_t *mi, size_t world);
 jl_code_info_t *jl_code_for_interpreter(jl_method_instance_t *lam);
 int jl_code_requires_compiler(jl_code_info_t *src) JL_NOTSAFEPOINT;
 jl_code_info_t *jl_new_code_info_from_ast(jl_expr_t *ast);
@@ -422,6 +468,7 @@ int jl_has_concrete_subtype(jl_value_t *typ) JL_NOTSAFEPOINT;
 jl_datatype_t *jl_inst_concrete_tupletype_v(jl_value_t **p, size_t np) JL_ALWAYS_LEAFTYPE;
 jl_datatype_t *jl_inst_concrete_tupletype(jl_svec_t *p) JL_ALWAYS_LEAFTYPE;
 JL_DLLEXPORT void jl_method_table_insert(jl_methtable_t *mt, jl_method_t *method, jl_tupletype_t *simpletype);
+void jl_method_table_insert_batch(jl_methtable_t *mt, jl_array_t *pairs);
 jl_datatype_t *jl_mk_builtin_func(jl_datatype_t *dt, const char *name, jl_fptr_args_t fptr) JL_GC_DISABLED;
 jl_value_t *jl_type_intersection_env_s(jl_value_t *a, jl_value_t *b, jl_svec_t **penv, int *issubty);
 jl_value_t *jl_type_intersection_env(jl_value_t *a, jl_value_t *b, jl_svec_t **penv);
@@ -465,6 +512,20 @@ jl_method_instance_t *jl_method_lookup(jl_methtable_t *mt JL_PROPAGATES_ROOT,
     jl_value_t **args, size_t nargs, int cache, size_t world);
 jl_value_t *jl_gf_invoke(jl_value_t *types, jl_value_t **args, size_t nargs);
 jl_method_instance_t *jl_lookup_generic(jl_value_t **args, uint32_t nargs, uint32_t callsite, size_t world) JL_ALWAYS_LEAFTYPE;
+
+// Per-callsite dispatch cache (polymorphic inline cache). Codegen allocates
+// one of these per dynamic call site and embeds its address into the
+// generated code (session-local, so only when not generating output); the
+// entries are filled by jl_lookup_generic_ and walked by the GC.
+#define N_SITE_CACHE 4
+typedef struct _jl_callsite_cache_t {
+    jl_typemap_entry_t *entries[N_SITE_CACHE];
+    uint8_t pick_which;
+    struct _jl_callsite_cache_t *next; // linked list of all site caches, for GC marking
+} jl_callsite_cache_t;
+jl_callsite_cache_t *jl_new_callsite_cache(void);
+JL_DLLEXPORT jl_value_t *jl_apply_generic_site(jl_value_t *cache, jl_value_t **args, uint32_t nargs);
+JL_DLLEXPORT jl_value_t *jl_apply_generic_stmt(jl_value_t **slot, jl_value_t **args, uint32_t nargs);
 JL_DLLEXPORT jl_value_t *jl_matching_methods(jl_tupletype_t *types, int lim, int include_ambiguous,
                                              size_t world, size_t *min_valid, size_t *max_valid);
 
@@ -478,9 +539,22 @@ jl_array_t *jl_new_array_for_deserialization(jl_value_t *atype, uint32_t ndims,
                                              int isunboxed, int isunion, int elsz);
 void jl_module_run_initializer(jl_module_t *m);
 jl_binding_t *jl_get_module_binding(jl_module_t *m JL_PROPAGATES_ROOT, jl_sym_t *var) JL_NOTSAFEPOINT;
+void jl_binding_deprecation_warning(jl_module_t *m, jl_binding_t *b);
+// with JULIA_LAZY_MODULE_BINDINGS, sysimage restore leaves each module's
+// binding hash table unbuilt (table == NULL, size == binding count) until the
+// module is first touched; call this before reading m->bindings
+void jl_module_rebuild_bindings(jl_module_t *m) JL_NOTSAFEPOINT; // staticdata.c
+STATIC_INLINE void jl_module_ensure_bindings(jl_module_t *m) JL_NOTSAFEPOINT
+{
+    // acquire pairs with the release-publish of the rebuilt table in
+    // jl_module_rebuild_bindings; the non-NULL fast path takes no lock
+    if (__unlikely(jl_atomic_load_acquire(&m->bindings.table) == NULL))
+        jl_module_rebuild_bindings(m);
+}
 extern jl_array_t *jl_module_init_order JL_GLOBALLY_ROOTED;
 extern htable_t jl_current_modules JL_GLOBALLY_ROOTED;
 extern jl_array_t *jl_cfunction_list JL_GLOBALLY_ROOTED;
+extern jl_array_t *jl_cfunction_tramp_list JL_GLOBALLY_ROOTED;
 
 #ifdef JL_USE_INTEL_JITEVENTS
 extern char jl_using_intel_jitevents;
@@ -492,6 +566,9 @@ extern char jl_using_oprofile_jitevents;
 extern char jl_using_perf_jitevents;
 #endif
 extern size_t jl_arr_xtralloc_limit;
+extern size_t jl_arr_growth_pct;
+extern size_t jl_arr_growth_thresh;
+extern size_t jl_nt_copy_thresh;
 
 void jl_init_types(void) JL_GC_DISABLED;
 void jl_init_box_caches(void);
@@ -518,6 +595,9 @@ extern ssize_t jl_tls_offset;
 extern const int jl_tls_elf_support;
 void jl_init_threading(void);
 void jl_start_threads(void);
+// spawn workers deferred by JULIA_LAZY_THREADS (see threading.c)
+void jl_ensure_threads_started(void);
+extern int jl_n_threads_configured;
 
 // Whether the GC is running
 extern char *jl_safepoint_pages;
@@ -550,6 +630,11 @@ void jl_safepoint_end_gc(void);
 // This function does **NOT** modify the `gc_state` to inform the GC thread
 // The caller should set it **BEFORE** calling this function.
 void jl_safepoint_wait_gc(void);
+// Called from `jl_safepoint_wait_gc` to let the spinning threads
+// participate in the parallel mark phase (see gc.c).
+void jl_gc_mark_worker_from_safepoint(void);
+// Same, for the parallel sweep of the big object shards.
+void jl_gc_sweep_worker_from_safepoint(void);
 
 // Set pending sigint and enable the mechanisms to deliver the sigint.
 void jl_safepoint_enable_sigint(void);
@@ -580,6 +665,9 @@ static inline void jl_set_gc_and_wait(void)
 JL_DLLEXPORT jl_value_t *jl_dump_fptr_asm(uint64_t fptr, int raw_mc, const char *asm_variant, const char *debuginfo);
 void jl_dump_native(const char *bc_fname, const char *unopt_bc_fname, const char *obj_fname, const char *sysimg_data, size_t sysimg_len);
 int32_t jl_get_llvm_gv(jl_value_t *p) JL_NOTSAFEPOINT;
+// zlib via LLVM, for compressed .ji bodies (jitlayers.cpp)
+JL_DLLEXPORT char *jl_zlib_compress(const char *src, size_t n, size_t *outn);
+JL_DLLEXPORT int jl_zlib_uncompress(const char *src, size_t n, char *dst, size_t dstn);
 int32_t jl_assign_functionID(const char *fname);
 
 // the first argument to jl_idtable_rehash is used to return a value
@@ -651,6 +739,9 @@ typedef int bt_cursor_t;
 #define JL_BT_INTERP_FRAME (((uintptr_t)0)-1)
 size_t rec_backtrace(uintptr_t *data, size_t maxsize) JL_NOTSAFEPOINT;
 size_t rec_backtrace_ctx(uintptr_t *data, size_t maxsize, bt_context_t *ctx) JL_NOTSAFEPOINT;
+// fast frame-pointer-chain walker; stops at the first frame without a
+// frame pointer, falling back to rec_backtrace_ctx is the caller's job
+size_t rec_backtrace_ctx_fp(uintptr_t *data, size_t maxsize, bt_context_t *ctx) JL_NOTSAFEPOINT;
 #ifdef LIBOSXUNWIND
 size_t rec_backtrace_ctx_dwarf(uintptr_t *data, size_t maxsize, bt_context_t *ctx);
 #endif
@@ -659,6 +750,12 @@ void jl_critical_error(int sig, bt_context_t *context, uintptr_t *bt_data, size_
 JL_DLLEXPORT void jl_raise_debugger(void);
 int jl_getFunctionInfo(jl_frame_t **frames, uintptr_t pointer, int skipC, int noInline);
 JL_DLLEXPORT void jl_gdblookup(uintptr_t ip);
+// named-lock contention statistics (threading.c)
+void jl_lock_register(jl_mutex_t *lock, const char *name);
+JL_DLLEXPORT int jl_lock_profile(int i, const char **name, uint64_t *nacquire,
+                                 uint64_t *ncontended, uint64_t *wait_ns,
+                                 uint64_t *wait_ns_max, uintptr_t *contended_ip);
+JL_DLLEXPORT void jl_print_lock_stats(void);
 // *to is NULL or malloc'd pointer, from is allowed to be NULL
 STATIC_INLINE char *jl_copy_str(char **to, const char *from)
 {
@@ -876,6 +973,11 @@ extern jl_mutex_t typecache_lock;
 extern jl_mutex_t codegen_lock;
 extern jl_mutex_t safepoint_lock;
 
+// string interning cache (array.c, enabled via `JULIA_STRING_INTERN`);
+// the GC treats the occupied slots as roots while the cache is active
+#define JL_STRING_INTERN_CACHE_SZ 8192
+extern jl_value_t **jl_string_intern_cache;
+
 // -- gc.c -- //
 
 #if defined(__APPLE__) && defined(JULIA_ENABLE_THREADING)
@@ -1043,6 +1145,7 @@ extern jl_sym_t *copyast_sym; extern jl_sym_t *cfunction_sym;
 extern jl_sym_t *pure_sym; extern jl_sym_t *loopinfo_sym;
 extern jl_sym_t *meta_sym; extern jl_sym_t *inert_sym;
 extern jl_sym_t *polly_sym; extern jl_sym_t *unused_sym;
+extern jl_sym_t *multiversion_sym;
 extern jl_sym_t *static_parameter_sym; extern jl_sym_t *inline_sym;
 extern jl_sym_t *noinline_sym; extern jl_sym_t *generated_sym;
 extern jl_sym_t *generated_only_sym; extern jl_sym_t *isdefined_sym;
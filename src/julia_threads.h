@@ -53,15 +53,31 @@ typedef ucontext_t jl_ucontext_t;
 #endif
 
 
-// Recursive spin lock
+// Recursive lock. Uncontended acquires are a single CAS on `owner`;
+// contended acquires spin briefly and then park on a futex where available
+// (see locks.h), so waiters stop hammering the owner's cache line. The
+// trailing counters are per-lock contention statistics, readable in
+// production via jl_lock_stats / jl_print_lock_stats (threading.c).
 typedef struct {
     volatile unsigned long owner;
     uint32_t count;
+    volatile uint32_t seq;       // bumped on release; futex word for parking
+    volatile uint32_t nwaiters;  // threads parked or about to park
+    uint32_t ncontended;         // acquires that missed the fast path
+    uint32_t nparked;            // futex sleeps
+    uint64_t nacquire;           // non-recursive acquires (fast or slow path)
+    uint64_t wait_ns;            // cumulative time spent waiting when contended
+    uint64_t wait_ns_max;        // longest single contended wait
+    uintptr_t holder_ip;         // call site of the most recent acquire
+    uintptr_t contended_ip;      // holder_ip seen by the last contended waiter
 } jl_mutex_t;
 
 typedef struct {
     jl_taggedvalue_t *freelist;   // root of list of free objects
     jl_taggedvalue_t *newpages;   // root of list of chunks of free objects
+    // pages whose sweep was deferred to allocation time
+    // (only used by the lazy sweep mode, see gc.c)
+    struct _jl_gc_pagemeta_t *unswept;
     uint16_t osize;      // size of objects in this pool
 } jl_gc_pool_t;
 
@@ -77,7 +93,9 @@ typedef struct {
     struct _mallocarray_t *mafreelist;
 
     // variables for tracking big objects
-    struct _bigval_t *big_objects;
+    // (sharded by address so the shards can be swept in parallel, see gc.c)
+#define JL_GC_N_BIG_SHARDS 8
+    struct _bigval_t *big_objects[JL_GC_N_BIG_SHARDS];
 
     // variables for tracking "remembered set"
     arraylist_t rem_bindings;
@@ -101,6 +119,20 @@ typedef struct {
     arraylist_t free_stacks[JL_N_STACK_POOLS];
 } jl_thread_heap_t;
 
+// Per-thread allocation counters (see `jl_gc_num_t` for the global
+// aggregate). The allocation fast paths only touch these, so counting never
+// bounces a shared cache line between cores; they are folded into the global
+// `gc_num` when the world is stopped for collection or on explicit query.
+typedef struct {
+    int64_t     allocd;
+    int64_t     freed;
+    uint64_t    malloc;
+    uint64_t    realloc;
+    uint64_t    poolalloc;
+    uint64_t    bigalloc;
+    uint64_t    freecall;
+} jl_thread_gc_num_t;
+
 // Cache of thread local change to global metadata during GC
 // This is sync'd after marking.
 typedef union _jl_gc_mark_data jl_gc_mark_data_t;
@@ -135,8 +167,26 @@ typedef struct {
 } jl_gc_mark_cache_t;
 
 typedef struct _jl_excstack_t jl_excstack_t;
+
+// cache-line sizing for the writer-partitioned sections of the TLS struct
+// below (keep in sync with JL_CACHE_BYTE_ALIGNMENT in julia_internal.h)
+#if defined(_COMPILER_MICROSOFT_)
+#define JL_CACHELINE_ALIGNED __declspec(align(64))
+#else
+#define JL_CACHELINE_ALIGNED __attribute__((aligned(64)))
+#endif
+
 // This includes all the thread local states we care about for a thread.
 // Changes to TLS field types must be reflected in codegen.
+//
+// The struct is partitioned by writer so that lines written during
+// cross-thread coordination never share a cache line with the owner's fast
+// paths: first the owner-only hot fields (codegen touches pgcstack,
+// world_age, safepoint and tid on essentially every call), then one aligned
+// section for everything other threads write or spin on (GC handshake,
+// signals), then the owner-only bulk state (allocator, caches). All C++
+// consumers locate fields with offsetof, so the grouping itself carries no
+// ABI assumptions.
 #define JL_MAX_BT_SIZE 80000
 struct _jl_tls_states_t {
     struct _jl_gcframe_t *pgcstack;
@@ -144,17 +194,7 @@ struct _jl_tls_states_t {
     int16_t tid;
     uint64_t rngseed;
     volatile size_t *safepoint;
-    // Whether it is safe to execute GC at the same time.
-#define JL_GC_STATE_WAITING 1
-    // gc_state = 1 means the thread is doing GC or is waiting for the GC to
-    //              finish.
-#define JL_GC_STATE_SAFE 2
-    // gc_state = 2 means the thread is running unmanaged code that can be
-    //              execute at the same time with the GC.
-    volatile int8_t gc_state;
-    volatile int8_t in_finalizer;
     int8_t disable_gc;
-    volatile sig_atomic_t defer_signal;
     struct _jl_task_t *current_task;
     struct _jl_task_t *previous_task;
     struct _jl_task_t *root_task;
@@ -167,13 +207,28 @@ struct _jl_tls_states_t {
     // Temporary backtrace buffer. Scanned for gc roots when bt_size > 0.
     uintptr_t *bt_data; // JL_MAX_BT_SIZE + 1 elements long
     size_t bt_size;    // Size for backtrace in transit in bt_data
+
+    // --- fields written or spun on by other threads ---
+    // Whether it is safe to execute GC at the same time.
+#define JL_GC_STATE_WAITING 1
+    // gc_state = 1 means the thread is doing GC or is waiting for the GC to
+    //              finish.
+#define JL_GC_STATE_SAFE 2
+    // gc_state = 2 means the thread is running unmanaged code that can be
+    //              execute at the same time with the GC.
+    JL_CACHELINE_ALIGNED volatile int8_t gc_state;
+    volatile int8_t in_finalizer;
+    volatile sig_atomic_t defer_signal;
     // Atomically set by the sender, reset by the handler.
     volatile sig_atomic_t signal_request;
     // Allow the sigint to be raised asynchronously
     // this is limited to the few places we do synchronous IO
     // we can make this more general (similar to defer_signal) if necessary
     volatile sig_atomic_t io_wait;
-    jl_thread_heap_t heap;
+
+    // --- owner-only bulk state ---
+    JL_CACHELINE_ALIGNED jl_thread_heap_t heap;
+    jl_thread_gc_num_t gc_num;
 #ifndef _OS_WINDOWS_
     // These are only used on unix now
     pthread_t system_id;
@@ -193,9 +248,60 @@ struct _jl_tls_states_t {
     jl_gc_mark_cache_t gc_cache;
     arraylist_t sweep_objs;
     jl_gc_mark_sp_t gc_mark_sp;
+    // Scratch arena for short-lived runtime buffers (LIFO: bracket the
+    // allocations with arena_save/arena_restore).
+    arena_t scratch_arena;
     // Saved exception for previous external API call or NULL if cleared.
     // Access via jl_exception_occurred().
     struct _jl_value_t *previous_exception;
+    // Thread-private first level of the dispatch cache (see
+    // jl_lookup_generic_ in gf.c), backed by the shared global call_cache.
+    // Hits here never touch shared memory, so hot entries don't bounce
+    // cache lines between cores. Scanned with the other thread-local GC
+    // roots in gc.c.
+#define N_CALL_CACHE_TLS 1024
+    struct _jl_typemap_entry_t *call_cache[N_CALL_CACHE_TLS];
+    uint8_t call_cache_pick_which;
+    // Thread-private memo table for env-free subtype queries (subtype.c).
+    // Slots cache (x, y) -> result for type objects without free typevars;
+    // the keys are scanned as GC roots so a slot can never go stale.
+#define N_SUBTYPE_CACHE 256
+    struct {
+        struct _jl_value_t *x;
+        struct _jl_value_t *y;
+        uint8_t result;
+    } subtype_cache[N_SUBTYPE_CACHE];
+    uint64_t subtype_cache_hits;
+    uint64_t subtype_cache_misses;
+    // Same idea for jl_type_intersection on closed type pairs, which method
+    // insertion and ambiguity checking repeat heavily during package load.
+#define N_INTERSECT_CACHE 256
+    struct {
+        struct _jl_value_t *a;
+        struct _jl_value_t *b;
+        struct _jl_value_t *result;
+    } intersect_cache[N_INTERSECT_CACHE];
+    // Memo for small concrete argument tuple types (jl_apply_tuple_type_v_),
+    // keyed by the component type pointers; built on every dynamic dispatch
+    // that misses the call caches.
+#define N_TUPLE_CACHE 128
+#define N_TUPLE_CACHE_ARGS 4
+    struct {
+        struct _jl_value_t *key[N_TUPLE_CACHE_ARGS];
+        struct _jl_value_t *result;
+        uint8_t np;
+    } tuple_type_cache[N_TUPLE_CACHE];
+    // Direct-mapped caches of recently boxed Int64/Float64 values outside
+    // the interned ranges, consulted by jl_box_int64/jl_box_float64
+    // (datatype.c) before allocating. Entries are scanned as GC roots so a
+    // cached box can never dangle.
+#define N_BOX_CACHE 64
+    struct _jl_value_t *int64_box_cache[N_BOX_CACHE];
+    struct _jl_value_t *float64_box_cache[N_BOX_CACHE];
+    // Depth-first spawn (partr.c): the task whose continuation should be
+    // made stealable once its context is saved; consumed by the post-switch
+    // code in task.c. Scanned as a GC root.
+    struct _jl_task_t *deferred_enqueue_task;
 };
 
 // Update codegen version in `ccall.cpp` after changing either `pause` or `wake`
@@ -261,6 +367,10 @@ STATIC_INLINE int8_t jl_gc_state_set(jl_ptls_t ptls, int8_t state,
 STATIC_INLINE int8_t jl_gc_state_set(jl_ptls_t ptls, int8_t state,
                                      int8_t old_state)
 {
+    // A plain store is all the mutator ever pays here: the collector
+    // issues a process-wide barrier when it starts a collection
+    // (`jl_safepoint_start_gc` in safepoint.c), which publishes this
+    // store and everything before it without fences on our side.
     ptls->gc_state = state;
     // A safe point is required if we transition from GC-safe region to
     // non GC-safe region.
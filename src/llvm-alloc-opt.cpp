@@ -97,6 +97,10 @@ static bool hasObjref(Type *ty)
  *
  *     The results of these cast instructions will be scanned recursively.
  *
+ * * non-tracked arguments of calls to known non-capturing callees
+ *   (a fixed list of runtime helpers plus functions defined in the same
+ *   module whose corresponding argument provably only accesses the memory)
+ *
  * All other uses are considered to escape conservatively.
  */
 
@@ -121,6 +125,7 @@ struct AllocOpt : public FunctionPass {
     const DataLayout *DL;
 
     Function *alloc_obj;
+    Function *alloc_array_1d;
     Function *ptr_from_objref;
     Function *lifetime_start;
     Function *lifetime_end;
@@ -139,15 +144,23 @@ struct AllocOpt : public FunctionPass {
 
     MDNode *tbaa_tag;
 
+    bool argNoCapture(Function *F, unsigned argno);
+
 private:
+    bool computeArgNoCapture(Function *F, unsigned argno);
+
+    // Summary of whether a callee argument is known not to escape
+    // (computed lazily, valid for the current module only).
+    std::map<std::pair<Function*,unsigned>,bool> nocapture_summary;
+
     bool doInitialization(Module &m) override;
     bool runOnFunction(Function &F) override;
     void getAnalysisUsage(AnalysisUsage &AU) const override
     {
         FunctionPass::getAnalysisUsage(AU);
         AU.addRequired<DominatorTreeWrapperPass>();
-        AU.addPreserved<DominatorTreeWrapperPass>();
-        AU.setPreservesCFG();
+        // The CFG (and with it the dominator tree) is no longer preserved:
+        // the array rewrite splits blocks for its size guard.
     }
 };
 
@@ -171,12 +184,14 @@ private:
     void insertLifetime(Value *ptr, Constant *sz, Instruction *orig);
 
     void checkInst(Instruction *I);
+    bool isNonCapturingArg(CallInst *call, unsigned opno);
 
     void replaceIntrinsicUseWith(IntrinsicInst *call, Intrinsic::ID ID,
                                  Instruction *orig_i, Instruction *new_i);
     void removeAlloc(CallInst *orig_inst);
     void moveToStack(CallInst *orig_inst, size_t sz, bool has_ref);
     void splitOnStack(CallInst *orig_inst);
+    void optimizeArray(CallInst *orig_inst);
 
     Function &F;
     AllocOpt &pass;
@@ -293,6 +308,7 @@ private:
             haspreserve = false;
             refload = false;
             refstore = false;
+            hasmemset = false;
             hasunknownmem = false;
             uses.clear();
             preserves.clear();
@@ -313,7 +329,9 @@ private:
     };
 
     SetVector<std::pair<CallInst*,size_t>> worklist;
+    SmallVector<CallInst*,4> array_worklist;
     SmallVector<CallInst*,6> removed;
+    bool array_changed = false;
     AllocUseInfo use_info;
     CheckInst::Stack check_stack;
     Lifetime::Stack lifetime_stack;
@@ -321,6 +339,96 @@ private:
     std::map<BasicBlock*, llvm::WeakVH> first_safepoint;
 };
 
+// Whether argument `argno` of `F` is known not to escape the call, i.e. the
+// callee only accesses the memory the pointer points to for the duration of
+// the call. The memory content is preserved when the allocation is moved to
+// the stack so such arguments only need to be redirected to the stack copy.
+// The stack copy does not carry a type tag, so any callee that can observe
+// the tag (`julia.typeof`) is treated as escaping.
+bool AllocOpt::argNoCapture(Function *F, unsigned argno)
+{
+    // Runtime helpers emitted by codegen with data pointer arguments.
+    if (F->getName() == "memcmp")
+        return true;
+    if (F->isDeclaration() || argno >= F->arg_size())
+        return false;
+    auto key = std::make_pair(F, argno);
+    auto it = nocapture_summary.find(key);
+    if (it != nocapture_summary.end())
+        return it->second;
+    // Mark as escaping while in progress so that recursive cycles
+    // fail conservatively.
+    nocapture_summary[key] = false;
+    bool res = computeArgNoCapture(F, argno);
+    nocapture_summary[key] = res;
+    return res;
+}
+
+bool AllocOpt::computeArgNoCapture(Function *F, unsigned argno)
+{
+    Argument *arg = &*(F->arg_begin() + argno);
+    SmallVector<Value*,8> worklist{arg};
+    SmallSet<Value*,16> visited;
+    visited.insert(arg);
+    unsigned budget = 64;
+    while (!worklist.empty()) {
+        Value *v = worklist.pop_back_val();
+        for (auto &use: v->uses()) {
+            if (budget-- == 0)
+                return false;
+            auto user = dyn_cast<Instruction>(use.getUser());
+            if (!user)
+                return false;
+            if (isa<LoadInst>(user))
+                continue;
+            if (isa<StoreInst>(user)) {
+                // Writing through the pointer is fine, storing it is a capture.
+                if (use.getOperandNo() != StoreInst::getPointerOperandIndex())
+                    return false;
+                continue;
+            }
+            if (isa<BitCastInst>(user) || isa<AddrSpaceCastInst>(user)) {
+                // Do not look through casts back to a tracked pointer, those
+                // could be spilled to the callee's GC frame.
+                if (auto ptrty = dyn_cast<PointerType>(user->getType()))
+                    if (ptrty->getAddressSpace() == AddressSpace::Tracked)
+                        return false;
+                if (visited.insert(user).second)
+                    worklist.push_back(user);
+                continue;
+            }
+            if (auto gep = dyn_cast<GetElementPtrInst>(user)) {
+                // A negative offset could reach the (missing) type tag.
+                APInt apoffset(sizeof(void*) * 8, 0, true);
+                if (!gep->accumulateConstantOffset(*DL, apoffset) ||
+                    apoffset.isNegative())
+                    return false;
+                if (visited.insert(gep).second)
+                    worklist.push_back(gep);
+                continue;
+            }
+            if (auto call = dyn_cast<CallInst>(user)) {
+                if (auto II = dyn_cast<IntrinsicInst>(call)) {
+                    if (II->getIntrinsicID() == Intrinsic::lifetime_start ||
+                        II->getIntrinsicID() == Intrinsic::lifetime_end ||
+                        isa<DbgInfoIntrinsic>(II))
+                        continue;
+                    return false;
+                }
+                auto callee = dyn_cast<Function>(call->getCalledValue());
+                if (!callee || callee == typeof_func)
+                    return false;
+                auto opno = use.getOperandNo();
+                if (opno < call->getNumArgOperands() && argNoCapture(callee, opno))
+                    continue;
+                return false;
+            }
+            return false;
+        }
+    }
+    return true;
+}
+
 void Optimizer::pushInstruction(Instruction *I)
 {
     ssize_t sz = getGCAllocSize(I);
@@ -334,6 +442,11 @@ void Optimizer::initialize()
     for (auto &bb: F) {
         for (auto &I: bb) {
             pushInstruction(&I);
+            if (pass.alloc_array_1d) {
+                auto call = dyn_cast<CallInst>(&I);
+                if (call && call->getCalledValue() == pass.alloc_array_1d)
+                    array_worklist.push_back(call);
+            }
         }
     }
 }
@@ -382,15 +495,18 @@ void Optimizer::optimizeAll()
         }
         moveToStack(orig, sz, has_ref);
     }
+    // Arrays are handled after the scalar allocations since their rewrite
+    // splits basic blocks, which would invalidate the cached safepoints
+    // and dominator tree used above.
+    for (auto orig: array_worklist)
+        optimizeArray(orig);
 }
 
 bool Optimizer::finalize()
 {
-    if (removed.empty())
-        return false;
     for (auto inst: removed)
         inst->eraseFromParent();
-    return true;
+    return !removed.empty() || array_changed;
 }
 
 bool Optimizer::isSafepoint(Instruction *inst)
@@ -556,6 +672,19 @@ JL_USED_FUNC void Optimizer::AllocUseInfo::dump()
     }
 }
 
+bool Optimizer::isNonCapturingArg(CallInst *call, unsigned opno)
+{
+    if (opno >= call->getNumArgOperands())
+        return false;
+    // Tracked operands are excluded: the callee could spill them to its GC
+    // frame, which must not point to a stack allocation.
+    auto ty = dyn_cast<PointerType>(call->getArgOperand(opno)->getType());
+    if (!ty || ty->getAddressSpace() == AddressSpace::Tracked)
+        return false;
+    auto callee = dyn_cast<Function>(call->getCalledValue());
+    return callee && pass.argNoCapture(callee, opno);
+}
+
 void Optimizer::checkInst(Instruction *I)
 {
     use_info.reset();
@@ -624,6 +753,16 @@ void Optimizer::checkInst(Instruction *I)
             if (pass.typeof_func == callee || pass.write_barrier_func == callee)
                 return true;
             auto opno = use->getOperandNo();
+            // A known non-capturing callee only accesses the object's memory
+            // for the duration of the call and that memory is preserved when
+            // the allocation is moved to the stack, so treat this like
+            // `pointer_from_objref`: the address leaks but the object does
+            // not escape.
+            if (isNonCapturingArg(call, opno)) {
+                use_info.addrescaped = true;
+                use_info.hasload = true;
+                return true;
+            }
             // Uses in `jl_roots` operand bundle are not counted as escaping, everything else is.
             if (!isBundleOperand(call, opno) ||
                 call->getOperandBundleForOperand(opno).getTagName() != "jl_roots") {
@@ -1023,6 +1162,30 @@ void Optimizer::moveToStack(CallInst *orig_inst, size_t sz, bool has_ref)
                     return;
                 }
             }
+            // Arguments of non-capturing callees (see `checkInst`) only need
+            // to be redirected to the stack copy.
+            auto nargs = call->getNumArgOperands();
+            for (unsigned argno = 0; argno < nargs; argno++) {
+                if (call->getArgOperand(argno) != orig_i ||
+                    !isNonCapturingArg(call, argno))
+                    continue;
+                Value *repl = new_i;
+                if (repl->getType() != orig_i->getType()) {
+                    auto cast = new AddrSpaceCastInst(repl, orig_i->getType(), "", call);
+                    cast->setDebugLoc(call->getDebugLoc());
+                    repl = cast;
+                }
+                call->setArgOperand(argno, repl);
+            }
+            bool remaining = false;
+            for (auto &op: call->operands()) {
+                if (op.get() == orig_i) {
+                    remaining = true;
+                    break;
+                }
+            }
+            if (!remaining)
+                return;
             // remove from operand bundle
             Value *replace = has_ref ? (Value*)buff : Constant::getNullValue(orig_i->getType());
             user->replaceUsesOfWith(orig_i, replace);
@@ -1442,13 +1605,270 @@ cleanup:
     }
 }
 
+// Extract the object a constant operand points to
+// (non-imaging mode emits objects as `inttoptr` literals).
+static jl_value_t *constantObjVal(Value *v)
+{
+    auto c = dyn_cast<Constant>(v);
+    while (c) {
+        if (auto ci = dyn_cast<ConstantInt>(c))
+            return (jl_value_t*)(uintptr_t)ci->getZExtValue();
+        auto ce = dyn_cast<ConstantExpr>(c);
+        if (!ce)
+            return nullptr;
+        auto opc = ce->getOpcode();
+        if (opc != Instruction::BitCast && opc != Instruction::AddrSpaceCast &&
+            opc != Instruction::IntToPtr)
+            return nullptr;
+        c = cast<Constant>(ce->getOperand(0));
+    }
+    return nullptr;
+}
+
+/**
+ * Rewrite a non-escaping `jl_alloc_array_1d` with a dynamic length into a
+ * guarded stack fast path:
+ *
+ *     if (n <= nmax) use a stack-built array header + data buffer
+ *     else           call jl_alloc_array_1d as before
+ *
+ * This only fires when every use of the array merely reads the header
+ * (`arraylen`, `arrayptr`, ...) or its type, so the object never needs to be
+ * visible to the GC: the stack variant is kept in address space 0 throughout
+ * (the GC frame lowering pass assigns no root to such values), while the heap
+ * fallback is kept alive through a tracked alloca root slot. Data accesses go
+ * through the loaded data pointer and need no rewriting. Element types must
+ * be stored inline (hence pointer-free in this runtime), so the stack buffer
+ * contains no object references.
+ */
+void Optimizer::optimizeArray(CallInst *orig)
+{
+    // Only handle the non-imaging case where the array type is a compile-time
+    // literal; its layout decides eligibility and the element size.
+    jl_value_t *atype = constantObjVal(orig->getArgOperand(0));
+    if (!atype || !jl_is_array_type(atype))
+        return;
+    jl_value_t *eltype = jl_tparam0(atype);
+    size_t elsz = 0, al = 0;
+    if (!jl_is_datatype(eltype) || !jl_islayout_inline(eltype, &elsz, &al))
+        return;
+    (void)al;
+    if (elsz == 0)
+        return;
+    size_t nmax = 64;
+    if (nmax * elsz > 1024)
+        nmax = 1024 / elsz;
+    if (nmax == 0)
+        return;
+    checkInst(orig);
+    if (use_info.escaped || use_info.addrescaped || use_info.haspreserve ||
+        use_info.refload || use_info.refstore || use_info.hasmemset ||
+        use_info.hasunknownmem)
+        return;
+    // The header must only ever be read.
+    for (auto &field: use_info.memops) {
+        for (auto &memop: field.second.accesses) {
+            if (!isa<LoadInst>(memop.inst)) {
+                return;
+            }
+        }
+    }
+    array_changed = true;
+    Module *M = F.getParent();
+    if (!pass.ptr_from_objref) {
+        Type *T_jlvalue = cast<PointerType>(pass.T_pjlvalue)->getElementType();
+        pass.ptr_from_objref = Function::Create(
+                FunctionType::get(pass.T_pjlvalue,
+                                  {PointerType::get(T_jlvalue, AddressSpace::Derived)}, false),
+                Function::ExternalLinkage, "julia.pointer_from_objref", M);
+        pass.ptr_from_objref->addFnAttr(Attribute::ReadNone);
+        pass.ptr_from_objref->addFnAttr(Attribute::NoUnwind);
+    }
+    Value *n = orig->getArgOperand(1);
+    Constant *tag = cast<Constant>(orig->getArgOperand(0));
+
+    // Stack layout: a separate header and data buffer, linked by the data
+    // field just like a `how == 0` heap array.
+    IRBuilder<> prolog_builder(&F.getEntryBlock().front());
+    size_t databytes = nmax * elsz + (elsz == 1 ? 1 : 0); // trailing NUL byte
+    auto header = prolog_builder.CreateAlloca(ArrayType::get(pass.T_int8, sizeof(jl_array_t)));
+    header->setAlignment(JL_SMALL_BYTE_ALIGNMENT);
+    auto databuf = prolog_builder.CreateAlloca(ArrayType::get(pass.T_int8, databytes));
+    databuf->setAlignment(JL_SMALL_BYTE_ALIGNMENT);
+    // Root slot keeping the heap fallback alive (the GC frame lowering pass
+    // turns tracked allocas into frame slots).
+    auto root = prolog_builder.CreateAlloca(pass.T_prjlvalue);
+    prolog_builder.CreateStore(
+            ConstantPointerNull::get(cast<PointerType>(pass.T_prjlvalue)), root);
+
+    BasicBlock *callbb = orig->getParent();
+    BasicBlock *contbb = callbb->splitBasicBlock(orig, "arr.cont");
+    callbb->getTerminator()->eraseFromParent();
+    auto stackbb = BasicBlock::Create(*pass.ctx, "arr.stack", &F, contbb);
+    auto heapbb = BasicBlock::Create(*pass.ctx, "arr.heap", &F, contbb);
+    IRBuilder<> guard_builder(callbb);
+    // Unsigned comparison sends invalid (negative) lengths to the heap call,
+    // which raises the error.
+    guard_builder.CreateCondBr(
+            guard_builder.CreateICmpULE(n, ConstantInt::get(n->getType(), nmax)),
+            stackbb, heapbb);
+
+    // Fill in the header the same way `_new_array_` does.
+    jl_array_flags_t fl;
+    memset(&fl, 0, sizeof(fl));
+    fl.how = 0;
+    fl.ndims = 1;
+    fl.ptrarray = 0;
+    fl.isaligned = 1;
+    uint16_t flword;
+    memcpy(&flword, &fl, sizeof(flword));
+    IRBuilder<> stack_builder(stackbb);
+    auto header_field = [&] (size_t offset, Type *elty) {
+        Value *p = stack_builder.CreateBitCast(header, pass.T_pint8);
+        p = stack_builder.CreateConstInBoundsGEP1_32(pass.T_int8, p, offset);
+        return stack_builder.CreateBitCast(p, elty->getPointerTo());
+    };
+    Value *dataptr = stack_builder.CreateBitCast(databuf, pass.T_pint8);
+    stack_builder.CreateStore(dataptr, header_field(offsetof(jl_array_t, data), pass.T_pint8));
+#ifdef STORE_ARRAY_LEN
+    stack_builder.CreateStore(n, header_field(offsetof(jl_array_t, length), n->getType()));
+#endif
+    Type *T_int16 = Type::getInt16Ty(*pass.ctx);
+    stack_builder.CreateStore(ConstantInt::get(T_int16, flword),
+                              header_field(offsetof(jl_array_t, flags), T_int16));
+    stack_builder.CreateStore(ConstantInt::get(T_int16, elsz),
+                              header_field(offsetof(jl_array_t, elsize), T_int16));
+    stack_builder.CreateStore(ConstantInt::get(pass.T_int32, 0),
+                              header_field(offsetof(jl_array_t, offset), pass.T_int32));
+    stack_builder.CreateStore(n, header_field(offsetof(jl_array_t, nrows), n->getType()));
+    stack_builder.CreateStore(n, header_field(offsetof(jl_array_t, maxsize), n->getType()));
+    if (elsz == 1) {
+        // extra byte for all julia allocated byte arrays
+        auto nul = stack_builder.CreateInBoundsGEP(pass.T_int8, dataptr, n);
+        stack_builder.CreateStore(ConstantInt::get(pass.T_int8, 0), nul);
+    }
+    Value *stackraw = stack_builder.CreateBitCast(header, pass.T_pint8);
+    stack_builder.CreateBr(contbb);
+
+    // The original call becomes the heap fallback.
+    orig->removeFromParent();
+    heapbb->getInstList().push_back(orig);
+    BranchInst::Create(contbb, heapbb);
+
+    auto phi = PHINode::Create(pass.T_pint8, 2, "", &contbb->front());
+    phi->addIncoming(stackraw, stackbb);
+    auto new_inst = new BitCastInst(phi, pass.T_pjlvalue, "",
+                                    &*contbb->getFirstInsertionPt());
+    new_inst->takeName(orig);
+
+    // Rewrite all (reading) uses of the array to the merged raw pointer,
+    // mirroring the cast chain in address space 0 like `moveToStack`.
+    auto simple_replace = [&] (Instruction *orig_i, Instruction *new_i) {
+        if (orig_i->user_empty()) {
+            if (orig_i != orig)
+                orig_i->eraseFromParent();
+            return true;
+        }
+        Type *orig_t = orig_i->getType();
+        Type *new_t = new_i->getType();
+        if (orig_t == new_t) {
+            orig_i->replaceAllUsesWith(new_i);
+            if (orig_i != orig)
+                orig_i->eraseFromParent();
+            return true;
+        }
+        return false;
+    };
+    if (!simple_replace(orig, new_inst)) {
+        assert(replace_stack.empty());
+        ReplaceUses::Frame cur{orig, new_inst};
+        auto finish_cur = [&] () {
+            assert(cur.orig_i->user_empty());
+            if (cur.orig_i != orig) {
+                cur.orig_i->eraseFromParent();
+            }
+        };
+        auto push_frame = [&] (Instruction *orig_i, Instruction *new_i) {
+            if (simple_replace(orig_i, new_i))
+                return;
+            replace_stack.push_back(cur);
+            cur = {orig_i, new_i};
+        };
+        auto replace_inst = [&] (Instruction *user) {
+            Instruction *orig_i = cur.orig_i;
+            Instruction *new_i = cur.new_i;
+            if (isa<LoadInst>(user)) {
+                user->replaceUsesOfWith(orig_i, new_i);
+            }
+            else if (auto call = dyn_cast<CallInst>(user)) {
+                auto callee = call->getCalledValue();
+                if (pass.typeof_func == callee) {
+                    call->replaceAllUsesWith(tag);
+                    call->eraseFromParent();
+                    return;
+                }
+                assert(pass.write_barrier_func == callee);
+                call->eraseFromParent();
+            }
+            else if (isa<AddrSpaceCastInst>(user) || isa<BitCastInst>(user)) {
+                auto cast_t = PointerType::get(
+                        cast<PointerType>(user->getType())->getElementType(), 0);
+                auto replace_i = new_i;
+                Type *new_t = new_i->getType();
+                if (cast_t != new_t) {
+                    replace_i = new BitCastInst(replace_i, cast_t, "", user);
+                    replace_i->setDebugLoc(user->getDebugLoc());
+                    replace_i->takeName(user);
+                }
+                push_frame(user, replace_i);
+            }
+            else if (auto gep = dyn_cast<GetElementPtrInst>(user)) {
+                SmallVector<Value *, 4> IdxOperands(gep->idx_begin(), gep->idx_end());
+                auto new_gep = GetElementPtrInst::Create(gep->getSourceElementType(),
+                                                         new_i, IdxOperands,
+                                                         gep->getName(), gep);
+                new_gep->setIsInBounds(gep->isInBounds());
+                new_gep->takeName(gep);
+                copyMetadata(new_gep, gep);
+                push_frame(gep, new_gep);
+            }
+            else {
+                abort();
+            }
+        };
+        while (true) {
+            replace_inst(cast<Instruction>(*cur.orig_i->user_begin()));
+            while (cur.orig_i->use_empty()) {
+                finish_cur();
+                if (replace_stack.empty())
+                    goto done;
+                cur = replace_stack.back();
+                replace_stack.pop_back();
+            }
+        }
+    }
+done:
+    // Now that the original uses are gone, wire up the heap fallback:
+    // root it for the GC and merge its raw address into the phi.
+    IRBuilder<> heap_builder(heapbb->getTerminator());
+    heap_builder.CreateStore(orig, root);
+    Type *T_jlvalue = cast<PointerType>(pass.T_pjlvalue)->getElementType();
+    Value *derived = heap_builder.CreateAddrSpaceCast(
+            orig, PointerType::get(T_jlvalue, AddressSpace::Derived));
+    Value *heapraw = heap_builder.CreateCall(pass.ptr_from_objref, {derived});
+    phi->addIncoming(heap_builder.CreateBitCast(heapraw, pass.T_pint8), heapbb);
+}
+
 bool AllocOpt::doInitialization(Module &M)
 {
     ctx = &M.getContext();
     DL = &M.getDataLayout();
 
+    nocapture_summary.clear();
+
     alloc_obj = M.getFunction("julia.gc_alloc_obj");
-    if (!alloc_obj)
+    alloc_array_1d = M.getFunction("jl_alloc_array_1d");
+    if (!alloc_obj && !alloc_array_1d)
         return false;
 
     ptr_from_objref = M.getFunction("julia.pointer_from_objref");
@@ -1456,7 +1876,7 @@ bool AllocOpt::doInitialization(Module &M)
     typeof_func = M.getFunction("julia.typeof");
     write_barrier_func = M.getFunction("julia.write_barrier");
 
-    T_prjlvalue = alloc_obj->getReturnType();
+    T_prjlvalue = (alloc_obj ? alloc_obj : alloc_array_1d)->getReturnType();
     T_pjlvalue = PointerType::get(cast<PointerType>(T_prjlvalue)->getElementType(), 0);
     T_pprjlvalue = PointerType::get(T_prjlvalue, 0);
 
@@ -1479,7 +1899,7 @@ bool AllocOpt::doInitialization(Module &M)
 
 bool AllocOpt::runOnFunction(Function &F)
 {
-    if (!alloc_obj)
+    if (!alloc_obj && !alloc_array_1d)
         return false;
     Optimizer optimizer(F, *this);
     optimizer.initialize();
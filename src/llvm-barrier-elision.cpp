@@ -0,0 +1,170 @@
+// This file is a part of Julia. License is MIT: https://julialang.org/license
+
+#define DEBUG_TYPE "barrier_elision"
+#undef DEBUG
+#include "llvm-version.h"
+
+#include <llvm-c/Core.h>
+#include <llvm-c/Types.h>
+
+#include <llvm/ADT/SmallPtrSet.h>
+#include <llvm/Analysis/LoopInfo.h>
+#include <llvm/IR/Value.h>
+#include <llvm/IR/LegacyPassManager.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/IntrinsicInst.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Pass.h>
+#include <llvm/Support/Debug.h>
+
+#include "julia.h"
+#include "julia_assert.h"
+
+using namespace llvm;
+
+/**
+ * Remove redundant `julia.write_barrier` calls before they are lowered by
+ * `LateLowerGCFrame`. A barrier only does work when its parent is old and
+ * marked, and once it ran the parent stays queued until the next safepoint
+ * that can run a collection, so:
+ *
+ * - a barrier dominated by another barrier on the same parent with no
+ *   safepoint in between is a no-op and can be deleted;
+ * - a barrier on an object allocated since the last safepoint is a no-op,
+ *   since a freshly allocated object cannot be old;
+ * - a barrier in a safepoint-free loop whose operands are loop-invariant
+ *   only needs to run once and is hoisted into the preheader.
+ *
+ * Mutation kernels that store into the same (old) object on every iteration
+ * otherwise take the barrier check and potential `jl_gc_queue_root` call on
+ * each store.
+ */
+
+struct BarrierElision : public FunctionPass {
+    static char ID;
+    BarrierElision() : FunctionPass(ID)
+    {}
+
+private:
+    bool runOnFunction(Function &F) override;
+    void getAnalysisUsage(AnalysisUsage &AU) const override
+    {
+        AU.addRequired<LoopInfoWrapperPass>();
+        AU.setPreservesCFG();
+    }
+};
+
+// Whether `I` can reach a safepoint and run a collection, which may mark the
+// parent old again and invalidates every barrier fact collected so far.
+static bool isSafepoint(Instruction *I)
+{
+    auto CI = dyn_cast<CallInst>(I);
+    if (!CI)
+        return isa<InvokeInst>(I);
+    auto callee = CI->getCalledFunction();
+    if (!callee)
+        return true; // indirect call, assume the worst
+    StringRef name = callee->getName();
+    if (name == "julia.gc_alloc_obj")
+        return true; // allocation can trigger a collection
+    // intrinsics and the other julia.* markers never run the GC
+    if (callee->isIntrinsic() || name.startswith("llvm.") ||
+        name.startswith("julia."))
+        return false;
+    return true;
+}
+
+bool BarrierElision::runOnFunction(Function &F)
+{
+    Function *wb_func = F.getParent()->getFunction("julia.write_barrier");
+    if (!wb_func)
+        return false;
+    bool Changed = false;
+
+    // Hoist barriers out of safepoint-free loops when the operands are
+    // loop-invariant. Running the barrier in the preheader is safe even if
+    // the loop does not execute: it only ever queues a valid object early.
+    LoopInfo &LI = getAnalysis<LoopInfoWrapperPass>().getLoopInfo();
+    SmallVector<Loop*, 8> Loops(LI.begin(), LI.end());
+    for (unsigned i = 0; i < Loops.size(); i++) {
+        Loop *L = Loops[i];
+        Loops.append(L->begin(), L->end());
+        BasicBlock *preheader = L->getLoopPreheader();
+        if (!preheader)
+            continue;
+        bool safepoint_free = true;
+        SmallVector<CallInst*, 4> barriers;
+        for (BasicBlock *BB : L->blocks()) {
+            for (Instruction &I : *BB) {
+                auto CI = dyn_cast<CallInst>(&I);
+                if (CI && CI->getCalledFunction() == wb_func) {
+                    if (L->isLoopInvariant(CI->getArgOperand(0)) &&
+                        L->isLoopInvariant(CI->getArgOperand(1)))
+                        barriers.push_back(CI);
+                    continue;
+                }
+                if (isSafepoint(&I)) {
+                    safepoint_free = false;
+                    break;
+                }
+            }
+            if (!safepoint_free)
+                break;
+        }
+        if (!safepoint_free)
+            continue;
+        for (auto CI: barriers) {
+            CI->moveBefore(preheader->getTerminator());
+            Changed = true;
+        }
+    }
+
+    // Delete barriers made redundant by an earlier barrier on the same
+    // parent or by the parent being allocated since the last safepoint.
+    // Block-local so that dominance is given by instruction order; this also
+    // cleans up duplicates the hoisting above may have stacked in a preheader.
+    for (BasicBlock &BB : F) {
+        SmallPtrSet<Value*, 8> barriered;
+        SmallPtrSet<Value*, 8> young;
+        for (auto it = BB.begin(); it != BB.end();) {
+            Instruction *I = &*it;
+            ++it;
+            auto CI = dyn_cast<CallInst>(I);
+            if (CI && CI->getCalledFunction() == wb_func) {
+                Value *parent = CI->getArgOperand(0)->stripPointerCasts();
+                if (barriered.count(parent) || young.count(parent)) {
+                    CI->eraseFromParent();
+                    Changed = true;
+                }
+                else {
+                    barriered.insert(parent);
+                }
+                continue;
+            }
+            if (isSafepoint(I)) {
+                barriered.clear();
+                young.clear();
+                if (CI && CI->getCalledFunction() &&
+                    CI->getCalledFunction()->getName() == "julia.gc_alloc_obj")
+                    young.insert(CI);
+            }
+        }
+    }
+    return Changed;
+}
+
+char BarrierElision::ID = 0;
+static RegisterPass<BarrierElision> X("BarrierElision", "Remove redundant GC write barriers",
+                                      false /* Only looks at CFG */,
+                                      false /* Analysis Pass */);
+
+Pass *createBarrierElisionPass()
+{
+    return new BarrierElision();
+}
+
+extern "C" JL_DLLEXPORT void LLVMExtraAddBarrierElisionPass(LLVMPassManagerRef PM)
+{
+    unwrap(PM)->add(createBarrierElisionPass());
+}
@@ -32,6 +32,19 @@
 #include "julia_assert.h"
 
 #define DEBUG_TYPE "late_lower_gcroot"
+
+// defined in debuginfo.cpp, feeds the per-method code size accounting
+extern "C" void jl_record_gc_frame_size(const char *fname, uint64_t nbytes);
+
+// When JULIA_LLVM_GC_FRAME_STATS is set, print how many rooted values each
+// frame holds vs. how many slots it actually got, i.e. how much the slot
+// sharing computed by `ColorRoots` shrinks the frame. Codegen runs under
+// the codegen lock, so plain counters suffice for the running totals.
+static bool gc_frame_stats_enabled(void)
+{
+    static bool enabled = getenv("JULIA_LLVM_GC_FRAME_STATS") != NULL;
+    return enabled;
+}
 #if JL_LLVM_VERSION < 70000
 #define LLVM_DEBUG DEBUG
 #endif
@@ -1199,7 +1212,10 @@ State LateLowerGCFrame::LocalScan(Function &F) {
                     }
                 }
                 if (isa<IntrinsicInst>(CI) || CI->hasFnAttr(Attribute::ArgMemOnly) ||
-                    CI->hasFnAttr(Attribute::ReadNone) || CI->hasFnAttr(Attribute::ReadOnly)) {
+                    CI->hasFnAttr(Attribute::ReadNone) || CI->hasFnAttr(Attribute::ReadOnly) ||
+                    // `gc_leaf` ccalls promise not to allocate, block, or
+                    // call back into julia (see emit_ccall)
+                    CI->hasFnAttr("gc-leaf-function")) {
                     // Intrinsics are never safepoints.
                     continue;
                 }
@@ -1968,12 +1984,30 @@ void LateLowerGCFrame::PlaceGCFrameStores(State &S, unsigned MinColorRoot,
 void LateLowerGCFrame::PlaceRootsAndUpdateCalls(std::vector<int> &Colors, State &S, std::map<Value *, std::pair<int, int>>) {
     auto F = S.F;
     int MaxColor = -1;
-    for (auto C : Colors)
+    unsigned NColored = 0;
+    for (auto C : Colors) {
         if (C > MaxColor)
             MaxColor = C;
+        if (C != -1)
+            NColored++;
+    }
+    if (gc_frame_stats_enabled() && NColored > 0) {
+        static uint64_t total_values = 0;
+        static uint64_t total_slots = 0;
+        total_values += NColored;
+        total_slots += MaxColor + 1;
+        // allocas always get a private slot each and are not counted
+        jl_safe_printf("gc frame %s: %u values in %d slots "
+                       "(total %" PRIu64 " in %" PRIu64 ")\n",
+                       F->getName().str().c_str(), NColored, MaxColor + 1,
+                       total_values, total_slots);
+    }
     // Insert instructions for the actual gc frame
     if (MaxColor != -1 || S.Allocas.size() != 0) {
         unsigned NRoots = MaxColor + 1 + S.Allocas.size();
+        // note the frame size (incl. the 2-slot header) for size accounting
+        jl_record_gc_frame_size(F->getName().str().c_str(),
+                                sizeof(void*) * (NRoots + 2));
         // Create GC Frame
         AllocaInst *gcframe = new AllocaInst(T_prjlvalue, 0,
             ConstantInt::get(T_int32, NRoots + 2), "gcframe");
@@ -4,6 +4,8 @@
 #include <llvm-c/Types.h>
 
 #include <llvm/ADT/DepthFirstIterator.h>
+#include <llvm/ADT/SmallPtrSet.h>
+#include <llvm/ADT/SmallVector.h>
 #include <llvm/Analysis/CFG.h>
 #include <llvm/IR/Value.h>
 #include <llvm/IR/Constants.h>
@@ -19,6 +21,8 @@
 #include "julia.h"
 #include "julia_assert.h"
 
+#include <map>
+
 #define DEBUG_TYPE "lower_handlers"
 #undef DEBUG
 
@@ -64,6 +68,13 @@ using namespace llvm;
  * As an additional optimization, we also insert lifetime intrinsics for the
  * handler structures to tell LLVM that it is free to re-use the stack slot
  * while the handler is not being used.
+ *
+ * Handlers whose protected region provably cannot throw -- i.e. the region
+ * contains no calls into the runtime or other julia code and no safepoint
+ * polls, e.g. a `try` whose body reduced to plain arithmetic after inlining
+ * -- are not materialized at all, since the setjmp is by far the dominant
+ * cost of entering a `try`. The matching pops are decremented (or removed)
+ * to keep the runtime handler stack balanced.
  */
 struct LowerExcHandlers : public FunctionPass {
     static char ID;
@@ -80,6 +91,11 @@ private:
 
     bool doInitialization(Module &M) override;
     bool runOnFunction(Function &F) override;
+    bool regionIsNothrow(CallInst *enter, int enterDepth,
+                         SmallPtrSetImpl<CallInst *> &Closers,
+                         BasicBlock **OwnCatchOut) const;
+    void collectCatchClosers(BasicBlock *CatchBB, int enterDepth,
+                             SmallPtrSetImpl<CallInst *> &Closers) const;
 };
 
 /*
@@ -125,13 +141,142 @@ bool LowerExcHandlers::doInitialization(Module &M) {
     return true;
 }
 
+/*
+ * Check whether any instruction executed while the handler pushed by `enter`
+ * is live can transfer control to it. Only calls (which may throw, run a
+ * safepoint or recurse into julia code) and volatile accesses (the safepoint
+ * poll, which can deliver e.g. an InterruptException) can do so; intrinsics
+ * are known harmless. The leaves that close the region on some path are
+ * collected in `Closers` so the caller can rebalance their pop counts. The
+ * enter's own catch successor (reported through `OwnCatchOut`) is skipped:
+ * it is only reachable if the region can throw, so the (then dead) catch
+ * code must not block the elision — but its leaves still pop this handler
+ * and need rebalancing too, which collectCatchClosers handles.
+ */
+bool LowerExcHandlers::regionIsNothrow(CallInst *enter, int enterDepth,
+                                       SmallPtrSetImpl<CallInst *> &Closers,
+                                       BasicBlock **OwnCatchOut) const
+{
+    BasicBlock *OwnCatch = nullptr;
+    if (enter->hasOneUse()) {
+        if (auto *cmp = dyn_cast<ICmpInst>(enter->user_back())) {
+            Value *other = cmp->getOperand(0) == enter ? cmp->getOperand(1) :
+                           cmp->getOperand(0);
+            auto *zero = dyn_cast<ConstantInt>(other);
+            if (cmp->hasOneUse() && cmp->getPredicate() == CmpInst::ICMP_EQ &&
+                zero && zero->isZero()) {
+                if (auto *br = dyn_cast<BranchInst>(cmp->user_back())) {
+                    if (br->isConditional() && br->getCondition() == cmp)
+                        OwnCatch = br->getSuccessor(1);
+                }
+            }
+        }
+    }
+    SmallVector<std::pair<Instruction *, int>, 8> Worklist;
+    SmallPtrSet<BasicBlock *, 8> Visited;
+    Worklist.push_back(std::make_pair(enter->getNextNode(), enterDepth + 1));
+    while (!Worklist.empty()) {
+        auto item = Worklist.pop_back_val();
+        BasicBlock *BB = item.first->getParent();
+        int Depth = item.second;
+        bool Closed = false;
+        for (Instruction *I = item.first; I; I = I->getNextNode()) {
+            if (auto *CI = dyn_cast<CallInst>(I)) {
+                Function *Callee = CI->getCalledFunction();
+                if (Callee == except_enter_func) {
+                    Depth++;
+                    continue;
+                }
+                if (Callee == leave_func) {
+                    Depth -= cast<ConstantInt>(CI->getArgOperand(0))->getLimitedValue();
+                    if (Depth <= enterDepth) {
+                        Closers.insert(CI);
+                        Closed = true;
+                        break;
+                    }
+                    continue;
+                }
+                if (!Callee || !Callee->isIntrinsic())
+                    return false;
+                continue;
+            }
+            if (auto *LI = dyn_cast<LoadInst>(I)) {
+                if (LI->isVolatile())
+                    return false;
+            }
+            else if (auto *SI = dyn_cast<StoreInst>(I)) {
+                if (SI->isVolatile())
+                    return false;
+            }
+        }
+        if (Closed)
+            continue;
+        for (BasicBlock *Succ : successors(BB)) {
+            if (Succ == OwnCatch)
+                continue;
+            if (Visited.insert(Succ).second)
+                Worklist.push_back(std::make_pair(&Succ->front(), Depth));
+        }
+    }
+    *OwnCatchOut = OwnCatch;
+    return true;
+}
+
+/*
+ * Collect the leaves that pop the handler pushed by an elided `enter` on
+ * paths through its catch successor, which regionIsNothrow skipped. Every
+ * catch block opens with a `leave` popping its own handler, so without this
+ * the elided depth would stay recorded against that leave and Step 2 would
+ * index a handler slot that no longer exists. The walk only tracks handler
+ * depth; the catch code is dead once the elision applies, so whether it
+ * could throw is irrelevant here.
+ */
+void LowerExcHandlers::collectCatchClosers(BasicBlock *CatchBB, int enterDepth,
+                                           SmallPtrSetImpl<CallInst *> &Closers) const
+{
+    SmallVector<std::pair<Instruction *, int>, 8> Worklist;
+    SmallPtrSet<BasicBlock *, 8> Visited;
+    Visited.insert(CatchBB);
+    Worklist.push_back(std::make_pair(&CatchBB->front(), enterDepth + 1));
+    while (!Worklist.empty()) {
+        auto item = Worklist.pop_back_val();
+        BasicBlock *BB = item.first->getParent();
+        int Depth = item.second;
+        bool Closed = false;
+        for (Instruction *I = item.first; I; I = I->getNextNode()) {
+            auto *CI = dyn_cast<CallInst>(I);
+            if (!CI)
+                continue;
+            Function *Callee = CI->getCalledFunction();
+            if (Callee == except_enter_func) {
+                Depth++;
+            }
+            else if (Callee == leave_func) {
+                Depth -= cast<ConstantInt>(CI->getArgOperand(0))->getLimitedValue();
+                if (Depth <= enterDepth) {
+                    Closers.insert(CI);
+                    Closed = true;
+                    break;
+                }
+            }
+        }
+        if (Closed)
+            continue;
+        for (BasicBlock *Succ : successors(BB)) {
+            if (Visited.insert(Succ).second)
+                Worklist.push_back(std::make_pair(&Succ->front(), Depth));
+        }
+    }
+}
+
 bool LowerExcHandlers::runOnFunction(Function &F) {
     if (!except_enter_func)
         return false; // No EH frames in this module
 
     /* Step 1: EH Depth Numbering */
     std::map<llvm::CallInst *, int> EnterDepth;
-    std::map<llvm::CallInst *, int> LeaveDepth;
+    // For each leave, the handler (stack slot) indices it pops.
+    std::map<llvm::CallInst *, SmallVector<int, 2>> LeaveClosures;
     std::map<BasicBlock *, int> ExitDepth;
     int MaxDepth = 0;
     // Compute EH Depth at each basic block using a DFS traversal.
@@ -160,8 +305,11 @@ bool LowerExcHandlers::runOnFunction(Function &F) {
             if (Callee == except_enter_func)
                 EnterDepth[CI] = Depth++;
             else if (Callee == leave_func) {
-                LeaveDepth[CI] = Depth;
-                Depth -= cast<ConstantInt>(CI->getArgOperand(0))->getLimitedValue();
+                int npops = cast<ConstantInt>(CI->getArgOperand(0))->getLimitedValue();
+                auto &closed = LeaveClosures[CI];
+                for (int i = 0; i < npops; ++i)
+                    closed.push_back(Depth - 1 - i);
+                Depth -= npops;
             }
             assert(Depth >= 0);
             if (Depth > MaxDepth)
@@ -171,6 +319,38 @@ bool LowerExcHandlers::runOnFunction(Function &F) {
         ExitDepth[BB] = Depth;
     }
 
+    /* Step 1.5: Elide handlers whose region cannot throw (see the file
+     * comment). The elided enter folds to a taken branch into the `try`
+     * body; the leaves that closed it pop one handler less. */
+    SmallVector<CallInst *, 4> Elided;
+    for (auto it : EnterDepth) {
+        CallInst *enter = it.first;
+        SmallPtrSet<CallInst *, 4> Closers;
+        BasicBlock *OwnCatch = nullptr;
+        if (!regionIsNothrow(enter, it.second, Closers, &OwnCatch))
+            continue;
+        if (OwnCatch)
+            collectCatchClosers(OwnCatch, it.second, Closers);
+        for (CallInst *leave : Closers) {
+            auto &closed = LeaveClosures[leave];
+            auto pos = std::find(closed.begin(), closed.end(), it.second);
+            assert(pos != closed.end());
+            if (pos != closed.end())
+                closed.erase(pos);
+        }
+        Elided.push_back(enter);
+    }
+    for (CallInst *enter : Elided) {
+        EnterDepth.erase(enter);
+        enter->replaceAllUsesWith(ConstantInt::get(enter->getType(), 0));
+        enter->eraseFromParent();
+    }
+    if (!Elided.empty()) {
+        MaxDepth = 0;
+        for (auto it : EnterDepth)
+            MaxDepth = std::max(MaxDepth, it.second + 1);
+    }
+
     /* Step 2: EH Frame lowering */
     // Allocate stack space for each handler. We allocate these as separate
     // allocas so the optimizer can later merge and reaarange them if it wants
@@ -217,18 +397,27 @@ bool LowerExcHandlers::runOnFunction(Function &F) {
         enter->replaceAllUsesWith(sj);
         enter->eraseFromParent();
     }
-    // Insert lifetime end intrinsics after every leave.
-    for (auto it : LeaveDepth) {
-        int StartDepth = it.second - 1;
-        int npops = cast<ConstantInt>(it.first->getArgOperand(0))->getLimitedValue();
-        for (int i = 0; i < npops; ++i) {
-            assert(StartDepth-i >= 0);
+    // Rebalance pops for elided handlers and insert lifetime end intrinsics
+    // after every leave.
+    for (auto it : LeaveClosures) {
+        CallInst *leave = it.first;
+        auto &closed = it.second;
+        unsigned npops = cast<ConstantInt>(leave->getArgOperand(0))->getLimitedValue();
+        if (closed.empty()) {
+            leave->eraseFromParent();
+            continue;
+        }
+        if (closed.size() != npops)
+            leave->setArgOperand(0, ConstantInt::get(Type::getInt32Ty(F.getContext()),
+                                                     closed.size()));
+        for (int idx : closed) {
+            assert(idx >= 0 && idx < MaxDepth);
             Value *lifetime_args[] = {
                 handler_sz64,
-                buffs[StartDepth-i]
+                buffs[idx]
             };
             auto LifetimeEnd = CallInst::Create(lifetime_end, lifetime_args);
-            LifetimeEnd->insertAfter(it.first);
+            LifetimeEnd->insertAfter(leave);
         }
     }
     return true;
@@ -32,6 +32,10 @@ using namespace llvm;
  * to
  * `%v = call fast @llvm.fmuladd.<...>(... %a, ... %b, ... %c)`
  * when `%v0` has no other use
+ *
+ * The match is purely opcode based so vector `fmul`/`fadd` pairs (as produced
+ * by the SLP and loop vectorizers) are handled the same as scalar ones; the
+ * pass is scheduled after the vectorizers for that reason.
  */
 
 struct CombineMulAdd : public FunctionPass {
@@ -69,14 +73,18 @@ bool CombineMulAdd::runOnFunction(Function &F)
             it++;
             switch (I.getOpcode()) {
             case Instruction::FAdd: {
-                if (!I.isFast())
+                // `contract` alone is enough to combine: `muladd` emits plain
+                // `contract` ops and the vectorizers intersect the flags of the
+                // scalars they bundle, which can strip the flag from the mul
+                // while the add keeps it.
+                if (!I.isFast() && !I.hasAllowContract())
                     continue;
                 checkCombine(m, &I, I.getOperand(0), I.getOperand(1), false, false) ||
                     checkCombine(m, &I, I.getOperand(1), I.getOperand(0), false, false);
                 break;
             }
             case Instruction::FSub: {
-                if (!I.isFast())
+                if (!I.isFast() && !I.hasAllowContract())
                     continue;
                 checkCombine(m, &I, I.getOperand(0), I.getOperand(1), true, false) ||
                     checkCombine(m, &I, I.getOperand(1), I.getOperand(0), true, true);
@@ -446,6 +446,12 @@ bool CloneCtx::is_vector(FunctionType *ty) const
 uint32_t CloneCtx::collect_func_info(Function &F)
 {
     uint32_t flag = 0;
+    // functions annotated with `Base.@multiversion` (lowered by codegen to
+    // the `julia.mv.clone` attribute) are cloned for every partial target,
+    // whether or not the heuristic below finds anything; keep scanning so
+    // that vector ABI calls still set `has_veccall`
+    if (F.hasFnAttribute("julia.mv.clone"))
+        flag |= clone_mask;
     if (!pass->getAnalysis<LoopInfoWrapperPass>(F).getLoopInfo().empty())
         flag |= JL_TARGET_CLONE_LOOP;
     if (is_vector(F.getFunctionType())) {
@@ -928,6 +934,39 @@ void CloneCtx::emit_metadata()
                                       value, "jl_dispatch_target_ids"));
     }
 
+    // Consolidate the constant relocation slots into a single page-aligned
+    // `jl_dispatch_got` array so that the loader can patch the resolved
+    // clone addresses in place and then drop write permission on the table
+    // (see parse_sysimg in processor.cpp). The gv_relocs entries live
+    // inside unrelated global initializers and have to stay where they are.
+    std::map<uint32_t,Constant*> got_slots;
+    if (!const_relocs.empty()) {
+        uint32_t nslots = const_relocs.size();
+        auto got_type = ArrayType::get(T_pvoidfunc, nslots);
+        auto got = new GlobalVariable(M, got_type, false,
+                                      GlobalVariable::ExternalLinkage,
+                                      Constant::getNullValue(got_type),
+                                      "jl_dispatch_got");
+        // page-aligned so whole pages can be write-protected; the loader
+        // still rounds with the runtime page size
+        got->setAlignment(4096);
+        add_comdat(got);
+        add_comdat(new GlobalVariable(M, T_int32, true,
+                                      GlobalVariable::ExternalLinkage,
+                                      ConstantInt::get(T_int32, nslots),
+                                      "jl_dispatch_got_len"));
+        uint32_t slot_i = 0;
+        for (auto &kv: const_relocs) {
+            Constant *idxs[] = {ConstantInt::get(T_int32, 0),
+                                ConstantInt::get(T_int32, slot_i++)};
+            auto gep = ConstantExpr::getInBoundsGetElementPtr(got_type, got,
+                                                              idxs);
+            kv.second->replaceAllUsesWith(gep);
+            kv.second->eraseFromParent();
+            got_slots[kv.first] = gep;
+        }
+    }
+
     // Generate `jl_dispatch_reloc_slots`
     std::set<uint32_t> shared_relocs;
     {
@@ -950,8 +989,8 @@ void CloneCtx::emit_metadata()
                 values.push_back(id_v);
                 values.push_back(get_ptrdiff32(gv_relocs[gv_reloc_idx].first, gbase));
             }
-            auto it = const_relocs.find(id);
-            if (it != const_relocs.end()) {
+            auto it = got_slots.find(id);
+            if (it != got_slots.end()) {
                 values.push_back(id_v);
                 values.push_back(get_ptrdiff32(it->second, gbase));
             }
@@ -21,6 +21,8 @@
 #include <llvm/Pass.h>
 #include <llvm/Support/Debug.h>
 
+#include <llvm/ADT/Statistic.h>
+
 #include "llvm-version.h"
 #include "codegen_shared.h"
 #include "julia.h"
@@ -29,6 +31,9 @@
 
 using namespace llvm;
 
+STATISTIC(LiftedAccesses, "Number of memory operations rewritten to an untracked address space");
+STATISTIC(LiftedChainInsts, "Number of GEP/phi/select instructions cloned without addrspace casts");
+
 /* This pass performs propagation of addrspace information that is legal from
    the frontend definition, but illegal by general IR semantics. In particular,
    this includes:
@@ -36,6 +41,10 @@ using namespace llvm;
         in an untracked address space
       - Commuting GEPs and addrspace casts
 
+    The pointer chains are followed through GEPs, phis, selects and both
+    instruction and constant-expression casts, so the rewrite is not blocked
+    by control-flow merges or literal-pointer bases.
+
     This is most useful for removing superfluous casts that can inhibit LLVM
     optimizations.
 */
@@ -148,6 +157,17 @@ Value *PropagateJuliaAddrspaces::LiftPointer(Value *V, Type *LocTy, Instruction
                 Stack.push_back(Select);
                 LocalVisited.insert(Select);
                 CurrentV = Select->getOperand(1);
+            } else if (isa<ConstantExpr>(CurrentV) &&
+                       cast<ConstantExpr>(CurrentV)->getOpcode() == Instruction::BitCast) {
+                // Mirror the instruction cases for constant-expression casts,
+                // e.g. literal pointers emitted as inttoptr+addrspacecast.
+                CurrentV = cast<ConstantExpr>(CurrentV)->getOperand(0);
+            } else if (isa<ConstantExpr>(CurrentV) &&
+                       cast<ConstantExpr>(CurrentV)->getOpcode() == Instruction::AddrSpaceCast) {
+                auto *CE = cast<ConstantExpr>(CurrentV);
+                CurrentV = CE->getOperand(0);
+                if (!isSpecialAS(getValueAddrSpace(CE)))
+                    break;
             } else if (isa<ConstantPointerNull>(CurrentV)) {
                 // It's always legal to lift null pointers into any address space
                 break;
@@ -181,6 +201,7 @@ Value *PropagateJuliaAddrspaces::LiftPointer(Value *V, Type *LocTy, Instruction
             NewV->mutateType(NewRetTy);
             LiftingMap[InstV] = NewV;
             ToRevisit.push_back(NewV);
+            ++LiftedChainInsts;
         }
     }
 
@@ -191,6 +212,10 @@ Value *PropagateJuliaAddrspaces::LiftPointer(Value *V, Type *LocTy, Instruction
                 CurrentV = cast<BitCastInst>(CurrentV)->getOperand(0);
             else if (isa<AddrSpaceCastInst>(CurrentV))
                 CurrentV = cast<AddrSpaceCastInst>(CurrentV)->getOperand(0);
+            else if (isa<ConstantExpr>(CurrentV) &&
+                     (cast<ConstantExpr>(CurrentV)->getOpcode() == Instruction::BitCast ||
+                      cast<ConstantExpr>(CurrentV)->getOpcode() == Instruction::AddrSpaceCast))
+                CurrentV = cast<ConstantExpr>(CurrentV)->getOperand(0);
             else
                 break;
         }
@@ -200,9 +225,16 @@ Value *PropagateJuliaAddrspaces::LiftPointer(Value *V, Type *LocTy, Instruction
         if (LiftingMap.count(CurrentV))
             CurrentV = LiftingMap[CurrentV];
         if (CurrentV->getType() != TargetType) {
-            auto *BCI = new BitCastInst(CurrentV, TargetType);
-            ToInsert.push_back(std::make_pair(BCI, InsertPt));
-            CurrentV = BCI;
+            // stay a constant expression for constant bases so later folds
+            // still see through it
+            if (auto *C = dyn_cast<Constant>(CurrentV)) {
+                CurrentV = ConstantExpr::getBitCast(C, TargetType);
+            }
+            else {
+                auto *BCI = new BitCastInst(CurrentV, TargetType);
+                ToInsert.push_back(std::make_pair(BCI, InsertPt));
+                CurrentV = BCI;
+            }
         }
         return CurrentV;
     };
@@ -237,6 +269,7 @@ void PropagateJuliaAddrspaces::visitLoadInst(LoadInst &LI) {
     if (!Replacement)
         return;
     LI.setOperand(LoadInst::getPointerOperandIndex(), Replacement);
+    ++LiftedAccesses;
 }
 
 void PropagateJuliaAddrspaces::visitStoreInst(StoreInst &SI) {
@@ -247,6 +280,7 @@ void PropagateJuliaAddrspaces::visitStoreInst(StoreInst &SI) {
     if (!Replacement)
         return;
     SI.setOperand(StoreInst::getPointerOperandIndex(), Replacement);
+    ++LiftedAccesses;
 }
 
 void PropagateJuliaAddrspaces::visitMemSetInst(MemSetInst &MI) {
@@ -260,6 +294,7 @@ void PropagateJuliaAddrspaces::visitMemSetInst(MemSetInst &MI) {
         {Replacement->getType(), MI.getOperand(1)->getType()});
     MI.setCalledFunction(TheFn);
     MI.setArgOperand(0, Replacement);
+    ++LiftedAccesses;
 }
 
 void PropagateJuliaAddrspaces::visitMemTransferInst(MemTransferInst &MTI) {
@@ -287,6 +322,7 @@ void PropagateJuliaAddrspaces::visitMemTransferInst(MemTransferInst &MTI) {
     MTI.setCalledFunction(TheFn);
     MTI.setArgOperand(0, Dest);
     MTI.setArgOperand(1, Src);
+    ++LiftedAccesses;
 }
 
 char PropagateJuliaAddrspaces::ID = 0;
@@ -128,22 +128,37 @@ Instruction *LowerPTLS::emit_ptls_tp(Value *offset, Instruction *insertBefore) c
     // It's also harder to emit the offset in a generic way on ARM/AArch64
     // (need to generate one or two `add` with shift) so let llvm emit
     // the add for now.
-#if defined(_CPU_AARCH64_)
+    Value *tls;
+#if defined(_CPU_X86_64_) || defined(_CPU_X86_)
+    // On x86 emit the thread pointer as a load from address 0 of the
+    // segment-register address space instead of inline asm: a plain
+    // (invariant) load can be CSE'd and rematerialized by the backend,
+    // while inline asm is an opaque box to MachineCSE/MachineLICM, so hot
+    // functions would recompute it at every lowered use.
+#  if defined(_CPU_X86_64_)
+    const unsigned tp_as = 257; // %fs
+#  else
+    const unsigned tp_as = 256; // %gs
+#  endif
+    auto tp = new LoadInst(T_pint8, Constant::getNullValue(T_pint8->getPointerTo(tp_as)),
+                           "thread_ptr", false, insertBefore);
+    tp->setMetadata(llvm::LLVMContext::MD_tbaa, tbaa_const);
+    tp->setMetadata(llvm::LLVMContext::MD_invariant_load, MDNode::get(*ctx, None));
+    tls = tp;
+#else
+#  if defined(_CPU_AARCH64_)
     const char *asm_str = "mrs $0, tpidr_el0";
-#elif defined(__ARM_ARCH) && __ARM_ARCH >= 7
+#  elif defined(__ARM_ARCH) && __ARM_ARCH >= 7
     const char *asm_str = "mrc p15, 0, $0, c13, c0, 3";
-#elif defined(_CPU_X86_64_)
-    const char *asm_str = "movq %fs:0, $0";
-#elif defined(_CPU_X86_)
-    const char *asm_str = "movl %gs:0, $0";
-#else
+#  else
     const char *asm_str = nullptr;
     assert(0 && "Cannot emit thread pointer for this architecture.");
+#  endif
+    auto tp = InlineAsm::get(FunctionType::get(T_pint8, false), asm_str, "=r", false);
+    tls = CallInst::Create(tp, "thread_ptr", insertBefore);
 #endif
     if (!offset)
         offset = ConstantInt::getSigned(T_size, jl_tls_offset);
-    auto tp = InlineAsm::get(FunctionType::get(T_pint8, false), asm_str, "=r", false);
-    Value *tls = CallInst::Create(tp, "thread_ptr", insertBefore);
     tls = GetElementPtrInst::Create(T_int8, tls, {offset}, "ptls_i8", insertBefore);
     return new BitCastInst(tls, T_pppjlvalue, "ptls", insertBefore);
 }
@@ -278,12 +293,27 @@ bool LowerPTLS::runOnModule(Module &_M)
                                     NULL, "jl_tls_states");
 #endif
 
+    // Inlining can leave one getter call per inlined callee when earlier CSE
+    // missed them; each would rematerialize the TLS pointer after lowering.
+    // The call is readnone and safe to speculate, so keep a single copy in
+    // the entry block of each function and forward the rest to it.
+    DenseMap<Function*, CallInst*> unique_call;
     for (auto it = ptls_getter->user_begin(); it != ptls_getter->user_end();) {
         auto call = cast<CallInst>(*it);
         ++it;
         assert(call->getCalledValue() == ptls_getter);
-        fix_ptls_use(call);
+        auto F = call->getFunction();
+        auto got = unique_call.insert(std::make_pair(F, call));
+        if (got.second) {
+            call->moveBefore(&*F->getEntryBlock().getFirstInsertionPt());
+        }
+        else {
+            call->replaceAllUsesWith(got.first->second);
+            call->eraseFromParent();
+        }
     }
+    for (auto it : unique_call)
+        fix_ptls_use(it.second);
     assert(ptls_getter->use_empty());
     ptls_getter->eraseFromParent();
     return true;
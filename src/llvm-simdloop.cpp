@@ -24,6 +24,7 @@
 #include <llvm/Analysis/LoopPass.h>
 #include <llvm/IR/LegacyPassManager.h>
 #include <llvm/IR/Instructions.h>
+#include <llvm/IR/IntrinsicInst.h>
 #include <llvm/IR/LLVMContext.h>
 #include <llvm/IR/Metadata.h>
 #include <llvm/Support/Debug.h>
@@ -59,11 +60,17 @@ struct LowerSIMDLoop : public ModulePass {
     bool markLoopInfo(Module &M, Function *marker);
 
     /// If Phi is part of a reduction cycle of FAdd, FSub, FMul or FDiv,
-    /// mark the ops as permitting reassociation/commuting.
+    /// of min/max (select+fcmp or the minnum/maxnum intrinsics), or of a
+    /// select-based conditional reduction, mark the ops as permitting
+    /// reassociation/commuting.
     /// As of LLVM 4.0, FDiv is not handled by the loop vectorizer
     void enableUnsafeAlgebraIfReduction(PHINode *Phi, Loop *L) const;
 };
 
+// Pseudo-opcode for min/max reduction steps, distinct from any real
+// instruction opcode.
+static const unsigned ReduceMinMax = ~0u;
+
 static unsigned getReduceOpcode(Instruction *J, Instruction *operand)
 {
     switch (J->getOpcode()) {
@@ -79,11 +86,46 @@ static unsigned getReduceOpcode(Instruction *J, Instruction *operand)
         JL_FALLTHROUGH;
     case Instruction::FMul:
         return Instruction::FMul;
+    case Instruction::Call:
+        if (auto intr = dyn_cast<IntrinsicInst>(J)) {
+            Intrinsic::ID ID = intr->getIntrinsicID();
+            if (ID == Intrinsic::minnum || ID == Intrinsic::maxnum)
+                return ReduceMinMax;
+        }
+        return 0;
     default:
         return 0;
     }
 }
 
+// A min/max or conditional reduction step uses the reduction value twice:
+// once in the comparison (resp. the combining op) and once in the select
+// merging the result. If select `S` together with its sibling use `Other`
+// forms such a step combining `operand` -- select(fcmp(x, y), x, y) for
+// min/max, select(cond, op(x, ...), x) for a conditional reduction --
+// return the opcode of the step, otherwise 0.
+static unsigned getReduceSelect(SelectInst *S, Instruction *Other, Instruction *operand)
+{
+    Value *T = S->getTrueValue();
+    Value *F = S->getFalseValue();
+    if (auto cmp = dyn_cast<FCmpInst>(Other)) {
+        if (S->getCondition() != cmp)
+            return 0;
+        if (((T == cmp->getOperand(0) && F == cmp->getOperand(1)) ||
+             (T == cmp->getOperand(1) && F == cmp->getOperand(0))) &&
+            (T == operand || F == operand))
+            return ReduceMinMax;
+        return 0;
+    }
+    // select(cond, op(operand, ...), operand): the untaken side passes the
+    // reduction value through unchanged.
+    if (!((T == Other && F == operand) || (T == operand && F == Other)))
+        return 0;
+    if (!Other->hasOneUse())
+        return 0;
+    return getReduceOpcode(Other, operand);
+}
+
 void LowerSIMDLoop::enableUnsafeAlgebraIfReduction(PHINode *Phi, Loop *L) const
 {
     typedef SmallVector<Instruction*, 8> chainVector;
@@ -92,44 +134,82 @@ void LowerSIMDLoop::enableUnsafeAlgebraIfReduction(PHINode *Phi, Loop *L) const
     unsigned opcode = 0;
     for (Instruction *I = Phi; ; I=J) {
         J = NULL;
-        // Find the user of instruction I that is within loop L.
+        Instruction *Second = NULL;
+        // Find the users of instruction I that are within loop L.
         for (User *UI : I->users()) { /*}*/
             Instruction *U = cast<Instruction>(UI);
             if (L->contains(U)) {
-                if (J) {
-                    LLVM_DEBUG(dbgs() << "LSL: not a reduction var because op has two internal uses: " << *I << "\n");
+                if (Second) {
+                    LLVM_DEBUG(dbgs() << "LSL: not a reduction var because op has too many internal uses: " << *I << "\n");
                     return;
                 }
-                J = U;
+                if (J)
+                    Second = U;
+                else
+                    J = U;
             }
         }
         if (!J) {
             LLVM_DEBUG(dbgs() << "LSL: chain prematurely terminated at " << *I << "\n");
             return;
         }
-        if (J == Phi) {
+        if (J == Phi || Second == Phi) {
+            if (Second) {
+                LLVM_DEBUG(dbgs() << "LSL: not a reduction var because op has two internal uses: " << *I << "\n");
+                return;
+            }
             // Found the entire chain.
             break;
         }
+        unsigned stepop;
+        Instruction *stepfirst = NULL;
+        if (Second) {
+            // Two internal uses are only allowed for the comparison (or
+            // combining op) plus select shape of a min/max or conditional
+            // reduction; the select continues the chain.
+            SelectInst *S = dyn_cast<SelectInst>(J);
+            Instruction *Other = Second;
+            if (!S) {
+                S = dyn_cast<SelectInst>(Second);
+                Other = J;
+            }
+            if (!S || !(stepop = getReduceSelect(S, Other, I))) {
+                LLVM_DEBUG(dbgs() << "LSL: not a reduction var because op has two internal uses: " << *I << "\n");
+                return;
+            }
+            stepfirst = Other;
+            J = S;
+        }
+        else {
+            stepop = getReduceOpcode(J, I);
+        }
         if (opcode) {
-            // Check that arithmetic op matches prior arithmetic ops in the chain.
-            if (getReduceOpcode(J, I) != opcode) {
+            // Check that the op matches prior ops in the chain.
+            if (stepop != opcode) {
                 LLVM_DEBUG(dbgs() << "LSL: chain broke at " << *J << " because of wrong opcode\n");
                 return;
             }
         }
         else {
-            // First arithmetic op in the chain.
-            opcode = getReduceOpcode(J, I);
+            // First op in the chain.
+            opcode = stepop;
             if (!opcode) {
-                LLVM_DEBUG(dbgs() << "LSL: first arithmetic op in chain is uninteresting" << *J << "\n");
+                LLVM_DEBUG(dbgs() << "LSL: first op in chain is uninteresting" << *J << "\n");
                 return;
             }
         }
+        if (stepfirst)
+            chain.push_back(stepfirst);
         chain.push_back(J);
     }
     for (chainVector::const_iterator K=chain.begin(); K!=chain.end(); ++K) {
         LLVM_DEBUG(dbgs() << "LSL: marking " << **K << "\n");
+#if JL_LLVM_VERSION < 80000
+        // Fast-math flags on select only exist since LLVM 8; the flags on
+        // the comparison and arithmetic ops are what the vectorizer checks.
+        if (isa<SelectInst>(*K))
+            continue;
+#endif
         (*K)->setFast(true);
     }
 }
@@ -18,6 +18,34 @@ extern "C" {
 // The JL_LOCK* and JL_UNLOCK* macros are no-op for non-threading build
 // while the jl_mutex_* functions are always locking and unlocking the locks.
 
+// Contended acquires on Linux park on the lock's `seq` word instead of
+// spinning indefinitely; elsewhere they keep the old spin behavior.
+#if defined(_OS_LINUX_) && defined(JULIA_ENABLE_THREADING)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define JL_MUTEX_HAVE_PARK
+static inline void jl_mutex_park(jl_mutex_t *lock, uint32_t seq) JL_NOTSAFEPOINT
+{
+    syscall(SYS_futex, &lock->seq, FUTEX_WAIT_PRIVATE, seq, NULL, NULL, 0);
+}
+static inline void jl_mutex_unpark(jl_mutex_t *lock) JL_NOTSAFEPOINT
+{
+    syscall(SYS_futex, &lock->seq, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+}
+#endif
+
+// acquire site recorded into `holder_ip` for contention diagnosis; with
+// inlining this resolves to a frame inside the locking function, which is
+// precise enough to name the culprit
+#ifdef _COMPILER_MICROSOFT_
+#define jl_lock_site() ((uintptr_t)0)
+#else
+#define jl_lock_site() ((uintptr_t)__builtin_return_address(0))
+#endif
+
+JL_DLLEXPORT uint64_t jl_hrtime(void);
+
 static inline void jl_mutex_wait(jl_mutex_t *lock, int safepoint)
 {
     unsigned long self = jl_thread_self();
@@ -26,18 +54,61 @@ static inline void jl_mutex_wait(jl_mutex_t *lock, int safepoint)
         lock->count++;
         return;
     }
+    if (owner == 0 &&
+        jl_atomic_compare_exchange(&lock->owner, 0, self) == 0) {
+        lock->count = 1;
+        lock->nacquire++;
+        lock->holder_ip = jl_lock_site();
+        return;
+    }
+    jl_atomic_fetch_add_relaxed(&lock->ncontended, 1);
+    // racy snapshot of who we ended up waiting on (diagnostic only)
+    lock->contended_ip = lock->holder_ip;
+    uint64_t wait_t0 = jl_hrtime();
+    uint32_t spins = 0;
     while (1) {
+        owner = jl_atomic_load_acquire(&lock->owner);
         if (owner == 0 &&
             jl_atomic_compare_exchange(&lock->owner, 0, self) == 0) {
             lock->count = 1;
+            lock->nacquire++;
+            lock->holder_ip = jl_lock_site();
+            uint64_t dt = jl_hrtime() - wait_t0;
+            lock->wait_ns += dt;
+            if (dt > lock->wait_ns_max)
+                lock->wait_ns_max = dt;
             return;
         }
         if (safepoint) {
             jl_ptls_t ptls = jl_get_ptls_states();
             jl_gc_safepoint_(ptls);
         }
+#ifdef JL_MUTEX_HAVE_PARK
+        if (++spins > 256) {
+            // the release bumps `seq` before checking for waiters, so a
+            // wakeup between this load and the futex wait cannot be lost:
+            // the wait just returns immediately
+            uint32_t seq = lock->seq;
+            if (jl_atomic_load_acquire(&lock->owner) != 0) {
+                jl_atomic_fetch_add_relaxed(&lock->nwaiters, 1);
+                jl_atomic_fetch_add_relaxed(&lock->nparked, 1);
+                if (safepoint) {
+                    jl_ptls_t ptls = jl_get_ptls_states();
+                    int8_t gc_state = jl_gc_safe_enter(ptls);
+                    jl_mutex_park(lock, seq);
+                    jl_gc_safe_leave(ptls, gc_state);
+                }
+                else {
+                    jl_mutex_park(lock, seq);
+                }
+                jl_atomic_fetch_add_relaxed(&lock->nwaiters, -1);
+            }
+            // freshly woken: re-spin a little before parking again
+            spins = 128;
+            continue;
+        }
+#endif
         jl_cpu_pause();
-        owner = lock->owner;
     }
 }
 
@@ -116,6 +187,8 @@ static inline int jl_mutex_trylock_nogc(jl_mutex_t *lock)
     if (owner == 0 &&
         jl_atomic_compare_exchange(&lock->owner, 0, self) == 0) {
         lock->count = 1;
+        lock->nacquire++;
+        lock->holder_ip = jl_lock_site();
         return 1;
     }
     return 0;
@@ -153,6 +226,12 @@ static inline void jl_mutex_unlock_nogc(jl_mutex_t *lock) JL_NOTSAFEPOINT
     if (--lock->count == 0) {
         jl_atomic_store_release(&lock->owner, 0);
         jl_cpu_wake();
+#ifdef JL_MUTEX_HAVE_PARK
+        // bump the futex word, then wake one parked waiter if there is one
+        jl_atomic_fetch_add(&lock->seq, 1);
+        if (jl_atomic_load_acquire(&lock->nwaiters) != 0)
+            jl_mutex_unpark(lock);
+#endif
     }
 #endif
 }
@@ -179,6 +258,15 @@ static inline void jl_mutex_init(jl_mutex_t *lock) JL_NOTSAFEPOINT
 {
     lock->owner = 0;
     lock->count = 0;
+    lock->seq = 0;
+    lock->nwaiters = 0;
+    lock->ncontended = 0;
+    lock->nparked = 0;
+    lock->nacquire = 0;
+    lock->wait_ns = 0;
+    lock->wait_ns_max = 0;
+    lock->holder_ip = 0;
+    lock->contended_ip = 0;
 }
 
 #ifdef JULIA_ENABLE_THREADING
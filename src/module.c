@@ -84,10 +84,47 @@ JL_DLLEXPORT uint8_t jl_istopmod(jl_module_t *mod)
     return mod->istopmod;
 }
 
+// --- negative binding-lookup cache ---
+
+// Successful resolutions through the `usings` list are interned into
+// `m->bindings` by `module_import_` (see `jl_get_binding_`), so repeated
+// lookups of a resolved name are already a single hash probe. Lookups that
+// fail to resolve, however, re-walk the whole `usings` list (recursively)
+// every time. Cache those negative results per-thread, keyed on
+// (module, name), and invalidate the whole cache whenever anything that
+// could make a name newly visible happens: a binding is created, a
+// binding's owner is assigned, a name is exported, or a `using` edge is
+// added. Invalidation is a single global epoch bump; entries from older
+// epochs are simply ignored. The cache is thread-local so entries never
+// need atomic updates, and the 64-bit epoch cannot wrap in practice.
+
+#define BINDING_LOOKUP_CACHE_SIZE 512  // entries; must be a power of two
+
+typedef struct {
+    jl_module_t *mod;
+    jl_sym_t *var;
+    uint64_t epoch;
+} binding_lookup_ent_t;
+
+static uint64_t bindings_epoch = 1;
+static __thread binding_lookup_ent_t binding_lookup_cache[BINDING_LOOKUP_CACHE_SIZE];
+
+STATIC_INLINE void invalidate_binding_lookups(void) JL_NOTSAFEPOINT
+{
+    bindings_epoch++;
+}
+
+STATIC_INLINE binding_lookup_ent_t *binding_lookup_slot(jl_module_t *m, jl_sym_t *var) JL_NOTSAFEPOINT
+{
+    size_t h = (((uintptr_t)m >> 4) ^ ((uintptr_t)var >> 4)) & (BINDING_LOOKUP_CACHE_SIZE - 1);
+    return &binding_lookup_cache[h];
+}
+
 static jl_binding_t *new_binding(jl_sym_t *name)
 {
     jl_ptls_t ptls = jl_get_ptls_states();
     assert(jl_is_symbol(name));
+    invalidate_binding_lookups();
     jl_binding_t *b = (jl_binding_t*)jl_gc_alloc_buf(ptls, sizeof(jl_binding_t));
     b->name = name;
     b->value = NULL;
@@ -103,6 +140,7 @@ static jl_binding_t *new_binding(jl_sym_t *name)
 // get binding for assignment
 JL_DLLEXPORT jl_binding_t *jl_get_binding_wr(jl_module_t *m, jl_sym_t *var, int error)
 {
+    jl_module_ensure_bindings(m);
     jl_binding_t **bp = (jl_binding_t**)ptrhash_bp(&m->bindings, var);
     jl_binding_t *b = *bp;
 
@@ -110,6 +148,7 @@ JL_DLLEXPORT jl_binding_t *jl_get_binding_wr(jl_module_t *m, jl_sym_t *var, int
         if (b->owner != m) {
             if (b->owner == NULL) {
                 b->owner = m;
+                invalidate_binding_lookups();
             }
             else if (error) {
                 jl_errorf("cannot assign a value to variable %s.%s from module %s",
@@ -134,10 +173,12 @@ jl_binding_t **_jl_get_module_binding_bp(jl_module_t *m JL_PROPAGATES_ROOT, jl_s
 #else
 static inline jl_binding_t *_jl_get_module_binding(jl_module_t *m JL_PROPAGATES_ROOT, jl_sym_t *var) JL_NOTSAFEPOINT
 {
+    jl_module_ensure_bindings(m);
     return (jl_binding_t*)ptrhash_get(&m->bindings, var);
 }
 static inline jl_binding_t **_jl_get_module_binding_bp(jl_module_t *m JL_PROPAGATES_ROOT, jl_sym_t *var) JL_NOTSAFEPOINT
 {
+    jl_module_ensure_bindings(m);
     return (jl_binding_t**)ptrhash_bp(&m->bindings, var);
 }
 #endif
@@ -163,6 +204,7 @@ JL_DLLEXPORT jl_binding_t *jl_get_binding_for_method_def(jl_module_t *m, jl_sym_
         if (b->owner != m) {
             if (b->owner == NULL) {
                 b->owner = m;
+                invalidate_binding_lookups();
             }
             else {
                 jl_binding_t *b2 = jl_get_binding(b->owner, var);
@@ -265,6 +307,7 @@ static jl_binding_t *jl_get_binding_(jl_module_t *m, jl_sym_t *var, modstack_t *
 // get owner of binding when accessing m.var, without resolving the binding
 JL_DLLEXPORT jl_value_t *jl_binding_owner(jl_module_t *m, jl_sym_t *var)
 {
+    jl_module_ensure_bindings(m);
     jl_binding_t *b = (jl_binding_t*)ptrhash_get(&m->bindings, var);
     if (b == HT_NOTFOUND || b->owner == NULL) {
         b = using_resolve_binding(m, var, NULL, 0);
@@ -276,7 +319,20 @@ JL_DLLEXPORT jl_value_t *jl_binding_owner(jl_module_t *m, jl_sym_t *var)
 
 JL_DLLEXPORT jl_binding_t *jl_get_binding(jl_module_t *m, jl_sym_t *var)
 {
-    return jl_get_binding_(m, var, NULL);
+    binding_lookup_ent_t *ent = binding_lookup_slot(m, var);
+    uint64_t epoch = bindings_epoch;
+    if (ent->mod == m && ent->var == var && ent->epoch == epoch)
+        return NULL;
+    jl_binding_t *b = jl_get_binding_(m, var, NULL);
+    if (b == NULL) {
+        // record the failed resolution, stamped with the epoch sampled
+        // before the walk so that any binding created concurrently with
+        // the lookup leaves this entry already stale
+        ent->mod = m;
+        ent->var = var;
+        ent->epoch = epoch;
+    }
+    return b;
 }
 
 void jl_binding_deprecation_warning(jl_module_t *m, jl_binding_t *b);
@@ -293,6 +349,7 @@ JL_DLLEXPORT jl_binding_t *jl_get_binding_or_error(jl_module_t *m, jl_sym_t *var
 
 JL_DLLEXPORT jl_value_t *jl_module_globalref(jl_module_t *m, jl_sym_t *var)
 {
+    jl_module_ensure_bindings(m);
     jl_binding_t *b = (jl_binding_t*)ptrhash_get(&m->bindings, var);
     if (b == HT_NOTFOUND) {
         return jl_new_struct(jl_globalref_type, m, var);
@@ -315,6 +372,7 @@ static int eq_bindings(jl_binding_t *a, jl_binding_t *b)
 // does module m explicitly import s?
 JL_DLLEXPORT int jl_is_imported(jl_module_t *m, jl_sym_t *s)
 {
+    jl_module_ensure_bindings(m);
     jl_binding_t *b = (jl_binding_t*)ptrhash_get(&m->bindings, s);
     return (b != HT_NOTFOUND && b->imported);
 }
@@ -347,6 +405,7 @@ static void module_import_(jl_module_t *to, jl_module_t *from, jl_sym_t *s,
             }
         }
 
+        jl_module_ensure_bindings(to);
         jl_binding_t **bp = (jl_binding_t**)ptrhash_bp(&to->bindings, s);
         jl_binding_t *bto = *bp;
         if (bto != HT_NOTFOUND) {
@@ -385,6 +444,7 @@ static void module_import_(jl_module_t *to, jl_module_t *from, jl_sym_t *s,
             else {
                 bto->owner = b->owner;
                 bto->imported = (explici!=0);
+                invalidate_binding_lookups();
             }
         }
         else {
@@ -420,6 +480,8 @@ JL_DLLEXPORT void jl_module_using(jl_module_t *to, jl_module_t *from)
     // print a warning if something visible via this "using" conflicts with
     // an existing identifier. note that an identifier added later may still
     // silently override a "using" name. see issue #2054.
+    jl_module_ensure_bindings(from);
+    jl_module_ensure_bindings(to);
     void **table = from->bindings.table;
     for(size_t i=1; i < from->bindings.size; i+=2) {
         if (table[i] != HT_NOTFOUND) {
@@ -443,10 +505,12 @@ JL_DLLEXPORT void jl_module_using(jl_module_t *to, jl_module_t *from)
 
     arraylist_push(&to->usings, from);
     jl_gc_wb(to, from);
+    invalidate_binding_lookups();
 }
 
 JL_DLLEXPORT void jl_module_export(jl_module_t *from, jl_sym_t *s)
 {
+    jl_module_ensure_bindings(from);
     jl_binding_t **bp = (jl_binding_t**)ptrhash_bp(&from->bindings, s);
     if (*bp == HT_NOTFOUND) {
         jl_binding_t *b = new_binding(s);
@@ -457,6 +521,7 @@ JL_DLLEXPORT void jl_module_export(jl_module_t *from, jl_sym_t *s)
     }
     assert(*bp != HT_NOTFOUND);
     (*bp)->exportp = 1;
+    invalidate_binding_lookups();
 }
 
 JL_DLLEXPORT int jl_boundp(jl_module_t *m, jl_sym_t *var)
@@ -467,6 +532,7 @@ JL_DLLEXPORT int jl_boundp(jl_module_t *m, jl_sym_t *var)
 
 JL_DLLEXPORT int jl_defines_or_exports_p(jl_module_t *m, jl_sym_t *var)
 {
+    jl_module_ensure_bindings(m);
     jl_binding_t *b = (jl_binding_t*)ptrhash_get(&m->bindings, var);
     return b != HT_NOTFOUND && (b->exportp || b->owner==m);
 }
@@ -671,6 +737,7 @@ JL_DLLEXPORT jl_value_t *jl_module_names(jl_module_t *m, int all, int imported)
     jl_array_t *a = jl_alloc_array_1d(jl_array_symbol_type, 0);
     JL_GC_PUSH1(&a);
     size_t i;
+    jl_module_ensure_bindings(m);
     void **table = m->bindings.table;
     for (i = 1; i < m->bindings.size; i+=2) {
         if (table[i] != HT_NOTFOUND) {
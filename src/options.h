@@ -71,9 +71,6 @@
 // MEMPROFILE prints pool summary statistics after every GC
 //#define MEMPROFILE
 
-// GC_TIME prints time taken by each phase of GC
-// #define GC_TIME
-
 // OBJPROFILE counts objects by type
 // #define OBJPROFILE
 
@@ -3,6 +3,7 @@
 #include <assert.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <strings.h>
 
 #include "julia.h"
@@ -46,16 +47,28 @@ static int16_t heap_p;
 /* unbias state for the RNG */
 static uint64_t cong_unbias;
 
-/* for thread sleeping */
-uv_mutex_t sleep_lock;
-uv_cond_t  sleep_alarm;
+/* for thread sleeping: one lock/condvar pair per thread, so wakeups can
+   target exactly the thread(s) that have work instead of broadcasting */
+static uv_mutex_t *sleep_locks;
+static uv_cond_t  *wake_signals;
+/* set by a thread before it blocks, cleared by whoever wakes it */
+static int8_t *sleeping;
+/* set while a thread is inside jl_task_get_next (spinning or sleeping);
+   queried by the profiler to attribute samples to scheduler idle time */
+static int8_t *in_scheduler;
+
+/* adaptive spin-before-sleep budget, per thread: doubled when spinning finds
+   work, halved after an unproductive sleep */
+static const uint32_t sched_spin_min = 32;
+static const uint32_t sched_spin_max = 4096;
+static uint32_t *sched_spins;
 
 
 /*  multiq_init()
  */
 static inline void multiq_init(void)
 {
-    heap_p = heap_c * jl_n_threads;
+    heap_p = heap_c * jl_n_threads_configured;
     heaps = (taskheap_t *)calloc(heap_p, sizeof(taskheap_t));
     for (int16_t i = 0; i < heap_p; ++i) {
         jl_mutex_init(&heaps[i].lock);
@@ -182,6 +195,153 @@ static inline jl_task_t *multiq_deletemin(void)
 }
 
 
+// work-stealing deques
+// ---
+
+/* a Chase-Lev deque, one per thread: the owner pushes and pops at the
+   bottom, idle threads steal from the top. default-priority tasks go
+   through these; the multiqueue above remains for explicitly prioritized
+   tasks and as overflow when a deque fills up. */
+typedef struct wsdeque_tag {
+    jl_task_t **tasks;
+    int64_t top;     // next slot to steal from (oldest task)
+    int64_t bottom;  // next slot to push to (youngest task)
+} wsdeque_t;
+
+/* size of each deque; must be a power of two (fixed, like tasks_per_heap) */
+static const int64_t wsdeque_size = 8192;
+
+static wsdeque_t *wsdeques;
+
+/* unbias state for victim selection */
+static uint64_t cong_unbias_ws;
+
+/* nonzero on multi-node machines: steal from same-node victims first */
+static int numa_aware;
+
+/* nonzero when cpus split into several last-level-cache groups (multiple
+   sockets or CCX-style clustered L3): steal from cache siblings first */
+static int cache_aware;
+
+
+/*  wsdeque_init()
+ */
+static inline void wsdeque_init(void)
+{
+    wsdeques = (wsdeque_t *)calloc(jl_n_threads_configured, sizeof(wsdeque_t));
+    for (int16_t i = 0; i < jl_n_threads_configured; ++i)
+        wsdeques[i].tasks = (jl_task_t **)calloc(wsdeque_size, sizeof(jl_task_t*));
+    unbias_cong(jl_n_threads_configured, &cong_unbias_ws);
+    numa_aware = jl_numa_node_count() > 1;
+    cache_aware = jl_cache_group_count() > 1;
+}
+
+
+/*  wsdeque_push()
+
+    owner only; returns -1 when full so the caller can fall back to the
+    multiqueue instead of losing the task
+ */
+static inline int wsdeque_push(jl_task_t *task)
+{
+    wsdeque_t *q = &wsdeques[jl_get_ptls_states()->tid];
+    int64_t b = q->bottom;
+    int64_t t = jl_atomic_load_acquire(&q->top);
+    if (b - t >= wsdeque_size)
+        return -1;
+    q->tasks[b & (wsdeque_size - 1)] = task;
+    jl_atomic_store_release(&q->bottom, b + 1);
+    return 0;
+}
+
+
+/*  wsdeque_pop()
+
+    owner only; no atomic RMW except when racing a thief for the last task
+ */
+static inline jl_task_t *wsdeque_pop(void)
+{
+    wsdeque_t *q = &wsdeques[jl_get_ptls_states()->tid];
+    int64_t b = q->bottom - 1;
+    jl_atomic_store(&q->bottom, b); // seq_cst, fences against in-flight steals
+    int64_t t = jl_atomic_load(&q->top);
+    if (t > b) {
+        // empty
+        q->bottom = t;
+        return NULL;
+    }
+    jl_task_t *task = q->tasks[b & (wsdeque_size - 1)];
+    if (t == b) {
+        // last task: race any thief for it
+        if (jl_atomic_compare_exchange(&q->top, t, t + 1) != t)
+            task = NULL;
+        q->bottom = t + 1;
+    }
+    return task;
+}
+
+
+/*  wsdeque_steal()
+
+    take the oldest task from a randomly chosen victim's deque
+ */
+static inline jl_task_t *wsdeque_steal(void)
+{
+    jl_ptls_t ptls = jl_get_ptls_states();
+    if (jl_n_threads < 2)
+        return NULL;
+    int self_node = numa_aware ? jl_numa_thread_node(ptls->tid) : -1;
+    int self_grp = cache_aware ? jl_cache_thread_group(ptls->tid) : -1;
+    for (int i = 0; i < 2 * jl_n_threads; ++i) {
+        int16_t vict = (int16_t)cong(jl_n_threads, cong_unbias_ws, &ptls->rngseed);
+        if (vict == ptls->tid)
+            continue;
+        // widen the victim set as attempts fail: first cpus sharing our
+        // last-level cache (the stolen task's data may still be resident
+        // there), then our own NUMA node, then anyone
+        if (self_grp != -1 && i < jl_n_threads / 2 &&
+            jl_cache_thread_group(vict) != self_grp)
+            continue;
+        if (self_node != -1 && i < jl_n_threads &&
+            jl_numa_thread_node(vict) != self_node)
+            continue;
+        wsdeque_t *q = &wsdeques[vict];
+        int64_t t = jl_atomic_load_acquire(&q->top);
+        int64_t b = jl_atomic_load(&q->bottom);
+        if (t >= b)
+            continue;
+        jl_task_t *task = q->tasks[t & (wsdeque_size - 1)];
+        if (jl_atomic_compare_exchange(&q->top, t, t + 1) != t)
+            continue; // lost the race, try another victim
+        return task;
+    }
+    return NULL;
+}
+
+
+/*  wsdeque_deletemin()
+
+    pop locally, else steal; hands tasks bound to another thread back to
+    the multiqueue (same tid protocol as multiq_deletemin)
+ */
+static jl_task_t *wsdeque_deletemin(void)
+{
+    jl_ptls_t ptls = jl_get_ptls_states();
+    jl_task_t *task = wsdeque_pop();
+    if (task == NULL)
+        task = wsdeque_steal();
+    if (task == NULL)
+        return NULL;
+    if (jl_atomic_load_acquire(&task->tid) != ptls->tid) {
+        if (jl_atomic_compare_exchange(&task->tid, -1, ptls->tid) != -1) {
+            multiq_insert(task, task->prio);
+            return NULL;
+        }
+    }
+    return task;
+}
+
+
 
 // parallel task runtime
 // ---
@@ -189,12 +349,22 @@ static inline jl_task_t *multiq_deletemin(void)
 // initialize the threading infrastructure
 void jl_init_threadinginfra(void)
 {
-    /* initialize the synchronization trees pool and the multiqueue */
+    /* initialize the synchronization trees pool, the multiqueue and the
+       work-stealing deques */
     multiq_init();
+    wsdeque_init();
 
     /* initialize the sleep mechanism */
-    uv_mutex_init(&sleep_lock);
-    uv_cond_init(&sleep_alarm);
+    sleep_locks = (uv_mutex_t*)calloc(jl_n_threads_configured, sizeof(uv_mutex_t));
+    wake_signals = (uv_cond_t*)calloc(jl_n_threads_configured, sizeof(uv_cond_t));
+    sleeping = (int8_t*)calloc(jl_n_threads_configured, sizeof(int8_t));
+    in_scheduler = (int8_t*)calloc(jl_n_threads_configured, sizeof(int8_t));
+    sched_spins = (uint32_t*)calloc(jl_n_threads_configured, sizeof(uint32_t));
+    for (int16_t i = 0; i < jl_n_threads_configured; ++i) {
+        uv_mutex_init(&sleep_locks[i]);
+        uv_cond_init(&wake_signals[i]);
+        sched_spins[i] = sched_spin_min;
+    }
 }
 
 
@@ -214,6 +384,9 @@ void jl_threadfun(void *arg)
     jl_ptls_t ptls = jl_get_ptls_states();
     jl_gc_state_set(ptls, JL_GC_STATE_SAFE, 0);
     uv_barrier_wait(targ->barrier);
+    // wait for jl_n_threads to reach its final value before running
+    // anything that could look at it (scheduling, GC)
+    uv_barrier_wait(targ->start_barrier);
 
     // free the thread argument here
     free(targ);
@@ -223,14 +396,49 @@ void jl_threadfun(void *arg)
     jl_finish_task(jl_current_task, jl_nothing); // noreturn
 }
 
+/*  wake_thread()
+
+    wake thread tid if it announced intent to sleep; returns 1 if a wakeup
+    was delivered. clearing the flag here (under the lock) is what releases
+    the sleeper from its wait loop.
+ */
+static int wake_thread(int16_t tid)
+{
+    if (!jl_atomic_load(&sleeping[tid]))
+        return 0;
+    int awakened = 0;
+    uv_mutex_lock(&sleep_locks[tid]);
+    if (jl_atomic_load(&sleeping[tid])) {
+        jl_atomic_store(&sleeping[tid], 0);
+        uv_cond_signal(&wake_signals[tid]);
+        awakened = 1;
+    }
+    uv_mutex_unlock(&sleep_locks[tid]);
+    return awakened;
+}
+
+// wake every sleeping thread (entering a threaded region)
+void jl_wake_all_threads(void)
+{
+    for (int16_t i = 0; i < jl_n_threads; ++i)
+        wake_thread(i);
+}
+
 JL_DLLEXPORT void jl_wakeup_thread(int16_t tid)
 {
     jl_ptls_t ptls = jl_get_ptls_states();
     /* ensure thread tid is awake if necessary */
-    if (ptls->tid != tid && !_threadedregion && tid != -1) {
-        uv_mutex_lock(&sleep_lock);
-        uv_cond_broadcast(&sleep_alarm); // TODO: make this uv_cond_signal / just wake up correct thread
-        uv_mutex_unlock(&sleep_lock);
+    if (!_threadedregion) {
+        if (tid == -1) {
+            // work any thread can run: wake exactly one sleeper
+            for (int16_t i = 0; i < jl_n_threads; ++i) {
+                if (i != ptls->tid && wake_thread(i))
+                    break;
+            }
+        }
+        else if (tid != ptls->tid) {
+            wake_thread(tid);
+        }
     }
     if (_threadedregion && jl_uv_mutex.owner != jl_thread_self())
         jl_wake_libuv();
@@ -239,10 +447,72 @@ JL_DLLEXPORT void jl_wakeup_thread(int16_t tid)
 }
 
 
+/* depth-first spawn mode (opt in with JULIA_SCHED_DEPTH_FIRST): instead of
+   queueing a freshly spawned task, switch into it immediately and make the
+   spawning task's continuation the stealable work. nested spawn trees then
+   execute depth-first, so pending-task growth is bounded by spawn depth
+   rather than tree width, and the child runs on a warm cache. */
+static int sched_depth_first(void)
+{
+    static int depth_first = -1;
+    if (depth_first == -1) {
+        char *v = getenv("JULIA_SCHED_DEPTH_FIRST");
+        depth_first = v != NULL && strcmp(v, "0") != 0;
+    }
+    return depth_first;
+}
+
+/*  jl_enqueue_deferred_task()
+
+    called from the post-switch paths in task.c: the task suspended by a
+    depth-first spawn is fully off-CPU now, so it can safely be published
+    as stealable work (doing this before its context is saved would let a
+    thief resume a still-running stack)
+ */
+void jl_enqueue_deferred_task(void)
+{
+    jl_ptls_t ptls = jl_get_ptls_states();
+    jl_task_t *t = ptls->deferred_enqueue_task;
+    if (t == NULL)
+        return;
+    ptls->deferred_enqueue_task = NULL;
+    if (wsdeque_push(t) != 0)
+        multiq_insert(t, t->prio);
+    jl_wakeup_thread(-1); // let an idle thread steal the continuation
+}
+
+
 // enqueue the specified task for execution
 JL_DLLEXPORT void jl_enqueue_task(jl_task_t *task)
 {
-    multiq_insert(task, task->prio);
+    // a non-sticky task is the first chance of parallel work; sticky tasks
+    // (plain @async) never leave this thread, so lazy workers stay deferred
+    if (!task->sticky)
+        jl_ensure_threads_started();
+    jl_ptls_t ptls = jl_get_ptls_states();
+    if (sched_depth_first() && !task->started && !task->sticky &&
+        task->prio == -1 && !ptls->current_task->sticky &&
+        ptls->deferred_enqueue_task == NULL &&
+        !ptls->in_finalizer && !ptls->in_pure_callback &&
+        jl_atomic_compare_exchange(&task->tid, -1, ptls->tid) == -1) {
+        // run the spawned task now; the continuation is enqueued by
+        // jl_enqueue_deferred_task once its context has been saved
+        jl_task_t *ct = ptls->current_task;
+        ptls->deferred_enqueue_task = ct;
+        JL_GC_PUSH1(&task);
+        jl_switchto(&task);
+        JL_GC_POP();
+        // if the switch bailed out before saving our context, the deferred
+        // enqueue was never consumed; drop it rather than double-schedule
+        ptls = jl_get_ptls_states();
+        if (ptls->deferred_enqueue_task == ct)
+            ptls->deferred_enqueue_task = NULL;
+        return;
+    }
+    // default-priority tasks go to the enqueuing thread's deque; anything
+    // explicitly prioritized (or overflowing the deque) uses the multiqueue
+    if (task->prio != -1 || wsdeque_push(task) != 0)
+        multiq_insert(task, task->prio);
 }
 
 
@@ -257,10 +527,19 @@ static jl_task_t *get_next_task(jl_value_t *getsticky)
         }
         return task;
     }
+    task = wsdeque_deletemin();
+    if (task)
+        return task;
     return multiq_deletemin();
 }
 
 
+// queried (from the signal listener thread) by the profiler
+int8_t jl_thread_in_scheduler(int16_t tid)
+{
+    return in_scheduler ? jl_atomic_load(&in_scheduler[tid]) : 0;
+}
+
 JL_DLLEXPORT jl_task_t *jl_task_get_next(jl_value_t *getsticky)
 {
     jl_ptls_t ptls = jl_get_ptls_states();
@@ -268,19 +547,48 @@ JL_DLLEXPORT jl_task_t *jl_task_get_next(jl_value_t *getsticky)
     size_t spin_count = 0;
     jl_task_t *task;
 
+    if (in_scheduler)
+        jl_atomic_store(&in_scheduler[ptls->tid], 1);
     while (1) {
         jl_gc_safepoint();
         task = get_next_task(getsticky);
-        if (task)
+        if (task) {
+            if (spin_count > 0 && ptls->tid != 0 && !_threadedregion) {
+                // spinning found work: allow a longer spin next time
+                uint32_t b = sched_spins[ptls->tid] * 2;
+                sched_spins[ptls->tid] = b > sched_spin_max ? sched_spin_max : b;
+            }
+            if (in_scheduler)
+                jl_atomic_store(&in_scheduler[ptls->tid], 0);
             return task;
+        }
+
+        // nothing to run: drain a batch of pending finalizers, this path
+        // acts as the (low-priority) finalizer task of the async
+        // finalization mode (see gc.c)
+        if (__unlikely(jl_gc_have_pending_finalizers)) {
+            jl_gc_run_pending_finalizers();
+            continue;
+        }
+
+        // likewise for method instances promoted by the tiered-execution
+        // mode: compile them here so the calling threads keep interpreting
+        // instead of blocking on LLVM (see gf.c)
+        if (__unlikely(jl_have_pending_compiles)) {
+            jl_compile_pending_hot_methods();
+            continue;
+        }
 
         if (!_threadedregion) {
-            spin_count = 0;
             if (ptls->tid == 0) {
+                spin_count = 0;
                 if (jl_run_once(jl_global_event_loop()) == 0) {
                     task = get_next_task(getsticky);
-                    if (task)
+                    if (task) {
+                        if (in_scheduler)
+                            jl_atomic_store(&in_scheduler[ptls->tid], 0);
                         return task;
+                    }
 #ifdef _OS_WINDOWS_
                     Sleep(INFINITE);
 #else
@@ -289,19 +597,38 @@ JL_DLLEXPORT jl_task_t *jl_task_get_next(jl_value_t *getsticky)
                 }
             }
             else {
-                int sleepnow = 0;
-                uv_mutex_lock(&sleep_lock);
-                if (!_threadedregion) {
-                    sleepnow = 1;
+                // spin a while before committing to sleep; the budget adapts
+                // to how often spinning has been paying off on this thread
+                if (++spin_count < sched_spins[ptls->tid]) {
+                    jl_cpu_pause();
+                    continue;
                 }
-                else {
-                    uv_mutex_unlock(&sleep_lock);
+                spin_count = 0;
+                // announce intent to sleep, then recheck for work: a
+                // concurrent enqueuer either sees the flag and signals us,
+                // or we see its task here (both stores are seq_cst)
+                jl_atomic_store(&sleeping[ptls->tid], 1);
+                task = get_next_task(getsticky);
+                if (task) {
+                    jl_atomic_store(&sleeping[ptls->tid], 0);
+                    if (in_scheduler)
+                        jl_atomic_store(&in_scheduler[ptls->tid], 0);
+                    return task;
                 }
-                if (sleepnow) {
+                uv_mutex_lock(&sleep_locks[ptls->tid]);
+                if (!_threadedregion && jl_atomic_load(&sleeping[ptls->tid])) {
                     int8_t gc_state = jl_gc_safe_enter(ptls);
-                    uv_cond_wait(&sleep_alarm, &sleep_lock);
-                    uv_mutex_unlock(&sleep_lock);
+                    while (jl_atomic_load(&sleeping[ptls->tid]))
+                        uv_cond_wait(&wake_signals[ptls->tid], &sleep_locks[ptls->tid]);
+                    uv_mutex_unlock(&sleep_locks[ptls->tid]);
                     jl_gc_safe_leave(ptls, gc_state);
+                    // we did go to sleep: shrink the spin budget
+                    uint32_t b = sched_spins[ptls->tid] / 2;
+                    sched_spins[ptls->tid] = b < sched_spin_min ? sched_spin_min : b;
+                }
+                else {
+                    jl_atomic_store(&sleeping[ptls->tid], 0);
+                    uv_mutex_unlock(&sleep_locks[ptls->tid]);
                 }
             }
         }
@@ -310,6 +637,8 @@ JL_DLLEXPORT jl_task_t *jl_task_get_next(jl_value_t *getsticky)
                 task = get_next_task(getsticky);
                 if (task) {
                     JL_UV_UNLOCK();
+                    if (in_scheduler)
+                        jl_atomic_store(&in_scheduler[ptls->tid], 0);
                     return task;
                 }
                 uv_loop_t *loop = jl_global_event_loop();
@@ -330,6 +659,13 @@ void jl_gc_mark_enqueued_tasks(jl_gc_mark_cache_t *gc_cache, jl_gc_mark_sp_t *sp
     for (int16_t i = 0; i < heap_p; ++i)
         for (int16_t j = 0; j < heaps[i].ntasks; ++j)
             jl_gc_mark_queue_obj_explicit(gc_cache, sp, (jl_value_t *)heaps[i].tasks[j]);
+    // the world is stopped here, so the deque bounds are stable
+    for (int16_t i = 0; i < jl_n_threads; ++i) {
+        wsdeque_t *q = &wsdeques[i];
+        for (int64_t j = q->top; j < q->bottom; ++j)
+            jl_gc_mark_queue_obj_explicit(gc_cache, sp,
+                    (jl_value_t *)q->tasks[j & (wsdeque_size - 1)]);
+    }
 }
 
 #endif // JULIA_ENABLE_THREADING
@@ -383,10 +383,20 @@ static void jl_compile_specializations(void)
     // TODO: Ensure stable ordering to make inference problems more reproducible (#29923)
     //jl_sort_types((jl_value_t**)jl_array_data(m), jl_array_len(m));
     size_t i, l = jl_array_len(m);
+    // the defs walk and the (unfiltered) dispatch-cache walk above enqueue
+    // most dispatched instances twice; each duplicate jl_compile_now pays a
+    // codegen-lock round trip and an inference attempt, so visit each
+    // instance only once
+    htable_t seen;
+    htable_new(&seen, l);
     for (i = 0; i < l; i++) {
         jl_method_instance_t *mi = (jl_method_instance_t*)jl_array_ptr_ref(m, i);
+        if (ptrhash_get(&seen, mi) != HT_NOTFOUND)
+            continue;
+        ptrhash_put(&seen, mi, (void*)1);
         jl_compile_now(mi);
     }
+    htable_free(&seen);
     JL_GC_POP();
 }
 
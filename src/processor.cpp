@@ -14,6 +14,12 @@
 #include <map>
 #include <algorithm>
 
+#ifdef _OS_WINDOWS_
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
 #include "julia_assert.h"
 
 // CPU target string is a list of strings separated by `;` each string starts with a CPU
@@ -720,6 +726,26 @@ static inline jl_sysimg_fptrs_t parse_sysimg(void *hdl, F &&callback)
         (void)found;
     }
 
+    // The dispatch GOT is fully resolved at this point and the CPU never
+    // changes after boot, so drop write permission on the pages it covers
+    // (the table is page-aligned; only a partial tail page can remain
+    // writable). Old images without a consolidated GOT lack the symbol.
+    void **got;
+    uint32_t *got_len;
+    if (jl_dlsym(hdl, "jl_dispatch_got", (void**)&got, 0) &&
+        jl_dlsym(hdl, "jl_dispatch_got_len", (void**)&got_len, 0)) {
+        uintptr_t lo = LLT_ALIGN((uintptr_t)got, jl_page_size);
+        uintptr_t hi = (uintptr_t)(got + *got_len) & ~(uintptr_t)(jl_page_size - 1);
+        if (hi > lo) {
+#ifdef _OS_WINDOWS_
+            DWORD old_prot;
+            VirtualProtect((void*)lo, hi - lo, PAGE_READONLY, &old_prot);
+#else
+            mprotect((void*)lo, hi - lo, PROT_READ);
+#endif
+        }
+    }
+
     return res;
 }
 
@@ -557,6 +557,11 @@ struct recur_list {
     jl_value_t *v;
 };
 
+// recursion-depth cap for jl_static_show_bounded; 0 means unbounded.
+// thread-local so a bounded rendering on one thread cannot truncate a
+// concurrent unbounded one.
+static __thread size_t static_show_depth_cap = 0;
+
 static size_t jl_static_show_x(JL_STREAM *out, jl_value_t *v, struct recur_list *depth) JL_NOTSAFEPOINT;
 
 JL_DLLEXPORT int jl_id_start_char(uint32_t wc) JL_NOTSAFEPOINT;
@@ -1023,6 +1028,8 @@ static size_t jl_static_show_x(JL_STREAM *out, jl_value_t *v, struct recur_list
         dist++;
         p = p->prev;
     }
+    if (static_show_depth_cap && dist > static_show_depth_cap)
+        return jl_printf(out, "…");
     return jl_static_show_x_(out, v, (jl_datatype_t*)jl_typeof(v), &this_item);
 }
 
@@ -1031,6 +1038,33 @@ JL_DLLEXPORT size_t jl_static_show(JL_STREAM *out, jl_value_t *v) JL_NOTSAFEPOIN
     return jl_static_show_x(out, v, 0);
 }
 
+// Like jl_static_show, but with recursion depth capped at `max_depth` and
+// output truncated at `max_bytes` (0 disables either limit), and with the
+// whole rendering staged in a memory stream so it reaches `out` as a single
+// write rather than one small write per token. Elided nesting and truncated
+// output are both marked with "…". Intended for error paths that render
+// deeply-parameterized types, where the exact unbounded form costs far more
+// than it is worth; jl_static_show itself stays unbuffered so that partial
+// output survives if rendering a corrupt object crashes mid-way.
+JL_DLLEXPORT size_t jl_static_show_bounded(JL_STREAM *out, jl_value_t *v,
+                                           size_t max_depth, size_t max_bytes) JL_NOTSAFEPOINT
+{
+    ios_t buf;
+    ios_mem(&buf, 0);
+    size_t prev_cap = static_show_depth_cap;
+    static_show_depth_cap = max_depth;
+    jl_static_show_x((JL_STREAM*)&buf, v, 0);
+    static_show_depth_cap = prev_cap;
+    size_t n = buf.size;
+    if (max_bytes && n > max_bytes)
+        n = max_bytes;
+    jl_uv_puts(out, buf.buf, n);
+    if (n < buf.size)
+        n += jl_printf(out, "…");
+    ios_close(&buf);
+    return n;
+}
+
 JL_DLLEXPORT size_t jl_static_show_func_sig(JL_STREAM *s, jl_value_t *type) JL_NOTSAFEPOINT
 {
     jl_value_t *ftype = (jl_value_t*)jl_first_argument_datatype(type);
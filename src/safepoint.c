@@ -9,6 +9,18 @@
 #define MAP_ANONYMOUS MAP_ANON
 #endif
 #endif
+#if defined(_OS_LINUX_)
+#include <sys/syscall.h>
+#include <unistd.h>
+#ifdef SYS_membarrier
+// Linux 4.14+. The headers may predate the expedited commands.
+#ifndef MEMBARRIER_CMD_PRIVATE_EXPEDITED
+#define MEMBARRIER_CMD_PRIVATE_EXPEDITED (1 << 3)
+#define MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED (1 << 4)
+#endif
+#define JL_HAVE_MEMBARRIER
+#endif
+#endif
 #include "julia_assert.h"
 
 #ifdef __cplusplus
@@ -46,6 +58,28 @@ uint8_t jl_safepoint_enable_cnt[3] = {0, 0, 0};
 // Acquiring and releasing this lock should use the `jl_mutex_*_nogc` functions
 jl_mutex_t safepoint_lock;
 
+#ifdef JL_HAVE_MEMBARRIER
+static int jl_membarrier_works = 0;
+#endif
+
+// Issue a process-wide memory barrier on behalf of all mutator threads.
+// Mutator `gc_state` transitions (`jl_gc_state_set` in julia_threads.h) are
+// plain stores with no fences or atomic RMWs -- that keeps the transitions
+// around every ccall nearly free. The collector pays for the synchronization
+// instead: calling this after enabling the safepoint pages orders every
+// mutator's prior stores (both `gc_state` and heap writes) before our
+// subsequent reads, so `jl_gc_wait_for_the_world` can trust what it sees.
+// On kernels without membarrier(2) we get the same effect for free from the
+// `mprotect` in `jl_safepoint_enable`: the TLB shootdown IPIs every core
+// running this process, which serializes their pending stores.
+static void jl_safepoint_sync_gc_state(void)
+{
+#ifdef JL_HAVE_MEMBARRIER
+    if (jl_membarrier_works)
+        syscall(SYS_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0);
+#endif
+}
+
 static void jl_safepoint_enable(int idx)
 {
     // safepoint_lock should be held
@@ -106,6 +140,11 @@ void jl_safepoint_init(void)
     // The signal page is for the gc safepoint.
     // The page before it is the sigint pending flag.
     jl_safepoint_pages = addr;
+#ifdef JL_HAVE_MEMBARRIER
+    // Expedited membarrier must be registered before first use.
+    jl_membarrier_works =
+        (syscall(SYS_membarrier, MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0) == 0);
+#endif
 }
 
 int jl_safepoint_start_gc(void)
@@ -129,6 +168,9 @@ int jl_safepoint_start_gc(void)
     }
     jl_safepoint_enable(1);
     jl_safepoint_enable(2);
+    // Flush the mutators' plain `gc_state` stores before we start
+    // inspecting them in `jl_gc_wait_for_the_world`.
+    jl_safepoint_sync_gc_state();
     jl_mutex_unlock_nogc(&safepoint_lock);
     return 1;
 #else
@@ -173,6 +215,10 @@ void jl_safepoint_wait_gc(void)
     // Use normal volatile load in the loop.
     // Use a acquire load to make sure the GC result is visible on this thread.
     while (jl_gc_running || jl_atomic_load_acquire(&jl_gc_running)) {
+        // Help out with parallel marking if the collecting thread
+        // published work for us (no-op otherwise).
+        jl_gc_mark_worker_from_safepoint();
+        jl_gc_sweep_worker_from_safepoint();
         jl_cpu_pause(); // yield?
     }
 #else
@@ -6,6 +6,7 @@
 #include <inttypes.h>
 #include "julia.h"
 #include "julia_internal.h"
+#include "ptrhash.h"
 #ifndef _OS_WINDOWS_
 #include <unistd.h>
 #include <sys/mman.h>
@@ -23,10 +24,83 @@ static volatile size_t bt_size_max = 0;
 static volatile size_t bt_size_cur = 0;
 static volatile uint64_t nsecprof = 0;
 static volatile int running = 0;
+// sample on per-thread CPU-time clocks instead of wall time (Linux only)
+static volatile int profile_cputime = 0;
+// append a [marker, tid, task, state] trailer to each sample block
+static volatile int profile_thread_data = 0;
+// capture samples by walking frame-pointer chains instead of libunwind
+static volatile int profile_fp_unwind = 0;
 static const    uint64_t GIGA = 1000000000ULL;
 // Timers to take samples at intervals
 JL_DLLEXPORT void jl_profile_stop_timer(void);
 JL_DLLEXPORT int jl_profile_start_timer(void);
+// collapsed-stack (flamegraph) export, defined below the platform parts
+JL_DLLEXPORT int jl_profile_write_collapsed(const char *fname);
+
+// Streaming profiler //
+// When streaming is active, each sample the platform sampler records into
+// bt_data_prof is immediately moved into a fixed-size ring buffer and the
+// cursor rewound, so memory stays bounded no matter how long the profile
+// runs. A consumer thread drains the ring and appends varint-coded samples
+// to a file. The producer is always the dedicated sampler thread (the
+// signal listener / profile_bt / mach exception thread), never an actual
+// signal handler, so a single-producer single-consumer ring with
+// acquire/release ordering is sufficient. Neither side ever blocks the
+// other: if the consumer falls behind, whole samples are dropped and
+// counted instead.
+#define PROF_STREAM_RING_WORDS (1 << 16) // power of two; 512kb on 64-bit
+static intptr_t *prof_stream_ring = NULL;
+static volatile size_t prof_stream_head = 0; // next write; sampler thread only
+static volatile size_t prof_stream_tail = 0; // next read; consumer thread only
+static volatile int prof_streaming = 0;
+static volatile uint64_t prof_stream_ndropped = 0;
+static uv_thread_t prof_stream_thread;
+static ios_t prof_stream_out;
+
+// move the sample just recorded at bt_data_prof[start..bt_size_cur) into
+// the ring and rewind the cursor, so the fixed buffer only ever holds the
+// sample currently being unwound
+static void jl_profile_stream_push(size_t start)
+{
+    size_t n = bt_size_cur - start;
+    size_t head = prof_stream_head;
+    size_t used = head - jl_atomic_load_acquire(&prof_stream_tail);
+    bt_size_cur = start;
+    if (PROF_STREAM_RING_WORDS - used < n) {
+        // drop the whole sample, never a partial one
+        prof_stream_ndropped++;
+        return;
+    }
+    for (size_t i = 0; i < n; i++)
+        prof_stream_ring[(head + i) & (PROF_STREAM_RING_WORDS - 1)] =
+            bt_data_prof[start + i];
+    jl_atomic_store_release(&prof_stream_head, head + n);
+}
+
+// Per-sample thread attribution //
+// when profile_thread_data is on, each sample block carries a trailer of
+// PROF_THREAD_DATA_NWORDS words between the backtrace and the zero
+// terminator: a marker, the thread id, the task the thread was running,
+// and whether it was executing user code or idling in the scheduler.
+// all-ones is taken (JL_BT_INTERP_FRAME appears in profile data when the
+// interpreter is on the stack), so the marker is -2, which can be neither
+// a return address nor one of the interpreter frame's payload pointers
+#define PROF_THREAD_DATA_MARKER ((intptr_t)-2)
+#define PROF_THREAD_DATA_NWORDS 4
+#define PROF_STATE_RUNNING 1
+#define PROF_STATE_SCHEDULER 2
+
+static void jl_profile_append_thread_data(int16_t tid)
+{
+    if (bt_size_cur + PROF_THREAD_DATA_NWORDS >= bt_size_max - 1)
+        return;
+    jl_ptls_t ptls2 = jl_all_tls_states[tid];
+    bt_data_prof[bt_size_cur++] = PROF_THREAD_DATA_MARKER;
+    bt_data_prof[bt_size_cur++] = (intptr_t)tid;
+    bt_data_prof[bt_size_cur++] = (intptr_t)ptls2->current_task;
+    bt_data_prof[bt_size_cur++] = jl_thread_in_scheduler(tid) ?
+        PROF_STATE_SCHEDULER : PROF_STATE_RUNNING;
+}
 
 static uint64_t jl_last_sigint_trigger = 0;
 static uint64_t jl_disable_sigint_time = 0;
@@ -284,6 +358,331 @@ JL_DLLEXPORT int jl_profile_is_running(void)
     return running;
 }
 
+// sample on per-thread CPU-time clocks instead of wall time, so samples
+// land on the threads actually burning CPU; Linux (POSIX timers) only
+JL_DLLEXPORT int jl_profile_set_cputime(int enable)
+{
+#if defined(HAVE_TIMER)
+    if (running)
+        return -1;
+    profile_cputime = enable;
+    return 0;
+#else
+    (void)enable;
+    return enable ? -1 : 0;
+#endif
+}
+
+JL_DLLEXPORT int jl_profile_get_cputime(void)
+{
+    return profile_cputime;
+}
+
+// record the [marker, tid, task, state] trailer with each sample; readers
+// that enable this must strip PROF_THREAD_DATA_NWORDS words per block
+JL_DLLEXPORT void jl_profile_set_thread_data(int enable)
+{
+    profile_thread_data = enable;
+}
+
+JL_DLLEXPORT int jl_profile_get_thread_data(void)
+{
+    return profile_thread_data;
+}
+
+// capture samples by walking frame-pointer chains (rec_backtrace_ctx_fp),
+// which is roughly an order of magnitude cheaper than libunwind; samples
+// that hit a frame without a frame pointer near the top of the stack fall
+// back to the full unwinder
+JL_DLLEXPORT void jl_profile_set_fp_unwind(int enable)
+{
+    profile_fp_unwind = enable;
+}
+
+JL_DLLEXPORT int jl_profile_get_fp_unwind(void)
+{
+    return profile_fp_unwind;
+}
+
+// Collapsed-stack export //
+// Writes the accumulated profile as one "frame;frame;...;leaf count" line
+// per unique stack — the folded format flamegraph renderers consume
+// directly — symbolized in-process through jl_getFunctionInfo, so frames
+// that were inlined away appear as their own ';'-separated entries.
+// Identical stacks are aggregated first and every distinct return address
+// is symbolized once, keeping the export cheap relative to the buffer
+// size. Available any time through jl_profile_write_collapsed; delivering
+// SIGINFO (SIGUSR1 where SIGINFO does not exist) to a process started
+// with JULIA_PROFILE_COLLAPSED=<file> writes the same file from the
+// signal listener, which covers pulling a flamegraph out of a production
+// process without attaching to it.
+
+typedef struct {
+    size_t start;   // first word of the sample in bt_data_prof
+    size_t len;     // words, excluding any trailer and the terminator
+    int16_t tid;    // thread id from the sample trailer, or -1
+    uint64_t hash;
+    uint64_t count;
+} prof_fold_ent_t;
+
+static uint64_t prof_fold_hash(size_t start, size_t len, int16_t tid)
+{
+    uint64_t h = 0xcbf29ce484222325ULL ^ (uint64_t)(uint16_t)tid;
+    for (size_t i = 0; i < len; i++) {
+        h ^= (uint64_t)bt_data_prof[start + i];
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+static int prof_fold_eq(prof_fold_ent_t *e, size_t start, size_t len, int16_t tid)
+{
+    return e->len == len && e->tid == tid &&
+        memcmp((void*)&bt_data_prof[e->start], (void*)&bt_data_prof[start],
+               len * sizeof(intptr_t)) == 0;
+}
+
+// copy `name` with the characters that delimit the folded format (';'
+// between frames, ' ' before the count) replaced
+static void prof_fold_putname(ios_t *s, const char *name)
+{
+    for (; *name; name++) {
+        char c = *name;
+        if (c == ';' || c == ' ' || c == '\n')
+            c = '_';
+        ios_putc(c, s);
+    }
+}
+
+// symbolize one return address into a ';'-joined, outermost-first run of
+// frame names (one address expands to several when inlining collapsed
+// them); the caller owns the returned malloc'd string
+static char *prof_fold_symbolize(uintptr_t ip)
+{
+    jl_frame_t *frames = NULL;
+    int n = jl_getFunctionInfo(&frames, ip, 0, 0);
+    ios_t str;
+    ios_mem(&str, 64);
+    if (n <= 0) {
+        ios_printf(&str, "unknown_0x%" PRIxPTR, ip);
+    }
+    else {
+        // jl_getFunctionInfo lists innermost first; folded stacks grow
+        // from the root, so emit in reverse
+        for (int i = n - 1; i >= 0; i--) {
+            jl_frame_t *frame = &frames[i];
+            if (frame->func_name) {
+                prof_fold_putname(&str, frame->func_name);
+                free(frame->func_name);
+            }
+            else {
+                ios_printf(&str, "unknown_0x%" PRIxPTR, ip);
+            }
+            free(frame->file_name);
+            if (i > 0)
+                ios_putc(';', &str);
+        }
+        free(frames);
+    }
+    ios_putc('\0', &str);
+    return ios_take_buffer(&str, &(size_t){0});
+}
+
+JL_DLLEXPORT int jl_profile_write_collapsed(const char *fname)
+{
+    size_t nwords = bt_size_cur;
+    if (bt_data_prof == NULL || nwords == 0)
+        return -1;
+    ios_t out;
+    if (ios_file(&out, fname, 1, 1, 1, 1) == NULL)
+        return -1;
+    // pass 1: aggregate identical samples in an open-addressing table
+    size_t nsamples = 0;
+    for (size_t i = 0; i < nwords; i++)
+        nsamples += (bt_data_prof[i] == 0);
+    size_t tabsz = 64;
+    while (tabsz < 2 * nsamples)
+        tabsz *= 2;
+    prof_fold_ent_t *tab = (prof_fold_ent_t*)calloc(tabsz, sizeof(prof_fold_ent_t));
+    if (tab == NULL) {
+        ios_close(&out);
+        return -1;
+    }
+    for (size_t i = 0; i < nwords; ) {
+        size_t end = i;
+        while (end < nwords && bt_data_prof[end] != 0)
+            end++;
+        size_t len = end - i;
+        int16_t tid = -1;
+        if (len >= PROF_THREAD_DATA_NWORDS &&
+            bt_data_prof[end - PROF_THREAD_DATA_NWORDS] == PROF_THREAD_DATA_MARKER) {
+            tid = (int16_t)bt_data_prof[end - PROF_THREAD_DATA_NWORDS + 1];
+            len -= PROF_THREAD_DATA_NWORDS;
+        }
+        if (len > 0) {
+            uint64_t h = prof_fold_hash(i, len, tid);
+            size_t slot = h & (tabsz - 1);
+            while (tab[slot].count &&
+                   !(tab[slot].hash == h && prof_fold_eq(&tab[slot], i, len, tid)))
+                slot = (slot + 1) & (tabsz - 1);
+            if (!tab[slot].count) {
+                tab[slot].start = i;
+                tab[slot].len = len;
+                tab[slot].tid = tid;
+                tab[slot].hash = h;
+            }
+            tab[slot].count++;
+        }
+        i = end + 1;
+    }
+    // pass 2: symbolize each distinct address once, then write the lines
+    htable_t symcache;
+    htable_new(&symcache, 512);
+    for (size_t s = 0; s < tabsz; s++) {
+        if (tab[s].count == 0)
+            continue;
+        if (tab[s].tid != -1)
+            ios_printf(&out, "thread_%d;", (int)tab[s].tid);
+        // samples record the leaf first; folded stacks start at the root
+        size_t base = tab[s].start;
+        for (size_t j = tab[s].len; j-- > 0; ) {
+            uintptr_t w = (uintptr_t)bt_data_prof[base + j];
+            if (w == JL_BT_INTERP_FRAME) {
+                // marker plus two payload words, recorded before the
+                // frames it annotates; attribute it as one frame
+                ios_puts("interpreter", &out);
+            }
+            else if (j >= 2 && (uintptr_t)bt_data_prof[base + j - 2] == JL_BT_INTERP_FRAME) {
+                // payload of an interpreter frame, not a return address
+                continue;
+            }
+            else if (j >= 1 && (uintptr_t)bt_data_prof[base + j - 1] == JL_BT_INTERP_FRAME) {
+                continue;
+            }
+            else {
+                char *name = (char*)ptrhash_get(&symcache, (void*)w);
+                if (name == HT_NOTFOUND) {
+                    name = prof_fold_symbolize(w - 1);
+                    ptrhash_put(&symcache, (void*)w, name);
+                }
+                ios_puts(name, &out);
+            }
+            if (j > 0)
+                ios_putc(';', &out);
+        }
+        ios_printf(&out, " %" PRIu64 "\n", tab[s].count);
+    }
+    for (size_t i = 0; i < symcache.size; i += 2) {
+        if (symcache.table[i + 1] != HT_NOTFOUND)
+            free(symcache.table[i + 1]);
+    }
+    htable_free(&symcache);
+    free(tab);
+    ios_close(&out);
+    return 0;
+}
+
+// ULEB128; a typical return address codes in <= 7 bytes and the zero
+// block terminator in one, vs sizeof(intptr_t) for the raw word
+static void prof_stream_putvarint(ios_t *s, uintptr_t v)
+{
+    while (v >= 0x80) {
+        ios_putc((int)(v & 0x7f) | 0x80, s);
+        v >>= 7;
+    }
+    ios_putc((int)v, s);
+}
+
+static void prof_stream_run(void *arg)
+{
+    (void)arg;
+    while (1) {
+        // check the run flag before loading head, so that once streaming
+        // is off we do one final drain of everything already published
+        int draining = !prof_streaming;
+        size_t head = jl_atomic_load_acquire(&prof_stream_head);
+        size_t tail = prof_stream_tail;
+        if (head == tail) {
+            if (draining)
+                break;
+#ifdef _OS_WINDOWS_
+            Sleep(1);
+#else
+            usleep(1000);
+#endif
+            continue;
+        }
+        do {
+            prof_stream_putvarint(&prof_stream_out,
+                (uintptr_t)prof_stream_ring[tail & (PROF_STREAM_RING_WORDS - 1)]);
+            tail++;
+        } while (tail != head);
+        jl_atomic_store_release(&prof_stream_tail, tail);
+    }
+    ios_flush(&prof_stream_out);
+}
+
+// Start streaming samples to fname. jl_profile_init must have been called
+// first: bt_data_prof stays the scratch space a single sample is unwound
+// into, so its size only needs to cover the deepest backtrace, not the
+// whole run. Samples are written as varint-coded words in the usual
+// profile format (zero-terminated backtraces), after an 8-byte header of
+// "JLPROF", a format version byte and the word size in bytes.
+JL_DLLEXPORT int jl_profile_stream_start(const char *fname)
+{
+    if (running || prof_streaming)
+        return -1;
+    if (bt_data_prof == NULL)
+        return -1;
+    if (prof_stream_ring == NULL) {
+        // kept allocated across sessions; freeing it would race with a
+        // straggler sample already past the prof_streaming check
+        prof_stream_ring = (intptr_t*)malloc(PROF_STREAM_RING_WORDS * sizeof(intptr_t));
+        if (prof_stream_ring == NULL)
+            return -1;
+    }
+    if (ios_file(&prof_stream_out, fname, 0, 1, 1, 1) == NULL)
+        return -1;
+    ios_write(&prof_stream_out, "JLPROF\x01", 7);
+    ios_putc((int)sizeof(uintptr_t), &prof_stream_out);
+    bt_size_cur = 0;
+    prof_stream_head = 0;
+    prof_stream_tail = 0;
+    prof_stream_ndropped = 0;
+    prof_streaming = 1;
+    if (uv_thread_create(&prof_stream_thread, prof_stream_run, NULL) != 0) {
+        prof_streaming = 0;
+        ios_close(&prof_stream_out);
+        return -1;
+    }
+    return 0;
+}
+
+JL_DLLEXPORT int jl_profile_stream_stop(void)
+{
+    if (!prof_streaming)
+        return -1;
+    if (running)
+        jl_profile_stop_timer();
+    // let an in-flight sample from the sampler thread land before telling
+    // the consumer to drain the ring and exit
+#ifdef _OS_WINDOWS_
+    Sleep((DWORD)(2 * (nsecprof / 1000000) + 2));
+#else
+    usleep((useconds_t)(2 * (nsecprof / 1000) + 2000));
+#endif
+    prof_streaming = 0;
+    uv_thread_join(&prof_stream_thread);
+    ios_close(&prof_stream_out);
+    return 0;
+}
+
+// samples dropped because the consumer could not keep up
+JL_DLLEXPORT uint64_t jl_profile_stream_ndropped(void)
+{
+    return prof_stream_ndropped;
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -437,6 +437,7 @@ void *mach_profile_listener(void *arg)
                 break;
 
             unw_context_t *uc;
+            size_t bt_start = bt_size_cur;
             jl_thread_suspend_and_get_state(i, &uc);
 
 #ifdef LIBOSXUNWIND
@@ -476,6 +477,11 @@ void *mach_profile_listener(void *arg)
             // Mark the end of this block with 0
             bt_data_prof[bt_size_cur++] = 0;
 
+            if (prof_streaming) {
+                // stream the sample out and reuse the buffer
+                jl_profile_stream_push(bt_start);
+            }
+
             // We're done! Resume the thread.
             jl_thread_resume(i, 0);
 
@@ -409,6 +409,9 @@ void usr2_handler(int sig, siginfo_t *info, void *ctx)
 
 static timer_t timerprof;
 static struct itimerspec itsprof;
+// CPU-time mode: one timer per thread, each on that thread's CPU clock
+static timer_t *cpu_timerprof = NULL;
+static int n_cpu_timerprof = 0;
 
 JL_DLLEXPORT int jl_profile_start_timer(void)
 {
@@ -419,14 +422,42 @@ JL_DLLEXPORT int jl_profile_start_timer(void)
     sigprof.sigev_notify = SIGEV_SIGNAL;
     sigprof.sigev_signo = SIGUSR1;
     sigprof.sigev_value.sival_ptr = &timerprof;
-    if (timer_create(CLOCK_REALTIME, &sigprof, &timerprof) == -1)
-        return -2;
 
-    // Start the timer
     itsprof.it_interval.tv_sec = nsecprof/GIGA;
     itsprof.it_interval.tv_nsec = nsecprof%GIGA;
     itsprof.it_value.tv_sec = nsecprof/GIGA;
     itsprof.it_value.tv_nsec = nsecprof%GIGA;
+
+    if (profile_cputime) {
+        // one timer per thread on its CPU-time clock: each fires after the
+        // thread has consumed nsecprof of CPU, so samples land on the
+        // threads doing the work, and the expiration carries the tid so
+        // the listener knows which thread to sample
+        cpu_timerprof = (timer_t*)calloc(jl_n_threads, sizeof(timer_t));
+        if (cpu_timerprof == NULL)
+            return -2;
+        for (n_cpu_timerprof = 0; n_cpu_timerprof < jl_n_threads; n_cpu_timerprof++) {
+            clockid_t clk;
+            sigprof.sigev_value.sival_int = n_cpu_timerprof;
+            if (pthread_getcpuclockid(jl_all_tls_states[n_cpu_timerprof]->system_id, &clk) != 0 ||
+                timer_create(clk, &sigprof, &cpu_timerprof[n_cpu_timerprof]) == -1) {
+                jl_profile_stop_timer();
+                return -2;
+            }
+            if (timer_settime(cpu_timerprof[n_cpu_timerprof], 0, &itsprof, NULL) == -1) {
+                n_cpu_timerprof++;
+                jl_profile_stop_timer();
+                return -3;
+            }
+        }
+        running = 1;
+        return 0;
+    }
+
+    if (timer_create(CLOCK_REALTIME, &sigprof, &timerprof) == -1)
+        return -2;
+
+    // Start the timer
     if (timer_settime(timerprof, 0, &itsprof, NULL) == -1)
         return -3;
 
@@ -436,8 +467,16 @@ JL_DLLEXPORT int jl_profile_start_timer(void)
 
 JL_DLLEXPORT void jl_profile_stop_timer(void)
 {
-    if (running)
+    if (cpu_timerprof != NULL) {
+        for (int i = 0; i < n_cpu_timerprof; i++)
+            timer_delete(cpu_timerprof[i]);
+        free(cpu_timerprof);
+        cpu_timerprof = NULL;
+        n_cpu_timerprof = 0;
+    }
+    else if (running) {
         timer_delete(timerprof);
+    }
     running = 0;
 }
 
@@ -556,6 +595,7 @@ static void *signal_listener(void *arg)
     static size_t bt_size = 0;
     sigset_t sset;
     int sig, critical, profile;
+    int profile_tid; // thread whose CPU timer fired, or -1 to sample all
     jl_sigsetset(&sset);
 #ifdef HAVE_KEVENT
     struct kevent ev;
@@ -581,6 +621,7 @@ static void *signal_listener(void *arg)
     while (1) {
         sig = 0;
         errno = 0;
+        profile_tid = -1;
 #ifdef HAVE_KEVENT
         if (sigqueue != -1) {
             int nevents = kevent(sigqueue, NULL, 0, &ev, 1, NULL);
@@ -598,6 +639,25 @@ static void *signal_listener(void *arg)
         }
         else
 #endif
+#if defined(HAVE_TIMER)
+        // use sigwaitinfo where we have POSIX timers: in CPU-time mode the
+        // timer expiration's value slot says which thread's timer fired
+        siginfo_t sinfo;
+        int swr = sigwaitinfo(&sset, &sinfo);
+        if (swr == -1) {
+            if (errno == EINTR)
+                continue; // same spurious wakeup as described for sigwait below
+            sig = SIGABRT; // this branch can't occur, unless we had stack memory corruption of sset
+        }
+        else {
+            sig = swr;
+            if (profile_cputime && sig == SIGUSR1 && sinfo.si_code == SI_TIMER)
+                profile_tid = sinfo.si_value.sival_int;
+        }
+        if (!sig) {
+            continue;
+        }
+#else
         if (sigwait(&sset, &sig)) {
             sig = SIGABRT; // this branch can't occur, unless we had stack memory corruption of sset
         }
@@ -613,6 +673,7 @@ static void *signal_listener(void *arg)
             // So signals really do seem to always just be lose-lose.
             continue;
         }
+#endif
 #ifndef HAVE_MACH
 #  ifdef HAVE_ITIMER
         profile = (sig == SIGPROF);
@@ -661,6 +722,10 @@ static void *signal_listener(void *arg)
         // sample each thread, round-robin style in reverse order
         // (so that thread zero gets notified last)
         for (int i = jl_n_threads; i-- > 0; ) {
+            // in CPU-time mode only the thread whose timer fired is sampled
+            if (!critical && profile_tid != -1 && profile_tid != i)
+                continue;
+
             // notify thread to stop
             jl_thread_suspend_and_get_state(i, &signal_context);
 
@@ -675,7 +740,11 @@ static void *signal_listener(void *arg)
 
             // do backtrace for profiler
             if (profile && running) {
-                if (bt_size_cur < bt_size_max - 1) {
+                size_t bt_start = bt_size_cur;
+                // leave room for the thread-data trailer and terminator
+                size_t bt_reserve = 1 +
+                    (profile_thread_data ? PROF_THREAD_DATA_NWORDS : 0);
+                if (bt_size_cur + bt_reserve < bt_size_max) {
                     // unwinding can fail, so keep track of the current state
                     // and restore from the SEGV handler if anything happens.
                     jl_ptls_t ptls = jl_get_ptls_states();
@@ -687,15 +756,33 @@ static void *signal_listener(void *arg)
                         jl_safe_printf("WARNING: profiler attempt to access an invalid memory location\n");
                     } else {
                         // Get backtrace data
-                        bt_size_cur += rec_backtrace_ctx((uintptr_t*)bt_data_prof + bt_size_cur,
-                                bt_size_max - bt_size_cur - 1, signal_context);
+                        size_t space = bt_size_max - bt_size_cur - bt_reserve;
+                        size_t nfp = 0;
+                        if (profile_fp_unwind)
+                            nfp = rec_backtrace_ctx_fp((uintptr_t*)bt_data_prof + bt_size_cur,
+                                    space, signal_context);
+                        if (nfp > 1) {
+                            bt_size_cur += nfp;
+                        }
+                        else {
+                            // no usable frame-pointer chain at this sample
+                            // point: take the slow, table-driven path
+                            bt_size_cur += rec_backtrace_ctx((uintptr_t*)bt_data_prof + bt_size_cur,
+                                    space, signal_context);
+                        }
                     }
                     ptls->safe_restore = old_buf;
 
+                    if (profile_thread_data)
+                        jl_profile_append_thread_data((int16_t)i);
                     // Mark the end of this block with 0
                     bt_data_prof[bt_size_cur++] = 0;
                 }
-                if (bt_size_cur >= bt_size_max - 1) {
+                if (prof_streaming) {
+                    // stream the sample out and reuse the buffer
+                    jl_profile_stream_push(bt_start);
+                }
+                else if (bt_size_cur >= bt_size_max - 1) {
                     // Buffer full: Delete the timer
                     jl_profile_stop_timer();
                 }
@@ -710,6 +797,13 @@ static void *signal_listener(void *arg)
         // and must be thread-safe, but not necessarily signal-handler safe
         if (critical) {
             jl_critical_error(sig, NULL, bt_data, &bt_size);
+            if (!doexit) {
+                // the non-fatal status signal also exports a symbolized
+                // flamegraph when JULIA_PROFILE_COLLAPSED names a file
+                const char *collapsed = getenv("JULIA_PROFILE_COLLAPSED");
+                if (collapsed && collapsed[0])
+                    jl_profile_write_collapsed(collapsed);
+            }
             if (doexit) {
                 thread0_exit_count++;
                 jl_exit_thread0(128 + sig);
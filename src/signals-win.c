@@ -345,11 +345,16 @@ static DWORD WINAPI profile_bt( LPVOID lparam )
                 break;
             }
             // Get backtrace data
+            size_t bt_start = bt_size_cur;
             bt_size_cur += rec_backtrace_ctx((uintptr_t*)bt_data_prof + bt_size_cur,
                 bt_size_max - bt_size_cur - 1, &ctxThread);
             // Mark the end of this block with 0
             bt_data_prof[bt_size_cur] = 0;
             bt_size_cur++;
+            if (prof_streaming) {
+                // stream the sample out and reuse the buffer
+                jl_profile_stream_push(bt_start);
+            }
             if ((DWORD)-1 == ResumeThread(hMainThread)) {
                 fputs("failed to resume main thread! aborting.",stderr);
                 gc_debug_critical_error();
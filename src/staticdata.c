@@ -14,6 +14,7 @@
 
 #ifndef _OS_WINDOWS_
 #include <dlfcn.h>
+#include <sys/mman.h>
 #endif
 
 #ifndef _COMPILER_MICROSOFT_
@@ -259,6 +260,7 @@ static void jl_serialize_module(jl_serializer_state *s, jl_module_t *m)
     jl_serialize_value(s, m->name);
     jl_serialize_value(s, m->parent);
     size_t i;
+    jl_module_ensure_bindings(m);
     void **table = m->bindings.table;
     for (i = 1; i < m->bindings.size; i += 2) {
         if (table[i] != HT_NOTFOUND) {
@@ -478,6 +480,7 @@ static void jl_write_module(jl_serializer_state *s, uintptr_t item, jl_module_t
     // (the ptrhash will need to be recreated on load)
     size_t count = 0;
     size_t i;
+    jl_module_ensure_bindings(m);
     void **table = m->bindings.table;
     for (i = 1; i < m->bindings.size; i += 2) {
         if (table[i] != HT_NOTFOUND) {
@@ -501,8 +504,11 @@ static void jl_write_module(jl_serializer_state *s, uintptr_t item, jl_module_t
     assert(ios_pos(s->s) - reloc_offset == tot);
     newm = (jl_module_t*)&s->s->buf[reloc_offset];
     newm->bindings.size = count; // stash the count in newm->size
+    newm->bindings.nused = 0;
     newm->bindings.table = NULL;
+    newm->bindings.meta = NULL;
     memset(&newm->bindings._space, 0, sizeof(newm->bindings._space));
+    memset(&newm->bindings._metaspace, 0, sizeof(newm->bindings._metaspace));
 
     // write out the usings list
     memset(&newm->usings._space, 0, sizeof(newm->usings._space));
@@ -1190,6 +1196,69 @@ static void jl_finalize_serializer(jl_serializer_state *s)
 }
 
 
+// whether to defer rebuilding sysimage binding tables until a module is
+// first touched (see jl_module_ensure_bindings); saves the rebuild work and
+// the table allocations for stdlib modules a process never looks at
+static int jl_lazy_module_bindings(void)
+{
+    static int lazy = -1;
+    if (lazy == -1) {
+        char *cp = getenv("JULIA_LAZY_MODULE_BINDINGS");
+        lazy = (cp && strcmp(cp, "0")) ? 1 : 0;
+    }
+    return lazy;
+}
+
+static jl_mutex_t lazy_bindings_lock;
+
+// rebuild the binding hash table of a module restored from the sysimage; the
+// serialized form stores the binding count in mod->bindings.size, a NULL
+// table pointer, and the bindings themselves as an array after the module.
+// The table is sized once from the count, so the rebuild is a single
+// allocation plus one probe per binding with no growth rehashes. Baking the
+// final slot layout into the image instead is not possible as long as the
+// table is keyed on symbol pointers: ptrhash buckets depend on the absolute
+// addresses the image relocates to, which differ from run to run, so the
+// writer cannot know where each binding will land.
+void jl_module_rebuild_bindings(jl_module_t *mod) JL_NOTSAFEPOINT
+{
+    JL_LOCK_NOGC(&lazy_bindings_lock);
+    if (mod->bindings.table != NULL) { // raced with another thread
+        JL_UNLOCK_NOGC(&lazy_bindings_lock);
+        return;
+    }
+    assert(jl_is_module(mod));
+    size_t nbindings = mod->bindings.size;
+    htable_t h;
+    htable_new(&h, nbindings);
+    struct binding {
+        uintptr_t tag;
+        jl_binding_t b;
+    } *b;
+    b = (struct binding*)&mod[1];
+    while (nbindings > 0) {
+        ptrhash_put(&h, (char*)b->b.name, &b->b);
+        b += 1;
+        nbindings -= 1;
+    }
+    mod->bindings.size = h.size;
+    mod->bindings.nused = h.nused;
+    if (h.table == &h._space[0]) {
+        memcpy(mod->bindings._space, h._space, sizeof(h._space));
+        memcpy(mod->bindings._metaspace, h._metaspace, sizeof(h._metaspace));
+        mod->bindings.meta = &mod->bindings._metaspace[0];
+        // release-publish last: readers check `table` with an acquire load
+        // and no lock (jl_module_ensure_bindings), so the table contents
+        // must be visible before the pointer
+        jl_atomic_store_release(&mod->bindings.table, &mod->bindings._space[0]);
+    }
+    else {
+        mod->bindings.meta = h.meta;
+        jl_atomic_store_release(&mod->bindings.table, h.table); // publish last
+    }
+    JL_UNLOCK_NOGC(&lazy_bindings_lock);
+}
+
 static void jl_reinit_item(jl_value_t *v, int how)
 {
     switch (how) {
@@ -1202,20 +1271,10 @@ static void jl_reinit_item(jl_value_t *v, int how)
             break;
         }
         case 2: { // rebuild the binding table for module v
-            jl_module_t *mod = (jl_module_t*)v;
-            assert(jl_is_module(mod));
-            size_t nbindings = mod->bindings.size;
-            htable_new(&mod->bindings, nbindings);
-            struct binding {
-                uintptr_t tag;
-                jl_binding_t b;
-            } *b;
-            b = (struct binding*)&mod[1];
-            while (nbindings > 0) {
-                ptrhash_put(&mod->bindings, (char*)b->b.name, &b->b);
-                b += 1;
-                nbindings -= 1;
-            }
+            // in lazy mode leave the serialized form in place (NULL table,
+            // count in size) and let the first access rebuild it
+            if (!jl_lazy_module_bindings())
+                jl_module_rebuild_bindings((jl_module_t*)v);
             break;
         }
         default:
@@ -1591,10 +1650,22 @@ JL_DLLEXPORT void jl_restore_system_image(const char *fname)
         JL_SIGATOMIC_BEGIN();
         ios_seek_end(&f);
         size_t len = ios_pos(&f);
-        char *sysimg = (char*)jl_gc_perm_alloc(len, 0, 64, 0);
-        ios_seek(&f, 0);
-        if (ios_readall(&f, sysimg, len) != len)
-            jl_errorf("Error reading system image file.");
+        char *sysimg = NULL;
+#ifndef _OS_WINDOWS_
+        // map the image copy-on-write instead of reading a private copy:
+        // startup skips the full read, and pages that relocation never
+        // writes stay shared between all processes using the same image
+        sysimg = (char*)mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE, f.fd, 0);
+        if (sysimg == MAP_FAILED)
+            sysimg = NULL;
+#endif
+        if (sysimg == NULL) {
+            // e.g. the image lives on a filesystem that cannot be mapped
+            sysimg = (char*)jl_gc_perm_alloc(len, 0, 64, 0);
+            ios_seek(&f, 0);
+            if (ios_readall(&f, sysimg, len) != len)
+                jl_errorf("Error reading system image file.");
+        }
         ios_close(&f);
         ios_static_buffer(&f, sysimg, len);
         jl_restore_system_image_from_stream(&f);
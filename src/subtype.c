@@ -26,6 +26,7 @@
 #endif
 #include "julia.h"
 #include "julia_internal.h"
+#include "threading.h"
 #include "julia_assert.h"
 
 #ifdef __cplusplus
@@ -133,6 +134,7 @@ static void statestack_set(jl_unionstate_t *st, int i, int val) JL_NOTSAFEPOINT
 
 typedef struct {
     int8_t *buf;
+    arena_mark_t mark;
     int rdepth;
 } jl_savedenv_t;
 
@@ -145,7 +147,9 @@ static void save_env(jl_stenv_t *e, jl_value_t **root, jl_savedenv_t *se)
         v = v->prev;
     }
     *root = (jl_value_t*)jl_alloc_svec(len*3);
-    se->buf = (int8_t*)(len ? malloc(len*2) : NULL);
+    arena_t *scratch = &jl_get_ptls_states()->scratch_arena;
+    se->mark = arena_save(scratch);
+    se->buf = (int8_t*)(len ? arena_alloc(scratch, len*2) : NULL);
 #ifdef __clang_analyzer__
     if (len)
         memset(se->buf, 0, len*2);
@@ -183,6 +187,13 @@ static void restore_env(jl_stenv_t *e, jl_value_t *root, jl_savedenv_t *se) JL_N
         memset(&e->envout[e->envidx], 0, (e->envsz - e->envidx)*sizeof(void*));
 }
 
+// release the scratch-arena space taken by `se` (and everything saved after it)
+static void free_env(jl_savedenv_t *se) JL_NOTSAFEPOINT
+{
+    arena_restore(&jl_get_ptls_states()->scratch_arena, se->mark);
+    se->buf = NULL;
+}
+
 // type utilities
 
 // quickly test that two types are identical
@@ -1151,7 +1162,7 @@ static int forall_exists_subtype(jl_value_t *x, jl_value_t *y, jl_stenv_t *e, in
         int set = e->Lunions.more;
         if (!sub || !set)
             break;
-        free(se.buf);
+        free_env(&se);
         save_env(e, &saved, &se);
         for (int i = set; i <= lastset; i++)
             statestack_set(&e->Lunions, i, 0);
@@ -1159,7 +1170,7 @@ static int forall_exists_subtype(jl_value_t *x, jl_value_t *y, jl_stenv_t *e, in
         statestack_set(&e->Lunions, lastset, 1);
     }
 
-    free(se.buf);
+    free_env(&se);
     JL_GC_POP();
     return sub;
 }
@@ -1374,9 +1385,73 @@ JL_DLLEXPORT int jl_obvious_subtype(jl_value_t *x, jl_value_t *y, int *subtype)
 // points to a rooted array of length `jl_subtype_env_size(y)`.
 // This will be populated with the values of variables from unionall
 // types at the outer level of `y`.
+// --- query corpus recording --------------------------------------------------
+// When JULIA_SUBTYPE_LOG names a file, every top-level subtype and
+// intersection query is appended to it as one tab-separated line:
+// the query kind, then both types printed with jl_static_show. The file
+// can be replayed and timed with contrib/bench_subtype.jl (`make
+// bench-subtype`), so solver changes can be validated against the query
+// distribution of a real session instead of synthetic types.
+static jl_mutex_t type_query_log_lock;
+static ios_t type_query_log_s;
+static volatile int type_query_log_on = -1; // -1 consult environment; 0 off; 1 on
+// intersection calls back into jl_subtype_env; only the outermost query
+// describes the work the caller asked for
+static __thread int type_query_nested = 0;
+
+static void record_type_query(const char *kind, jl_value_t *a, jl_value_t *b)
+{
+    JL_LOCK_NOGC(&type_query_log_lock);
+    if (type_query_log_on == -1) {
+        const char *fname = getenv("JULIA_SUBTYPE_LOG");
+        type_query_log_on =
+            (fname && fname[0] &&
+             ios_file(&type_query_log_s, fname, 1, 1, 1, 1) != NULL);
+    }
+    if (type_query_log_on) {
+        JL_STREAM *s = (JL_STREAM*)&type_query_log_s;
+        jl_printf(s, "%s\t", kind);
+        jl_static_show(s, a);
+        jl_printf(s, "\t");
+        jl_static_show(s, b);
+        jl_printf(s, "\n");
+        ios_flush(&type_query_log_s);
+    }
+    JL_UNLOCK_NOGC(&type_query_log_lock);
+}
+
+// store a finished env-free query in the thread-local memo table
+// (`ptls` is NULL when the query was not cacheable)
+STATIC_INLINE int record_subtype(jl_ptls_t ptls, uint32_t slot, jl_value_t *x, jl_value_t *y, int subtype)
+{
+    if (ptls) {
+        ptls->subtype_cache[slot].result = subtype;
+        ptls->subtype_cache[slot].x = x;
+        ptls->subtype_cache[slot].y = y;
+    }
+    return subtype;
+}
+
+// expose the thread-summed memo table counters so the table can be sized
+JL_DLLEXPORT void jl_subtype_cache_stats(uint64_t *hits, uint64_t *misses)
+{
+    uint64_t h = 0, m = 0;
+    for (int i = 0; i < jl_n_threads; i++) {
+        jl_ptls_t ptls2 = jl_all_tls_states[i];
+        h += ptls2->subtype_cache_hits;
+        m += ptls2->subtype_cache_misses;
+    }
+    *hits = h;
+    *misses = m;
+}
+
 JL_DLLEXPORT int jl_subtype_env(jl_value_t *x, jl_value_t *y, jl_value_t **env, int envsz)
 {
     jl_stenv_t e;
+    jl_ptls_t ptls = NULL;
+    uint32_t slot = 0;
+    if (__unlikely(type_query_log_on != 0) && !type_query_nested)
+        record_type_query("subtype", x, y);
     if (envsz == 0) {
         if (y == (jl_value_t*)jl_any_type || x == jl_bottom_type || x == y)
             return 1;
@@ -1384,16 +1459,28 @@ JL_DLLEXPORT int jl_subtype_env(jl_value_t *x, jl_value_t *y, jl_value_t **env,
             (jl_is_unionall(y) || jl_is_uniontype(y)) &&
             jl_egal(x, y))
             return 1;
+        // consult the thread-local memo table. subtyping of fully resolved
+        // type objects is purely structural, so a cached answer keyed on the
+        // pointer pair stays correct forever (the keys are GC roots).
+        if (!jl_has_free_typevars(x) && !jl_has_free_typevars(y)) {
+            ptls = jl_get_ptls_states();
+            slot = (uint32_t)(((uintptr_t)x >> 4) ^ ((uintptr_t)y >> 9)) & (N_SUBTYPE_CACHE - 1);
+            if (ptls->subtype_cache[slot].x == x && ptls->subtype_cache[slot].y == y) {
+                ptls->subtype_cache_hits++;
+                return ptls->subtype_cache[slot].result;
+            }
+            ptls->subtype_cache_misses++;
+        }
     }
     int obvious_subtype = 2;
     if (jl_obvious_subtype(x, y, &obvious_subtype)) {
 #ifdef NDEBUG
         if (obvious_subtype == 0)
-            return obvious_subtype;
+            return record_subtype(ptls, slot, x, y, obvious_subtype);
         else if (jl_has_free_typevars(y))
             obvious_subtype = 3;
         else if (envsz == 0)
-            return obvious_subtype;
+            return record_subtype(ptls, slot, x, y, obvious_subtype);
 #else
         if (jl_has_free_typevars(y))
             obvious_subtype = 3;
@@ -1405,7 +1492,7 @@ JL_DLLEXPORT int jl_subtype_env(jl_value_t *x, jl_value_t *y, jl_value_t **env,
     init_stenv(&e, env, envsz);
     int subtype = forall_exists_subtype(x, y, &e, 0);
     assert(obvious_subtype == 3 || obvious_subtype == subtype);
-    return subtype;
+    return record_subtype(ptls, slot, x, y, subtype);
 }
 
 static int subtype_in_env(jl_value_t *x, jl_value_t *y, jl_stenv_t *e)
@@ -1606,7 +1693,7 @@ static int try_subtype_in_env(jl_value_t *a, jl_value_t *b, jl_stenv_t *e)
     save_env(e, &root, &se);
     int ret = subtype_in_env(a, b, e);
     restore_env(e, root, &se);
-    free(se.buf);
+    free_env(&se);
     JL_GC_POP();
     return ret;
 }
@@ -1636,7 +1723,9 @@ static int subtype_in_env_existential(jl_value_t *x, jl_value_t *y, jl_stenv_t *
         len++;
         v = v->prev;
     }
-    int8_t *rs = (int8_t*)malloc(len);
+    arena_t *scratch = &jl_get_ptls_states()->scratch_arena;
+    arena_mark_t mark = arena_save(scratch);
+    int8_t *rs = (int8_t*)arena_alloc(scratch, len);
     int n = 0;
     v = e->vars;
     while (v != NULL) {
@@ -1650,7 +1739,7 @@ static int subtype_in_env_existential(jl_value_t *x, jl_value_t *y, jl_stenv_t *
         v->right = rs[n++];
         v = v->prev;
     }
-    free(rs);
+    arena_restore(scratch, mark);
     return issub;
 }
 
@@ -1746,7 +1835,7 @@ static jl_value_t *intersect_var(jl_tvar_t *b, jl_value_t *a, jl_stenv_t *e, int
         ii = (jl_value_t*)b;
         set_bound(&bb->ub, ub, b, e);
     }
-    free(se.buf);
+    free_env(&se);
     JL_GC_POP();
     return ii;
 }
@@ -2003,10 +2092,10 @@ static jl_value_t *intersect_unionall(jl_value_t *t, jl_unionall_t *u, jl_stenv_
             }
             if (res2 != jl_bottom_type)
                 res = res2;
-            free(se2.buf);
+            free_env(&se2);
         }
     }
-    free(se.buf);
+    free_env(&se);
     JL_GC_POP();
     return res;
 }
@@ -2217,7 +2306,7 @@ static jl_value_t *intersect_invariant(jl_value_t *x, jl_value_t *y, jl_stenv_t
         flip_vars(e);
     }
     restore_env(e, root, &se);
-    free(se.buf);
+    free_env(&se);
     JL_GC_POP();
     return ii;
 }
@@ -2377,7 +2466,7 @@ static jl_value_t *intersect(jl_value_t *x, jl_value_t *y, jl_stenv_t *e, int pa
                     }
                 }
             }
-            free(se.buf);
+            free_env(&se);
             if (!jl_has_free_typevars(a) && !jl_has_free_typevars(b)) {
                 if (jl_subtype(a, b))
                     res = b;
@@ -2490,12 +2579,12 @@ static jl_value_t *intersect_all(jl_value_t *x, jl_value_t *y, jl_stenv_t *e)
         restore_env(e, *saved, &se);
     }
     else {
-        free(se.buf);
+        free_env(&se);
         save_env(e, saved, &se);
     }
     while (e->Runions.more) {
         if (e->emptiness_only && ii != jl_bottom_type) {
-            free(se.buf);
+            free_env(&se);
             JL_GC_POP();
             return ii;
         }
@@ -2513,7 +2602,7 @@ static jl_value_t *intersect_all(jl_value_t *x, jl_value_t *y, jl_stenv_t *e)
             restore_env(e, *saved, &se);
         }
         else {
-            free(se.buf);
+            free_env(&se);
             save_env(e, saved, &se);
         }
         if (is[0] == jl_bottom_type)
@@ -2527,12 +2616,12 @@ static jl_value_t *intersect_all(jl_value_t *x, jl_value_t *y, jl_stenv_t *e)
         }
         total_iter++;
         if (niter > 3 || total_iter > 400000) {
-            free(se.buf);
+            free_env(&se);
             JL_GC_POP();
             return y;
         }
     }
-    free(se.buf);
+    free_env(&se);
     JL_GC_POP();
     return ii;
 }
@@ -2641,9 +2730,13 @@ jl_value_t *switch_union_tuple(jl_value_t *a, jl_value_t *b)
 // sets *issubty to 1 iff `a` is a subtype of `b`
 jl_value_t *jl_type_intersection_env_s(jl_value_t *a, jl_value_t *b, jl_svec_t **penv, int *issubty)
 {
+    if (__unlikely(type_query_log_on != 0) && !type_query_nested)
+        record_type_query("intersect", a, b);
+    type_query_nested++;
     if (issubty) *issubty = 0;
     if (obviously_disjoint(a, b, 0)) {
         if (issubty && a == jl_bottom_type) *issubty = 1;
+        type_query_nested--;
         return jl_bottom_type;
     }
     int szb = jl_subtype_env_size(b);
@@ -2717,6 +2810,7 @@ jl_value_t *jl_type_intersection_env_s(jl_value_t *a, jl_value_t *b, jl_svec_t *
             jl_svecset(e, i, env[i]);
     }
  bot:
+    type_query_nested--;
     JL_GC_POP();
     return *ans;
 }
@@ -2728,7 +2822,25 @@ jl_value_t *jl_type_intersection_env(jl_value_t *a, jl_value_t *b, jl_svec_t **p
 
 JL_DLLEXPORT jl_value_t *jl_type_intersection(jl_value_t *a, jl_value_t *b)
 {
-    return jl_type_intersection_env(a, b, NULL);
+    // method insertion and ambiguity checking intersect the same signature
+    // pairs over and over, so memoize closed pairs in a thread-local table.
+    // intersection of closed types is structural, so entries never need
+    // invalidation (world bumps included); the keys and results are GC roots.
+    jl_ptls_t ptls = NULL;
+    uint32_t slot = 0;
+    if (!jl_has_free_typevars(a) && !jl_has_free_typevars(b)) {
+        ptls = jl_get_ptls_states();
+        slot = (uint32_t)(((uintptr_t)a >> 4) ^ ((uintptr_t)b >> 9)) & (N_INTERSECT_CACHE - 1);
+        if (ptls->intersect_cache[slot].a == a && ptls->intersect_cache[slot].b == b)
+            return ptls->intersect_cache[slot].result;
+    }
+    jl_value_t *ti = jl_type_intersection_env(a, b, NULL);
+    if (ptls) {
+        ptls->intersect_cache[slot].result = ti;
+        ptls->intersect_cache[slot].a = a;
+        ptls->intersect_cache[slot].b = b;
+    }
+    return ti;
 }
 
 JL_DLLEXPORT jl_svec_t *jl_type_intersection_with_env(jl_value_t *a, jl_value_t *b)
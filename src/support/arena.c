@@ -0,0 +1,79 @@
+// This file is a part of Julia. License is MIT: https://julialang.org/license
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include "dtypes.h"
+#include "arena.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ARENA_BLOCK_SZ (16 * 1024)
+#define ARENA_ALIGN 16
+
+static arena_block_t *arena_new_block(arena_block_t *prev, size_t sz)
+{
+    if (sz < ARENA_BLOCK_SZ)
+        sz = ARENA_BLOCK_SZ;
+    arena_block_t *b = (arena_block_t*)LLT_ALLOC(sizeof(arena_block_t) + sz);
+    if (b == NULL)
+        return NULL;
+    b->prev = prev;
+    b->sz = sz;
+    b->used = 0;
+    return b;
+}
+
+arena_t *arena_new(arena_t *a)
+{
+    a->top = NULL;
+    return a;
+}
+
+void *arena_alloc(arena_t *a, size_t sz)
+{
+    sz = (sz + (ARENA_ALIGN - 1)) & ~(size_t)(ARENA_ALIGN - 1);
+    arena_block_t *b = a->top;
+    if (b == NULL || b->sz - b->used < sz) {
+        b = arena_new_block(b, sz);
+        if (b == NULL)
+            return NULL;
+        a->top = b;
+    }
+    void *p = (char*)(b + 1) + b->used;
+    b->used += sz;
+    return p;
+}
+
+arena_mark_t arena_save(arena_t *a)
+{
+    arena_mark_t mark = { a->top, a->top ? a->top->used : 0 };
+    return mark;
+}
+
+void arena_restore(arena_t *a, arena_mark_t mark)
+{
+    arena_block_t *b = a->top;
+    while (b != mark.block) {
+        assert(b); // mark must come from this arena
+        arena_block_t *prev = b->prev;
+        LLT_FREE(b);
+        b = prev;
+    }
+    a->top = b;
+    if (b)
+        b->used = mark.used;
+}
+
+void arena_free(arena_t *a)
+{
+    arena_mark_t mark = { NULL, 0 };
+    arena_restore(a, mark);
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,43 @@
+// This file is a part of Julia. License is MIT: https://julialang.org/license
+
+#ifndef JL_ARENA_H
+#define JL_ARENA_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "analyzer_annotations.h"
+
+// Pointer-bump allocator for short-lived scratch buffers. Allocation is a
+// bump of the top block's offset; individual buffers are never freed.
+// Instead the caller records a mark before a group of allocations and
+// releases all of them at once by restoring the mark (LIFO discipline).
+
+typedef struct _arena_block_t {
+    struct _arena_block_t *prev;
+    size_t sz;   // usable bytes in this block
+    size_t used; // bytes handed out from this block
+    // the block data follows the header
+} arena_block_t;
+
+typedef struct {
+    arena_block_t *top;
+} arena_t;
+
+typedef struct {
+    arena_block_t *block;
+    size_t used;
+} arena_mark_t;
+
+arena_t *arena_new(arena_t *a) JL_NOTSAFEPOINT;
+void *arena_alloc(arena_t *a, size_t sz) JL_NOTSAFEPOINT;
+arena_mark_t arena_save(arena_t *a) JL_NOTSAFEPOINT;
+void arena_restore(arena_t *a, arena_mark_t mark) JL_NOTSAFEPOINT;
+void arena_free(arena_t *a) JL_NOTSAFEPOINT;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -37,33 +37,66 @@ void arraylist_free(arraylist_t *a)
     a->items = &a->_space[0];
 }
 
+// ensure capacity for at least max elements without changing len
+void arraylist_reserve(arraylist_t *a, size_t max)
+{
+    if (max <= a->max)
+        return;
+    size_t nm = a->max * 2;
+    if (nm == 0)
+        nm = 1;
+    while (max > nm)
+        nm *= 2;
+    if (a->items == &a->_space[0]) {
+        void **p = (void**)LLT_ALLOC(nm * sizeof(void*));
+        if (p == NULL) return;
+        memcpy(p, a->items, a->len * sizeof(void*));
+        a->items = p;
+    }
+    else {
+        void **p = (void**)LLT_REALLOC(a->items, nm * sizeof(void*));
+        if (p == NULL) return;
+        a->items = p;
+    }
+    a->max = nm;
+}
+
 void arraylist_grow(arraylist_t *a, size_t n)
 {
-    size_t len = a->len;
-    size_t newlen = len + n;
+    size_t newlen = a->len + n;
+    if (newlen > a->max) {
+        arraylist_reserve(a, newlen);
+        if (newlen > a->max) return;
+    }
+    a->len = newlen;
+}
+
+void arraylist_grow_arena(arraylist_t *a, size_t n, arena_t *ar)
+{
+    size_t newlen = a->len + n;
     if (newlen > a->max) {
-        if (a->items == &a->_space[0]) {
-            void **p = (void**)LLT_ALLOC((a->len+n)*sizeof(void*));
-            if (p == NULL) return;
-            memcpy(p, a->items, len * sizeof(void*));
-            a->items = p;
-            a->max = newlen;
-        }
-        else {
-            size_t nm = a->max * 2;
-            if (nm == 0)
-                nm = 1;
-            while (newlen > nm)
-                nm *= 2;
-            void **p = (void**)LLT_REALLOC(a->items, nm * sizeof(void*));
-            if (p == NULL) return;
-            a->items = p;
-            a->max = nm;
-        }
+        size_t nm = a->max * 2;
+        if (nm == 0)
+            nm = 1;
+        while (newlen > nm)
+            nm *= 2;
+        void **p = (void**)arena_alloc(ar, nm * sizeof(void*));
+        if (p == NULL) return;
+        memcpy(p, a->items, a->len * sizeof(void*));
+        // the outgrown block stays in the arena until the owner releases
+        // the whole arena (or restores a mark preceding this list)
+        a->items = p;
+        a->max = nm;
     }
     a->len = newlen;
 }
 
+void arraylist_push_arena(arraylist_t *a, void *elt, arena_t *ar)
+{
+    arraylist_grow_arena(a, 1, ar);
+    a->items[a->len - 1] = elt;
+}
+
 void arraylist_push(arraylist_t *a, void *elt)
 {
     arraylist_grow(a, 1);
@@ -10,6 +10,7 @@ extern "C" {
 #endif
 
 #include "analyzer_annotations.h"
+#include "arena.h"
 
 typedef struct {
     size_t len;
@@ -24,6 +25,14 @@ void arraylist_free(arraylist_t *a);
 void arraylist_push(arraylist_t *a, void *elt) JL_NOTSAFEPOINT;
 void *arraylist_pop(arraylist_t *a);
 void arraylist_grow(arraylist_t *a, size_t n);
+void arraylist_reserve(arraylist_t *a, size_t max) JL_NOTSAFEPOINT;
+
+// arena-backed growth: the backing store is bumped off a caller-provided
+// arena instead of malloc, so pushes never allocate during a collection.
+// Lists grown this way must not be passed to arraylist_free; their storage
+// is reclaimed wholesale with the arena.
+void arraylist_grow_arena(arraylist_t *a, size_t n, arena_t *ar) JL_NOTSAFEPOINT;
+void arraylist_push_arena(arraylist_t *a, void *elt, arena_t *ar) JL_NOTSAFEPOINT;
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,336 @@
+// This file is a part of Julia. License is MIT: https://julialang.org/license
+
+/*
+  libsupport microbenchmarks.
+
+  Build and run with `make -C src/support bench`. Each benchmark times one
+  primitive over a representative input distribution and prints one
+  tab-separated line per result:
+
+      <name> <TAB> <ns/op> <TAB> <ops/run>
+
+  Typical workflow:
+
+      make -C src/support bench BENCH_ARGS="-o bench-baseline.tsv"
+      ... make changes ...
+      make -C src/support bench BENCH_ARGS="-c bench-baseline.tsv"
+
+  `-o FILE` additionally writes the results to FILE; `-c FILE` compares
+  against a stored baseline, prints the per-benchmark delta, and exits
+  nonzero if anything regressed by more than BENCH_TOLERANCE (default 15%,
+  override with `-t <percent>`). Results are medians of BENCH_REPS runs to
+  keep scheduler noise out of the comparison.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "dtypes.h"
+
+#ifdef _OS_WINDOWS_
+#include <process.h>
+#include <io.h>
+#define getpid _getpid
+#define unlink _unlink
+#else
+#include <unistd.h>
+#endif
+
+#include "timefuncs.h"
+#include "hashing.h"
+#include "htable.h"
+#include "ptrhash.h"
+#include "utf8.h"
+#include "ios.h"
+#include "arraylist.h"
+
+#define BENCH_REPS 5
+#define MAX_RESULTS 64
+
+typedef struct {
+    char name[64];
+    double ns_per_op;
+    double nops;
+} bench_result_t;
+
+static bench_result_t results[MAX_RESULTS];
+static int nresults = 0;
+
+// defeat dead-code elimination without perturbing the loop
+static volatile uint64_t bench_sink;
+
+static uint64_t rng_state = 0x853c49e6748fea9bULL;
+static uint64_t bench_rng(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static int cmp_double(const void *a, const void *b)
+{
+    double x = *(const double*)a, y = *(const double*)b;
+    return x < y ? -1 : x > y;
+}
+
+static void report(const char *name, double *reps, double nops)
+{
+    qsort(reps, BENCH_REPS, sizeof(double), cmp_double);
+    double med = reps[BENCH_REPS / 2];
+    bench_result_t *r = &results[nresults++];
+    snprintf(r->name, sizeof(r->name), "%s", name);
+    r->ns_per_op = med / nops * 1e9;
+    r->nops = nops;
+}
+
+#define BENCH(name, nops, setup, body)                                  \
+    do {                                                                \
+        double reps_[BENCH_REPS];                                       \
+        for (int rep_ = 0; rep_ < BENCH_REPS; rep_++) {                 \
+            setup;                                                      \
+            double t0_ = jl_clock_now();                                \
+            body;                                                       \
+            reps_[rep_] = jl_clock_now() - t0_;                         \
+        }                                                               \
+        report(name, reps_, (double)(nops));                            \
+    } while (0)
+
+// -- htable ------------------------------------------------------------
+
+#define HT_N (1 << 20)
+
+static void bench_htable(void)
+{
+    htable_t h;
+    htable_new(&h, 0);
+    for (uintptr_t i = 0; i < HT_N; i++)
+        ptrhash_put(&h, (void*)(i * 64 + 16), (void*)(i + 1));
+
+    BENCH("htable/hit", HT_N, rng_state = 1, {
+        for (int i = 0; i < HT_N; i++) {
+            uintptr_t k = (bench_rng() % HT_N) * 64 + 16;
+            bench_sink += (uintptr_t)ptrhash_get(&h, (void*)k);
+        }
+    });
+    BENCH("htable/miss", HT_N, rng_state = 2, {
+        for (int i = 0; i < HT_N; i++) {
+            uintptr_t k = (HT_N + bench_rng() % HT_N) * 64 + 16;
+            bench_sink += (uintptr_t)ptrhash_get(&h, (void*)k);
+        }
+    });
+    htable_free(&h);
+    BENCH("htable/insert", HT_N, htable_new(&h, 0), {
+        for (uintptr_t i = 0; i < HT_N; i++)
+            ptrhash_put(&h, (void*)(i * 64 + 16), (void*)(i + 1));
+        htable_free(&h);
+    });
+}
+
+// -- memhash -----------------------------------------------------------
+
+static void bench_memhash(void)
+{
+    static char buf[65536];
+    for (size_t i = 0; i < sizeof(buf); i++)
+        buf[i] = (char)(i * 31);
+    static const size_t sizes[] = {8, 16, 64, 1024, 65536};
+    char name[64];
+    for (int s = 0; s < 5; s++) {
+        size_t n = sizes[s];
+        long iters = (long)(1e9 / (n + 30));
+        snprintf(name, sizeof(name), "memhash/%zub", n);
+        BENCH(name, iters, (void)0, {
+            for (long i = 0; i < iters; i++) {
+                buf[0] = (char)i;
+                bench_sink += memhash(buf, n);
+            }
+        });
+    }
+}
+
+// -- utf8 --------------------------------------------------------------
+
+static void bench_utf8(void)
+{
+    static char ascii[65536], multi[65536];
+    memset(ascii, 'a', sizeof(ascii));
+    for (size_t i = 0; i < sizeof(multi); i += 4) {
+        // U+1F600, dense 4-byte sequences
+        multi[i] = (char)0xf0;
+        multi[i+1] = (char)0x9f;
+        multi[i+2] = (char)0x98;
+        multi[i+3] = (char)0x80;
+    }
+    BENCH("utf8/isvalid-ascii", 2000, (void)0, {
+        for (int i = 0; i < 2000; i++)
+            bench_sink += (uint64_t)u8_isvalid(ascii, sizeof(ascii));
+    });
+    BENCH("utf8/isvalid-multi", 2000, (void)0, {
+        for (int i = 0; i < 2000; i++)
+            bench_sink += (uint64_t)u8_isvalid(multi, sizeof(multi));
+    });
+    BENCH("utf8/charnum", 2000, (void)0, {
+        for (int i = 0; i < 2000; i++)
+            bench_sink += u8_charnum(multi, sizeof(multi));
+    });
+}
+
+// -- ios ---------------------------------------------------------------
+
+#define IOS_FILE_SZ (16 * 1024 * 1024)
+
+static void bench_ios(void)
+{
+    char path[256];
+    snprintf(path, sizeof(path), "%s/libsupport-bench-%d.tmp",
+             getenv("TMPDIR") ? getenv("TMPDIR") : "/tmp", (int)getpid());
+    ios_t s;
+    ios_file(&s, path, 1, 1, 1, 1);
+    static char chunk[4096];
+    rng_state = 3;
+    for (size_t i = 0; i < sizeof(chunk); i++) {
+        chunk[i] = (char)('a' + bench_rng() % 26);
+        if (bench_rng() % 40 == 0)
+            chunk[i] = '\n';
+    }
+    for (int i = 0; i < IOS_FILE_SZ / (int)sizeof(chunk); i++)
+        ios_write(&s, chunk, sizeof(chunk));
+    ios_close(&s);
+
+    static char rdbuf[4096];
+    BENCH("ios/read-4kb", IOS_FILE_SZ / 4096, ios_file(&s, path, 1, 0, 0, 0), {
+        size_t n;
+        while ((n = ios_read(&s, rdbuf, sizeof(rdbuf))) > 0)
+            bench_sink += n;
+        ios_close(&s);
+    });
+    BENCH("ios/read-64b", IOS_FILE_SZ / 64, ios_file(&s, path, 1, 0, 0, 0), {
+        size_t n;
+        while ((n = ios_read(&s, rdbuf, 64)) > 0)
+            bench_sink += n;
+        ios_close(&s);
+    });
+    // ~40-byte lines: ops is an estimate, ns/op is per line either way
+    BENCH("ios/spanuntil", IOS_FILE_SZ / 40, ios_file(&s, path, 1, 0, 0, 0), {
+        size_t n;
+        const char *p;
+        while ((p = ios_spanuntil(&s, '\n', &n)) != NULL)
+            bench_sink += (uint64_t)n;
+        ios_close(&s);
+    });
+    unlink(path);
+}
+
+// -- arraylist ---------------------------------------------------------
+
+static void bench_arraylist(void)
+{
+    arraylist_t a;
+    BENCH("arraylist/push-1m", 1 << 20, (void)0, {
+        arraylist_new(&a, 0);
+        for (uintptr_t i = 0; i < (1 << 20); i++)
+            arraylist_push(&a, (void*)i);
+        bench_sink += a.len;
+        arraylist_free(&a);
+    });
+    BENCH("arraylist/push-reserved", 1 << 20, (void)0, {
+        arraylist_new(&a, 0);
+        arraylist_reserve(&a, 1 << 20);
+        for (uintptr_t i = 0; i < (1 << 20); i++)
+            arraylist_push(&a, (void*)i);
+        bench_sink += a.len;
+        arraylist_free(&a);
+    });
+}
+
+// -- driver ------------------------------------------------------------
+
+static int load_baseline(const char *file, bench_result_t *base, int maxn)
+{
+    FILE *f = fopen(file, "r");
+    int n = 0;
+    char line[256];
+    if (f == NULL) {
+        fprintf(stderr, "bench: cannot open baseline %s\n", file);
+        exit(2);
+    }
+    while (n < maxn && fgets(line, sizeof(line), f)) {
+        if (sscanf(line, "%63s\t%lf\t%lf", base[n].name,
+                   &base[n].ns_per_op, &base[n].nops) >= 2)
+            n++;
+    }
+    fclose(f);
+    return n;
+}
+
+int main(int argc, char **argv)
+{
+    const char *outfile = NULL, *basefile = NULL;
+    double tol = 15.0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+            outfile = argv[++i];
+        else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc)
+            basefile = argv[++i];
+        else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+            tol = atof(argv[++i]);
+        else {
+            fprintf(stderr,
+                    "usage: %s [-o results.tsv] [-c baseline.tsv] [-t pct]\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+
+    bench_htable();
+    bench_memhash();
+    bench_utf8();
+    bench_ios();
+    bench_arraylist();
+
+    for (int i = 0; i < nresults; i++)
+        printf("%s\t%.2f\t%.0f\n", results[i].name, results[i].ns_per_op,
+               results[i].nops);
+
+    if (outfile) {
+        FILE *f = fopen(outfile, "w");
+        if (f == NULL) {
+            fprintf(stderr, "bench: cannot write %s\n", outfile);
+            return 2;
+        }
+        for (int i = 0; i < nresults; i++)
+            fprintf(f, "%s\t%.2f\t%.0f\n", results[i].name,
+                    results[i].ns_per_op, results[i].nops);
+        fclose(f);
+    }
+
+    if (basefile) {
+        bench_result_t base[MAX_RESULTS];
+        int nbase = load_baseline(basefile, base, MAX_RESULTS);
+        int regressed = 0;
+        printf("\n%-24s %12s %12s %8s\n", "benchmark", "baseline", "current",
+               "delta");
+        for (int i = 0; i < nresults; i++) {
+            int j;
+            for (j = 0; j < nbase; j++)
+                if (strcmp(base[j].name, results[i].name) == 0)
+                    break;
+            if (j == nbase) {
+                printf("%-24s %12s %12.2f %8s\n", results[i].name, "-",
+                       results[i].ns_per_op, "new");
+                continue;
+            }
+            double pct = (results[i].ns_per_op / base[j].ns_per_op - 1.0) * 100;
+            printf("%-24s %12.2f %12.2f %+7.1f%%%s\n", results[i].name,
+                   base[j].ns_per_op, results[i].ns_per_op, pct,
+                   pct > tol ? "  REGRESSION" : "");
+            if (pct > tol)
+                regressed = 1;
+        }
+        return regressed;
+    }
+    return 0;
+}
@@ -56,6 +56,151 @@ uint32_t bitvector_get(uint32_t *b, uint64_t n)
     return b[n>>5] & (1<<(n&31));
 }
 
+// range kernels: the partial words at the edges are handled with masks and
+// the interior runs a full-word loop (which compilers can vectorize).
+
+// mask of the low n bits, 0 < n <= 32
+#define lomask(n) (0xffffffffu >> (32-(n)))
+
+STATIC_INLINE uint32_t count_bits(uint32_t w)
+{
+#ifdef _COMPILER_MICROSOFT_
+    w = w - ((w>>1)&0x55555555);
+    w = (w&0x33333333) + ((w>>2)&0x33333333);
+    w = (w + (w>>4)) & 0x0f0f0f0f;
+    return (w*0x01010101) >> 24;
+#else
+    return __builtin_popcount(w);
+#endif
+}
+
+uint64_t bitvector_count(const uint32_t *b, uint64_t offs, uint64_t nbits)
+{
+    if (nbits == 0) return 0;
+    b += offs>>5;
+    offs &= 31;
+    uint64_t cnt = 0;
+    if (offs) {
+        uint64_t head = 32 - offs;
+        if (head > nbits) head = nbits;
+        cnt += count_bits((*b++ >> offs) & lomask(head));
+        nbits -= head;
+    }
+    while (nbits >= 32) {
+        cnt += count_bits(*b++);
+        nbits -= 32;
+    }
+    if (nbits)
+        cnt += count_bits(*b & lomask(nbits));
+    return cnt;
+}
+
+uint32_t bitvector_any1(const uint32_t *b, uint64_t offs, uint64_t nbits)
+{
+    if (nbits == 0) return 0;
+    b += offs>>5;
+    offs &= 31;
+    if (offs) {
+        uint64_t head = 32 - offs;
+        if (head > nbits) head = nbits;
+        if ((*b++ >> offs) & lomask(head)) return 1;
+        nbits -= head;
+    }
+    while (nbits >= 32) {
+        if (*b++) return 1;
+        nbits -= 32;
+    }
+    if (nbits && (*b & lomask(nbits)))
+        return 1;
+    return 0;
+}
+
+uint32_t bitvector_all1(const uint32_t *b, uint64_t offs, uint64_t nbits)
+{
+    if (nbits == 0) return 1;
+    b += offs>>5;
+    offs &= 31;
+    if (offs) {
+        uint64_t head = 32 - offs;
+        if (head > nbits) head = nbits;
+        uint32_t m = lomask(head) << offs;
+        if ((*b++ & m) != m) return 0;
+        nbits -= head;
+    }
+    while (nbits >= 32) {
+        if (*b++ != 0xffffffffu) return 0;
+        nbits -= 32;
+    }
+    if (nbits && (*b & lomask(nbits)) != lomask(nbits))
+        return 0;
+    return 1;
+}
+
+void bitvector_fill(uint32_t *b, uint64_t offs, uint64_t nbits, uint32_t c)
+{
+    if (nbits == 0) return;
+    b += offs>>5;
+    offs &= 31;
+    if (offs) {
+        uint64_t head = 32 - offs;
+        if (head > nbits) head = nbits;
+        uint32_t m = lomask(head) << offs;
+        if (c)
+            *b++ |= m;
+        else
+            *b++ &= ~m;
+        nbits -= head;
+    }
+    if (nbits >= 32) {
+        memset(b, c ? 0xff : 0, (nbits>>5) * sizeof(uint32_t));
+        b += nbits>>5;
+        nbits &= 31;
+    }
+    if (nbits) {
+        if (c)
+            *b |= lomask(nbits);
+        else
+            *b &= ~lomask(nbits);
+    }
+}
+
+// dest, a, and b all start at bit offset 0; bits of dest past nbits are kept
+void bitvector_copy(uint32_t *dest, const uint32_t *a, uint64_t nbits)
+{
+    memcpy(dest, a, (nbits>>5) * sizeof(uint32_t));
+    if (nbits & 31) {
+        uint32_t m = lomask(nbits & 31);
+        size_t i = nbits>>5;
+        dest[i] = (dest[i] & ~m) | (a[i] & m);
+    }
+}
+
+void bitvector_and(uint32_t *dest, const uint32_t *a, const uint32_t *b,
+                   uint64_t nbits)
+{
+    size_t i, nw = nbits>>5;
+    for (i = 0; i < nw; i++)
+        dest[i] = a[i] & b[i];
+    if (nbits & 31) {
+        uint32_t m = lomask(nbits & 31);
+        dest[nw] = (dest[nw] & ~m) | (a[nw] & b[nw] & m);
+    }
+}
+
+void bitvector_or(uint32_t *dest, const uint32_t *a, const uint32_t *b,
+                  uint64_t nbits)
+{
+    size_t i, nw = nbits>>5;
+    for (i = 0; i < nw; i++)
+        dest[i] = a[i] | b[i];
+    if (nbits & 31) {
+        uint32_t m = lomask(nbits & 31);
+        dest[nw] = (dest[nw] & ~m) | ((a[nw] | b[nw]) & m);
+    }
+}
+
+#undef lomask
+
 #ifdef __cplusplus
 }
 #endif
@@ -15,6 +15,18 @@ size_t bitvector_nwords(uint64_t nbits);
 JL_DLLEXPORT void bitvector_set(uint32_t *b, uint64_t n, uint32_t c);
 JL_DLLEXPORT uint32_t bitvector_get(uint32_t *b, uint64_t n);
 
+// word-at-a-time kernels over the bit range [offs, offs+nbits)
+uint64_t bitvector_count(const uint32_t *b, uint64_t offs, uint64_t nbits);
+uint32_t bitvector_any1(const uint32_t *b, uint64_t offs, uint64_t nbits);
+uint32_t bitvector_all1(const uint32_t *b, uint64_t offs, uint64_t nbits);
+void bitvector_fill(uint32_t *b, uint64_t offs, uint64_t nbits, uint32_t c);
+// these operate from bit offset 0; bits of dest past nbits are preserved
+void bitvector_copy(uint32_t *dest, const uint32_t *a, uint64_t nbits);
+void bitvector_and(uint32_t *dest, const uint32_t *a, const uint32_t *b,
+                   uint64_t nbits);
+void bitvector_or(uint32_t *dest, const uint32_t *a, const uint32_t *b,
+                  uint64_t nbits);
+
 #ifdef __cplusplus
 }
 #endif
@@ -10,6 +10,10 @@
 #include "timefuncs.h"
 #include "ios.h"
 
+#if defined(_COMPILER_MICROSOFT_) && defined(_P64)
+#include <intrin.h> // _umul128
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -48,50 +52,122 @@ uint32_t int64to32hash(uint64_t key)
     return (uint32_t)key;
 }
 
-#include "MurmurHash3.c"
-
 #define _MHASH_SEED_ 0xcafe8881
 
-uint64_t memhash(const char *buf, size_t n)
-{
-    uint64_t out[2];
+/*
+  memhash: a wyhash/xxh3-class mixer built on folded 64x64->128-bit
+  multiplies. Short keys (the common case for Dict{String} and symbol
+  interning) take a branch-light path with two overlapping reads and a
+  single final mix; longer inputs run three independent 16-byte lanes so
+  the multiplies pipeline. This replaced MurmurHash3, which paid its
+  16-byte round setup even for tiny keys. The output is an internal
+  value only -- it is not stable across processes or versions.
+*/
 
-    // TODO: expose 128-bit hash
-#ifdef _P64
-    MurmurHash3_x64_128(buf, n, _MHASH_SEED_, out);
+// fold a 64x64->128-bit multiply back to 64 bits
+STATIC_INLINE uint64_t hash_mix(uint64_t a, uint64_t b) JL_NOTSAFEPOINT
+{
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 p = (unsigned __int128)a * b;
+    return (uint64_t)p ^ (uint64_t)(p >> 64);
+#elif defined(_COMPILER_MICROSOFT_) && defined(_P64)
+    uint64_t hi;
+    uint64_t lo = _umul128(a, b, &hi);
+    return lo ^ hi;
 #else
-    MurmurHash3_x86_128(buf, n, _MHASH_SEED_, out);
+    // portable long multiplication for 32-bit targets
+    uint64_t la = (uint32_t)a, ha = a >> 32;
+    uint64_t lb = (uint32_t)b, hb = b >> 32;
+    uint64_t ll = la * lb, lh = la * hb, hl = ha * lb, hh = ha * hb;
+    uint64_t cross = (ll >> 32) + (uint32_t)lh + (uint32_t)hl;
+    uint64_t hi = hh + (lh >> 32) + (hl >> 32) + (cross >> 32);
+    uint64_t lo = (cross << 32) | (uint32_t)ll;
+    return lo ^ hi;
 #endif
-    return out[1];
 }
 
-uint64_t memhash_seed(const char *buf, size_t n, uint32_t seed)
+// odd 64-bit constants with balanced bit patterns (from xxHash)
+#define HASH_SECRET0 0x9e3779b185ebca87ull
+#define HASH_SECRET1 0xc2b2ae3d27d4eb4full
+#define HASH_SECRET2 0x165667b19e3779f9ull
+#define HASH_SECRET3 0x27d4eb2f165667c5ull
+
+STATIC_INLINE uint64_t memhash64_seed(const char *buf, size_t n,
+                                      uint64_t seed) JL_NOTSAFEPOINT
 {
-    uint64_t out[2];
+    const char *p = buf;
+    uint64_t a, b;
+    seed ^= hash_mix(seed ^ HASH_SECRET0, HASH_SECRET1);
+    if (__likely(n <= 16)) {
+        if (__likely(n >= 4)) {
+            // two possibly-overlapping reads at each end cover 4..16 bytes
+            size_t shift = (n >> 3) << 2; // 4 iff n >= 8
+            a = ((uint64_t)jl_load_unaligned_i32(p) << 32) |
+                jl_load_unaligned_i32(p + shift);
+            b = ((uint64_t)jl_load_unaligned_i32(p + n - 4) << 32) |
+                jl_load_unaligned_i32(p + n - 4 - shift);
+        }
+        else if (__likely(n > 0)) {
+            a = ((uint64_t)(unsigned char)p[0] << 16) |
+                ((uint64_t)(unsigned char)p[n >> 1] << 8) |
+                (unsigned char)p[n - 1];
+            b = 0;
+        }
+        else {
+            a = b = 0;
+        }
+    }
+    else {
+        size_t i = n;
+        if (__unlikely(i > 48)) {
+            uint64_t s1 = seed, s2 = seed;
+            do {
+                seed = hash_mix(jl_load_unaligned_i64(p) ^ HASH_SECRET1,
+                                jl_load_unaligned_i64(p + 8) ^ seed);
+                s1 = hash_mix(jl_load_unaligned_i64(p + 16) ^ HASH_SECRET2,
+                              jl_load_unaligned_i64(p + 24) ^ s1);
+                s2 = hash_mix(jl_load_unaligned_i64(p + 32) ^ HASH_SECRET3,
+                              jl_load_unaligned_i64(p + 40) ^ s2);
+                p += 48;
+                i -= 48;
+            } while (__likely(i > 48));
+            seed ^= s1 ^ s2;
+        }
+        while (__unlikely(i > 16)) {
+            seed = hash_mix(jl_load_unaligned_i64(p) ^ HASH_SECRET1,
+                            jl_load_unaligned_i64(p + 8) ^ seed);
+            p += 16;
+            i -= 16;
+        }
+        // last 16 bytes, re-reading up to 15 already-hashed ones
+        a = jl_load_unaligned_i64(p + i - 16);
+        b = jl_load_unaligned_i64(p + i - 8);
+    }
+    // mix in the length so strings sharing a prefix or suffix differ
+    return hash_mix(HASH_SECRET1 ^ n ^ hash_mix(a ^ HASH_SECRET1, b ^ seed),
+                    HASH_SECRET0);
+}
 
-    // TODO: expose 128-bit hash
-#ifdef _P64
-    MurmurHash3_x64_128(buf, n, seed, out);
-#else
-    MurmurHash3_x86_128(buf, n, seed, out);
-#endif
-    return out[1];
+uint64_t memhash(const char *buf, size_t n)
+{
+    return memhash64_seed(buf, n, _MHASH_SEED_);
 }
 
-uint32_t memhash32(const char *buf, size_t n)
+uint64_t memhash_seed(const char *buf, size_t n, uint32_t seed)
 {
-    uint32_t out;
+    return memhash64_seed(buf, n, seed);
+}
 
-    MurmurHash3_x86_32(buf, n, _MHASH_SEED_, &out);
-    return out;
+uint32_t memhash32(const char *buf, size_t n)
+{
+    uint64_t h = memhash64_seed(buf, n, _MHASH_SEED_);
+    return (uint32_t)h ^ (uint32_t)(h >> 32);
 }
 
 uint32_t memhash32_seed(const char *buf, size_t n, uint32_t seed)
 {
-    uint32_t out;
-
-    MurmurHash3_x86_32(buf, n, seed, &out);
-    return out;
+    uint64_t h = memhash64_seed(buf, n, seed);
+    return (uint32_t)h ^ (uint32_t)(h >> 32);
 }
 
 #ifdef __cplusplus
@@ -23,6 +23,7 @@ htable_t *htable_new(htable_t *h, size_t size)
     if (size <= HT_N_INLINE / 2) {
         h->size = size = HT_N_INLINE;
         h->table = &h->_space[0];
+        h->meta = &h->_metaspace[0];
     }
     else {
         size = next_power_of_two(size);
@@ -30,19 +31,29 @@ htable_t *htable_new(htable_t *h, size_t size)
         size *= 2;  // aim for 50% occupancy
         h->size = size;
         h->table = (void**)LLT_ALLOC(size * sizeof(void*));
+        if (h->table == NULL)
+            return NULL;
+        h->meta = (uint8_t*)LLT_ALLOC(size / 2 + HT_GROUP - 1);
+        if (h->meta == NULL) {
+            LLT_FREE(h->table);
+            h->table = NULL;
+            return NULL;
+        }
     }
-    if (h->table == NULL)
-        return NULL;
     size_t i;
     for (i = 0; i < size; i++)
         h->table[i] = HT_NOTFOUND;
+    memset(h->meta, HT_M_EMPTY, size / 2 + HT_GROUP - 1);
+    h->nused = 0;
     return h;
 }
 
 void htable_free(htable_t *h)
 {
-    if (h->table != &h->_space[0])
+    if (h->table != &h->_space[0]) {
         LLT_FREE(h->table);
+        LLT_FREE(h->meta);
+    }
 }
 
 // empty and reduce size
@@ -50,7 +61,7 @@ void htable_reset(htable_t *h, size_t sz)
 {
     sz = next_power_of_two(sz);
     if (h->size > sz * 4 && h->size > HT_N_INLINE) {
-        LLT_FREE(h->table);
+        htable_free(h);
         h->table = NULL;
         if (htable_new(h, sz) == NULL)
             htable_new(h, 0);
@@ -59,6 +70,8 @@ void htable_reset(htable_t *h, size_t sz)
         size_t i, hsz = h->size;
         for (i = 0; i < hsz; i++)
             h->table[i] = HT_NOTFOUND;
+        memset(h->meta, HT_M_EMPTY, hsz / 2 + HT_GROUP - 1);
+        h->nused = 0;
     }
 }
 
@@ -3,8 +3,17 @@
 #ifndef JL_HTABLE_H
 #define JL_HTABLE_H
 
+#include <stdint.h>
+
 #define HT_N_INLINE 32
 
+// group-probing parameters: one control byte per key/value pair holds the
+// low 7 bits of the key's hash (or HT_M_EMPTY), and probes scan HT_GROUP
+// bytes at a time. The meta array carries HT_GROUP-1 extra bytes mirroring
+// its start so group loads never have to wrap.
+#define HT_GROUP 8
+#define HT_M_EMPTY 0x80
+
 #include "analyzer_annotations.h"
 
 #ifdef __cplusplus
@@ -12,9 +21,12 @@ extern "C" {
 #endif
 
 typedef struct {
-    size_t size;
+    size_t size;    // number of slots (2 per key/value pair)
+    size_t nused;   // pairs ever claimed; cleared only by rehash/reset
     void **table;
+    uint8_t *meta;
     void *_space[HT_N_INLINE];
+    uint8_t _metaspace[HT_N_INLINE / 2 + HT_GROUP - 1];
 } htable_t;
 
 // define this to be an invalid key/value
@@ -8,12 +8,54 @@
 extern "C" {
 #endif
 
+static const char digit_pairs[201] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
 char *uint2str(char *dest, size_t len, uint64_t num, uint32_t base)
 {
     int i = len-1;
     uint64_t b = (uint64_t)base;
     char ch;
     dest[i--] = '\0';
+    if (base == 10) {
+        // one divide and one table lookup per two digits
+        while (num >= 100 && i >= 1) {
+            uint64_t q = num / 100;
+            unsigned r = (unsigned)(num - q * 100) * 2;
+            dest[i--] = digit_pairs[r + 1];
+            dest[i--] = digit_pairs[r];
+            num = q;
+        }
+        while (i >= 0) {
+            dest[i--] = (char)('0' + num % 10);
+            num /= 10;
+            if (num == 0)
+                break;
+        }
+        return &dest[i+1];
+    }
+    if ((base & (base - 1)) == 0) {
+        // power-of-two base: shift and mask instead of dividing
+        uint32_t shift = 0;
+        while ((base >> shift) > 1)
+            shift++;
+        while (i >= 0) {
+            ch = (char)(num & (b - 1));
+            if (ch < 10)
+                ch += '0';
+            else
+                ch = ch-10+'a';
+            dest[i--] = ch;
+            num >>= shift;
+            if (num == 0)
+                break;
+        }
+        return &dest[i+1];
+    }
     while (i >= 0) {
         ch = (char)(num % b);
         if (ch < 10)
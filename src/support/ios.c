@@ -22,6 +22,8 @@
 #include <sys/time.h>
 #include <sys/select.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
+#include <sys/mman.h>
 #include <fcntl.h>
 #endif
 
@@ -178,6 +180,72 @@ int _os_write_all(long fd, const void *buf, size_t n, size_t *nwritten)
     return 0;
 }
 
+// number of iovec entries passed to writev() per call
+#define IOS_IOV_MAX 16
+
+static int _os_writev_all(long fd, const ios_iovec_t *iov, int iovcnt,
+                          size_t *nwritten)
+{
+    *nwritten = 0;
+#ifdef _OS_WINDOWS_
+    // no scatter-gather write, fall back to one write per buffer
+    for (int i = 0; i < iovcnt; i++) {
+        size_t wrote;
+        int err = _os_write_all(fd, iov[i].data, iov[i].len, &wrote);
+        *nwritten += wrote;
+        if (err)
+            return err;
+    }
+    return 0;
+#else
+    int i = 0;
+    size_t skip = 0; // bytes of iov[i] already written
+    while (i < iovcnt) {
+        if (iov[i].len - skip == 0) {
+            i++;
+            skip = 0;
+            continue;
+        }
+        // ios_iovec_t has the layout of struct iovec, but re-batching here
+        // anyway keeps the partial-write bookkeeping in one place
+        struct iovec vec[IOS_IOV_MAX];
+        int nvec = 0;
+        for (int j = i; j < iovcnt && nvec < IOS_IOV_MAX; j++) {
+            size_t off = (j == i) ? skip : 0;
+            if (iov[j].len == off)
+                continue;
+            vec[nvec].iov_base = (char*)iov[j].data + off;
+            vec[nvec].iov_len = iov[j].len - off;
+            nvec++;
+        }
+        ssize_t r;
+        while (1) {
+            r = writev((int)fd, vec, nvec);
+            if (r > -1)
+                break;
+            if (!_enonfatal(errno))
+                return errno;
+            sleep_ms(SLEEP_TIME);
+        }
+        *nwritten += (size_t)r;
+        // consume r bytes from the front of the array
+        while (r > 0) {
+            size_t avail = iov[i].len - skip;
+            if ((size_t)r < avail) {
+                skip += (size_t)r;
+                r = 0;
+            }
+            else {
+                r -= (ssize_t)avail;
+                i++;
+                skip = 0;
+            }
+        }
+    }
+    return 0;
+#endif
+}
+
 
 /* internal utility functions */
 
@@ -257,6 +325,54 @@ static size_t _write_grow(ios_t *s, const char *data, size_t n)
 
 /* interface functions, low level */
 
+// Adaptive buffering. IOS_BUFSIZE is a fine default, but a linear scan
+// over a file orders of magnitude larger wants a bigger buffer (fewer
+// read syscalls) and kernel readahead, while a random-access pattern
+// wants neither. A few sequential buffer refills in a row classify the
+// stream as scanning: we fadvise SEQUENTIAL and double the buffer up to
+// IOS_MAX_BUFSIZE on each further refill. A few buffer-discarding seeks
+// in a row classify it as random: we fadvise RANDOM and drop an
+// overgrown buffer back to the default so refills stop overshooting.
+#define IOS_MAX_BUFSIZE (4*1024*1024)
+#define IOS_SEQ_THRESHOLD 4
+#define IOS_RND_THRESHOLD 4
+
+static void _ios_seq_hint(ios_t *s)
+{
+    if (s->seqhits < IOS_SEQ_THRESHOLD) {
+        if (++s->seqhits < IOS_SEQ_THRESHOLD)
+            return;
+#if !defined(_OS_WINDOWS_) && defined(POSIX_FADV_SEQUENTIAL)
+        posix_fadvise(s->fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+    }
+    s->rndhits = 0;
+    if (s->bm == bm_block && s->ownbuf &&
+        s->maxsize >= IOS_BUFSIZE && s->maxsize < IOS_MAX_BUFSIZE)
+        _buf_realloc(s, (size_t)s->maxsize * 2);  // failure is harmless
+}
+
+static void _ios_rnd_hint(ios_t *s)
+{
+    s->seqhits = 0;
+    if (s->rndhits < IOS_RND_THRESHOLD) {
+        if (++s->rndhits < IOS_RND_THRESHOLD)
+            return;
+#if !defined(_OS_WINDOWS_) && defined(POSIX_FADV_RANDOM)
+        posix_fadvise(s->fd, 0, 0, POSIX_FADV_RANDOM);
+#endif
+        // an overgrown buffer only wastes refill work now
+        if (s->bm == bm_block && s->ownbuf && s->maxsize > IOS_BUFSIZE &&
+            s->buf != &s->local[0] && s->size == 0 && s->ndirty == 0) {
+            char *tmp = (char*)LLT_REALLOC(s->buf, IOS_BUFSIZE + 1);
+            if (tmp != NULL) {
+                s->buf = tmp;
+                s->maxsize = IOS_BUFSIZE;
+            }
+        }
+    }
+}
+
 static size_t _ios_read(ios_t *s, char *dest, size_t n, int all)
 {
     size_t tot = 0;
@@ -294,6 +410,7 @@ static size_t _ios_read(ios_t *s, char *dest, size_t n, int all)
         ios_flush(s);
         s->bpos = s->size = 0;
         s->fpos = -1;
+        _ios_seq_hint(s);
         if (n > MOST_OF(s->maxsize)) {
             // doesn't fit comfortably in buffer; go direct
             if (all) {
@@ -362,6 +479,7 @@ size_t ios_readprep(ios_t *s, size_t n)
     }
     size_t got;
     s->fpos = -1;
+    _ios_seq_hint(s);
     int result = _os_read(s->fd, s->buf+s->size, (size_t)(s->maxsize - s->size), &got);
     if (result)
         return space;
@@ -369,6 +487,16 @@ size_t ios_readprep(ios_t *s, size_t n)
     return (size_t)(s->size - s->bpos);
 }
 
+const char *ios_peekptr(ios_t *s, size_t n, size_t *avail)
+{
+    size_t have = ios_readprep(s, n);
+    if (avail)
+        *avail = have;
+    if (have == 0)
+        return NULL;
+    return s->buf + s->bpos;
+}
+
 static void _write_update_pos(ios_t *s)
 {
     if (s->bpos > s->ndirty) s->ndirty = s->bpos;
@@ -437,6 +565,50 @@ size_t ios_write(ios_t *s, const char *data, size_t n)
     return wrote;
 }
 
+// Vectored write: emit several buffers (e.g. header + body + trailer of a
+// framed message) as one logical write. Unbuffered streams get a single
+// writev() instead of one syscall per buffer; buffered streams coalesce
+// into the stream buffer when the total fits.
+size_t ios_writev(ios_t *s, const ios_iovec_t *iov, int iovcnt)
+{
+    if (!s->writable || iovcnt <= 0)
+        return 0;
+    size_t total = 0;
+    for (int i = 0; i < iovcnt; i++)
+        total += iov[i].len;
+    if (total == 0)
+        return 0;
+
+    if (s->state == bst_rd) {
+        ios_seek(s, ios_pos(s));
+    }
+    s->state = bst_wr;
+
+    if (s->bm == bm_none) {
+        size_t wrote;
+        s->fpos = -1;
+        _os_writev_all(s->fd, iov, iovcnt, &wrote);
+        return wrote;
+    }
+    if (s->bm != bm_mem && total > (size_t)(s->maxsize - s->bpos) &&
+        total > MOST_OF(s->maxsize)) {
+        // too big to ever sit in the buffer: flush what is pending and
+        // write the whole frame in one vectored call
+        ios_flush(s);
+        size_t wrote;
+        s->fpos = -1;
+        _os_writev_all(s->fd, iov, iovcnt, &wrote);
+        return wrote;
+    }
+    // coalesce into the buffer (it fits, possibly after a flush) or grow a
+    // memory stream; `ios_write` already has the bookkeeping for both,
+    // including line buffering
+    size_t wrote = 0;
+    for (int i = 0; i < iovcnt; i++)
+        wrote += ios_write(s, iov[i].data, iov[i].len);
+    return wrote;
+}
+
 // Returns 0 on success,
 //        -1 on error which set errno, and
 //        -2 on error which doesn't set errno.
@@ -455,6 +627,7 @@ int64_t ios_seek(ios_t *s, int64_t pos)
             return fdpos;
         s->fpos = fdpos;
         s->bpos = s->size = 0;
+        _ios_rnd_hint(s);
     }
     return 0;
 }
@@ -652,13 +825,26 @@ int ios_flush(ios_t *s)
     return 0;
 }
 
+// release a file mapping installed by ios_mmap
+static void _ios_unmap(ios_t *s)
+{
+#ifndef _OS_WINDOWS_
+    munmap(s->buf, (size_t)s->maxsize);
+#endif
+    s->buf = NULL;
+    s->mmapped = 0;
+}
+
 void ios_close(ios_t *s)
 {
     ios_flush(s);
     if (s->fd != -1 && s->ownfd)
         close(s->fd);
     s->fd = -1;
-    if (s->buf!=NULL && s->ownbuf && s->buf!=&s->local[0]) {
+    if (s->mmapped) {
+        _ios_unmap(s);
+    }
+    else if (s->buf!=NULL && s->ownbuf && s->buf!=&s->local[0]) {
         LLT_FREE(s->buf);
     }
     s->buf = NULL;
@@ -691,7 +877,8 @@ char *ios_take_buffer(ios_t *s, size_t *psize)
 
     ios_flush(s);
 
-    if (s->buf == &s->local[0]) {
+    if (s->buf == &s->local[0] || s->mmapped) {
+        // inline and mapped buffers can't be handed out; copy instead
         buf = (char*)LLT_ALLOC((size_t)s->size + 1);
         if (buf == NULL)
             return NULL;
@@ -709,6 +896,8 @@ char *ios_take_buffer(ios_t *s, size_t *psize)
     *psize = s->size+1;  // buffer is actually 1 bigger for terminating NUL
 
     /* empty stream and reinitialize */
+    if (s->mmapped)
+        _ios_unmap(s);
     _buf_init(s, s->bm);
 
     return buf;
@@ -728,7 +917,10 @@ int ios_setbuf(ios_t *s, char *buf, size_t size, int own)
     }
     s->size = nvalid;
 
-    if (s->buf!=NULL && s->ownbuf && s->buf!=&s->local[0]) {
+    if (s->mmapped) {
+        _ios_unmap(s);
+    }
+    else if (s->buf!=NULL && s->ownbuf && s->buf!=&s->local[0]) {
         LLT_FREE(s->buf);
     }
     s->buf = buf;
@@ -833,6 +1025,41 @@ size_t ios_copyuntil(ios_t *to, ios_t *from, char delim)
     return total;
 }
 
+// zero-copy counterpart of ios_copyuntil: hand back a span of the stream's
+// own buffer running up to and including the next delimiter (or the
+// remaining data when the stream ends first). The whole line is buffered,
+// growing the buffer as needed, so no bytes are copied out; the returned
+// pointer is only valid until the next operation on the stream.
+const char *ios_spanuntil(ios_t *s, char delim, size_t *nspan)
+{
+    size_t scanned = 0;
+    size_t want = LINE_CHUNK_SIZE;
+    while (1) {
+        size_t avail = ios_readprep(s, want);
+        char *start = s->buf + s->bpos;
+        if (avail > scanned) {
+            // only new bytes need scanning after a refill
+            char *pd = (char*)memchr(start + scanned, delim, avail - scanned);
+            if (pd != NULL) {
+                *nspan = (size_t)(pd - start) + 1;
+                s->bpos += *nspan;
+                return start;
+            }
+            scanned = avail;
+        }
+        else {
+            // no new data arrived: stream exhausted
+            s->_eof = 1;
+            *nspan = avail;
+            if (avail == 0)
+                return NULL;
+            s->bpos += avail;
+            return start;
+        }
+        want = avail + LINE_CHUNK_SIZE;
+    }
+}
+
 size_t ios_nchomp(ios_t *from, size_t ntowrite)
 {
     assert(ntowrite > 0);
@@ -867,6 +1094,9 @@ static void _ios_init(ios_t *s)
     s->readable = 1;
     s->writable = 1;
     s->rereadable = 0;
+    s->mmapped = 0;
+    s->seqhits = 0;
+    s->rndhits = 0;
 }
 
 /* stream object initializers. we do no allocation. */
@@ -1002,6 +1232,43 @@ ios_t *ios_static_buffer(ios_t *s, char *buf, size_t sz)
     return s;
 }
 
+ios_t *ios_mmap(ios_t *s, const char *fname)
+{
+#ifdef _OS_WINDOWS_
+    // no mmap here; fall back to buffered reads
+    return ios_file(s, fname, 1, 0, 0, 0);
+#else
+    if (ios_file(s, fname, 1, 0, 0, 0) == NULL)
+        return NULL;
+    struct stat st;
+    if (fstat(s->fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size == 0)
+        return s;  // not mappable; keep the buffered stream
+    size_t sz = (size_t)st.st_size;
+    char *map = (char*)mmap(NULL, sz, PROT_READ, MAP_PRIVATE, s->fd, 0);
+    if (map == MAP_FAILED)
+        return s;
+#ifdef MADV_SEQUENTIAL
+    madvise(map, sz, MADV_SEQUENTIAL);
+#endif
+#ifdef MADV_WILLNEED
+    madvise(map, sz, MADV_WILLNEED);
+#endif
+    close(s->fd);  // the mapping outlives the descriptor
+    s->fd = -1;
+    if (s->buf != NULL && s->ownbuf && s->buf != &s->local[0])
+        LLT_FREE(s->buf);
+    s->buf = map;
+    s->maxsize = s->size = sz;
+    s->bpos = 0;
+    s->state = bst_rd;
+    s->bm = bm_mem;
+    s->ownbuf = 0;
+    s->mmapped = 1;
+    ios_set_readonly(s);
+    return s;
+#endif
+}
+
 ios_t *ios_fd(ios_t *s, long fd, int isfile, int own)
 {
     _ios_init(s);
@@ -1177,6 +1444,251 @@ char *ios_readline(ios_t *s)
 
 extern int vasprintf(char **strp, const char *fmt, va_list ap);
 
+// Compiled format segments. Formatting goes through vsnprintf, which
+// re-parses the whole format string on every call; the hot logging paths
+// use a small set of format literals over and over. We memoize the parse:
+// a format is split once into literal runs (memcpy'd straight to the
+// stream) and single conversion specs (each handed to snprintf with the
+// one argument it consumes), keyed by the format string's address in a
+// tiny direct-mapped cache. Each entry stores its own copy of the format
+// and a hit is validated against it by content: callers may pass
+// heap-allocated formats whose storage is later reused for a different
+// string at the same address, so the address alone identifies nothing.
+// Formats using features that can't be safely
+// replayed segment-at-a-time (arg-supplied widths, positional args, %n,
+// decorated %s, huge widths) are marked unsupported and take the generic
+// path forever. Cache slots are claimed once and never evicted, so
+// readers never see an entry die under them.
+
+#define IOS_FMT_CACHE_SIZE 64
+#define IOS_FMT_MAX_SEGS 16
+#define IOS_FMT_MAX_SPEC 24
+#define IOS_FMT_MAX_WIDTH 256
+
+enum {
+    IOS_FA_LIT,     // literal run, copied verbatim
+    IOS_FA_PCT,     // "%%"
+    IOS_FA_INT,     // int-sized integer conversion (incl. h/hh, %c)
+    IOS_FA_LONG,
+    IOS_FA_LLONG,
+    IOS_FA_INTMAX,
+    IOS_FA_SIZE,
+    IOS_FA_PTRDIFF,
+    IOS_FA_DBL,
+    IOS_FA_LDBL,
+    IOS_FA_STR,     // plain "%s" only
+    IOS_FA_PTR
+};
+
+typedef struct {
+    uint8_t kind;
+    uint16_t off;   // segment start within the format string
+    uint16_t len;   // segment byte length
+} ios_fmt_seg_t;
+
+typedef struct {
+    const char *fmt; // private copy of the format (allocated with the entry)
+    int nsegs;       // -1 if the format can't be segmented
+    ios_fmt_seg_t segs[IOS_FMT_MAX_SEGS];
+} ios_fmt_entry_t;
+
+static ios_fmt_entry_t *ios_fmt_cache[IOS_FMT_CACHE_SIZE];
+
+static void _ios_fmt_compile(const char *fmt, ios_fmt_entry_t *e)
+{
+    const char *p = fmt;
+    int n = 0;
+    e->nsegs = -1; // pessimistic until we parse the whole thing
+    while (*p) {
+        if (n >= IOS_FMT_MAX_SEGS || p - fmt > UINT16_MAX - IOS_FMT_MAX_SPEC)
+            return;
+        if (*p != '%') {
+            const char *start = p;
+            while (*p && *p != '%')
+                p++;
+            e->segs[n].kind = IOS_FA_LIT;
+            e->segs[n].off = (uint16_t)(start - fmt);
+            e->segs[n].len = (uint16_t)(p - start);
+            n++;
+            continue;
+        }
+        const char *start = p++;
+        if (*p == '%') {
+            p++;
+            e->segs[n].kind = IOS_FA_PCT;
+            e->segs[n].off = (uint16_t)(start - fmt);
+            e->segs[n].len = 2;
+            n++;
+            continue;
+        }
+        while (*p == '-' || *p == '+' || *p == ' ' || *p == '#' || *p == '0')
+            p++;
+        long width = 0;
+        if (*p == '*')
+            return; // width from the arg list
+        while (*p >= '0' && *p <= '9')
+            width = width * 10 + (*p++ - '0');
+        long prec = 0;
+        if (*p == '.') {
+            p++;
+            if (*p == '*')
+                return;
+            while (*p >= '0' && *p <= '9')
+                prec = prec * 10 + (*p++ - '0');
+        }
+        if (width > IOS_FMT_MAX_WIDTH || prec > IOS_FMT_MAX_WIDTH)
+            return; // keep single conversions inside a stack buffer
+        int lm = 0; // 0 none, 'H' hh, 'h', 'l', 'q' ll, 'j', 'z', 't', 'L'
+        if (*p == 'h') {
+            lm = (p[1] == 'h') ? 'H' : 'h';
+            p += (p[1] == 'h') ? 2 : 1;
+        }
+        else if (*p == 'l') {
+            lm = (p[1] == 'l') ? 'q' : 'l';
+            p += (p[1] == 'l') ? 2 : 1;
+        }
+        else if (*p == 'j' || *p == 'z' || *p == 't' || *p == 'L') {
+            lm = *p++;
+        }
+        char conv = *p++;
+        uint8_t kind;
+        switch (conv) {
+        case 'd': case 'i': case 'u': case 'o': case 'x': case 'X':
+            switch (lm) {
+            case 0: case 'h': case 'H': kind = IOS_FA_INT; break;
+            case 'l': kind = IOS_FA_LONG; break;
+            case 'q': kind = IOS_FA_LLONG; break;
+            case 'j': kind = IOS_FA_INTMAX; break;
+            case 'z': kind = IOS_FA_SIZE; break;
+            case 't': kind = IOS_FA_PTRDIFF; break;
+            default: return;
+            }
+            break;
+        case 'c':
+            if (lm != 0)
+                return;
+            kind = IOS_FA_INT;
+            break;
+        case 's':
+            // only bare %s: a width/precision can't bound the output
+            if (lm != 0 || p - start != 2)
+                return;
+            kind = IOS_FA_STR;
+            break;
+        case 'p':
+            kind = IOS_FA_PTR;
+            break;
+        case 'e': case 'E': case 'f': case 'F':
+        case 'g': case 'G': case 'a': case 'A':
+            if (lm == 'L')
+                kind = IOS_FA_LDBL;
+            else if (lm == 0 || lm == 'l')
+                kind = IOS_FA_DBL;
+            else
+                return;
+            break;
+        default:
+            return; // %n, %m, positional args, unknown conversions
+        }
+        if (p - start > IOS_FMT_MAX_SPEC)
+            return;
+        e->segs[n].kind = kind;
+        e->segs[n].off = (uint16_t)(start - fmt);
+        e->segs[n].len = (uint16_t)(p - start);
+        n++;
+    }
+    e->nsegs = n;
+}
+
+// replay a compiled format. returns the byte count written, or -2 before
+// consuming any arguments if the format isn't cached as segmentable.
+static int _ios_fmt_segwrite(ios_t *s, const char *format, va_list args)
+{
+    size_t h = (((uintptr_t)format) >> 4) % IOS_FMT_CACHE_SIZE;
+    ios_fmt_entry_t *e = ios_fmt_cache[h];
+    if (e == NULL) {
+        size_t len = strlen(format);
+        e = (ios_fmt_entry_t*)LLT_ALLOC(sizeof(ios_fmt_entry_t) + len + 1);
+        if (e == NULL)
+            return -2;
+        char *copy = (char*)(e + 1);
+        memcpy(copy, format, len + 1);
+        e->fmt = copy;
+        _ios_fmt_compile(copy, e);
+        if (!__sync_bool_compare_and_swap(&ios_fmt_cache[h], NULL, e)) {
+            // someone else claimed the slot; theirs stays
+            LLT_FREE(e);
+            e = ios_fmt_cache[h];
+        }
+    }
+    if (e->nsegs < 0 || strcmp(e->fmt, format) != 0)
+        return -2;
+    char tmp[512]; // large enough for any conversion we compile
+    char spec[IOS_FMT_MAX_SPEC + 1];
+    int tot = 0;
+    for (int i = 0; i < e->nsegs; i++) {
+        const ios_fmt_seg_t *seg = &e->segs[i];
+        int c;
+        switch (seg->kind) {
+        case IOS_FA_LIT:
+            ios_write(s, format + seg->off, seg->len);
+            tot += seg->len;
+            continue;
+        case IOS_FA_PCT:
+            ios_putc('%', s);
+            tot += 1;
+            continue;
+        case IOS_FA_STR: {
+            const char *str = va_arg(args, const char*);
+            if (str == NULL)
+                str = "(null)";
+            size_t sl = strlen(str);
+            ios_write(s, str, sl);
+            tot += (int)sl;
+            continue;
+        }
+        }
+        memcpy(spec, format + seg->off, seg->len);
+        spec[seg->len] = '\0';
+        switch (seg->kind) {
+        case IOS_FA_INT:
+            c = snprintf(tmp, sizeof(tmp), spec, va_arg(args, int));
+            break;
+        case IOS_FA_LONG:
+            c = snprintf(tmp, sizeof(tmp), spec, va_arg(args, long));
+            break;
+        case IOS_FA_LLONG:
+            c = snprintf(tmp, sizeof(tmp), spec, va_arg(args, long long));
+            break;
+        case IOS_FA_INTMAX:
+            c = snprintf(tmp, sizeof(tmp), spec, va_arg(args, intmax_t));
+            break;
+        case IOS_FA_SIZE:
+            c = snprintf(tmp, sizeof(tmp), spec, va_arg(args, size_t));
+            break;
+        case IOS_FA_PTRDIFF:
+            c = snprintf(tmp, sizeof(tmp), spec, va_arg(args, ptrdiff_t));
+            break;
+        case IOS_FA_DBL:
+            c = snprintf(tmp, sizeof(tmp), spec, va_arg(args, double));
+            break;
+        case IOS_FA_LDBL:
+            c = snprintf(tmp, sizeof(tmp), spec, va_arg(args, long double));
+            break;
+        default: // IOS_FA_PTR
+            c = snprintf(tmp, sizeof(tmp), spec, va_arg(args, void*));
+            break;
+        }
+        if (c < 0)
+            return tot; // emit what we have; matches best-effort semantics
+        if (c >= (int)sizeof(tmp))
+            c = (int)sizeof(tmp) - 1; // can't happen: widths are capped
+        ios_write(s, tmp, c);
+        tot += c;
+    }
+    return tot;
+}
+
 int ios_vprintf(ios_t *s, const char *format, va_list args)
 {
     char *str=NULL;
@@ -1206,6 +1718,42 @@ int ios_vprintf(ios_t *s, const char *format, va_list args)
             return c;
         }
     }
+    {
+        // replay a compiled format if we have one for this string
+        va_list al2;
+#if defined(_OS_WINDOWS_)
+        al2 = al;
+#else
+        va_copy(al2, al);
+#endif
+        c = _ios_fmt_segwrite(s, format, al2);
+#if !defined(_OS_WINDOWS_)
+        va_end(al2);
+#endif
+        if (c >= 0) {
+            va_end(al);
+            return c;
+        }
+    }
+    {
+        // short output: format into a stack buffer and skip the malloc
+        char sbuf[1024];
+        va_list al2;
+#if defined(_OS_WINDOWS_)
+        al2 = al;
+#else
+        va_copy(al2, al);
+#endif
+        c = vsnprintf(sbuf, sizeof(sbuf), format, al2);
+#if !defined(_OS_WINDOWS_)
+        va_end(al2);
+#endif
+        if (c >= 0 && c < (int)sizeof(sbuf)) {
+            ios_write(s, sbuf, c);
+            va_end(al);
+            return c;
+        }
+    }
     c = vasprintf(&str, format, al);
 
     if (c >= 0) {
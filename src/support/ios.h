@@ -59,6 +59,10 @@ typedef struct {
     // again any number of times. usually only true for files and strings.
     unsigned char rereadable:1;
 
+    // buf is a read-only file mapping owned by the stream; ios_close
+    // unmaps it instead of freeing it. set by ios_mmap.
+    unsigned char mmapped:1;
+
     // this enables "stenciled writes". you can alternately write and
     // seek without flushing in between. this performs read-before-write
     // to populate the buffer, so "rereadable" capability is required.
@@ -68,15 +72,27 @@ typedef struct {
     // request durable writes (fsync)
     // unsigned char durable:1;
 
+    // adaptive buffering state: consecutive sequential buffer refills and
+    // buffer-discarding seeks; drives buffer sizing and fadvise hints
+    unsigned char seqhits;
+    unsigned char rndhits;
+
     int64_t userdata;
     char local[IOS_INLSIZE];
 } ios_t;
 
+// one buffer of a vectored write; same layout as a POSIX struct iovec
+typedef struct {
+    const char *data;
+    size_t len;
+} ios_iovec_t;
+
 extern void (*ios_set_io_wait_func)(int);
 /* low-level interface functions */
 JL_DLLEXPORT size_t ios_read(ios_t *s, char *dest, size_t n);
 JL_DLLEXPORT size_t ios_readall(ios_t *s, char *dest, size_t n);
 JL_DLLEXPORT size_t ios_write(ios_t *s, const char *data, size_t n) JL_NOTSAFEPOINT;
+JL_DLLEXPORT size_t ios_writev(ios_t *s, const ios_iovec_t *iov, int iovcnt) JL_NOTSAFEPOINT;
 JL_DLLEXPORT int64_t ios_seek(ios_t *s, int64_t pos) JL_NOTSAFEPOINT; // absolute seek
 JL_DLLEXPORT int64_t ios_seek_end(ios_t *s);
 JL_DLLEXPORT int64_t ios_skip(ios_t *s, int64_t offs);  // relative seek
@@ -97,9 +113,18 @@ JL_DLLEXPORT void ios_set_readonly(ios_t *s);
 JL_DLLEXPORT size_t ios_copy(ios_t *to, ios_t *from, size_t nbytes);
 JL_DLLEXPORT size_t ios_copyall(ios_t *to, ios_t *from);
 JL_DLLEXPORT size_t ios_copyuntil(ios_t *to, ios_t *from, char delim) JL_NOTSAFEPOINT;
+// zero-copy line iteration: return a span of the stream buffer up to and
+// including the next delim (or the remainder at EOF, or NULL when empty);
+// the span is only valid until the next operation on the stream
+JL_DLLEXPORT const char *ios_spanuntil(ios_t *s, char delim, size_t *nspan) JL_NOTSAFEPOINT;
 JL_DLLEXPORT size_t ios_nchomp(ios_t *from, size_t ntowrite);
 // ensure at least n bytes are buffered if possible. returns # available.
 JL_DLLEXPORT size_t ios_readprep(ios_t *from, size_t n);
+// zero-copy read: buffer up to n bytes and return a pointer to them
+// inside the stream buffer, setting *avail to the count actually there.
+// the pointer is invalidated by the next read, write, seek, or close.
+// on an ios_mmap stream the whole file is addressable this way.
+JL_DLLEXPORT const char *ios_peekptr(ios_t *s, size_t n, size_t *avail);
 
 /* stream creation */
 JL_DLLEXPORT
@@ -108,6 +133,10 @@ JL_DLLEXPORT ios_t *ios_mkstemp(ios_t *f, char *fname);
 JL_DLLEXPORT ios_t *ios_mem(ios_t *s, size_t initsize) JL_NOTSAFEPOINT;
 ios_t *ios_str(ios_t *s, char *str);
 ios_t *ios_static_buffer(ios_t *s, char *buf, size_t sz);
+// open fname read-only backed by a private file mapping, with readahead
+// hinted to the kernel. falls back to a buffered ios_file when the file
+// cannot be mapped (empty, not a regular file, or no mmap support).
+JL_DLLEXPORT ios_t *ios_mmap(ios_t *s, const char *fname);
 JL_DLLEXPORT ios_t *ios_fd(ios_t *s, long fd, int isfile, int own);
 // todo: ios_socket
 extern JL_DLLEXPORT ios_t *ios_stdin;
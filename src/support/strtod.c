@@ -11,6 +11,173 @@
 extern "C" {
 #endif
 
+#if defined(__SIZEOF_INT128__) || (defined(_COMPILER_MICROSOFT_) && defined(_P64))
+#define JL_STRTOD_FAST 1
+#endif
+
+#ifdef JL_STRTOD_FAST
+#if defined(_COMPILER_MICROSOFT_)
+#include <intrin.h> // _umul128, _BitScanReverse64
+#endif
+
+#include "strtod-pow5-tables.c"
+
+STATIC_INLINE void jl_strtod_mul128(uint64_t a, uint64_t b,
+                                    uint64_t *hi, uint64_t *lo)
+{
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 p = (unsigned __int128)a * b;
+    *hi = (uint64_t)(p >> 64);
+    *lo = (uint64_t)p;
+#else
+    *lo = _umul128(a, b, hi);
+#endif
+}
+
+STATIC_INLINE int jl_strtod_clz64(uint64_t x)
+{
+#if defined(_COMPILER_MICROSOFT_)
+    unsigned long i;
+    _BitScanReverse64(&i, x);
+    return 63 - (int)i;
+#else
+    return __builtin_clzll(x);
+#endif
+}
+
+/* Eisel-Lemire fast path: accumulate up to 19 significant digits into a
+   64-bit mantissa and scale by a table-driven 128-bit power of ten. The
+   result is exactly-rounded whenever this returns 1; anything unusual
+   (hex floats, inf/nan, > 19 digits, subnormals, overflow, or the rare
+   ambiguously-rounded product) returns 0 and takes the slow path. */
+static int jl_strtod_fast(const char *nptr, char **endptr, double *out)
+{
+    const char *p = nptr;
+    const char *digits_end;
+    uint64_t w = 0;
+    int64_t frac = 0, expv = 0, q;
+    int neg = 0, ndig = 0, anydig = 0;
+    uint64_t phi, plo, mant, bits;
+    int lz, upperbit;
+    int32_t power2;
+
+    while (*p == ' ' || (*p >= '\t' && *p <= '\r'))
+        p++;
+    if (*p == '-') {
+        neg = 1;
+        p++;
+    }
+    else if (*p == '+') {
+        p++;
+    }
+    if (p[0] == '0' && (p[1] == 'x' || p[1] == 'X'))
+        return 0; // hex float
+    while (*p == '0') {
+        p++;
+        anydig = 1;
+    }
+    while (*p >= '0' && *p <= '9') {
+        if (ndig >= 19)
+            return 0; // needs more than 64-bit decimal accumulation
+        w = w * 10 + (uint64_t)(*p - '0');
+        ndig++;
+        anydig = 1;
+        p++;
+    }
+    if (*p == '.') {
+        p++;
+        if (ndig == 0) {
+            // zeros here are still leading zeros, but count the scale
+            while (*p == '0') {
+                p++;
+                frac++;
+                anydig = 1;
+            }
+        }
+        while (*p >= '0' && *p <= '9') {
+            if (ndig >= 19)
+                return 0;
+            w = w * 10 + (uint64_t)(*p - '0');
+            ndig++;
+            frac++;
+            anydig = 1;
+            p++;
+        }
+    }
+    if (!anydig)
+        return 0; // no digits: inf/nan or no conversion
+    digits_end = p;
+    if (*p == 'e' || *p == 'E') {
+        const char *e = p + 1;
+        int eneg = 0;
+        if (*e == '-') {
+            eneg = 1;
+            e++;
+        }
+        else if (*e == '+') {
+            e++;
+        }
+        if (*e >= '0' && *e <= '9') {
+            int64_t ev = 0;
+            while (*e >= '0' && *e <= '9') {
+                if (ev < 100000)
+                    ev = ev * 10 + (*e - '0');
+                e++;
+            }
+            expv = eneg ? -ev : ev;
+            p = e;
+        }
+        else {
+            p = digits_end; // "1e+" parses as "1"
+        }
+    }
+    if (w == 0) {
+        *out = neg ? -0.0 : 0.0;
+        if (endptr)
+            *endptr = (char*)p;
+        return 1;
+    }
+    q = expv - frac;
+    if (q < -342 || q > 308)
+        return 0; // certain underflow/overflow; let strtod set errno
+    lz = jl_strtod_clz64(w);
+    jl_strtod_mul128(w << lz, jl_pow5_inv128[q + 342][0], &phi, &plo);
+    if ((phi & 0x1ff) == 0x1ff) {
+        // not enough bits to round; refine with the low table word
+        uint64_t mhi, mlo;
+        jl_strtod_mul128(w << lz, jl_pow5_inv128[q + 342][1], &mhi, &mlo);
+        plo += mhi;
+        if (plo < mhi)
+            phi++;
+        if ((phi & 0x1ff) == 0x1ff && plo + 1 == 0)
+            return 0; // still ambiguous (cannot happen for q in [-27, 55])
+    }
+    upperbit = (int)(phi >> 63);
+    mant = phi >> (upperbit + 9);
+    power2 = (int32_t)((((152170 + 65536) * q) >> 16) + 63 + upperbit - lz + 1023);
+    if (power2 <= 0)
+        return 0; // subnormal
+    // products ending in exactly 0.5 ulp must round to even, not up
+    if (plo <= 1 && q >= -4 && q <= 23 && (mant & 3) == 1)
+        return 0;
+    mant += mant & 1;
+    mant >>= 1;
+    if (mant >= (2ull << 52)) {
+        mant = 1ull << 52;
+        power2++;
+    }
+    if (power2 >= 0x7ff)
+        return 0; // overflow to infinity; let strtod set errno
+    bits = ((uint64_t)(uint32_t)power2 << 52) | (mant & ~(1ull << 52));
+    if (neg)
+        bits |= 0x8000000000000000ull;
+    memcpy(out, &bits, sizeof(bits));
+    if (endptr)
+        *endptr = (char*)p;
+    return 1;
+}
+#endif // JL_STRTOD_FAST
+
 #if !defined(_OS_WINDOWS_)
 // This code path should be used for systems that support the strtod_l function
 
@@ -29,6 +196,11 @@ locale_t get_c_locale(void)
 
 JL_DLLEXPORT double jl_strtod_c(const char *nptr, char **endptr)
 {
+#ifdef JL_STRTOD_FAST
+    double val;
+    if (jl_strtod_fast(nptr, endptr, &val))
+        return val;
+#endif
     return strtod_l(nptr, endptr, get_c_locale());
 }
 
@@ -110,6 +282,11 @@ JL_DLLEXPORT double jl_strtod_c(const char *nptr, char **endptr)
     const char *digits_pos = NULL;
     int negate = 0;
 
+#ifdef JL_STRTOD_FAST
+    if (jl_strtod_fast(nptr, endptr, &val))
+        return val;
+#endif
+
     fail_pos = NULL;
 
     locale_data = localeconv();
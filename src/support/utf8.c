@@ -37,6 +37,11 @@
 
 #include "utf8.h"
 
+#if defined(_CPU_X86_64_) && !defined(_COMPILER_MICROSOFT_)
+#define U8_SIMD 1
+#include <immintrin.h>
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -224,6 +229,31 @@ size_t u8_offset(const char *s, size_t charnum)
 size_t u8_charnum(const char *s, size_t offset)
 {
     size_t charnum = 0;
+#ifdef U8_SIMD
+    // count continuation bytes 16 at a time; the 0xff lanes from the
+    // comparison accumulate as per-byte counts, drained through psadbw
+    // before they can wrap at 255 blocks
+    while (offset >= 16) {
+        const __m128i cmask = _mm_set1_epi8((char)0xc0);
+        const __m128i cbyte = _mm_set1_epi8((char)0x80);
+        __m128i acc = _mm_setzero_si128();
+        __m128i sums;
+        size_t nblk = offset / 16;
+        if (nblk > 255)
+            nblk = 255;
+        offset -= nblk * 16;
+        charnum += nblk * 16;
+        do {
+            __m128i x = _mm_loadu_si128((const __m128i*)s);
+            acc = _mm_sub_epi8(acc, _mm_cmpeq_epi8(_mm_and_si128(x, cmask),
+                                                   cbyte));
+            s += 16;
+        } while (--nblk);
+        sums = _mm_sad_epu8(acc, _mm_setzero_si128());
+        charnum -= (size_t)_mm_cvtsi128_si64(sums) +
+                   (size_t)_mm_cvtsi128_si64(_mm_unpackhi_epi64(sums, sums));
+    }
+#endif
     if (offset) {
        do {
           // Simply not count continuation bytes
@@ -538,7 +568,11 @@ size_t u8_printf(const char *fmt, ...)
 
    length is in bytes, since without knowing whether the string is valid
    it's hard to know how many characters there are! */
+#ifdef U8_SIMD
+static int u8_isvalid_scalar(const char *str, size_t len)
+#else
 int u8_isvalid(const char *str, size_t len)
+#endif
 {
     const unsigned char *pnt;   // Current pointer in string
     const unsigned char *pend;  // End of string
@@ -594,6 +628,162 @@ chkutf8:
     }
     return 2;   // Valid UTF-8
 }
+
+#ifdef U8_SIMD
+/* Vectorized validation after Keiser & Lemire, "Validating UTF-8 In Less
+   Than One Instruction Per Byte": each byte pair is classified through
+   three nibble lookup tables whose bits name every way a two-byte prefix
+   can be malformed, and 3/4-byte leads additionally demand continuation
+   bytes at distance 2/3. Any error bit left standing after a block means
+   the input is invalid. Accepts exactly the same strings as the scalar
+   validator (strict UTF-8: no surrogates, overlongs, or > U+10FFFF). */
+
+#define U8_TOO_SHORT      0x01 // lead byte followed by lead/ASCII
+#define U8_TOO_LONG       0x02 // ASCII followed by a continuation
+#define U8_OVERLONG_3     0x04 // e0 80..9f
+#define U8_TOO_LARGE      0x08 // f4 90..bf
+#define U8_SURROGATE      0x10 // ed a0..bf
+#define U8_OVERLONG_2     0x20 // c0/c1 lead
+#define U8_TOO_LARGE_1000 0x40 // f5..ff lead
+#define U8_OVERLONG_4     0x40 // f0 80..8f
+#define U8_TWO_CONTS      0x80 // continuation after continuation; the
+                               // length check below cancels legal cases
+#define U8_CARRY (U8_TOO_SHORT | U8_TOO_LONG | U8_TWO_CONTS)
+
+__attribute__((target("ssse3")))
+static int u8_isvalid_ssse3(const char *str, size_t len)
+{
+    // indexed by the high nibble of the first byte of each pair
+    static const char byte_1_high_tbl[16] = {
+        U8_TOO_LONG, U8_TOO_LONG, U8_TOO_LONG, U8_TOO_LONG,
+        U8_TOO_LONG, U8_TOO_LONG, U8_TOO_LONG, U8_TOO_LONG,
+        U8_TWO_CONTS, U8_TWO_CONTS, U8_TWO_CONTS, U8_TWO_CONTS,
+        U8_TOO_SHORT | U8_OVERLONG_2,
+        U8_TOO_SHORT,
+        U8_TOO_SHORT | U8_OVERLONG_3 | U8_SURROGATE,
+        U8_TOO_SHORT | U8_TOO_LARGE | U8_TOO_LARGE_1000 | U8_OVERLONG_4
+    };
+    // indexed by the low nibble of the first byte
+    static const char byte_1_low_tbl[16] = {
+        U8_CARRY | U8_OVERLONG_3 | U8_OVERLONG_2 | U8_OVERLONG_4,
+        U8_CARRY | U8_OVERLONG_2,
+        U8_CARRY, U8_CARRY,
+        U8_CARRY | U8_TOO_LARGE,
+        U8_CARRY | U8_TOO_LARGE | U8_TOO_LARGE_1000,
+        U8_CARRY | U8_TOO_LARGE | U8_TOO_LARGE_1000,
+        U8_CARRY | U8_TOO_LARGE | U8_TOO_LARGE_1000,
+        U8_CARRY | U8_TOO_LARGE | U8_TOO_LARGE_1000,
+        U8_CARRY | U8_TOO_LARGE | U8_TOO_LARGE_1000,
+        U8_CARRY | U8_TOO_LARGE | U8_TOO_LARGE_1000,
+        U8_CARRY | U8_TOO_LARGE | U8_TOO_LARGE_1000,
+        U8_CARRY | U8_TOO_LARGE | U8_TOO_LARGE_1000,
+        U8_CARRY | U8_TOO_LARGE | U8_TOO_LARGE_1000 | U8_SURROGATE,
+        U8_CARRY | U8_TOO_LARGE | U8_TOO_LARGE_1000,
+        U8_CARRY | U8_TOO_LARGE | U8_TOO_LARGE_1000
+    };
+    // indexed by the high nibble of the second byte
+    static const char byte_2_high_tbl[16] = {
+        U8_TOO_SHORT, U8_TOO_SHORT, U8_TOO_SHORT, U8_TOO_SHORT,
+        U8_TOO_SHORT, U8_TOO_SHORT, U8_TOO_SHORT, U8_TOO_SHORT,
+        U8_TOO_LONG | U8_OVERLONG_2 | U8_TWO_CONTS | U8_OVERLONG_3 |
+            U8_TOO_LARGE_1000 | U8_OVERLONG_4,
+        U8_TOO_LONG | U8_OVERLONG_2 | U8_TWO_CONTS | U8_OVERLONG_3 |
+            U8_TOO_LARGE,
+        U8_TOO_LONG | U8_OVERLONG_2 | U8_TWO_CONTS | U8_SURROGATE |
+            U8_TOO_LARGE,
+        U8_TOO_LONG | U8_OVERLONG_2 | U8_TWO_CONTS | U8_SURROGATE |
+            U8_TOO_LARGE,
+        U8_TOO_SHORT, U8_TOO_SHORT, U8_TOO_SHORT, U8_TOO_SHORT
+    };
+    // a block is incomplete if it ends inside a multi-byte sequence
+    static const char max_tbl[16] = {
+        (char)0xff, (char)0xff, (char)0xff, (char)0xff,
+        (char)0xff, (char)0xff, (char)0xff, (char)0xff,
+        (char)0xff, (char)0xff, (char)0xff, (char)0xff,
+        (char)0xff, (char)0xef, (char)0xdf, (char)0xbf
+    };
+    const __m128i b1h = _mm_loadu_si128((const __m128i*)byte_1_high_tbl);
+    const __m128i b1l = _mm_loadu_si128((const __m128i*)byte_1_low_tbl);
+    const __m128i b2h = _mm_loadu_si128((const __m128i*)byte_2_high_tbl);
+    const __m128i maxv = _mm_loadu_si128((const __m128i*)max_tbl);
+    const __m128i lownib = _mm_set1_epi8(0x0f);
+    __m128i err = _mm_setzero_si128();
+    __m128i prev = _mm_setzero_si128();
+    __m128i prev_incomplete = _mm_setzero_si128();
+    int ascii_only = 1;
+
+    while (len) {
+        __m128i input;
+        if (len >= 16) {
+            input = _mm_loadu_si128((const __m128i*)str);
+            str += 16;
+            len -= 16;
+        }
+        else {
+            // zero padding is ASCII, so a sequence truncated by the end
+            // of the input fails its continuation checks below
+            char tmp[16];
+            memset(tmp, 0, sizeof(tmp));
+            memcpy(tmp, str, len);
+            input = _mm_loadu_si128((const __m128i*)tmp);
+            len = 0;
+        }
+        if (_mm_movemask_epi8(input) == 0) {
+            // all-ASCII block: only a dangling sequence from the
+            // previous block can be wrong
+            err = _mm_or_si128(err, prev_incomplete);
+        }
+        else {
+            __m128i prev1 = _mm_alignr_epi8(input, prev, 15);
+            __m128i prev2 = _mm_alignr_epi8(input, prev, 14);
+            __m128i prev3 = _mm_alignr_epi8(input, prev, 13);
+            __m128i sc = _mm_and_si128(_mm_and_si128(
+                _mm_shuffle_epi8(b1h, _mm_and_si128(_mm_srli_epi16(prev1, 4),
+                                                    lownib)),
+                _mm_shuffle_epi8(b1l, _mm_and_si128(prev1, lownib))),
+                _mm_shuffle_epi8(b2h, _mm_and_si128(_mm_srli_epi16(input, 4),
+                                                    lownib)));
+            // lanes two past a 3/4-byte lead or three past a 4-byte lead
+            // carry 0x80 here and must cancel TWO_CONTS in sc (and vice
+            // versa: an unexpected continuation leaves 0x80 standing)
+            __m128i is3 = _mm_subs_epu8(prev2, _mm_set1_epi8((char)(0xe0 - 0x80)));
+            __m128i is4 = _mm_subs_epu8(prev3, _mm_set1_epi8((char)(0xf0 - 0x80)));
+            __m128i must23_80 = _mm_and_si128(_mm_or_si128(is3, is4),
+                                              _mm_set1_epi8((char)0x80));
+            err = _mm_or_si128(err, _mm_xor_si128(must23_80, sc));
+            prev_incomplete = _mm_subs_epu8(input, maxv);
+            ascii_only = 0;
+        }
+        prev = input;
+    }
+    // the input must not end in the middle of a sequence
+    err = _mm_or_si128(err, prev_incomplete);
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(err, _mm_setzero_si128())) != 0xffff)
+        return 0;
+    return ascii_only ? 1 : 2;
+}
+
+// dispatch on SSSE3 availability on first use
+static int u8_isvalid_init(const char *str, size_t len);
+static int (*u8_isvalid_fptr)(const char *, size_t) = u8_isvalid_init;
+
+static int u8_isvalid_init(const char *str, size_t len)
+{
+    uint32_t eax = 1, ebx, ecx, edx;
+    asm ("cpuid":
+         "=b" (ebx),
+         "+a" (eax),
+         "=c" (ecx),
+         "=d" (edx));
+    u8_isvalid_fptr = ((ecx >> 9) & 1) ? u8_isvalid_ssse3 : u8_isvalid_scalar;
+    return u8_isvalid_fptr(str, len);
+}
+
+int u8_isvalid(const char *str, size_t len)
+{
+    return u8_isvalid_fptr(str, len);
+}
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -57,6 +57,8 @@
 #endif
 
 #include "julia_assert.h"
+#include "support/hashing.h"
+#include "support/htable.inc"
 
 #ifdef __cplusplus
 extern "C" {
@@ -164,6 +166,132 @@ JL_DLLEXPORT int32_t jl_fstat(uv_os_fd_t fd, char *statbuf)
     return ret;
 }
 
+// --- stat cache ---
+//
+// Package resolution stats the same depot paths thousands of times while
+// resolving a `require`; on network filesystems every one is a round
+// trip. When JULIA_STAT_CACHE_TTL_MS is set to a positive value,
+// jl_stat_cached serves repeated lookups (including cached ENOENT) from
+// a path-keyed table for that long. The load path opts in by calling
+// jl_stat_cached; plain jl_stat is untouched, so nothing else in the
+// system changes behavior. jl_stat_cache_invalidate drops one path (or
+// the whole table) after a write, and jl_stat_cache_counters reports
+// hit/miss totals so the win is measurable.
+
+#define statcache_hash(k) ((uint_t)memhash((const char*)(k), strlen((const char*)(k))))
+#define statcache_eq(x, y) (strcmp((const char*)(x), (const char*)(y)) == 0)
+HTIMPL(statcache, statcache_hash, statcache_eq)
+
+typedef struct {
+    char *path;       // owned copy; doubles as the table key
+    uint64_t expires; // uv_hrtime deadline
+    int32_t ret;
+    uv_stat_t buf;
+} jl_statcache_ent_t;
+
+static htable_t jl_statcache;
+static int jl_statcache_inited = 0;
+static jl_mutex_t jl_statcache_lock; // zero-initialized is a valid unlocked state
+static uint64_t jl_statcache_hits = 0;
+static uint64_t jl_statcache_misses = 0;
+static int jl_statcache_ttl_ms = -2; // -2: environment not read yet
+
+// jl_statcache_lock must be held
+static int jl_statcache_enabled(void)
+{
+    if (jl_statcache_ttl_ms == -2) {
+        char *ttl = getenv("JULIA_STAT_CACHE_TTL_MS");
+        jl_statcache_ttl_ms = ttl ? atoi(ttl) : 0;
+        if (jl_statcache_ttl_ms > 0 && !jl_statcache_inited) {
+            htable_new(&jl_statcache, 512);
+            jl_statcache_inited = 1;
+        }
+    }
+    return jl_statcache_ttl_ms > 0;
+}
+
+JL_DLLEXPORT int32_t jl_stat_cached(const char *path, char *statbuf)
+{
+    JL_LOCK_NOGC(&jl_statcache_lock);
+    if (!jl_statcache_enabled()) {
+        JL_UNLOCK_NOGC(&jl_statcache_lock);
+        return jl_stat(path, statbuf);
+    }
+    uint64_t now = uv_hrtime();
+    jl_statcache_ent_t *ent =
+        (jl_statcache_ent_t*)statcache_get(&jl_statcache, (void*)path);
+    if (ent != HT_NOTFOUND && now < ent->expires) {
+        jl_statcache_hits++;
+        int32_t ret = ent->ret;
+        if (ret == 0)
+            memcpy(statbuf, &ent->buf, sizeof(uv_stat_t));
+        JL_UNLOCK_NOGC(&jl_statcache_lock);
+        return ret;
+    }
+    jl_statcache_misses++;
+    uint64_t ttl_ns = (uint64_t)jl_statcache_ttl_ms * 1000000;
+    JL_UNLOCK_NOGC(&jl_statcache_lock); // not across the real round trip
+    int32_t ret = jl_stat(path, statbuf);
+    JL_LOCK_NOGC(&jl_statcache_lock);
+    ent = (jl_statcache_ent_t*)statcache_get(&jl_statcache, (void*)path);
+    if (ent == HT_NOTFOUND) {
+        ent = (jl_statcache_ent_t*)malloc(sizeof(jl_statcache_ent_t));
+        if (ent == NULL) {
+            JL_UNLOCK_NOGC(&jl_statcache_lock);
+            return ret;
+        }
+        ent->path = strdup(path);
+        statcache_put(&jl_statcache, ent->path, ent);
+    }
+    ent->ret = ret;
+    if (ret == 0)
+        memcpy(&ent->buf, statbuf, sizeof(uv_stat_t));
+    ent->expires = uv_hrtime() + ttl_ns;
+    JL_UNLOCK_NOGC(&jl_statcache_lock);
+    return ret;
+}
+
+// drop one cached path, or the whole cache when path is NULL; call after
+// anything that may have changed what a cached stat would report
+JL_DLLEXPORT void jl_stat_cache_invalidate(const char *path)
+{
+    JL_LOCK_NOGC(&jl_statcache_lock);
+    if (!jl_statcache_inited) {
+        JL_UNLOCK_NOGC(&jl_statcache_lock);
+        return;
+    }
+    if (path == NULL) {
+        for (size_t i = 0; i < jl_statcache.size; i += 2) {
+            jl_statcache_ent_t *ent = (jl_statcache_ent_t*)jl_statcache.table[i + 1];
+            if (ent != HT_NOTFOUND) {
+                free(ent->path);
+                free(ent);
+            }
+        }
+        htable_reset(&jl_statcache, 512);
+    }
+    else {
+        jl_statcache_ent_t *ent =
+            (jl_statcache_ent_t*)statcache_get(&jl_statcache, (void*)path);
+        if (ent != HT_NOTFOUND) {
+            statcache_remove(&jl_statcache, (void*)path);
+            free(ent->path);
+            free(ent);
+        }
+    }
+    JL_UNLOCK_NOGC(&jl_statcache_lock);
+}
+
+JL_DLLEXPORT void jl_stat_cache_counters(uint64_t *hits, uint64_t *misses)
+{
+    JL_LOCK_NOGC(&jl_statcache_lock);
+    if (hits)
+        *hits = jl_statcache_hits;
+    if (misses)
+        *misses = jl_statcache_misses;
+    JL_UNLOCK_NOGC(&jl_statcache_lock);
+}
+
 JL_DLLEXPORT unsigned int jl_stat_dev(char *statbuf)
 {
     return ((uv_stat_t*)statbuf)->st_dev;
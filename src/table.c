@@ -10,6 +10,36 @@
 
 static int jl_table_assign_bp(jl_array_t **pa, jl_value_t *key, jl_value_t *val);
 
+// insert used only while rehashing: the keys are known to be distinct and
+// the slots free of tombstones, so no jl_egal comparison, deletion-sentinel
+// bookkeeping, or in-place update is needed. Returns 0 if the key clustered
+// beyond maxprobe; the caller must retry with a bigger table.
+static int jl_table_rehash_bp(jl_array_t *a, jl_value_t *key, jl_value_t *val)
+{
+    size_t sz = hash_size(a);
+    size_t maxprobe = max_probe(sz);
+    void **tab = (void **)a->data;
+    uint_t hv = keyhash(key);
+    size_t index = h2index(hv, sz);
+    sz *= 2;
+    size_t orig = index;
+    size_t iter = 0;
+
+    do {
+        if (tab[index] == NULL) {
+            tab[index] = key;
+            jl_gc_wb(a, key);
+            tab[index + 1] = val;
+            jl_gc_wb(a, val);
+            return 1;
+        }
+        index = (index + 2) & (sz - 1);
+        iter++;
+    } while (iter <= maxprobe && index != orig);
+
+    return 0;
+}
+
 JL_DLLEXPORT jl_array_t *jl_idtable_rehash(jl_array_t *a, size_t newsz)
 {
     // Assume *pa don't need a write barrier
@@ -17,16 +47,21 @@ JL_DLLEXPORT jl_array_t *jl_idtable_rehash(jl_array_t *a, size_t newsz)
     size_t sz = jl_array_len(a);
     size_t i;
     jl_value_t **ol = (jl_value_t **)a->data;
-    jl_array_t *newa = jl_alloc_vec_any(newsz);
+    jl_array_t *newa = NULL;
     // keep the original array in the original slot since we need `ol`
     // to be valid in the loop below.
     JL_GC_PUSH1(&newa);
-    for (i = 0; i < sz; i += 2) {
-        if (ol[i + 1] != NULL) {
-            jl_table_assign_bp(&newa, ol[i], ol[i + 1]);
-            // it is however necessary here because allocation
-            // can (and will) occur in a recursive call inside table_lookup_bp
+    while (1) {
+        newa = jl_alloc_vec_any(newsz);
+        for (i = 0; i < sz; i += 2) {
+            if (ol[i + 1] != NULL &&
+                !jl_table_rehash_bp(newa, ol[i], ol[i + 1]))
+                break;
         }
+        if (i >= sz)
+            break;
+        // a key clustered beyond maxprobe at this size; start over bigger
+        newsz *= 2;
     }
     // we do not check the write barrier here
     // because pa always points to a C stack location
@@ -82,6 +82,27 @@ static int always_copy_stacks = 1;
 static int always_copy_stacks = 0;
 #endif
 
+// Hand-written fiber switch primitives (support/fiber_switch.x86_64.S).
+// They save and restore exactly the callee-saved registers, the stack
+// pointer, the resume address and the fp control state — the same set
+// sigsetjmp(buf, 0) preserves — but skip the libc indirection, pointer
+// mangling and the separate save/restore calls, which is measurable at
+// million-switch rates. The buffer layout is private to the .S file and
+// lives in the same jl_jmp_buf storage; all saves and restores of fiber
+// contexts must go through the jl_save_fiber_ctx/jl_restore_fiber_ctx
+// macros below so the two formats never mix.
+#if defined(JL_HAVE_ASM) && defined(_CPU_X86_64_) && !defined(_OS_WINDOWS_)
+#define JL_HAVE_FIBER_SWAP
+int jl_fiber_save(jl_ucontext_t *ctx) __attribute__((returns_twice));
+void jl_fiber_restore(jl_ucontext_t *ctx) __attribute__((noreturn));
+void jl_fiber_swap(jl_ucontext_t *save_ctx, jl_ucontext_t *restore_ctx);
+#define jl_save_fiber_ctx(ctx) jl_fiber_save(ctx)
+#define jl_restore_fiber_ctx(ctx) jl_fiber_restore(ctx)
+#else
+#define jl_save_fiber_ctx(ctx) jl_setjmp((ctx)->uc_mcontext, 0)
+#define jl_restore_fiber_ctx(ctx) jl_longjmp((ctx)->uc_mcontext, 1)
+#endif
+
 #ifdef COPY_STACKS
 
 static void memcpy_a16(uint64_t *to, uint64_t *from, size_t nb)
@@ -210,10 +231,36 @@ JL_DLLEXPORT void *jl_task_stack_buffer(jl_task_t *task, size_t *size, int *tid)
     return (void *)((char *)task->stkbuf + off);
 }
 
+// Maximum number of frames captured when an exception is thrown.
+// JULIA_THROW_BT_FRAMES can lower this (0 captures no trace at all) for
+// workloads that use exceptions for control flow and discard the trace in
+// the handler: stack unwinding dominates the cost of such throws, and the
+// trace cannot be materialized later since the frames are gone once the
+// handler runs. Default is the full JL_MAX_BT_SIZE.
+static size_t jl_throw_bt_frames(void) JL_NOTSAFEPOINT
+{
+    static int limit = -1;
+    if (limit == -1) {
+        char *env = getenv("JULIA_THROW_BT_FRAMES");
+        limit = JL_MAX_BT_SIZE;
+        if (env) {
+            int n = atoi(env);
+            if (n >= 0 && n < JL_MAX_BT_SIZE)
+                limit = n;
+        }
+    }
+    return (size_t)limit;
+}
+
 static void record_backtrace(jl_ptls_t ptls) JL_NOTSAFEPOINT
 {
+    size_t maxsize = jl_throw_bt_frames();
+    if (maxsize == 0) {
+        ptls->bt_size = 0;
+        return;
+    }
     // storing bt_size in ptls ensures roots in bt_data will be found
-    ptls->bt_size = rec_backtrace(ptls->bt_data, JL_MAX_BT_SIZE);
+    ptls->bt_size = rec_backtrace(ptls->bt_data, maxsize);
 }
 
 JL_DLLEXPORT void julia_init(JL_IMAGE_SEARCH rel)
@@ -270,7 +317,7 @@ static void ctx_switch(jl_ptls_t ptls, jl_task_t **pt)
 #ifdef COPY_STACKS
         if (lastt->copy_stack) { // save the old copy-stack
             save_stack(ptls, lastt, pt); // allocates (gc-safepoint, and can also fail)
-            if (jl_setjmp(lastt->ctx.uc_mcontext, 0)) {
+            if (jl_save_fiber_ctx(&lastt->ctx)) {
                 // TODO: mutex unlock the thread we just switched from
                 return;
             }
@@ -317,7 +364,7 @@ static void ctx_switch(jl_ptls_t ptls, jl_task_t **pt)
     }
     else {
         if (always_copy_stacks)
-            jl_longjmp(ptls->base_ctx.uc_mcontext, 1);
+            jl_restore_fiber_ctx(&ptls->base_ctx);
         else
             jl_start_fiber(lastt_ctx, &t->ctx);
     }
@@ -370,6 +417,12 @@ JL_DLLEXPORT void jl_switchto(jl_task_t **pt)
     assert(t->tid == ptls->tid);
     if (!t->sticky && !t->copy_stack)
         t->tid = -1;
+#ifdef JULIA_ENABLE_THREADING
+    // a depth-first spawn suspended the previous task; it is off-CPU now,
+    // so publish its continuation as stealable work (partr.c)
+    if (__unlikely(ptls->deferred_enqueue_task != NULL))
+        jl_enqueue_deferred_task();
+#endif
     ct = ptls->current_task;
 
 #ifdef ENABLE_TIMINGS
@@ -388,7 +441,10 @@ JL_DLLEXPORT void jl_switchto(jl_task_t **pt)
 JL_DLLEXPORT JL_NORETURN void jl_no_exc_handler(jl_value_t *e) JL_NOTSAFEPOINT
 {
     jl_printf(JL_STDERR, "fatal: error thrown and no exception handler available.\n");
-    jl_static_show(JL_STDERR, e);
+    // cap the rendering; a deeply-parameterized type here should not make the
+    // fatal path itself take milliseconds (limits chosen to be far beyond
+    // anything informative)
+    jl_static_show_bounded(JL_STDERR, e, 32, 1<<20);
     jl_printf(JL_STDERR, "\n");
     jlbacktrace();
     jl_exit(1);
@@ -563,6 +619,12 @@ static void NOINLINE JL_NORETURN start_task(void)
     jl_task_t *pt = ptls->previous_task;
     if (!pt->sticky && !pt->copy_stack)
         pt->tid = -1;
+#ifdef JULIA_ENABLE_THREADING
+    // a depth-first spawn suspended the previous task; it is off-CPU now,
+    // so publish its continuation as stealable work (partr.c)
+    if (__unlikely(ptls->deferred_enqueue_task != NULL))
+        jl_enqueue_deferred_task();
+#endif
 
     t->started = 1;
     if (t->exception != jl_nothing) {
@@ -735,7 +797,7 @@ static char *jl_alloc_fiber(jl_ucontext_t *t, size_t *ssize, jl_task_t *owner)
 }
 static void jl_start_fiber(jl_ucontext_t *lastt, jl_ucontext_t *t)
 {
-    if (lastt && jl_setjmp(lastt->uc_mcontext, 0))
+    if (lastt && jl_save_fiber_ctx(lastt))
         return;
     char *stk = ((char**)t)[0];
     size_t ssize = ((size_t*)t)[1];
@@ -807,13 +869,18 @@ static void jl_start_fiber(jl_ucontext_t *lastt, jl_ucontext_t *t)
 }
 static void jl_swap_fiber(jl_ucontext_t *lastt, jl_ucontext_t *t)
 {
-    if (jl_setjmp(lastt->uc_mcontext, 0))
+#ifdef JL_HAVE_FIBER_SWAP
+    // single combined save+restore; "returns" here again when resumed
+    jl_fiber_swap(lastt, t);
+#else
+    if (jl_save_fiber_ctx(lastt))
         return;
-    jl_longjmp(t->uc_mcontext, 1); // (doesn't return)
+    jl_restore_fiber_ctx(t); // (doesn't return)
+#endif
 }
 static void jl_set_fiber(jl_ucontext_t *t)
 {
-    jl_longjmp(t->uc_mcontext, 1);
+    jl_restore_fiber_ctx(t);
 }
 static void jl_init_basefiber(size_t ssize)
 {
@@ -965,7 +1032,7 @@ void jl_init_root_task(void *stack_lo, void *stack_hi)
     if (always_copy_stacks) {
         ptls->stackbase = stack_hi;
         ptls->stacksize = ssize;
-        if (jl_setjmp(ptls->base_ctx.uc_mcontext, 0))
+        if (jl_save_fiber_ctx(&ptls->base_ctx))
             start_task();
     }
     else {
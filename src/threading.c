@@ -227,6 +227,12 @@ JL_DLLEXPORT JL_CONST_FUNC jl_ptls_t (jl_get_ptls_states)(void)
 #endif
 
 JL_DLLEXPORT int jl_n_threads;
+// the JULIA_NUM_THREADS setting. normally equal to jl_n_threads; with
+// JULIA_LAZY_THREADS=1 the workers (and their heaps and stacks) are not
+// created until the first chance of parallel work, and jl_n_threads stays 1
+// until they are, so every loop over jl_all_tls_states only ever visits
+// initialized slots
+int jl_n_threads_configured = 1;
 jl_ptls_t *jl_all_tls_states;
 
 // return calling thread's ID
@@ -238,6 +244,300 @@ JL_DLLEXPORT int16_t jl_threadid(void)
     return ptls->tid;
 }
 
+// NUMA topology
+// On Linux the node layout is parsed from sysfs; everywhere else the
+// machine is reported as a single node. Exposed so pools (and Base code)
+// can size and place per node, and used below to keep work stealing and
+// recycled GC pages node-local.
+
+#ifdef _OS_LINUX_
+#include <sched.h>
+#endif
+
+#define JL_NUMA_MAX_CPUS 1024
+static int numa_nnodes = -1;
+static int16_t numa_cpu_node[JL_NUMA_MAX_CPUS];
+
+// per-thread node ids, recorded by each thread in jl_init_threadtls
+int16_t *jl_thread_numa_nodes;
+
+#ifdef _OS_LINUX_
+// parse a sysfs cpulist ("0-3,8-11\n") and assign those cpus to `node`
+static void numa_parse_cpulist(const char *buf, int16_t node)
+{
+    const char *p = buf;
+    while (*p) {
+        char *end;
+        long lo = strtol(p, &end, 10);
+        if (end == p)
+            break;
+        long hi = lo;
+        if (*end == '-') {
+            p = end + 1;
+            hi = strtol(p, &end, 10);
+        }
+        for (long c = lo; c <= hi && c < JL_NUMA_MAX_CPUS; c++)
+            numa_cpu_node[c] = node;
+        if (*end != ',')
+            break;
+        p = end + 1;
+    }
+}
+#endif
+
+JL_DLLEXPORT int jl_numa_node_count(void)
+{
+    if (numa_nnodes != -1)
+        return numa_nnodes;
+#ifdef _OS_LINUX_
+    memset(numa_cpu_node, 0, sizeof(numa_cpu_node));
+    int n = 0;
+    while (1) {
+        char path[128];
+        snprintf(path, sizeof(path),
+                 "/sys/devices/system/node/node%d/cpulist", n);
+        FILE *f = fopen(path, "r");
+        if (f == NULL)
+            break;
+        char buf[4096];
+        if (fgets(buf, sizeof(buf), f))
+            numa_parse_cpulist(buf, (int16_t)n);
+        fclose(f);
+        n++;
+    }
+    numa_nnodes = n > 0 ? n : 1;
+#else
+    numa_nnodes = 1;
+#endif
+    return numa_nnodes;
+}
+
+JL_DLLEXPORT int jl_numa_cpu_to_node(int cpu)
+{
+    jl_numa_node_count();
+    if (cpu < 0 || cpu >= JL_NUMA_MAX_CPUS)
+        return 0;
+    return numa_cpu_node[cpu];
+}
+
+// node the calling thread is currently running on
+JL_DLLEXPORT int jl_numa_current_node(void)
+{
+#ifdef _OS_LINUX_
+    return jl_numa_cpu_to_node(sched_getcpu());
+#else
+    return 0;
+#endif
+}
+
+// node recorded for thread tid at thread start
+JL_DLLEXPORT int jl_numa_thread_node(int16_t tid)
+{
+    if (jl_thread_numa_nodes == NULL)
+        return 0;
+    return jl_thread_numa_nodes[tid];
+}
+
+// Cache topology
+// Per-cache geometry (level, size, line size, sharing width) is parsed
+// from sysfs on Linux and from cpuid leaf 4 on other x86 hosts, so
+// blocked kernels can size their tiles from jl_cpu_cache_info instead of
+// guessing L2/L3 sizes from environment variables. On Linux, cpus sharing
+// a last-level cache are additionally grouped so the partr scheduler can
+// prefer steals among cache siblings (see wsdeque_steal in partr.c);
+// elsewhere the machine is reported as a single group.
+
+#define JL_CACHE_MAX_CACHES 8
+static int cache_ncaches = -1;
+static jl_cpu_cache_info_t cache_descs[JL_CACHE_MAX_CACHES];
+static int cache_ngroups;
+// group of each cpu, identified by the smallest cpu sharing its LLC
+static int16_t cache_cpu_group[JL_NUMA_MAX_CPUS];
+
+// per-thread group ids, recorded by each thread in jl_init_threadtls
+int16_t *jl_thread_cache_groups;
+
+#ifdef _OS_LINUX_
+// parse a sysfs cpulist ("0-3,8-11\n"); returns the number of cpus listed
+// and the smallest one in `*first`
+static int cache_parse_cpulist(const char *buf, int *first)
+{
+    const char *p = buf;
+    int count = 0;
+    *first = -1;
+    while (*p) {
+        char *end;
+        long lo = strtol(p, &end, 10);
+        if (end == p)
+            break;
+        long hi = lo;
+        if (*end == '-') {
+            p = end + 1;
+            hi = strtol(p, &end, 10);
+        }
+        if (*first == -1 || lo < *first)
+            *first = (int)lo;
+        count += (int)(hi - lo + 1);
+        if (*end != ',')
+            break;
+        p = end + 1;
+    }
+    return count;
+}
+
+// read one attribute of /sys/devices/system/cpu/cpu<c>/cache/index<i>/
+static int cache_read_sysfs(int cpu, int idx, const char *attr,
+                            char *buf, size_t len)
+{
+    char path[128];
+    snprintf(path, sizeof(path),
+             "/sys/devices/system/cpu/cpu%d/cache/index%d/%s",
+             cpu, idx, attr);
+    FILE *f = fopen(path, "r");
+    if (f == NULL)
+        return -1;
+    if (fgets(buf, len, f) == NULL)
+        buf[0] = '\0';
+    fclose(f);
+    return 0;
+}
+#endif
+
+#if defined(_CPU_X86_) || defined(_CPU_X86_64_)
+JL_DLLEXPORT void jl_cpuidex(int32_t CPUInfo[4], int32_t InfoType,
+                             int32_t subInfoType);
+#endif
+
+static void cache_probe(void)
+{
+    int n = 0;
+    cache_ngroups = 1;
+#ifdef _OS_LINUX_
+    memset(cache_cpu_group, 0, sizeof(cache_cpu_group));
+    int llc_idx = -1, llc_level = 0;
+    for (int i = 0; n < JL_CACHE_MAX_CACHES; i++) {
+        char buf[4096];
+        if (cache_read_sysfs(0, i, "level", buf, sizeof(buf)))
+            break;
+        jl_cpu_cache_info_t *c = &cache_descs[n];
+        memset(c, 0, sizeof(*c));
+        c->level = (int)strtol(buf, NULL, 10);
+        c->type = 3; // unified, unless the type attribute says otherwise
+        if (!cache_read_sysfs(0, i, "type", buf, sizeof(buf))) {
+            if (buf[0] == 'D')
+                c->type = 1;
+            else if (buf[0] == 'I')
+                c->type = 2;
+        }
+        if (!cache_read_sysfs(0, i, "size", buf, sizeof(buf))) {
+            char *end;
+            c->size = (size_t)strtol(buf, &end, 10);
+            if (*end == 'K')
+                c->size <<= 10;
+            else if (*end == 'M')
+                c->size <<= 20;
+        }
+        if (!cache_read_sysfs(0, i, "coherency_line_size", buf, sizeof(buf)))
+            c->linesize = (int)strtol(buf, NULL, 10);
+        if (!cache_read_sysfs(0, i, "shared_cpu_list", buf, sizeof(buf))) {
+            int first;
+            c->sharing = cache_parse_cpulist(buf, &first);
+        }
+        if (c->type != 2 && c->level > llc_level) {
+            llc_level = c->level;
+            llc_idx = i;
+        }
+        n++;
+    }
+    if (llc_idx != -1) {
+        // group each cpu by the smallest cpu sharing its last-level cache
+        int ngroups = 0;
+        for (int cpu = 0; cpu < JL_NUMA_MAX_CPUS; cpu++) {
+            char buf[4096];
+            int first;
+            if (cache_read_sysfs(cpu, llc_idx, "shared_cpu_list",
+                                 buf, sizeof(buf)))
+                break;
+            if (cache_parse_cpulist(buf, &first) <= 0)
+                first = cpu;
+            cache_cpu_group[cpu] = (int16_t)first;
+            if (first == cpu)
+                ngroups++;
+        }
+        if (ngroups > 1)
+            cache_ngroups = ngroups;
+    }
+#elif defined(_CPU_X86_) || defined(_CPU_X86_64_)
+    for (int32_t i = 0; n < JL_CACHE_MAX_CACHES; i++) {
+        int32_t info[4];
+        jl_cpuidex(info, 4, i);
+        int type = info[0] & 0x1f;
+        if (type == 0)
+            break;
+        jl_cpu_cache_info_t *c = &cache_descs[n];
+        c->type = type; // 1 = data, 2 = instruction, 3 = unified
+        c->level = (info[0] >> 5) & 0x7;
+        c->sharing = ((info[0] >> 14) & 0xfff) + 1;
+        c->linesize = (info[1] & 0xfff) + 1;
+        int ways = ((uint32_t)info[1] >> 22) + 1;
+        int partitions = ((info[1] >> 12) & 0x3ff) + 1;
+        c->size = (size_t)ways * partitions * c->linesize *
+                  ((uint32_t)info[2] + 1);
+        n++;
+    }
+#endif
+    cache_ncaches = n;
+}
+
+// number of caches described for one core (all levels and types)
+JL_DLLEXPORT int jl_cpu_cache_count(void)
+{
+    if (cache_ncaches == -1)
+        cache_probe();
+    return cache_ncaches;
+}
+
+JL_DLLEXPORT int jl_cpu_cache_info(int i, jl_cpu_cache_info_t *info)
+{
+    if (i < 0 || i >= jl_cpu_cache_count())
+        return -1;
+    *info = cache_descs[i];
+    return 0;
+}
+
+// number of distinct last-level-cache groups (1 when unknown or uniform)
+JL_DLLEXPORT int jl_cache_group_count(void)
+{
+    jl_cpu_cache_count();
+    return cache_ngroups;
+}
+
+JL_DLLEXPORT int jl_cache_cpu_to_group(int cpu)
+{
+    jl_cpu_cache_count();
+    if (cpu < 0 || cpu >= JL_NUMA_MAX_CPUS)
+        return 0;
+    return cache_cpu_group[cpu];
+}
+
+// group the calling thread is currently running in
+JL_DLLEXPORT int jl_cache_current_group(void)
+{
+#ifdef _OS_LINUX_
+    return jl_cache_cpu_to_group(sched_getcpu());
+#else
+    return 0;
+#endif
+}
+
+// group recorded for thread tid at thread start
+JL_DLLEXPORT int jl_cache_thread_group(int16_t tid)
+{
+    if (jl_thread_cache_groups == NULL)
+        return 0;
+    return jl_thread_cache_groups[tid];
+}
+
 void jl_init_threadtls(int16_t tid)
 {
     jl_ptls_t ptls = jl_get_ptls_states();
@@ -269,6 +569,15 @@ void jl_init_threadtls(int16_t tid)
                                     sizeof(size_t));
     }
     ptls->defer_signal = 0;
+    memset(ptls->call_cache, 0, sizeof(ptls->call_cache));
+    ptls->call_cache_pick_which = 0;
+    memset(ptls->subtype_cache, 0, sizeof(ptls->subtype_cache));
+    ptls->subtype_cache_hits = 0;
+    ptls->subtype_cache_misses = 0;
+    memset(ptls->intersect_cache, 0, sizeof(ptls->intersect_cache));
+    memset(ptls->tuple_type_cache, 0, sizeof(ptls->tuple_type_cache));
+    memset(ptls->int64_box_cache, 0, sizeof(ptls->int64_box_cache));
+    memset(ptls->float64_box_cache, 0, sizeof(ptls->float64_box_cache));
     void *bt_data = malloc(sizeof(uintptr_t) * (JL_MAX_BT_SIZE + 1));
     if (bt_data == NULL) {
         jl_printf(JL_STDERR, "could not allocate backtrace buffer\n");
@@ -285,6 +594,10 @@ void jl_init_threadtls(int16_t tid)
     jl_init_thread_heap(ptls);
     jl_install_thread_signal_handler(ptls);
 
+    if (jl_thread_numa_nodes)
+        jl_thread_numa_nodes[tid] = (int16_t)jl_numa_current_node();
+    if (jl_thread_cache_groups)
+        jl_thread_cache_groups[tid] = (int16_t)jl_cache_current_group();
     jl_all_tls_states[tid] = ptls;
 }
 
@@ -292,6 +605,67 @@ void jl_init_threadtls(int16_t tid)
 jl_mutex_t codegen_lock;
 jl_mutex_t typecache_lock;
 
+// per-lock contention statistics (see jl_mutex_t in julia_threads.h);
+// any exported lock symbol can be inspected via cglobal + jl_lock_stats
+JL_DLLEXPORT void jl_lock_stats(jl_mutex_t *lock, uint32_t *ncontended, uint32_t *nparked)
+{
+    *ncontended = lock->ncontended;
+    *nparked = lock->nparked;
+}
+
+// Named-lock registry: runtime subsystems register their long-lived locks
+// here (jl_uv_mutex in jl_uv.c, finalizers_lock in gc.c, ...) so monitoring
+// can enumerate them without knowing the symbol for each one. The counters
+// are maintained by the lock paths themselves (see locks.h), so reading
+// them costs nothing beyond the call.
+#define JL_LOCK_REGISTRY_MAX 32
+static struct { jl_mutex_t *lock; const char *name; } lock_registry[JL_LOCK_REGISTRY_MAX];
+static int lock_registry_len = 0;
+
+void jl_lock_register(jl_mutex_t *lock, const char *name)
+{
+    if (lock_registry_len < JL_LOCK_REGISTRY_MAX) {
+        lock_registry[lock_registry_len].lock = lock;
+        lock_registry[lock_registry_len].name = name;
+        lock_registry_len++;
+    }
+}
+
+// copy out the statistics of registered lock `i`; returns the number of
+// registered locks, or -1 when `i` is out of range. `contended_ip` is the
+// acquire site of the holder observed by the most recent contended waiter.
+JL_DLLEXPORT int jl_lock_profile(int i, const char **name, uint64_t *nacquire,
+                                 uint64_t *ncontended, uint64_t *wait_ns,
+                                 uint64_t *wait_ns_max, uintptr_t *contended_ip)
+{
+    if (i < 0 || i >= lock_registry_len)
+        return -1;
+    jl_mutex_t *lock = lock_registry[i].lock;
+    *name = lock_registry[i].name;
+    *nacquire = lock->nacquire;
+    *ncontended = lock->ncontended;
+    *wait_ns = lock->wait_ns;
+    *wait_ns_max = lock->wait_ns_max;
+    *contended_ip = lock->contended_ip;
+    return lock_registry_len;
+}
+
+JL_DLLEXPORT void jl_print_lock_stats(void)
+{
+    for (int i = 0; i < lock_registry_len; i++) {
+        jl_mutex_t *lock = lock_registry[i].lock;
+        jl_safe_printf("%-16s %10" PRIu64 " acquires, %u contended (%u parks), "
+                       "%.3f ms waited (max %.3f ms)\n",
+                       lock_registry[i].name, lock->nacquire,
+                       lock->ncontended, lock->nparked,
+                       lock->wait_ns / 1e6, lock->wait_ns_max / 1e6);
+        if (lock->contended_ip) {
+            jl_safe_printf("    last contended holder acquired at:\n");
+            jl_gdblookup(lock->contended_ip - 1);
+        }
+    }
+}
+
 #ifdef JULIA_ENABLE_THREADING
 
 ssize_t jl_tls_offset = -1;
@@ -391,6 +765,22 @@ static void jl_check_tls(void)
 const int jl_tls_elf_support = 0;
 #endif
 
+// JULIA_LAZY_THREADS=1 defers creating the worker threads until the first
+// chance of parallel work (a non-sticky task enqueue or a threaded region).
+// Single-threaded processes launched under a site-wide JULIA_NUM_THREADS
+// then never pay the worker heaps, stacks and startup time. Note the
+// visible consequence: Threads.nthreads() reports 1 until the workers
+// exist, so code sizing tables from it before any parallel work sees 1.
+static int jl_threads_lazy(void)
+{
+    static int lazy = -1;
+    if (lazy == -1) {
+        char *cp = getenv("JULIA_LAZY_THREADS");
+        lazy = (cp && strtol(cp, NULL, 10) != 0);
+    }
+    return lazy;
+}
+
 // interface to Julia; sets up to make the runtime thread-safe
 void jl_init_threading(void)
 {
@@ -410,26 +800,43 @@ void jl_init_threading(void)
         jl_n_threads = max_threads;
     if (jl_n_threads <= 0)
         jl_n_threads = 1;
+    jl_n_threads_configured = jl_n_threads;
+    // lazy mode: advertise one thread until the workers actually exist
+    if (jl_threads_lazy())
+        jl_n_threads = 1;
 
-    jl_all_tls_states = (jl_ptls_t*)calloc(jl_n_threads, sizeof(void*));
+    // all per-thread tables are sized for the configured count up front, so
+    // a lazy start later only has to create the threads themselves
+    jl_all_tls_states = (jl_ptls_t*)calloc(jl_n_threads_configured, sizeof(void*));
+    jl_thread_numa_nodes = (int16_t*)calloc(jl_n_threads_configured, sizeof(int16_t));
+    jl_thread_cache_groups = (int16_t*)calloc(jl_n_threads_configured, sizeof(int16_t));
 
     // initialize this thread (set tid, create heap, etc.)
     jl_init_threadtls(0);
 
+    jl_lock_register(&codegen_lock, "codegen");
+    jl_lock_register(&typecache_lock, "typecache");
+
     // initialize threading infrastructure
     jl_init_threadinginfra();
 }
 
 static uv_barrier_t thread_init_done;
+// released only once jl_n_threads has its final value, so a worker can
+// never run (and in particular never collect) while the thread count still
+// hides some initialized slots from it
+static uv_barrier_t thread_start_done;
+static int threads_started = 0;
+static jl_mutex_t threads_start_lock;
 
-void jl_start_threads(void)
+static void jl_start_all_threads(void)
 {
     int cpumasksize = uv_cpumask_size();
     char *cp;
     int i, exclusive;
     uv_thread_t uvtid;
-    if (cpumasksize < jl_n_threads) // also handles error case
-        cpumasksize = jl_n_threads;
+    if (cpumasksize < jl_n_threads_configured) // also handles error case
+        cpumasksize = jl_n_threads_configured;
     char *mask = (char*)alloca(cpumasksize);
 
     // do we have exclusive use of the machine? default is no
@@ -449,16 +856,17 @@ void jl_start_threads(void)
         mask[0] = 0;
     }
 
-    // The analyzer doesn't know jl_n_threads doesn't change, help it
-    size_t nthreads = jl_n_threads;
+    size_t nthreads = jl_n_threads_configured;
 
     // create threads
     uv_barrier_init(&thread_init_done, nthreads);
+    uv_barrier_init(&thread_start_done, nthreads);
 
     for (i = 1; i < nthreads; ++i) {
         jl_threadarg_t *t = (jl_threadarg_t*)malloc(sizeof(jl_threadarg_t)); // ownership will be passed to the thread
         t->tid = i;
         t->barrier = &thread_init_done;
+        t->start_barrier = &thread_start_done;
         uv_thread_create(&uvtid, jl_threadfun, t);
         if (exclusive) {
             mask[i] = 1;
@@ -468,16 +876,86 @@ void jl_start_threads(void)
         uv_thread_detach(&uvtid);
     }
 
+    // every jl_all_tls_states slot is populated once this returns ...
     uv_barrier_wait(&thread_init_done);
+    jl_n_threads = jl_n_threads_configured;
+    threads_started = 1;
+    // ... and only now may the workers start running tasks
+    uv_barrier_wait(&thread_start_done);
+}
+
+void jl_start_threads(void)
+{
+    // lazy mode defers the workers to jl_ensure_threads_started
+    if (jl_threads_lazy() && jl_n_threads_configured > 1)
+        return;
+    jl_start_all_threads();
+}
+
+// spawn the deferred workers; called from the scheduler at the first
+// chance of parallel work, a no-op once the threads exist
+void jl_ensure_threads_started(void)
+{
+    if (jl_n_threads == jl_n_threads_configured)
+        return;
+    JL_LOCK_NOGC(&threads_start_lock);
+    if (!threads_started)
+        jl_start_all_threads();
+    JL_UNLOCK_NOGC(&threads_start_lock);
 }
 
 #endif
 
 unsigned volatile _threadedregion; // HACK: prevent the root task from sleeping
 
+// chunked dynamic distribution for threaded regions: the caller seeds the
+// shared iteration counter, then the per-thread closures pull half-open
+// chunks [first, last) until it is exhausted, so skewed per-iteration work
+// rebalances across threads instead of idling on a static partition
+static struct {
+    volatile int64_t next;
+    int64_t stop;
+    int64_t chunk;      // <= 0 means guided (auto-tuned) chunk sizes
+} chunk_sched;
+
+JL_DLLEXPORT void jl_threading_chunk_init(int64_t start, int64_t stop, int64_t chunk)
+{
+    chunk_sched.stop = stop;
+    chunk_sched.chunk = chunk;
+    jl_atomic_store(&chunk_sched.next, start);
+}
+
+JL_DLLEXPORT int jl_threading_next_chunk(int64_t *first, int64_t *last)
+{
+    while (1) {
+        int64_t base = jl_atomic_load(&chunk_sched.next);
+        if (base >= chunk_sched.stop)
+            return 0;
+        int64_t sz = chunk_sched.chunk;
+        if (sz <= 0) {
+            // guided self-scheduling: hand out a shrinking share of the
+            // remaining iterations, so early chunks are large (little
+            // counter traffic) and late chunks are small (good balance)
+            sz = (chunk_sched.stop - base) / (2 * jl_n_threads);
+            if (sz < 1)
+                sz = 1;
+        }
+        int64_t end = base + sz;
+        if (end > chunk_sched.stop)
+            end = chunk_sched.stop;
+        if (jl_atomic_compare_exchange(&chunk_sched.next, base, end) == base) {
+            *first = base;
+            *last = end;
+            return 1;
+        }
+        jl_cpu_pause();
+    }
+}
+
 // simple fork/join mode code
 JL_DLLEXPORT void jl_threading_run(jl_value_t *func)
 {
+    jl_ensure_threads_started();
     jl_ptls_t ptls = jl_get_ptls_states();
     int8_t gc_state = jl_gc_unsafe_enter(ptls);
     size_t world = jl_world_counter;
@@ -507,16 +985,12 @@ JL_DLLEXPORT void jl_threading_run(jl_value_t *func)
         jl_apply(args2, 2);
         if (i == 1) {
             // let threads know work is coming (optimistic)
-            uv_mutex_lock(&sleep_lock);
-            uv_cond_broadcast(&sleep_alarm);
-            uv_mutex_unlock(&sleep_lock);
+            jl_wake_all_threads();
         }
     }
     if (nthreads > 2) {
         // let threads know work is ready (guaranteed)
-        uv_mutex_lock(&sleep_lock);
-        uv_cond_broadcast(&sleep_alarm);
-        uv_mutex_unlock(&sleep_lock);
+        jl_wake_all_threads();
     }
     // join with all tasks
     JL_TRY {
@@ -557,6 +1031,8 @@ void jl_init_threading(void)
 
 void jl_start_threads(void) { }
 
+void jl_ensure_threads_started(void) { }
+
 #endif // !JULIA_ENABLE_THREADING
 
 // Make gc alignment available for threading
@@ -16,12 +16,37 @@ extern jl_ptls_t *jl_all_tls_states;    /* thread local storage */
 extern JL_DLLEXPORT int jl_n_threads;   /* # threads we're actually using */
 extern volatile unsigned _threadedregion; // HACK: prevent tasks from sleeping in threaded regions
 
-extern uv_mutex_t sleep_lock;
-extern uv_cond_t  sleep_alarm;
+void jl_wake_all_threads(void); // partr.c
+int8_t jl_thread_in_scheduler(int16_t tid); // partr.c
+
+// NUMA topology (threading.c)
+extern int16_t *jl_thread_numa_nodes;
+JL_DLLEXPORT int jl_numa_node_count(void);
+JL_DLLEXPORT int jl_numa_cpu_to_node(int cpu);
+JL_DLLEXPORT int jl_numa_current_node(void);
+JL_DLLEXPORT int jl_numa_thread_node(int16_t tid);
+
+// cache topology (threading.c)
+typedef struct {
+    int level;    // 1 = L1, 2 = L2, ...
+    int type;     // 1 = data, 2 = instruction, 3 = unified
+    size_t size;  // total size in bytes
+    int linesize; // coherency line size in bytes
+    int sharing;  // number of hardware threads sharing this cache
+} jl_cpu_cache_info_t;
+extern int16_t *jl_thread_cache_groups;
+JL_DLLEXPORT int jl_cpu_cache_count(void);
+JL_DLLEXPORT int jl_cpu_cache_info(int i, jl_cpu_cache_info_t *info);
+JL_DLLEXPORT int jl_cache_group_count(void);
+JL_DLLEXPORT int jl_cache_cpu_to_group(int cpu);
+JL_DLLEXPORT int jl_cache_current_group(void);
+JL_DLLEXPORT int jl_cache_thread_group(int16_t tid);
+void jl_enqueue_deferred_task(void); // partr.c, see ptls->deferred_enqueue_task
 
 typedef struct _jl_threadarg_t {
     int16_t tid;
     uv_barrier_t *barrier;
+    uv_barrier_t *start_barrier;
     void *arg;
 } jl_threadarg_t;
 
@@ -1,7 +1,9 @@
 // This file is a part of Julia. License is MIT: https://julialang.org/license
 
 #include <inttypes.h>
+#include <string.h>
 #include "julia.h"
+#include "julia_internal.h"
 #include "options.h"
 #include "stdio.h"
 
@@ -9,33 +11,394 @@
 extern "C" {
 #endif
 
+// -- TSC-based timestamps ------------------------------------------------
+//
+// jl_tsc_now reads the processor timestamp counter directly when it is
+// invariant (constant rate, running in all P- and C-states), which costs a
+// few nanoseconds instead of the ~20-25ns of a clock_gettime-based
+// jl_hrtime call, and falls back to jl_hrtime otherwise. The counter runs
+// at an arbitrary rate, so jl_tsc_now returns opaque ticks; elapsed tick
+// counts are converted to nanoseconds with jl_tsc_to_ns, which calibrates
+// the tick rate against jl_hrtime the first time it is needed.
+
+JL_DLLEXPORT int jl_tsc_is_invariant = 0;
+
+static int jl_tsc_initialized = 0;
+static uint64_t jl_tsc_anchor_ticks;
+static uint64_t jl_tsc_anchor_ns;
+static double jl_tsc_ns_per_tick = 0;
+
+#ifdef JL_HAVE_RDTSCP
+// processor_x86.cpp
+JL_DLLEXPORT void jl_cpuid(int32_t CPUInfo[4], int32_t InfoType);
+
+static int jl_tsc_check_invariant(void)
+{
+    int32_t info[4];
+    jl_cpuid(info, (int32_t)0x80000000);
+    if ((uint32_t)info[0] < 0x80000007u)
+        return 0;
+    jl_cpuid(info, (int32_t)0x80000007);
+    return (info[3] >> 8) & 1; // EDX bit 8: invariant TSC
+}
+#endif
+
+// idempotent, so the lazy call in jl_tsc_now is harmless if two threads
+// race to be first
+static void jl_tsc_init(void)
+{
+#ifdef JL_HAVE_RDTSCP
+    if (jl_tsc_check_invariant()) {
+        jl_tsc_anchor_ns = jl_hrtime();
+        jl_tsc_anchor_ticks = rdtscp();
+        jl_tsc_is_invariant = 1;
+    }
+#endif
+    jl_tsc_initialized = 1;
+}
+
+JL_DLLEXPORT uint64_t jl_tsc_now(void)
+{
+    if (!jl_tsc_initialized)
+        jl_tsc_init();
+#ifdef JL_HAVE_RDTSCP
+    if (jl_tsc_is_invariant)
+        return rdtscp();
+#endif
+    return jl_hrtime();
+}
+
+JL_DLLEXPORT uint64_t jl_tsc_to_ns(uint64_t ticks)
+{
+    if (!jl_tsc_initialized)
+        jl_tsc_init();
+    if (!jl_tsc_is_invariant)
+        return ticks; // already nanoseconds from jl_hrtime
+#ifdef JL_HAVE_RDTSCP
+    if (jl_tsc_ns_per_tick == 0) {
+        // estimate the tick rate from the wall time elapsed since the
+        // anchor was taken at init; if the caller converts very early,
+        // wait out the remainder of a millisecond for a usable baseline
+        uint64_t ns1 = jl_hrtime();
+        while (ns1 - jl_tsc_anchor_ns < 1000000)
+            ns1 = jl_hrtime();
+        uint64_t ticks1 = rdtscp();
+        jl_tsc_ns_per_tick = (double)(ns1 - jl_tsc_anchor_ns) /
+                             (double)(ticks1 - jl_tsc_anchor_ticks);
+    }
+#endif
+    return (uint64_t)(ticks * jl_tsc_ns_per_tick);
+}
+
+// -- hardware performance counters ---------------------------------------
+//
+// One perf_event group per thread (cycles leader plus instructions, LLC
+// misses and branch misses) so all four are scheduled onto the PMU
+// together; the kernel multiplexes groups when the PMU is oversubscribed
+// and the read scales by time_enabled/time_running to correct for it.
+// See `jl_perf_counters_t` in julia.h.
+
+#if defined(_OS_LINUX_)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+static const uint32_t jl_perf_types[4] = {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES,
+};
+
+static __thread int perf_group_fd = -1;
+static __thread int perf_fds[4];
+static __thread int perf_open_failed = 0;
+
+JL_DLLEXPORT void jl_perf_counters_close(void)
+{
+    for (int i = 0; i < 4; i++) {
+        if (perf_group_fd != -1 && perf_fds[i] != -1)
+            close(perf_fds[i]);
+        perf_fds[i] = -1;
+    }
+    perf_group_fd = -1;
+}
+
+JL_DLLEXPORT int jl_perf_counters_open(void)
+{
+    if (perf_group_fd != -1)
+        return 0;
+    if (perf_open_failed)
+        return -1; // don't retry the syscalls on every block
+    for (int i = 0; i < 4; i++)
+        perf_fds[i] = -1;
+    for (int i = 0; i < 4; i++) {
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = jl_perf_types[i];
+        attr.disabled = (i == 0); // enabled as a group below
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                           PERF_FORMAT_TOTAL_TIME_RUNNING;
+        int fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1,
+                              i == 0 ? -1 : perf_group_fd, 0);
+        if (fd == -1) {
+            if (i == 0)
+                perf_group_fd = -2; // let close() release nothing
+            jl_perf_counters_close();
+            perf_open_failed = 1;
+            return -1;
+        }
+        perf_fds[i] = fd;
+        if (i == 0)
+            perf_group_fd = fd;
+    }
+    ioctl(perf_group_fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    return 0;
+}
+
+JL_DLLEXPORT int jl_perf_counters_read(jl_perf_counters_t *out)
+{
+    if (perf_group_fd == -1)
+        return -1;
+    struct {
+        uint64_t nr;
+        uint64_t time_enabled;
+        uint64_t time_running;
+        uint64_t values[4];
+    } buf;
+    if (read(perf_group_fd, &buf, sizeof(buf)) != (ssize_t)sizeof(buf))
+        return -1;
+    // correct for multiplexing; values are in group-creation order
+    double scale = buf.time_running ?
+        (double)buf.time_enabled / (double)buf.time_running : 0;
+    out->cycles = (uint64_t)(buf.values[0] * scale);
+    out->instructions = (uint64_t)(buf.values[1] * scale);
+    out->cache_misses = (uint64_t)(buf.values[2] * scale);
+    out->branch_misses = (uint64_t)(buf.values[3] * scale);
+    return 0;
+}
+
+#else
+
+JL_DLLEXPORT int jl_perf_counters_open(void)
+{
+    return -1;
+}
+
+JL_DLLEXPORT int jl_perf_counters_read(jl_perf_counters_t *out)
+{
+    (void)out;
+    return -1;
+}
+
+JL_DLLEXPORT void jl_perf_counters_close(void)
+{
+}
+
+#endif
+
 #ifdef ENABLE_TIMINGS
 #include "timing.h"
 
 jl_timing_block_t *jl_root_timing;
-uint64_t jl_timing_data[(int)JL_TIMING_LAST] = {0};
-const char *jl_timing_names[(int)JL_TIMING_LAST] =
+JL_DLLEXPORT int jl_timing_enabled = 1;
+uint64_t jl_timing_data[JL_TIMING_MAX_OWNERS] = {0};
+const char *jl_timing_names[JL_TIMING_MAX_OWNERS] =
     {
 #define X(name) #name
         JL_TIMING_OWNERS
 #undef X
     };
+static int jl_timing_nowners = (int)JL_TIMING_LAST;
+static uv_mutex_t jl_timing_reg_lock;
+
+JL_DLLEXPORT int jl_timing_register(const char *name)
+{
+    int id = -1;
+    uv_mutex_lock(&jl_timing_reg_lock);
+    if (jl_timing_nowners < JL_TIMING_MAX_OWNERS) {
+        id = jl_timing_nowners;
+        jl_timing_names[id] = strdup(name);
+        jl_timing_nowners++; // publish only after the name is in place
+    }
+    uv_mutex_unlock(&jl_timing_reg_lock);
+    return id;
+}
+
+// dynamic-region entry points (also ccall-able); the JL_TIMING macro
+// covers the statically enumerated owners
+JL_DLLEXPORT void jl_timing_begin(jl_timing_block_t *block, int owner)
+{
+    _jl_timing_block_ctor(block, owner);
+}
+
+JL_DLLEXPORT void jl_timing_end(jl_timing_block_t *block)
+{
+    _jl_timing_block_destroy(block);
+}
+
+// -- per-event tracing --------------------------------------------------
+//
+// while tracing is on, every JL_TIMING begin/end appends one event to a
+// preallocated buffer (atomic slot reservation, so writers never block);
+// jl_timing_trace_stop converts timestamps via jl_tsc_to_ns and writes
+// chrome-trace JSON for chrome://tracing or perfetto
+
+typedef struct {
+    uint64_t t;
+    int32_t owner;
+    int16_t tid;
+    int16_t phase; // 1 begin, 0 end
+} jl_timing_event_t;
+
+static jl_timing_event_t *trace_buf = NULL;
+static size_t trace_cap = 0;
+static volatile uint64_t trace_len = 0;
+static uint64_t trace_t0 = 0;
+volatile int jl_timing_trace_on = 0;
+
+void jl_timing_trace_event(int owner, int phase, uint64_t t)
+{
+    uint64_t idx = jl_atomic_fetch_add(&trace_len, 1);
+    if (idx >= trace_cap)
+        return; // full: drop, reported at export
+    jl_timing_event_t *ev = &trace_buf[idx];
+    ev->t = t;
+    ev->owner = owner;
+    ev->tid = jl_get_ptls_states()->tid;
+    ev->phase = (int16_t)phase;
+}
+
+JL_DLLEXPORT int jl_timing_trace_start(size_t max_events)
+{
+    if (jl_timing_trace_on)
+        return -1;
+    if (max_events == 0)
+        max_events = 1 << 20; // 16mb of events by default
+    jl_timing_event_t *buf = (jl_timing_event_t*)malloc(max_events * sizeof(jl_timing_event_t));
+    if (buf == NULL)
+        return -1;
+    trace_buf = buf;
+    trace_cap = max_events;
+    trace_len = 0;
+    trace_t0 = jl_timing_now();
+    jl_timing_trace_on = 1;
+    return 0;
+}
+
+JL_DLLEXPORT int jl_timing_trace_stop(const char *fname)
+{
+    if (!jl_timing_trace_on)
+        return -1;
+    jl_timing_trace_on = 0;
+    // a writer that reserved its slot just before the flag flipped may
+    // still be filling it, but its stores land long before the writes
+    // below reach that slot
+    uint64_t nreserved = trace_len;
+    size_t n = nreserved < trace_cap ? (size_t)nreserved : trace_cap;
+    FILE *f = fopen(fname, "w");
+    if (f == NULL)
+        return -1;
+    fprintf(f, "[\n");
+    for (size_t i = 0; i < n; i++) {
+        jl_timing_event_t *ev = &trace_buf[i];
+        const char *name = ev->owner >= 0 && ev->owner < jl_timing_nowners &&
+            jl_timing_names[ev->owner] ? jl_timing_names[ev->owner] : "?";
+        fprintf(f, "%s{\"name\":\"%s\",\"cat\":\"julia\",\"ph\":\"%c\","
+                "\"ts\":%.3f,\"pid\":1,\"tid\":%d}",
+                i == 0 ? "" : ",\n", name, ev->phase ? 'B' : 'E',
+                jl_tsc_to_ns(ev->t - trace_t0) / 1e3, (int)ev->tid);
+    }
+    fprintf(f, "\n]\n");
+    fclose(f);
+    if (nreserved > trace_cap)
+        fprintf(stderr, "WARNING: timing trace buffer filled, dropped %" PRIu64 " events\n",
+                nreserved - (uint64_t)trace_cap);
+    free(trace_buf);
+    trace_buf = NULL;
+    trace_cap = 0;
+    return 0;
+}
+
+// -- hardware counters around timing blocks ------------------------------
+//
+// With jl_timing_perf_enable(1), every timing block snapshots its thread's
+// counter group on entry and accumulates the delta per owner on exit, so
+// e.g. the GC mark loop or the subtype solver can be checked for cache- or
+// branch-miss-boundedness in place. Counter groups are opened lazily the
+// first time a block runs on a thread. Counts are inclusive of nested
+// blocks (the per-owner exclusive accounting done for wall time would cost
+// two extra reads per child block).
+
+volatile int jl_timing_perf_on = 0;
+static uint64_t jl_timing_perf_data[JL_TIMING_MAX_OWNERS][4];
+
+void jl_timing_perf_begin(jl_timing_block_t *block)
+{
+    jl_perf_counters_t c;
+    if (jl_perf_counters_open() != 0 || jl_perf_counters_read(&c) != 0) {
+        block->perf0[0] = (uint64_t)-1; // mark: no snapshot for this block
+        return;
+    }
+    block->perf0[0] = c.cycles;
+    block->perf0[1] = c.instructions;
+    block->perf0[2] = c.cache_misses;
+    block->perf0[3] = c.branch_misses;
+}
+
+void jl_timing_perf_end(jl_timing_block_t *block)
+{
+    jl_perf_counters_t c;
+    if (block->perf0[0] == (uint64_t)-1 || jl_perf_counters_read(&c) != 0)
+        return;
+    uint64_t *data = jl_timing_perf_data[block->owner];
+    data[0] += c.cycles - block->perf0[0];
+    data[1] += c.instructions - block->perf0[1];
+    data[2] += c.cache_misses - block->perf0[2];
+    data[3] += c.branch_misses - block->perf0[3];
+}
+
+JL_DLLEXPORT int jl_timing_perf_enable(int enable)
+{
+    int old = jl_timing_perf_on;
+    jl_timing_perf_on = enable;
+    return old;
+}
+
+JL_DLLEXPORT int jl_timing_perf_counters(int owner, jl_perf_counters_t *out)
+{
+    if (owner < 0 || owner >= JL_TIMING_MAX_OWNERS)
+        return -1;
+    out->cycles = jl_timing_perf_data[owner][0];
+    out->instructions = jl_timing_perf_data[owner][1];
+    out->cache_misses = jl_timing_perf_data[owner][2];
+    out->branch_misses = jl_timing_perf_data[owner][3];
+    return 0;
+}
 
 void jl_print_timings(void)
 {
     uint64_t total_time = 0;
-    for (int i = 0; i < JL_TIMING_LAST; i++) {
+    for (int i = 0; i < jl_timing_nowners; i++) {
         total_time += jl_timing_data[i];
     }
-    for (int i = 0; i < JL_TIMING_LAST; i++) {
-        if (jl_timing_data[i] != 0)
-            fprintf(stderr,"%-25s : %.2f %%   %" PRIu64 "\n", jl_timing_names[i],
-                    100 * (((double)jl_timing_data[i]) / total_time), jl_timing_data[i]);
+    for (int i = 0; i < jl_timing_nowners; i++) {
+        if (jl_timing_data[i] != 0 && jl_timing_names[i] != NULL)
+            fprintf(stderr,"%-25s : %.2f %%   %.2f ms\n", jl_timing_names[i],
+                    100 * (((double)jl_timing_data[i]) / total_time),
+                    jl_tsc_to_ns(jl_timing_data[i]) / 1e6);
     }
 }
 
 void jl_init_timing(void)
 {
+    jl_tsc_init(); // settle jl_tsc_is_invariant before the first block
+    uv_mutex_init(&jl_timing_reg_lock);
     jl_root_timing = (jl_timing_block_t*)malloc(sizeof(jl_timing_block_t));
     _jl_timing_block_init(jl_root_timing, JL_TIMING_ROOT);
     jl_root_timing->prev = NULL;
@@ -55,17 +418,27 @@ jl_timing_block_t *jl_pop_timing_block(jl_timing_block_t *cur_block)
 
 void jl_timing_block_start(jl_timing_block_t *cur_block)
 {
-    _jl_timing_block_start(cur_block, rdtscp());
+    _jl_timing_block_start(cur_block, jl_timing_now());
 }
 
 void jl_timing_block_stop(jl_timing_block_t *cur_block)
 {
-    _jl_timing_block_stop(cur_block, rdtscp());
+    _jl_timing_block_stop(cur_block, jl_timing_now());
 }
 
 #else
 
-void jl_init_timing(void) { }
+// keep the exported entry points ccall-able in builds without ENABLE_TIMINGS
+JL_DLLEXPORT int jl_timing_enabled = 0;
+JL_DLLEXPORT int jl_timing_register(const char *name) { (void)name; return -1; }
+JL_DLLEXPORT void jl_timing_begin(jl_timing_block_t *block, int owner) { (void)block; (void)owner; }
+JL_DLLEXPORT void jl_timing_end(jl_timing_block_t *block) { (void)block; }
+JL_DLLEXPORT int jl_timing_trace_start(size_t max_events) { (void)max_events; return -1; }
+JL_DLLEXPORT int jl_timing_trace_stop(const char *fname) { (void)fname; return -1; }
+JL_DLLEXPORT int jl_timing_perf_enable(int enable) { (void)enable; return -1; }
+JL_DLLEXPORT int jl_timing_perf_counters(int owner, jl_perf_counters_t *out) { (void)owner; (void)out; return -1; }
+
+void jl_init_timing(void) { jl_tsc_init(); }
 void jl_destroy_timing(void) { }
 
 #endif
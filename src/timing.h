@@ -3,6 +3,33 @@
 #ifndef JL_TIMING_H
 #define JL_TIMING_H
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// TSC-based timestamps, calibrated against jl_hrtime (see timing.c).
+// jl_tsc_now costs a few nanoseconds on hardware with an invariant TSC
+// (constant rate, running in all P- and C-states) and falls back to
+// jl_hrtime elsewhere. It counts opaque ticks; convert elapsed tick
+// counts to nanoseconds with jl_tsc_to_ns.
+extern JL_DLLEXPORT int jl_tsc_is_invariant;
+JL_DLLEXPORT uint64_t jl_tsc_now(void);
+JL_DLLEXPORT uint64_t jl_tsc_to_ns(uint64_t ticks);
+
+#ifdef __cplusplus
+}
+#endif
+
+#if (defined(_CPU_X86_64_) || defined(_CPU_X86_)) && !defined(_COMPILER_MICROSOFT_)
+#define JL_HAVE_RDTSCP
+STATIC_INLINE uint64_t rdtscp(void)
+{
+    uint64_t rax,rdx;
+    asm volatile ( "rdtscp\n" : "=a" (rax), "=d" (rdx) : : "rcx" );
+    return (rdx << 32) + rax;
+}
+#endif
+
 #ifndef ENABLE_TIMINGS
 #define JL_TIMING(owner)
 #else
@@ -19,6 +46,26 @@ void jl_destroy_timing(void);
 extern jl_timing_block_t *jl_root_timing;
 void jl_timing_block_start(jl_timing_block_t *cur_block);
 void jl_timing_block_stop(jl_timing_block_t *cur_block);
+// runtime toggle: when 0, JL_TIMING blocks cost one predicted branch
+extern JL_DLLEXPORT int jl_timing_enabled;
+// dynamic region registration; returns an owner id usable with
+// jl_timing_begin/jl_timing_end, or -1 when the owner table is full
+JL_DLLEXPORT int jl_timing_register(const char *name);
+JL_DLLEXPORT void jl_timing_begin(jl_timing_block_t *block, int owner);
+JL_DLLEXPORT void jl_timing_end(jl_timing_block_t *block);
+// per-event begin/end capture with thread ids, exported as chrome-trace
+// JSON (load the file in chrome://tracing or perfetto)
+JL_DLLEXPORT int jl_timing_trace_start(size_t max_events);
+JL_DLLEXPORT int jl_timing_trace_stop(const char *fname);
+extern volatile int jl_timing_trace_on;
+void jl_timing_trace_event(int owner, int phase, uint64_t t);
+// hardware counter capture around timing blocks (Linux; see timing.c);
+// the accumulated counts are inclusive of nested blocks
+extern volatile int jl_timing_perf_on;
+JL_DLLEXPORT int jl_timing_perf_enable(int enable);
+JL_DLLEXPORT int jl_timing_perf_counters(int owner, jl_perf_counters_t *out);
+void jl_timing_perf_begin(jl_timing_block_t *block);
+void jl_timing_perf_end(jl_timing_block_t *block);
 #ifdef __cplusplus
 }
 #endif
@@ -35,11 +82,15 @@ void jl_timing_block_stop(jl_timing_block_t *cur_block);
 #define JL_TIMING(owner)
 #else
 
-static inline uint64_t rdtscp(void)
+// inline the counter read when the TSC is known-good; the flag settles in
+// jl_init_timing, before any timing block runs
+STATIC_INLINE uint64_t jl_timing_now(void)
 {
-    uint64_t rax,rdx;
-    asm volatile ( "rdtscp\n" : "=a" (rax), "=d" (rdx) : : "rcx" );
-    return (rdx << 32) + rax;
+#ifdef JL_HAVE_RDTSCP
+    if (jl_tsc_is_invariant)
+        return rdtscp();
+#endif
+    return jl_tsc_now();
 }
 
 #define JL_TIMING_OWNERS          \
@@ -77,13 +128,17 @@ enum jl_timing_owners {
     JL_TIMING_LAST
 };
 
-extern uint64_t jl_timing_data[(int)JL_TIMING_LAST];
-extern const char *jl_timing_names[(int)JL_TIMING_LAST];
+// static owners above plus room for jl_timing_register
+#define JL_TIMING_MAX_OWNERS ((int)JL_TIMING_LAST + 64)
+
+extern uint64_t jl_timing_data[JL_TIMING_MAX_OWNERS];
+extern const char *jl_timing_names[JL_TIMING_MAX_OWNERS];
 
 struct _jl_timing_block_t { // typedef in julia.h
     jl_timing_block_t *prev;
     uint64_t total;
     uint64_t t0;
+    uint64_t perf0[4]; // counter snapshot at entry while jl_timing_perf_on
     int owner;
 #ifdef JL_DEBUG_BUILD
     uint8_t running;
@@ -107,7 +162,7 @@ STATIC_INLINE void _jl_timing_block_start(jl_timing_block_t *block, uint64_t t)
 }
 
 STATIC_INLINE uint64_t _jl_timing_block_init(jl_timing_block_t *block, int owner) {
-    uint64_t t = rdtscp();
+    uint64_t t = jl_timing_now();
     block->owner = owner;
     block->total = 0;
 #ifdef JL_DEBUG_BUILD
@@ -118,16 +173,32 @@ STATIC_INLINE uint64_t _jl_timing_block_init(jl_timing_block_t *block, int owner
 }
 
 STATIC_INLINE void _jl_timing_block_ctor(jl_timing_block_t *block, int owner) {
+    if (__unlikely(!jl_timing_enabled)) {
+        // never pushed, so the matching destroy is a no-op too; toggling
+        // mid-block therefore can't unbalance the timing stack
+        block->owner = -1;
+        return;
+    }
     uint64_t t = _jl_timing_block_init(block, owner);
     jl_timing_block_t **prevp = jl_current_task ? &jl_current_task->timing_stack : &jl_root_timing;
     block->prev = *prevp;
     if (block->prev)
         _jl_timing_block_stop(block->prev, t);
     *prevp = block;
+    if (__unlikely(jl_timing_trace_on))
+        jl_timing_trace_event(owner, 1, t);
+    if (__unlikely(jl_timing_perf_on))
+        jl_timing_perf_begin(block);
 }
 
 STATIC_INLINE void _jl_timing_block_destroy(jl_timing_block_t *block) {
-    uint64_t t = rdtscp();
+    if (__unlikely(block->owner < 0))
+        return;
+    uint64_t t = jl_timing_now();
+    if (__unlikely(jl_timing_trace_on))
+        jl_timing_trace_event(block->owner, 0, t);
+    if (__unlikely(jl_timing_perf_on))
+        jl_timing_perf_end(block);
     _jl_timing_block_stop(block, t);
     jl_timing_data[block->owner] += block->total;
     jl_timing_block_t **pcur = jl_current_task ? &jl_current_task->timing_stack : &jl_root_timing;
@@ -616,6 +616,9 @@ jl_value_t *jl_toplevel_eval_flex(jl_module_t *JL_NONNULL m, jl_value_t *e, int
         jl_value_t *rhs = jl_exprarg(ex, 1);
         // only handle `a.b` syntax here, so qualified names can be eval'd in pure contexts
         if (jl_is_quotenode(rhs) && jl_is_symbol(jl_fieldref(rhs, 0))) {
+            // getproperty is user-extendable, so this can call into methods
+            // defined earlier in the current world batch
+            jl_world_batch_break();
             return jl_eval_dot_expr(m, lhs, rhs, fast);
         }
     }
@@ -789,6 +792,13 @@ jl_value_t *jl_toplevel_eval_flex(jl_module_t *JL_NONNULL m, jl_value_t *e, int
     assert(jl_typeis(thk->code, jl_array_any_type));
     body_attributes((jl_array_t*)thk->code, &has_intrinsics, &has_defs, &has_loops);
 
+    // executing anything that is not purely definitions may call methods
+    // defined earlier in the current world batch; end world sharing so the
+    // next definition gets a fresh world and sequential code stays
+    // consistent (no-op unless a batch is open, see gf.c)
+    if (!has_defs || has_intrinsics)
+        jl_world_batch_break();
+
     jl_value_t *result;
     if (has_intrinsics || (!has_defs && fast && has_loops &&
                            jl_options.compile_enabled != JL_OPTIONS_COMPILE_OFF &&
@@ -861,10 +861,14 @@ jl_typemap_entry_t *jl_typemap_level_assoc_exact(jl_typemap_level_t *cache, jl_v
 
 // ----- Method List Insertion Management ----- //
 
-static unsigned jl_typemap_list_count(jl_typemap_entry_t *ml) JL_NOTSAFEPOINT
+// count entries, stopping at `limit`: the only consumer compares against the
+// level-split threshold, and walking thousands of entries per insert just to
+// learn "more than the threshold" made insertion into a large unsplittable
+// list quadratic
+static unsigned jl_typemap_list_count_upto(jl_typemap_entry_t *ml, unsigned limit) JL_NOTSAFEPOINT
 {
     unsigned count = 0;
-    while (ml != (void*)jl_nothing) {
+    while (ml != (void*)jl_nothing && count < limit) {
         count++;
         ml = ml->next;
     }
@@ -922,6 +926,40 @@ static void jl_typemap_list_insert_(jl_typemap_entry_t **pml, jl_value_t *parent
     }
 }
 
+// whether converting `ml` into a cache level split at position `offs` can
+// actually separate any entries: a signature counts if the type there can be
+// indexed by the ordered dicts (or recursed through the Any list). unions,
+// varargs and non-leaf types all fall back to the level's linear list, so a
+// level split on a position where every signature looks like that is pure
+// overhead and the sorted list should be kept instead.
+static int jl_typemap_entry_splittable(jl_typemap_entry_t *ml, int8_t offs)
+{
+    jl_value_t *ttypes = jl_unwrap_unionall((jl_value_t*)ml->sig);
+    size_t l = jl_nparams(ttypes);
+    jl_value_t *t1;
+    if (l <= offs)
+        return 0;
+    t1 = jl_tparam(ttypes, l <= offs + 1 ? l - 1 : offs);
+    if (jl_is_vararg_type(t1))
+        return 0;
+    if (jl_is_any(t1))
+        return 1;
+    if (t1 != (jl_value_t*)jl_typetype_type && jl_is_type_type(t1))
+        t1 = jl_tparam0(t1);
+    // same condition as mtcache_hash_bp
+    return (jl_is_datatype(t1) && ((jl_datatype_t*)t1)->uid &&
+            !jl_is_kind(t1) && !jl_has_free_typevars(t1));
+}
+
+static int jl_typemap_list_splittable(jl_typemap_entry_t *ml, int8_t offs)
+{
+    for (; ml != (void*)jl_nothing; ml = ml->next) {
+        if (jl_typemap_entry_splittable(ml, offs))
+            return 1;
+    }
+    return 0;
+}
+
 static void jl_typemap_insert_generic(jl_typemap_t **pml, jl_value_t *parent,
                                       jl_typemap_entry_t *newrec, jl_value_t *key, int8_t offs,
                                       const struct jl_typemap_info *tparams)
@@ -931,14 +969,23 @@ static void jl_typemap_insert_generic(jl_typemap_t **pml, jl_value_t *parent,
         return;
     }
 
-    unsigned count = jl_typemap_list_count((jl_typemap_entry_t*)*pml);
+    unsigned count = jl_typemap_list_count_upto((jl_typemap_entry_t*)*pml, MAX_METHLIST_COUNT + 2);
     if (count > MAX_METHLIST_COUNT) {
-        *pml = (jl_typemap_t*)jl_method_convert_list_to_cache(
-            (jl_typemap_entry_t *)*pml,
-            key, offs, tparams);
-        jl_gc_wb(parent, *pml);
-        jl_typemap_level_insert_((jl_typemap_level_t*)*pml, newrec, offs, tparams);
-        return;
+        // entries never change their signature in place, so once a full scan
+        // found the list unsplittable (when it first crossed the threshold),
+        // later inserts only need to test the record being added: everything
+        // already in the list was either scanned at the crossing or tested
+        // here when it was inserted
+        if (jl_typemap_entry_splittable(newrec, offs) ||
+            (count == MAX_METHLIST_COUNT + 1 &&
+             jl_typemap_list_splittable((jl_typemap_entry_t*)*pml, offs))) {
+            *pml = (jl_typemap_t*)jl_method_convert_list_to_cache(
+                (jl_typemap_entry_t *)*pml,
+                key, offs, tparams);
+            jl_gc_wb(parent, *pml);
+            jl_typemap_level_insert_((jl_typemap_level_t*)*pml, newrec, offs, tparams);
+            return;
+        }
     }
 
     jl_typemap_list_insert_((jl_typemap_entry_t **)pml,
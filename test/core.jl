@@ -129,6 +129,26 @@ Type{Integer}  # cache this
 @test typejoin(Union{Int,AbstractString}, Int8) == Any
 @test typejoin(Tuple{}, Tuple{Int}) == Tuple{Vararg{Int}}
 
+# normalization of unions with many components (these take the sorted
+# deduplication path in jl_type_union)
+let tys = Any[Int8, Int16, Int32, Int64, UInt8, UInt16, UInt32, UInt64,
+              Float16, Float32, Float64, Bool, Char, String, Symbol]
+    u = Union{tys...}
+    @test u === Union{reverse(tys)...}
+    @test u === Union{tys..., tys...}
+    @test u === Union{tys..., Union{}}
+    @test Union{tys..., Integer} === Union{Float16, Float32, Float64,
+                                           Char, String, Symbol, Integer}
+    @test Union{tys..., Any} === Any
+    @test Set(Base.uniontypes(u)) == Set(tys)
+    # concrete types can still absorb other concrete types: tuples are
+    # covariant and Type{T} sits under the kinds
+    @test Union{tys..., Tuple{Int}, Tuple{Any}} === Union{tys..., Tuple{Any}}
+    @test Union{tys..., Tuple{Int8, Integer}, Tuple{Int8, Int16}} ===
+          Union{tys..., Tuple{Int8, Integer}}
+    @test Union{tys..., Type{Int}, DataType} === Union{tys..., DataType}
+end
+
 # typejoin associativity
 abstract type Foo____{K} end
 mutable struct Wow____{K,V} <: Foo____{K} end
@@ -106,3 +106,15 @@ end
 @test unsafe_load(Ptr{Nothing}(0)) === nothing
 struct GhostStruct end
 @test unsafe_load(Ptr{GhostStruct}(rand(Int))) === GhostStruct()
+
+# alignment-asserting variants of unsafe_load/unsafe_store!
+let a = zeros(Float64, 4)
+    GC.@preserve a begin
+        p = pointer(a)
+        @test unsafe_store!(p, 1.25, 1, 8) === p
+        unsafe_store!(p, 2.5, 2, 8)
+        @test unsafe_load(p, 1, 8) === 1.25
+        @test unsafe_load(p, 2, 8) === 2.5
+        @test unsafe_load(p, 2) === 2.5
+    end
+end
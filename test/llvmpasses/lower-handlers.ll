@@ -4,10 +4,12 @@ attributes #1 = { returns_twice }
 declare i32 @julia.except_enter() #1
 declare void @jl_pop_handler(i32)
 declare i8**** @julia.ptls_states()
+declare void @may_throw()
 
 define void @simple() {
 top:
     %ptls = call i8**** @julia.ptls_states()
+; CHECK-LABEL: @simple
 ; CHECK: call void @llvm.lifetime.start
 ; CHECK: call void @jl_enter_handler
 ; CHECK: setjmp
@@ -15,6 +17,7 @@ top:
     %cmp = icmp eq i32 %r, 0
     br i1 %cmp, label %try, label %catch
 try:
+    call void @may_throw()
     br label %after
 catch:
     br label %after
@@ -23,3 +26,55 @@ after:
 ; CHECK: llvm.lifetime.end
     ret void
 }
+
+; A region with no calls and no volatile accesses cannot reach its handler:
+; the enter and every pop balancing it are removed, including the leave that
+; opens the (then dead) catch block.
+define i32 @elide_nothrow(i32 %x) {
+top:
+; CHECK-LABEL: @elide_nothrow
+; CHECK-NOT: call void @jl_enter_handler
+; CHECK-NOT: setjmp
+; CHECK-NOT: call void @jl_pop_handler
+    %r = call i32 @julia.except_enter()
+    %cmp = icmp eq i32 %r, 0
+    br i1 %cmp, label %try, label %catch
+try:
+    %v = add i32 %x, 1
+    call void @jl_pop_handler(i32 1)
+    br label %after
+catch:
+    call void @jl_pop_handler(i32 1)
+    br label %after
+after:
+    %p = phi i32 [ %v, %try ], [ 0, %catch ]
+    ret i32 %p
+}
+
+; An elidable handler nested inside one that stays: the `leave 2` popping
+; both frames is rewritten to pop only the surviving outer one.
+define void @elide_nested() {
+top:
+; CHECK-LABEL: @elide_nested
+; CHECK: call void @jl_enter_handler
+; CHECK-NOT: call void @jl_enter_handler
+; CHECK: call void @jl_pop_handler(i32 1)
+    %r = call i32 @julia.except_enter()
+    %cmp = icmp eq i32 %r, 0
+    br i1 %cmp, label %try, label %catch
+try:
+    call void @may_throw()
+    %r2 = call i32 @julia.except_enter()
+    %cmp2 = icmp eq i32 %r2, 0
+    br i1 %cmp2, label %try2, label %catch2
+try2:
+    call void @jl_pop_handler(i32 2)
+    ret void
+catch2:
+    call void @jl_pop_handler(i32 1)
+    call void @jl_pop_handler(i32 1)
+    ret void
+catch:
+    call void @jl_pop_handler(i32 1)
+    ret void
+}
@@ -24,6 +24,14 @@ let a = zeros(Int, 2 * nthreads())
     @test all(isequal(4), a)
 end
 
+# dynamic (chunked) schedule covers every iteration exactly once
+let a = zeros(Int, 1000)
+    @threads :dynamic for i = 1:length(a)
+        a[i] += 1
+    end
+    @test all(isequal(1), a)
+end
+
 # parallel loop with parallel atomic addition
 function threaded_loop(a, r, x)
     @threads for i in r